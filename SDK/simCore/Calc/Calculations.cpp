@@ -34,6 +34,7 @@
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simCore/Calc/CoordinateSystem.h"
 #include "simCore/Calc/Calculations.h"
+#include "simCore/Calc/LocalFrame.h"
 
 namespace
 {
@@ -47,6 +48,40 @@ namespace
     cc.setReferenceOrigin(refLla);
     return cc;
   }
+
+  /** Calculates true azimuth, elevation and composite angles from an ENU offset */
+  void absAnglesFromEnu(const simCore::Vec3& enuDelta, double* azim, double* elev, double* cmp)
+  {
+    if (azim)
+      *azim = simCore::angFix2PI(atan2(enuDelta[0], enuDelta[1]));
+
+    if (elev)
+      *elev = atan2(enuDelta[2], sqrt(enuDelta[0]*enuDelta[0] + enuDelta[1]*enuDelta[1]));
+
+    if (cmp)
+    {
+      simCore::Vec3 northVector(0.0, 1.0, 0.0);
+      *cmp = simCore::v3Angle(northVector, enuDelta);
+    }
+  }
+
+  /** Calculates downrange, crossrange and down value from the slant range and true angles to the target */
+  void drcrDownFromSlant(double slantDistance, double trueAzimuth, double trueElevation, double yaw, double* downRng, double* crossRng, double* downValue)
+  {
+    // get the down value
+    if (downValue)
+      *downValue = slantDistance * sin(trueElevation);
+
+    const double downRangeCrossRangeAngle = trueAzimuth - yaw;
+    const double downRangeCrossRangeHypotenuse = slantDistance * cos(trueElevation);
+
+    // calculates the downrange and crossrange
+    if (downRng)
+      *downRng = downRangeCrossRangeHypotenuse * cos(downRangeCrossRangeAngle);
+
+    if (crossRng)
+      *crossRng = downRangeCrossRangeHypotenuse * sin(downRangeCrossRangeAngle);
+  }
 }
 
 namespace simCore {
@@ -144,17 +179,7 @@ void calculateAbsAzEl(const Vec3 &fromLla, const Vec3 &toLla, double *azim, doub
     return;
   }
 
-  if (azim)
-    *azim = angFix2PI(atan2(ENUDelta[0], ENUDelta[1]));
-
-  if (elev)
-    *elev = atan2(ENUDelta[2], sqrt(ENUDelta[0]*ENUDelta[0] + ENUDelta[1]*ENUDelta[1]));
-
-  if (cmp)
-  {
-    Vec3 northVector(0.0, 1.0, 0.0);
-    *cmp = v3Angle(northVector, ENUDelta);
-  }
+  absAnglesFromEnu(ENUDelta, azim, elev, cmp);
 }
 
 /**
@@ -326,19 +351,109 @@ void calculateDRCRDownValue(const Vec3 &fromLla, const double &yaw, const Vec3 &
   double trueElevation = 0;
   calculateAbsAzEl(fromLla, toLla, &trueAzimuth, &trueElevation, nullptr, model, &cc);
 
-  // get the down value
-  if (downValue)
-    *downValue = slantDistance * sin(trueElevation);
+  drcrDownFromSlant(slantDistance, trueAzimuth, trueElevation, yaw, downRng, crossRng, downValue);
+}
 
-  const double downRangeCrossRangeAngle = trueAzimuth - yaw;
-  const double downRangeCrossRangeHypotenuse = slantDistance * cos(trueElevation);
+//------------------------------------------------------------------------
 
-  // calculates the downrange and crossrange
-  if (downRng)
-    *downRng = downRangeCrossRangeHypotenuse * cos(downRangeCrossRangeAngle);
+void calculateRelAzEl(const LocalFrame &fromFrame, const Vec3 &fromOriLla, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv)
+{
+  if (model != TANGENT_PLANE_WGS_84 && model != WGS_84)
+  {
+    calculateRelAzEl(fromFrame.originLla(), fromOriLla, toLla, azim, elev, cmp, model, coordConv);
+    return;
+  }
+  assert(fromFrame.isValid());
+  assert(azim || elev || cmp);
+  if (!azim && !elev && !cmp)
+  {
+    SIM_ERROR << "calculateRelAzEl, invalid angles: " << __LINE__ << std::endl;
+    return;
+  }
+
+  Vec3 toPos;
+  fromFrame.geodeticToLocal(toLla, toPos);
+  calculateRelAng(toPos, fromOriLla, azim, elev, cmp);
+}
 
-  if (crossRng)
-    *crossRng = downRangeCrossRangeHypotenuse * sin(downRangeCrossRangeAngle);
+void calculateAbsAzEl(const LocalFrame &fromFrame, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv)
+{
+  if (model != TANGENT_PLANE_WGS_84 && model != WGS_84)
+  {
+    calculateAbsAzEl(fromFrame.originLla(), toLla, azim, elev, cmp, model, coordConv);
+    return;
+  }
+  assert(fromFrame.isValid());
+  assert(azim || elev || cmp);
+  if (!azim && !elev && !cmp)
+  {
+    SIM_ERROR << "calculateAbsAzEl, invalid angles: " << __LINE__ << std::endl;
+    return;
+  }
+
+  Vec3 ENUDelta;
+  fromFrame.geodeticToLocal(toLla, ENUDelta);
+  absAnglesFromEnu(ENUDelta, azim, elev, cmp);
+}
+
+double calculateSlant(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv)
+{
+  if (model == WGS_84)
+  {
+    assert(fromFrame.isValid());
+    Vec3 toPos;
+    CoordinateConverter::convertGeodeticPosToEcef(toLla, toPos);
+    return v3Distance(toPos, fromFrame.originEcef());
+  }
+  if (model == TANGENT_PLANE_WGS_84)
+  {
+    assert(fromFrame.isValid());
+    // the 'from' entity is at the origin of the tangent plane
+    Vec3 toPos;
+    fromFrame.geodeticToLocal(toLla, toPos);
+    return v3Length(toPos);
+  }
+  return calculateSlant(fromFrame.originLla(), toLla, model, coordConv);
+}
+
+double calculateGroundDist(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv)
+{
+  if (model != TANGENT_PLANE_WGS_84)
+    return calculateGroundDist(fromFrame.originLla(), toLla, model, coordConv);
+
+  assert(fromFrame.isValid());
+  Vec3 toPos;
+  fromFrame.geodeticToLocal(toLla, toPos);
+  return sqrt(square(toPos[0]) + square(toPos[1]));
+}
+
+double calculateAltitude(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv)
+{
+  if (model != TANGENT_PLANE_WGS_84)
+    return calculateAltitude(fromFrame.originLla(), toLla, model, coordConv);
+
+  assert(fromFrame.isValid());
+  Vec3 toPos;
+  fromFrame.geodeticToLocal(toLla, toPos);
+  return toPos.z();
+}
+
+void calculateDRCRDownValue(const LocalFrame &fromFrame, const double &yaw, const Vec3 &toLla, const EarthModelCalculations model, double* downRng, double* crossRng, double* downValue)
+{
+  assert(downRng || crossRng || downValue);
+  if (!downRng && !crossRng && !downValue)
+  {
+    SIM_ERROR << "calculateDRCRDownValue, invalid ranges: " << __LINE__ << std::endl;
+    return;
+  }
+
+  // as in the Vec3 version, flat earth is calculated against a converter at the 'from' entity
+  const CoordinateConverter* cc = &fromFrame.converter();
+  const double slantDistance = calculateSlant(fromFrame, toLla, model, cc);
+  double trueAzimuth = 0;
+  double trueElevation = 0;
+  calculateAbsAzEl(fromFrame, toLla, &trueAzimuth, &trueElevation, nullptr, model, cc);
+  drcrDownFromSlant(slantDistance, trueAzimuth, trueElevation, yaw, downRng, crossRng, downValue);
 }
 
 /**
@@ -36,6 +36,8 @@
 
 namespace simCore
 {
+  class LocalFrame;
+
   /**
   * @brief Calculates the relative azimuth, elevation, and composite angles between two entities
   *
@@ -53,6 +55,21 @@ namespace simCore
   */
   SDKCORE_EXPORT void calculateRelAzEl(const Vec3 &fromLla, const Vec3 &fromOriLla, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv);
 
+  /**
+  * Calculates the relative azimuth, elevation, and composite angles using a cached local frame at the 'from' entity.
+  * WGS-84 and tangent plane models use the cached frame; other models behave as calculateRelAzEl() at fromFrame.originLla().
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] fromOriLla Vector of yaw, pitch, roll that describes current pointing angles for the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity, to which the angles are calculated
+  * @param[out] azim Azimuth value from one entity to another along the from's line of sight
+  * @param[out] elev Elevation value from one entity to another along the from's line of sight
+  * @param[out] cmp Composite value from one entity to another along the from's line of sight
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter structure with a reference origin set
+  * @pre fromFrame must be valid and one of the azim, elev and cmp params must be valid
+  */
+  SDKCORE_EXPORT void calculateRelAzEl(const LocalFrame &fromFrame, const Vec3 &fromOriLla, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv);
+
   /**
   * @brief Calculates the absolute azimuth, elevation, and composite angles between two entities
   *
@@ -69,6 +86,20 @@ namespace simCore
   */
   SDKCORE_EXPORT void calculateAbsAzEl(const Vec3 &fromLla, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv);
 
+  /**
+  * Calculates the absolute azimuth, elevation, and composite angles using a cached local frame at the 'from' entity.
+  * WGS-84 and tangent plane models use the cached frame; other models behave as calculateAbsAzEl() at fromFrame.originLla().
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity, to which the angles are calculated
+  * @param[out] azim Azimuth value from one entity to another
+  * @param[out] elev Elevation value from one entity to another
+  * @param[out] cmp Composite value from one entity to another
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter structure with a reference origin set
+  * @pre fromFrame must be valid and one of the azim, elev and cmp params must be valid
+  */
+  SDKCORE_EXPORT void calculateAbsAzEl(const LocalFrame &fromFrame, const Vec3 &toLla, double* azim, double* elev, double* cmp, const EarthModelCalculations model, const CoordinateConverter* coordConv);
+
   /**
   * @brief Calculates the slant distance between two entities
   *
@@ -83,6 +114,18 @@ namespace simCore
   */
   SDKCORE_EXPORT double calculateSlant(const Vec3 &fromLla, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
 
+  /**
+  * Calculates the slant distance using a cached local frame at the 'from' entity.  WGS-84 and tangent plane
+  * models use the cached frame; other models behave as calculateSlant() at fromFrame.originLla().
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter structure with a reference origin set
+  * @return Slant distance between two objects in meters, with a 0 return indicating an error (or equality of points)
+  * @pre fromFrame must be valid
+  */
+  SDKCORE_EXPORT double calculateSlant(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
+
   /**
   * @brief Calculates the ground distance between two entities
   *
@@ -98,6 +141,18 @@ namespace simCore
   */
   SDKCORE_EXPORT double calculateGroundDist(const Vec3 &fromLla, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
 
+  /**
+  * Calculates the ground distance using a cached local frame at the 'from' entity.  The tangent plane
+  * model uses the cached frame; other models behave as calculateGroundDist() at fromFrame.originLla().
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter structure with a reference origin set
+  * @return Ground distance between two objects in meters, with a 0 return indicating an error (or equality of points)
+  * @pre fromFrame must be valid
+  */
+  SDKCORE_EXPORT double calculateGroundDist(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
+
   /**
   * @brief Calculates the altitude difference between two entities
   *
@@ -112,6 +167,18 @@ namespace simCore
   */
   SDKCORE_EXPORT double calculateAltitude(const Vec3 &fromLla, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
 
+  /**
+  * Calculates the altitude difference using a cached local frame at the 'from' entity.  The tangent plane
+  * model uses the cached frame; other models behave as calculateAltitude() at fromFrame.originLla().
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter structure with a reference origin set
+  * @return Altitude difference between two objects in meters; if toLla is higher than the origin, this value should be positive
+  * @pre fromFrame must be valid
+  */
+  SDKCORE_EXPORT double calculateAltitude(const LocalFrame &fromFrame, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv);
+
   /**
   * @brief Calculates the downrange, crossrange, and down values between two entities
   *
@@ -129,6 +196,21 @@ namespace simCore
   */
   SDKCORE_EXPORT void calculateDRCRDownValue(const Vec3 &fromLla, const double &yaw, const Vec3 &toLla, const EarthModelCalculations model, const CoordinateConverter* coordConv, double* downRng, double* crossRng, double* downValue);
 
+  /**
+  * Calculates the downrange, crossrange, and down values using a cached local frame at the 'from' entity.
+  * The slant range and true angles are calculated with the LocalFrame versions of calculateSlant() and calculateAbsAzEl(),
+  * using the frame's converter for flat earth, as calculateDRCRDownValue() does with a converter at the 'from' entity.
+  * @param[in ] fromFrame Local frame whose origin is the position of the 'from' entity
+  * @param[in ] yaw Yaw (heading) pointing angle for the 'from' entity
+  * @param[in ] toLla Location in space consisting of latitude, longitude, altitude that is the 'to' entity, to which the angles are calculated
+  * @param[in ] model Earth model to perform the calculation in
+  * @param[out] downRng Range along the x-axis normal to the to entity, where the x-axis is aligned with the yaw of the from entity
+  * @param[out] crossRng Distance measured along a line whose direction is either 90deg CW (positive) or 90deg CCW (neg) to the projection of from's yaw into a horizontal plane
+  * @param[out] downValue Shortest distance between a plane tangent to the earth at from's position and altitude and the to entity
+  * @pre fromFrame must be valid
+  */
+  SDKCORE_EXPORT void calculateDRCRDownValue(const LocalFrame &fromFrame, const double &yaw, const Vec3 &toLla, const EarthModelCalculations model, double* downRng, double* crossRng, double* downValue);
+
   /**
   * @brief Calculates the geodesic downrange and crossrange values between two entities
   *
@@ -32,9 +32,107 @@
 
 namespace simCore
 {
-  // used only in convertEcefToGeodeticPos; e' in Fukushima 1999
+  // used only in ecefToGeodetic; e' in Fukushima 1999
   static const double FUKUSHIMA_eP = sqrt(WGS_ESQC);
 
+  /**
+  * Converts an ECEF position to geodetic using Fukushima's method; shared by the single point
+  * and batch routines so that both give identical results.  On failure only lon is set.
+  * @return 0 on success, !0 if the iteration degenerates
+  */
+  static int ecefToGeodetic(double x, double y, double z, double& lat, double& lon, double& alt)
+  {
+    if (x != 0.0)
+    {
+      lon = atan2(y, x);
+    }
+    else
+    {
+      if (y > 0.0)
+      {
+        lon = M_PI_2;
+      }
+      else if (y < 0.0)
+      {
+        lon = -M_PI_2;
+      }
+      else
+      {
+        // at pole or at center of the earth
+        lon = 0.0;
+        if (z > 0.0)
+        { // north pole
+          lat = M_PI_2;
+          alt = z - WGS_B;
+        }
+        else if (z < 0.0)
+        { // south pole
+          lat = -M_PI_2;
+          alt = -z - WGS_B;
+        }
+        else
+        { // center of earth
+          lat = M_PI_2;
+          alt = -WGS_B;
+        }
+        return 0;
+      }
+    }
+
+    // derived from:
+    // Fukushima T., (2006) : Transformation from Cartesian to geodetic coordinates accelerated by Halley's method
+    //   Journal of Geodesy, Vol. 79, pp. 689-693.
+    // Note: Variable names follow the notation therein
+
+    // p is distance from Z axis
+    const double p = sqrt(square(x) + square(y));
+    // in the Fukushima document, this is notated as: P
+    const double PP = p / WGS_A;
+    const double Z = FUKUSHIMA_eP * fabs(z) / WGS_A;
+    double S = Z;
+    double C = WGS_ESQC * PP;
+    double Cc = C * FUKUSHIMA_eP;
+
+    for (int i = 0; i < 2; ++i)
+    {
+      // iterative section, Halley's iterative formula
+      {
+        const double A = sqrt(S * S + C * C);
+        const double B = 1.5 * WGS_ESQ * S * C * C * ((PP * S - Z * C) * A - WGS_ESQ * S * C);
+        const double D = Z * A * A * A + WGS_ESQ * S * S * S;
+        const double F = PP * A * A * A - WGS_ESQ * C * C * C;
+        S = D * F - B * S;
+        C = F * F - B * C;
+      }
+
+      // C == 0 should be equivalent to x == 0 && y == 0, which is handled by polar/center-of-earth code above
+      if (C == 0.0)
+      {
+        assert(0);
+        return 1;
+      }
+
+      Cc = C * FUKUSHIMA_eP;
+      if (S == 0.0 || sign(S) == sign(Cc))
+      {
+        // testing suggests that one iteration is sufficient for cases when
+        // S/Cc is positive and the atan(S / Cc) is first-quadrant.
+        break;
+      }
+      //else
+      // SIM-13615 provided test cases with points near center-of-earth
+      // where one-iteration condition was not met. testing suggests that
+      // 2 iterations produces an acceptable result in these cases.
+    }
+    lat = sign(z) * atan(S / Cc);
+    const double num = Cc * p + fabs(z) * S - WGS_B * (sqrt(C * C + S * S));
+    const double den = sqrt(Cc * Cc + S * S);
+    // den cannot be 0.0 if C != 0.0
+    alt = num/den;
+
+    return 0;
+  }
+
 //------------------------------------------------------------------------
 Coordinate::Coordinate()
   : system_(COORD_SYS_NONE),
@@ -2082,96 +2180,7 @@ int CoordinateConverter::convertEcefToGeodeticPos(const Vec3 &ecefPos, Vec3 &lla
     return 1;
   }
 
-  if (ecefPos.x() != 0.0)
-  {
-    llaPos.setLon(atan2(ecefPos.y(), ecefPos.x()));
-  }
-  else
-  {
-    if (ecefPos.y() > 0.0)
-    {
-      llaPos.setLon(M_PI_2);
-    }
-    else if (ecefPos.y() < 0.0)
-    {
-      llaPos.setLon(-M_PI_2);
-    }
-    else
-    {
-      // at pole or at center of the earth
-      llaPos.setLon(0.0);
-      if (ecefPos.z() > 0.0)
-      { // north pole
-        llaPos.setLat(M_PI_2);
-        llaPos.setAlt(ecefPos.z() - WGS_B);
-      }
-      else if (ecefPos.z() < 0.0)
-      { // south pole
-        llaPos.setLat(-M_PI_2);
-        llaPos.setAlt(-ecefPos.z() - WGS_B);
-      }
-      else
-      { // center of earth
-        llaPos.setLat(M_PI_2);
-        llaPos.setAlt(-WGS_B);
-      }
-      return 0;
-    }
-  }
-
-  // derived from:
-  // Fukushima T., (2006) : Transformation from Cartesian to geodetic coordinates accelerated by Halley's method
-  //   Journal of Geodesy, Vol. 79, pp. 689-693.
-  // Note: Variable names follow the notation therein
-
-  // p is distance from Z axis
-  const double p = sqrt(square(ecefPos.x()) + square(ecefPos.y()));
-  // in the Fukushima document, this is notated as: P
-  const double PP = p / WGS_A;
-  const double Z = FUKUSHIMA_eP * fabs(ecefPos.z()) / WGS_A;
-  double S = Z;
-  double C = WGS_ESQC * PP;
-  double Cc = C * FUKUSHIMA_eP;
-
-  for (int i = 0; i < 2; ++i)
-  {
-    // iterative section, Halley's iterative formula
-    {
-      const double A = sqrt(S * S + C * C);
-      const double B = 1.5 * WGS_ESQ * S * C * C * ((PP * S - Z * C) * A - WGS_ESQ * S * C);
-      const double D = Z * A * A * A + WGS_ESQ * S * S * S;
-      const double F = PP * A * A * A - WGS_ESQ * C * C * C;
-      S = D * F - B * S;
-      C = F * F - B * C;
-    }
-
-    // C == 0 should be equivalent to x == 0 && y == 0, which is handled by polar/center-of-earth code above
-    if (C == 0.0)
-    {
-      assert(0);
-      return 1;
-    }
-
-    Cc = C * FUKUSHIMA_eP;
-    if (S == 0.0 || sign(S) == sign(Cc))
-    {
-      // testing suggests that one iteration is sufficient for cases when
-      // S/Cc is positive and the atan(S / Cc) is first-quadrant.
-      break;
-    }
-    //else
-    // SIM-13615 provided test cases with points near center-of-earth
-    // where one-iteration condition was not met. testing suggests that
-    // 2 iterations produces an acceptable result in these cases.
-  }
-  const double lat = sign(ecefPos.z()) * atan(S / Cc);
-  const double num = Cc * p + fabs(ecefPos.z()) * S - WGS_B * (sqrt(C * C + S * S));
-  const double den = sqrt(Cc * Cc + S * S);
-  llaPos.setLat(lat);
-  // den cannot be 0.0 if C != 0.0
-  llaPos.setAlt(num/den);
-
-  return 0;
+  return ecefToGeodetic(ecefPos.x(), ecefPos.y(), ecefPos.z(), llaPos[0], llaPos[1], llaPos[2]);
 }
 
 /// convert geodetic projection to earth centered, earth fixed projection
@@ -2274,4 +2283,167 @@ void CoordinateConverter::convertGeodeticOriToEcef(const Vec3 &llaPos, const Vec
   d3DCMtoEuler(BE, ecefOri);
 }
 
+//------------------------------------------------------------------------
+// Batch conversions
+
+void CoordinateConverter::convertGeodeticPosToEcef(size_t count, const ConstVec3Arrays& llaPos, const Vec3Arrays& ecefPos)
+{
+  // same arithmetic as the single point convertGeodeticPosToEcef() with the WGS-84 defaults
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double lat = llaPos.x[i];
+    const double lon = llaPos.y[i];
+    const double alt = llaPos.z[i];
+    const double sLat = sin(lat);
+    const double Rn = WGS_A / sqrt(1.0 - WGS_ESQ * square(sLat));
+    const double cLat = cos(lat);
+    const double horizontal = (Rn + alt) * cLat;
+    ecefPos.x[i] = horizontal * cos(lon);
+    ecefPos.y[i] = horizontal * sin(lon);
+    ecefPos.z[i] = (Rn * (1.0 - WGS_ESQ) + alt) * sLat;
+  }
+}
+
+int CoordinateConverter::convertEcefToGeodeticPos(size_t count, const ConstVec3Arrays& ecefPos, const Vec3Arrays& llaPos)
+{
+  int rv = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    double lat = 0.0;
+    double lon = 0.0;
+    double alt = 0.0;
+    if (ecefToGeodetic(ecefPos.x[i], ecefPos.y[i], ecefPos.z[i], lat, lon, alt) != 0)
+      rv = 1;
+    llaPos.x[i] = lat;
+    llaPos.y[i] = lon;
+    llaPos.z[i] = alt;
+  }
+  return rv;
+}
+
+void CoordinateConverter::convertGeodeticVelToEcef(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& llaVel, const Vec3Arrays& ecefVel)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double sLat = sin(llaPos.x[i]);
+    const double cLat = cos(llaPos.x[i]);
+    const double sLon = sin(llaPos.y[i]);
+    const double cLon = cos(llaPos.y[i]);
+    const double east = llaVel.x[i];
+    const double north = llaVel.y[i];
+    const double up = llaVel.z[i];
+    // sum of the east, north and up unit vectors in ECEF, scaled by the velocity components
+    ecefVel.x[i] = -sLon * east - sLat * cLon * north + cLat * cLon * up;
+    ecefVel.y[i] = cLon * east - sLat * sLon * north + cLat * sLon * up;
+    ecefVel.z[i] = cLat * north + sLat * up;
+  }
+}
+
+void CoordinateConverter::convertEcefToGeodeticVel(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& ecefVel, const Vec3Arrays& llaVel)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double sLat = sin(llaPos.x[i]);
+    const double cLat = cos(llaPos.x[i]);
+    const double sLon = sin(llaPos.y[i]);
+    const double cLon = cos(llaPos.y[i]);
+    const double vx = ecefVel.x[i];
+    const double vy = ecefVel.y[i];
+    const double vz = ecefVel.z[i];
+    // project onto the east, north and up unit vectors
+    llaVel.x[i] = -sLon * vx + cLon * vy;
+    llaVel.y[i] = -sLat * cLon * vx - sLat * sLon * vy + cLat * vz;
+    llaVel.z[i] = cLat * cLon * vx + cLat * sLon * vy + sLat * vz;
+  }
+}
+
+void CoordinateConverter::convertGeodeticOriToEcef(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& llaOri, const Vec3Arrays& ecefOri, LocalLevelFrame localLevelFrame)
+{
+  double LE[3][3];
+  double BL[3][3];
+  double BE[3][3];
+  Vec3 ecef;
+  for (size_t i = 0; i < count; ++i)
+  {
+    CoordinateConverter::setLocalToEarthMatrix(llaPos.x[i], llaPos.y[i], localLevelFrame, LE);
+    d3EulertoDCM(Vec3(llaOri.x[i], llaOri.y[i], llaOri.z[i]), BL);
+    d3MMmult(BL, LE, BE);
+    d3DCMtoEuler(BE, ecef);
+    ecefOri.x[i] = ecef.x();
+    ecefOri.y[i] = ecef.y();
+    ecefOri.z[i] = ecef.z();
+  }
+}
+
+void CoordinateConverter::convertEcefToGeodeticOri(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& ecefOri, const Vec3Arrays& llaOri, LocalLevelFrame localLevelFrame)
+{
+  double LE[3][3];
+  double BE[3][3];
+  double BL[3][3];
+  Vec3 lla;
+  for (size_t i = 0; i < count; ++i)
+  {
+    CoordinateConverter::setLocalToEarthMatrix(llaPos.x[i], llaPos.y[i], localLevelFrame, LE);
+    d3EulertoDCM(Vec3(ecefOri.x[i], ecefOri.y[i], ecefOri.z[i]), BE);
+    d3MMTmult(BE, LE, BL);
+    d3DCMtoEuler(BL, lla);
+    llaOri.x[i] = lla.x();
+    llaOri.y[i] = lla.y();
+    llaOri.z[i] = lla.z();
+  }
+}
+
+void CoordinateConverter::convertEciToEcefPos(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciPos, const Vec3Arrays& ecefPos)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    // ECI to ECEF is a negative rotation about the z axis, as in convertEciEcef_()
+    const double eciRotation = angFix2PI(-EARTH_ROTATION_RATE * elapsedEciTimes[i]);
+    const double cosOmega = cos(eciRotation);
+    const double sinOmega = sin(eciRotation);
+    const double x = eciPos.x[i];
+    const double y = eciPos.y[i];
+    ecefPos.x[i] = cosOmega * x - sinOmega * y;
+    ecefPos.y[i] = cosOmega * y + sinOmega * x;
+    ecefPos.z[i] = eciPos.z[i];
+  }
+}
+
+void CoordinateConverter::convertEciToEcefVel(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciPos, const ConstVec3Arrays& eciVel, const Vec3Arrays& ecefVel)
+{
+  const double rotationRate = -EARTH_ROTATION_RATE;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double eciRotation = angFix2PI(rotationRate * elapsedEciTimes[i]);
+    const double cosOmega = cos(eciRotation);
+    const double sinOmega = sin(eciRotation);
+    // remove the earth rotation component, then rotate
+    const double xVel = eciVel.x[i] - rotationRate * eciPos.y[i];
+    const double yVel = eciVel.y[i] + rotationRate * eciPos.x[i];
+    ecefVel.x[i] = xVel * cosOmega - yVel * sinOmega;
+    ecefVel.y[i] = yVel * cosOmega + xVel * sinOmega;
+    ecefVel.z[i] = eciVel.z[i];
+  }
+}
+
+void CoordinateConverter::convertEciToEcefOri(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciOri, const Vec3Arrays& ecefOri)
+{
+  double BE[3][3];
+  double BL[3][3];
+  Vec3 ecef;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double eciRotation = angFix2PI(-EARTH_ROTATION_RATE * elapsedEciTimes[i]);
+    const double cosOmega = cos(eciRotation);
+    const double sinOmega = sin(eciRotation);
+    const double zRot[3][3] = {{cosOmega, sinOmega, 0.}, {-sinOmega, cosOmega, 0.}, {0., 0., 1.}};
+    d3EulertoDCM(Vec3(eciOri.x[i], eciOri.y[i], eciOri.z[i]), BE);
+    d3MMmult(BE, zRot, BL);
+    d3DCMtoEuler(BL, ecef);
+    ecefOri.x[i] = ecef.x();
+    ecefOri.y[i] = ecef.y();
+    ecefOri.z[i] = ecef.z();
+  }
+}
+
 } // namespace simCore
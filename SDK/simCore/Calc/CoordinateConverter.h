@@ -108,6 +108,33 @@ namespace simCore
     LOCAL_LEVEL_FRAME_ENU     ///< Local level ENU frame: +X=East, +Y=North, +Z=Up, perpendicular to Earth surface
   };
 
+  /**
+  * Structure-of-arrays view of a set of vectors, used by the CoordinateConverter batch routines.
+  * Element i of each array holds one component of vector i.  The arrays are owned by the caller.
+  */
+  struct Vec3Arrays
+  {
+    /** Constructs from three component arrays */
+    Vec3Arrays(double* xIn, double* yIn, double* zIn) : x(xIn), y(yIn), z(zIn) {}
+
+    double* x;  ///< First component (X, latitude or yaw)
+    double* y;  ///< Second component (Y, longitude or pitch)
+    double* z;  ///< Third component (Z, altitude or roll)
+  };
+
+  /** Read-only version of Vec3Arrays, for batch inputs */
+  struct ConstVec3Arrays
+  {
+    /** Constructs from three component arrays */
+    ConstVec3Arrays(const double* xIn, const double* yIn, const double* zIn) : x(xIn), y(yIn), z(zIn) {}
+    /** Reads from writable arrays, such as the output of another batch conversion */
+    ConstVec3Arrays(const Vec3Arrays& arrays) : x(arrays.x), y(arrays.y), z(arrays.z) {}
+
+    const double* x;  ///< First component (X, latitude or yaw)
+    const double* y;  ///< Second component (Y, longitude or pitch)
+    const double* z;  ///< Third component (Z, altitude or roll)
+  };
+
   class SDKCORE_EXPORT CoordinateConverter
   {
   public:
@@ -510,6 +537,100 @@ namespace simCore
     */
     static void convertEcefToGeodeticAccel(const Vec3 &llaPos, const Vec3 &ecefAcc, Vec3 &llaAcc, LocalLevelFrame localLevelFrame = LOCAL_LEVEL_FRAME_NED);
 
+    /**@name Batch conversions
+    * Convert many points at once, with the same results as the single-point routines above.
+    * Inputs and outputs are structure-of-arrays vectors of count elements each, with no
+    * per-point Coordinate, so the loops stay tight for large imports and backfills.  Each point
+    * is read before it is written, so an output may reuse the arrays of an input to convert in
+    * place.  Velocities in geodetic coordinates are east/north/up, as in Coordinate, and the
+    * local level frame only affects the orientation Euler angles.
+    * @{
+    */
+
+    /**
+    * Converts geodetic positions to ECEF
+    * @param[in ] count Number of points
+    * @param[in ] llaPos latitude (rad), longitude (rad), altitude (m)
+    * @param[out] ecefPos X (m), Y (m), Z (m)
+    */
+    static void convertGeodeticPosToEcef(size_t count, const ConstVec3Arrays& llaPos, const Vec3Arrays& ecefPos);
+
+    /**
+    * Converts ECEF positions to geodetic
+    * @param[in ] count Number of points
+    * @param[in ] ecefPos X (m), Y (m), Z (m)
+    * @param[out] llaPos latitude (rad), longitude (rad), altitude (m)
+    * @return 0 on success, !0 if any point failed to converge
+    */
+    static int convertEcefToGeodeticPos(size_t count, const ConstVec3Arrays& ecefPos, const Vec3Arrays& llaPos);
+
+    /**
+    * Converts geodetic velocities to ECEF
+    * @param[in ] count Number of points
+    * @param[in ] llaPos Geodetic positions of the points
+    * @param[in ] llaVel East, north, up velocity (m/s)
+    * @param[out] ecefVel ECEF velocity (m/s)
+    */
+    static void convertGeodeticVelToEcef(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& llaVel, const Vec3Arrays& ecefVel);
+
+    /**
+    * Converts ECEF velocities to geodetic
+    * @param[in ] count Number of points
+    * @param[in ] llaPos Geodetic positions of the points
+    * @param[in ] ecefVel ECEF velocity (m/s)
+    * @param[out] llaVel East, north, up velocity (m/s)
+    */
+    static void convertEcefToGeodeticVel(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& ecefVel, const Vec3Arrays& llaVel);
+
+    /**
+    * Converts geodetic Euler angles to ECEF Euler angles
+    * @param[in ] count Number of points
+    * @param[in ] llaPos Geodetic positions of the points
+    * @param[in ] llaOri Yaw, pitch, roll (rad) relative to the local level frame
+    * @param[out] ecefOri Yaw, pitch, roll (rad) relative to ECEF
+    * @param[in ] localLevelFrame alignment of local geodetic horizon system (NED, ENU, NWU)
+    */
+    static void convertGeodeticOriToEcef(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& llaOri, const Vec3Arrays& ecefOri, LocalLevelFrame localLevelFrame = LOCAL_LEVEL_FRAME_NED);
+
+    /**
+    * Converts ECEF Euler angles to geodetic Euler angles
+    * @param[in ] count Number of points
+    * @param[in ] llaPos Geodetic positions of the points
+    * @param[in ] ecefOri Yaw, pitch, roll (rad) relative to ECEF
+    * @param[out] llaOri Yaw, pitch, roll (rad) relative to the local level frame
+    * @param[in ] localLevelFrame alignment of local geodetic horizon system (NED, ENU, NWU)
+    */
+    static void convertEcefToGeodeticOri(size_t count, const ConstVec3Arrays& llaPos, const ConstVec3Arrays& ecefOri, const Vec3Arrays& llaOri, LocalLevelFrame localLevelFrame = LOCAL_LEVEL_FRAME_NED);
+
+    /**
+    * Converts ECI positions to ECEF
+    * @param[in ] count Number of points
+    * @param[in ] elapsedEciTimes Elapsed ECI time (s) of each point
+    * @param[in ] eciPos ECI position (m)
+    * @param[out] ecefPos ECEF position (m)
+    */
+    static void convertEciToEcefPos(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciPos, const Vec3Arrays& ecefPos);
+
+    /**
+    * Converts ECI velocities to ECEF, removing the earth rotation component
+    * @param[in ] count Number of points
+    * @param[in ] elapsedEciTimes Elapsed ECI time (s) of each point
+    * @param[in ] eciPos ECI position (m)
+    * @param[in ] eciVel ECI velocity (m/s)
+    * @param[out] ecefVel ECEF velocity (m/s)
+    */
+    static void convertEciToEcefVel(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciPos, const ConstVec3Arrays& eciVel, const Vec3Arrays& ecefVel);
+
+    /**
+    * Converts ECI Euler angles to ECEF
+    * @param[in ] count Number of points
+    * @param[in ] elapsedEciTimes Elapsed ECI time (s) of each point
+    * @param[in ] eciOri Yaw, pitch, roll (rad) relative to ECI
+    * @param[out] ecefOri Yaw, pitch, roll (rad) relative to ECEF
+    */
+    static void convertEciToEcefOri(size_t count, const double* elapsedEciTimes, const ConstVec3Arrays& eciOri, const Vec3Arrays& ecefOri);
+    ///@}
+
   private: // data
     double latRadius_;                   /// radius of earth at reference  latitude (m)
     double lonRadius_;                   /// radius of earth at reference longitude (m)
@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <limits>
 #include "simCore/Calc/Geometry.h"
 #include "simCore/Calc/CoordinateSystem.h"
 #include "simCore/Calc/CoordinateConverter.h"
@@ -195,4 +196,96 @@ bool GeoFence::verifyConvexity_(const Vec3String& v) const
   return true;
 }
 
-}
\ No newline at end of file
+namespace
+{
+  /** Distance from p to the segment [a, b] */
+  double distanceToSegment(const Vec3& p, const Vec3& a, const Vec3& b)
+  {
+    Vec3 ab;
+    Vec3 ap;
+    v3Subtract(b, a, ab);
+    v3Subtract(p, a, ap);
+    const double length2 = v3Dot(ab, ab);
+    if (length2 <= 0.0)
+      return v3Length(ap);
+
+    const double t = simCore::sdkMax(0.0, simCore::sdkMin(1.0, v3Dot(ap, ab) / length2));
+    Vec3 closest;
+    v3Scale(t, ab, closest);
+    v3Add(a, closest, closest);
+    return v3Distance(p, closest);
+  }
+
+  /** Range of vertices still to be split, along with the importance of the vertex that created it */
+  struct DouglasPeuckerSpan
+  {
+    size_t first;
+    size_t last;
+    double limit;
+  };
+}
+
+void douglasPeuckerImportance(const Vec3String& points, std::vector<double>& importance)
+{
+  const size_t count = points.size();
+  importance.assign(count, 0.0);
+  if (count == 0)
+    return;
+  importance.front() = std::numeric_limits<double>::max();
+  importance.back() = std::numeric_limits<double>::max();
+  if (count < 3)
+    return;
+
+  // Split iteratively rather than recursively; long polylines with many corners would otherwise run deep
+  std::vector<DouglasPeuckerSpan> spans;
+  DouglasPeuckerSpan all = { 0, count - 1, std::numeric_limits<double>::max() };
+  spans.push_back(all);
+  while (!spans.empty())
+  {
+    const DouglasPeuckerSpan span = spans.back();
+    spans.pop_back();
+    if (span.last <= span.first + 1)
+      continue;
+
+    size_t farthest = span.first + 1;
+    double maxDistance = -1.0;
+    for (size_t k = span.first + 1; k < span.last; ++k)
+    {
+      const double distance = distanceToSegment(points[k], points[span.first], points[span.last]);
+      if (distance > maxDistance)
+      {
+        maxDistance = distance;
+        farthest = k;
+      }
+    }
+
+    // A vertex can only be retained if the vertex that split its span is retained, so its
+    // importance is capped at that of its parent; this makes importance thresholds match
+    // the results of running Douglas-Peucker at each tolerance
+    const double rank = simCore::sdkMin(maxDistance, span.limit);
+    importance[farthest] = rank;
+    DouglasPeuckerSpan before = { span.first, farthest, rank };
+    DouglasPeuckerSpan after = { farthest, span.last, rank };
+    spans.push_back(before);
+    spans.push_back(after);
+  }
+}
+
+void douglasPeuckerSelect(const std::vector<double>& importance, double tolerance, std::vector<size_t>& indices)
+{
+  indices.clear();
+  for (size_t k = 0; k < importance.size(); ++k)
+  {
+    if (importance[k] > tolerance)
+      indices.push_back(k);
+  }
+}
+
+void douglasPeucker(const Vec3String& points, double tolerance, std::vector<size_t>& indices)
+{
+  std::vector<double> importance;
+  douglasPeuckerImportance(points, importance);
+  douglasPeuckerSelect(importance, tolerance, indices);
+}
+
+}
@@ -103,6 +103,9 @@ namespace simCore
     */
     bool contains(const Vec3& point) const;
 
+    /** Bounding planes of the polytope */
+    const std::vector<Plane>& planes() const { return planes_; }
+
     /**
     * Resets the polytope by removing all planes.
     */
@@ -170,6 +173,9 @@ namespace simCore
     */
     bool contains(const Coordinate& coord) const;
 
+    /** Volume bounded by the fence, in ECEF; useful for culling with a SpatialIndex */
+    const Polytope& polytope() const { return tope_; }
+
     /** dtor */
     virtual ~GeoFence() { }
 
@@ -186,6 +192,37 @@ namespace simCore
     bool verifyConvexity_(const Vec3String& v) const;
   };
 
+  /**
+  * Ranks each vertex of a polyline for Douglas-Peucker simplification.  A vertex's importance
+  * is the largest tolerance at which Douglas-Peucker simplification retains that vertex, so the
+  * polyline can be simplified at any tolerance by keeping the vertices whose importance exceeds
+  * the tolerance.  This lets a caller build several levels of detail from a single pass.
+  * Distances are measured to the segment between the retained vertices, in the units of the
+  * points.  The first and last vertices always have an importance of std::numeric_limits<double>::max().
+  * @param[in ] points Polyline vertices, in order
+  * @param[out] importance Importance of each vertex, parallel to points
+  */
+  SDKCORE_EXPORT void douglasPeuckerImportance(const Vec3String& points, std::vector<double>& importance);
+
+  /**
+  * Selects the vertices retained by Douglas-Peucker simplification at the given tolerance,
+  * using importance values from douglasPeuckerImportance().
+  * @param[in ] importance Importance of each vertex, from douglasPeuckerImportance()
+  * @param[in ] tolerance Maximum distance of a dropped vertex from the simplified polyline
+  * @param[out] indices Indices of the retained vertices, in increasing order
+  */
+  SDKCORE_EXPORT void douglasPeuckerSelect(const std::vector<double>& importance, double tolerance, std::vector<size_t>& indices);
+
+  /**
+  * Simplifies a polyline with the Douglas-Peucker algorithm.  Every dropped vertex lies within
+  * the tolerance of the segment between the retained vertices on either side of it.  The first
+  * and last vertices are always retained.
+  * @param[in ] points Polyline vertices, in order
+  * @param[in ] tolerance Maximum distance of a dropped vertex from the simplified polyline
+  * @param[out] indices Indices of the retained vertices, in increasing order
+  */
+  SDKCORE_EXPORT void douglasPeucker(const Vec3String& points, double tolerance, std::vector<size_t>& indices);
+
 } // namespace simCore
 
 #endif /* SIMCORE_CALC_GEOMETRY_H */
@@ -0,0 +1,198 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cassert>
+#include <cmath>
+#include "simCore/Calc/Math.h"
+#include "simCore/Calc/LocalFrame.h"
+
+namespace simCore
+{
+
+LocalFrame::LocalFrame()
+  : valid_(false)
+{
+  for (size_t row = 0; row < 3; ++row)
+  {
+    for (size_t col = 0; col < 3; ++col)
+    {
+      localToEarthNED_[row][col] = (row == col) ? 1.0 : 0.0;
+      localToEarthENU_[row][col] = (row == col) ? 1.0 : 0.0;
+    }
+  }
+}
+
+LocalFrame::LocalFrame(const Vec3& originLla)
+  : valid_(false)
+{
+  setOrigin(originLla);
+}
+
+LocalFrame::~LocalFrame()
+{
+}
+
+void LocalFrame::setOrigin(const Vec3& originLla)
+{
+  if (valid_ && originLla_ == originLla)
+    return;
+  valid_ = true;
+  originLla_ = originLla;
+  converter_.setReferenceOrigin(originLla);
+
+  const double sinLat = sin(originLla.lat());
+  const double cosLat = cos(originLla.lat());
+  const double sinLon = sin(originLla.lon());
+  const double cosLon = cos(originLla.lon());
+
+  // NED local level frame, as in CoordinateConverter::setLocalToEarthMatrix()
+  localToEarthNED_[0][0] = -sinLat * cosLon;
+  localToEarthNED_[0][1] = -sinLat * sinLon;
+  localToEarthNED_[0][2] = cosLat;
+  localToEarthNED_[1][0] = -sinLon;
+  localToEarthNED_[1][1] = cosLon;
+  localToEarthNED_[1][2] = 0.0;
+  localToEarthNED_[2][0] = -cosLat * cosLon;
+  localToEarthNED_[2][1] = -cosLat * sinLon;
+  localToEarthNED_[2][2] = -sinLat;
+
+  // ENU local level frame, which is also the X-East tangent plane rotation
+  localToEarthENU_[0][0] = -sinLon;
+  localToEarthENU_[0][1] = cosLon;
+  localToEarthENU_[0][2] = 0.0;
+  localToEarthENU_[1][0] = -sinLat * cosLon;
+  localToEarthENU_[1][1] = -sinLat * sinLon;
+  localToEarthENU_[1][2] = cosLat;
+  localToEarthENU_[2][0] = cosLat * cosLon;
+  localToEarthENU_[2][1] = cosLat * sinLon;
+  localToEarthENU_[2][2] = sinLat;
+
+  // same translation as the CoordinateConverter X-East tangent plane
+  const double rN = WGS_A / sqrt(1.0 - WGS_ESQ * sinLat * sinLat);
+  const double horizontal = (rN + originLla.alt()) * cosLat;
+  originEcef_.set(cosLon * horizontal, sinLon * horizontal, (WGS_ESQC * rN + originLla.alt()) * sinLat);
+}
+
+bool LocalFrame::isValid() const
+{
+  return valid_;
+}
+
+const Vec3& LocalFrame::originLla() const
+{
+  return originLla_;
+}
+
+const Vec3& LocalFrame::originEcef() const
+{
+  return originEcef_;
+}
+
+const CoordinateConverter& LocalFrame::converter() const
+{
+  return converter_;
+}
+
+void LocalFrame::localToEarthMatrix(LocalLevelFrame localLevelFrame, double localToEarth[][3]) const
+{
+  for (size_t col = 0; col < 3; ++col)
+  {
+    switch (localLevelFrame)
+    {
+    case LOCAL_LEVEL_FRAME_NED:
+      localToEarth[0][col] = localToEarthNED_[0][col];
+      localToEarth[1][col] = localToEarthNED_[1][col];
+      localToEarth[2][col] = localToEarthNED_[2][col];
+      break;
+    case LOCAL_LEVEL_FRAME_NWU:
+      // NWU negates the Y and Z axes of NED
+      localToEarth[0][col] = localToEarthNED_[0][col];
+      localToEarth[1][col] = -localToEarthNED_[1][col];
+      localToEarth[2][col] = -localToEarthNED_[2][col];
+      break;
+    case LOCAL_LEVEL_FRAME_ENU:
+    default:
+      localToEarth[0][col] = localToEarthENU_[0][col];
+      localToEarth[1][col] = localToEarthENU_[1][col];
+      localToEarth[2][col] = localToEarthENU_[2][col];
+      break;
+    }
+  }
+}
+
+void LocalFrame::geodeticToLocal(const Vec3& lla, Vec3& local) const
+{
+  assert(valid_);
+  Vec3 ecef;
+  CoordinateConverter::convertGeodeticPosToEcef(lla, ecef);
+  ecefToLocal(ecef, local);
+}
+
+void LocalFrame::ecefToLocal(const Vec3& ecef, Vec3& local) const
+{
+  assert(valid_);
+  Vec3 delta;
+  v3Subtract(ecef, originEcef_, delta);
+  d3Mv3Mult(localToEarthENU_, delta, local);
+}
+
+void LocalFrame::localToEcef(const Vec3& local, Vec3& ecef) const
+{
+  assert(valid_);
+  Vec3 delta;
+  d3MTv3Mult(localToEarthENU_, local, delta);
+  v3Add(delta, originEcef_, ecef);
+}
+
+void LocalFrame::rotateEcefToLocal(const Vec3& ecefVec, Vec3& localVec) const
+{
+  assert(valid_);
+  d3Mv3Mult(localToEarthENU_, ecefVec, localVec);
+}
+
+void LocalFrame::rotateLocalToEcef(const Vec3& localVec, Vec3& ecefVec) const
+{
+  assert(valid_);
+  d3MTv3Mult(localToEarthENU_, localVec, ecefVec);
+}
+
+void LocalFrame::geodeticOriToEcef(const Vec3& llaOri, Vec3& ecefOri) const
+{
+  assert(valid_);
+  double BL[3][3];
+  d3EulertoDCM(llaOri, BL);
+  double BE[3][3];
+  d3MMmult(BL, localToEarthNED_, BE);
+  d3DCMtoEuler(BE, ecefOri);
+}
+
+void LocalFrame::ecefOriToGeodetic(const Vec3& ecefOri, Vec3& llaOri) const
+{
+  assert(valid_);
+  double BE[3][3];
+  d3EulertoDCM(ecefOri, BE);
+  double BL[3][3];
+  d3MMTmult(BE, localToEarthNED_, BL);
+  d3DCMtoEuler(BL, llaOri);
+}
+
+}
@@ -0,0 +1,132 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_CALC_LOCALFRAME_H
+#define SIMCORE_CALC_LOCALFRAME_H
+
+#include "simCore/Common/Export.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Vec3.h"
+
+namespace simCore
+{
+
+/**
+ * Caches the local level frame for a reference point, typically the host of a set of relative
+ * calculations.  Setting the origin computes the ECEF position of the origin, the local to earth
+ * rotation matrices and a CoordinateConverter whose reference origin is the same point, so that
+ * repeated calculations against the same host do the trigonometry once instead of once per call.
+ *
+ * Local coordinates are X-East tangent plane coordinates (ENU, in meters) relative to the origin,
+ * matching CoordinateConverter conversions to COORD_SYS_XEAST with the same reference origin.
+ *
+ * A LocalFrame is not modified by the calculations that use it, so a single instance may be
+ * shared by calculations running on multiple threads.
+ */
+class SDKCORE_EXPORT LocalFrame
+{
+public:
+  /** Constructs a frame without an origin; isValid() returns false until setOrigin() is called */
+  LocalFrame();
+  /** Constructs a frame at the given origin: lat (rad), lon (rad), alt (m) */
+  explicit LocalFrame(const Vec3& originLla);
+  virtual ~LocalFrame();
+
+  /**
+   * Sets the origin of the frame and updates the cached values.  Setting the same origin again
+   * does not recompute anything.
+   * @param originLla Origin lat (rad), lon (rad), alt (m)
+   */
+  void setOrigin(const Vec3& originLla);
+  /** Returns true if an origin has been set */
+  bool isValid() const;
+
+  /** Origin lat (rad), lon (rad), alt (m) */
+  const Vec3& originLla() const;
+  /** Origin in ECEF (m) */
+  const Vec3& originEcef() const;
+  /** Coordinate converter with its reference origin at originLla() */
+  const CoordinateConverter& converter() const;
+
+  /**
+   * Retrieves the cached local to earth rotation matrix at the origin, equivalent to
+   * CoordinateConverter::setLocalToEarthMatrix(originLla().lat(), originLla().lon(), localLevelFrame, localToEarth)
+   * @param[in ] localLevelFrame Local level frame of the matrix
+   * @param[out] localToEarth Local to earth rotation matrix
+   */
+  void localToEarthMatrix(LocalLevelFrame localLevelFrame, double localToEarth[][3]) const;
+
+  /**
+   * Converts a geodetic position to local X-East coordinates
+   * @param[in ] lla Position lat (rad), lon (rad), alt (m)
+   * @param[out] local X-East position relative to the origin (m)
+   */
+  void geodeticToLocal(const Vec3& lla, Vec3& local) const;
+  /**
+   * Converts an ECEF position to local X-East coordinates
+   * @param[in ] ecef ECEF position (m)
+   * @param[out] local X-East position relative to the origin (m)
+   */
+  void ecefToLocal(const Vec3& ecef, Vec3& local) const;
+  /**
+   * Converts a local X-East position to ECEF
+   * @param[in ] local X-East position relative to the origin (m)
+   * @param[out] ecef ECEF position (m)
+   */
+  void localToEcef(const Vec3& local, Vec3& ecef) const;
+  /**
+   * Rotates an ECEF vector, such as a velocity, into the local east/north/up axes
+   * @param[in ] ecefVec Vector in ECEF axes
+   * @param[out] localVec Vector in local east/north/up axes
+   */
+  void rotateEcefToLocal(const Vec3& ecefVec, Vec3& localVec) const;
+  /**
+   * Rotates a local east/north/up vector, such as a velocity, into ECEF axes
+   * @param[in ] localVec Vector in local east/north/up axes
+   * @param[out] ecefVec Vector in ECEF axes
+   */
+  void rotateLocalToEcef(const Vec3& localVec, Vec3& ecefVec) const;
+  /**
+   * Converts a geodetic (NED local level) orientation at the origin to an ECEF orientation
+   * @param[in ] llaOri Yaw, pitch, roll (rad) relative to the local level frame
+   * @param[out] ecefOri Euler angles (rad) relative to ECEF
+   */
+  void geodeticOriToEcef(const Vec3& llaOri, Vec3& ecefOri) const;
+  /**
+   * Converts an ECEF orientation at the origin to a geodetic (NED local level) orientation
+   * @param[in ] ecefOri Euler angles (rad) relative to ECEF
+   * @param[out] llaOri Yaw, pitch, roll (rad) relative to the local level frame
+   */
+  void ecefOriToGeodetic(const Vec3& ecefOri, Vec3& llaOri) const;
+
+private:
+  bool valid_;
+  Vec3 originLla_;
+  Vec3 originEcef_;
+  double localToEarthNED_[3][3];   ///< NED local level frame relative to ECEF
+  double localToEarthENU_[3][3];   ///< ENU local level frame relative to ECEF
+  CoordinateConverter converter_;
+};
+
+}
+
+#endif /* SIMCORE_CALC_LOCALFRAME_H */
@@ -0,0 +1,383 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include "simNotify/Notify.h"
+#include "simCore/Common/ThreadPool.h"
+#include "simCore/Calc/Calculations.h"
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/LocalFrame.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Calc/RelativeGeometry.h"
+
+namespace simCore
+{
+
+namespace
+{
+  /** Conversions of one entity, shared by every pair that includes the entity */
+  struct ConvertedStates
+  {
+    std::vector<double> ecefX;
+    std::vector<double> ecefY;
+    std::vector<double> ecefZ;
+    std::vector<double> velX;
+    std::vector<double> velY;
+    std::vector<double> velZ;
+    /** ENU positions for FLAT_EARTH, or spherical positions for PERFECT_SPHERE */
+    std::vector<Vec3> modelPos;
+
+    Vec3 ecefPos(size_t index) const { return Vec3(ecefX[index], ecefY[index], ecefZ[index]); }
+    Vec3 ecefVel(size_t index) const { return Vec3(velX[index], velY[index], velZ[index]); }
+  };
+
+  /** Converts each entity once, dividing the entities among the pool's threads */
+  void convertStates(ThreadPool& pool, const std::vector<RelativeGeometryState>& states, EarthModelCalculations model,
+    const CoordinateConverter* coordConv, bool needEcef, ConvertedStates& converted)
+  {
+    const size_t count = states.size();
+    if (needEcef)
+    {
+      converted.ecefX.resize(count);
+      converted.ecefY.resize(count);
+      converted.ecefZ.resize(count);
+      converted.velX.resize(count);
+      converted.velY.resize(count);
+      converted.velZ.resize(count);
+    }
+    const bool needModelPos = (model == FLAT_EARTH && coordConv != nullptr) || model == PERFECT_SPHERE;
+    if (needModelPos)
+      converted.modelPos.resize(count);
+
+    pool.parallelFor(count, [&](size_t begin, size_t end) {
+      if (needEcef)
+      {
+        // structure of arrays for the batch CoordinateConverter routines
+        const size_t rangeSize = end - begin;
+        std::vector<double> lla(rangeSize * 6);
+        double* lat = &lla[0];
+        double* lon = lat + rangeSize;
+        double* alt = lon + rangeSize;
+        double* east = alt + rangeSize;
+        double* north = east + rangeSize;
+        double* up = north + rangeSize;
+        for (size_t k = 0; k < rangeSize; ++k)
+        {
+          const RelativeGeometryState& state = states[begin + k];
+          lat[k] = state.lla.lat();
+          lon[k] = state.lla.lon();
+          alt[k] = state.lla.alt();
+          east[k] = state.vel.x();
+          north[k] = state.vel.y();
+          up[k] = state.vel.z();
+        }
+        const ConstVec3Arrays llaPos(lat, lon, alt);
+        CoordinateConverter::convertGeodeticPosToEcef(rangeSize, llaPos,
+          Vec3Arrays(&converted.ecefX[begin], &converted.ecefY[begin], &converted.ecefZ[begin]));
+        CoordinateConverter::convertGeodeticVelToEcef(rangeSize, llaPos, ConstVec3Arrays(east, north, up),
+          Vec3Arrays(&converted.velX[begin], &converted.velY[begin], &converted.velZ[begin]));
+      }
+
+      if (!needModelPos)
+        return;
+      for (size_t k = begin; k < end; ++k)
+      {
+        if (model == PERFECT_SPHERE)
+          geodeticToSpherical(states[k].lla.lat(), states[k].lla.lon(), states[k].lla.alt(), converted.modelPos[k]);
+        else
+        {
+          Coordinate flatPos;
+          coordConv->convert(Coordinate(COORD_SYS_LLA, states[k].lla), flatPos, COORD_SYS_ENU);
+          converted.modelPos[k] = flatPos.position();
+        }
+      }
+    });
+  }
+
+  /** Values of calculateRelAng() that depend only on the reference orientation */
+  struct RelAngReference
+  {
+    double rotMat[3][3];
+    Vec3 bodyPnt;
+
+    explicit RelAngReference(const Vec3& refOri)
+    {
+      d3EulertoDCM(refOri, rotMat);
+      calculateBodyUnitX(refOri.yaw(), refOri.pitch(), bodyPnt);
+    }
+  };
+
+  /** Same calculation as calculateRelAng(), using the precalculated reference values */
+  void relAngles(const Vec3& enuVec, const RelAngReference& ref, double* azim, double* elev, double* cmp)
+  {
+    Vec3 pntVec;
+    calculateBodyUnitX(atan2(enuVec[0], enuVec[1]), atan2(enuVec[2], sqrt(square(enuVec[0]) + square(enuVec[1]))), pntVec);
+    if (azim || elev)
+    {
+      Vec3 body;
+      d3Mv3Mult(ref.rotMat, pntVec, body);
+      double az = 0.;
+      double el = 0.;
+      calculateYawPitchFromBodyUnitX(body, az, el);
+      if (azim)
+        *azim = az;
+      if (elev)
+        *elev = el;
+    }
+    if (cmp)
+      *cmp = v3Angle(ref.bodyPnt, pntVec);
+  }
+
+  /** Same formula as calculateClosingVelocity() */
+  double closingVelocity(const Vec3& fromPos, const Vec3& fromVel, const Vec3& toPos, const Vec3& toVel)
+  {
+    Vec3 unitPosVec;
+    v3Subtract(toPos, fromPos, unitPosVec);
+    v3Unit(unitPosVec);
+    Vec3 diff;
+    v3Subtract(fromVel, toVel, diff);
+    return v3Dot(diff, unitPosVec);
+  }
+
+  /** Same formula as calculateRangeRate() */
+  double rangeRate(const RelativeGeometryState& from, const RelativeGeometryState& to, double bearing)
+  {
+    return v3Length(from.vel) * cos(from.ori[0] - bearing) - (v3Length(to.vel) * cos(to.ori[0] - bearing));
+  }
+
+  /** Pointer to the value in an optional result matrix, or nullptr if the matrix was not requested */
+  double* resultPtr(std::vector<double>& matrix, size_t index)
+  {
+    return matrix.empty() ? nullptr : &matrix[index];
+  }
+}
+
+//------------------------------------------------------------------------
+
+RelativeGeometryState::RelativeGeometryState()
+{
+}
+
+RelativeGeometryState::RelativeGeometryState(const Vec3& llaIn, const Vec3& oriIn, const Vec3& velIn)
+  : lla(llaIn),
+    ori(oriIn),
+    vel(velIn)
+{
+}
+
+RelativeGeometryBatch::Results::Results()
+  : numFrom(0),
+    numTo(0)
+{
+}
+
+//------------------------------------------------------------------------
+
+RelativeGeometryBatch::RelativeGeometryBatch(unsigned int numThreads)
+  : pool_(new ThreadPool(numThreads == 0 ? ThreadPool::hardwareThreads() : numThreads))
+{
+}
+
+RelativeGeometryBatch::~RelativeGeometryBatch()
+{
+}
+
+unsigned int RelativeGeometryBatch::numThreads() const
+{
+  return pool_->numThreads();
+}
+
+int RelativeGeometryBatch::calculate(const std::vector<RelativeGeometryState>& from, const std::vector<RelativeGeometryState>& to,
+  unsigned int outputs, EarthModelCalculations model, const CoordinateConverter* coordConv, Results& results)
+{
+  const size_t numFrom = from.size();
+  const size_t numTo = to.size();
+  const size_t numValues = numFrom * numTo;
+  results.numFrom = numFrom;
+  results.numTo = numTo;
+  std::vector<double>* matrices[] = { &results.relAzimuth, &results.relElevation, &results.relComposite,
+    &results.slantRange, &results.groundDistance, &results.rangeRate, &results.closingVelocity };
+  for (size_t k = 0; k < sizeof(matrices) / sizeof(matrices[0]); ++k)
+  {
+    matrices[k]->clear();
+    if ((outputs & (1u << k)) != 0)
+      matrices[k]->resize(numValues, 0.);
+  }
+
+  // Determine which requested values the earth model supports
+  const unsigned int angleOutputs = REL_AZIMUTH | REL_ELEVATION | REL_COMPOSITE;
+  const unsigned int rateOutputs = RANGE_RATE | CLOSING_VELOCITY;
+  unsigned int supported = 0;
+  switch (model)
+  {
+  case WGS_84:
+  case TANGENT_PLANE_WGS_84:
+    supported = ALL_OUTPUTS;
+    break;
+  case FLAT_EARTH:
+    supported = rateOutputs;
+    if (coordConv != nullptr && coordConv->hasReferenceOrigin())
+      supported = ALL_OUTPUTS;
+    else
+      coordConv = nullptr;
+    break;
+  case PERFECT_SPHERE:
+    supported = SLANT_RANGE;
+    break;
+  }
+  int rv = 0;
+  if ((outputs & ~supported & ALL_OUTPUTS) != 0)
+  {
+    SIM_WARN << "RelativeGeometryBatch::calculate, requested values not supported by the earth model are set to 0" << std::endl;
+    rv = 1;
+  }
+  outputs &= supported;
+  if (numValues == 0 || outputs == 0)
+    return rv;
+
+  const bool tangentModel = (model == WGS_84 || model == TANGENT_PLANE_WGS_84);
+  ConvertedStates fromStates;
+  ConvertedStates toStates;
+  convertStates(*pool_, from, model, coordConv, tangentModel, fromStates);
+  convertStates(*pool_, to, model, coordConv, tangentModel, toStates);
+
+  pool_->parallelFor(numFrom, [&](size_t begin, size_t end) {
+    LocalFrame frame;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const RelativeGeometryState& fromState = from[i];
+      const RelAngReference angleRef(fromState.ori);
+      const bool needRowFrame = tangentModel || (model == FLAT_EARTH && (outputs & rateOutputs) != 0);
+      if (needRowFrame)
+        frame.setOrigin(fromState.lla);
+
+      // Values for the 'from' entity, shared across the row
+      Vec3 fromPos;
+      Vec3 fromVel;
+      if (tangentModel)
+      {
+        if (model == WGS_84)
+        {
+          fromPos = fromStates.ecefPos(i);
+          fromVel = fromStates.ecefVel(i);
+        }
+        else
+        {
+          frame.ecefToLocal(fromStates.ecefPos(i), fromPos);
+          frame.rotateEcefToLocal(fromStates.ecefVel(i), fromVel);
+        }
+      }
+      Coordinate fromFlatState;
+      if (model == FLAT_EARTH && (outputs & rateOutputs) != 0)
+        frame.converter().convert(Coordinate(COORD_SYS_LLA, fromState.lla, Vec3(), fromState.vel), fromFlatState, COORD_SYS_ENU);
+
+      for (size_t j = 0; j < numTo; ++j)
+      {
+        const size_t index = i * numTo + j;
+        const RelativeGeometryState& toState = to[j];
+        double* azim = resultPtr(results.relAzimuth, index);
+        double* elev = resultPtr(results.relElevation, index);
+        double* cmp = resultPtr(results.relComposite, index);
+
+        if (tangentModel)
+        {
+          // X-East position of the 'to' entity, relative to the 'from' entity
+          Vec3 toLocal;
+          frame.ecefToLocal(toStates.ecefPos(j), toLocal);
+          double bearing = 0.;
+          if ((outputs & (angleOutputs | RANGE_RATE)) != 0)
+            relAngles(toLocal, angleRef, &bearing, elev, cmp);
+          if (azim)
+            *azim = bearing;
+
+          Vec3 toPos;
+          Vec3 toVel;
+          if (model == WGS_84)
+          {
+            toPos = toStates.ecefPos(j);
+            toVel = toStates.ecefVel(j);
+          }
+          else
+          {
+            toPos = toLocal;
+            if ((outputs & CLOSING_VELOCITY) != 0)
+              frame.rotateEcefToLocal(toStates.ecefVel(j), toVel);
+          }
+
+          if ((outputs & SLANT_RANGE) != 0)
+            results.slantRange[index] = v3Distance(toPos, fromPos);
+          if ((outputs & GROUND_DISTANCE) != 0)
+          {
+            if (model == WGS_84)
+              results.groundDistance[index] = sodanoInverse(fromState.lla.lat(), fromState.lla.lon(), 0., toState.lla.lat(), toState.lla.lon());
+            else
+              results.groundDistance[index] = sqrt(square(toLocal[0] - fromPos[0]) + square(toLocal[1] - fromPos[1]));
+          }
+          if ((outputs & CLOSING_VELOCITY) != 0)
+            results.closingVelocity[index] = closingVelocity(fromPos, fromVel, toPos, toVel);
+          if ((outputs & RANGE_RATE) != 0)
+            results.rangeRate[index] = rangeRate(fromState, toState, bearing);
+          continue;
+        }
+
+        if (model == PERFECT_SPHERE)
+        {
+          results.slantRange[index] = v3Distance(toStates.modelPos[j], fromStates.modelPos[i]);
+          continue;
+        }
+
+        // FLAT_EARTH; angles and distances use the caller's converter
+        if (coordConv != nullptr)
+        {
+          Vec3 enuDelta;
+          v3Subtract(toStates.modelPos[j], fromStates.modelPos[i], enuDelta);
+          if (azim || elev || cmp)
+            relAngles(enuDelta, angleRef, azim, elev, cmp);
+          if ((outputs & SLANT_RANGE) != 0)
+            results.slantRange[index] = v3Length(enuDelta);
+          if ((outputs & GROUND_DISTANCE) != 0)
+            results.groundDistance[index] = sqrt(square(enuDelta[0]) + square(enuDelta[1]));
+        }
+        // rates use a converter at the 'from' entity, as the pairwise functions do
+        if ((outputs & rateOutputs) != 0)
+        {
+          Coordinate toFlatState;
+          frame.converter().convert(Coordinate(COORD_SYS_LLA, toState.lla, Vec3(), toState.vel), toFlatState, COORD_SYS_ENU);
+          if ((outputs & CLOSING_VELOCITY) != 0)
+            results.closingVelocity[index] = closingVelocity(fromFlatState.position(), fromFlatState.velocity(), toFlatState.position(), toFlatState.velocity());
+          if ((outputs & RANGE_RATE) != 0)
+          {
+            Vec3 enuDelta;
+            v3Subtract(toFlatState.position(), fromFlatState.position(), enuDelta);
+            double bearing = 0.;
+            relAngles(enuDelta, angleRef, &bearing, nullptr, nullptr);
+            results.rangeRate[index] = rangeRate(fromState, toState, bearing);
+          }
+        }
+      }
+    }
+  });
+  return rv;
+}
+
+}
@@ -0,0 +1,135 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_CALC_RELATIVEGEOMETRY_H
+#define SIMCORE_CALC_RELATIVEGEOMETRY_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simCore/Calc/CoordinateSystem.h"
+#include "simCore/Calc/Vec3.h"
+
+namespace simCore
+{
+
+class CoordinateConverter;
+class ThreadPool;
+
+/** State of one entity for RelativeGeometryBatch */
+struct SDKCORE_EXPORT RelativeGeometryState
+{
+  Vec3 lla;   ///< Position lat (rad), lon (rad), alt (m)
+  Vec3 ori;   ///< Orientation yaw, pitch, roll (rad) relative to the local level frame
+  Vec3 vel;   ///< Velocity east, north, up (m/s)
+
+  RelativeGeometryState();
+  /** Constructs from position, orientation and velocity */
+  RelativeGeometryState(const Vec3& llaIn, const Vec3& oriIn, const Vec3& velIn);
+};
+
+/**
+ * Calculates relative geometry between every pair of a set of 'from' entities and a set of 'to'
+ * entities, such as a range tool table for every platform pair of a scenario.  Each entity is
+ * converted once, and the conversion is shared by every pair the entity takes part in.  Rows of
+ * the result, one per 'from' entity, are divided among a pool of threads.
+ *
+ * Results match the pairwise functions in Calculations.h (calculateRelAzEl(), calculateSlant(),
+ * calculateGroundDist(), calculateRangeRate() and calculateClosingVelocity()) for the same earth
+ * model, to within round-off.
+ */
+class SDKCORE_EXPORT RelativeGeometryBatch
+{
+public:
+  /** Bit flags selecting the calculated values */
+  enum Output
+  {
+    REL_AZIMUTH = 1 << 0,       ///< Relative azimuth along the 'from' line of sight (rad)
+    REL_ELEVATION = 1 << 1,     ///< Relative elevation along the 'from' line of sight (rad)
+    REL_COMPOSITE = 1 << 2,     ///< Composite (bore sight) angle (rad)
+    SLANT_RANGE = 1 << 3,       ///< Slant range (m)
+    GROUND_DISTANCE = 1 << 4,   ///< Ground distance (m)
+    RANGE_RATE = 1 << 5,        ///< Range rate (m/s)
+    CLOSING_VELOCITY = 1 << 6,  ///< Closing velocity (m/s)
+    ALL_OUTPUTS = 0x7f          ///< All of the above
+  };
+
+  /**
+   * Dense result matrices, stored by row: the value for from[i] and to[j] is at index
+   * i * numTo + j.  Matrices for values that were not requested are empty.
+   */
+  struct SDKCORE_EXPORT Results
+  {
+    size_t numFrom;  ///< Number of rows
+    size_t numTo;    ///< Number of columns
+    std::vector<double> relAzimuth;       ///< REL_AZIMUTH values
+    std::vector<double> relElevation;     ///< REL_ELEVATION values
+    std::vector<double> relComposite;     ///< REL_COMPOSITE values
+    std::vector<double> slantRange;       ///< SLANT_RANGE values
+    std::vector<double> groundDistance;   ///< GROUND_DISTANCE values
+    std::vector<double> rangeRate;        ///< RANGE_RATE values
+    std::vector<double> closingVelocity;  ///< CLOSING_VELOCITY values
+
+    Results();
+    /** Returns the index of the value for the given row and column */
+    size_t index(size_t fromIndex, size_t toIndex) const { return fromIndex * numTo + toIndex; }
+  };
+
+  /**
+   * Creates a batch calculator
+   * @param numThreads Number of threads used for calculations, including the calling thread; 0 uses the hardware concurrency
+   */
+  explicit RelativeGeometryBatch(unsigned int numThreads = 0);
+  virtual ~RelativeGeometryBatch();
+
+  /** Number of threads used for calculations */
+  unsigned int numThreads() const;
+
+  /**
+   * Calculates the requested values for every pair of 'from' and 'to' entities.
+   * WGS_84 and TANGENT_PLANE_WGS_84 support all values.  FLAT_EARTH supports all values, and
+   * requires coordConv with a reference origin for angles, slant range and ground distance.
+   * PERFECT_SPHERE supports slant range only.  Values that cannot be calculated are set to 0.
+   * Not thread safe: calls on one instance share its thread pool and must not overlap.
+   * @param[in ] from 'From' entities, one per row
+   * @param[in ] to 'To' entities, one per column
+   * @param[in ] outputs Bitwise OR of Output values to calculate
+   * @param[in ] model Earth model to perform the calculations in
+   * @param[in ] coordConv Converter with a reference origin, used by FLAT_EARTH; may be nullptr for other models
+   * @param[out] results Result matrices, resized to from.size() by to.size()
+   * @return 0 on success, non-zero if any requested value is not supported for the earth model
+   */
+  int calculate(const std::vector<RelativeGeometryState>& from, const std::vector<RelativeGeometryState>& to,
+    unsigned int outputs, EarthModelCalculations model, const CoordinateConverter* coordConv, Results& results);
+
+private:
+  std::unique_ptr<ThreadPool> pool_;
+
+  // Not implemented
+  RelativeGeometryBatch(const RelativeGeometryBatch&);
+  RelativeGeometryBatch& operator=(const RelativeGeometryBatch&);
+};
+
+}
+
+#endif /* SIMCORE_CALC_RELATIVEGEOMETRY_H */
@@ -0,0 +1,565 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <queue>
+#include "simCore/Calc/Geometry.h"
+#include "simCore/Calc/SpatialIndex.h"
+
+namespace simCore
+{
+
+namespace
+{
+  const int NULL_NODE = -1;
+
+  /** Surface area of a box, used as the cost of a node when choosing where to insert */
+  double area(const Vec3& minCorner, const Vec3& maxCorner)
+  {
+    const double dx = maxCorner.x() - minCorner.x();
+    const double dy = maxCorner.y() - minCorner.y();
+    const double dz = maxCorner.z() - minCorner.z();
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+  }
+
+  /** Combines two boxes, given by their corners */
+  void combine(const Vec3& min1, const Vec3& max1, const Vec3& min2, const Vec3& max2, Vec3& outMin, Vec3& outMax)
+  {
+    outMin.set(std::min(min1.x(), min2.x()), std::min(min1.y(), min2.y()), std::min(min1.z(), min2.z()));
+    outMax.set(std::max(max1.x(), max2.x()), std::max(max1.y(), max2.y()), std::max(max1.z(), max2.z()));
+  }
+
+  /** Squared distance from a point to the closest point of a box; 0 if inside */
+  double distanceSquared(const Vec3& point, const Vec3& minCorner, const Vec3& maxCorner)
+  {
+    double rv = 0.0;
+    for (size_t k = 0; k < 3; ++k)
+    {
+      double delta = 0.0;
+      if (point[k] < minCorner[k])
+        delta = minCorner[k] - point[k];
+      else if (point[k] > maxCorner[k])
+        delta = point[k] - maxCorner[k];
+      rv += delta * delta;
+    }
+    return rv;
+  }
+
+  /** Squared distance between two points */
+  double distanceSquared(const Vec3& a, const Vec3& b)
+  {
+    const double dx = a.x() - b.x();
+    const double dy = a.y() - b.y();
+    const double dz = a.z() - b.z();
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  /** True if the point lies in the box, inclusive */
+  bool boxContains(const Vec3& minCorner, const Vec3& maxCorner, const Vec3& point)
+  {
+    return point.x() >= minCorner.x() && point.x() <= maxCorner.x() &&
+      point.y() >= minCorner.y() && point.y() <= maxCorner.y() &&
+      point.z() >= minCorner.z() && point.z() <= maxCorner.z();
+  }
+
+  /** True if the two boxes overlap, inclusive */
+  bool boxesOverlap(const Vec3& min1, const Vec3& max1, const Vec3& min2, const Vec3& max2)
+  {
+    return min1.x() <= max2.x() && max1.x() >= min2.x() &&
+      min1.y() <= max2.y() && max1.y() >= min2.y() &&
+      min1.z() <= max2.z() && max1.z() >= min2.z();
+  }
+
+  /** True if the box lies entirely on the outside of any plane of the volume */
+  bool boxOutside(const std::vector<Plane>& planes, const Vec3& minCorner, const Vec3& maxCorner)
+  {
+    // Same tolerance as Polytope::contains()
+    const double epsilon = 1e-5;
+    for (std::vector<Plane>::const_iterator i = planes.begin(); i != planes.end(); ++i)
+    {
+      bool anyInside = false;
+      for (int corner = 0; corner < 8 && !anyInside; ++corner)
+      {
+        const Vec3 point((corner & 1) ? maxCorner.x() : minCorner.x(),
+          (corner & 2) ? maxCorner.y() : minCorner.y(),
+          (corner & 4) ? maxCorner.z() : minCorner.z());
+        anyInside = (i->distance(point) + epsilon >= 0.0);
+      }
+      if (!anyInside)
+        return true;
+    }
+    return false;
+  }
+
+  /** Candidate for the nearest neighbor search */
+  struct NearestCandidate
+  {
+    double distanceSq;
+    bool leaf;
+    uint64_t id;
+    int node;
+  };
+
+  /** Orders the search queue: closest first; at equal distance, expand nodes before reporting leaves, and report leaves in ID order */
+  struct FartherCandidate
+  {
+    bool operator()(const NearestCandidate& a, const NearestCandidate& b) const
+    {
+      if (a.distanceSq != b.distanceSq)
+        return a.distanceSq > b.distanceSq;
+      if (a.leaf != b.leaf)
+        return a.leaf;
+      return a.id > b.id;
+    }
+  };
+}
+
+SpatialIndex::SpatialIndex(double margin)
+  : margin_(std::max(0.0, margin)),
+    root_(NULL_NODE),
+    freeList_(NULL_NODE)
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+void SpatialIndex::setPosition(uint64_t id, const Vec3& position)
+{
+  std::map<uint64_t, int>::const_iterator i = leaves_.find(id);
+  int leaf = NULL_NODE;
+  if (i != leaves_.end())
+  {
+    leaf = i->second;
+    Node& node = nodes_[leaf];
+    node.position = position;
+    // Small moves stay inside the enlarged box and leave the tree alone
+    if (boxContains(node.box.minCorner, node.box.maxCorner, position))
+      return;
+    removeLeaf_(leaf);
+  }
+  else
+  {
+    leaf = allocateNode_();
+    Node& node = nodes_[leaf];
+    node.id = id;
+    node.position = position;
+    leaves_[id] = leaf;
+  }
+
+  Node& node = nodes_[leaf];
+  node.box.minCorner.set(position.x() - margin_, position.y() - margin_, position.z() - margin_);
+  node.box.maxCorner.set(position.x() + margin_, position.y() + margin_, position.z() + margin_);
+  insertLeaf_(leaf);
+}
+
+int SpatialIndex::remove(uint64_t id)
+{
+  std::map<uint64_t, int>::iterator i = leaves_.find(id);
+  if (i == leaves_.end())
+    return 1;
+  removeLeaf_(i->second);
+  freeNode_(i->second);
+  leaves_.erase(i);
+  return 0;
+}
+
+void SpatialIndex::clear()
+{
+  nodes_.clear();
+  leaves_.clear();
+  root_ = NULL_NODE;
+  freeList_ = NULL_NODE;
+}
+
+size_t SpatialIndex::size() const
+{
+  return leaves_.size();
+}
+
+int SpatialIndex::position(uint64_t id, Vec3& position) const
+{
+  std::map<uint64_t, int>::const_iterator i = leaves_.find(id);
+  if (i == leaves_.end())
+    return 1;
+  position = nodes_[i->second].position;
+  return 0;
+}
+
+int SpatialIndex::height() const
+{
+  return (root_ == NULL_NODE) ? 0 : nodes_[root_].height + 1;
+}
+
+void SpatialIndex::queryRadius(const Vec3& center, double radius, std::vector<uint64_t>& ids) const
+{
+  if (root_ == NULL_NODE || radius < 0.0)
+    return;
+
+  const double radiusSq = radius * radius;
+  std::vector<int> stack;
+  stack.push_back(root_);
+  while (!stack.empty())
+  {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (node.isLeaf())
+    {
+      if (distanceSquared(center, node.position) <= radiusSq)
+        ids.push_back(node.id);
+    }
+    else if (distanceSquared(center, node.box.minCorner, node.box.maxCorner) <= radiusSq)
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void SpatialIndex::queryBox(const Vec3& minCorner, const Vec3& maxCorner, std::vector<uint64_t>& ids) const
+{
+  if (root_ == NULL_NODE)
+    return;
+
+  std::vector<int> stack;
+  stack.push_back(root_);
+  while (!stack.empty())
+  {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (node.isLeaf())
+    {
+      if (boxContains(minCorner, maxCorner, node.position))
+        ids.push_back(node.id);
+    }
+    else if (boxesOverlap(minCorner, maxCorner, node.box.minCorner, node.box.maxCorner))
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void SpatialIndex::queryPolytope(const Polytope& volume, std::vector<uint64_t>& ids) const
+{
+  if (root_ == NULL_NODE)
+    return;
+
+  const std::vector<Plane>& planes = volume.planes();
+  std::vector<int> stack;
+  stack.push_back(root_);
+  while (!stack.empty())
+  {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (node.isLeaf())
+    {
+      if (volume.contains(node.position))
+        ids.push_back(node.id);
+    }
+    else if (!boxOutside(planes, node.box.minCorner, node.box.maxCorner))
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void SpatialIndex::queryNearest(const Vec3& point, size_t k, std::vector<uint64_t>& ids) const
+{
+  if (root_ == NULL_NODE || k == 0)
+    return;
+
+  // Best-first search; a leaf popped from the queue is closer than anything left to search
+  std::priority_queue<NearestCandidate, std::vector<NearestCandidate>, FartherCandidate> queue;
+  NearestCandidate candidate = { 0.0, false, 0, root_ };
+  queue.push(candidate);
+  size_t found = 0;
+  while (!queue.empty() && found < k)
+  {
+    const NearestCandidate next = queue.top();
+    queue.pop();
+    if (next.leaf)
+    {
+      ids.push_back(next.id);
+      ++found;
+      continue;
+    }
+
+    const Node& node = nodes_[next.node];
+    if (node.isLeaf())
+    {
+      candidate.distanceSq = distanceSquared(point, node.position);
+      candidate.leaf = true;
+      candidate.id = node.id;
+      candidate.node = next.node;
+      queue.push(candidate);
+      continue;
+    }
+
+    const int children[2] = { node.child1, node.child2 };
+    for (size_t c = 0; c < 2; ++c)
+    {
+      const Node& child = nodes_[children[c]];
+      candidate.distanceSq = child.isLeaf() ? distanceSquared(point, child.position) : distanceSquared(point, child.box.minCorner, child.box.maxCorner);
+      candidate.leaf = child.isLeaf();
+      candidate.id = child.isLeaf() ? child.id : 0;
+      candidate.node = children[c];
+      queue.push(candidate);
+    }
+  }
+}
+
+int SpatialIndex::allocateNode_()
+{
+  int node = freeList_;
+  if (node != NULL_NODE)
+    freeList_ = nodes_[node].parent;
+  else
+  {
+    node = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node());
+  }
+
+  Node& rv = nodes_[node];
+  rv.parent = NULL_NODE;
+  rv.child1 = NULL_NODE;
+  rv.child2 = NULL_NODE;
+  rv.height = 0;
+  rv.id = 0;
+  return node;
+}
+
+void SpatialIndex::freeNode_(int node)
+{
+  nodes_[node].parent = freeList_;
+  nodes_[node].height = -1;
+  freeList_ = node;
+}
+
+void SpatialIndex::insertLeaf_(int leaf)
+{
+  if (root_ == NULL_NODE)
+  {
+    root_ = leaf;
+    nodes_[root_].parent = NULL_NODE;
+    return;
+  }
+
+  // Descend toward the sibling that grows the total box area the least
+  const Box leafBox = nodes_[leaf].box;
+  int index = root_;
+  while (!nodes_[index].isLeaf())
+  {
+    const Node& node = nodes_[index];
+    const double nodeArea = area(node.box.minCorner, node.box.maxCorner);
+    Vec3 combinedMin;
+    Vec3 combinedMax;
+    combine(node.box.minCorner, node.box.maxCorner, leafBox.minCorner, leafBox.maxCorner, combinedMin, combinedMax);
+    const double combinedArea = area(combinedMin, combinedMax);
+
+    // Cost of pairing the leaf with this node, and the cost pushed down to either child
+    const double cost = 2.0 * combinedArea;
+    const double inheritanceCost = 2.0 * (combinedArea - nodeArea);
+
+    double childCost[2];
+    const int children[2] = { node.child1, node.child2 };
+    for (size_t c = 0; c < 2; ++c)
+    {
+      const Node& child = nodes_[children[c]];
+      combine(child.box.minCorner, child.box.maxCorner, leafBox.minCorner, leafBox.maxCorner, combinedMin, combinedMax);
+      childCost[c] = area(combinedMin, combinedMax) + inheritanceCost;
+      if (!child.isLeaf())
+        childCost[c] -= area(child.box.minCorner, child.box.maxCorner);
+    }
+
+    if (cost < childCost[0] && cost < childCost[1])
+      break;
+    index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+  }
+
+  // Replace the sibling with a new parent holding both the sibling and the leaf
+  const int sibling = index;
+  const int newParent = allocateNode_();
+  const int oldParent = nodes_[sibling].parent;
+  Node& parent = nodes_[newParent];
+  parent.parent = oldParent;
+  combine(leafBox.minCorner, leafBox.maxCorner, nodes_[sibling].box.minCorner, nodes_[sibling].box.maxCorner, parent.box.minCorner, parent.box.maxCorner);
+  parent.height = nodes_[sibling].height + 1;
+  parent.child1 = sibling;
+  parent.child2 = leaf;
+  nodes_[sibling].parent = newParent;
+  nodes_[leaf].parent = newParent;
+
+  if (oldParent == NULL_NODE)
+    root_ = newParent;
+  else if (nodes_[oldParent].child1 == sibling)
+    nodes_[oldParent].child1 = newParent;
+  else
+    nodes_[oldParent].child2 = newParent;
+
+  refit_(nodes_[leaf].parent);
+}
+
+void SpatialIndex::removeLeaf_(int leaf)
+{
+  if (leaf == root_)
+  {
+    root_ = NULL_NODE;
+    return;
+  }
+
+  const int parent = nodes_[leaf].parent;
+  const int grandParent = nodes_[parent].parent;
+  const int sibling = (nodes_[parent].child1 == leaf) ? nodes_[parent].child2 : nodes_[parent].child1;
+  freeNode_(parent);
+
+  if (grandParent == NULL_NODE)
+  {
+    root_ = sibling;
+    nodes_[sibling].parent = NULL_NODE;
+    return;
+  }
+
+  // Connect the sibling to the grandparent in place of the parent
+  if (nodes_[grandParent].child1 == parent)
+    nodes_[grandParent].child1 = sibling;
+  else
+    nodes_[grandParent].child2 = sibling;
+  nodes_[sibling].parent = grandParent;
+  refit_(grandParent);
+}
+
+void SpatialIndex::refit_(int index)
+{
+  while (index != NULL_NODE)
+  {
+    index = balance_(index);
+    Node& node = nodes_[index];
+    const Node& child1 = nodes_[node.child1];
+    const Node& child2 = nodes_[node.child2];
+    node.height = 1 + std::max(child1.height, child2.height);
+    combine(child1.box.minCorner, child1.box.maxCorner, child2.box.minCorner, child2.box.maxCorner, node.box.minCorner, node.box.maxCorner);
+    index = node.parent;
+  }
+}
+
+int SpatialIndex::balance_(int iA)
+{
+  Node& a = nodes_[iA];
+  if (a.isLeaf() || a.height < 2)
+    return iA;
+
+  const int iB = a.child1;
+  const int iC = a.child2;
+  Node& b = nodes_[iB];
+  Node& c = nodes_[iC];
+  const int balance = c.height - b.height;
+
+  if (balance > 1)
+  {
+    // Rotate C up
+    const int iF = c.child1;
+    const int iG = c.child2;
+    Node& f = nodes_[iF];
+    Node& g = nodes_[iG];
+
+    c.child1 = iA;
+    c.parent = a.parent;
+    a.parent = iC;
+    if (c.parent == NULL_NODE)
+      root_ = iC;
+    else if (nodes_[c.parent].child1 == iA)
+      nodes_[c.parent].child1 = iC;
+    else
+      nodes_[c.parent].child2 = iC;
+
+    if (f.height > g.height)
+    {
+      c.child2 = iF;
+      a.child2 = iG;
+      g.parent = iA;
+      combine(b.box.minCorner, b.box.maxCorner, g.box.minCorner, g.box.maxCorner, a.box.minCorner, a.box.maxCorner);
+      combine(a.box.minCorner, a.box.maxCorner, f.box.minCorner, f.box.maxCorner, c.box.minCorner, c.box.maxCorner);
+      a.height = 1 + std::max(b.height, g.height);
+      c.height = 1 + std::max(a.height, f.height);
+    }
+    else
+    {
+      c.child2 = iG;
+      a.child2 = iF;
+      f.parent = iA;
+      combine(b.box.minCorner, b.box.maxCorner, f.box.minCorner, f.box.maxCorner, a.box.minCorner, a.box.maxCorner);
+      combine(a.box.minCorner, a.box.maxCorner, g.box.minCorner, g.box.maxCorner, c.box.minCorner, c.box.maxCorner);
+      a.height = 1 + std::max(b.height, f.height);
+      c.height = 1 + std::max(a.height, g.height);
+    }
+    return iC;
+  }
+
+  if (balance < -1)
+  {
+    // Rotate B up
+    const int iD = b.child1;
+    const int iE = b.child2;
+    Node& d = nodes_[iD];
+    Node& e = nodes_[iE];
+
+    b.child1 = iA;
+    b.parent = a.parent;
+    a.parent = iB;
+    if (b.parent == NULL_NODE)
+      root_ = iB;
+    else if (nodes_[b.parent].child1 == iA)
+      nodes_[b.parent].child1 = iB;
+    else
+      nodes_[b.parent].child2 = iB;
+
+    if (d.height > e.height)
+    {
+      b.child2 = iD;
+      a.child1 = iE;
+      e.parent = iA;
+      combine(c.box.minCorner, c.box.maxCorner, e.box.minCorner, e.box.maxCorner, a.box.minCorner, a.box.maxCorner);
+      combine(a.box.minCorner, a.box.maxCorner, d.box.minCorner, d.box.maxCorner, b.box.minCorner, b.box.maxCorner);
+      a.height = 1 + std::max(c.height, e.height);
+      b.height = 1 + std::max(a.height, d.height);
+    }
+    else
+    {
+      b.child2 = iE;
+      a.child1 = iD;
+      d.parent = iA;
+      combine(c.box.minCorner, c.box.maxCorner, d.box.minCorner, d.box.maxCorner, a.box.minCorner, a.box.maxCorner);
+      combine(a.box.minCorner, a.box.maxCorner, e.box.minCorner, e.box.maxCorner, b.box.minCorner, b.box.maxCorner);
+      a.height = 1 + std::max(c.height, d.height);
+      b.height = 1 + std::max(a.height, e.height);
+    }
+    return iB;
+  }
+
+  return iA;
+}
+
+}
@@ -0,0 +1,164 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_CALC_SPATIALINDEX_H
+#define SIMCORE_CALC_SPATIALINDEX_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simCore/Calc/Vec3.h"
+
+namespace simCore
+{
+  class Polytope;
+
+  /**
+  * Dynamic bounding volume hierarchy over point items, such as entity ECEF positions.
+  * Each item lives in a leaf whose axis-aligned box is enlarged by a margin, so an item
+  * that moves less than the margin only updates its stored position.  An item that leaves
+  * its box is removed and reinserted, and the tree is kept balanced with rotations, so
+  * insert, move and remove are O(log n).  Boxes are only used to prune the search; query
+  * results are always tested against the exact item positions.
+  */
+  class SDKCORE_EXPORT SpatialIndex
+  {
+  public:
+    /**
+    * Constructs an empty index.
+    * @param[in ] margin Distance that each leaf box extends past its item's position, in the
+    *   units of the positions.  Larger values make small moves cheaper, at the cost of looser
+    *   boxes during queries.
+    */
+    explicit SpatialIndex(double margin = 0.0);
+
+    /// dtor
+    virtual ~SpatialIndex();
+
+    /**
+    * Adds the item to the index, or moves it if it is already present.
+    * @param[in ] id Unique identifier of the item
+    * @param[in ] position Position of the item
+    */
+    void setPosition(uint64_t id, const Vec3& position);
+
+    /**
+    * Removes the item from the index.
+    * @param[in ] id Item to remove
+    * @return 0 on success, non-zero if the item is not in the index
+    */
+    int remove(uint64_t id);
+
+    /** Removes all items */
+    void clear();
+
+    /** Returns the number of items in the index */
+    size_t size() const;
+
+    /**
+    * Retrieves the position of an item.
+    * @param[in ] id Item to look up
+    * @param[out] position Position of the item
+    * @return 0 on success, non-zero if the item is not in the index
+    */
+    int position(uint64_t id, Vec3& position) const;
+
+    /** Returns the number of levels in the tree; 0 when empty and 1 with a single item */
+    int height() const;
+
+    /**
+    * Finds the items within a distance of a point.
+    * @param[in ] center Center of the search sphere
+    * @param[in ] radius Search distance, inclusive
+    * @param[out] ids Receives the IDs of the matching items, in no particular order; existing contents are kept
+    */
+    void queryRadius(const Vec3& center, double radius, std::vector<uint64_t>& ids) const;
+
+    /**
+    * Finds the items inside an axis-aligned box.
+    * @param[in ] minCorner Box corner with the smallest coordinates
+    * @param[in ] maxCorner Box corner with the largest coordinates
+    * @param[out] ids Receives the IDs of the matching items, in no particular order; existing contents are kept
+    */
+    void queryBox(const Vec3& minCorner, const Vec3& maxCorner, std::vector<uint64_t>& ids) const;
+
+    /**
+    * Finds the items contained by a convex volume, such as a view frustum or the polytope of a GeoFence.
+    * Containment follows Polytope::contains(), so an empty polytope matches every item.
+    * @param[in ] volume Bounding volume
+    * @param[out] ids Receives the IDs of the matching items, in no particular order; existing contents are kept
+    */
+    void queryPolytope(const Polytope& volume, std::vector<uint64_t>& ids) const;
+
+    /**
+    * Finds the items nearest to a point.
+    * @param[in ] point Search point
+    * @param[in ] k Maximum number of items to return
+    * @param[out] ids Receives up to k IDs, closest first, with equally distant items in ID order; existing contents are kept
+    */
+    void queryNearest(const Vec3& point, size_t k, std::vector<uint64_t>& ids) const;
+
+  private:
+    /// Axis-aligned bounding box
+    struct Box
+    {
+      Vec3 minCorner;
+      Vec3 maxCorner;
+    };
+
+    /// Tree node; leaves hold an item, internal nodes always have two children
+    struct Node
+    {
+      Box box;
+      int parent;  ///< Parent node, or next free node when on the free list
+      int child1;
+      int child2;
+      int height;  ///< 0 for leaves
+      uint64_t id;
+      Vec3 position;
+
+      bool isLeaf() const { return child1 < 0; }
+    };
+
+    int allocateNode_();
+    void freeNode_(int node);
+    void insertLeaf_(int leaf);
+    void removeLeaf_(int leaf);
+    int balance_(int node);
+    /// Recomputes boxes and heights from the node up to the root, rebalancing along the way
+    void refit_(int node);
+
+    double margin_;
+    int root_;
+    int freeList_;
+    std::vector<Node> nodes_;
+    std::map<uint64_t, int> leaves_;
+
+    // Not implemented
+    SpatialIndex(const SpatialIndex&);
+    SpatialIndex& operator=(const SpatialIndex&);
+  };
+
+} // namespace simCore
+
+#endif /* SIMCORE_CALC_SPATIALINDEX_H */
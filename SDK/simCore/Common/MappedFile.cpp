@@ -0,0 +1,139 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifdef WIN32
+#include "simCore/Common/Common.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "simCore/String/UtfUtils.h"
+#include "simCore/Common/MappedFile.h"
+
+namespace simCore
+{
+
+MappedFile::MappedFile()
+  : data_(nullptr),
+    size_(0),
+#ifdef WIN32
+    file_(INVALID_HANDLE_VALUE),
+    mapping_(nullptr)
+#else
+    fd_(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+int MappedFile::open(const std::string& filename)
+{
+  close();
+#ifdef WIN32
+  file_ = CreateFileW(simCore::streamFixUtf8(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE)
+    return 1;
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0)
+  {
+    close();
+    return 1;
+  }
+  mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr)
+  {
+    close();
+    return 1;
+  }
+  data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr)
+  {
+    close();
+    return 1;
+  }
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+  fd_ = ::open(filename.c_str(), O_RDONLY);
+  if (fd_ < 0)
+    return 1;
+  struct stat fileStat;
+  if (fstat(fd_, &fileStat) != 0 || fileStat.st_size <= 0)
+  {
+    close();
+    return 1;
+  }
+  void* address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (address == MAP_FAILED)
+  {
+    close();
+    return 1;
+  }
+  data_ = static_cast<const char*>(address);
+  size_ = static_cast<size_t>(fileStat.st_size);
+#endif
+  return 0;
+}
+
+void MappedFile::close()
+{
+#ifdef WIN32
+  if (data_ != nullptr)
+    UnmapViewOfFile(data_);
+  if (mapping_ != nullptr)
+    CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_);
+  mapping_ = nullptr;
+  file_ = INVALID_HANDLE_VALUE;
+#else
+  if (data_ != nullptr)
+    munmap(const_cast<char*>(data_), size_);
+  if (fd_ >= 0)
+    ::close(fd_);
+  fd_ = -1;
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+  return data_ != nullptr;
+}
+
+const char* MappedFile::data() const
+{
+  return data_;
+}
+
+size_t MappedFile::size() const
+{
+  return size_;
+}
+
+}
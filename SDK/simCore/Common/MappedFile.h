@@ -0,0 +1,84 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_COMMON_MAPPEDFILE_H
+#define SIMCORE_COMMON_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include "simCore/Common/Export.h"
+
+namespace simCore
+{
+
+  /**
+  * Read-only memory mapping of an entire file.  The mapping is released when the object
+  * is destroyed, invalidating any pointers obtained from data().
+  *
+  * Usage:
+  *   simCore::MappedFile file;
+  *   if (file.open("input.bin") == 0)
+  *     parse(file.data(), file.size());
+  */
+  class SDKCORE_EXPORT MappedFile
+  {
+  public:
+    MappedFile();
+    /** Unmaps and closes the file */
+    virtual ~MappedFile();
+
+    /**
+    * Maps the file into memory.  Empty files cannot be mapped.
+    * @param filename UTF-8 name of the file to map
+    * @return 0 on success, non-zero if the file could not be opened or mapped
+    */
+    int open(const std::string& filename);
+    /** Unmaps and closes the file; safe to call when no file is open */
+    void close();
+
+    /** Returns true if a file is currently mapped */
+    bool isOpen() const;
+    /** Start of the mapped file, or nullptr if no file is mapped */
+    const char* data() const;
+    /** Size of the mapped file in bytes */
+    size_t size() const;
+
+  private:
+    const char* data_;
+    size_t size_;
+#ifdef WIN32
+    /// File HANDLE
+    void* file_;
+    /// File mapping HANDLE
+    void* mapping_;
+#else
+    int fd_;
+#endif
+
+    // Not implemented
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+  };
+
+}
+
+#endif /* SIMCORE_COMMON_MAPPEDFILE_H */
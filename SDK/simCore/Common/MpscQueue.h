@@ -0,0 +1,178 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_COMMON_MPSCQUEUE_H
+#define SIMCORE_COMMON_MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace simCore
+{
+
+  /**
+  * Bounded lock-free queue for any number of producer threads and a single consumer
+  * thread.  Items are stored in a ring of preallocated cells, so pushing and popping
+  * never allocate.  Each cell carries a sequence number that tells producers whether it
+  * is free and tells the consumer whether it holds a completed item, so producers only
+  * contend on a single atomic index and never on the consumer.
+  *
+  * tryPush() may be called concurrently from any number of threads.  tryPop() must only
+  * be called from one thread at a time.  T must be default constructible and move assignable.
+  *
+  * Usage:
+  *   simCore::MpscQueue<Packet> queue(1024);
+  *   // producer threads
+  *   if (!queue.tryPush(std::move(packet)))
+  *     ++dropped;
+  *   // consumer thread
+  *   Packet packet;
+  *   while (queue.tryPop(packet))
+  *     process(packet);
+  */
+  template <typename T>
+  class MpscQueue
+  {
+  public:
+    /** Creates a queue that holds at least the given number of items; rounded up to a power of two */
+    explicit MpscQueue(size_t capacity)
+      : cells_(nullptr),
+        mask_(0),
+        enqueuePos_(0),
+        dequeuePos_(0)
+    {
+      size_t size = 2;
+      while (size < capacity)
+        size *= 2;
+      cells_ = new Cell[size];
+      mask_ = size - 1;
+      for (size_t k = 0; k < size; ++k)
+        cells_[k].sequence.store(k, std::memory_order_relaxed);
+    }
+
+    virtual ~MpscQueue()
+    {
+      delete[] cells_;
+    }
+
+    /** Maximum number of items in the queue */
+    size_t capacity() const
+    {
+      return mask_ + 1;
+    }
+
+    /** Number of items in the queue; approximate while producers or the consumer are active */
+    size_t size() const
+    {
+      const size_t dequeue = dequeuePos_.load(std::memory_order_acquire);
+      const size_t enqueue = enqueuePos_.load(std::memory_order_acquire);
+      return (enqueue > dequeue) ? enqueue - dequeue : 0;
+    }
+
+    /**
+    * Adds an item to the back of the queue.  Safe to call from multiple threads.
+    * @param item Item to add; moved from only if the push succeeds
+    * @return True if added, false if the queue is full
+    */
+    bool tryPush(T&& item)
+    {
+      size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+      Cell* cell = nullptr;
+      while (true)
+      {
+        cell = &cells_[pos & mask_];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+          // Cell is free; claim it
+          if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+          // pos was reloaded by the failed exchange
+        }
+        else if (diff < 0)
+        {
+          // Consumer has not released this cell yet; queue is full
+          return false;
+        }
+        else
+        {
+          // Another producer claimed this cell
+          pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+      }
+      cell->value = std::move(item);
+      // Publish the item to the consumer
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /** Adds a copy of the item to the back of the queue; returns false if the queue is full */
+    bool tryPush(const T& item)
+    {
+      T copy(item);
+      return tryPush(std::move(copy));
+    }
+
+    /**
+    * Removes the item at the front of the queue.  Must only be called from one thread at a time.
+    * @param item Receives the item
+    * @return True if an item was removed, false if the queue is empty
+    */
+    bool tryPop(T& item)
+    {
+      const size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+      Cell* cell = &cells_[pos & mask_];
+      if (cell->sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+      item = std::move(cell->value);
+      // Release the cell for the producer one lap ahead
+      cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+      dequeuePos_.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+  private:
+    /** Storage for one item */
+    struct Cell
+    {
+      /** Equals the enqueue position when free, and the position + 1 when holding an item */
+      std::atomic<size_t> sequence;
+      T value;
+    };
+
+    Cell* cells_;
+    size_t mask_;
+    /** Next position to claim for a push; separate cache line from the consumer position */
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    /** Next position to pop */
+    alignas(64) std::atomic<size_t> dequeuePos_;
+
+    // Not implemented
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+  };
+
+}
+
+#endif /* SIMCORE_COMMON_MPSCQUEUE_H */
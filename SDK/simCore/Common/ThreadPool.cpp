@@ -0,0 +1,161 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include "simCore/Common/ThreadPool.h"
+
+namespace simCore
+{
+
+/// Number of ranges per thread; more ranges balance uneven work at the cost of more counter traffic
+static const size_t RANGES_PER_THREAD = 4;
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+  : func_(nullptr),
+    count_(0),
+    rangeSize_(1),
+    next_(0),
+    busyWorkers_(0),
+    generation_(0),
+    stopping_(false)
+{
+  for (unsigned int k = 1; k < numThreads; ++k)
+    workers_.push_back(std::thread(&ThreadPool::workerLoop_, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+  // Queued tasks are released outside the lock, since they may own resources of their own
+  std::deque<Task> discarded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    discarded.swap(tasks_);
+  }
+  wake_.notify_all();
+  discarded.clear();
+  for (std::vector<std::thread>::iterator i = workers_.begin(); i != workers_.end(); ++i)
+    i->join();
+}
+
+unsigned int ThreadPool::numThreads() const
+{
+  return static_cast<unsigned int>(workers_.size() + 1);
+}
+
+void ThreadPool::parallelFor(size_t count, const RangeFunction& func)
+{
+  if (count == 0)
+    return;
+  // Avoid the hand-off cost when there is nothing to share
+  if (workers_.empty() || count == 1)
+  {
+    func(0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_ = &func;
+    count_ = count;
+    rangeSize_ = std::max<size_t>(1, count / (numThreads() * RANGES_PER_THREAD));
+    next_ = 0;
+    busyWorkers_ = workers_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  runRanges_();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busyWorkers_ == 0; });
+  func_ = nullptr;
+}
+
+void ThreadPool::submit(const Task& task)
+{
+  if (workers_.empty())
+  {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(task);
+  }
+  wake_.notify_one();
+}
+
+unsigned int ThreadPool::hardwareThreads()
+{
+  const unsigned int rv = std::thread::hardware_concurrency();
+  return (rv == 0) ? 1 : rv;
+}
+
+void ThreadPool::workerLoop_()
+{
+  unsigned long long lastGeneration = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    wake_.wait(lock, [this, lastGeneration] { return stopping_ || generation_ != lastGeneration || !tasks_.empty(); });
+    if (generation_ != lastGeneration)
+    {
+      lastGeneration = generation_;
+
+      lock.unlock();
+      runRanges_();
+      lock.lock();
+
+      if (--busyWorkers_ == 0)
+        done_.notify_one();
+    }
+    else if (!stopping_ && !tasks_.empty())
+    {
+      const Task task = tasks_.front();
+      tasks_.pop_front();
+
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+    else
+    {
+      // stopping; queued tasks were discarded
+      return;
+    }
+  }
+}
+
+void ThreadPool::runRanges_()
+{
+  while (true)
+  {
+    const size_t begin = next_.fetch_add(rangeSize_);
+    if (begin >= count_)
+      return;
+    (*func_)(begin, std::min(begin + rangeSize_, count_));
+  }
+}
+
+}
@@ -0,0 +1,130 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_COMMON_THREADPOOL_H
+#define SIMCORE_COMMON_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "simCore/Common/Export.h"
+
+namespace simCore
+{
+
+  /**
+  * Fixed-size pool of worker threads for data-parallel loops.  The calling thread
+  * participates in the work, so a pool of N threads starts N-1 workers.  Work is
+  * handed out in contiguous ranges of indices from a shared counter, so uneven
+  * per-item costs are balanced across threads.
+  *
+  * parallelFor() blocks until all work is complete and must not be called concurrently
+  * from more than one thread, or recursively from inside the work function.
+  *
+  * submit() queues a task for the workers and returns immediately, for work that should
+  * not hold up the caller.  A parallelFor() issued while workers are running tasks waits
+  * for those workers to finish their current task before they join in.
+  *
+  * Usage:
+  *   simCore::ThreadPool pool(4);
+  *   pool.parallelFor(values.size(), [&](size_t begin, size_t end) {
+  *     for (size_t k = begin; k < end; ++k)
+  *       values[k] = compute(k);
+  *   });
+  */
+  class SDKCORE_EXPORT ThreadPool
+  {
+  public:
+    /** Function that processes the items in [begin, end) */
+    typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+    /** Function run by a worker thread after submit() */
+    typedef std::function<void()> Task;
+
+    /** Creates a pool that uses the given number of threads, including the calling thread; 0 is treated as 1 */
+    explicit ThreadPool(unsigned int numThreads);
+    /** Discards queued tasks that have not started, waits for running tasks, then stops and joins the worker threads */
+    virtual ~ThreadPool();
+
+    /** Number of threads that process work, including the calling thread */
+    unsigned int numThreads() const;
+
+    /**
+    * Processes the items in [0, count) by calling func on disjoint ranges that cover the
+    * entire interval.  Returns once every range has been processed.
+    * @param count Number of items to process
+    * @param func Function to call for each range; called concurrently from multiple threads
+    */
+    void parallelFor(size_t count, const RangeFunction& func);
+
+    /**
+    * Queues the task to run on a worker thread and returns without waiting for it.  Tasks
+    * start in the order submitted.  A pool without worker threads runs the task on the
+    * calling thread before returning.  Tasks that have not started when the pool is
+    * destroyed never run, so a pool that outlives main() does no work during static
+    * destruction.
+    * @param task Function to run; must not call parallelFor() on this pool
+    */
+    void submit(const Task& task);
+
+    /** Number of concurrent threads supported by the hardware, or 1 if unknown */
+    static unsigned int hardwareThreads();
+
+  private:
+    /** Main loop for the worker threads */
+    void workerLoop_();
+    /** Processes ranges of the current job until none remain */
+    void runRanges_();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    /** Signals workers that a new job is ready or that the pool is stopping */
+    std::condition_variable wake_;
+    /** Signals the caller that all workers finished the current job */
+    std::condition_variable done_;
+
+    /** Current job; written under mutex_ before generation_ is incremented */
+    const RangeFunction* func_;
+    size_t count_;
+    size_t rangeSize_;
+    /** First index of the next range to hand out */
+    std::atomic<size_t> next_;
+    /** Number of workers that have not finished the current job */
+    size_t busyWorkers_;
+    /** Incremented for each job */
+    unsigned long long generation_;
+    /** Tasks from submit() that have not started */
+    std::deque<Task> tasks_;
+    bool stopping_;
+
+    // Not implemented
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+  };
+
+}
+
+#endif /* SIMCORE_COMMON_THREADPOOL_H */
@@ -0,0 +1,248 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Interpolation.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/EM/AntennaGainCache.h"
+
+namespace simCore
+{
+
+AntennaGainCache::Key::Key(const AntennaGainParameters& params)
+  : polarity(params.polarity_),
+    hbw(params.hbw_),
+    vbw(params.vbw_),
+    refGain(params.refGain_),
+    firstLobe(params.firstLobe_),
+    backLobe(params.backLobe_),
+    freq(params.freq_),
+    weighting(params.weighting_),
+    delta(params.delta_)
+{
+}
+
+bool AntennaGainCache::Key::operator<(const Key& other) const
+{
+  if (polarity != other.polarity)
+    return polarity < other.polarity;
+  if (hbw != other.hbw)
+    return hbw < other.hbw;
+  if (vbw != other.vbw)
+    return vbw < other.vbw;
+  if (refGain != other.refGain)
+    return refGain < other.refGain;
+  if (firstLobe != other.firstLobe)
+    return firstLobe < other.firstLobe;
+  if (backLobe != other.backLobe)
+    return backLobe < other.backLobe;
+  if (freq != other.freq)
+    return freq < other.freq;
+  if (weighting != other.weighting)
+    return other.weighting;
+  return !delta && other.delta;
+}
+
+//------------------------------------------------------------------------
+
+AntennaGainCache::AntennaGainCache(AntennaPattern* pattern, double azStep, double elStep, size_t maxTables)
+  : pattern_(pattern),
+    baked_(pattern != nullptr && isBaked(pattern->type())),
+    maxTables_(std::max<size_t>(1, maxTables)),
+    useCounter_(0)
+{
+  assert(pattern_ != nullptr);
+  assert(azStep > 0. && elStep > 0.);
+  // Grids include both ends of their spans, so the steps are reduced to divide the spans evenly
+  numAz_ = static_cast<size_t>(ceil(M_TWOPI / std::max(azStep, 1e-6))) + 1;
+  numEl_ = static_cast<size_t>(ceil(M_PI / std::max(elStep, 1e-6))) + 1;
+  numAz_ = std::max<size_t>(numAz_, 2);
+  numEl_ = std::max<size_t>(numEl_, 2);
+  azStep_ = M_TWOPI / (numAz_ - 1);
+  elStep_ = M_PI / (numEl_ - 1);
+}
+
+AntennaGainCache::~AntennaGainCache()
+{
+}
+
+AntennaPattern* AntennaGainCache::pattern() const
+{
+  return pattern_;
+}
+
+double AntennaGainCache::azStep() const
+{
+  return azStep_;
+}
+
+double AntennaGainCache::elStep() const
+{
+  return elStep_;
+}
+
+size_t AntennaGainCache::maxTables() const
+{
+  return maxTables_;
+}
+
+size_t AntennaGainCache::numTables() const
+{
+  return tables_.size();
+}
+
+bool AntennaGainCache::isBaked(AntennaPatternType type)
+{
+  switch (type)
+  {
+  case ANTENNA_PATTERN_TABLE:
+  case ANTENNA_PATTERN_MONOPULSE:
+  case ANTENNA_PATTERN_CRUISE:
+  case ANTENNA_PATTERN_RELATIVE:
+  case ANTENNA_PATTERN_BILINEAR:
+  case ANTENNA_PATTERN_NSMA:
+  case ANTENNA_PATTERN_EZNEC:
+  case ANTENNA_PATTERN_XFDTD:
+    return true;
+  case NO_ANTENNA_PATTERN:
+  case ANTENNA_PATTERN_PEDESTAL:
+  case ANTENNA_PATTERN_GAUSS:
+  case ANTENNA_PATTERN_CSCSQ:
+  case ANTENNA_PATTERN_SINXX:
+  case ANTENNA_PATTERN_OMNI:
+    break;
+  }
+  return false;
+}
+
+float AntennaGainCache::gain(const AntennaGainParameters& params)
+{
+  if (!baked_)
+    return pattern_->gain(params);
+  return interpolate_(table_(params), params.azim_, params.elev_);
+}
+
+void AntennaGainCache::gain(const AntennaGainParameters& params, size_t count, const float* azim, const float* elev, float* gains)
+{
+  if (count == 0)
+    return;
+  if (!baked_)
+  {
+    AntennaGainParameters sample(params);
+    for (size_t k = 0; k < count; ++k)
+    {
+      sample.azim_ = azim[k];
+      sample.elev_ = elev[k];
+      gains[k] = pattern_->gain(sample);
+    }
+    return;
+  }
+  const Table& table = table_(params);
+  for (size_t k = 0; k < count; ++k)
+    gains[k] = interpolate_(table, azim[k], elev[k]);
+}
+
+float AntennaGainCache::errorBound(const AntennaGainParameters& params)
+{
+  if (!baked_)
+    return 0.f;
+  Table& table = table_(params);
+  if (table.errorBound >= 0.f)
+    return table.errorBound;
+
+  AntennaGainParameters sample(params);
+  float maxError = 0.f;
+  for (size_t row = 0; row + 1 < numEl_; ++row)
+  {
+    const double elev = -M_PI_2 + (row + 0.5) * elStep_;
+    for (size_t col = 0; col + 1 < numAz_; ++col)
+    {
+      const double azim = -M_PI + (col + 0.5) * azStep_;
+      sample.azim_ = static_cast<float>(azim);
+      sample.elev_ = static_cast<float>(elev);
+      const float error = fabs(pattern_->gain(sample) - interpolate_(table, azim, elev));
+      maxError = std::max(maxError, error);
+    }
+  }
+  table.errorBound = maxError;
+  return maxError;
+}
+
+void AntennaGainCache::clear()
+{
+  tables_.clear();
+}
+
+AntennaGainCache::Table& AntennaGainCache::table_(const AntennaGainParameters& params)
+{
+  const Key key(params);
+  TableMap::iterator iter = tables_.find(key);
+  if (iter != tables_.end())
+  {
+    iter->second.lastUse = ++useCounter_;
+    return iter->second;
+  }
+
+  // Discard the least recently used table to make room
+  if (tables_.size() >= maxTables_)
+  {
+    TableMap::iterator oldest = tables_.begin();
+    for (TableMap::iterator i = tables_.begin(); i != tables_.end(); ++i)
+    {
+      if (i->second.lastUse < oldest->second.lastUse)
+        oldest = i;
+    }
+    tables_.erase(oldest);
+  }
+
+  Table& table = tables_[key];
+  table.errorBound = -1.f;
+  table.lastUse = ++useCounter_;
+  table.gains.resize(numAz_ * numEl_);
+  AntennaGainParameters sample(params);
+  for (size_t row = 0; row < numEl_; ++row)
+  {
+    sample.elev_ = static_cast<float>(-M_PI_2 + row * elStep_);
+    for (size_t col = 0; col < numAz_; ++col)
+    {
+      sample.azim_ = static_cast<float>(-M_PI + col * azStep_);
+      table.gains[row * numAz_ + col] = pattern_->gain(sample);
+    }
+  }
+  return table;
+}
+
+float AntennaGainCache::interpolate_(const Table& table, double azim, double elev) const
+{
+  const double azIndex = (angFixPI(azim) + M_PI) / azStep_;
+  const double elIndex = (simCore::sdkMax(-M_PI_2, simCore::sdkMin(M_PI_2, elev)) + M_PI_2) / elStep_;
+  const size_t col = std::min(static_cast<size_t>(azIndex), numAz_ - 2);
+  const size_t row = std::min(static_cast<size_t>(elIndex), numEl_ - 2);
+  const float* lower = &table.gains[row * numAz_ + col];
+  const float* upper = lower + numAz_;
+  return bilinearInterpolate(lower[0], lower[1], upper[1], upper[0], azIndex - col, elIndex - row);
+}
+
+}
@@ -0,0 +1,162 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_EM_ANTENNA_GAIN_CACHE_H
+#define SIMCORE_EM_ANTENNA_GAIN_CACHE_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simCore/EM/AntennaPattern.h"
+
+namespace simCore
+{
+
+/**
+* Samples an antenna pattern onto a regular azimuth/elevation grid and answers gain queries by
+* bilinear interpolation of the grid.  A separate grid is baked for each combination of the
+* non-angular AntennaGainParameters (polarity, beam widths, reference gain, lobes, frequency,
+* weighting and delta channel), the first time that combination is queried.  The least recently
+* used grids are discarded once more than maxTables() are cached.
+*
+* Gains are interpolated in dB.  The interpolation error depends on the pattern and the grid
+* spacing; errorBound() estimates it by comparing the pattern against the grid at cell centers.
+*
+* Only table based patterns are baked; see isBaked().  Analytic patterns such as Gauss cost about
+* as much to evaluate as a grid lookup, whose large grids do not stay in the processor cache, so
+* their queries are passed directly to the pattern.
+*
+* The cache does not own the pattern.  Call clear() if the pattern changes, for example after
+* loading a new file.  The cache is not thread safe.
+*/
+class SDKCORE_EXPORT AntennaGainCache
+{
+public:
+  /**
+  * Constructs a cache for the given pattern
+  * @param[in ] pattern Pattern to sample; must remain valid for the life of the cache
+  * @param[in ] azStep Maximum azimuth grid spacing (rad)
+  * @param[in ] elStep Maximum elevation grid spacing (rad)
+  * @param[in ] maxTables Maximum number of grids kept at once; 0 is treated as 1
+  */
+  AntennaGainCache(AntennaPattern* pattern, double azStep, double elStep, size_t maxTables = 8);
+  virtual ~AntennaGainCache();
+
+  /** Pattern that the cache samples */
+  AntennaPattern* pattern() const;
+  /** Azimuth grid spacing (rad); may be less than the requested step so that the grid spans [-PI,PI] evenly */
+  double azStep() const;
+  /** Elevation grid spacing (rad); may be less than the requested step so that the grid spans [-PI/2,PI/2] evenly */
+  double elStep() const;
+  /** Maximum number of grids kept at once */
+  size_t maxTables() const;
+  /** Number of grids currently cached */
+  size_t numTables() const;
+
+  /**
+  * Returns true if gains of the pattern type are baked into grids; false for analytic patterns
+  * (pedestal, Gauss, CscSq, SinXX, omni), which are cheaper to evaluate directly.
+  * @param[in ] type Pattern type
+  * @return true if the type is table based
+  */
+  static bool isBaked(AntennaPatternType type);
+
+  /**
+  * Returns the interpolated gain for the parameters, baking the grid for the parameters if needed
+  * @param[in ] params Gain parameters; azimuth is wrapped to [-PI,PI) and elevation is clamped to [-PI/2,PI/2]
+  * @return antenna pattern gain (dB)
+  */
+  float gain(const AntennaGainParameters& params);
+
+  /**
+  * Returns interpolated gains for arrays of angles that share the remaining parameters
+  * @param[in ] params Gain parameters; azim_ and elev_ are ignored
+  * @param[in ] count Number of angles
+  * @param[in ] azim Relative azimuth angles (rad)
+  * @param[in ] elev Relative elevation angles (rad)
+  * @param[out] gains Gains (dB), count values
+  */
+  void gain(const AntennaGainParameters& params, size_t count, const float* azim, const float* elev, float* gains);
+
+  /**
+  * Estimates the largest interpolation error (dB) of the grid for the parameters, by comparing
+  * the pattern against the interpolated value at the center of every grid cell.  The estimate
+  * is calculated once per grid, the first time it is requested.
+  * @param[in ] params Gain parameters; azim_ and elev_ are ignored
+  * @return largest absolute difference found between the pattern and the grid (dB); 0 if the pattern is not baked
+  */
+  float errorBound(const AntennaGainParameters& params);
+
+  /** Discards all cached grids */
+  void clear();
+
+private:
+  /** Non-angular gain parameters that identify a grid */
+  struct Key
+  {
+    PolarityType polarity;
+    float hbw;
+    float vbw;
+    float refGain;
+    float firstLobe;
+    float backLobe;
+    double freq;
+    bool weighting;
+    bool delta;
+
+    explicit Key(const AntennaGainParameters& params);
+    bool operator<(const Key& other) const;
+  };
+
+  /** Baked gains for one Key */
+  struct Table
+  {
+    std::vector<float> gains;   ///< numEl_ rows of numAz_ gains (dB), by increasing elevation
+    float errorBound;           ///< Estimated interpolation error (dB), or negative if not yet calculated
+    unsigned long long lastUse; ///< Value of useCounter_ when last used
+  };
+  typedef std::map<Key, Table> TableMap;
+
+  /** Returns the table for the parameters, baking it if needed */
+  Table& table_(const AntennaGainParameters& params);
+  /** Interpolates the gain at the angles */
+  float interpolate_(const Table& table, double azim, double elev) const;
+
+  AntennaPattern* pattern_;
+  bool baked_;
+  size_t numAz_;
+  size_t numEl_;
+  double azStep_;
+  double elStep_;
+  size_t maxTables_;
+  TableMap tables_;
+  unsigned long long useCounter_;
+
+  // Not implemented
+  AntennaGainCache(const AntennaGainCache&);
+  AntennaGainCache& operator=(const AntennaGainCache&);
+};
+
+}
+
+#endif /* SIMCORE_EM_ANTENNA_GAIN_CACHE_H */
@@ -491,45 +491,181 @@ float RCSLUT::RCSsm(float freq, double azim, double elev, PolarityType pol)
   case RCS_LUT_TYPE:
     // strictly a lookup table, return mean value
     return calcTableRCS_(freq, azim, elev, pol);
-  
+
   case RCS_SYM_LUT_TYPE:
     // symmetrical lookup table, return mean value
     return calcTableRCS_(freq, fabs(angFixPI(azim)), elev, pol);
-  
+
   case RCS_DISTRIBUTION_FUNC_TYPE:
   default: // UTILS::eRCS_DISTRIBUTION_FUNC_TYPE
+    return applyDistribution_(calcTableRCS_(freq, azim, elev, pol));
+  }
+  return SMALL_RCS_SM;
+}
+
+void RCSLUT::RCSsm(size_t count, const float* freq, const double* azim, const double* elev, const PolarityType* pol, float* rcs)
+{
+  // tables are flattened on load; catch tables added some other way
+  if (flatPolarities_.empty() && !rcsMap_.empty())
+    flattenTables_();
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    // convert incoming azimuth & elevation to correct units & limits
+    const double az = angFix2PI(azim[k]);
+    const double el = angFixPI(elev[k]);
+    switch (tableType_)
+    {
+    case RCS_LUT_TYPE:
+      rcs[k] = calcFlatTableRCS_(freq[k], az, el, pol[k]);
+      break;
+    case RCS_SYM_LUT_TYPE:
+      rcs[k] = calcFlatTableRCS_(freq[k], fabs(angFixPI(az)), el, pol[k]);
+      break;
+    case RCS_DISTRIBUTION_FUNC_TYPE:
+    default:
+      rcs[k] = applyDistribution_(calcFlatTableRCS_(freq[k], az, el, pol[k]));
+      break;
+    }
+  }
+}
+
+void RCSLUT::RCSdB(size_t count, const float* freq, const double* azim, const double* elev, const PolarityType* pol, float* rcs)
+{
+  RCSsm(count, freq, azim, elev, pol, rcs);
+  for (size_t k = 0; k < count; ++k)
+    rcs[k] = linear2dB(rcs[k]);
+}
+
+float RCSLUT::applyDistribution_(double rcs)
+{
+  // apply distribution to mean rcs value
+  switch (functionType_)
+  {
+  case RCS_MEAN_FUNC:
+  default: // RCS_MEAN_FUNC
+    // apply scintillation to mean value
+    return static_cast<float>(rcs + modulation_);
+  case RCS_GAUSSIAN_FUNC:
+    // apply Gaussian distribution to rcs value
+    return static_cast<float>(rcs + (modulation_ * gaussian_()));
+  case RCS_RAYLEIGH_FUNC:
+    {
+      // apply Rayleigh distribution to rcs value
+      // sqrt (sum of the squares of two gaussians)
+      double x = gaussian_();
+      double y = gaussian_();
+      return static_cast<float>(rcs + (modulation_ * (sqrt(square(x) + square(y)))));
+    }
+  case RCS_LOG_NORMAL_FUNC:
+    {
+      // apply log normal distribution to rcs value
+      // (log of Rayleigh)
+      double x = gaussian_();
+      double y = gaussian_();
+      return static_cast<float>(rcs + (modulation_ * (log10(sqrt(square(x) + square(y))))));
+    }
+  }
+}
+
+void RCSLUT::flattenTables_()
+{
+  flatPolarities_.clear();
+  flatPolarityFreqs_.clear();
+  flatFreqs_.clear();
+  flatFreqElevs_.clear();
+  flatElevs_.clear();
+  flatElevAzims_.clear();
+  flatAzims_.clear();
+  flatRcs_.clear();
+
+  for (POLARITY_FREQ_ELEV_MAP::const_iterator pfeiter = rcsMap_.begin(); pfeiter != rcsMap_.end(); ++pfeiter)
+  {
+    FlatRange freqRange = { flatFreqs_.size(), 0 };
+    const FREQ_ELEV_MAP& freqMap = pfeiter->second->freqMap;
+    for (FREQ_ELEV_MAP::const_iterator feiter = freqMap.begin(); feiter != freqMap.end(); ++feiter)
     {
-      const double rcs = calcTableRCS_(freq, azim, elev, pol);
-      // apply distribution to mean rcs value
-      switch (functionType_)
+      FlatRange elevRange = { flatElevs_.size(), 0 };
+      const ELEV_RCSTABLE_MAP& elevMap = feiter->second->eMap;
+      for (ELEV_RCSTABLE_MAP::const_iterator eiter = elevMap.begin(); eiter != elevMap.end(); ++eiter)
       {
-      case RCS_MEAN_FUNC:
-      default: // RCS_MEAN_FUNC
-        // apply scintillation to mean value
-        return static_cast<float>(rcs + modulation_);
-      case RCS_GAUSSIAN_FUNC:
-        // apply Gaussian distribution to rcs value
-        return static_cast<float>(rcs + (modulation_ * gaussian_()));
-      case RCS_RAYLEIGH_FUNC:
-        {
-          // apply Rayleigh distribution to rcs value
-          // sqrt (sum of the squares of two gaussians)
-          double x = gaussian_();
-          double y = gaussian_();
-          return static_cast<float>(rcs + (modulation_ * (sqrt(square(x) + square(y)))));
-        }
-      case RCS_LOG_NORMAL_FUNC:
+        const AZIM_RCS_MAP& azMap = eiter->second->rcsMap();
+        const FlatRange azimRange = { flatAzims_.size(), azMap.size() };
+        for (AZIM_RCS_MAP::const_iterator aiter = azMap.begin(); aiter != azMap.end(); ++aiter)
         {
-          // apply log normal distribution to rcs value
-          // (log of Rayleigh)
-          double x = gaussian_();
-          double y = gaussian_();
-          return static_cast<float>(rcs + (modulation_ * (log10(sqrt(square(x) + square(y))))));
+          flatAzims_.push_back(aiter->first);
+          flatRcs_.push_back(aiter->second);
         }
+        flatElevs_.push_back(eiter->first);
+        flatElevAzims_.push_back(azimRange);
+        ++elevRange.count;
       }
+      flatFreqs_.push_back(feiter->first);
+      flatFreqElevs_.push_back(elevRange);
+      ++freqRange.count;
     }
+    flatPolarities_.push_back(pfeiter->first);
+    flatPolarityFreqs_.push_back(freqRange);
   }
-  return SMALL_RCS_SM;
+}
+
+float RCSLUT::calcFlatTableRCS_(float freq, double azim, double elev, PolarityType pol) const
+{
+  if (flatPolarities_.empty())
+    return SMALL_RCS_SM;
+
+  // unknown polarity uses the first one
+  size_t polIndex = 0;
+  if (pol != POLARITY_UNKNOWN)
+  {
+    polIndex = std::find(flatPolarities_.begin(), flatPolarities_.end(), pol) - flatPolarities_.begin();
+    if (polIndex == flatPolarities_.size())
+      return SMALL_RCS_SM;
+  }
+
+  // choose closest frequency, favoring the lower one on ties
+  const FlatRange& freqRange = flatPolarityFreqs_[polIndex];
+  const float* freqBegin = &flatFreqs_[freqRange.first];
+  const float* freqEnd = freqBegin + freqRange.count;
+  const float* freqIter = std::lower_bound(freqBegin, freqEnd, freq);
+  if (freqIter == freqEnd)
+    --freqIter;
+  else if (*freqIter != freq && freqIter != freqBegin && fabs(freq - *(freqIter - 1)) <= fabs(*freqIter - freq))
+    --freqIter;
+
+  // find elevation tables bounding the requested elevation
+  const FlatRange& elevRange = flatFreqElevs_[freqRange.first + (freqIter - freqBegin)];
+  if (elevRange.count == 1)
+    return flatTableRCS_(elevRange.first, azim);
+  const float* elevBegin = &flatElevs_[elevRange.first];
+  const float* elevEnd = elevBegin + elevRange.count;
+  const float* elevIter = std::lower_bound(elevBegin, elevEnd, static_cast<float>(elev));
+  if (elevIter == elevEnd)
+    return flatTableRCS_(elevRange.first + elevRange.count - 1, azim);
+  const size_t hiTable = elevRange.first + (elevIter - elevBegin);
+  if (*elevIter == static_cast<float>(elev) || elevIter == elevBegin)
+    return flatTableRCS_(hiTable, azim);
+  return linearInterpolate(flatTableRCS_(hiTable - 1, azim), flatTableRCS_(hiTable, azim), flatElevs_[hiTable - 1], elev, flatElevs_[hiTable]);
+}
+
+float RCSLUT::flatTableRCS_(size_t table, double azim) const
+{
+  const FlatRange& azimRange = flatElevAzims_[table];
+  if (azimRange.count == 0)
+    return static_cast<float>(SMALL_RCS_SM);
+  const float* rcs = &flatRcs_[azimRange.first];
+  if (azimRange.count == 1)
+    return rcs[0];
+
+  const float* azimBegin = &flatAzims_[azimRange.first];
+  const float* azimEnd = azimBegin + azimRange.count;
+  const float* azimIter = std::lower_bound(azimBegin, azimEnd, static_cast<float>(azim));
+  if (azimIter == azimEnd)
+    return rcs[azimRange.count - 1];
+  const size_t hi = azimIter - azimBegin;
+  if (*azimIter == static_cast<float>(azim) || hi == 0)
+    return rcs[hi];
+  return linearInterpolate(rcs[hi - 1], rcs[hi], azimBegin[hi - 1], azim, azimBegin[hi]);
 }
 
 int RCSLUT::loadXPATCHRCSFile_(std::istream &inFile)
@@ -1292,6 +1428,7 @@ void RCSLUT::reset_()
     loTable_[i] = nullptr;
     hiTable_[i] = nullptr;
   }
+  flattenTables_();
   mean_ = 0.;
   median_ = SMALL_DB_VAL;
   min_ = std::numeric_limits<float>::max();
@@ -1330,21 +1467,28 @@ int RCSLUT::loadRCSFile(const std::string& fname)
 int RCSLUT::loadRCSFile(std::istream& istream)
 {
   RCSType rcsType = getRCSType(istream);
+  int rv = 1;
   switch (rcsType)
   {
   case RCS_LUT:
-    return loadRcsLutFile_(istream);
+    rv = loadRcsLutFile_(istream);
+    break;
   case RCS_XPATCH:
-    return loadXPATCHRCSFile_(istream);
+    rv = loadXPATCHRCSFile_(istream);
+    break;
   case RCS_SADM:
-    return loadSADMRCSFile_(istream);
+    rv = loadSADMRCSFile_(istream);
+    break;
   case NO_RCS:
   case RCS_BLOOM:
   case RCS_RTS:
     // Not handled
     break;
   }
-  return 1;
+  // contiguous copy of the tables for batch look ups
+  if (rv == 0)
+    flattenTables_();
+  return rv;
 }
 
 
@@ -131,6 +131,12 @@ namespace simCore
     */
     void setRCS(float azim, float rcs);
 
+    /**
+    * This method retrieves the radar cross section values of the table
+    * @return RCS values in square meters, keyed on azimuth relative to host (rad)
+    */
+    const AZIM_RCS_MAP& rcsMap() const { return azMap_; }
+
     /**
     * This method retrieves the measured frequency associated to this RCSTable
     * @return measured frequency (MHz)
@@ -264,6 +270,30 @@ namespace simCore
     */
     virtual float RCSdB(float freq, double azim, double elev, PolarityType pol=POLARITY_UNKNOWN);
 
+    /**
+    * This method computes RCS values in square meters for arrays of requests.  Lookups use a
+    * contiguous copy of the loaded tables and give the same values as the single request
+    * version, without updating its table cache.
+    * @param[in ] count Number of requests
+    * @param[in ] freq Frequencies of radar in MHz
+    * @param[in ] azim Relative azimuth angles, referenced to host platform (rad)
+    * @param[in ] elev Relative elevation angles, referenced to host platform (rad)
+    * @param[in ] pol Radar polarities
+    * @param[out] rcs RCS values (square meters), count values
+    */
+    void RCSsm(size_t count, const float* freq, const double* azim, const double* elev, const PolarityType* pol, float* rcs);
+
+    /**
+    * This method computes RCS values in dB for arrays of requests; see the square meter version
+    * @param[in ] count Number of requests
+    * @param[in ] freq Frequencies of radar in MHz
+    * @param[in ] azim Relative azimuth angles, referenced to host platform (rad)
+    * @param[in ] elev Relative elevation angles, referenced to host platform (rad)
+    * @param[in ] pol Radar polarities
+    * @param[out] rcs RCS values (dB), count values
+    */
+    void RCSdB(size_t count, const float* freq, const double* azim, const double* elev, const PolarityType* pol, float* rcs);
+
     /**
     * This method sets the radar cross section modulation value
     * @param[in ] mod Radar cross section modulation value (sq meters)
@@ -318,6 +348,22 @@ namespace simCore
     RCSTable *loTable_[2];              ///< pointers to two last accessed lo tables
     RCSTable *hiTable_[2];              ///< pointers to two last accessed hi tables
 
+    /** Range of entries in one of the flattened arrays */
+    struct FlatRange
+    {
+      size_t first;                     ///< index of first entry
+      size_t count;                     ///< number of entries
+    };
+    // Contiguous copy of rcsMap_, used by the batch look ups; each level lists ranges into the next
+    std::vector<PolarityType> flatPolarities_;  ///< polarities, in rcsMap_ order
+    std::vector<FlatRange> flatPolarityFreqs_;  ///< range in flatFreqs_ for each polarity
+    std::vector<float> flatFreqs_;              ///< frequencies (MHz), ascending for each polarity
+    std::vector<FlatRange> flatFreqElevs_;      ///< range in flatElevs_ for each frequency
+    std::vector<float> flatElevs_;              ///< table elevations (rad), ascending for each frequency
+    std::vector<FlatRange> flatElevAzims_;      ///< range in flatAzims_ for each table
+    std::vector<float> flatAzims_;              ///< azimuths (rad), ascending for each table
+    std::vector<float> flatRcs_;                ///< RCS (sq meter) at each azimuth in flatAzims_
+
     /**
     * This method returns an azimuth based RCSTable
     * @param[in ] freq Frequency of radar in MHz
@@ -338,6 +384,36 @@ namespace simCore
     */
     float calcTableRCS_(float freq, double azim, double elev, PolarityType pol);
 
+    /**
+    * This method copies rcsMap_ into the flattened arrays used for batch look ups
+    */
+    void flattenTables_();
+
+    /**
+    * This method returns a RCS value (sq meter) from the flattened tables, matching calcTableRCS_()
+    * @param[in ] freq Frequency of radar in MHz
+    * @param[in ] azim Relative azimuth angle, referenced to host platform (rad)
+    * @param[in ] elev Relative elevation angle, referenced to host platform (rad)
+    * @param[in ] pol Radar polarity
+    * @return RCS value in square meters.
+    */
+    float calcFlatTableRCS_(float freq, double azim, double elev, PolarityType pol) const;
+
+    /**
+    * This method returns a RCS value (sq meter) for one flattened table, matching RCSTable::RCS()
+    * @param[in ] table Index of table in flatElevAzims_
+    * @param[in ] azim Relative azimuth angle, referenced to host platform (rad)
+    * @return RCS value in square meters.
+    */
+    float flatTableRCS_(size_t table, double azim) const;
+
+    /**
+    * This method applies the distribution function to a mean RCS value, for distribution table types
+    * @param[in ] rcs Mean RCS value (sq meter)
+    * @return RCS value in square meters.
+    */
+    float applyDistribution_(double rcs);
+
     /**
     * This method parses and loads a RCS table file (RCS_LUT type)
     * @param[in ] inFile Input stream
@@ -20,14 +20,17 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cctype>
 #include <iomanip>
+#include <iterator>
 
 #include "simNotify/Notify.h"
 #include "simCore/Common/Exception.h"
 #include "simCore/Common/Optional.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simCore/String/Angle.h"
 #include "simCore/String/Format.h"
-#include "simCore/String/Tokenizer.h"
 #include "simCore/String/Utils.h"
 #include "simCore/String/ValidNumber.h"
 #include "simCore/Time/String.h"
@@ -53,6 +56,107 @@ static const std::set<std::string> CASE_SENSITIVE_GOG_TOKENS = {
   "annotation", "comment", "name", "imagefile", "kml_icon", "starttime", "endtime"
 };
 
+/// Lines per chunk of a parallel parse, before extending the chunk to the next start command
+static const size_t MIN_LINES_PER_CHUNK = 1024;
+
+/// White space that separates GOG tokens, same as simCore::STR_WHITE_SPACE_CHARS
+static const std::string_view GOG_WHITE_SPACE = " \n\r\t";
+
+/// Splits the data into lines the same way as simCore::getStrippedLine()
+void splitStrippedLines(std::string_view data, std::vector<std::string_view>& lines)
+{
+  size_t offset = 0;
+  while (offset < data.size())
+  {
+    size_t end = data.find('\n', offset);
+    const size_t next = (end == std::string_view::npos) ? data.size() : end + 1;
+    if (end == std::string_view::npos)
+      end = data.size();
+    // strip trailing white space
+    while (end > offset && (data[end - 1] == ' ' || data[end - 1] == '\r' || data[end - 1] == '\t'))
+      --end;
+    lines.push_back(data.substr(offset, end - offset));
+    offset = next;
+  }
+}
+
+/// Returns true if the first word of the line is "start", in any case
+bool isStartLine(std::string_view line)
+{
+  static const char START[] = "start";
+  const char* pos = line.data();
+  const char* end = pos + line.size();
+  while (pos != end && (*pos == ' ' || *pos == '\t'))
+    ++pos;
+  for (size_t i = 0; i + 1 < sizeof(START); ++i, ++pos)
+  {
+    if (pos == end || tolower(static_cast<unsigned char>(*pos)) != START[i])
+      return false;
+  }
+  return pos == end || isspace(static_cast<unsigned char>(*pos));
+}
+
+/**
+ * Returns the position just past the end of the token that begins at start, or npos if the
+ * token runs to the end of the line.  Single, double and triple quoted tokens end at their
+ * closing quote, matching simCore::getTerminateForStringPos() and getFirstCharPosAfterString().
+ */
+size_t findTokenEnd(std::string_view line, size_t start)
+{
+  std::string_view terminator;
+  if (line[start] == '\'')
+    terminator = "'";
+  else if (line[start] == '"')
+  {
+    // match three quotes but not four
+    const bool triple = (start + 3 <= line.size() && line[start + 1] == '"' && line[start + 2] == '"' &&
+      (start + 3 == line.size() || line[start + 3] != '"'));
+    terminator = triple ? "\"\"\"" : "\"";
+  }
+  else
+    return line.find_first_of(GOG_WHITE_SPACE, start + 1);
+
+  size_t pos = line.find(terminator, start + 1);
+  if (pos == std::string_view::npos)
+    return pos;
+
+  // double quotes can be escaped with an odd number of back slashes
+  if (terminator == "\"")
+  {
+    while (line[pos - 1] == '\\')
+    {
+      size_t counterPos = pos - 1;
+      unsigned int counter = 1;
+      while (counterPos > 0 && line[counterPos - 1] == '\\')
+      {
+        ++counter;
+        --counterPos;
+      }
+      if ((counter % 2) == 0)
+        break;
+      pos = line.find(terminator, pos + 1);
+      if (pos == std::string_view::npos)
+        return pos;
+    }
+  }
+  return pos + terminator.size();
+}
+
+/// Tokenizes the line in place, giving the same tokens as simCore::quoteTokenizer()
+void tokenizeLine(std::string_view line, std::vector<std::string_view>& tokens)
+{
+  tokens.clear();
+  size_t start = line.find_first_not_of(GOG_WHITE_SPACE);
+  while (start != std::string_view::npos)
+  {
+    const size_t end = findTokenEnd(line, start);
+    tokens.push_back(line.substr(start, end - start));
+    if (end == std::string_view::npos)
+      return;
+    start = line.find_first_not_of(GOG_WHITE_SPACE, end);
+  }
+}
+
 }
 
 //------------------------------------------------------------------------
@@ -63,8 +167,45 @@ namespace simCore { namespace GOG {
 // (ref SIMDIS user manual, sec. 8.8.1)
 const simCore::Vec3 BSTUR(simCore::DEG2RAD*22.1194392, simCore::DEG2RAD*-159.9194988, 0.0);
 
+/** State carried from line to line while parsing GOG input */
+struct Parser::ParseState
+{
+  /// Modifier state, with default values. The state persists across the parsing of the
+  /// GOG input for annotations, spanning actual objects. (e.g. if the line color is set
+  /// within the scope of one annotation, that value remains active for future annotations
+  /// until it is set again.)
+  ModifierState modifiers;
+  /// valid commands must occur within a start/end block
+  bool validStartEndBlock = false;
+  bool invalidShape = false;
+  ParsedShape current;
+  /// reference origin settings within a start/end block
+  simCore::Optional<PositionStrings> refLla;
+};
+
+/** Notification recorded by a parallel parse, to be sent to simNotify in order once parsing completes */
+struct Parser::Message
+{
+  simNotify::NotifySeverity severity;
+  std::string text;
+  bool flush; ///< Message is ended with std::endl instead of being written as is
+};
+
+/** Storage for the tokens of a line, kept between lines to avoid reallocating */
+struct Parser::LineBuffers
+{
+  /// Tokens of the line, referencing the input data
+  std::vector<std::string_view> views;
+  /// Tokens of the line, lowercased where applicable
+  std::vector<std::string> tokens;
+  /// Tokens joined back into a line with single spaces
+  std::string line;
+};
+
 Parser::Parser()
-  : units_(nullptr)
+  : units_(nullptr),
+    numThreads_(1),
+    messages_(nullptr)
 {
   initGogColors_();
 
@@ -125,698 +266,827 @@ void Parser::setUnitsRegistry(const simCore::UnitsRegistry* registry)
   units_ = registry;
 }
 
-void Parser::parse(std::istream& input, const std::string& filename, std::vector<GogShapePtr>& output) const
+void Parser::setNumThreads(unsigned int numThreads)
 {
-  // Set up the modifier state object with default values. The state persists
-  // across the parsing of the GOG input for annotations, spanning actual objects.
-  // (e.g. if the line color is set within the scope of one annotation, that value
-  // remains active for future annotations until it is set again.)
-  ModifierState state;
+  numThreads_ = numThreads;
+}
 
-  // valid commands must occur within a start/end block
-  bool validStartEndBlock = false;
-  bool invalidShape = false;
+unsigned int Parser::numThreads() const
+{
+  return numThreads_;
+}
 
-  ParsedShape current;
-  std::string line;
-  // reference origin settings within a start/end block
-  simCore::Optional<PositionStrings> refLla;
+void Parser::parse(std::istream& input, const std::string& filename, std::vector<GogShapePtr>& output) const
+{
+  if (numThreads_ != 1)
+  {
+    const std::string buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    parseParallel_(buffer, filename, output);
+    return;
+  }
 
+  ParseState state;
+  LineBuffers buffers;
+  std::string line;
   // track line number parsed for error reporting
   size_t lineNumber = 0;
-
-  std::vector<std::string> tokens;
   while (simCore::getStrippedLine(input, line))
+    parseLine_(line, buffers, ++lineNumber, filename, state, output);
+}
+
+void Parser::parse(const char* data, size_t size, const std::string& filename, std::vector<GogShapePtr>& output) const
+{
+  const std::string_view input(data, size);
+  if (numThreads_ != 1)
   {
-    ++lineNumber;
-    simCore::quoteTokenizer(tokens, line);
+    parseParallel_(input, filename, output);
+    return;
+  }
 
-    // convert tokens to lower case (unless it's in quotes or commented)
-    for (std::string& token : tokens)
-    {
-      if (token[0] != '"' && token[0] != '#' && token[0] !=  '/')
-      {
-        token = simCore::lowerCase(token);
-        // stop further lower case conversion on text based values
-        if (CASE_SENSITIVE_GOG_TOKENS.find(token) != CASE_SENSITIVE_GOG_TOKENS.end())
-          break;
-      }
-    }
-    // rewrite the line now that it's lowered.
-    line = simCore::join(tokens, " ");
+  ParseState state;
+  LineBuffers buffers;
+  std::vector<std::string_view> lines;
+  splitStrippedLines(input, lines);
+  for (size_t k = 0; k < lines.size(); ++k)
+    parseLine_(lines[k], buffers, k + 1, filename, state, output);
+}
 
-    if (tokens.empty())
-    {
-      // skip empty line
-      continue;
-    }
+void Parser::parseParallel_(std::string_view data, const std::string& filename, std::vector<GogShapePtr>& output) const
+{
+  std::vector<std::string_view> lines;
+  splitStrippedLines(data, lines);
+  if (lines.empty())
+    return;
 
-    // determine if the command is within a valid start/end block
-    // acceptable commands are: comments, start and version
-    if (!validStartEndBlock && !isComment_(tokens[0]) && tokens[0] != "start" && tokens[0] != "version")
-    {
-      std::stringstream errorText;
-      errorText << "token \"" << tokens[0] << "\" detected outside of a valid start/end block";
-      printError_(filename, lineNumber, errorText.str());
-      // skip command
-      continue;
-    }
+  // Split the input into chunks that begin with a start command where possible
+  std::vector<size_t> chunkStarts;
+  chunkStarts.push_back(0);
+  for (size_t k = MIN_LINES_PER_CHUNK; k < lines.size(); ++k)
+  {
+    if (k - chunkStarts.back() >= MIN_LINES_PER_CHUNK && isStartLine(lines[k]))
+      chunkStarts.push_back(k);
+  }
+  chunkStarts.push_back(lines.size());
+  const size_t numChunks = chunkStarts.size() - 1;
 
-    if (isComment_(tokens[0]))
-    {
-      // NOTE: this will only store comments within a start/end block
-      current.addComment(line);
+  /** Results of parsing one chunk */
+  struct ChunkResult
+  {
+    std::vector<GogShapePtr> shapes;
+    std::vector<Message> messages;
+    ParseState state;
+  };
+  std::vector<ChunkResult> results(numChunks);
+
+  // Parses the chunk, starting from the state given; notifications are recorded
+  // by a copy of this parser so that they can be replayed in order
+  auto parseChunk = [&](size_t chunk, const ParseState& initialState) {
+    ChunkResult& result = results[chunk];
+    result.shapes.clear();
+    result.messages.clear();
+    result.state = initialState;
+    Parser chunkParser(*this);
+    chunkParser.messages_ = &result.messages;
+    LineBuffers buffers;
+    for (size_t k = chunkStarts[chunk]; k < chunkStarts[chunk + 1]; ++k)
+      chunkParser.parseLine_(lines[k], buffers, k + 1, filename, result.state, result.shapes);
+  };
+
+  // Each chunk is parsed assuming that it starts outside of a start/end block.  Outside of a
+  // block, the rest of the parse state is discarded by the next start command, so the
+  // assumption is only wrong if the previous chunk ended inside a block.
+  // No more threads than chunks are started, and none for a single chunk.
+  const ParseState outsideBlock;
+  const size_t numThreads = std::min<size_t>(numThreads_ == 0 ? ThreadPool::hardwareThreads() : numThreads_, numChunks);
+  if (numThreads <= 1)
+  {
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+      parseChunk(chunk, outsideBlock);
+  }
+  else
+  {
+    ThreadPool pool(static_cast<unsigned int>(numThreads));
+    pool.parallelFor(numChunks, [&](size_t begin, size_t end) {
+      for (size_t chunk = begin; chunk < end; ++chunk)
+        parseChunk(chunk, outsideBlock);
+    });
+  }
 
-      // process deprecated KML icon comment keywords
-      if (tokens.size () > 2 && tokens[1] == "kml_icon")
-        current.set(ShapeParameter::IMAGE, tokens[2]);
-      if (tokens.size() > 1 && tokens[1] == "kml_groundoverlay")
-        current.setShape(ShapeType::IMAGEOVERLAY);
-      if (tokens.size() > 1 && tokens[1] == "kml_latlonbox")
-      {
-        if (tokens.size() > 6)
-        {
-          current.set(ShapeParameter::LLABOX_N, tokens[2]);
-          current.set(ShapeParameter::LLABOX_S, tokens[3]);
-          current.set(ShapeParameter::LLABOX_E, tokens[4]);
-          current.set(ShapeParameter::LLABOX_W, tokens[5]);
-          current.set(ShapeParameter::LLABOX_ROT, tokens[6]);
-        }
-      }
-    }
-    else if (tokens[0] == "start" || tokens[0] == "end")
+  // Reparse chunks that followed an unterminated block, using the actual state
+  for (size_t chunk = 1; chunk < numChunks; ++chunk)
+  {
+    if (results[chunk - 1].state.validStartEndBlock)
     {
-      if (validStartEndBlock && tokens[0] == "start")
-      {
-        printError_(filename, lineNumber, "nested start command not allowed");
-        continue;
-      }
-      if (!validStartEndBlock && tokens[0] == "end")
-      {
-        printError_(filename, lineNumber, "end command encountered before start");
-        continue;
-      }
-      if (tokens[0] == "end" && current.shape() == ShapeType::UNKNOWN)
-      {
-        printError_(filename, lineNumber, "end command encountered before recognized GOG shape type keyword");
-        continue;
-      }
-
-      // apply all cached information to shape when end is reached, only if shape is valid
-      if (tokens[0] == "end" && !invalidShape)
-      {
-        // set the relative state based on point type if it hasn't already been specified
-        if (!current.hasValue(ShapeParameter::ABSOLUTE_POINTS) && current.pointType() == ParsedShape::LLA)
-          current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
-        state.apply(current);
-        current.setFilename(filename);
-        GogShapePtr gog = getShape_(current);
-        if (gog)
-          output.push_back(gog);
-      }
-
-      // clear reference origin settings for new block of commands
-      refLla.reset();
-      invalidShape = false;
-
-      // "start" indicates a valid block, "end" indicates the block of commands are complete and subsequent commands will be invalid
-      validStartEndBlock = (tokens[0] == "start");
-      current.reset();
-      current.setLineNumber(lineNumber);
-      state = ModifierState();
+      const ParseState previousState = results[chunk - 1].state;
+      parseChunk(chunk, previousState);
     }
-    else if (tokens[0] == "annotation")
+  }
+
+  for (size_t chunk = 0; chunk < numChunks; ++chunk)
+  {
+    const ChunkResult& result = results[chunk];
+    for (const Message& message : result.messages)
     {
-      if (tokens.size() >= 2)
+      if (message.flush)
       {
-        // special case: annotations. you can have multiple annotations within
-        // a single start/end block.
-        if (current.shape() == ShapeType::ANNOTATION)
-        {
-          // set the relative state based on point type if it hasn't already been specified
-          if (!current.hasValue(ShapeParameter::ABSOLUTE_POINTS) && current.pointType() == ParsedShape::LLA)
-            current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
-          state.apply(current);
-          current.setFilename(filename);
-          GogShapePtr gog = getShape_(current);
-          if (gog)
-            output.push_back(gog);
-          current.reset();
-          // if available, recreate reference origin
-          // values are needed for subsequent annotation points since a new "current" is used
-          if (refLla.has_value())
-            current.set(ShapeParameter::REF_LLA, refLla.value_or(PositionStrings()));
-        }
-        if (current.shape() != ShapeType::UNKNOWN)
-        {
-          SIM_WARN << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
-          // treat as an annotation and keep going
-        }
-        current.setShape(ShapeType::ANNOTATION);
-        std::string textToken = simCore::StringUtils::trim(line.substr(tokens[0].length() + 1));
-        // clean up text
-        textToken = simCore::StringUtils::substitute(textToken, "_", " ");
-        textToken = simCore::StringUtils::substitute(textToken, "\\n", "\n");
-        current.set(ShapeParameter::TEXT, textToken);
-        current.set(ShapeParameter::NAME, textToken);
-        invalidShape = false;  // Required to allow processing of valid annotations after an invalid annotation
+        SIM_NOTIFY(message.severity) << message.text << std::endl;
       }
       else
       {
-        printError_(filename, lineNumber, "annotation command requires at least 1 argument");
-        // shape is recognized, but invalid, so set the shape type correctly
-        current.setShape(ShapeType::ANNOTATION);
-        invalidShape = true;
+        SIM_NOTIFY(message.severity) << message.text;
       }
     }
-    // object types
-    else if (
-      tokens[0] == "circle"        ||
-      tokens[0] == "ellipse"       ||
-      tokens[0] == "arc"           ||
-      tokens[0] == "cylinder"      ||
-      tokens[0] == "hemisphere"    ||
-      tokens[0] == "sphere"        ||
-      tokens[0] == "ellipsoid"     ||
-      tokens[0] == "points"        ||
-      tokens[0] == "line"          ||
-      tokens[0] == "poly"          ||
-      tokens[0] == "polygon"       ||
-      tokens[0] == "linesegs"      ||
-      tokens[0] == "cone"          ||
-      tokens[0] == "orbit"
-      )
+    output.insert(output.end(), result.shapes.begin(), result.shapes.end());
+  }
+}
+
+void Parser::parseLine_(std::string_view input, LineBuffers& buffers, size_t lineNumber, const std::string& filename, ParseState& parseState, std::vector<GogShapePtr>& output) const
+{
+  ModifierState& state = parseState.modifiers;
+  ParsedShape& current = parseState.current;
+  bool& validStartEndBlock = parseState.validStartEndBlock;
+  bool& invalidShape = parseState.invalidShape;
+  simCore::Optional<PositionStrings>& refLla = parseState.refLla;
+  const std::vector<std::string>& tokens = buffers.tokens;
+  const std::string& line = buffers.line;
+
+  tokenizeLine(input, buffers.views);
+
+  // copy tokens, converting to lower case (unless it's in quotes or commented)
+  buffers.tokens.resize(buffers.views.size());
+  bool lower = true;
+  for (size_t k = 0; k < buffers.views.size(); ++k)
+  {
+    std::string& token = buffers.tokens[k];
+    token.assign(buffers.views[k]);
+    if (lower && token[0] != '"' && token[0] != '#' && token[0] != '/')
     {
-      if (current.shape() != ShapeType::UNKNOWN)
-      {
-        SIM_WARN << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
-        invalidShape = true;
-      }
-      current.setShape(GogShape::stringToShapeType(tokens[0]));
+      std::transform(token.begin(), token.end(), token.begin(), ::tolower);
+      // stop further lower case conversion on text based values
+      if (CASE_SENSITIVE_GOG_TOKENS.find(token) != CASE_SENSITIVE_GOG_TOKENS.end())
+        lower = false;
     }
-    else if (tokens[0] == "latlonaltbox")
+  }
+  // rewrite the line now that it's lowered.
+  buffers.line.clear();
+  for (size_t k = 0; k < tokens.size(); ++k)
+  {
+    if (k != 0)
+      buffers.line += ' ';
+    buffers.line += tokens[k];
+  }
+
+  if (tokens.empty())
+  {
+    // skip empty line
+    return;
+  }
+
+  // determine if the command is within a valid start/end block
+  // acceptable commands are: comments, start and version
+  if (!validStartEndBlock && !isComment_(tokens[0]) && tokens[0] != "start" && tokens[0] != "version")
+  {
+    std::stringstream errorText;
+    errorText << "token \"" << tokens[0] << "\" detected outside of a valid start/end block";
+    printError_(filename, lineNumber, errorText.str());
+    // skip command
+    return;
+  }
+
+  if (isComment_(tokens[0]))
+  {
+    // NOTE: this will only store comments within a start/end block
+    current.addComment(line);
+
+    // process deprecated KML icon comment keywords
+    if (tokens.size () > 2 && tokens[1] == "kml_icon")
+      current.set(ShapeParameter::IMAGE, tokens[2]);
+    if (tokens.size() > 1 && tokens[1] == "kml_groundoverlay")
+      current.setShape(ShapeType::IMAGEOVERLAY);
+    if (tokens.size() > 1 && tokens[1] == "kml_latlonbox")
     {
-      if (tokens.size() > 5)
+      if (tokens.size() > 6)
       {
-        if (current.shape() != ShapeType::UNKNOWN)
-        {
-          SIM_WARN << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
-          invalidShape = true;
-        }
-        current.setShape(ShapeType::LATLONALTBOX);
-        current.set(ShapeParameter::LLABOX_N, tokens[1]);
-        current.set(ShapeParameter::LLABOX_S, tokens[2]);
-        current.set(ShapeParameter::LLABOX_W, tokens[3]);
+        current.set(ShapeParameter::LLABOX_N, tokens[2]);
+        current.set(ShapeParameter::LLABOX_S, tokens[3]);
         current.set(ShapeParameter::LLABOX_E, tokens[4]);
-        current.set(ShapeParameter::LLABOX_MINALT, tokens[5]);
-        if (tokens.size() > 6)
-          current.set(ShapeParameter::LLABOX_MAXALT, tokens[6]);
-      }
-      else
-      {
-        printError_(filename, lineNumber, "latlonaltbox command requires at least 5 arguments");
+        current.set(ShapeParameter::LLABOX_W, tokens[5]);
+        current.set(ShapeParameter::LLABOX_ROT, tokens[6]);
       }
     }
-    else if (tokens[0] == "imageoverlay")
+  }
+  else if (tokens[0] == "start" || tokens[0] == "end")
+  {
+    if (validStartEndBlock && tokens[0] == "start")
     {
-      if (tokens.size() > 4)
-      {
-        if (current.shape() != ShapeType::UNKNOWN)
-        {
-          SIM_WARN << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
-          invalidShape = true;
-        }
-        current.setShape(ShapeType::IMAGEOVERLAY);
-        current.set(ShapeParameter::LLABOX_N, tokens[1]);
-        current.set(ShapeParameter::LLABOX_S, tokens[2]);
-        current.set(ShapeParameter::LLABOX_W, tokens[3]);
-        current.set(ShapeParameter::LLABOX_E, tokens[4]);
-        if (tokens.size() > 5)
-          current.set(ShapeParameter::LLABOX_ROT, tokens[5]);
-      }
-      else
-      {
-        printError_(filename, lineNumber, "imageoverlay command requires at least 4 arguments");
-      }
+      printError_(filename, lineNumber, "nested start command not allowed");
+      return;
     }
-    // arguments
-    else if (tokens[0] == "off")
+    if (!validStartEndBlock && tokens[0] == "end")
     {
-      current.set(ShapeParameter::DRAW, "false");
+      printError_(filename, lineNumber, "end command encountered before start");
+      return;
     }
-    else if (tokens[0] == "ref" || tokens[0] == "referencepoint")
+    if (tokens[0] == "end" && current.shape() == ShapeType::UNKNOWN)
     {
-      if (tokens.size() >= 3)
-      {
-        // cache reference origin line and values for repeated use by GOG objects within a start/end block, such as annotations
-        if (tokens.size() >= 4)
-          refLla = PositionStrings(tokens[1], tokens[2], tokens[3]);
-        else
-          refLla = PositionStrings(tokens[1], tokens[2]);
-        current.set(ShapeParameter::REF_LLA, refLla.value_or(PositionStrings()));
-      }
-      else
-      {
-        printError_(filename, lineNumber, "ref/referencepoint command requires at least 2 arguments");
-      }
+      printError_(filename, lineNumber, "end command encountered before recognized GOG shape type keyword");
+      return;
     }
-    // geometric data
-    else if (tokens[0] == "xy" || tokens[0] == "xyz")
-    {
-      if (tokens.size() >= 3)
-      {
-        if (tokens.size() >= 4)
-          current.append(ParsedShape::XYZ, PositionStrings(tokens[1], tokens[2], tokens[3]));
-        else
-          current.append(ParsedShape::XYZ, PositionStrings(tokens[1], tokens[2]));
-      }
-      else
-      {
-        printError_(filename, lineNumber, "xy/xyz command requires at least 2 arguments");
-      }
-    }
-    else if (tokens[0] == "ll" || tokens[0] == "lla" || tokens[0] == "latlon")
+
+    // apply all cached information to shape when end is reached, only if shape is valid
+    if (tokens[0] == "end" && !invalidShape)
     {
-      if (tokens.size() >= 3)
-      {
-        if (tokens.size() >= 4)
-          current.append(ParsedShape::LLA, PositionStrings(tokens[1], tokens[2], tokens[3]));
-        else
-          current.append(ParsedShape::LLA, PositionStrings(tokens[1], tokens[2]));
-      }
-      else
-        printError_(filename, lineNumber, "ll/lla/latlon command requires at least 2 arguments");
-    }
-    else if (tokens[0] == "mgrs")
+      // set the relative state based on point type if it hasn't already been specified
+      if (!current.hasValue(ShapeParameter::ABSOLUTE_POINTS) && current.pointType() == ParsedShape::LLA)
+        current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
+      state.apply(current);
+      current.setFilename(filename);
+      GogShapePtr gog = getShape_(current);
+      if (gog)
+        output.push_back(gog);
+    }
+
+    // clear reference origin settings for new block of commands
+    refLla.reset();
+    invalidShape = false;
+
+    // "start" indicates a valid block, "end" indicates the block of commands are complete and subsequent commands will be invalid
+    validStartEndBlock = (tokens[0] == "start");
+    current.reset();
+    current.setLineNumber(lineNumber);
+    state = ModifierState();
+  }
+  else if (tokens[0] == "annotation")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
+      // special case: annotations. you can have multiple annotations within
+      // a single start/end block.
+      if (current.shape() == ShapeType::ANNOTATION)
       {
-        double lat;
-        double lon;
-        if (simCore::Mgrs::convertMgrsToGeodetic(tokens[1], lat, lon) != 0)
-          printError_(filename, lineNumber, "Unable to convert MGRS coordinate to lat/lon");
-        else
-        {
-          const std::string& latString = simCore::buildString("", lat * simCore::RAD2DEG);
-          const std::string& lonString = simCore::buildString("", lon * simCore::RAD2DEG);
-          if (tokens.size() >= 3)
-            current.append(ParsedShape::LLA, PositionStrings(latString, lonString, tokens[2]));
-          else
-            current.append(ParsedShape::LLA, PositionStrings(latString, lonString));
-        }
+        // set the relative state based on point type if it hasn't already been specified
+        if (!current.hasValue(ShapeParameter::ABSOLUTE_POINTS) && current.pointType() == ParsedShape::LLA)
+          current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
+        state.apply(current);
+        current.setFilename(filename);
+        GogShapePtr gog = getShape_(current);
+        if (gog)
+          output.push_back(gog);
+        current.reset();
+        // if available, recreate reference origin
+        // values are needed for subsequent annotation points since a new "current" is used
+        if (refLla.has_value())
+          current.set(ShapeParameter::REF_LLA, refLla.value_or(PositionStrings()));
       }
-      else
-        printError_(filename, lineNumber, "mgrs command requires at least 2 arguments");
-    }
-    else if (tokens[0] == "centerxy" || tokens[0] == "centerxyz")
-    {
-      if (tokens.size() >= 3)
+      if (current.shape() != ShapeType::UNKNOWN)
       {
-        current.set(ShapeParameter::ABSOLUTE_POINTS, "0");
-        if (tokens.size() >= 4)
-          current.set(ShapeParameter::CENTERXY, PositionStrings(tokens[1], tokens[2], tokens[3]));
-        else
-          current.set(ShapeParameter::CENTERXY, PositionStrings(tokens[1], tokens[2]));
+        printMultipleShapesWarning_(filename, lineNumber);
+        // treat as an annotation and keep going
       }
-      else
-        printError_(filename, lineNumber, "centerxy/centerxyz command requires at least 2 arguments");
+      current.setShape(ShapeType::ANNOTATION);
+      std::string textToken = simCore::StringUtils::trim(line.substr(tokens[0].length() + 1));
+      // clean up text
+      textToken = simCore::StringUtils::substitute(textToken, "_", " ");
+      textToken = simCore::StringUtils::substitute(textToken, "\\n", "\n");
+      current.set(ShapeParameter::TEXT, textToken);
+      current.set(ShapeParameter::NAME, textToken);
+      invalidShape = false;  // Required to allow processing of valid annotations after an invalid annotation
     }
-    else if (tokens[0] == "centerxy2")
+    else
     {
-      if (tokens.size() >= 3)
-      {
-        current.set(ShapeParameter::ABSOLUTE_POINTS, "0");
-        current.set(ShapeParameter::CENTERXY2, PositionStrings(tokens[1], tokens[2]));
-      }
-      else
-        printError_(filename, lineNumber, "centerxy2 command requires at least 2 arguments");
+      printError_(filename, lineNumber, "annotation command requires at least 1 argument");
+      // shape is recognized, but invalid, so set the shape type correctly
+      current.setShape(ShapeType::ANNOTATION);
+      invalidShape = true;
     }
-    else if (tokens[0] == "centerll" || tokens[0] == "centerlla" || tokens[0] == "centerlatlon")
+  }
+  // object types
+  else if (
+    tokens[0] == "circle"        ||
+    tokens[0] == "ellipse"       ||
+    tokens[0] == "arc"           ||
+    tokens[0] == "cylinder"      ||
+    tokens[0] == "hemisphere"    ||
+    tokens[0] == "sphere"        ||
+    tokens[0] == "ellipsoid"     ||
+    tokens[0] == "points"        ||
+    tokens[0] == "line"          ||
+    tokens[0] == "poly"          ||
+    tokens[0] == "polygon"       ||
+    tokens[0] == "linesegs"      ||
+    tokens[0] == "cone"          ||
+    tokens[0] == "orbit"
+    )
+  {
+    if (current.shape() != ShapeType::UNKNOWN)
     {
-      if (tokens.size() >= 3)
-      {
-        current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
-        if (tokens.size() >= 4)
-          current.set(ShapeParameter::CENTERLL, PositionStrings(tokens[1], tokens[2], tokens[3]));
-        else
-          current.set(ShapeParameter::CENTERLL, PositionStrings(tokens[1], tokens[2]));
-      }
-      else
-        printError_(filename, lineNumber, "centerll/centerlla/centerlatlon command requires at least 2 arguments");
+      printMultipleShapesWarning_(filename, lineNumber);
+      invalidShape = true;
     }
-    else if (tokens[0] == "centerll2" || tokens[0] == "centerlatlon2")
+    current.setShape(GogShape::stringToShapeType(tokens[0]));
+  }
+  else if (tokens[0] == "latlonaltbox")
+  {
+    if (tokens.size() > 5)
     {
-      if (tokens.size() >= 3)
+      if (current.shape() != ShapeType::UNKNOWN)
       {
-        current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
-        // note centerll2 only supports lat and lon, altitude for shape must be derived from first center point
-        current.set(ShapeParameter::CENTERLL2, PositionStrings(tokens[1], tokens[2]));
+        printMultipleShapesWarning_(filename, lineNumber);
+        invalidShape = true;
       }
-      else
-        printError_(filename, lineNumber, "centerll2 command requires at least 2 arguments");
-    }
-    // persistent state modifiers:
-    else if (tokens[0] == "linecolor")
-    {
-      if (tokens.size() == 2)
-        state.lineColor_ = parseGogColor_(tokens[1]);
-      else if (tokens.size() == 3)
-        state.lineColor_ = tokens[2];
-      else
-        printError_(filename, lineNumber, "linecolor command requires at least 1 argument");
-    }
-    else if (tokens[0] == "fillcolor")
-    {
-      if (tokens.size() == 2)
-        state.fillColor_ = parseGogColor_(tokens[1]);
-      else if (tokens.size() == 3)
-        state.fillColor_ = tokens[2];
-      else
-        printError_(filename, lineNumber, "fillcolor command requires at least 1 argument");
-    }
-    else if (tokens[0] == "linewidth")
-    {
-      if (tokens.size() >= 2)
-        state.lineWidth_ = tokens[1];
-      else
-        printError_(filename, lineNumber, "linewidth command requires 1 argument");
-     }
-    else if (tokens[0] == "pointsize")
-    {
-      if (tokens.size() >= 2)
-        state.pointSize_ = tokens[1];
-      else
-        printError_(filename, lineNumber, "pointsize command requires 1 argument");
+      current.setShape(ShapeType::LATLONALTBOX);
+      current.set(ShapeParameter::LLABOX_N, tokens[1]);
+      current.set(ShapeParameter::LLABOX_S, tokens[2]);
+      current.set(ShapeParameter::LLABOX_W, tokens[3]);
+      current.set(ShapeParameter::LLABOX_E, tokens[4]);
+      current.set(ShapeParameter::LLABOX_MINALT, tokens[5]);
+      if (tokens.size() > 6)
+        current.set(ShapeParameter::LLABOX_MAXALT, tokens[6]);
     }
-    else if (tokens[0] == "altitudemode")
+    else
     {
-      if (tokens.size() >= 2)
-        state.altitudeMode_ = tokens[1];
-      else
-        printError_(filename, lineNumber, "altitudemode command requires 1 argument");
+      printError_(filename, lineNumber, "latlonaltbox command requires at least 5 arguments");
     }
-    else if (tokens[0] == "altitudeunits")
+  }
+  else if (tokens[0] == "imageoverlay")
+  {
+    if (tokens.size() > 4)
     {
-      if (tokens.size() >= 2)
+      if (current.shape() != ShapeType::UNKNOWN)
       {
-        std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
-        state.altitudeUnits_ = restOfLine;
+        printMultipleShapesWarning_(filename, lineNumber);
+        invalidShape = true;
       }
-      else
-        printError_(filename, lineNumber, "altitudeunits command requires 1 argument");
+      current.setShape(ShapeType::IMAGEOVERLAY);
+      current.set(ShapeParameter::LLABOX_N, tokens[1]);
+      current.set(ShapeParameter::LLABOX_S, tokens[2]);
+      current.set(ShapeParameter::LLABOX_W, tokens[3]);
+      current.set(ShapeParameter::LLABOX_E, tokens[4]);
+      if (tokens.size() > 5)
+        current.set(ShapeParameter::LLABOX_ROT, tokens[5]);
     }
-    else if (tokens[0] == "rangeunits")
+    else
     {
-      if (tokens.size() >= 2)
-      {
-        std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
-        state.rangeUnits_ = restOfLine;
-      }
-      else
-        printError_(filename, lineNumber, "rangeunits command requires 1 argument");
+      printError_(filename, lineNumber, "imageoverlay command requires at least 4 arguments");
     }
-    else if (tokens[0] == "angleunits")
+  }
+  // arguments
+  else if (tokens[0] == "off")
+  {
+    current.set(ShapeParameter::DRAW, "false");
+  }
+  else if (tokens[0] == "ref" || tokens[0] == "referencepoint")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-      {
-        std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
-        state.angleUnits_ = restOfLine;
-      }
+      // cache reference origin line and values for repeated use by GOG objects within a start/end block, such as annotations
+      if (tokens.size() >= 4)
+        refLla = PositionStrings(tokens[1], tokens[2], tokens[3]);
       else
-        printError_(filename, lineNumber, "angleunits command requires 1 argument");
+        refLla = PositionStrings(tokens[1], tokens[2]);
+      current.set(ShapeParameter::REF_LLA, refLla.value_or(PositionStrings()));
     }
-    else if (tokens[0] == "verticaldatum")
+    else
     {
-      if (tokens.size() >= 2)
-        state.verticalDatum_ = tokens[1];
-      else
-        printError_(filename, lineNumber, "verticaldatum command requires 1 argument");
+      printError_(filename, lineNumber, "ref/referencepoint command requires at least 2 arguments");
     }
-    else if (tokens[0] == "priority")
+  }
+  // geometric data
+  else if (tokens[0] == "xy" || tokens[0] == "xyz")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-        state.priority_ = tokens[1];
+      if (tokens.size() >= 4)
+        current.append(ParsedShape::XYZ, PositionStrings(tokens[1], tokens[2], tokens[3]));
       else
-        printError_(filename, lineNumber, "priority command requires 1 argument");
+        current.append(ParsedShape::XYZ, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "filled")
-    {
-      current.set(ShapeParameter::FILLED, "true");
-    }
-    else if (tokens[0] == "outline")
+    else
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::OUTLINE, tokens[1]);
-      else
-        printError_(filename, lineNumber, "outline command requires 1 argument");
+      printError_(filename, lineNumber, "xy/xyz command requires at least 2 arguments");
     }
-    else if (tokens[0] == "textoutlinecolor")
+  }
+  else if (tokens[0] == "ll" || tokens[0] == "lla" || tokens[0] == "latlon")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() == 2)
-        state.textOutlineColor_ = parseGogColor_(tokens[1]);
-      else if (tokens.size() == 3)
-        state.textOutlineColor_ = tokens[2];
+      if (tokens.size() >= 4)
+        current.append(ParsedShape::LLA, PositionStrings(tokens[1], tokens[2], tokens[3]));
       else
-        printError_(filename, lineNumber, "textoutlinecolor command requires at least 1 argument");
+        current.append(ParsedShape::LLA, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "textoutlinethickness")
+    else
+      printError_(filename, lineNumber, "ll/lla/latlon command requires at least 2 arguments");
+  }
+  else if (tokens[0] == "mgrs")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
-        state.textOutlineThickness_ = tokens[1];
+      double lat;
+      double lon;
+      if (simCore::Mgrs::convertMgrsToGeodetic(tokens[1], lat, lon) != 0)
+        printError_(filename, lineNumber, "Unable to convert MGRS coordinate to lat/lon");
       else
-        printError_(filename, lineNumber, "textoutlinethickness command requires 1 argument");
-    }
-    else if (tokens[0] == "diameter")
-    {
-      if (tokens.size() >= 2)
       {
-        double value = 1.0;
-        if (simCore::isValidNumber(tokens[1], value))
-        {
-          std::ostringstream os;
-          os << (value * 0.5);
-          current.set(ShapeParameter::RADIUS, os.str());
-        }
+        const std::string& latString = simCore::buildString("", lat * simCore::RAD2DEG);
+        const std::string& lonString = simCore::buildString("", lon * simCore::RAD2DEG);
+        if (tokens.size() >= 3)
+          current.append(ParsedShape::LLA, PositionStrings(latString, lonString, tokens[2]));
+        else
+          current.append(ParsedShape::LLA, PositionStrings(latString, lonString));
       }
-      else
-        printError_(filename, lineNumber, "diameter command requires 1 argument");
     }
-    else if (tokens[0] == "radius")
+    else
+      printError_(filename, lineNumber, "mgrs command requires at least 2 arguments");
+  }
+  else if (tokens[0] == "centerxy" || tokens[0] == "centerxyz")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::RADIUS, tokens[1]);
+      current.set(ShapeParameter::ABSOLUTE_POINTS, "0");
+      if (tokens.size() >= 4)
+        current.set(ShapeParameter::CENTERXY, PositionStrings(tokens[1], tokens[2], tokens[3]));
       else
-        printError_(filename, lineNumber, "radius command requires 1 argument");
+        current.set(ShapeParameter::CENTERXY, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "innerradius")
+    else
+      printError_(filename, lineNumber, "centerxy/centerxyz command requires at least 2 arguments");
+  }
+  else if (tokens[0] == "centerxy2")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::INNERRADIUS, tokens[1]);
-      else
-        printError_(filename, lineNumber, "innerradius command requires 1 argument");
+      current.set(ShapeParameter::ABSOLUTE_POINTS, "0");
+      current.set(ShapeParameter::CENTERXY2, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "anglestart")
+    else
+      printError_(filename, lineNumber, "centerxy2 command requires at least 2 arguments");
+  }
+  else if (tokens[0] == "centerll" || tokens[0] == "centerlla" || tokens[0] == "centerlatlon")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::ANGLESTART, tokens[1]);
+      current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
+      if (tokens.size() >= 4)
+        current.set(ShapeParameter::CENTERLL, PositionStrings(tokens[1], tokens[2], tokens[3]));
       else
-        printError_(filename, lineNumber, "anglestart command requires 1 argument");
+        current.set(ShapeParameter::CENTERLL, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "angleend")
+    else
+      printError_(filename, lineNumber, "centerll/centerlla/centerlatlon command requires at least 2 arguments");
+  }
+  else if (tokens[0] == "centerll2" || tokens[0] == "centerlatlon2")
+  {
+    if (tokens.size() >= 3)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::ANGLEEND, tokens[1]);
-      else
-        printError_(filename, lineNumber, "angleend command requires 1 argument");
+      current.set(ShapeParameter::ABSOLUTE_POINTS, "1");
+      // note centerll2 only supports lat and lon, altitude for shape must be derived from first center point
+      current.set(ShapeParameter::CENTERLL2, PositionStrings(tokens[1], tokens[2]));
     }
-    else if (tokens[0] == "angledeg")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::ANGLEDEG, tokens[1]);
-      else
-        printError_(filename, lineNumber, "angledeg command requires 1 argument");
+    else
+      printError_(filename, lineNumber, "centerll2 command requires at least 2 arguments");
+  }
+  // persistent state modifiers:
+  else if (tokens[0] == "linecolor")
+  {
+    if (tokens.size() == 2)
+      state.lineColor_ = parseGogColor_(tokens[1]);
+    else if (tokens.size() == 3)
+      state.lineColor_ = tokens[2];
+    else
+      printError_(filename, lineNumber, "linecolor command requires at least 1 argument");
+  }
+  else if (tokens[0] == "fillcolor")
+  {
+    if (tokens.size() == 2)
+      state.fillColor_ = parseGogColor_(tokens[1]);
+    else if (tokens.size() == 3)
+      state.fillColor_ = tokens[2];
+    else
+      printError_(filename, lineNumber, "fillcolor command requires at least 1 argument");
+  }
+  else if (tokens[0] == "linewidth")
+  {
+    if (tokens.size() >= 2)
+      state.lineWidth_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "linewidth command requires 1 argument");
    }
-    else if (tokens[0] == "majoraxis")
+  else if (tokens[0] == "pointsize")
+  {
+    if (tokens.size() >= 2)
+      state.pointSize_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "pointsize command requires 1 argument");
+  }
+  else if (tokens[0] == "altitudemode")
+  {
+    if (tokens.size() >= 2)
+      state.altitudeMode_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "altitudemode command requires 1 argument");
+  }
+  else if (tokens[0] == "altitudeunits")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::MAJORAXIS, tokens[1]);
-      else
-        printError_(filename, lineNumber, "majoraxis command requires 1 argument");
+      std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
+      state.altitudeUnits_ = restOfLine;
     }
-    else if (tokens[0] == "minoraxis")
+    else
+      printError_(filename, lineNumber, "altitudeunits command requires 1 argument");
+  }
+  else if (tokens[0] == "rangeunits")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::MINORAXIS, tokens[1]);
-      else
-        printError_(filename, lineNumber, "minoraxis command requires 1 argument");
+      std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
+      state.rangeUnits_ = restOfLine;
     }
-    else if (tokens[0] == "semimajoraxis")
+    else
+      printError_(filename, lineNumber, "rangeunits command requires 1 argument");
+  }
+  else if (tokens[0] == "angleunits")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
-      {
-        double value = 1.0;
-        if (simCore::isValidNumber(tokens[1], value))
-        {
-          std::ostringstream os;
-          os << (value * 2.0);
-          current.set(ShapeParameter::MAJORAXIS, os.str());
-        }
-      }
-      else
-        printError_(filename, lineNumber, "semimajoraxis command requires 1 argument");
+      std::string restOfLine = simCore::StringUtils::trim(line.substr(tokens[0].size() + 1));
+      state.angleUnits_ = restOfLine;
     }
-    else if (tokens[0] == "semiminoraxis")
+    else
+      printError_(filename, lineNumber, "angleunits command requires 1 argument");
+  }
+  else if (tokens[0] == "verticaldatum")
+  {
+    if (tokens.size() >= 2)
+      state.verticalDatum_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "verticaldatum command requires 1 argument");
+  }
+  else if (tokens[0] == "priority")
+  {
+    if (tokens.size() >= 2)
+      state.priority_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "priority command requires 1 argument");
+  }
+  else if (tokens[0] == "filled")
+  {
+    current.set(ShapeParameter::FILLED, "true");
+  }
+  else if (tokens[0] == "outline")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::OUTLINE, tokens[1]);
+    else
+      printError_(filename, lineNumber, "outline command requires 1 argument");
+  }
+  else if (tokens[0] == "textoutlinecolor")
+  {
+    if (tokens.size() == 2)
+      state.textOutlineColor_ = parseGogColor_(tokens[1]);
+    else if (tokens.size() == 3)
+      state.textOutlineColor_ = tokens[2];
+    else
+      printError_(filename, lineNumber, "textoutlinecolor command requires at least 1 argument");
+  }
+  else if (tokens[0] == "textoutlinethickness")
+  {
+    if (tokens.size() >= 2)
+      state.textOutlineThickness_ = tokens[1];
+    else
+      printError_(filename, lineNumber, "textoutlinethickness command requires 1 argument");
+  }
+  else if (tokens[0] == "diameter")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
+      double value = 1.0;
+      if (simCore::isValidNumber(tokens[1], value))
       {
-        double value = 1.0;
-        if (simCore::isValidNumber(tokens[1], value))
-        {
-          std::ostringstream os;
-          os << (value * 2.0);
-          current.set(ShapeParameter::MINORAXIS, os.str());
-        }
+        std::ostringstream os;
+        os << (value * 0.5);
+        current.set(ShapeParameter::RADIUS, os.str());
       }
-      else
-        printError_(filename, lineNumber, "semiminoraxis command requires 1 argument");
     }
-    else if (tokens[0] == "scale")
+    else
+      printError_(filename, lineNumber, "diameter command requires 1 argument");
+  }
+  else if (tokens[0] == "radius")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::RADIUS, tokens[1]);
+    else
+      printError_(filename, lineNumber, "radius command requires 1 argument");
+  }
+  else if (tokens[0] == "innerradius")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::INNERRADIUS, tokens[1]);
+    else
+      printError_(filename, lineNumber, "innerradius command requires 1 argument");
+  }
+  else if (tokens[0] == "anglestart")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::ANGLESTART, tokens[1]);
+    else
+      printError_(filename, lineNumber, "anglestart command requires 1 argument");
+  }
+  else if (tokens[0] == "angleend")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::ANGLEEND, tokens[1]);
+    else
+      printError_(filename, lineNumber, "angleend command requires 1 argument");
+  }
+  else if (tokens[0] == "angledeg")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::ANGLEDEG, tokens[1]);
+    else
+      printError_(filename, lineNumber, "angledeg command requires 1 argument");
+ }
+  else if (tokens[0] == "majoraxis")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::MAJORAXIS, tokens[1]);
+    else
+      printError_(filename, lineNumber, "majoraxis command requires 1 argument");
+  }
+  else if (tokens[0] == "minoraxis")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::MINORAXIS, tokens[1]);
+    else
+      printError_(filename, lineNumber, "minoraxis command requires 1 argument");
+  }
+  else if (tokens[0] == "semimajoraxis")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 4)
+      double value = 1.0;
+      if (simCore::isValidNumber(tokens[1], value))
       {
-        current.set(ShapeParameter::SCALEX, tokens[1]);
-        current.set(ShapeParameter::SCALEY, tokens[2]);
-        current.set(ShapeParameter::SCALEZ, tokens[3]);
+        std::ostringstream os;
+        os << (value * 2.0);
+        current.set(ShapeParameter::MAJORAXIS, os.str());
       }
-      else
-        printError_(filename, lineNumber, "scale command requires 3 arguments");
     }
-    else if (tokens[0] == "orient")
+    else
+      printError_(filename, lineNumber, "semimajoraxis command requires 1 argument");
+  }
+  else if (tokens[0] == "semiminoraxis")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
+      double value = 1.0;
+      if (simCore::isValidNumber(tokens[1], value))
       {
-        current.set(ShapeParameter::OFFSETYAW, tokens[1]);
-        if (tokens.size() >= 3)
-        {
-          current.set(ShapeParameter::OFFSETPITCH, tokens[2]);
-          if (tokens.size() >= 4)
-          {
-            current.set(ShapeParameter::OFFSETROLL, tokens[3]);
-            current.set(ShapeParameter::FOLLOW, "cpr"); // c=heading(course), p=pitch, r=roll
-          }
-          else
-            current.set(ShapeParameter::FOLLOW, "cp"); // c=heading(course), p=pitch, r=roll
-        }
-        else
-          current.set(ShapeParameter::FOLLOW, "c");
+        std::ostringstream os;
+        os << (value * 2.0);
+        current.set(ShapeParameter::MINORAXIS, os.str());
       }
-      else
-        printError_(filename, lineNumber, "orient command requires at least 1 argument");
-    }
-    else if (startsWith(line, "rotate"))
-      current.set(ShapeParameter::FOLLOW, "cpr"); // c=heading(course), p=pitch, r=roll
-    else if (
-      startsWith(line, "3d name") ||
-      startsWith(line, "3d offsetalt") ||
-      startsWith(line, "3d offsetcourse") ||
-      startsWith(line, "3d offsetpitch") ||
-      startsWith(line, "3d offsetroll") ||
-      startsWith(line, "3d follow"))
+    }
+    else
+      printError_(filename, lineNumber, "semiminoraxis command requires 1 argument");
+  }
+  else if (tokens[0] == "scale")
+  {
+    if (tokens.size() >= 4)
     {
-      if (tokens.size() >= 3)
-      {
-        const std::string tag = tokens[0] + " " + tokens[1];
-        const std::string restOfLine = line.substr(tag.length() + 1);
-
-        if (tokens[1] == "name")
-          current.set(ShapeParameter::NAME, restOfLine);
-        else if (tokens[1] == "offsetalt")
-          current.set(ShapeParameter::OFFSETALT, restOfLine);
-        else if (tokens[1] == "offsetcourse") // original terminology was mistaken, they used course when they meant heading/yaw
-          current.set(ShapeParameter::OFFSETYAW, restOfLine);
-        else if (tokens[1] == "offsetpitch")
-          current.set(ShapeParameter::OFFSETPITCH, restOfLine);
-        else if (tokens[1] == "offsetroll")
-          current.set(ShapeParameter::OFFSETROLL, restOfLine);
-        else if (tokens[1] == "follow")
-          current.set(ShapeParameter::FOLLOW, restOfLine);
-      }
-      else
-        printError_(filename, lineNumber, "3d command requires at least 2 arguments: " + line);
+      current.set(ShapeParameter::SCALEX, tokens[1]);
+      current.set(ShapeParameter::SCALEY, tokens[2]);
+      current.set(ShapeParameter::SCALEZ, tokens[3]);
     }
-    else if (startsWith(line, "extrude"))
+    else
+      printError_(filename, lineNumber, "scale command requires 3 arguments");
+  }
+  else if (tokens[0] == "orient")
+  {
+    if (tokens.size() >= 2)
     {
-      if (tokens.size() >= 2)
+      current.set(ShapeParameter::OFFSETYAW, tokens[1]);
+      if (tokens.size() >= 3)
       {
-        // extrusion is an altitude mode
-        if (ParsedShape::getBoolFromString(tokens[1]))
-          current.set(ShapeParameter::ALTITUDEMODE, "extrude");
-        if (tokens.size() >= 3)
+        current.set(ShapeParameter::OFFSETPITCH, tokens[2]);
+        if (tokens.size() >= 4)
         {
-          // handle optional extrude height
-          current.set(ShapeParameter::EXTRUDE_HEIGHT, tokens[2]);
+          current.set(ShapeParameter::OFFSETROLL, tokens[3]);
+          current.set(ShapeParameter::FOLLOW, "cpr"); // c=heading(course), p=pitch, r=roll
         }
+        else
+          current.set(ShapeParameter::FOLLOW, "cp"); // c=heading(course), p=pitch, r=roll
       }
       else
-        printError_(filename, lineNumber, "extrude command requires at least 1 argument");
-    }
-    else if (tokens[0] == "height")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::HEIGHT, tokens[1]);
-      else
-        printError_(filename, lineNumber, "height command requires 1 argument");
-    }
-    else if (tokens[0] == "tessellate")
-      current.set(ShapeParameter::TESSELLATE, tokens[1]);
-    else if (tokens[0] == "lineprojection")
-      current.set(ShapeParameter::LINEPROJECTION, tokens[1]);
-    else if (tokens[0] == "linestyle")
-      current.set(ShapeParameter::LINESTYLE, tokens[1]);
-    else if (tokens[0] == "depthbuffer")
-      current.set(ShapeParameter::DEPTHBUFFER, tokens[1]);
-    else if (tokens[0] == "fontname")
-    {
-      state.fontName_ = tokens[1];
-      current.set(ShapeParameter::FONTNAME, tokens[1]);
-    }
-    else if (tokens[0] == "fontsize")
-    {
-      state.textSize_ = tokens[1];
-      current.set(ShapeParameter::TEXTSIZE, tokens[1]);
-    }
-    else if (tokens[0] == "starttime")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::TIME_START, tokens[1]);
+        current.set(ShapeParameter::FOLLOW, "c");
     }
-    else if (tokens[0] == "endtime")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::TIME_END, tokens[1]);
-    }
-    // 3d billboard is OBE, since all annotations are always billboarded
-    else if (startsWith(line, "3d billboard"))
-      continue;
-    else if (tokens[0] == "imagefile")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::IMAGE, tokens[1]);
-    }
-    else if (tokens[0] == "opacity")
-    {
-      if (tokens.size() >= 2)
-        current.set(ShapeParameter::OPACITY, tokens[1]);
+    else
+      printError_(filename, lineNumber, "orient command requires at least 1 argument");
+  }
+  else if (startsWith(line, "rotate"))
+    current.set(ShapeParameter::FOLLOW, "cpr"); // c=heading(course), p=pitch, r=roll
+  else if (
+    startsWith(line, "3d name") ||
+    startsWith(line, "3d offsetalt") ||
+    startsWith(line, "3d offsetcourse") ||
+    startsWith(line, "3d offsetpitch") ||
+    startsWith(line, "3d offsetroll") ||
+    startsWith(line, "3d follow"))
+  {
+    if (tokens.size() >= 3)
+    {
+      const std::string tag = tokens[0] + " " + tokens[1];
+      const std::string restOfLine = line.substr(tag.length() + 1);
+
+      if (tokens[1] == "name")
+        current.set(ShapeParameter::NAME, restOfLine);
+      else if (tokens[1] == "offsetalt")
+        current.set(ShapeParameter::OFFSETALT, restOfLine);
+      else if (tokens[1] == "offsetcourse") // original terminology was mistaken, they used course when they meant heading/yaw
+        current.set(ShapeParameter::OFFSETYAW, restOfLine);
+      else if (tokens[1] == "offsetpitch")
+        current.set(ShapeParameter::OFFSETPITCH, restOfLine);
+      else if (tokens[1] == "offsetroll")
+        current.set(ShapeParameter::OFFSETROLL, restOfLine);
+      else if (tokens[1] == "follow")
+        current.set(ShapeParameter::FOLLOW, restOfLine);
     }
-    else // treat everything as a name/value pair
+    else
+      printError_(filename, lineNumber, "3d command requires at least 2 arguments: " + line);
+  }
+  else if (startsWith(line, "extrude"))
+  {
+    if (tokens.size() >= 2)
     {
-      if (!tokens.empty())
+      // extrusion is an altitude mode
+      if (ParsedShape::getBoolFromString(tokens[1]))
+        current.set(ShapeParameter::ALTITUDEMODE, "extrude");
+      if (tokens.size() >= 3)
       {
-        // filter out items that are explicitly unhandled
-        if (unhandledKeywords_.find(tokens[0]) == unhandledKeywords_.end())
-          printError_(filename, lineNumber, "Found unknown GOG command " + line);
+        // handle optional extrude height
+        current.set(ShapeParameter::EXTRUDE_HEIGHT, tokens[2]);
       }
     }
+    else
+      printError_(filename, lineNumber, "extrude command requires at least 1 argument");
+  }
+  else if (tokens[0] == "height")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::HEIGHT, tokens[1]);
+    else
+      printError_(filename, lineNumber, "height command requires 1 argument");
+  }
+  else if (tokens[0] == "tessellate")
+    current.set(ShapeParameter::TESSELLATE, tokens[1]);
+  else if (tokens[0] == "lineprojection")
+    current.set(ShapeParameter::LINEPROJECTION, tokens[1]);
+  else if (tokens[0] == "linestyle")
+    current.set(ShapeParameter::LINESTYLE, tokens[1]);
+  else if (tokens[0] == "depthbuffer")
+    current.set(ShapeParameter::DEPTHBUFFER, tokens[1]);
+  else if (tokens[0] == "fontname")
+  {
+    state.fontName_ = tokens[1];
+    current.set(ShapeParameter::FONTNAME, tokens[1]);
+  }
+  else if (tokens[0] == "fontsize")
+  {
+    state.textSize_ = tokens[1];
+    current.set(ShapeParameter::TEXTSIZE, tokens[1]);
+  }
+  else if (tokens[0] == "starttime")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::TIME_START, tokens[1]);
+  }
+  else if (tokens[0] == "endtime")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::TIME_END, tokens[1]);
+  }
+  // 3d billboard is OBE, since all annotations are always billboarded
+  else if (startsWith(line, "3d billboard"))
+    return;
+  else if (tokens[0] == "imagefile")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::IMAGE, tokens[1]);
+  }
+  else if (tokens[0] == "opacity")
+  {
+    if (tokens.size() >= 2)
+      current.set(ShapeParameter::OPACITY, tokens[1]);
+  }
+  else // treat everything as a name/value pair
+  {
+    if (!tokens.empty())
+    {
+      // filter out items that are explicitly unhandled
+      if (unhandledKeywords_.find(tokens[0]) == unhandledKeywords_.end())
+        printError_(filename, lineNumber, "Found unknown GOG command " + line);
+    }
   }
 }
 
@@ -1684,8 +1954,29 @@ int Parser::getPosition_(const PositionStrings & pos, bool relative, const Units
 
 void Parser::printError_(const std::string& filename, size_t lineNumber, const std::string& errorText) const
 {
+  if (messages_)
+  {
+    std::ostringstream os;
+    os << "GOG: " << errorText << ", " << (!filename.empty() ? filename + " " : "") <<  "line: " << lineNumber;
+    const Message message = { simNotify::NOTIFY_ERROR, os.str(), true };
+    messages_->push_back(message);
+    return;
+  }
   SIM_ERROR << "GOG: " << errorText << ", " << (!filename.empty() ? filename + " " : "") <<  "line: " << lineNumber << std::endl;
 }
 
+void Parser::printMultipleShapesWarning_(const std::string& filename, size_t lineNumber) const
+{
+  if (messages_)
+  {
+    std::ostringstream os;
+    os << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
+    const Message message = { simNotify::NOTIFY_WARN, os.str(), false };
+    messages_->push_back(message);
+    return;
+  }
+  SIM_WARN << "Multiple shape keywords found in single start/end block, " << filename << " line: " << lineNumber << "\n";
+}
+
 
 } }
@@ -27,6 +27,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "simCore/Common/Common.h"
 #include "simCore/GOG/GogShape.h"
@@ -87,7 +88,35 @@ public:
    */
   void parse(std::istream& input, const std::string& filename, std::vector<GogShapePtr>& output) const;
 
+  /**
+   * Parses GOG data that is already in memory, such as a simCore::MappedFile, into a vector of
+   * GogShapes.  Lines are tokenized in place, without copying the buffer.
+   * @param data Start of the GOG data; does not need to be null terminated
+   * @param size Size of the GOG data in bytes
+   * @param filename identifies the source GOG file or shape group
+   * @param output Vector that will contain a GogShape object for each shape in the data.
+   */
+  void parse(const char* data, size_t size, const std::string& filename, std::vector<GogShapePtr>& output) const;
+
+  /**
+   * Sets the number of threads used by parse().  When not 1, parse() splits the data into chunks at
+   * start commands and parses the chunks in parallel; a stream is first read into memory.  Shapes and
+   * error messages are reported in the same order, with the same text, as a single threaded parse.
+   * @param numThreads Number of threads to use, including the calling thread; 0 uses the number of hardware threads
+   */
+  void setNumThreads(unsigned int numThreads);
+  /** Returns the number of threads used by parse(); default is 1 */
+  unsigned int numThreads() const;
+
 private:
+  struct ParseState;
+  struct Message;
+  struct LineBuffers;
+
+  /// Parses the in-memory data in chunks on multiple threads
+  void parseParallel_(std::string_view data, const std::string& filename, std::vector<GogShapePtr>& output) const;
+  /// Processes one stripped line of input, adding any completed shapes to output; buffers are reused from line to line
+  void parseLine_(std::string_view input, LineBuffers& buffers, size_t lineNumber, const std::string& filename, ParseState& parseState, std::vector<GogShapePtr>& output) const;
   /// Get a GogShape for the specified parsed shape, returns an empty ptr if could not convert
   GogShapePtr getShape_(const ParsedShape& parsed) const;
   /// Parses the optional field for an OutlinedShape
@@ -121,11 +150,15 @@ private:
 
   /// Prints any GOG parsing error to simNotify
   void printError_(const std::string& filename, size_t lineNumber, const std::string& errorText) const;
+  /// Prints a warning for a start/end block with more than one shape keyword to simNotify
+  void printMultipleShapesWarning_(const std::string& filename, size_t lineNumber) const;
 
 private:
   const simCore::UnitsRegistry* units_; ///< registry for unit conversions
   std::map<std::string, std::string> colors_; ///< maps GOG color keywords to GOG hex string format (0xAABBGGRR), e.g. "white", "color1"
   std::set<std::string> unhandledKeywords_;  ///< set of keywords not handled explicitly by the parser
+  unsigned int numThreads_; ///< number of threads used by parse()
+  std::vector<Message>* messages_; ///< when set, notifications are recorded here instead of being sent to simNotify
 };
 
 } } // namespace simCore::GOG
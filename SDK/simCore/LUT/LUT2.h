@@ -28,6 +28,7 @@
 #include <utility>
 #include <algorithm>
 
+#include "simCore/Calc/Interpolation.h"
 #include "LUT1.h"
 
 namespace simCore
@@ -119,6 +120,19 @@ namespace simCore
 
         return array_[xIndex][yIndex];
       }
+      /**
+      * Retrieves all values at an X index
+      * @param[in ] xIndex X location of the values
+      * @return Const reference to the numY() values at the X index, ordered by Y index
+      * @throw std::out_of_range
+      */
+      const std::vector<Value>& row(size_t xIndex) const
+      {
+        if (xIndex >= numX_)
+          throw std::out_of_range("simCore::LUT::LUT2::row(size_t xIndex) const");
+
+        return array_[xIndex];
+      }
 
     private:
       double minX_;               /**< minimum X value of the LUT */
@@ -190,6 +204,52 @@ namespace simCore
         minX, exactX, minX + stepX, minY, exactY, minY + stepY);
     }
 
+    /**
+    * Performs bilinear interpolation of the LUT for arrays of values.  Gives the same results as
+    * calling interpolate() with simCore::bilinearInterpolate() for each pair of values, but skips
+    * the bounds checks on each table access.  Values outside the table limits are clamped to the
+    * nearest cell instead of throwing.
+    * @param[in ] lut2 Lookup table to interpolate
+    * @param[in ] count Number of values to interpolate
+    * @param[in ] exactX X values, count values
+    * @param[in ] exactY Y values, count values
+    * @param[out] values Interpolated values, count values
+    * @throw std::out_of_range if the table has fewer than two values in either dimension
+    */
+    template <class Value>
+    inline void interpolateBilinear(const LUT2<Value> &lut2, size_t count, const double* exactX, const double* exactY, Value* values)
+    {
+      const size_t numX = lut2.numX();
+      const size_t numY = lut2.numY();
+      if (numX < 2 || numY < 2)
+        throw std::out_of_range("simCore::LUT::interpolateBilinear");
+
+      // Resolve the rows once, so that each lookup is a pair of pointer offsets
+      std::vector<const Value*> rows(numX);
+      for (size_t i = 0; i < numX; ++i)
+        rows[i] = &lut2.row(i)[0];
+
+      const double minX = lut2.minX();
+      const double minY = lut2.minY();
+      const double stepX = lut2.stepX();
+      const double stepY = lut2.stepY();
+      const size_t lastX = numX - 2;
+      const size_t lastY = numY - 2;
+      for (size_t k = 0; k < count; ++k)
+      {
+        const double indexX = index(minX, stepX, exactX[k]);
+        const double indexY = index(minY, stepY, exactY[k]);
+        const size_t lowx = (indexX > 0) ? static_cast<size_t>(std::min(indexX, static_cast<double>(lastX))) : 0;
+        const size_t lowy = (indexY > 0) ? static_cast<size_t>(std::min(indexY, static_cast<double>(lastY))) : 0;
+        const double lowX = minX + stepX * lowx;
+        const double lowY = minY + stepY * lowy;
+        const Value* row0 = rows[lowx];
+        const Value* row1 = rows[lowx + 1];
+        values[k] = simCore::bilinearInterpolate(row0[lowy], row1[lowy], row1[lowy + 1], row0[lowy + 1],
+          simCore::getFactor(lowX, exactX[k], lowX + stepX), simCore::getFactor(lowY, exactY[k], lowY + stepY));
+      }
+    }
+
     /**
     * Writes the LUT to an output stream
     * @param[in ] out Output stream
@@ -1,3 +1,4 @@
 include(CMakeFindDependencyMacro)
 find_dependency(simNotify)
+find_dependency(Threads)
 include("${CMAKE_CURRENT_LIST_DIR}/simCoreTargets.cmake")
@@ -80,8 +80,8 @@ void BeamMemoryCommandSlice::update(DataStore *ds, ObjectId id, double time)
     prefs->clear_targetid();
     prefs->mutable_commonprefs()->set_datadraw(false);
 
-    // advance time forward, execute all commands from 0.0 (use -1.0 since we need a time before 0.0) to new current time
-    advance_(-1.0, time);
+    // advance time forward, execute all commands from the nearest snapshot to new current time
+    replay_(time);
     conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
 
     hasChanged_ = true;
@@ -194,6 +194,14 @@ public:
   virtual void allInts(std::map<int, int> &nameValueIntMap) const = 0;
   ///@}
 
+  /**
+   * Current value for each category name, indexed by CategoryNameManager::nameIndex().  Categories without
+   * data at the last update time, and names beyond the end of the vector, hold NO_CATEGORY_VALUE_AT_TIME.
+   * Equivalent to allInts(), without building a map.
+   * @return current values, or nullptr if the implementation does not support a flat representation
+   */
+  virtual const std::vector<int>* currentValues() const { return nullptr; }
+
 protected:
   /// used by the iterator implementation
   virtual std::unique_ptr<IteratorImpl> iterator_() const = 0;
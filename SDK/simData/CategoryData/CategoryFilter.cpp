@@ -40,6 +40,54 @@ static const std::string SIM_PREF_RULE_REGEXP_SEP = "^";
 
 //---------------------------------------------------------
 
+namespace {
+
+/** Value lookup for CategoryFilter::match_() on a map of name int to value int */
+class MapValueLookup
+{
+public:
+  explicit MapValueLookup(const CategoryFilter::CurrentCategoryValues& values)
+    : values_(values)
+  {
+  }
+
+  int operator()(int nameInt) const
+  {
+    CategoryFilter::CurrentCategoryValues::const_iterator i = values_.find(nameInt);
+    return (i == values_.end()) ? CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME : i->second;
+  }
+
+private:
+  const CategoryFilter::CurrentCategoryValues& values_;
+};
+
+/** Value lookup for CategoryFilter::match_() on an array indexed by dense category name index */
+class FlatValueLookup
+{
+public:
+  FlatValueLookup(const std::vector<int>& values, const CategoryNameManager& nameManager)
+    : values_(values),
+      nameManager_(nameManager)
+  {
+  }
+
+  int operator()(int nameInt) const
+  {
+    const int index = nameManager_.nameIndex(nameInt);
+    if (index < 0 || static_cast<size_t>(index) >= values_.size())
+      return CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME;
+    return values_[index];
+  }
+
+private:
+  const std::vector<int>& values_;
+  const CategoryNameManager& nameManager_;
+};
+
+}
+
+//---------------------------------------------------------
+
 /// Monitors for category data changes
 class CategoryFilter::CategoryFilterListener : public simData::CategoryNameManager::Listener
 {
@@ -387,17 +435,33 @@ void CategoryFilter::setCategoryRegExp(int nameInt, const simData::RegExpFilterP
 
 bool CategoryFilter::match(const simData::DataStore& dataStore, uint64_t entityId) const
 {
+  // Prefer the flat representation, which avoids building a map per entity
+  const simData::CategoryDataSlice* slice = dataStore.categoryDataSlice(entityId);
+  const std::vector<int>* currentValues = (slice ? slice->currentValues() : nullptr);
+  if (currentValues)
+    return matchValues(*currentValues, dataStore.categoryNameManager());
+
   CurrentCategoryValues curCategoryData;
   CategoryFilter::getCurrentCategoryValues(dataStore, entityId, curCategoryData);
   return matchData(curCategoryData);
 }
 
 bool CategoryFilter::matchData(const CurrentCategoryValues& curCategoryData) const
+{
+  return match_(MapValueLookup(curCategoryData));
+}
+
+bool CategoryFilter::matchValues(const std::vector<int>& currentValues, const CategoryNameManager& nameManager) const
+{
+  return match_(FlatValueLookup(currentValues, nameManager));
+}
+
+template <typename ValueLookup>
+bool CategoryFilter::match_(const ValueLookup& lookup) const
 {
   if (categoryCheck_.empty() && categoryRegExp_.empty())
     return true;
 
-  CurrentCategoryValues::const_iterator curCategoryDataIter;
   CategoryCheck::const_iterator checksIter;
   ValuesCheck::const_iterator currentChecksValuesIter;
   int valueAtGivenTime;
@@ -424,11 +488,11 @@ bool CategoryFilter::matchData(const CurrentCategoryValues& curCategoryData) con
     // grab the pointer for ease of use
     const ValuesCheck* currentChecksValues = &(catValues.second);
 
-    // checks if the curCategoryData has category data (name) for the current category
-    curCategoryDataIter = curCategoryData.find(checksIter->first);
-    if (curCategoryDataIter == curCategoryData.end())
+    // checks if the current category data has a value for the current category
+    valueAtGivenTime = lookup(checksIter->first);
+    if (valueAtGivenTime == simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME)
     {
-      // curCategoryData has no category data for the current check category
+      // current category data has no value for the current check category
 
       // checks if there is a NoValue item in currentChecksValues
       currentChecksValuesIter = currentChecksValues->find(simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
@@ -453,9 +517,7 @@ bool CategoryFilter::matchData(const CurrentCategoryValues& curCategoryData) con
     }
     else
     {
-      // curCategoryData has category data for the current check category
-      valueAtGivenTime = curCategoryDataIter->second;
-
+      // current category data has a value for the current check category
       // checks for a check value that corresponds to the valueAtGivenTime
       currentChecksValuesIter = currentChecksValues->find(valueAtGivenTime);
       if (currentChecksValuesIter == currentChecksValues->end())
@@ -488,18 +550,18 @@ bool CategoryFilter::matchData(const CurrentCategoryValues& curCategoryData) con
   }
 
   // finally check against the RegExpFilters. Only fail if there is a regular expression and no match
-  if (!matchRegExpFilter_(curCategoryData))
+  if (!matchRegExpFilter_(lookup))
     return false;
 
   return true;
 }
 
-bool CategoryFilter::matchRegExpFilter_(const CurrentCategoryValues& curCategoryData) const
+template <typename ValueLookup>
+bool CategoryFilter::matchRegExpFilter_(const ValueLookup& lookup) const
 {
   // no failure if no regular expressions
   if (categoryRegExp_.empty() || dataStore_ == nullptr)
     return true;
-  CurrentCategoryValues::const_iterator curCategoryDataIter;
   // first, check the reg exp, since this is likely to be more comprehensive
   simData::CategoryNameManager& catNameMgr = dataStore_->categoryNameManager();
   for (CategoryRegExp::const_iterator iter = categoryRegExp_.begin(); iter != categoryRegExp_.end(); ++iter)
@@ -508,11 +570,11 @@ bool CategoryFilter::matchRegExpFilter_(const CurrentCategoryValues& curCategory
     if (iter->second->pattern().empty())
       continue;
 
-    curCategoryDataIter = curCategoryData.find(iter->first);
-    if (curCategoryDataIter != curCategoryData.end())
+    const int valueInt = lookup(iter->first);
+    if (valueInt != simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME)
     {
       // convert value int to string for regular expression matching
-      std::string valueString = catNameMgr.valueIntToString(curCategoryDataIter->second);
+      std::string valueString = catNameMgr.valueIntToString(valueInt);
       // if the string doesn't match the regexp, then we fail
       if (!iter->second->match(valueString))
         return false;
@@ -68,6 +68,7 @@ public:
 };
 
 class DataStore;
+class CategoryNameManager;
 
 /**
  * Class to manage the category data filtering.  The CategoryFilter builds an internal map
@@ -264,6 +265,15 @@ public:
   */
   bool matchData(const CurrentCategoryValues& curCategoryData) const;
 
+  /**
+  * Check if the flat category data values passed in match the current category filter.  Same result as matchData(),
+  * but reads the values directly from the contiguous array provided by CategoryDataSlice::currentValues().
+  * @param[in] currentValues  current value per category, indexed by CategoryNameManager::nameIndex()
+  * @param[in] nameManager  category name manager that assigned the indices in currentValues
+  * @return true if the specified category data passes the filter, false otherwise
+  */
+  bool matchValues(const std::vector<int>& currentValues, const CategoryNameManager& nameManager) const;
+
   /**
   * Serialize the category filter into a SIMDIS 9 compatible string
   * @param simplify if true, return " " if all category values are checked
@@ -329,8 +339,12 @@ private:
   * @param[in] unlisted  default unlisted check state
   */
   void buildCategoryFilter_(bool addNoValue, bool noValue, bool addUnlisted, bool unlisted);
+  /** Implementation of matchData() and matchValues(); lookup returns the value for a name int, or NO_CATEGORY_VALUE_AT_TIME */
+  template <typename ValueLookup>
+  bool match_(const ValueLookup& lookup) const;
   /** Returns true if all RegExpFilters match. Returns false if anything fails to match */
-  bool matchRegExpFilter_(const CurrentCategoryValues& curCategoryData) const;
+  template <typename ValueLookup>
+  bool matchRegExpFilter_(const ValueLookup& lookup) const;
   /** Removes invalid or empty regular expressions. */
   void simplifyRegExp_(CategoryRegExp& regExps) const;
   /** Reduces the categoryCheck_ to the smallest state possible. */
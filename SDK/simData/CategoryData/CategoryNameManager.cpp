@@ -40,7 +40,8 @@ const int CategoryNameManager::UNLISTED_CATEGORY_VALUE = -3;
 //----------------------------------------------------------------------------
 CategoryNameManager::CategoryNameManager()
   : caseSensitive_(true),
-    nextInt_(1)
+    nextInt_(1),
+    numCategoryNames_(0)
 {
 }
 
@@ -58,6 +59,8 @@ void CategoryNameManager::clear()
   map_.clear();
   reverseMap_.clear();
   categoryStringInts_.clear();
+  nameIndices_.clear();
+  numCategoryNames_ = 0;
   for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
   {
     (*i)->onClear();
@@ -107,6 +110,12 @@ int CategoryNameManager::addCategoryName(const std::string &name)
     // add the key "catInt" to the map
     categoryStringInts_[catInt];
 
+    // assign a dense index, unless the category was removed and is coming back
+    if (static_cast<size_t>(catInt) >= nameIndices_.size())
+      nameIndices_.resize(catInt + 1, NO_CATEGORY_NAME);
+    if (nameIndices_[catInt] == NO_CATEGORY_NAME)
+      nameIndices_[catInt] = static_cast<int>(numCategoryNames_++);
+
     for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
     {
       (*i)->onAddCategory(catInt);
@@ -170,6 +179,11 @@ void CategoryNameManager::removeValue(int nameInt, int valueInt)
   }
 }
 
+size_t CategoryNameManager::numCategoryNames() const
+{
+  return numCategoryNames_;
+}
+
 // provide one mapping: string to int
 int CategoryNameManager::nameToInt(const std::string &name) const
 {
@@ -100,6 +100,21 @@ public:
   /// provide one category value mapping: int to string
   std::string valueIntToString(int valueInt) const;
 
+  /**
+   * Dense index for a category name, assigned in the order names are first added; suitable for indexing
+   * contiguous per-entity arrays of current values.  Indices are stable until clear().
+   * @param nameInt Category name key
+   * @return index in [0, numCategoryNames()), or NO_CATEGORY_NAME if nameInt is not a category name
+   */
+  int nameIndex(int nameInt) const
+  {
+    if (nameInt < 0 || static_cast<size_t>(nameInt) >= nameIndices_.size())
+      return NO_CATEGORY_NAME;
+    return nameIndices_[nameInt];
+  }
+  /// Number of category names that have been assigned a dense index; one past the largest nameIndex()
+  size_t numCategoryNames() const;
+
   /// retrieve all the category name strings
   void allCategoryNames(std::vector<std::string> &nameVec) const;
   /// retrieve all the category name keys
@@ -147,6 +162,11 @@ private:
   std::map<std::string, int> map_;
   std::map<int, std::string> reverseMap_;
 
+  /// dense name index, indexed by category name key; NO_CATEGORY_NAME for keys that are not names
+  std::vector<int> nameIndices_;
+  /// number of dense name indices assigned
+  size_t numCategoryNames_;
+
   std::vector<ListenerPtr> listeners_;
 };
 }
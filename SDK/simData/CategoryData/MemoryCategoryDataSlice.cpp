@@ -563,7 +563,8 @@ private: // data
 MemoryCategoryDataSlice::MemoryCategoryDataSlice(double timeStamp)
   : lastUpdateTime_(timeStamp),
   categoryNameManager_(nullptr),
-  sliceSize_(0)
+  sliceSize_(0),
+  currentValuesDirty_(true)
 {
 }
 
@@ -583,6 +584,12 @@ bool MemoryCategoryDataSlice::update(double time)
   // do not exit early - all category data must be updated for time before returning
   bool ret = false; // we will return true if anything has changed
 
+  // current values are only written for categories whose value changed; edits since the last
+  // update may have changed any category, so rebuild them all in that case
+  const bool rebuild = currentValuesDirty_ && (categoryNameManager_ != nullptr);
+  if (rebuild)
+    currentValues_.assign(categoryNameManager_->numCategoryNames(), CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
+
   //for each category
   for (EntityData::iterator i = data_.begin(); i != data_.end(); ++i)
   {
@@ -595,16 +602,22 @@ bool MemoryCategoryDataSlice::update(double time)
       {
         timeState.lastUpdateTime = NO_CATEGORY_DATA;
         ret = true; // Went from category data to no category data so something has changed
+        if (!rebuild)
+          setCurrentValue_(i->first, CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
       }
       continue;
     }
 
     --j;
 
+    bool valueChanged = false;
     if (!simCore::areEqual(j->time, timeState.lastUpdateTime))
     {
       if (timeState.lastUpdateTime == NO_CATEGORY_DATA)
+      {
         ret = true;  // Went from no category data to category data so something changed
+        valueChanged = true;
+      }
 
       timeState.lastUpdateTime = j->time;
     }
@@ -614,10 +627,14 @@ bool MemoryCategoryDataSlice::update(double time)
     {
       timeState.lastValue = j->value;
       ret = true; // something has changed
+      valueChanged = true;
     }
+    if (rebuild || valueChanged)
+      setCurrentValue_(i->first, j->value);
   }
 
   lastUpdateTime_ = time;
+  currentValuesDirty_ = (categoryNameManager_ == nullptr);
   return ret;
 }
 
@@ -664,6 +681,7 @@ bool MemoryCategoryDataSlice::removePoint(double time, int catNameInt, int value
 
   // successful match, remove it
   timeState.data.erase(j);
+  currentValuesDirty_ = true;
   // Assertion failure means we're about to overflow; our count is out of sync
   assert(sliceSize_ > 0);
   sliceSize_--;
@@ -678,6 +696,7 @@ void MemoryCategoryDataSlice::insertOneEntry_(double time, const CategoryData::E
 
   data_[catInt].data.insert(time, valInt);
   sliceSize_++;
+  currentValuesDirty_ = true;
 }
 
 void MemoryCategoryDataSlice::insert(CategoryData *data)
@@ -697,6 +716,7 @@ void MemoryCategoryDataSlice::limitByPoints_(uint32_t limitPoints)
     return;
 
   sliceSize_ = 0;
+  currentValuesDirty_ = true;
   for (EntityData::iterator i = data_.begin(); i != data_.end(); ++i)
   {
     i->second.data.limitByPoints(limitPoints);
@@ -710,6 +730,7 @@ void MemoryCategoryDataSlice::limitByTime_(double timeLimit)
     return; // nothing to do
 
   sliceSize_ = 0;
+  currentValuesDirty_ = true;
   for (EntityData::iterator i = data_.begin(); i != data_.end(); ++i)
   {
     i->second.data.limitByTime(timeLimit);
@@ -733,6 +754,7 @@ void MemoryCategoryDataSlice::flush()
 void MemoryCategoryDataSlice::completeFlush()
 {
   sliceSize_ = 0;
+  currentValuesDirty_ = true;
   for (EntityData::iterator i = data_.begin(); i != data_.end(); ++i)
     i->second.data.completeFlush();
 }
@@ -740,6 +762,7 @@ void MemoryCategoryDataSlice::completeFlush()
 void MemoryCategoryDataSlice::flush(double startTime, double endTime)
 {
   sliceSize_ = 0;
+  currentValuesDirty_ = true;
   for (EntityData::iterator i = data_.begin(); i != data_.end(); ++i)
   {
     i->second.data.flush(startTime, endTime);
@@ -860,10 +883,48 @@ void MemoryCategoryDataSlice::allInts(std::map<int, int> &nameValueIntMap) const
   }
 }
 
+const std::vector<int>* MemoryCategoryDataSlice::currentValues() const
+{
+  if (categoryNameManager_ == nullptr)
+    return nullptr;
+  // Names added since the last rebuild are covered by the "beyond the end" rule, so only edits force a rebuild
+  if (!currentValuesDirty_)
+    return &currentValues_;
+
+  // much like allInts()
+  currentValues_.assign(categoryNameManager_->numCategoryNames(), CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
+  for (EntityData::const_iterator i = data_.begin(); i != data_.end(); ++i)
+  {
+    // look for value beyond current time
+    TimeValueIterator j = i->second.data.upper_bound(lastUpdateTime_);
+    if (j == i->second.data.begin())
+      continue;
+
+    --j;
+
+    setCurrentValue_(i->first, j->value);
+  }
+  currentValuesDirty_ = false;
+  return &currentValues_;
+}
+
+void MemoryCategoryDataSlice::setCurrentValue_(int catNameInt, int valueInt) const
+{
+  if (categoryNameManager_ == nullptr)
+    return;
+  const int index = categoryNameManager_->nameIndex(catNameInt);
+  if (index < 0)
+    return;
+  if (static_cast<size_t>(index) >= currentValues_.size())
+    currentValues_.resize(index + 1, CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
+  currentValues_[index] = valueInt;
+}
+
 void MemoryCategoryDataSlice::setCategoryNameManager(CategoryNameManager* categoryNameManager)
 {
   assert(categoryNameManager);
   categoryNameManager_ = categoryNameManager;
+  currentValuesDirty_ = true;
 }
 
 size_t MemoryCategoryDataSlice::numItems() const
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <map>
 #include <deque>
+#include <vector>
 #include "simCore/Common/Common.h"
 #include "simData/DataTypes.h"
 #include "simData/CategoryData/CategoryData.h"
@@ -91,6 +92,9 @@ public:
 
   ///@}
 
+  /// Current values indexed by the category name manager's dense name index; rebuilt on demand after edits
+  virtual const std::vector<int>* currentValues() const;
+
   /// remove all data in the slice, retaining current category data and the static point
   void flush();
 
@@ -207,6 +211,9 @@ private: // methods
    */
   void limitByTime_(double timeLimit);
 
+  /** Stores the value for the category in currentValues_, growing it to cover the category's dense index */
+  void setCurrentValue_(int catNameInt, int valueInt) const;
+
   //--- from CategoryDataSlice
   virtual std::unique_ptr<IteratorImpl> iterator_() const;
 
@@ -215,6 +222,10 @@ private: // data
   double lastUpdateTime_;
   CategoryNameManager* categoryNameManager_;
   size_t sliceSize_;
+  /// current value per dense category name index; kept in sync by update()
+  mutable std::vector<int> currentValues_;
+  /// true when data changed after the last update(), so currentValues_ may be out of date
+  mutable bool currentValuesDirty_;
 };
 
 } // namespace
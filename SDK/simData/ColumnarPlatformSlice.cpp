@@ -0,0 +1,679 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include "simCore/Calc/Math.h"
+#include "simData/ColumnarPlatformSlice.h"
+#include "simData/DataSliceUpdaters.h"
+
+namespace simData
+{
+
+namespace
+{
+/// Number of values removed from the front of the columns before they are compacted
+const size_t COMPACT_THRESHOLD = 1024;
+
+template <typename T>
+void eraseColumn(std::vector<T>& column, size_t begin, size_t end)
+{
+  column.erase(column.begin() + begin, column.begin() + end);
+}
+
+template <typename T>
+void insertColumn(std::vector<T>& column, size_t index, T value)
+{
+  column.insert(column.begin() + index, value);
+}
+}
+
+//----------------------------------------------------------------------------
+/**
+ * Iterator over the columns of a ColumnarPlatformSlice.  Updates are materialized into
+ * storage owned by the iterator, alternating between two slots so that the two most
+ * recently returned pointers remain valid.
+ */
+class ColumnarPlatformSlice::ColumnIterator : public PlatformUpdateSlice::IteratorImpl
+{
+public:
+  explicit ColumnIterator(const ColumnarPlatformSlice* slice)
+    : slice_(slice),
+      nextIndex_(0),
+      lastSlot_(0)
+  {
+    assert(slice_);
+  }
+
+  virtual const PlatformUpdate* const next()
+  {
+    if (!hasNext())
+      return nullptr;
+    return materialize_(nextIndex_++);
+  }
+
+  virtual const PlatformUpdate* const peekNext() const
+  {
+    if (!hasNext())
+      return nullptr;
+    return materialize_(nextIndex_);
+  }
+
+  virtual const PlatformUpdate* const previous()
+  {
+    if (!hasPrevious())
+      return nullptr;
+    return materialize_(--nextIndex_);
+  }
+
+  virtual const PlatformUpdate* const peekPrevious() const
+  {
+    if (!hasPrevious())
+      return nullptr;
+    return materialize_(nextIndex_ - 1);
+  }
+
+  virtual void toFront()
+  {
+    nextIndex_ = 0;
+  }
+
+  virtual void toBack()
+  {
+    nextIndex_ = slice_->numItems();
+  }
+
+  virtual bool hasNext() const
+  {
+    return nextIndex_ < slice_->numItems();
+  }
+
+  virtual bool hasPrevious() const
+  {
+    return nextIndex_ > 0 && nextIndex_ <= slice_->numItems();
+  }
+
+  virtual PlatformUpdateSlice::IteratorImpl* clone() const
+  {
+    ColumnIterator* rv = new ColumnIterator(slice_);
+    rv->nextIndex_ = nextIndex_;
+    return rv;
+  }
+
+  /** Sets the index of the update returned by next() */
+  void set(size_t index)
+  {
+    nextIndex_ = index;
+  }
+
+private:
+  const PlatformUpdate* materialize_(size_t index) const
+  {
+    lastSlot_ = 1 - lastSlot_;
+    slice_->get(index, &values_[lastSlot_]);
+    return &values_[lastSlot_];
+  }
+
+  const ColumnarPlatformSlice* slice_;
+  size_t nextIndex_;
+  mutable PlatformUpdate values_[2];
+  mutable size_t lastSlot_;
+};
+
+//----------------------------------------------------------------------------
+ColumnarPlatformSlice::ColumnarPlatformSlice()
+  : first_(0),
+    hasChanged_(false),
+    dirty_(false),
+    current_(nullptr),
+    interpolated_(false),
+    fastUpdate_(0)
+{
+}
+
+ColumnarPlatformSlice::~ColumnarPlatformSlice()
+{
+}
+
+bool ColumnarPlatformSlice::hasChanged() const
+{
+  return hasChanged_;
+}
+
+bool ColumnarPlatformSlice::isDirty() const
+{
+  return dirty_;
+}
+
+void ColumnarPlatformSlice::visit(PlatformUpdateSlice::Visitor* visitor) const
+{
+  PlatformUpdate update;
+  const size_t size = numItems();
+  for (size_t k = 0; k < size; ++k)
+  {
+    get(k, &update);
+    (*visitor)(&update);
+  }
+}
+
+void ColumnarPlatformSlice::modify(PlatformUpdateSlice::Modifier* modifier)
+{
+  // Implement when/if needed
+  assert(0);
+}
+
+PlatformUpdateSlice::Iterator ColumnarPlatformSlice::lower_bound(double timeValue) const
+{
+  ColumnIterator* rv = new ColumnIterator(this);
+  rv->set(lowerBound_(timeValue));
+  return PlatformUpdateSlice::Iterator(rv);
+}
+
+PlatformUpdateSlice::Iterator ColumnarPlatformSlice::upper_bound(double timeValue) const
+{
+  ColumnIterator* rv = new ColumnIterator(this);
+  rv->set(upperBound_(timeValue));
+  return PlatformUpdateSlice::Iterator(rv);
+}
+
+size_t ColumnarPlatformSlice::numItems() const
+{
+  return times_.size() - first_;
+}
+
+const PlatformUpdate* ColumnarPlatformSlice::current() const
+{
+  return current_;
+}
+
+bool ColumnarPlatformSlice::isInterpolated() const
+{
+  return interpolated_;
+}
+
+PlatformUpdateSlice::Bounds ColumnarPlatformSlice::interpolationBounds() const
+{
+  if (!interpolated_)
+    return Bounds(static_cast<PlatformUpdate*>(nullptr), static_cast<PlatformUpdate*>(nullptr));
+  return Bounds(&lowBound_, &highBound_);
+}
+
+double ColumnarPlatformSlice::firstTime() const
+{
+  if (numItems() == 0)
+    return std::numeric_limits<double>::max();
+  return times_[first_];
+}
+
+double ColumnarPlatformSlice::lastTime() const
+{
+  if (numItems() == 0)
+    return -std::numeric_limits<double>::max();
+  return times_.back();
+}
+
+double ColumnarPlatformSlice::deltaTime(double time) const
+{
+  if (numItems() == 0 || (time < 0.0))
+    return -1.0;
+
+  size_t index = lowerBound_(time);
+  if (index != numItems())
+  {
+    if (times_[first_ + index] == time)
+      return 0.0;
+
+    if (index == 0)
+      return -1.0;
+  }
+
+  --index;
+
+  // Check for static point
+  if (times_[first_ + index] < 0.0)
+    return -1.0;
+
+  return time - times_[first_ + index];
+}
+
+void ColumnarPlatformSlice::flush(bool keepStatic)
+{
+  dirty_ = true;
+  // don't flush static entities
+  if (keepStatic && numItems() == 1 && times_[first_] == -1.0)
+    return;
+
+  clear_();
+  current_ = nullptr;
+}
+
+void ColumnarPlatformSlice::flush(double startTime, double endTime)
+{
+  dirty_ = true;
+  const size_t start = lowerBound_(startTime);
+  if (start == numItems() || times_[first_ + start] >= endTime)
+    return;
+
+  // endTime is non-inclusive
+  const size_t end = start + (std::lower_bound(times_.begin() + first_ + start, times_.end(), endTime) - (times_.begin() + first_ + start));
+  erase_(start, end);
+  fastUpdate_ = numItems();
+  current_ = nullptr;
+}
+
+void ColumnarPlatformSlice::clearChanged()
+{
+  hasChanged_ = false;
+}
+
+void ColumnarPlatformSlice::update(double time)
+{
+  // start by marking as unchanged, new hasChanged status is outcome of this update
+  clearChanged();
+
+  // early out when there are no changes to this slice
+  if (!dirty_ && (current_ != nullptr) && ((current_->time() == time) || (current_->time() == -1.0)))
+    return;
+
+  dirty_ = false;
+  interpolated_ = false;
+
+  const size_t size = numItems();
+  if (size == 0)
+  {
+    setCurrent_(size);
+    return;
+  }
+
+  // Current update is the last point at or before the time
+  size_t index = lowerBound_(time);
+  if (index == size)
+    index = size - 1;
+  else if (time < times_[first_ + index])
+    index = (index == 0) ? size : index - 1;
+
+  fastUpdate_ = index;
+  setCurrent_(index);
+}
+
+void ColumnarPlatformSlice::update(double time, Interpolator* interpolator)
+{
+  assert(interpolator);
+
+  // start by marking as unchanged, new hasChanged status is outcome of this update
+  clearChanged();
+
+  // early out when there are no changes to this slice
+  if (!dirty_ && (current_ != nullptr) && ((current_->time() == time) || (current_->time() == -1.0)))
+    return;
+
+  dirty_ = false;
+  interpolated_ = false;
+
+  const size_t size = numItems();
+  if (size == 0)
+  {
+    setCurrent_(size);
+    return;
+  }
+
+  const size_t next = upperBound_(time);
+  if (next == size)
+  {
+    // Closest update is the last point
+    fastUpdate_ = size - 1;
+    setCurrent_(size - 1);
+    return;
+  }
+
+  // time is before the first point
+  if (next == 0)
+  {
+    fastUpdate_ = 0;
+    setCurrent_(size);
+    return;
+  }
+
+  fastUpdate_ = next - 1;
+  if (simCore::areEqual(time, times_[first_ + next - 1]))
+  {
+    setCurrent_(next - 1);
+    return;
+  }
+
+  // time is between points
+  get(next - 1, &lowBound_);
+  get(next, &highBound_);
+  interpolator->interpolate(time, lowBound_, highBound_, &currentInterpolated_);
+  current_ = &currentInterpolated_;
+  interpolated_ = true;
+  // a new interpolated update is always a change
+  hasChanged_ = true;
+}
+
+void ColumnarPlatformSlice::insert(const PlatformUpdate& data)
+{
+  const double time = data.time();
+  size_t index = numItems();
+  if (index != 0 && times_.back() >= time)
+  {
+    index = std::lower_bound(times_.begin() + first_, times_.end(), time) - (times_.begin() + first_);
+    if (times_[first_ + index] == time)
+    {
+      // Clear the current update if replacing it; current will become valid upon update
+      if (current_ == &currentValue_ && currentValue_.time() == time)
+      {
+        current_ = nullptr;
+        hasChanged_ = true;
+      }
+      assignAt_(index, data);
+      dirty_ = true;
+      return;
+    }
+  }
+  insertAt_(index, data);
+  fastUpdate_ = numItems();
+  dirty_ = true;
+}
+
+void ColumnarPlatformSlice::limitByTime(double timeWindow)
+{
+  if (timeWindow < 0 || numItems() == 0)
+    return;
+
+  const double timeLimit = lastTime() - timeWindow;
+  if (timeLimit < 0.0)
+    return;
+
+  // get the first point after the limit
+  size_t newFirst = std::upper_bound(times_.begin() + first_, times_.end(), timeLimit) - (times_.begin() + first_);
+  // always leave one point
+  if (newFirst == numItems())
+    --newFirst;
+  if (newFirst == 0)
+    return;
+
+  erase_(0, newFirst);
+  fastUpdate_ = numItems();
+}
+
+void ColumnarPlatformSlice::limitByPoints(uint32_t limitPoints)
+{
+  // zero is special case for "no limit"
+  if (limitPoints == 0 || numItems() <= limitPoints)
+    return;
+
+  erase_(0, numItems() - limitPoints);
+  fastUpdate_ = numItems();
+}
+
+void ColumnarPlatformSlice::limitByPrefs(const CommonPrefs& prefs)
+{
+  limitByPoints(prefs.datalimitpoints());
+  limitByTime(prefs.datalimittime());
+}
+
+int ColumnarPlatformSlice::get(size_t index, PlatformUpdate* update) const
+{
+  if (update == nullptr || index >= numItems())
+    return 1;
+
+  const size_t at = first_ + index;
+  update->set_time(times_[at]);
+  update->set_x(x_[at]);
+  update->set_y(y_[at]);
+  update->set_z(z_[at]);
+  update->set_psi(psi_[at]);
+  update->set_theta(theta_[at]);
+  update->set_phi(phi_[at]);
+  update->set_vx(vx_[at]);
+  update->set_vy(vy_[at]);
+  update->set_vz(vz_[at]);
+  return 0;
+}
+
+const double* ColumnarPlatformSlice::times() const
+{
+  return numItems() == 0 ? nullptr : &times_[first_];
+}
+
+const double* ColumnarPlatformSlice::x() const
+{
+  return numItems() == 0 ? nullptr : &x_[first_];
+}
+
+const double* ColumnarPlatformSlice::y() const
+{
+  return numItems() == 0 ? nullptr : &y_[first_];
+}
+
+const double* ColumnarPlatformSlice::z() const
+{
+  return numItems() == 0 ? nullptr : &z_[first_];
+}
+
+const float* ColumnarPlatformSlice::psi() const
+{
+  return numItems() == 0 ? nullptr : &psi_[first_];
+}
+
+const float* ColumnarPlatformSlice::theta() const
+{
+  return numItems() == 0 ? nullptr : &theta_[first_];
+}
+
+const float* ColumnarPlatformSlice::phi() const
+{
+  return numItems() == 0 ? nullptr : &phi_[first_];
+}
+
+const float* ColumnarPlatformSlice::vx() const
+{
+  return numItems() == 0 ? nullptr : &vx_[first_];
+}
+
+const float* ColumnarPlatformSlice::vy() const
+{
+  return numItems() == 0 ? nullptr : &vy_[first_];
+}
+
+const float* ColumnarPlatformSlice::vz() const
+{
+  return numItems() == 0 ? nullptr : &vz_[first_];
+}
+
+PlatformUpdateSlice::IteratorImpl* ColumnarPlatformSlice::iterator_() const
+{
+  return new ColumnIterator(this);
+}
+
+size_t ColumnarPlatformSlice::lowerBound_(double time) const
+{
+  const size_t size = numItems();
+  const double* t = times();
+  size_t current = fastUpdate_;
+  // Sequential search near the last update; same approach as computeLowerBound()
+  if (current < size)
+  {
+    if (t[current] <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && current != size; ++ii, ++current)
+      {
+        if (t[current] >= time)
+          return current;
+      }
+      if (current == size)
+        return size;
+    }
+    else
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && current != 0; ++ii, --current)
+      {
+        if (t[current] < time)
+          return current + 1;
+      }
+    }
+  }
+  if (size == 0)
+    return 0;
+  return std::lower_bound(t, t + size, time) - t;
+}
+
+size_t ColumnarPlatformSlice::upperBound_(double time) const
+{
+  const size_t size = numItems();
+  const double* t = times();
+  size_t current = fastUpdate_;
+  // Sequential search near the last update; same approach as computeUpperBound()
+  if (current < size)
+  {
+    if (t[current] <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && current != size; ++ii, ++current)
+      {
+        if (t[current] > time)
+          return current;
+      }
+      if (current == size)
+        return size;
+    }
+    else
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && current != 0; ++ii, --current)
+      {
+        if (t[current] <= time)
+          return current + 1;
+      }
+      // avoid the binary search when before/at first time
+      if (current == 0)
+        return (t[0] <= time) ? 1 : 0;
+    }
+  }
+  if (size == 0)
+    return 0;
+  return std::upper_bound(t, t + size, time) - t;
+}
+
+void ColumnarPlatformSlice::setCurrent_(size_t index)
+{
+  if (index >= numItems())
+  {
+    if (current_ != nullptr)
+    {
+      hasChanged_ = true;
+      current_ = nullptr;
+    }
+    return;
+  }
+
+  // Times are unique within the slice, so the same time means the same update
+  if (current_ == &currentValue_ && currentValue_.time() == times_[first_ + index])
+    return;
+
+  get(index, &currentValue_);
+  current_ = &currentValue_;
+  hasChanged_ = true;
+}
+
+void ColumnarPlatformSlice::insertAt_(size_t index, const PlatformUpdate& data)
+{
+  const size_t at = first_ + index;
+  insertColumn(times_, at, data.time());
+  insertColumn(x_, at, data.x());
+  insertColumn(y_, at, data.y());
+  insertColumn(z_, at, data.z());
+  insertColumn(psi_, at, static_cast<float>(data.psi()));
+  insertColumn(theta_, at, static_cast<float>(data.theta()));
+  insertColumn(phi_, at, static_cast<float>(data.phi()));
+  insertColumn(vx_, at, static_cast<float>(data.vx()));
+  insertColumn(vy_, at, static_cast<float>(data.vy()));
+  insertColumn(vz_, at, static_cast<float>(data.vz()));
+}
+
+void ColumnarPlatformSlice::assignAt_(size_t index, const PlatformUpdate& data)
+{
+  const size_t at = first_ + index;
+  times_[at] = data.time();
+  x_[at] = data.x();
+  y_[at] = data.y();
+  z_[at] = data.z();
+  psi_[at] = static_cast<float>(data.psi());
+  theta_[at] = static_cast<float>(data.theta());
+  phi_[at] = static_cast<float>(data.phi());
+  vx_[at] = static_cast<float>(data.vx());
+  vy_[at] = static_cast<float>(data.vy());
+  vz_[at] = static_cast<float>(data.vz());
+}
+
+void ColumnarPlatformSlice::erase_(size_t begin, size_t end)
+{
+  if (begin >= end)
+    return;
+  if (end >= numItems() && begin == 0)
+  {
+    clear_();
+    return;
+  }
+
+  size_t eraseBegin = first_ + begin;
+  size_t eraseEnd = first_ + end;
+  if (begin == 0)
+  {
+    // Removal from the front is deferred, so that data limiting does not shift the columns on every insert
+    first_ = eraseEnd;
+    if (first_ < COMPACT_THRESHOLD || first_ < numItems())
+      return;
+    eraseBegin = 0;
+    eraseEnd = first_;
+    first_ = 0;
+  }
+
+  eraseColumn(times_, eraseBegin, eraseEnd);
+  eraseColumn(x_, eraseBegin, eraseEnd);
+  eraseColumn(y_, eraseBegin, eraseEnd);
+  eraseColumn(z_, eraseBegin, eraseEnd);
+  eraseColumn(psi_, eraseBegin, eraseEnd);
+  eraseColumn(theta_, eraseBegin, eraseEnd);
+  eraseColumn(phi_, eraseBegin, eraseEnd);
+  eraseColumn(vx_, eraseBegin, eraseEnd);
+  eraseColumn(vy_, eraseBegin, eraseEnd);
+  eraseColumn(vz_, eraseBegin, eraseEnd);
+}
+
+void ColumnarPlatformSlice::clear_()
+{
+  first_ = 0;
+  fastUpdate_ = 0;
+  times_.clear();
+  x_.clear();
+  y_.clear();
+  z_.clear();
+  psi_.clear();
+  theta_.clear();
+  phi_.clear();
+  vx_.clear();
+  vy_.clear();
+  vz_.clear();
+}
+
+}
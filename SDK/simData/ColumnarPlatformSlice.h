@@ -0,0 +1,211 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_COLUMNARPLATFORMSLICE_H
+#define SIMDATA_COLUMNARPLATFORMSLICE_H
+
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simData/DataSlice.h"
+#include "simData/Interpolator.h"
+
+namespace simData
+{
+
+/**
+ * Platform update slice that stores its updates as a structure of arrays:  one contiguous
+ * array per field (time, x, y, z, psi, theta, phi, vx, vy, vz) instead of one heap allocated
+ * PlatformUpdate per point.  Time searches only touch the time array, and bulk consumers
+ * can read the columns directly through the zero-copy accessors such as times() and x().
+ *
+ * The class implements the PlatformUpdateSlice interface by materializing a PlatformUpdate
+ * on demand.  As a consequence the pointers returned by its iterators refer to storage owned
+ * by the iterator:  each iterator keeps the two most recently returned updates valid (enough
+ * for the common peekPrevious() / peekNext() pattern), and the pointers are invalidated when
+ * the iterator is destroyed.  Pointers from current() and interpolationBounds() remain valid
+ * until the next update(), insert() or flush() call.
+ *
+ * Maintenance functions mirror those of MemoryDataSlice<PlatformUpdate>, except that insert()
+ * copies the update instead of taking ownership of it.
+ */
+class SDKDATA_EXPORT ColumnarPlatformSlice : public PlatformUpdateSlice
+{
+public:
+  ColumnarPlatformSlice();
+  virtual ~ColumnarPlatformSlice();
+
+  ///@return true if current update has changed during last update()
+  virtual bool hasChanged() const;
+  ///@return true if the slice has been modified since last update()
+  virtual bool isDirty() const;
+
+  /// Process update range; visitor receives a materialized update valid only for the duration of the call
+  virtual void visit(PlatformUpdateSlice::Visitor* visitor) const;
+  /// Not supported; PlatformUpdate is not a protobuf message
+  virtual void modify(PlatformUpdateSlice::Modifier* modifier);
+
+  /// @copydoc simData::DataSlice::lower_bound
+  virtual PlatformUpdateSlice::Iterator lower_bound(double timeValue) const;
+  /// @copydoc simData::DataSlice::upper_bound
+  virtual PlatformUpdateSlice::Iterator upper_bound(double timeValue) const;
+  /// Total number of items in this data slice
+  virtual size_t numItems() const;
+  /// Retrieve the current update, or nullptr if none
+  virtual const PlatformUpdate* current() const;
+  /// Determine if current update is an actual data value or if it was interpolated from actual data values
+  virtual bool isInterpolated() const;
+  /// Retrieve the bounds used to compute the interpolated value; values are nullptr if not interpolated
+  virtual Bounds interpolationBounds() const;
+  /// Earliest time in the update slice, or DBL_MAX if none
+  virtual double firstTime() const;
+  /// Latest time in the update slice, or -DBL_MAX if none
+  virtual double lastTime() const;
+  /// Returns the delta between the given time and the time of the data point before the given time; returns -1 if there is no previous point
+  virtual double deltaTime(double time) const;
+
+  /// remove all data in the slice
+  void flush(bool keepStatic = true);
+  /// remove points in the given time range; up to but not including endTime
+  void flush(double startTime, double endTime);
+
+  /// Clear the marker that indicates if the "current" update contains new data
+  void clearChanged();
+
+  /**
+   * Perform a time update, finding the update whose time matches or is the lower bound of the specified time
+   * @param time
+   */
+  void update(double time);
+
+  /**
+   * Perform a time update, finding the update whose time is an exact match for the time specified, or interpolating
+   * to compute the update for the time specified from its bounding points
+   * @param time
+   * @param interpolator
+   */
+  void update(double time, Interpolator* interpolator);
+
+  /**
+   * Insert a copy of the update in time-sorted order; replaces any update with the same time
+   * @param data Update to copy into the slice
+   */
+  void insert(const PlatformUpdate& data);
+
+  /// reduce the slice to only have points within the given 'timeWindow'
+  /// @param timeWindow amount of time to keep in window (negative for no limit)
+  void limitByTime(double timeWindow);
+
+  /// reduce the slice to only have 'limitPoints' points
+  /// @param limitPoints number of points to keep (0 is no limit)
+  void limitByPoints(uint32_t limitPoints);
+
+  /** Performs both point and time limiting based on the settings in prefs */
+  void limitByPrefs(const CommonPrefs& prefs);
+
+  /**
+   * Copies the update at the given index into the output parameter
+   * @param index Index of the update, in [0, numItems())
+   * @param update Receives the update; must not be nullptr
+   * @return 0 on success, non-zero if index is out of range
+   */
+  int get(size_t index, PlatformUpdate* update) const;
+
+  /**@name Zero-copy column accessors
+   * Each returns a pointer to numItems() contiguous values in time order, or nullptr if the
+   * slice is empty.  Pointers are invalidated by any call that modifies the slice.  Unset values
+   * hold the same sentinel (the type's maximum value) as PlatformUpdate.
+   *@{
+   */
+  const double* times() const;
+  const double* x() const;
+  const double* y() const;
+  const double* z() const;
+  const float* psi() const;
+  const float* theta() const;
+  const float* phi() const;
+  const float* vx() const;
+  const float* vy() const;
+  const float* vz() const;
+  ///@}
+
+protected:
+  /// Helper function to return an iterator to first index
+  virtual PlatformUpdateSlice::IteratorImpl* iterator_() const;
+
+private:
+  class ColumnIterator;
+
+  /// Returns the index of the first update with time >= the given time, using fastUpdate_ as a hint
+  size_t lowerBound_(double time) const;
+  /// Returns the index of the first update with time > the given time, using fastUpdate_ as a hint
+  size_t upperBound_(double time) const;
+  /// Sets current_ to the materialized update at index, or nullptr for numItems()
+  void setCurrent_(size_t index);
+
+  /// Inserts the update before the given index
+  void insertAt_(size_t index, const PlatformUpdate& data);
+  /// Overwrites the update at the given index
+  void assignAt_(size_t index, const PlatformUpdate& data);
+  /// Removes the updates in the range [begin, end) of indices
+  void erase_(size_t begin, size_t end);
+  /// Removes all updates
+  void clear_();
+
+  /// Index of the first live value in each column; values before it have been removed by data limiting
+  size_t first_;
+  std::vector<double> times_;
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> z_;
+  std::vector<float> psi_;
+  std::vector<float> theta_;
+  std::vector<float> phi_;
+  std::vector<float> vx_;
+  std::vector<float> vy_;
+  std::vector<float> vz_;
+
+  /// used to mark if time update or changes to the slice have resulted in a change to the current update
+  bool hasChanged_;
+  /// used to mark if this slice needs to be updated
+  bool dirty_;
+  /// Points to currentValue_, currentInterpolated_, or nullptr
+  const PlatformUpdate* current_;
+  /// Materialized copy of the current update when not interpolated
+  PlatformUpdate currentValue_;
+  /// Cache of the interpolated update for the current time
+  PlatformUpdate currentInterpolated_;
+  /// Materialized copies of the interpolation bounds
+  PlatformUpdate lowBound_;
+  PlatformUpdate highBound_;
+  /// specifies if the interpolated cache value is valid
+  bool interpolated_;
+  /// Index near the last update, used to optimize sequential time searches
+  size_t fastUpdate_;
+
+  /// Not implemented
+  ColumnarPlatformSlice(const ColumnarPlatformSlice&);
+  ColumnarPlatformSlice& operator=(const ColumnarPlatformSlice&);
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "simData/DataSlice.h"
@@ -147,6 +148,9 @@ public:
     std::shared_ptr<TransactionImpl> transaction_; /// underlying implementation
   };
 
+  /// "." separated paths of changed prefs or properties fields (e.g. "commonPrefs.draw"); test with simData::protobuf::containsField()
+  typedef std::vector<std::string> FieldList;
+
   /// similar to Observer, but provides more info to the listener
   class Listener
   {
@@ -168,6 +172,12 @@ public:
     /// properties for the given entity have been changed
     virtual void onPropertiesChange(DataStore *source, ObjectId id) = 0;
 
+    /// prefs for the given entity have been changed; override to skip work for unrelated fields.  Default calls onPrefsChange()
+    virtual void onPrefsFieldsChange(DataStore *source, ObjectId id, const FieldList& changedFields) { onPrefsChange(source, id); }
+
+    /// properties for the given entity have been changed; override to skip work for unrelated fields.  Default calls onPropertiesChange()
+    virtual void onPropertiesFieldsChange(DataStore *source, ObjectId id, const FieldList& changedFields) { onPropertiesChange(source, id); }
+
     /// data store has changed, this includes both time change and/or data change; called a max of once per frame
     virtual void onChange(DataStore *source) = 0;
 
@@ -443,6 +453,14 @@ public: // methods
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const = 0;
 
+  /**
+   * Retrieve the IDs of entities whose update slice changed (hasChanged() or isDirty()) in the most
+   * recent call to update(double).  Entities without an update slice, such as custom renderings, are
+   * never reported.  The list is replaced on each update() and may reference entities removed since.
+   * @param ids Receives the changed IDs in ascending order; existing contents are kept
+   */
+  virtual void changedIdList(IdList* ids) const = 0;
+
   /// Retrieve a list of IDs for all beams associated with a platform
   virtual void beamIdListForHost(ObjectId hostid, IdList *ids) const = 0;
 
@@ -603,6 +621,18 @@ public: // methods
   //virtual        TableData*        addTableData(ObjectId id, Transaction *transaction) = 0;
   ///@}
 
+  /**
+   * Adds a batch of platform updates in one operation, e.g. when loading a file.  The updates are
+   * sorted once and merged into the platform's update slice in a single pass, data limiting is
+   * applied once, and the new-updates listener is notified once for the earliest and once for the
+   * latest time in the batch.  As with addPlatformUpdate(), an update replaces an existing update
+   * with the same time.
+   * @param id Platform to receive the updates
+   * @param updates Updates to add, in any order
+   * @return 0 on success, non-zero if the platform does not exist
+   */
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) = 0;
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
@@ -142,6 +142,9 @@ public: // methods
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const {dataStore_->idListByOriginalId(ids, originalId, type);}
 
+  /// Retrieve the IDs of entities whose update slice changed in the most recent update()
+  virtual void changedIdList(IdList* ids) const {dataStore_->changedIdList(ids);}
+
   /// Retrieve a list of IDs for all beams associated with a platform
   virtual void beamIdListForHost(ObjectId hostid, IdList *ids) const {dataStore_->beamIdListForHost(hostid, ids);}
 
@@ -295,6 +298,9 @@ public: // methods
   //virtual        TableData*        addTableData(ObjectId id, Transaction *transaction) = 0;
   ///@}
 
+  /// @copydoc simData::DataStore::addPlatformUpdates
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) { return dataStore_->addPlatformUpdates(id, updates); }
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
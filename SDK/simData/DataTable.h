@@ -23,6 +23,8 @@
 #ifndef SIMDATA_DATATABLE_H
 #define SIMDATA_DATATABLE_H
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -656,6 +658,110 @@ public:
    */
   virtual int getTimeRange(double& begin, double& end) const = 0;
   /// @}
+
+  ///@{
+  /**
+   * Bulk copies the cells with times in [beginTime, endTime), in time order, converting values
+   * to the output type as necessary.  Unlike iteration, no objects are allocated per cell, making
+   * this suitable for plotting or exporting large columns.  Use TableColumnCursor to walk a range
+   * of unknown size using a fixed size buffer.
+   * @param beginTime Time of the first cell to copy, inclusive
+   * @param endTime Time after the last cell to copy, exclusive
+   * @param values Receives the cell values; must have room for maxCount values
+   * @param times Receives the cell times; may be nullptr if times are not needed, else must have room for maxCount times
+   * @param maxCount Maximum number of cells to copy
+   * @return Number of cells copied
+   */
+  virtual size_t copyRange(double beginTime, double endTime, uint8_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, int8_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, uint16_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, int16_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, uint32_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, int32_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, uint64_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, int64_t* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, float* values, double* times, size_t maxCount) const = 0;
+  virtual size_t copyRange(double beginTime, double endTime, double* values, double* times, size_t maxCount) const = 0;
+  ///@}
+};
+
+/**
+ * Forward-only cursor over the cells of a column in a time range.  Cells are read in blocks
+ * through TableColumn::copyRange() into a buffer held by the cursor, so stepping through cells
+ * makes no heap allocations and no virtual calls.  Values are converted to the numeric type T.
+ * Changes to the column invalidate the cursor.
+ *
+ * <code>
+ * TableColumnCursor<double> cursor(*column);
+ * while (cursor.next())
+ *   plot(cursor.time(), cursor.value());
+ * </code>
+ */
+template <typename T>
+class TableColumnCursor
+{
+public:
+  /// Number of cells read from the column at a time
+  static const size_t BLOCK_SIZE = 256;
+
+  /**
+   * Creates a cursor positioned before the first cell in [beginTime, endTime)
+   * @param column Column to read; must outlive the cursor
+   * @param beginTime Time of the first cell, inclusive
+   * @param endTime Time after the last cell, exclusive
+   */
+  explicit TableColumnCursor(const TableColumn& column, double beginTime = -std::numeric_limits<double>::max(),
+    double endTime = std::numeric_limits<double>::max())
+    : column_(column),
+      nextTime_(beginTime),
+      endTime_(endTime),
+      count_(0),
+      position_(0),
+      done_(false)
+  {
+  }
+
+  /**
+   * Advances to the next cell
+   * @return True if the cursor is on a cell, false if there are no more cells
+   */
+  bool next()
+  {
+    if (position_ + 1 < count_)
+    {
+      ++position_;
+      return true;
+    }
+    if (done_)
+    {
+      position_ = count_;
+      return false;
+    }
+    count_ = column_.copyRange(nextTime_, endTime_, values_, times_, BLOCK_SIZE);
+    position_ = 0;
+    // A partial block means the range is exhausted
+    done_ = (count_ < BLOCK_SIZE);
+    if (count_ == 0)
+      return false;
+    // Times in a column are unique, so the next block starts just after the last time read
+    nextTime_ = std::nextafter(times_[count_ - 1], std::numeric_limits<double>::infinity());
+    return true;
+  }
+
+  /** Time of the current cell; only valid after next() returns true */
+  double time() const { return times_[position_]; }
+  /** Value of the current cell; only valid after next() returns true */
+  T value() const { return values_[position_]; }
+
+private:
+  const TableColumn& column_;
+  double nextTime_;
+  double endTime_;
+  size_t count_;
+  size_t position_;
+  bool done_;
+  T values_[BLOCK_SIZE];
+  double times_[BLOCK_SIZE];
 };
 
 /// Forward declare a cell class to be used internally by TableRow
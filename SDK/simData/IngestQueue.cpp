@@ -0,0 +1,233 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cassert>
+#include "simData/DataStore.h"
+#include "simData/IngestQueue.h"
+
+namespace simData
+{
+
+namespace
+{
+  /** Moves the queued protobuf update into a new update of the data store; returns 0 on success */
+  template <typename UpdateType>
+  int applyMessage(DataStore& dataStore, ObjectId id, google::protobuf::Message* message,
+    UpdateType* (DataStore::*addUpdate)(ObjectId, DataStore::Transaction*))
+  {
+    DataStore::Transaction t;
+    UpdateType* update = (dataStore.*addUpdate)(id, &t);
+    if (update == nullptr)
+      return 1;
+    update->Swap(static_cast<UpdateType*>(message));
+    t.complete(&update);
+    return 0;
+  }
+}
+
+IngestQueue::Item::Item()
+  : type(NONE),
+    id(0)
+{
+}
+
+IngestQueue::IngestQueue(size_t capacity)
+  : queue_(capacity),
+    accepted_(0),
+    dropped_(0),
+    applied_(0),
+    rejected_(0),
+    highWaterMark_(0)
+{
+}
+
+IngestQueue::~IngestQueue()
+{
+}
+
+size_t IngestQueue::capacity() const
+{
+  return queue_.capacity();
+}
+
+size_t IngestQueue::size() const
+{
+  return queue_.size();
+}
+
+int IngestQueue::push(ObjectId id, const PlatformUpdate& update)
+{
+  Item item;
+  item.type = PLATFORM;
+  item.id = id;
+  item.platform = update;
+  return push_(item);
+}
+
+int IngestQueue::push(ObjectId id, BeamUpdate* update)
+{
+  Item item;
+  item.type = BEAM;
+  item.id = id;
+  item.message.reset(update);
+  return push_(item);
+}
+
+int IngestQueue::push(ObjectId id, GateUpdate* update)
+{
+  Item item;
+  item.type = GATE;
+  item.id = id;
+  item.message.reset(update);
+  return push_(item);
+}
+
+int IngestQueue::push(ObjectId id, LaserUpdate* update)
+{
+  Item item;
+  item.type = LASER;
+  item.id = id;
+  item.message.reset(update);
+  return push_(item);
+}
+
+int IngestQueue::push(ObjectId id, ProjectorUpdate* update)
+{
+  Item item;
+  item.type = PROJECTOR;
+  item.id = id;
+  item.message.reset(update);
+  return push_(item);
+}
+
+int IngestQueue::push(ObjectId id, LobGroupUpdate* update)
+{
+  Item item;
+  item.type = LOB_GROUP;
+  item.id = id;
+  item.message.reset(update);
+  return push_(item);
+}
+
+int IngestQueue::push_(Item& item)
+{
+  if (item.type != PLATFORM && !item.message)
+    return 1;
+  if (!queue_.tryPush(std::move(item)))
+  {
+    // item still owns the update, which is deleted on return
+    ++dropped_;
+    return 1;
+  }
+  ++accepted_;
+  updateHighWaterMark_(queue_.size());
+  return 0;
+}
+
+void IngestQueue::updateHighWaterMark_(size_t queued)
+{
+  size_t previous = highWaterMark_.load(std::memory_order_relaxed);
+  while (queued > previous && !highWaterMark_.compare_exchange_weak(previous, queued, std::memory_order_relaxed))
+  {
+    // previous was reloaded by the failed exchange
+  }
+}
+
+size_t IngestQueue::drain(DataStore& dataStore)
+{
+  // Limit the batch to the updates queued now so that busy producers cannot starve the caller
+  const size_t queued = queue_.size();
+
+  size_t applied = 0;
+  size_t rejected = 0;
+  Item item;
+  for (size_t k = 0; k < queued && queue_.tryPop(item); ++k)
+  {
+    if (item.type == PLATFORM)
+    {
+      // Collected for one batch per platform; order within a platform is preserved
+      platformBatches_[item.id].push_back(item.platform);
+      continue;
+    }
+    if (apply_(dataStore, item) == 0)
+      ++applied;
+    else
+      ++rejected;
+    item.message.reset();
+  }
+
+  for (std::map<ObjectId, std::vector<PlatformUpdate> >::const_iterator iter = platformBatches_.begin(); iter != platformBatches_.end(); ++iter)
+  {
+    if (dataStore.addPlatformUpdates(iter->first, iter->second) == 0)
+      applied += iter->second.size();
+    else
+      rejected += iter->second.size();
+  }
+  platformBatches_.clear();
+
+  applied_ += applied;
+  rejected_ += rejected;
+  return applied;
+}
+
+int IngestQueue::apply_(DataStore& dataStore, Item& item) const
+{
+  switch (item.type)
+  {
+  case BEAM:
+    return applyMessage<BeamUpdate>(dataStore, item.id, item.message.get(), &DataStore::addBeamUpdate);
+  case GATE:
+    return applyMessage<GateUpdate>(dataStore, item.id, item.message.get(), &DataStore::addGateUpdate);
+  case LASER:
+    return applyMessage<LaserUpdate>(dataStore, item.id, item.message.get(), &DataStore::addLaserUpdate);
+  case PROJECTOR:
+    return applyMessage<ProjectorUpdate>(dataStore, item.id, item.message.get(), &DataStore::addProjectorUpdate);
+  case LOB_GROUP:
+    return applyMessage<LobGroupUpdate>(dataStore, item.id, item.message.get(), &DataStore::addLobGroupUpdate);
+  default:
+    break;
+  }
+  assert(0);
+  return 1;
+}
+
+IngestQueue::Statistics IngestQueue::statistics() const
+{
+  Statistics stats;
+  stats.accepted = accepted_;
+  stats.dropped = dropped_;
+  stats.applied = applied_;
+  stats.rejected = rejected_;
+  stats.highWaterMark = highWaterMark_;
+  return stats;
+}
+
+void IngestQueue::resetStatistics()
+{
+  accepted_ = 0;
+  dropped_ = 0;
+  applied_ = 0;
+  rejected_ = 0;
+  highWaterMark_ = 0;
+}
+
+}
@@ -0,0 +1,145 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_INGESTQUEUE_H
+#define SIMDATA_INGESTQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simCore/Common/MpscQueue.h"
+#include "simData/DataTypes.h"
+#include "simData/ObjectId.h"
+
+namespace google { namespace protobuf { class Message; } }
+
+namespace simData
+{
+
+class DataStore;
+
+/**
+ * Thread-safe front end for adding entity updates to a DataStore.  The DataStore itself has
+ * no internal synchronization, so updates decoded on other threads would otherwise have to
+ * be marshaled to the thread that owns the data store one at a time.  Any number of producer
+ * threads may push() pre-built updates into a bounded lock-free ring; the thread that owns
+ * the data store applies them in a batch with drain().  Platform updates are grouped by
+ * platform and added with DataStore::addPlatformUpdates(), so data limiting and the
+ * new-updates listener run once per platform per drain instead of once per update.  MemoryDataStore::update() drains
+ * its attached queue (see MemoryDataStore::setIngestQueue()) before updating its slices.
+ *
+ * The queue never blocks.  When it is full, push() drops the update and returns non-zero,
+ * which producers can use as a back-pressure signal, e.g. to throttle reading or to skip
+ * low-priority data.  statistics() reports the number of accepted, dropped, applied and
+ * rejected updates.
+ */
+class SDKDATA_EXPORT IngestQueue
+{
+public:
+  /** Counts of updates processed by the queue since construction or resetStatistics() */
+  struct Statistics
+  {
+    uint64_t accepted;     ///< Updates added to the queue
+    uint64_t dropped;      ///< Updates discarded because the queue was full
+    uint64_t applied;      ///< Updates added to the data store by drain()
+    uint64_t rejected;     ///< Updates discarded by drain() because their entity did not exist
+    size_t highWaterMark;  ///< Most updates queued at once, sampled on each push()
+  };
+
+  /** Creates a queue that holds at least the given number of updates; rounded up to a power of two */
+  explicit IngestQueue(size_t capacity);
+  virtual ~IngestQueue();
+
+  /** Maximum number of queued updates */
+  size_t capacity() const;
+  /** Number of queued updates; approximate while other threads are pushing */
+  size_t size() const;
+
+  /**@name Thread-safe methods to queue an update for the entity with the given ID
+   * The protobuf based updates are passed by pointer and ownership is always transferred;
+   * they are deleted if dropped.
+   * @return 0 on success, non-zero if the queue is full and the update was dropped
+   *@{
+   */
+  int push(ObjectId id, const PlatformUpdate& update);
+  int push(ObjectId id, BeamUpdate* update);
+  int push(ObjectId id, GateUpdate* update);
+  int push(ObjectId id, LaserUpdate* update);
+  int push(ObjectId id, ProjectorUpdate* update);
+  int push(ObjectId id, LobGroupUpdate* update);
+  ///@}
+
+  /**
+   * Adds the queued updates to the data store.  Must be called from the thread that owns
+   * the data store, and from only one thread at a time.  Only the updates queued when the
+   * drain starts are applied, so producers cannot starve the caller.
+   * @param dataStore Data store to receive the updates
+   * @return Number of updates applied
+   */
+  size_t drain(DataStore& dataStore);
+
+  /** Retrieves the current statistics */
+  Statistics statistics() const;
+  /** Resets all statistics to zero */
+  void resetStatistics();
+
+private:
+  /** One queued update */
+  struct Item
+  {
+    Item();
+    ObjectType type;
+    ObjectId id;
+    /// Platform updates are stored by value, avoiding an allocation on the hot path
+    PlatformUpdate platform;
+    /// Protobuf based updates for the other entity types
+    std::unique_ptr<google::protobuf::Message> message;
+  };
+
+  /** Adds the item to the ring and updates the statistics */
+  int push_(Item& item);
+  /** Adds a single non-platform item to the data store; returns 0 on success */
+  int apply_(DataStore& dataStore, Item& item) const;
+  /** Raises the high-water mark to the given queue size if needed; thread-safe */
+  void updateHighWaterMark_(size_t queued);
+
+  simCore::MpscQueue<Item> queue_;
+  std::atomic<uint64_t> accepted_;
+  std::atomic<uint64_t> dropped_;
+  std::atomic<uint64_t> applied_;
+  std::atomic<uint64_t> rejected_;
+  std::atomic<size_t> highWaterMark_;
+  /// Platform updates collected by drain(), by platform; only used by the draining thread
+  std::map<ObjectId, std::vector<PlatformUpdate> > platformBatches_;
+
+  // Not implemented
+  IngestQueue(const IngestQueue&);
+  IngestQueue& operator=(const IngestQueue&);
+};
+
+}
+
+#endif
@@ -107,7 +107,7 @@ void LobGroupMemoryDataSlice::update(double time)
 
 void LobGroupMemoryDataSlice::flush(bool keepStatic)
 {
-  if (MemorySliceHelper::flush(updates_, keepStatic) == 0)
+  if (MemorySliceHelper::flush(updates_, keepStatic, pool_) == 0)
   {
     delete current_;
     current_ = nullptr;
@@ -117,7 +117,7 @@ void LobGroupMemoryDataSlice::flush(bool keepStatic)
 
 void LobGroupMemoryDataSlice::flush(double startTime, double endTime)
 {
-  if (MemorySliceHelper::flush(updates_, startTime, endTime) == 0)
+  if (MemorySliceHelper::flush(updates_, startTime, endTime, pool_) == 0)
   {
     delete current_;
     current_ = nullptr;
@@ -144,7 +144,7 @@ void LobGroupMemoryDataSlice::insert(LobGroupUpdate *data)
       data->mutable_datapoints()->RemoveLast();
     }
     // done with data, since we added its points to an existing update record
-    delete data;
+    deleteUpdate(data);
   }
   else
   {
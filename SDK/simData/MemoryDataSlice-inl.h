@@ -71,8 +71,22 @@ typename std::deque<T>::iterator SafeDequeIterator<T>::get() const
 }
 
 //----------------------------------------------------------------------------
+template<typename T, typename Iterator>
+void releaseUpdates(Iterator begin, Iterator end, UpdatePool<T>* pool)
+{
+  if (pool == nullptr)
+  {
+    for (Iterator j = begin; j != end; ++j)
+      delete *j;
+    return;
+  }
+
+  for (Iterator j = begin; j != end; ++j)
+    pool->release(*j);
+}
+
 template<typename T>
-int limitByTime(std::deque<T*> &updates, double timeLimit)
+int limitByTime(std::deque<T*> &updates, double timeLimit, UpdatePool<T>* pool)
 {
   if (updates.empty() || timeLimit < 0.0)
     return -1; // nothing to do
@@ -88,8 +102,7 @@ int limitByTime(std::deque<T*> &updates, double timeLimit)
     return -1; // nothing to do
 
   // reclaim memory for the points which will be removed
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != newFirstPt; ++j)
-    delete *j;
+  releaseUpdates(updates.begin(), newFirstPt, pool);
 
   // do the removal
   updates.erase(updates.begin(), newFirstPt);
@@ -97,7 +110,7 @@ int limitByTime(std::deque<T*> &updates, double timeLimit)
 }
 
 template<typename T>
-int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints)
+int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints, UpdatePool<T>* pool)
 {
   // zero is special case for "no limit"
   if (limitPoints == 0)
@@ -110,29 +123,27 @@ int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints)
   // set end point for deletion (only 'limitPoints' will remain at end)
   typename std::deque<T*>::iterator newFirstPt = updates.begin() + (curPoints - limitPoints);
 
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != newFirstPt; ++j)
-    delete *j;
+  releaseUpdates(updates.begin(), newFirstPt, pool);
 
   updates.erase(updates.begin(), newFirstPt);
   return 0;
 }
 
 template<typename T>
-int flush(std::deque<T*> &updates, bool keepStatic)
+int flush(std::deque<T*> &updates, bool keepStatic, UpdatePool<T>* pool)
 {
   // don't flush static entities
   if (keepStatic && updates.size() == 1 && (**updates.begin()).time() == -1.0)
     return 1;
 
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != updates.end(); ++j)
-    delete *j;
+  releaseUpdates(updates.begin(), updates.end(), pool);
 
   updates.clear();
   return 0;
 }
 
 template<typename T>
-int flush(std::deque<T*> &updates, double startTime, double endTime)
+int flush(std::deque<T*> &updates, double startTime, double endTime, UpdatePool<T>* pool)
 {
   auto start = std::lower_bound(updates.begin(), updates.end(), startTime, UpdateComp<T>());
   if ((start == updates.end()) || ((*start)->time() >= endTime))
@@ -141,8 +152,7 @@ int flush(std::deque<T*> &updates, double startTime, double endTime)
   // endTime is non-inclusive
   auto end = std::lower_bound(start, updates.end(), endTime, UpdateComp<T>());
 
-  for (auto it = start; it != end; ++it)
-    delete *it;
+  releaseUpdates(start, end, pool);
 
   updates.erase(start, end);
   return 0;
@@ -239,20 +249,23 @@ MemoryDataSlice<T>::MemoryDataSlice()
   current_(nullptr),
   interpolated_(false),
   bounds_(static_cast<T*>(nullptr), static_cast<T*>(nullptr)),
-  fastUpdate_(&updates_, updates_.end())
+  fastUpdate_(&updates_, updates_.end()),
+  pool_(nullptr),
+  pooled_(false)
 {
 }
 
 template<typename T>
 MemoryDataSlice<T>::~MemoryDataSlice()
 {
-  MemorySliceHelper::flush(updates_, false);
+  MemorySliceHelper::flush(updates_, false, pool_);
+  delete pool_;
 }
 
 template<typename T>
 void MemoryDataSlice<T>::flush(bool keepStatic)
 {
-  if (MemorySliceHelper::flush(updates_, keepStatic) == 0)
+  if (MemorySliceHelper::flush(updates_, keepStatic, pool_) == 0)
     current_ = nullptr;
   dirty_ = true;
 }
@@ -260,7 +273,7 @@ void MemoryDataSlice<T>::flush(bool keepStatic)
 template<typename T>
 void MemoryDataSlice<T>::flush(double startTime, double endTime)
 {
-  if (MemorySliceHelper::flush(updates_, startTime, endTime) == 0)
+  if (MemorySliceHelper::flush(updates_, startTime, endTime, pool_) == 0)
     current_ = nullptr;
   dirty_ = true;
 }
@@ -432,7 +445,7 @@ void MemoryDataSlice<T>::insert(T *data)
         if (current_ == *iter)
           setCurrent(nullptr);
 
-        delete *iter;
+        deleteUpdate(*iter);
         *iter = data;
         dirty_ = true;
         return;
@@ -444,12 +457,76 @@ void MemoryDataSlice<T>::insert(T *data)
   dirty_ = true;
 }
 
+template<typename T>
+void MemoryDataSlice<T>::insertBatch(std::vector<T*>& updates)
+{
+  if (updates.empty())
+    return;
+
+  // Stable sort, so that the last of several updates with the same time is kept, as with insert()
+  std::stable_sort(updates.begin(), updates.end(), UpdateComp<T>());
+  size_t numUnique = 0;
+  for (size_t k = 0; k < updates.size(); ++k)
+  {
+    if (numUnique > 0 && updates[numUnique - 1]->time() == updates[k]->time())
+    {
+      deleteUpdate(updates[numUnique - 1]);
+      updates[numUnique - 1] = updates[k];
+    }
+    else
+      updates[numUnique++] = updates[k];
+  }
+  updates.resize(numUnique);
+
+  if (updates_.empty() || updates_.back()->time() < updates.front()->time())
+  {
+    // Common case when loading files; the new updates all follow the existing updates
+    updates_.insert(updates_.end(), updates.begin(), updates.end());
+  }
+  else
+  {
+    // Merge with the existing updates from the first new time onward
+    typename std::deque<T*>::iterator first = std::lower_bound(updates_.begin(), updates_.end(), updates.front()->time(), UpdateComp<T>());
+    const std::vector<T*> tail(first, updates_.end());
+    updates_.erase(first, updates_.end());
+
+    size_t oldIndex = 0;
+    size_t newIndex = 0;
+    while (oldIndex < tail.size() && newIndex < updates.size())
+    {
+      T* existing = tail[oldIndex];
+      T* added = updates[newIndex];
+      if (existing->time() < added->time())
+      {
+        updates_.push_back(existing);
+        ++oldIndex;
+        continue;
+      }
+      if (existing->time() == added->time())
+      {
+        // NULL the current ptr, if we are replacing the update it aliases; current will become valid upon update
+        if (current_ == existing)
+          setCurrent(nullptr);
+        deleteUpdate(existing);
+        ++oldIndex;
+      }
+      updates_.push_back(added);
+      ++newIndex;
+    }
+    updates_.insert(updates_.end(), tail.begin() + oldIndex, tail.end());
+    updates_.insert(updates_.end(), updates.begin() + newIndex, updates.end());
+  }
+  updates.clear();
+  fastUpdate_.invalidate();
+  dirty_ = true;
+}
+
 template<typename T>
 void MemoryDataSlice<T>::limitByTime(double timeWindow)
 {
   if (timeWindow >= 0)
   {
-    if (MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow) == 0)
+    if (MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow, pool_) == 0)
       fastUpdate_.invalidate();
   }
 }
@@ -457,7 +534,7 @@ void MemoryDataSlice<T>::limitByTime(double timeWindow)
 template<typename T>
 void MemoryDataSlice<T>::limitByPoints(uint32_t limitPoints)
 {
-  if (MemorySliceHelper::limitByPoints(updates_, limitPoints) == 0)
+  if (MemorySliceHelper::limitByPoints(updates_, limitPoints, pool_) == 0)
     fastUpdate_.invalidate();
 }
 
@@ -518,6 +595,38 @@ T* MemoryDataSlice<T>::currentInterpolated()
   return &currentInterpolated_;
 }
 
+template<typename T>
+void MemoryDataSlice<T>::setPooledAllocation(bool pooled)
+{
+  pooled_ = pooled;
+}
+
+template<typename T>
+bool MemoryDataSlice<T>::pooledAllocation() const
+{
+  return pooled_;
+}
+
+template<typename T>
+T* MemoryDataSlice<T>::newUpdate()
+{
+  if (!pooled_)
+    return new T();
+
+  if (pool_ == nullptr)
+    pool_ = new UpdatePool<T>();
+  return pool_->allocate();
+}
+
+template<typename T>
+void MemoryDataSlice<T>::deleteUpdate(T* update)
+{
+  if (pool_ == nullptr)
+    delete update;
+  else
+    pool_->release(update);
+}
+
 template<typename T>
 typename DataSlice<T>::IteratorImpl* MemoryDataSlice<T>::iterator_() const
 {
@@ -529,7 +638,11 @@ template<class CommandType, class PrefType>
 MemoryCommandSlice<CommandType, PrefType>::MemoryCommandSlice()
 : lastUpdateTime_(-std::numeric_limits<double>::max()),
   hasChanged_(false),
-  earliestInsert_(std::numeric_limits<double>::max())
+  earliestInsert_(std::numeric_limits<double>::max()),
+  snapshotCommandInterval_(100),
+  snapshotTimeInterval_(0.0),
+  maxSnapshots_(32),
+  snapshotSpacing_(1)
 {
 }
 
@@ -576,6 +689,7 @@ void MemoryCommandSlice<CommandType, PrefType>::modify(typename DataSlice<Comman
   }
   // force a recalculation of commandPrefsCache_; less than optional solution
   // when necessary a future solution should reset the individual field
+  discardSnapshots_(-std::numeric_limits<double>::max());
   reset_();
 }
 
@@ -583,6 +697,7 @@ template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::flush()
 {
   MemorySliceHelper::flush(updates_);
+  discardSnapshots_(-std::numeric_limits<double>::max());
   earliestInsert_ = std::numeric_limits<double>::max();
 }
 
@@ -590,6 +705,7 @@ template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::flush(double startTime, double endTime)
 {
   MemorySliceHelper::flush(updates_, startTime, endTime);
+  discardSnapshots_(startTime);
   earliestInsert_ = std::numeric_limits<double>::max();
 }
 
@@ -613,6 +729,8 @@ void MemoryCommandSlice<CommandType, PrefType>::insert(CommandType *data)
   typename std::deque<CommandType*>::iterator iter = std::lower_bound(updates_.begin(), updates_.end(), data, UpdateComp<CommandType>());
   if (data->time() < earliestInsert_)
     earliestInsert_ = data->time();
+  // snapshots at or after the new command no longer reflect the command state
+  discardSnapshots_(data->time());
   if ((iter == updates_.end()) || (*iter)->time() != data->time())
   {
     // the transaction owns the data item, transfers ownership to the deque here
@@ -683,25 +801,11 @@ void MemoryCommandSlice<CommandType, PrefType>::update(DataStore *ds, ObjectId i
     return;
   }
 
-  // process all command updates in one prefs transaction
-  DataStore::Transaction t;
-  PrefType* prefs = nullptr;
-  simData::getPreference(ds, id, &prefs, &t);
-  if (prefs == nullptr)
-    return;
-
   const CommandType *lastCommand = current();
   if ((!lastCommand || time >= lastCommand->time()) && (earliestInsert_ > lastUpdateTime_))
   {
     // time moved forward: execute all commands from lastUpdateTime_ to new current time
     hasChanged_ = advance_(lastUpdateTime_, time);
-
-    // Check for repeated scalars in the command, forcing complete replacement instead of add-value
-    conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
-
-    // apply the current command state at every update, even if no change in command state occurred with this update; commands override prefs settings
-    prefs->MergeFrom(commandPrefsCache_);
-    t.complete(&prefs);
   }
   else
   {
@@ -709,31 +813,54 @@ void MemoryCommandSlice<CommandType, PrefType>::update(DataStore *ds, ObjectId i
     // reset lastUpdateTime_
     reset_();
 
-    // advance time forward, execute all commands from 0.0 (use -1.0 since we need a time before 0.0) to new current time
-    advance_(-1.0, time);
-    conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
+    // advance time forward, execute all commands from the nearest snapshot to new current time
+    replay_(time);
 
     hasChanged_ = true;
-
-    prefs->MergeFrom(commandPrefsCache_);
-    t.complete(&prefs);
   }
 
   // reset to no inserted commands
   earliestInsert_ = std::numeric_limits<double>::max();
+
+  // performance: no command state to apply, so skip copying and comparing the prefs in a transaction
+  if (commandPrefsCache_.ByteSizeLong() == 0)
+    return;
+
+  // process all command updates in one prefs transaction
+  DataStore::Transaction t;
+  PrefType* prefs = nullptr;
+  simData::getPreference(ds, id, &prefs, &t);
+  if (prefs == nullptr)
+    return;
+
+  // Check for repeated scalars in the command, forcing complete replacement instead of add-value
+  conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
+
+  // apply the current command state at every update, even if no change in command state occurred with this update; commands override prefs settings
+  prefs->MergeFrom(commandPrefsCache_);
+  t.complete(&prefs);
 }
 
 template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::limitByTime(double timeWindow)
 {
-  if (timeWindow >= 0)
-    MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow);
+  if (timeWindow < 0)
+    return;
+  const size_t oldSize = updates_.size();
+  MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow);
+  // snapshot command counts are relative to the first command
+  if (updates_.size() != oldSize)
+    discardSnapshots_(-std::numeric_limits<double>::max());
 }
 
 template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::limitByPoints(uint32_t limitPoints)
 {
+  const size_t oldSize = updates_.size();
   MemorySliceHelper::limitByPoints(updates_, limitPoints);
+  // snapshot command counts are relative to the first command
+  if (updates_.size() != oldSize)
+    discardSnapshots_(-std::numeric_limits<double>::max());
 }
 
 template<class CommandType, class PrefType>
@@ -791,6 +918,33 @@ double MemoryCommandSlice<CommandType, PrefType>::deltaTime(double time) const
   return -1;
 }
 
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::setSnapshotLimits(size_t commandInterval, double timeInterval, size_t maxSnapshots)
+{
+  snapshotCommandInterval_ = commandInterval;
+  snapshotTimeInterval_ = (timeInterval > 0.0) ? timeInterval : 0.0;
+  maxSnapshots_ = maxSnapshots;
+  // existing snapshots may not match the new spacing
+  discardSnapshots_(-std::numeric_limits<double>::max());
+}
+
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::snapshotLimits(size_t* commandInterval, double* timeInterval, size_t* maxSnapshots) const
+{
+  if (commandInterval)
+    *commandInterval = snapshotCommandInterval_;
+  if (timeInterval)
+    *timeInterval = snapshotTimeInterval_;
+  if (maxSnapshots)
+    *maxSnapshots = maxSnapshots_;
+}
+
+template<class CommandType, class PrefType>
+size_t MemoryCommandSlice<CommandType, PrefType>::numSnapshots() const
+{
+  return snapshots_.size();
+}
+
 template<class CommandType, class PrefType>
 bool MemoryCommandSlice<CommandType, PrefType>::advance_(double startTime, double time)
 {
@@ -822,6 +976,7 @@ bool MemoryCommandSlice<CommandType, PrefType>::advance_(double startTime, doubl
       // a command was executed, which may or may not be an actual change in prefs.
       prefsWereUpdated = true;
       lastUpdateTime_ = cmd->time();
+      snapshot_(i - updates_.begin());
     }
   }
   return prefsWereUpdated;
@@ -836,6 +991,70 @@ void MemoryCommandSlice<CommandType, PrefType>::reset_()
   earliestInsert_ = std::numeric_limits<double>::max();
 }
 
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::replay_(double time)
+{
+  // find the latest snapshot at or before time
+  typename std::deque<Snapshot>::const_iterator snapshot = std::upper_bound(snapshots_.begin(), snapshots_.end(), time,
+    [](double value, const Snapshot& s) { return value < s.time; });
+  if (snapshot == snapshots_.begin())
+  {
+    // execute all commands from 0.0 (use -1.0 since we need a time before 0.0)
+    advance_(-1.0, time);
+    return;
+  }
+
+  --snapshot;
+  commandPrefsCache_ = snapshot->prefs;
+  lastUpdateTime_ = snapshot->time;
+  advance_(snapshot->time, time);
+}
+
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::snapshot_(size_t index)
+{
+  if (maxSnapshots_ == 0 || (snapshotCommandInterval_ == 0 && snapshotTimeInterval_ <= 0.0))
+    return;
+
+  const double time = updates_[index]->time();
+  // only extend the snapshots forward; commands at earlier times are covered by existing snapshots
+  if (!snapshots_.empty() && time <= snapshots_.back().time)
+    return;
+
+  const size_t numCommands = index + 1;
+  const size_t previousCommands = snapshots_.empty() ? 0 : snapshots_.back().numCommands;
+  const double previousTime = snapshots_.empty() ? updates_.front()->time() : snapshots_.back().time;
+  const bool commandDue = (snapshotCommandInterval_ > 0) && (numCommands - previousCommands >= snapshotCommandInterval_ * snapshotSpacing_);
+  const bool timeDue = (snapshotTimeInterval_ > 0.0) && (time - previousTime >= snapshotTimeInterval_ * snapshotSpacing_);
+  if (!commandDue && !timeDue)
+    return;
+
+  if (snapshots_.size() >= maxSnapshots_)
+  {
+    // keep every other snapshot and double the spacing to bound memory use
+    std::deque<Snapshot> kept;
+    for (size_t k = 1; k < snapshots_.size(); k += 2)
+      kept.push_back(snapshots_[k]);
+    snapshots_.swap(kept);
+    snapshotSpacing_ *= 2;
+  }
+
+  Snapshot snapshot;
+  snapshot.time = time;
+  snapshot.numCommands = numCommands;
+  snapshot.prefs = commandPrefsCache_;
+  snapshots_.push_back(snapshot);
+}
+
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::discardSnapshots_(double time)
+{
+  while (!snapshots_.empty() && snapshots_.back().time >= time)
+    snapshots_.pop_back();
+  if (snapshots_.empty())
+    snapshotSpacing_ = 1;
+}
+
 template<class CommandType, class PrefType>
 bool MemoryCommandSlice<CommandType, PrefType>::hasRepeatedFields_(const PrefType* prefs) const
 {
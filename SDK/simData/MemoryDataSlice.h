@@ -24,12 +24,14 @@
 #define SIMDATA_MEMORYDATASLICE_H
 
 #include <deque>
+#include <vector>
 #include "simData/DataTypes.h"
 #include "simData/DataSlice.h"
 #include "simData/DataSliceUpdaters.h"
 #include "simData/Interpolator.h"
 #include "simData/ObjectId.h"
 #include "simData/UpdateComp.h"
+#include "simData/UpdatePool.h"
 
 namespace simData
 {
@@ -60,31 +62,42 @@ private:
 };
 
 
+/**
+ * Frees the updates in the range [begin, end), returning them to the pool if given, else deleting them
+ * @param begin First update to free
+ * @param end One past the last update to free
+ * @param pool Pool that may own the updates; nullptr if updates were allocated on the heap
+ */
+template<typename T, typename Iterator>
+void releaseUpdates(Iterator begin, Iterator end, UpdatePool<T>* pool);
+
 /**
  * Reduce the data store to only have points within the given 'timeWindow'
  * @param updates Deque of updates on which to apply data limit
  * @param timeLimit earliest time to keep
+ * @param pool Pool that may own the updates; nullptr if updates were allocated on the heap
  * @return 0 if at least one item is removed.
  */
 template<typename T>
-int limitByTime(std::deque<T*> &updates, double timeLimit);
+int limitByTime(std::deque<T*> &updates, double timeLimit, UpdatePool<T>* pool = nullptr);
 
 /**
  * Reduce the data store to only have 'limitPoints' points
  * @param updates Deque of updates on which to apply data limit
  * @param limitPoints number of points to keep (0 is no limit)
+ * @param pool Pool that may own the updates; nullptr if updates were allocated on the heap
  * @return 0 if at least one item is removed.
  */
 template<typename T>
-int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints);
+int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints, UpdatePool<T>* pool = nullptr);
 
 /// remove all points, unless keeping a static (time = -1) point; returns non-zero if flush did not occur due to static case
 template<typename T>
-int flush(std::deque<T*> &updates, bool keepStatic = true);
+int flush(std::deque<T*> &updates, bool keepStatic = true, UpdatePool<T>* pool = nullptr);
 
 /// remove points in the given time range; up to but not including endTime
 template<typename T>
-int flush(std::deque<T*> &updates, double startTime, double endTime);
+int flush(std::deque<T*> &updates, double startTime, double endTime, UpdatePool<T>* pool = nullptr);
 } // namespace MemorySliceHelper
 
 /** Iterator for DataSlice vector */
@@ -244,6 +257,17 @@ public:
    */
   virtual void insert(T *data);
 
+  /**
+   * Inserts a batch of updates with a single sort and a single merge pass, instead of one
+   * search and deque insert per update.  The result matches calling insert() on each update in
+   * order:  an update replaces an existing update with the same time, and the last of several
+   * updates in the batch with the same time wins.  Ownership of the updates is transferred and
+   * the vector is cleared.  Updates should come from newUpdate().  Does not call insert(), so
+   * subclasses that override insert() should not use this method.
+   * @param updates Updates to insert, in any order
+   */
+  void insertBatch(std::vector<T*>& updates);
+
   /// reduce the data store to only have points within the given 'timeWindow'
   /// @param timeWindow amount of time to keep in window (negative for no limit)
   void limitByTime(double timeWindow);
@@ -267,6 +291,25 @@ public:
   /** Retrieves the current interpolated T, or nullptr if none */
   T* currentInterpolated();
 
+  /**
+   * Enables or disables allocation of new updates from a per-slice chunked pool.  Updates that
+   * are already allocated are unaffected, and are freed by whichever allocator created them.
+   * @param pooled If true, newUpdate() allocates from the slice's UpdatePool
+   */
+  void setPooledAllocation(bool pooled);
+
+  /** Returns true if newUpdate() allocates from the slice's UpdatePool */
+  bool pooledAllocation() const;
+
+  /**
+   * Allocates an update for later insert().  Ownership passes to the slice on insert(); updates
+   * that are never inserted must be returned through deleteUpdate().
+   */
+  T* newUpdate();
+
+  /** Frees an update returned by newUpdate(), or any heap allocated update */
+  void deleteUpdate(T* update);
+
 protected:
   /// Helper function to return an iterator to first index
   virtual typename DataSlice<T>::IteratorImpl* iterator_() const;
@@ -288,6 +331,15 @@ protected:
   typename DataSlice<T>::Bounds bounds_;
   /// Used to optimize updates by looking at data near the last update
   typename MemorySliceHelper::SafeDequeIterator<T*> fastUpdate_;
+  /// Pool for update allocation; created on first use and kept until all of its updates are freed
+  UpdatePool<T>* pool_;
+  /// If true, newUpdate() allocates from pool_
+  bool pooled_;
+
+private:
+  /// Not implemented
+  MemoryDataSlice(const MemoryDataSlice&);
+  MemoryDataSlice& operator=(const MemoryDataSlice&);
 };
 
 //----------------------------------------------------------------------------
@@ -403,6 +455,25 @@ public:
   /// Not Implemented; always returns -1;
   virtual double deltaTime(double time) const;
 
+  /**
+   * Configures the command state snapshots used to speed up backward time seeks.  The command
+   * state is saved every commandInterval commands and every timeInterval seconds, whichever
+   * comes first (0 disables that trigger).  Moving backwards in time executes commands from
+   * the latest snapshot at or before the new time instead of from the first command.  When
+   * maxSnapshots is reached, every other snapshot is discarded and the intervals double, so
+   * memory use stays bounded.  A maxSnapshots of 0 disables snapshots.
+   * @param commandInterval Number of commands between snapshots
+   * @param timeInterval Seconds of scenario time between snapshots
+   * @param maxSnapshots Maximum number of snapshots kept
+   */
+  void setSnapshotLimits(size_t commandInterval, double timeInterval, size_t maxSnapshots);
+
+  /** Retrieves the values from setSnapshotLimits(); any parameter may be nullptr */
+  void snapshotLimits(size_t* commandInterval, double* timeInterval, size_t* maxSnapshots) const;
+
+  /// Returns the number of command state snapshots currently held
+  size_t numSnapshots() const;
+
 protected: // methods
   /**
    * Move "current" to specified time.
@@ -417,6 +488,19 @@ protected: // methods
   /// Set values to default
   void reset_();
 
+  /**
+   * Executes all commands up to the specified time, starting from the latest snapshot at or
+   * before the time when one is available.  Expects reset_() to have been called.
+   * @param time current time
+   */
+  void replay_(double time);
+
+  /// Saves the command state if the command at the given index is due for a snapshot
+  void snapshot_(size_t index);
+
+  /// Discards the snapshots at or after the given time
+  void discardSnapshots_(double time);
+
   /**
    * Repeated fields for command processing have unique requirements with respect to updating.
    * If a repeated field of the update command has values, then the current preferences
@@ -454,6 +538,24 @@ protected: // data
   bool hasChanged_;
   /// Keeps track of the earliest command time insert since the last update(), to efficiently process command updates
   double earliestInsert_;
+
+  /// Command state after executing every command at or before a time
+  struct Snapshot
+  {
+    double time;         ///< Time of the last command executed
+    size_t numCommands;  ///< Number of commands at or before time
+    PrefType prefs;      ///< Value of commandPrefsCache_
+  };
+  /// Snapshots of the command state, sorted by time
+  std::deque<Snapshot> snapshots_;
+  /// Number of commands between snapshots; 0 to disable
+  size_t snapshotCommandInterval_;
+  /// Seconds between snapshots; 0 to disable
+  double snapshotTimeInterval_;
+  /// Maximum number of snapshots; 0 to disable
+  size_t maxSnapshots_;
+  /// Multiplier on the snapshot intervals, doubled each time the snapshots are thinned
+  size_t snapshotSpacing_;
 };
 
 /**
@@ -25,8 +25,10 @@
 #include <functional>
 #include <float.h>
 #include <limits>
+#include <vector>
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Calculations.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simCore/Time/Clock.h"
 #include "simData/MemoryDataStore.h"
 #include "simData/DataEntry.h"
@@ -34,6 +36,8 @@
 #include "simData/DataTable.h"
 #include "simData/DataStoreHelpers.h"
 #include "simData/EntityNameCache.h"
+#include "simData/IngestQueue.h"
+#include "simData/MessageVisitor/Message.h"
 #include "simData/CategoryData/MemoryCategoryDataSlice.h"
 #include "simData/CategoryData/CategoryNameManager.h"
 #include "simData/MemoryTable/DataLimitsProvider.h"
@@ -132,6 +136,23 @@ EntryType* getEntry(ObjectId id, const EntryMapType *store, DataStore::Transacti
   return getEntry<EntryType, EntryMapType>(id, store);
 }
 
+/**
+ * Calls func with each (id, entry) pair of the map, distributing the entries across the thread pool
+ */
+template <typename EntryMapType, typename Function>
+void parallelForEachEntry(simCore::ThreadPool& pool, EntryMapType& entries, const Function& func)
+{
+  std::vector<typename EntryMapType::value_type*> items;
+  items.reserve(entries.size());
+  for (typename EntryMapType::iterator i = entries.begin(); i != entries.end(); ++i)
+    items.push_back(&*i);
+
+  pool.parallelFor(items.size(), [&items, &func](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k)
+      func(*items[k]);
+  });
+}
+
 /**
  * Update sparse data set slices (GenericData and CategoryData)
  */
@@ -145,6 +166,22 @@ void updateSparseSlices(EntryListType& entries, double time)
   }
 }
 
+/**
+ * Appends the IDs of entries whose update slice changed in the last update
+ * @param entries Entity map to scan
+ * @param ids Receives the changed IDs
+ */
+template <typename EntryMapType>
+void appendChangedIds(const EntryMapType& entries, DataStore::IdList& ids)
+{
+  for (typename EntryMapType::const_iterator i = entries.begin(); i != entries.end(); ++i)
+  {
+    const DataSliceBase* slice = i->second->updates();
+    if (slice->hasChanged() || slice->isDirty())
+      ids.push_back(i->first);
+  }
+}
+
 /**
 * Calls flush on any entries found for the specified id in the entity map
 * @param map Entity map
@@ -167,6 +204,20 @@ void flushEntityData(EntityMap& map, ObjectId id, bool flushUpdates, bool flushC
   }
 }
 
+/**
+ * Appends the fields changed by one commit to the fields changed by the transaction, skipping duplicates
+ * @param fields Fields changed by the commit
+ * @param allFields Fields changed by all commits so far
+ */
+void addChangedFields(const DataStore::FieldList& fields, DataStore::FieldList& allFields)
+{
+  for (DataStore::FieldList::const_iterator i = fields.begin(); i != fields.end(); ++i)
+  {
+    if (std::find(allFields.begin(), allFields.end(), *i) == allFields.end())
+      allFields.push_back(*i);
+  }
+}
+
 /** Data limit provider that pulls values out of the data store */
 class DataStoreLimits : public MemoryTable::DataLimitsProvider
 {
@@ -325,6 +376,12 @@ MemoryDataStore::MemoryDataStore()
   interpolator_(nullptr),
   newUpdatesListener_(new DefaultNewUpdatesListener),
   dataLimiting_(false),
+  pooledUpdates_(false),
+  updateThreads_(nullptr),
+  commandSnapshotInterval_(100),
+  commandSnapshotTimeInterval_(0.0),
+  maxCommandSnapshots_(32),
+  ingestQueue_(nullptr),
   categoryNameManager_(new CategoryNameManager),
   dataLimitsProvider_(nullptr),
   dataTableManager_(nullptr),
@@ -346,6 +403,12 @@ MemoryDataStore::MemoryDataStore(const ScenarioProperties &properties)
   interpolator_(nullptr),
   newUpdatesListener_(new DefaultNewUpdatesListener),
   dataLimiting_(false),
+  pooledUpdates_(false),
+  updateThreads_(nullptr),
+  commandSnapshotInterval_(100),
+  commandSnapshotTimeInterval_(0.0),
+  maxCommandSnapshots_(32),
+  ingestQueue_(nullptr),
   categoryNameManager_(new CategoryNameManager),
   dataLimitsProvider_(nullptr),
   dataTableManager_(nullptr),
@@ -371,6 +434,8 @@ MemoryDataStore::~MemoryDataStore()
   dataLimitsProvider_ = nullptr;
   delete entityNameCache_;
   entityNameCache_ = nullptr;
+  delete updateThreads_;
+  updateThreads_ = nullptr;
 }
 
 void MemoryDataStore::clear()
@@ -393,6 +458,7 @@ void MemoryDataStore::clear()
     delete it->second;
   genericData_.clear();
   categoryData_.clear();
+  changedIds_.clear();
 
   // clear out the category name manager, since categories are scenario specific data
   categoryNameManager_->clear();
@@ -471,38 +537,52 @@ void MemoryDataStore::updatePlatforms_(double time)
   // treat file mode as the default if no clock has been bound
   const bool fileMode = (!boundClock_ || !boundClock_->isLiveMode());
 
-  for (Platforms::const_iterator iter = platforms_.begin(); iter != platforms_.end(); ++iter)
+  if (updateThreads_ == nullptr)
   {
-    PlatformEntry* platform = iter->second;
-    // apply commands
-    platform->commands()->update(this, iter->first, time);
-
-    if (!platform->preferences()->commonprefs().datadraw())
+    for (Platforms::const_iterator iter = platforms_.begin(); iter != platforms_.end(); ++iter)
     {
-      // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-      platform->updates()->setCurrent(nullptr);
-      continue;
+      // apply commands
+      iter->second->commands()->update(this, iter->first, time);
+      updatePlatformSlice_(iter->second, time, fileMode);
     }
+    return;
+  }
+
+  // Commands can notify listeners, so they are applied on this thread before the slices are updated in parallel
+  for (Platforms::const_iterator iter = platforms_.begin(); iter != platforms_.end(); ++iter)
+    iter->second->commands()->update(this, iter->first, time);
+  parallelForEachEntry(*updateThreads_, platforms_, [this, time, fileMode](Platforms::value_type& entry) {
+    updatePlatformSlice_(entry.second, time, fileMode);
+  });
+}
+
+void MemoryDataStore::updatePlatformSlice_(PlatformEntry* platform, double time, bool fileMode)
+{
+  if (!platform->preferences()->commonprefs().datadraw())
+  {
+    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+    platform->updates()->setCurrent(nullptr);
+    return;
+  }
 
-    if (fileMode)
+  if (fileMode)
+  {
+    const PlatformUpdateSlice* slice = platform->updates();
+    const double firstTime = slice->firstTime();
+    const bool staticPlatform = (firstTime == -1.0);
+    // do we need to expire a non-static platform?
+    if (!staticPlatform && (time < firstTime || time > slice->lastTime()))
     {
-      const PlatformUpdateSlice* slice = platform->updates();
-      const double firstTime = slice->firstTime();
-      const bool staticPlatform = (firstTime == -1.0);
-      // do we need to expire a non-static platform?
-      if (!staticPlatform && (time < firstTime || time > slice->lastTime()))
-      {
-        // platform is not valid/has expired
-        platform->updates()->setCurrent(nullptr);
-        continue;
-      }
+      // platform is not valid/has expired
+      platform->updates()->setCurrent(nullptr);
+      return;
     }
-
-    if (isInterpolationEnabled() && platform->preferences()->interpolatepos())
-      platform->updates()->update(time, interpolator_);
-    else
-      platform->updates()->update(time);
   }
+
+  if (isInterpolationEnabled() && platform->preferences()->interpolatepos())
+    platform->updates()->update(time, interpolator_);
+  else
+    platform->updates()->update(time);
 }
 
 void MemoryDataStore::updateTargetBeam_(ObjectId id, BeamEntry* beam, double time)
@@ -572,22 +652,36 @@ void MemoryDataStore::updateTargetBeam_(ObjectId id, BeamEntry* beam, double tim
 
 void MemoryDataStore::updateBeams_(double time)
 {
-  for (Beams::iterator iter = beams_.begin(); iter != beams_.end(); ++iter)
+  if (updateThreads_ == nullptr)
   {
-    BeamEntry* beamEntry = iter->second;
-    // apply commands
-    beamEntry->commands()->update(this, iter->first, time);
-
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!beamEntry->preferences()->commonprefs().datadraw())
-      beamEntry->updates()->setCurrent(nullptr);
-    else if (beamEntry->properties()->type() == BeamProperties_BeamType_TARGET)
-      updateTargetBeam_(iter->first, beamEntry, time);
-    else if (isInterpolationEnabled() && beamEntry->preferences()->interpolatebeampos())
-      beamEntry->updates()->update(time, interpolator_);
-    else
-      beamEntry->updates()->update(time);
+    for (Beams::iterator iter = beams_.begin(); iter != beams_.end(); ++iter)
+    {
+      // apply commands
+      iter->second->commands()->update(this, iter->first, time);
+      updateBeamSlice_(iter->first, iter->second, time);
+    }
+    return;
   }
+
+  // Target beams only read the platform slices, which are already updated
+  for (Beams::iterator iter = beams_.begin(); iter != beams_.end(); ++iter)
+    iter->second->commands()->update(this, iter->first, time);
+  parallelForEachEntry(*updateThreads_, beams_, [this, time](Beams::value_type& entry) {
+    updateBeamSlice_(entry.first, entry.second, time);
+  });
+}
+
+void MemoryDataStore::updateBeamSlice_(ObjectId id, BeamEntry* beamEntry, double time)
+{
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!beamEntry->preferences()->commonprefs().datadraw())
+    beamEntry->updates()->setCurrent(nullptr);
+  else if (beamEntry->properties()->type() == BeamProperties_BeamType_TARGET)
+    updateTargetBeam_(id, beamEntry, time);
+  else if (isInterpolationEnabled() && beamEntry->preferences()->interpolatebeampos())
+    beamEntry->updates()->update(time, interpolator_);
+  else
+    beamEntry->updates()->update(time);
 }
 
 simData::MemoryDataStore::BeamEntry* MemoryDataStore::getBeamForGate_(google::protobuf::uint64 gateID)
@@ -700,92 +794,183 @@ bool MemoryDataStore::gateUsesBeamBeamwidth_(GateEntry* gate) const
 
 void MemoryDataStore::updateGates_(double time)
 {
-  for (Gates::iterator iter = gates_.begin(); iter != gates_.end(); ++iter)
+  if (updateThreads_ == nullptr)
   {
-    GateEntry* gateEntry = iter->second;
-    // apply commands
-    gateEntry->commands()->update(this, iter->first, time);
+    for (Gates::iterator iter = gates_.begin(); iter != gates_.end(); ++iter)
+    {
+      // apply commands
+      iter->second->commands()->update(this, iter->first, time);
+      updateGateSlice_(iter->second, time);
+    }
+    return;
+  }
 
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!gateEntry->preferences()->commonprefs().datadraw())
-      gateEntry->updates()->setCurrent(nullptr);
-    else if (gateEntry->properties()->type() == GateProperties_GateType_TARGET)
-      updateTargetGate_(gateEntry, time);
+  // Target gates only read the beam and platform slices, which are already updated
+  for (Gates::iterator iter = gates_.begin(); iter != gates_.end(); ++iter)
+    iter->second->commands()->update(this, iter->first, time);
+  parallelForEachEntry(*updateThreads_, gates_, [this, time](Gates::value_type& entry) {
+    updateGateSlice_(entry.second, time);
+  });
+}
+
+void MemoryDataStore::updateGateSlice_(GateEntry* gateEntry, double time)
+{
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!gateEntry->preferences()->commonprefs().datadraw())
+    gateEntry->updates()->setCurrent(nullptr);
+  else if (gateEntry->properties()->type() == GateProperties_GateType_TARGET)
+    updateTargetGate_(gateEntry, time);
+  else
+  {
+    if (isInterpolationEnabled() && gateEntry->preferences()->interpolategatepos())
+      gateEntry->updates()->update(time, interpolator_);
     else
-    {
-      if (isInterpolationEnabled() && gateEntry->preferences()->interpolategatepos())
-        gateEntry->updates()->update(time, interpolator_);
-      else
-        gateEntry->updates()->update(time);
+      gateEntry->updates()->update(time);
 
-      if (gateUsesBeamBeamwidth_(gateEntry))
-      {
-        // this gate depends on beam prefs; either
-        //   force an update of the gate every iteration, or
-        //   update gate when there is a change in beam pref height or width
+    if (gateUsesBeamBeamwidth_(gateEntry))
+    {
+      // this gate depends on beam prefs; either
+      //   force an update of the gate every iteration, or
+      //   update gate when there is a change in beam pref height or width
 
-        // force an update of the gate every iteration
-        gateEntry->updates()->setChanged();
-      }
+      // force an update of the gate every iteration
+      gateEntry->updates()->setChanged();
     }
   }
 }
 
 void MemoryDataStore::updateLasers_(double time)
 {
-  for (Lasers::iterator iter = lasers_.begin(); iter != lasers_.end(); ++iter)
+  if (updateThreads_ == nullptr)
   {
-    LaserEntry* laserEntry = iter->second;
-    // apply commands
-    laserEntry->commands()->update(this, iter->first, time);
-
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!laserEntry->preferences()->commonprefs().datadraw())
-      laserEntry->updates()->setCurrent(nullptr);
-    // laser interpolation is on, there is no preference; but off if we have no interpolator
-    else if (isInterpolationEnabled())
-      laserEntry->updates()->update(time, interpolator_);
-    else
-      laserEntry->updates()->update(time);
+    for (Lasers::iterator iter = lasers_.begin(); iter != lasers_.end(); ++iter)
+    {
+      // apply commands
+      iter->second->commands()->update(this, iter->first, time);
+      updateLaserSlice_(iter->second, time);
+    }
+    return;
   }
+
+  for (Lasers::iterator iter = lasers_.begin(); iter != lasers_.end(); ++iter)
+    iter->second->commands()->update(this, iter->first, time);
+  parallelForEachEntry(*updateThreads_, lasers_, [this, time](Lasers::value_type& entry) {
+    updateLaserSlice_(entry.second, time);
+  });
+}
+
+void MemoryDataStore::updateLaserSlice_(LaserEntry* laserEntry, double time)
+{
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!laserEntry->preferences()->commonprefs().datadraw())
+    laserEntry->updates()->setCurrent(nullptr);
+  // laser interpolation is on, there is no preference; but off if we have no interpolator
+  else if (isInterpolationEnabled())
+    laserEntry->updates()->update(time, interpolator_);
+  else
+    laserEntry->updates()->update(time);
 }
 
 void MemoryDataStore::updateProjectors_(double time)
 {
-  for (Projectors::iterator iter = projectors_.begin(); iter != projectors_.end(); ++iter)
+  if (updateThreads_ == nullptr)
   {
-    ProjectorEntry* projectorEntry = iter->second;
-    // apply commands
-    projectorEntry->commands()->update(this, iter->first, time);
-
-    if (isInterpolationEnabled() && projectorEntry->preferences()->interpolateprojectorfov())
-      projectorEntry->updates()->update(time, interpolator_);
-    else
-      projectorEntry->updates()->update(time);
+    for (Projectors::iterator iter = projectors_.begin(); iter != projectors_.end(); ++iter)
+    {
+      // apply commands
+      iter->second->commands()->update(this, iter->first, time);
+      updateProjectorSlice_(iter->second, time);
+    }
+    return;
   }
+
+  for (Projectors::iterator iter = projectors_.begin(); iter != projectors_.end(); ++iter)
+    iter->second->commands()->update(this, iter->first, time);
+  parallelForEachEntry(*updateThreads_, projectors_, [this, time](Projectors::value_type& entry) {
+    updateProjectorSlice_(entry.second, time);
+  });
+}
+
+void MemoryDataStore::updateProjectorSlice_(ProjectorEntry* projectorEntry, double time)
+{
+  if (isInterpolationEnabled() && projectorEntry->preferences()->interpolateprojectorfov())
+    projectorEntry->updates()->update(time, interpolator_);
+  else
+    projectorEntry->updates()->update(time);
 }
 
 void MemoryDataStore::updateLobGroups_(double time)
 {
-  //for each entry
+  if (updateThreads_ == nullptr)
+  {
+    //for each entry
+    for (LobGroups::iterator iter = lobGroups_.begin(); iter != lobGroups_.end(); ++iter)
+    {
+      updateLobGroupCommands_(iter->first, iter->second, time);
+      // update the slice
+      iter->second->updates()->update(time);
+    }
+    return;
+  }
+
   for (LobGroups::iterator iter = lobGroups_.begin(); iter != lobGroups_.end(); ++iter)
+    updateLobGroupCommands_(iter->first, iter->second, time);
+  parallelForEachEntry(*updateThreads_, lobGroups_, [time](LobGroups::value_type& entry) {
+    entry.second->updates()->update(time);
+  });
+}
+
+void MemoryDataStore::updateLobGroupCommands_(ObjectId id, LobGroupEntry* lobGroup, double time)
+{
+  // apply commands
+  lobGroup->commands()->update(this, id, time);
+
+  // check for changes in maxdatapoints or maxdataseconds prefs, memoryDataSlice processes these.
+  DataStore::Transaction tn;
+  const LobGroupPrefs* lobPrefs = lobGroupPrefs(id, &tn);
+  if (lobPrefs)
   {
-    // apply commands
-    iter->second->commands()->update(this, iter->first, time);
+    lobGroup->updates()->setMaxDataPoints(static_cast<size_t>(lobPrefs->maxdatapoints()));
+    lobGroup->updates()->setMaxDataSeconds(lobPrefs->maxdataseconds());
+  }
+}
+
+void MemoryDataStore::updateCategoryData_(double time, ListenerList& localCopy)
+{
+  std::vector<char> changed;
+  if (updateThreads_ != nullptr)
+  {
+    // Compute the changes in parallel, then notify in ID order below
+    changed.resize(categoryData_.size(), 0);
+    std::vector<MemoryCategoryDataSlice*> slices;
+    slices.reserve(categoryData_.size());
+    for (CategoryDataMap::const_iterator i = categoryData_.begin(); i != categoryData_.end(); ++i)
+      slices.push_back(i->second);
+    updateThreads_->parallelFor(slices.size(), [&slices, &changed, time](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k)
+        changed[k] = slices[k]->update(time) ? 1 : 0;
+    });
+  }
+
+  // for each category data slice
+  size_t index = 0;
+  for (CategoryDataMap::const_iterator i = categoryData_.begin(); i != categoryData_.end(); ++i, ++index)
+  {
+    // if something changed
+    const bool sliceChanged = changed.empty() ? i->second->update(time) : (changed[index] != 0);
+    if (!sliceChanged)
+      continue;
 
-    // check for changes in maxdatapoints or maxdataseconds prefs, memoryDataSlice processes these.
+    // send notification
+    const simData::ObjectType ot = objectType(i->first);
+    for (ListenerList::const_iterator j = localCopy.begin(); j != localCopy.end(); ++j)
     {
-      DataStore::Transaction tn;
-      const LobGroupPrefs* lobPrefs = lobGroupPrefs(iter->first, &tn);
-      if (lobPrefs)
+      if (*j != nullptr)
       {
-        iter->second->updates()->setMaxDataPoints(static_cast<size_t>(lobPrefs->maxdatapoints()));
-        iter->second->updates()->setMaxDataSeconds(lobPrefs->maxdataseconds());
+        (**j).onCategoryDataChange(this, i->first, ot);
+        checkForRemoval_(localCopy);
       }
     }
-
-    // update the slice
-    iter->second->updates()->update(time);
   }
 }
 
@@ -973,6 +1158,12 @@ simData::PlatformPrefs MemoryDataStore::defaultPlatformPrefs() const
 ///Update internal data to show 'time' as current
 void MemoryDataStore::update(double time)
 {
+  // Add the updates from other threads first so that they are visible in this update
+  if (ingestQueue_ != nullptr)
+    ingestQueue_->drain(*this);
+
+  // IDs changed by the previous update no longer apply
+  changedIds_.clear();
   if (!hasChanged_ && time == lastUpdateTime_)
     return;
 
@@ -985,31 +1176,23 @@ void MemoryDataStore::update(double time)
   // Need to handle recursion so make a local copy
   ListenerList localCopy = listeners_;
   justRemoved_.clear();
-  // for each category data slice
-  for (CategoryDataMap::const_iterator i = categoryData_.begin(); i != categoryData_.end(); ++i)
-  {
-    // if something changed
-    if (i->second->update(time))
-    {
-      // send notification
-      const simData::ObjectType ot = objectType(i->first);
-
-      for (ListenerList::const_iterator j = localCopy.begin(); j != localCopy.end(); ++j)
-      {
-        if (*j != nullptr)
-        {
-          (**j).onCategoryDataChange(this, i->first, ot);
-          checkForRemoval_(localCopy);
-        }
-      }
-    }
-  }
+  updateCategoryData_(time, localCopy);
 
   updateLasers_(time);
   updateProjectors_(time);
   updateLobGroups_(time);
   updateCustomRenderings_(time);
 
+  // Record which entities changed so that observers can limit their work to those entities
+  appendChangedIds(platforms_, changedIds_);
+  appendChangedIds(beams_, changedIds_);
+  appendChangedIds(gates_, changedIds_);
+  appendChangedIds(lasers_, changedIds_);
+  appendChangedIds(projectors_, changedIds_);
+  appendChangedIds(lobGroups_, changedIds_);
+  // IDs are unique across entity types, so a single sort restores ID order
+  std::sort(changedIds_.begin(), changedIds_.end());
+
   // After all the slice updates, set the new update time and notify observers
   lastUpdateTime_ = time;
   hasChanged_ = false;
@@ -1055,6 +1238,74 @@ bool MemoryDataStore::dataLimiting() const
   return dataLimiting_;
 }
 
+void MemoryDataStore::setPooledUpdateAllocation(bool pooled)
+{
+  if (pooledUpdates_ == pooled)
+    return;
+
+  pooledUpdates_ = pooled;
+  setPooledUpdateAllocation_(platforms_, pooled);
+  setPooledUpdateAllocation_(beams_, pooled);
+  setPooledUpdateAllocation_(gates_, pooled);
+  setPooledUpdateAllocation_(lasers_, pooled);
+  setPooledUpdateAllocation_(projectors_, pooled);
+  setPooledUpdateAllocation_(lobGroups_, pooled);
+  setPooledUpdateAllocation_(customRenderings_, pooled);
+}
+
+bool MemoryDataStore::pooledUpdateAllocation() const
+{
+  return pooledUpdates_;
+}
+
+void MemoryDataStore::setCommandSnapshotLimits(size_t commandInterval, double timeInterval, size_t maxSnapshots)
+{
+  commandSnapshotInterval_ = commandInterval;
+  commandSnapshotTimeInterval_ = timeInterval;
+  maxCommandSnapshots_ = maxSnapshots;
+  setCommandSnapshotLimits_(platforms_);
+  setCommandSnapshotLimits_(beams_);
+  setCommandSnapshotLimits_(gates_);
+  setCommandSnapshotLimits_(lasers_);
+  setCommandSnapshotLimits_(projectors_);
+  setCommandSnapshotLimits_(lobGroups_);
+  setCommandSnapshotLimits_(customRenderings_);
+}
+
+void MemoryDataStore::commandSnapshotLimits(size_t* commandInterval, double* timeInterval, size_t* maxSnapshots) const
+{
+  if (commandInterval)
+    *commandInterval = commandSnapshotInterval_;
+  if (timeInterval)
+    *timeInterval = commandSnapshotTimeInterval_;
+  if (maxSnapshots)
+    *maxSnapshots = maxCommandSnapshots_;
+}
+
+void MemoryDataStore::setIngestQueue(IngestQueue* queue)
+{
+  ingestQueue_ = queue;
+}
+
+IngestQueue* MemoryDataStore::ingestQueue() const
+{
+  return ingestQueue_;
+}
+
+void MemoryDataStore::setUpdateThreadCount(unsigned int numThreads)
+{
+  if (numThreads == updateThreadCount())
+    return;
+
+  delete updateThreads_;
+  updateThreads_ = (numThreads > 1) ? new simCore::ThreadPool(numThreads) : nullptr;
+}
+
+unsigned int MemoryDataStore::updateThreadCount() const
+{
+  return (updateThreads_ == nullptr) ? 1 : updateThreads_->numThreads();
+}
+
 void MemoryDataStore::flush(ObjectId flushId, FlushType flushType)
 {
   if (flushId == 0)
@@ -1248,6 +1499,11 @@ void MemoryDataStore::idList(IdList *ids, simData::ObjectType type) const
 }
 
 /// Retrieve a list of IDs for objects of 'type' with the given name
+void MemoryDataStore::changedIdList(IdList* ids) const
+{
+  ids->insert(ids->end(), changedIds_.begin(), changedIds_.end());
+}
+
 void MemoryDataStore::idListByName(const std::string& name, IdList* ids, simData::ObjectType type) const
 {
   // If null someone is call this routine before entityNameCache_ is made in the constructor
@@ -2062,15 +2318,51 @@ PlatformUpdate* MemoryDataStore::addPlatformUpdate(ObjectId id, Transaction *tra
     return nullptr;
   }
 
-  PlatformUpdate *update = new PlatformUpdate();
-
   // Setup transaction
   MemoryDataSlice<PlatformUpdate> *slice = entry->updates();
+  PlatformUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<PlatformUpdate, MemoryDataSlice<PlatformUpdate> >(update, slice, this, id, true));
 
   return update;
 }
 
+int MemoryDataStore::addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates)
+{
+  PlatformEntry *entry = getEntry<PlatformEntry, Platforms>(id, &platforms_);
+  if (!entry)
+    return 1;
+  if (updates.empty())
+    return 0;
+
+  MemoryDataSlice<PlatformUpdate> *slice = entry->updates();
+  std::vector<PlatformUpdate*> newUpdates;
+  newUpdates.reserve(updates.size());
+  double earliest = std::numeric_limits<double>::max();
+  double latest = -std::numeric_limits<double>::max();
+  for (std::vector<PlatformUpdate>::const_iterator iter = updates.begin(); iter != updates.end(); ++iter)
+  {
+    PlatformUpdate *update = slice->newUpdate();
+    *update = *iter;
+    newUpdates.push_back(update);
+    earliest = simCore::sdkMin(earliest, iter->time());
+    latest = simCore::sdkMax(latest, iter->time());
+  }
+  slice->insertBatch(newUpdates);
+
+  // Same post-processing as NewUpdateTransactionImpl::commit(), once for the whole batch
+  if (dataLimiting())
+  {
+    Transaction t;
+    const CommonPrefs* prefs = commonPrefs(id, &t);
+    slice->limitByPrefs(*prefs);
+  }
+  hasChanged_ = true;
+  newUpdatesListener().onEntityUpdate(this, id, earliest);
+  if (latest != earliest)
+    newUpdatesListener().onEntityUpdate(this, id, latest);
+  return 0;
+}
+
 ///@return nullptr if platform for specified 'id' does not exist
 PlatformCommand *MemoryDataStore::addPlatformCommand(ObjectId id, Transaction *transaction)
 {
@@ -2103,10 +2395,9 @@ BeamUpdate* MemoryDataStore::addBeamUpdate(ObjectId id, Transaction *transaction
     return nullptr;
   }
 
-  BeamUpdate *update = new BeamUpdate();
-
   // Setup transaction
   MemoryDataSlice<BeamUpdate> *slice = entry->updates();
+  BeamUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<BeamUpdate, MemoryDataSlice<BeamUpdate> >(update, slice, this, id, true));
 
   return update;
@@ -2144,10 +2435,9 @@ GateUpdate* MemoryDataStore::addGateUpdate(ObjectId id, Transaction *transaction
     return nullptr;
   }
 
-  GateUpdate *update = new GateUpdate();
-
   // Setup transaction
   MemoryDataSlice<GateUpdate> *slice = entry->updates();
+  GateUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<GateUpdate, MemoryDataSlice<GateUpdate> >(update, slice, this, id, true));
 
   return update;
@@ -2185,10 +2475,9 @@ LaserUpdate* MemoryDataStore::addLaserUpdate(ObjectId id, Transaction *transacti
     return nullptr;
   }
 
-  LaserUpdate *update = new LaserUpdate();
-
   // Setup transaction
   MemoryDataSlice<LaserUpdate> *slice = entry->updates();
+  LaserUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<LaserUpdate, MemoryDataSlice<LaserUpdate> >(update, slice, this, id, true));
 
   return update;
@@ -2226,10 +2515,9 @@ ProjectorUpdate* MemoryDataStore::addProjectorUpdate(ObjectId id, Transaction *t
     return nullptr;
   }
 
-  ProjectorUpdate *update = new ProjectorUpdate();
-
   // Setup transaction
   MemoryDataSlice<ProjectorUpdate> *slice = entry->updates();
+  ProjectorUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<ProjectorUpdate, MemoryDataSlice<ProjectorUpdate> >(update, slice, this, id, true));
 
   return update;
@@ -2267,10 +2555,9 @@ LobGroupUpdate* MemoryDataStore::addLobGroupUpdate(ObjectId id, Transaction *tra
     return nullptr;
   }
 
-  LobGroupUpdate *update = new LobGroupUpdate();
-
   // Setup transaction
   MemoryDataSlice<LobGroupUpdate> *slice = entry->updates();
+  LobGroupUpdate *update = slice->newUpdate();
   *transaction = Transaction(new NewUpdateTransactionImpl<LobGroupUpdate, MemoryDataSlice<LobGroupUpdate> >(update, slice, this, id, true));
 
   return update;
@@ -2595,6 +2882,20 @@ void MemoryDataStore::deleteEntries_(EntryMapType *entries)
   entries->clear();
 }
 
+template <typename EntryMapType>
+void MemoryDataStore::setPooledUpdateAllocation_(std::map<ObjectId, EntryMapType*>& entryMap, bool pooled)
+{
+  for (typename std::map<ObjectId, EntryMapType*>::const_iterator iter = entryMap.begin(); iter != entryMap.end(); ++iter)
+    iter->second->updates()->setPooledAllocation(pooled);
+}
+
+template <typename EntryMapType>
+void MemoryDataStore::setCommandSnapshotLimits_(std::map<ObjectId, EntryMapType*>& entryMap)
+{
+  for (typename std::map<ObjectId, EntryMapType*>::const_iterator iter = entryMap.begin(); iter != entryMap.end(); ++iter)
+    iter->second->commands()->setSnapshotLimits(commandSnapshotInterval_, commandSnapshotTimeInterval_, maxCommandSnapshots_);
+}
+
 template <typename EntryMapType>
 void MemoryDataStore::dataLimit_(std::map<ObjectId, EntryMapType* >& entryMap, ObjectId id, const CommonPrefs* prefs)
 {
@@ -2625,24 +2926,27 @@ MemoryDataStore::MutableSettingsTransactionImpl<T>::MutableSettingsTransactionIm
 template<typename T>
 void MemoryDataStore::MutableSettingsTransactionImpl<T>::commit()
 {
-  // performance: skip if there are no changes
-  if (modifiedSettings_->SerializeAsString() != currentSettings_->SerializeAsString())
+  // check for name change, if shown or alias change, if shown or change for show name to/from show alias; must be done before the copy
+  const bool nameChange = ((!modifiedSettings_->commonprefs().usealias() && modifiedSettings_->commonprefs().name() != currentSettings_->commonprefs().name()) ||
+    (modifiedSettings_->commonprefs().usealias() && modifiedSettings_->commonprefs().alias() != currentSettings_->commonprefs().alias()) ||
+    (modifiedSettings_->commonprefs().usealias() != currentSettings_->commonprefs().usealias()));
+  const std::string oldName = nameChange ? currentSettings_->commonprefs().name() : std::string();
+
+  // copy the settings modified by the user into the entity settings; performance: only the changed fields are copied
+  FieldList changedFields;
+  if (simData::protobuf::copyChangedFields(*modifiedSettings_, *currentSettings_, &changedFields))
   {
     committed_ = true; // transaction is valid
+    addChangedFields(changedFields, changedFields_);
 
-    // check for name change, if shown or alias change, if shown or change for show name to/from show alias
-    if ((!modifiedSettings_->commonprefs().usealias() && modifiedSettings_->commonprefs().name() != currentSettings_->commonprefs().name()) ||
-        (modifiedSettings_->commonprefs().usealias() && modifiedSettings_->commonprefs().alias() != currentSettings_->commonprefs().alias()) ||
-        (modifiedSettings_->commonprefs().usealias() != currentSettings_->commonprefs().usealias()))
+    if (nameChange)
     {
-      oldName_ = currentSettings_->commonprefs().name();
+      oldName_ = oldName;
       newName_ = modifiedSettings_->commonprefs().name();
       // even if oldName and newName match a name change has occurred since displayed name can be switching between name and alias
       nameChange_ = true;
     }
 
-    // copy the settings modified by the user into the entity settings
-    currentSettings_->CopyFrom(*modifiedSettings_);
     // now apply data limiting.  Will apply for Prefs and Properties changes
     store_->applyDataLimiting_(id_);
     store_->hasChanged_ = true;
@@ -2669,7 +2973,7 @@ void MemoryDataStore::MutableSettingsTransactionImpl<T>::release()
     {
       if (*i != nullptr)
       {
-        (*i)->onPrefsChange(store_, id_);
+        (*i)->onPrefsFieldsChange(store_, id_, changedFields_);
         store_->checkForRemoval_(localCopy);
         if ((*i != nullptr) && (nameChange_))
         {
@@ -2707,13 +3011,12 @@ MemoryDataStore::MutablePropertyTransactionImpl<T>::MutablePropertyTransactionIm
 template<typename T>
 void MemoryDataStore::MutablePropertyTransactionImpl<T>::commit()
 {
-  // performance: skip if there are no changes
-  if (modifiedProperties_->SerializeAsString() != currentProperties_->SerializeAsString())
+  // copy the properties modified by the user into the entity properties; performance: only the changed fields are copied
+  FieldList changedFields;
+  if (simData::protobuf::copyChangedFields(*modifiedProperties_, *currentProperties_, &changedFields))
   {
     committed_ = true; // transaction is valid
-
-    // copy the settings modified by the user into the entity settings
-    currentProperties_->CopyFrom(*modifiedProperties_);
+    addChangedFields(changedFields, changedFields_);
     store_->hasChanged_ = true;
   }
 }
@@ -2735,7 +3038,7 @@ void MemoryDataStore::MutablePropertyTransactionImpl<T>::release()
     {
       if (*i != nullptr)
       {
-        (*i)->onPropertiesChange(store_, id_);
+        (*i)->onPropertiesFieldsChange(store_, id_, changedFields_);
         store_->checkForRemoval_(localCopy);
       }
     }
@@ -2766,13 +3069,10 @@ MemoryDataStore::ScenarioSettingsTransactionImpl::ScenarioSettingsTransactionImp
 /// to the internal data structure
 void MemoryDataStore::ScenarioSettingsTransactionImpl::commit()
 {
-  // performance: skip if there are no changes
-  if (modifiedSettings_->SerializeAsString() != currentSettings_->SerializeAsString())
+  // copy the settings modified by the user into the scenario settings; performance: only the changed fields are copied
+  if (simData::protobuf::copyChangedFields(*modifiedSettings_, *currentSettings_, nullptr))
   {
     committed_ = true; // transaction is valid
-
-    // copy the settings modified by the user into the entity settings
-    currentSettings_->CopyFrom(*modifiedSettings_);
     store_->hasChanged_ = true;
   }
 }
@@ -2820,6 +3120,8 @@ void MemoryDataStore::NewEntryTransactionImpl<T, P>::commit()
     // assign default pref values
     P* mutablePrefs = entry_->mutable_preferences();
     mutablePrefs->CopyFrom(*defaultPrefs_);
+    entry_->updates()->setPooledAllocation(store_->pooledUpdates_);
+    entry_->commands()->setSnapshotLimits(store_->commandSnapshotInterval_, store_->commandSnapshotTimeInterval_, store_->maxCommandSnapshots_);
 
     typename std::map<ObjectId, T*>::iterator i = entries_->find(entry_->properties()->id());
     if (i == entries_->end())
@@ -2937,11 +3239,23 @@ void MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::release()
   if (!committed_)
   {
     // Delete the uncommitted update
-    delete update_;
+    deleteUpdate_(typename std::is_base_of<MemoryDataSlice<T>, SliceType>::type());
     update_ = nullptr;
   }
 }
 
+template <typename T, typename SliceType>
+void MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::deleteUpdate_(std::true_type isMemoryDataSlice)
+{
+  slice_->deleteUpdate(update_);
+}
+
+template <typename T, typename SliceType>
+void MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::deleteUpdate_(std::false_type isMemoryDataSlice)
+{
+  delete update_;
+}
+
 template <typename T, typename SliceType>
 MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::~NewUpdateTransactionImpl()
 {
@@ -25,15 +25,20 @@
 
 #include <map>
 #include <string>
+#include <type_traits>
 #include "simData/MemoryDataEntry.h"
 #include "simData/DataStore.h"
 
-namespace simCore { class Clock; }
+namespace simCore {
+  class Clock;
+  class ThreadPool;
+}
 
 namespace simData {
 
 class EntityNameCache;
 class GenericDataSlice;
+class IngestQueue;
 class MemoryCategoryDataSlice;
 class NewRowDataToNewUpdatesAdapter;
 namespace MemoryTable { class DataLimitsProvider; }
@@ -134,6 +139,9 @@ public:
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const;
 
+  /// Retrieve the IDs of entities whose update slice changed in the most recent update()
+  virtual void changedIdList(IdList* ids) const;
+
   /// Retrieve a list of IDs for all beams associated with a platform
   virtual void beamIdListForHost(ObjectId hostid, IdList *ids) const;
 
@@ -268,6 +276,9 @@ public:
   //virtual TableData *addTableData(ObjectId id, Transaction *transaction);
   ///@}
 
+  /// @copydoc simData::DataStore::addPlatformUpdates
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates);
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
@@ -342,6 +353,54 @@ public:
    */
   virtual DataTableManager& dataTableManager() const;
 
+  /**
+   * Enables or disables pooled allocation of entity updates.  When enabled, each update slice
+   * allocates its updates from a chunked UpdatePool instead of one heap allocation per update,
+   * and data limiting and flushing return memory to the system a chunk at a time.  Applies to
+   * existing and future entities; updates already in the data store are unaffected.
+   * @param pooled True to allocate updates from per-slice pools
+   */
+  void setPooledUpdateAllocation(bool pooled);
+
+  /// returns flag indicating if updates are allocated from per-slice pools
+  bool pooledUpdateAllocation() const;
+
+  /**
+   * Sets the number of threads used to update entity slices in update(double).  With more than
+   * one thread, commands are applied on the calling thread first, then the update slices and
+   * category data of each entity type are updated in parallel.  Listeners are always notified on
+   * the calling thread, in the same order as a serial update.  The interpolator must be safe to
+   * call from multiple threads; the interpolators in simData are.
+   * @param numThreads Number of threads including the calling thread; 0 or 1 updates serially (default)
+   */
+  void setUpdateThreadCount(unsigned int numThreads);
+
+  /// returns the number of threads used to update entity slices in update(double)
+  unsigned int updateThreadCount() const;
+
+  /**
+   * Configures the command state snapshots that command slices use to speed up backward time
+   * seeks; see MemoryCommandSlice::setSnapshotLimits().  Applies to existing and future entities.
+   * Defaults to a snapshot every 100 commands, no time interval, and at most 32 snapshots.
+   * @param commandInterval Number of commands between snapshots; 0 disables the command trigger
+   * @param timeInterval Seconds of scenario time between snapshots; 0 disables the time trigger
+   * @param maxSnapshots Maximum number of snapshots per command slice; 0 disables snapshots
+   */
+  void setCommandSnapshotLimits(size_t commandInterval, double timeInterval, size_t maxSnapshots);
+
+  /** Retrieves the values from setCommandSnapshotLimits(); any parameter may be nullptr */
+  void commandSnapshotLimits(size_t* commandInterval, double* timeInterval, size_t* maxSnapshots) const;
+
+  /**
+   * Attaches a queue whose updates are added to the data store at the start of each update(double),
+   * before any slice is updated.  Producer threads may push to the queue at any time.
+   * @param queue Queue to drain; not owned, and must outlive the data store or be detached with nullptr
+   */
+  void setIngestQueue(IngestQueue* queue);
+
+  /// returns the attached ingest queue, or nullptr if none
+  IngestQueue* ingestQueue() const;
+
 protected:
   /// generate a unique id
   ObjectId genUniqueId_();
@@ -357,6 +416,14 @@ private:
 
   template <typename EntryMapType>
   void dataLimit_(std::map<ObjectId, EntryMapType*>& entryMap, ObjectId id, const CommonPrefs* prefs);
+
+  /// apply the pooled allocation flag to the update slices of all entries in a map
+  template <typename EntryMapType>
+  void setPooledUpdateAllocation_(std::map<ObjectId, EntryMapType*>& entryMap, bool pooled);
+
+  /// apply the command snapshot limits to the command slices of all entries in a map
+  template <typename EntryMapType>
+  void setCommandSnapshotLimits_(std::map<ObjectId, EntryMapType*>& entryMap);
   ///@}
 
   /// Execute the onPostRemoveEntity callback
@@ -407,6 +474,8 @@ public:
 
 private:
   class MemoryInternalsMemento;
+  /// Saves and restores the data store's internals directly
+  friend class MemoryDataStoreSnapshot;
 
   // Implementation of transactions for this data store
 
@@ -448,6 +517,7 @@ private:
     bool nameChange_;                             ///< Determine if a name change has occurred
     std::string oldName_;                         ///< Old entity name
     std::string newName_;                         ///< New entity name
+    FieldList changedFields_;                     ///< Fields changed by all commits of this transaction
     T *currentSettings_;                          ///< Pointer to current settings object stored by DataStore; Will not be modified until the transaction is committed
     T *modifiedSettings_;                         ///< The mutable settings object provided to the transaction initiator for modification
     MemoryDataStore *store_;
@@ -480,6 +550,7 @@ private:
     ObjectId id_;                                 ///< Id of entry associated with the transaction (to be provided to observers on entry change notification)
     bool committed_;                              ///< The changes have been committed to the data structure
     bool notified_;                               ///< Observers have been notified of the entry's modification
+    FieldList changedFields_;                     ///< Fields changed by all commits of this transaction
     T *currentProperties_;                        ///< Pointer to current properties object stored by DataStore; Will not be modified until the transaction is committed
     T *modifiedProperties_;                       ///< The mutable properties object provided to the transaction initiator for modification
     MemoryDataStore *store_;
@@ -584,6 +655,10 @@ private:
   private:
     /// Responsible for performing the actual insert(), prior to data limiting.
     void insert_();
+    /// Frees an uncommitted update through the allocator of a MemoryDataSlice
+    void deleteUpdate_(std::true_type isMemoryDataSlice);
+    /// Frees an uncommitted update that was allocated on the heap
+    void deleteUpdate_(std::false_type isMemoryDataSlice);
 
     bool       committed_; // The update has been added to the data structure
     T         *update_;
@@ -632,10 +707,14 @@ private:
 private:
   /// Updates all the platforms
   void updatePlatforms_(double time);
+  /// Updates the update slice of a platform whose commands have been applied
+  void updatePlatformSlice_(PlatformEntry* platform, double time, bool fileMode);
   /// Updates a target beam
   void updateTargetBeam_(ObjectId id, BeamEntry* beam, double time);
   /// Updates all the beams
   void updateBeams_(double time);
+  /// Updates the update slice of a beam whose commands have been applied
+  void updateBeamSlice_(ObjectId id, BeamEntry* beam, double time);
   ///Gets the beam that corresponds to specified gate
   BeamEntry* getBeamForGate_(google::protobuf::uint64 gateID);
   /// Updates a target gate
@@ -650,12 +729,22 @@ private:
 
   /// Updates all the gates
   void updateGates_(double time);
+  /// Updates the update slice of a gate whose commands have been applied
+  void updateGateSlice_(GateEntry* gate, double time);
   /// Updates all the lasers
   void updateLasers_(double time);
+  /// Updates the update slice of a laser whose commands have been applied
+  void updateLaserSlice_(LaserEntry* laser, double time);
   /// Updates all the projectors
   void updateProjectors_(double time);
+  /// Updates the update slice of a projector whose commands have been applied
+  void updateProjectorSlice_(ProjectorEntry* projector, double time);
   /// Updates all the LobGroups
   void updateLobGroups_(double time);
+  /// Applies commands and data point limits for a LobGroup, before its slice is updated
+  void updateLobGroupCommands_(ObjectId id, LobGroupEntry* lobGroup, double time);
+  /// Updates all the category data slices, notifying listeners of changes
+  void updateCategoryData_(double time, ListenerList& localCopy);
   ///Updates all the CustomRenderings
   void updateCustomRenderings_(double time);
   /// Flushes an entity based on the given scope, fields and time ranges
@@ -680,6 +769,7 @@ private:
   ObjectId baseId_;          // Used for unique ID generation
   double   lastUpdateTime_;  // Last time sent to update(double)
   bool     hasChanged_; // has something changed since last update
+  IdList   changedIds_; // entities whose update slices changed in the last update, in ID order
 
   // interpolation
   bool          interpolationEnabled_;
@@ -714,6 +804,18 @@ private:
   NewUpdatesListenerPtr newUpdatesListener_;
   /// Flag indicating if data limiting is set
   bool dataLimiting_;
+  /// Flag indicating if updates are allocated from per-slice pools
+  bool pooledUpdates_;
+  /// Threads for parallel slice updates; nullptr when updating serially
+  simCore::ThreadPool* updateThreads_;
+  /// Number of commands between command state snapshots
+  size_t commandSnapshotInterval_;
+  /// Seconds between command state snapshots
+  double commandSnapshotTimeInterval_;
+  /// Maximum number of command state snapshots per command slice
+  size_t maxCommandSnapshots_;
+  /// Queue of updates from other threads, drained in update(); not owned
+  IngestQueue* ingestQueue_;
   /// The CategoryNameManager coordinates string/int values
   CategoryNameManager* categoryNameManager_;
   /// Correlates data store preferences to limit values for the table manager
@@ -0,0 +1,848 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <vector>
+#include "simCore/Common/MappedFile.h"
+#include "simCore/String/UtfUtils.h"
+#include "simData/CategoryData/MemoryCategoryDataSlice.h"
+#include "simData/DataTable.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/MemoryGenericDataSlice.h"
+#include "simData/MemoryDataStoreSnapshot.h"
+
+namespace simData
+{
+
+namespace
+{
+  /// Identifies a snapshot file
+  const char SNAPSHOT_MAGIC[8] = { 'S', 'I', 'M', 'D', 'S', 'N', 'A', 'P' };
+  /// Written in native byte order, so that files from a machine with another byte order are detected
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+  /// Record payloads are padded to a multiple of this size, keeping records aligned in the mapped file
+  const uint64_t RECORD_ALIGNMENT = 8;
+  /// Size of a packed platform update: time, x, y, z as doubles; psi, theta, phi, vx, vy, vz as floats
+  const size_t PLATFORM_UPDATE_SIZE = 4 * sizeof(double) + 6 * sizeof(float);
+
+  /// Types of records in a snapshot file
+  enum RecordType
+  {
+    RECORD_END = 0,  ///< Last record in the file; no payload
+    RECORD_SCENARIO_PROPERTIES,  ///< Serialized ScenarioProperties
+    RECORD_PROPERTIES,  ///< Serialized entity properties; creates the entity
+    RECORD_PREFERENCES,  ///< Serialized entity preferences
+    RECORD_UPDATES,  ///< Entity updates; packed for platforms, length prefixed messages otherwise
+    RECORD_COMMANDS,  ///< Length prefixed entity commands
+    RECORD_GENERIC_DATA,  ///< Length prefixed generic data; ID 0 is the scenario
+    RECORD_CATEGORY_DATA,  ///< Length prefixed category data
+    RECORD_DATA_TABLE  ///< Table name, columns and rows of one data table; ID is the owner
+  };
+
+  /// Start of the file
+  struct FileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t baseId;  ///< Last ID generated by the data store
+  };
+
+  /// Precedes each record's payload
+  struct RecordHeader
+  {
+    uint32_t type;
+    uint32_t objectType;
+    uint64_t id;
+    uint64_t size;  ///< Payload size, not including padding
+  };
+
+  /** Returns the number of padding bytes following a payload of the given size */
+  uint64_t paddingSize(uint64_t size)
+  {
+    return (RECORD_ALIGNMENT - (size % RECORD_ALIGNMENT)) % RECORD_ALIGNMENT;
+  }
+
+  //----------------------------------------------------------------------------
+  /** Accumulates the payload of one record */
+  class PayloadBuffer
+  {
+  public:
+    /** Appends a value in native byte order */
+    template <typename T>
+    void put(T value)
+    {
+      data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /** Appends a length prefixed string */
+    void putString(const std::string& value)
+    {
+      put(static_cast<uint32_t>(value.size()));
+      data_.append(value);
+    }
+
+    /** Appends a length prefixed serialized message */
+    template <typename T>
+    void putMessage(const T& message)
+    {
+      message.SerializeToString(&scratch_);
+      putString(scratch_);
+    }
+
+    /** Returns the payload */
+    const std::string& data() const { return data_; }
+
+    /** Discards the payload, keeping its storage */
+    void clear() { data_.clear(); }
+
+  private:
+    std::string data_;
+    std::string scratch_;
+  };
+
+  /** Writes records to the output stream */
+  class RecordWriter
+  {
+  public:
+    explicit RecordWriter(std::ostream& out)
+      : out_(out)
+    {
+    }
+
+    /** Writes a record holding the given payload */
+    void write(RecordType type, ObjectType objectType, ObjectId id, const std::string& payload)
+    {
+      static const char PADDING[RECORD_ALIGNMENT] = { 0 };
+      RecordHeader header;
+      header.type = type;
+      header.objectType = static_cast<uint32_t>(objectType);
+      header.id = id;
+      header.size = payload.size();
+      out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out_.write(payload.data(), payload.size());
+      out_.write(PADDING, paddingSize(payload.size()));
+    }
+
+    /** Writes a record holding a single serialized message, without a length prefix */
+    template <typename T>
+    void writeMessage(RecordType type, ObjectType objectType, ObjectId id, const T& message)
+    {
+      message.SerializeToString(&scratch_);
+      write(type, objectType, id, scratch_);
+    }
+
+  private:
+    std::ostream& out_;
+    std::string scratch_;
+  };
+
+  /** Appends each visited message to a payload */
+  template <typename VisitorType, typename T>
+  class MessageCollector : public VisitorType
+  {
+  public:
+    explicit MessageCollector(PayloadBuffer& buffer)
+      : buffer_(buffer)
+    {
+    }
+
+    virtual void operator()(const T* message)
+    {
+      buffer_.putMessage(*message);
+    }
+
+  private:
+    PayloadBuffer& buffer_;
+  };
+
+  /** Appends each visited platform update to a payload as a packed record */
+  class PlatformUpdateCollector : public DataSlice<PlatformUpdate>::Visitor
+  {
+  public:
+    explicit PlatformUpdateCollector(PayloadBuffer& buffer)
+      : buffer_(buffer)
+    {
+    }
+
+    virtual void operator()(const PlatformUpdate* update)
+    {
+      buffer_.put(update->time());
+      buffer_.put(update->x());
+      buffer_.put(update->y());
+      buffer_.put(update->z());
+      buffer_.put(static_cast<float>(update->psi()));
+      buffer_.put(static_cast<float>(update->theta()));
+      buffer_.put(static_cast<float>(update->phi()));
+      buffer_.put(static_cast<float>(update->vx()));
+      buffer_.put(static_cast<float>(update->vy()));
+      buffer_.put(static_cast<float>(update->vz()));
+    }
+
+  private:
+    PayloadBuffer& buffer_;
+  };
+
+  /** Writes the update slice of an entity */
+  template <typename T>
+  void saveUpdates(RecordWriter& writer, PayloadBuffer& buffer, ObjectType objectType, ObjectId id, const DataSlice<T>* slice)
+  {
+    buffer.clear();
+    MessageCollector<typename DataSlice<T>::Visitor, T> collector(buffer);
+    slice->visit(&collector);
+    if (!buffer.data().empty())
+      writer.write(RECORD_UPDATES, objectType, id, buffer.data());
+  }
+
+  /** Writes the update slice of a platform */
+  void saveUpdates(RecordWriter& writer, PayloadBuffer& buffer, ObjectType objectType, ObjectId id, const DataSlice<PlatformUpdate>* slice)
+  {
+    buffer.clear();
+    PlatformUpdateCollector collector(buffer);
+    slice->visit(&collector);
+    if (!buffer.data().empty())
+      writer.write(RECORD_UPDATES, objectType, id, buffer.data());
+  }
+
+  /** Writes the command slice of an entity */
+  template <typename CommandType, typename PrefType>
+  void saveCommands(RecordWriter& writer, PayloadBuffer& buffer, ObjectType objectType, ObjectId id, const MemoryCommandSlice<CommandType, PrefType>* slice)
+  {
+    buffer.clear();
+    MessageCollector<typename DataSlice<CommandType>::Visitor, CommandType> collector(buffer);
+    slice->visit(&collector);
+    if (!buffer.data().empty())
+      writer.write(RECORD_COMMANDS, objectType, id, buffer.data());
+  }
+
+  /** Writes the properties, preferences, updates and commands of each entry */
+  template <typename EntryType>
+  void saveEntries(RecordWriter& writer, PayloadBuffer& buffer, ObjectType objectType, const std::map<ObjectId, EntryType*>& entries)
+  {
+    for (typename std::map<ObjectId, EntryType*>::const_iterator i = entries.begin(); i != entries.end(); ++i)
+    {
+      EntryType* entry = i->second;
+      writer.writeMessage(RECORD_PROPERTIES, objectType, i->first, *entry->properties());
+      writer.writeMessage(RECORD_PREFERENCES, objectType, i->first, *entry->preferences());
+      saveUpdates(writer, buffer, objectType, i->first, entry->updates());
+
+      saveCommands(writer, buffer, objectType, i->first, entry->commands());
+    }
+  }
+
+  /** Appends the column definitions of a table to a payload */
+  class ColumnWriter : public DataTable::ColumnVisitor
+  {
+  public:
+    explicit ColumnWriter(PayloadBuffer& buffer)
+      : buffer_(buffer)
+    {
+    }
+
+    virtual void visit(TableColumn* column)
+    {
+      buffer_.put(static_cast<int64_t>(column->columnId()));
+      buffer_.put(static_cast<uint32_t>(column->variableType()));
+      buffer_.put(static_cast<int32_t>(column->unitType()));
+      buffer_.putString(column->name());
+    }
+
+  private:
+    PayloadBuffer& buffer_;
+  };
+
+  /** Appends the cells of a row to a payload, each as a column ID and a value */
+  class CellWriter : public TableRow::CellVisitor
+  {
+  public:
+    explicit CellWriter(PayloadBuffer& buffer)
+      : buffer_(buffer)
+    {
+    }
+
+    virtual void visit(TableColumnId columnId, uint8_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, int8_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, uint16_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, int16_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, uint32_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, int32_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, uint64_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, int64_t value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, float value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, double value) { putCell_(columnId, value); }
+    virtual void visit(TableColumnId columnId, const std::string& value)
+    {
+      buffer_.put(static_cast<int64_t>(columnId));
+      buffer_.putString(value);
+    }
+
+  private:
+    template <typename T>
+    void putCell_(TableColumnId columnId, T value)
+    {
+      buffer_.put(static_cast<int64_t>(columnId));
+      buffer_.put(value);
+    }
+
+    PayloadBuffer& buffer_;
+  };
+
+  /** Appends each row of a table to a payload */
+  class RowWriter : public DataTable::RowVisitor
+  {
+  public:
+    explicit RowWriter(PayloadBuffer& buffer)
+      : buffer_(buffer),
+        cellWriter_(buffer)
+    {
+    }
+
+    virtual VisitReturn visit(const TableRow& row)
+    {
+      buffer_.put(row.time());
+      buffer_.put(static_cast<uint32_t>(row.cellCount()));
+      row.accept(cellWriter_);
+      return VISIT_CONTINUE;
+    }
+
+  private:
+    PayloadBuffer& buffer_;
+    CellWriter cellWriter_;
+  };
+
+  /** Writes a record for each visited table */
+  class TableWriter : public TableList::Visitor
+  {
+  public:
+    TableWriter(RecordWriter& writer, PayloadBuffer& buffer)
+      : writer_(writer),
+        buffer_(buffer)
+    {
+    }
+
+    virtual void visit(DataTable* table)
+    {
+      buffer_.clear();
+      buffer_.putString(table->tableName());
+      buffer_.put(static_cast<uint32_t>(table->columnCount()));
+      ColumnWriter columnWriter(buffer_);
+      table->accept(columnWriter);
+      RowWriter rowWriter(buffer_);
+      table->accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), rowWriter);
+      writer_.write(RECORD_DATA_TABLE, NONE, table->ownerId(), buffer_.data());
+    }
+
+  private:
+    RecordWriter& writer_;
+    PayloadBuffer& buffer_;
+  };
+
+  /** Bounds checked sequential reads from a block of memory; get functions return 0 on success */
+  class PayloadReader
+  {
+  public:
+    PayloadReader(const char* data, size_t size)
+      : pos_(data),
+        end_(data + size)
+    {
+    }
+
+    /** Returns true if all bytes have been read */
+    bool atEnd() const { return pos_ == end_; }
+    /** Returns the number of unread bytes */
+    size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+
+    /** Reads a value in native byte order */
+    template <typename T>
+    int get(T& value)
+    {
+      if (remaining() < sizeof(T))
+        return 1;
+      memcpy(&value, pos_, sizeof(T));
+      pos_ += sizeof(T);
+      return 0;
+    }
+
+    /** Returns a pointer to the next size bytes without copying them */
+    int getBlock(const char*& data, size_t size)
+    {
+      if (remaining() < size)
+        return 1;
+      data = pos_;
+      pos_ += size;
+      return 0;
+    }
+
+    /** Returns a pointer to a length prefixed block without copying it */
+    int getBytes(const char*& data, uint32_t& size)
+    {
+      if (get(size) != 0)
+        return 1;
+      return getBlock(data, size);
+    }
+
+    /** Reads a length prefixed string */
+    int getString(std::string& value)
+    {
+      const char* data = nullptr;
+      uint32_t size = 0;
+      if (getBytes(data, size) != 0)
+        return 1;
+      value.assign(data, size);
+      return 0;
+    }
+
+    /** Parses a length prefixed message */
+    template <typename T>
+    int getMessage(T& message)
+    {
+      const char* data = nullptr;
+      uint32_t size = 0;
+      if (getBytes(data, size) != 0)
+        return 1;
+      return message.ParseFromArray(data, static_cast<int>(size)) ? 0 : 1;
+    }
+
+  private:
+    const char* pos_;
+    const char* end_;
+  };
+
+  /** Creates an entity from its serialized properties; the data store's next generated ID must be the saved ID */
+  template <typename PropertiesType>
+  int addEntity(MemoryDataStore& dataStore, PropertiesType* (MemoryDataStore::*addFunc)(DataStore::Transaction*), ObjectId id, const char* data, size_t size)
+  {
+    // Parse first, so that a malformed record does not leave a partially added entity behind
+    PropertiesType saved;
+    if (!saved.ParseFromArray(data, static_cast<int>(size)) || saved.id() != id)
+      return 1;
+
+    DataStore::Transaction transaction;
+    PropertiesType* properties = (dataStore.*addFunc)(&transaction);
+    if (properties == nullptr || properties->id() != id)
+      return 1;
+    properties->CopyFrom(saved);
+    transaction.complete(&properties);
+    return 0;
+  }
+
+  /** Replaces the preferences of an entity with serialized preferences */
+  template <typename PrefsType>
+  int setPrefs(MemoryDataStore& dataStore, PrefsType* (MemoryDataStore::*mutablePrefs)(ObjectId, DataStore::Transaction*), ObjectId id, const char* data, size_t size)
+  {
+    PrefsType saved;
+    if (!saved.ParseFromArray(data, static_cast<int>(size)))
+      return 1;
+
+    DataStore::Transaction transaction;
+    PrefsType* prefs = (dataStore.*mutablePrefs)(id, &transaction);
+    if (prefs == nullptr)
+      return 1;
+    prefs->CopyFrom(saved);
+    transaction.complete(&prefs);
+    return 0;
+  }
+
+  /** Inserts length prefixed updates into an update slice */
+  template <typename T>
+  int loadUpdates(MemoryDataSlice<T>* slice, PayloadReader& reader)
+  {
+    while (!reader.atEnd())
+    {
+      T* update = slice->newUpdate();
+      if (reader.getMessage(*update) != 0)
+      {
+        slice->deleteUpdate(update);
+        return 1;
+      }
+      slice->insert(update);
+    }
+    return 0;
+  }
+
+  /** Inserts packed platform updates into a platform update slice */
+  int loadUpdates(MemoryDataSlice<PlatformUpdate>* slice, PayloadReader& reader)
+  {
+    if (reader.remaining() % PLATFORM_UPDATE_SIZE != 0)
+      return 1;
+
+    std::vector<PlatformUpdate*> updates;
+    updates.reserve(reader.remaining() / PLATFORM_UPDATE_SIZE);
+    while (!reader.atEnd())
+    {
+      double time;
+      double position[3];
+      float orientation[3];
+      float velocity[3];
+      // Size was validated above, so these reads cannot fail
+      reader.get(time);
+      reader.get(position);
+      reader.get(orientation);
+      reader.get(velocity);
+
+      PlatformUpdate* update = slice->newUpdate();
+      update->set_time(time);
+      update->set_x(position[0]);
+      update->set_y(position[1]);
+      update->set_z(position[2]);
+      update->set_psi(orientation[0]);
+      update->set_theta(orientation[1]);
+      update->set_phi(orientation[2]);
+      update->set_vx(velocity[0]);
+      update->set_vy(velocity[1]);
+      update->set_vz(velocity[2]);
+      updates.push_back(update);
+    }
+    slice->insertBatch(updates);
+    return 0;
+  }
+
+  /** Inserts length prefixed commands into a command slice */
+  template <typename CommandType, typename PrefType>
+  int loadCommands(MemoryCommandSlice<CommandType, PrefType>* slice, PayloadReader& reader)
+  {
+    while (!reader.atEnd())
+    {
+      CommandType* command = new CommandType;
+      if (reader.getMessage(*command) != 0)
+      {
+        delete command;
+        return 1;
+      }
+      slice->insert(command);
+    }
+    return 0;
+  }
+
+  /** Applies an entity record to an entity of one type */
+  template <typename EntryType, typename PropertiesType, typename PrefsType>
+  int loadEntityRecord(MemoryDataStore& dataStore, const std::map<ObjectId, EntryType*>& entries,
+    PropertiesType* (MemoryDataStore::*addFunc)(DataStore::Transaction*),
+    PrefsType* (MemoryDataStore::*mutablePrefs)(ObjectId, DataStore::Transaction*),
+    const RecordHeader& header, const char* data, size_t size)
+  {
+    if (header.type == RECORD_PROPERTIES)
+      return addEntity(dataStore, addFunc, header.id, data, size);
+    if (header.type == RECORD_PREFERENCES)
+      return setPrefs(dataStore, mutablePrefs, header.id, data, size);
+
+    typename std::map<ObjectId, EntryType*>::const_iterator i = entries.find(header.id);
+    if (i == entries.end())
+      return 1;
+    PayloadReader reader(data, size);
+    if (header.type == RECORD_UPDATES)
+      return loadUpdates(i->second->updates(), reader);
+    if (header.type == RECORD_COMMANDS)
+      return loadCommands(i->second->commands(), reader);
+    return 1;
+  }
+
+  /** Creates a data table from its record */
+  int loadDataTable(DataTableManager& tables, ObjectId ownerId, PayloadReader& reader)
+  {
+    std::string tableName;
+    uint32_t numColumns = 0;
+    if (reader.getString(tableName) != 0 || reader.get(numColumns) != 0)
+      return 1;
+
+    DataTable* table = nullptr;
+    if (tables.addDataTable(ownerId, tableName, &table).isError() || table == nullptr)
+      return 1;
+
+    // Column IDs are assigned by the table manager, so map saved IDs to new columns
+    std::map<int64_t, TableColumn*> columns;
+    for (uint32_t k = 0; k < numColumns; ++k)
+    {
+      int64_t savedId = 0;
+      uint32_t variableType = 0;
+      int32_t unitType = 0;
+      std::string columnName;
+      if (reader.get(savedId) != 0 || reader.get(variableType) != 0 || reader.get(unitType) != 0 || reader.getString(columnName) != 0)
+        return 1;
+      if (variableType > VT_STRING)
+        return 1;
+      TableColumn* column = nullptr;
+      if (table->addColumn(columnName, static_cast<VariableType>(variableType), unitType, &column).isError() || column == nullptr)
+        return 1;
+      columns[savedId] = column;
+    }
+
+    TableRow row;
+    while (!reader.atEnd())
+    {
+      double time = 0.0;
+      uint32_t numCells = 0;
+      if (reader.get(time) != 0 || reader.get(numCells) != 0)
+        return 1;
+      row.clear();
+      row.setTime(time);
+      for (uint32_t k = 0; k < numCells; ++k)
+      {
+        int64_t savedId = 0;
+        if (reader.get(savedId) != 0)
+          return 1;
+        std::map<int64_t, TableColumn*>::const_iterator i = columns.find(savedId);
+        if (i == columns.end())
+          return 1;
+        const TableColumnId columnId = i->second->columnId();
+        int rv = 0;
+        switch (i->second->variableType())
+        {
+        case VT_UINT8: { uint8_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_INT8: { int8_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_UINT16: { uint16_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_INT16: { int16_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_UINT32: { uint32_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_INT32: { int32_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_UINT64: { uint64_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_INT64: { int64_t value = 0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_FLOAT: { float value = 0.f; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_DOUBLE: { double value = 0.0; rv = reader.get(value); row.setValue(columnId, value); break; }
+        case VT_STRING: { std::string value; rv = reader.getString(value); row.setValue(columnId, value); break; }
+        }
+        if (rv != 0)
+          return 1;
+      }
+      if (table->addRow(row).isError())
+        return 1;
+    }
+    return 0;
+  }
+}
+
+int MemoryDataStoreSnapshot::save(const MemoryDataStore& dataStore, const std::string& filename)
+{
+  std::ofstream out(simCore::streamFixUtf8(filename), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+    return 1;
+
+  FileHeader fileHeader;
+  memcpy(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(fileHeader.magic));
+  fileHeader.version = VERSION;
+  fileHeader.byteOrder = BYTE_ORDER_MARK;
+  fileHeader.baseId = dataStore.baseId_;
+  out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+
+  RecordWriter writer(out);
+  PayloadBuffer buffer;
+  writer.writeMessage(RECORD_SCENARIO_PROPERTIES, NONE, 0, dataStore.properties_);
+
+  // Hosts are written before the entities they host
+  saveEntries(writer, buffer, PLATFORM, dataStore.platforms_);
+  saveEntries(writer, buffer, BEAM, dataStore.beams_);
+  saveEntries(writer, buffer, GATE, dataStore.gates_);
+  saveEntries(writer, buffer, LASER, dataStore.lasers_);
+  saveEntries(writer, buffer, PROJECTOR, dataStore.projectors_);
+  saveEntries(writer, buffer, LOB_GROUP, dataStore.lobGroups_);
+  saveEntries(writer, buffer, CUSTOM_RENDERING, dataStore.customRenderings_);
+
+  // Generic data includes the scenario, under ID 0
+  for (MemoryDataStore::GenericDataMap::const_iterator i = dataStore.genericData_.begin(); i != dataStore.genericData_.end(); ++i)
+  {
+    buffer.clear();
+    MessageCollector<GenericDataSlice::Visitor, GenericData> collector(buffer);
+    i->second->visit(&collector);
+    if (!buffer.data().empty())
+      writer.write(RECORD_GENERIC_DATA, dataStore.objectType(i->first), i->first, buffer.data());
+  }
+  for (MemoryDataStore::CategoryDataMap::const_iterator i = dataStore.categoryData_.begin(); i != dataStore.categoryData_.end(); ++i)
+  {
+    buffer.clear();
+    MessageCollector<CategoryDataSlice::Visitor, CategoryData> collector(buffer);
+    i->second->visit(&collector);
+    if (!buffer.data().empty())
+      writer.write(RECORD_CATEGORY_DATA, dataStore.objectType(i->first), i->first, buffer.data());
+  }
+
+  // Data tables of the scenario and of each entity
+  DataStore::IdList owners;
+  owners.push_back(0);
+  dataStore.idList(&owners);
+  TableWriter tableWriter(writer, buffer);
+  for (DataStore::IdList::const_iterator i = owners.begin(); i != owners.end(); ++i)
+  {
+    const TableList* tables = dataStore.dataTableManager().tablesForOwner(*i);
+    if (tables != nullptr)
+      tables->accept(tableWriter);
+  }
+
+  writer.write(RECORD_END, NONE, 0, std::string());
+  out.close();
+  return out.fail() ? 1 : 0;
+}
+
+int MemoryDataStoreSnapshot::load(MemoryDataStore& dataStore, const std::string& filename)
+{
+  simCore::MappedFile file;
+  if (file.open(filename) != 0 || file.size() < sizeof(FileHeader))
+    return 1;
+
+  FileHeader fileHeader;
+  memcpy(&fileHeader, file.data(), sizeof(fileHeader));
+  if (memcmp(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(fileHeader.magic)) != 0 ||
+    fileHeader.version != VERSION || fileHeader.byteOrder != BYTE_ORDER_MARK)
+    return 1;
+
+  // Remove the current contents; removing entities also removes their generic data, category data and tables
+  DataStore::IdList ids;
+  dataStore.idList(&ids);
+  for (DataStore::IdList::const_iterator i = ids.begin(); i != ids.end(); ++i)
+    dataStore.removeEntity(*i);
+  MemoryDataStore::GenericDataMap::const_iterator scenarioGenericData = dataStore.genericData_.find(0);
+  if (scenarioGenericData != dataStore.genericData_.end())
+    scenarioGenericData->second->flush();
+  dataStore.dataTableManager().deleteTablesByOwner(0);
+  dataStore.hasChanged_ = true;
+
+  ObjectId maxId = 0;
+  PayloadReader fileReader(file.data() + sizeof(fileHeader), file.size() - sizeof(fileHeader));
+  while (true)
+  {
+    RecordHeader header;
+    const char* data = nullptr;
+    if (fileReader.get(header) != 0 || header.size > fileReader.remaining() ||
+      fileReader.getBlock(data, static_cast<size_t>(header.size)) != 0)
+      return 1;
+    const size_t size = static_cast<size_t>(header.size);
+    const char* padding = nullptr;
+    if (fileReader.getBlock(padding, static_cast<size_t>(paddingSize(header.size))) != 0)
+      return 1;
+
+    int rv = 0;
+    switch (header.type)
+    {
+    case RECORD_END:
+      dataStore.baseId_ = std::max(static_cast<ObjectId>(fileHeader.baseId), maxId);
+      return 0;
+
+    case RECORD_SCENARIO_PROPERTIES:
+    {
+      ScenarioProperties saved;
+      if (!saved.ParseFromArray(data, static_cast<int>(size)))
+        return 1;
+      DataStore::Transaction transaction;
+      ScenarioProperties* properties = dataStore.mutable_scenarioProperties(&transaction);
+      properties->CopyFrom(saved);
+      transaction.complete(&properties);
+      break;
+    }
+
+    case RECORD_PROPERTIES:
+    case RECORD_PREFERENCES:
+    case RECORD_UPDATES:
+    case RECORD_COMMANDS:
+      if (header.type == RECORD_PROPERTIES)
+      {
+        // ID 0 is reserved for the scenario
+        if (header.id == 0)
+          return 1;
+        // New entities get the ID after baseId_
+        dataStore.baseId_ = header.id - 1;
+        maxId = std::max(maxId, static_cast<ObjectId>(header.id));
+      }
+      switch (header.objectType)
+      {
+      case PLATFORM:
+        rv = loadEntityRecord(dataStore, dataStore.platforms_, &MemoryDataStore::addPlatform, &MemoryDataStore::mutable_platformPrefs, header, data, size);
+        break;
+      case BEAM:
+        rv = loadEntityRecord(dataStore, dataStore.beams_, &MemoryDataStore::addBeam, &MemoryDataStore::mutable_beamPrefs, header, data, size);
+        break;
+      case GATE:
+        rv = loadEntityRecord(dataStore, dataStore.gates_, &MemoryDataStore::addGate, &MemoryDataStore::mutable_gatePrefs, header, data, size);
+        break;
+      case LASER:
+        rv = loadEntityRecord(dataStore, dataStore.lasers_, &MemoryDataStore::addLaser, &MemoryDataStore::mutable_laserPrefs, header, data, size);
+        break;
+      case PROJECTOR:
+        rv = loadEntityRecord(dataStore, dataStore.projectors_, &MemoryDataStore::addProjector, &MemoryDataStore::mutable_projectorPrefs, header, data, size);
+        break;
+      case LOB_GROUP:
+        rv = loadEntityRecord(dataStore, dataStore.lobGroups_, &MemoryDataStore::addLobGroup, &MemoryDataStore::mutable_lobGroupPrefs, header, data, size);
+        break;
+      case CUSTOM_RENDERING:
+        rv = loadEntityRecord(dataStore, dataStore.customRenderings_, &MemoryDataStore::addCustomRendering, &MemoryDataStore::mutable_customRenderingPrefs, header, data, size);
+        break;
+      default:
+        rv = 1;
+        break;
+      }
+      break;
+
+    case RECORD_GENERIC_DATA:
+    {
+      MemoryDataStore::GenericDataMap::const_iterator i = dataStore.genericData_.find(header.id);
+      if (i == dataStore.genericData_.end())
+        return 1;
+      PayloadReader reader(data, size);
+      while (rv == 0 && !reader.atEnd())
+      {
+        GenericData* genericData = new GenericData;
+        rv = reader.getMessage(*genericData);
+        if (rv == 0)
+          i->second->insert(genericData, false);
+        else
+          delete genericData;
+      }
+      break;
+    }
+
+    case RECORD_CATEGORY_DATA:
+    {
+      MemoryDataStore::CategoryDataMap::const_iterator i = dataStore.categoryData_.find(header.id);
+      if (i == dataStore.categoryData_.end())
+        return 1;
+      PayloadReader reader(data, size);
+      while (rv == 0 && !reader.atEnd())
+      {
+        CategoryData* categoryData = new CategoryData;
+        rv = reader.getMessage(*categoryData);
+        if (rv == 0)
+          i->second->insert(categoryData);
+        else
+          delete categoryData;
+      }
+      break;
+    }
+
+    case RECORD_DATA_TABLE:
+    {
+      PayloadReader reader(data, size);
+      rv = loadDataTable(dataStore.dataTableManager(), header.id, reader);
+      break;
+    }
+
+    default:
+      rv = 1;
+      break;
+    }
+
+    if (rv != 0)
+      return 1;
+  }
+}
+
+}
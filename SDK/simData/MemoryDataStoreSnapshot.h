@@ -0,0 +1,94 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_MEMORYDATASTORESNAPSHOT_H
+#define SIMDATA_MEMORYDATASTORESNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "simCore/Common/Export.h"
+
+namespace simData
+{
+
+class MemoryDataStore;
+
+/**
+ * Saves and restores the complete contents of a MemoryDataStore using a compact binary file.
+ * Saving and reloading a scenario is much faster than replaying the original input, since
+ * the file holds the data exactly as the data store keeps it: scenario properties, entity
+ * properties and preferences, update and command slices, generic data, category data and
+ * data tables.  Platform updates, which dominate most scenarios, are stored as packed fixed
+ * size records; everything else is stored as length prefixed serialized messages.
+ *
+ * The file starts with a header holding a magic string, the format version and a byte order
+ * marker, followed by a sequence of records.  Files from a different format version or from a
+ * machine with a different byte order are rejected.  load() maps the file into memory and
+ * decodes records in place, without reading the file into an intermediate buffer.
+ *
+ * Entity IDs are preserved.  Listeners are notified of new entities and preference changes
+ * while loading, but updates, commands, generic data, category data and table rows are added
+ * directly to the slices, so new updates listeners are not called for them.  Call
+ * MemoryDataStore::update() after loading to bring the current state up to date.
+ *
+ * Data store settings such as data limiting, interpolation and default preferences are not
+ * part of the snapshot.  The snapshot is not built on DataStore::createInternalsMemento():
+ * the memento holds run-time objects of the data store (listener and observer pointers, the
+ * interpolator, the bound clock and default preferences), none of which can be written to a
+ * file, and it holds none of the entity data that the snapshot stores.  The two complement
+ * each other instead; to restore a snapshot into a new data store that replaces an existing
+ * one, apply a memento of the existing store to the new store:
+ * <pre>
+ *   std::unique_ptr<simData::DataStore::InternalsMemento> memento(oldStore.createInternalsMemento());
+ *   memento->apply(newStore);
+ *   simData::MemoryDataStoreSnapshot::load(newStore, filename);
+ * </pre>
+ */
+class SDKDATA_EXPORT MemoryDataStoreSnapshot
+{
+public:
+  /// Version of the file format written by save()
+  static const uint32_t VERSION = 1;
+
+  /**
+   * Writes the contents of the data store to a snapshot file, overwriting the file if it exists
+   * @param dataStore Data store to save
+   * @param filename Name of the file to write
+   * @return 0 on success, non-zero if the file could not be written
+   */
+  static int save(const MemoryDataStore& dataStore, const std::string& filename);
+
+  /**
+   * Replaces the contents of the data store with the contents of a snapshot file.  Existing
+   * entities, scenario generic data and scenario data tables are removed first.
+   * @param dataStore Data store to restore into
+   * @param filename Name of the snapshot file to read
+   * @return 0 on success, non-zero if the file could not be read, is not a snapshot file, has
+   *   an unsupported version, or is malformed.  If the file is malformed after its header, the
+   *   data store holds the records read before the error.
+   */
+  static int load(MemoryDataStore& dataStore, const std::string& filename);
+};
+
+}
+
+#endif
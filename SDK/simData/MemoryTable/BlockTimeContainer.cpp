@@ -0,0 +1,874 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "simData/MemoryTable/DataColumn.h"
+#include "simData/MemoryTable/BlockTimeContainer.h"
+
+namespace simData { namespace MemoryTable {
+
+namespace
+{
+
+/** Decimal scales are tried first, coarsest first, since most data is recorded at decimal rates */
+static const double DECIMAL_SCALES[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+static const size_t NUM_DECIMAL_SCALES = sizeof(DECIMAL_SCALES) / sizeof(DECIMAL_SCALES[0]);
+/** Largest integer such that it and all smaller integers are exactly representable as a double */
+static const double MAX_EXACT_UNITS = 9007199254740992.0;
+
+/** Returns the value of the least significant set bit of a positive finite value */
+double lowestBit(double value)
+{
+  int exponent = 0;
+  const double mantissa = std::frexp(value, &exponent);
+  // Mantissa is in [0.5,1), so scaling by 2^53 produces an exact integer
+  uint64_t bits = static_cast<uint64_t>(std::ldexp(mantissa, 53));
+  int shift = 0;
+  while (bits != 0 && (bits & 1) == 0)
+  {
+    bits >>= 1;
+    ++shift;
+  }
+  return std::ldexp(1.0, exponent - 53 + shift);
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+BlockTimeContainer::Block::Block()
+  : baseTime_(0.0),
+    maxTime_(0.0),
+    scale_(1.0),
+    baseUnits_(0),
+    baseIndex_(0),
+    count_(0),
+    raw_(false)
+{
+}
+
+size_t BlockTimeContainer::Block::size() const
+{
+  return count_;
+}
+
+double BlockTimeContainer::Block::minTime() const
+{
+  return baseTime_;
+}
+
+double BlockTimeContainer::Block::maxTime() const
+{
+  return maxTime_;
+}
+
+double BlockTimeContainer::Block::time(size_t offset) const
+{
+  if (raw_)
+    return rawTimes_[offset];
+  return static_cast<double>(baseUnits_ + deltas_[offset]) / scale_;
+}
+
+size_t BlockTimeContainer::Block::index(size_t offset) const
+{
+  if (indexOffsets_.empty())
+    return baseIndex_ + offset;
+  return baseIndex_ + indexOffsets_[offset];
+}
+
+size_t BlockTimeContainer::Block::bound(double timeValue, bool upper) const
+{
+  size_t first = 0;
+  size_t count = count_;
+  while (count > 0)
+  {
+    const size_t step = count / 2;
+    const double stepTime = time(first + step);
+    if (upper ? (stepTime <= timeValue) : (stepTime < timeValue))
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+  return first;
+}
+
+bool BlockTimeContainer::Block::isRaw() const
+{
+  return raw_;
+}
+
+size_t BlockTimeContainer::Block::memoryUsage() const
+{
+  return deltas_.capacity() * sizeof(uint32_t) + rawTimes_.capacity() * sizeof(double) +
+    indexOffsets_.capacity() * sizeof(uint32_t);
+}
+
+bool BlockTimeContainer::Block::append(double timeValue, size_t index)
+{
+  if (count_ >= BLOCK_SIZE)
+    return false;
+
+  // Validate the index before changing any state
+  const bool sequential = indexOffsets_.empty() && (count_ == 0 || index == baseIndex_ + count_);
+  if (!sequential && (index < baseIndex_ || index - baseIndex_ > std::numeric_limits<uint32_t>::max()))
+    return false;
+
+  assert(count_ == 0 || timeValue > maxTime_);
+  if (!appendDelta_(timeValue))
+    return false;
+
+  if (count_ == 0)
+    baseIndex_ = index;
+  else if (!sequential)
+  {
+    // Switch from implied sequential indices to explicit offsets
+    if (indexOffsets_.empty())
+    {
+      indexOffsets_.reserve(count_ + 1);
+      for (size_t k = 0; k < count_; ++k)
+        indexOffsets_.push_back(static_cast<uint32_t>(k));
+    }
+    indexOffsets_.push_back(static_cast<uint32_t>(index - baseIndex_));
+  }
+  maxTime_ = timeValue;
+  ++count_;
+  return true;
+}
+
+void BlockTimeContainer::Block::assign(const double* times, const size_t* indices, size_t count)
+{
+  assert(count > 0 && count <= BLOCK_SIZE);
+  clear_();
+
+  size_t minIndex = indices[0];
+  bool sequential = true;
+  for (size_t k = 1; k < count; ++k)
+  {
+    minIndex = std::min(minIndex, indices[k]);
+    if (indices[k] != indices[0] + k)
+      sequential = false;
+  }
+  baseIndex_ = minIndex;
+  if (!sequential)
+  {
+    indexOffsets_.reserve(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+      // Assertion failure means more than 4 billion rows were inserted out of order
+      assert(indices[k] - minIndex <= std::numeric_limits<uint32_t>::max());
+      indexOffsets_.push_back(static_cast<uint32_t>(indices[k] - minIndex));
+    }
+  }
+
+  // Encode times as deltas, falling back to full doubles if any time cannot be represented
+  deltas_.reserve(count);
+  for (count_ = 0; count_ < count; ++count_)
+  {
+    if (!appendDelta_(times[count_]))
+    {
+      raw_ = true;
+      std::vector<uint32_t>().swap(deltas_);
+      rawTimes_.assign(times, times + count);
+      break;
+    }
+  }
+  count_ = count;
+  maxTime_ = times[count - 1];
+}
+
+void BlockTimeContainer::Block::decode(std::vector<double>& times, std::vector<size_t>& indices) const
+{
+  for (size_t k = 0; k < count_; ++k)
+  {
+    times.push_back(time(k));
+    indices.push_back(index(k));
+  }
+}
+
+size_t BlockTimeContainer::Block::maxIndex() const
+{
+  if (indexOffsets_.empty())
+    return baseIndex_ + count_ - 1;
+  return baseIndex_ + *std::max_element(indexOffsets_.begin(), indexOffsets_.end());
+}
+
+void BlockTimeContainer::Block::shiftIndices(size_t amount)
+{
+  assert(baseIndex_ >= amount);
+  baseIndex_ -= amount;
+}
+
+void BlockTimeContainer::Block::closeIndexGap(size_t removedIndex)
+{
+  if (baseIndex_ > removedIndex)
+  {
+    --baseIndex_;
+    return;
+  }
+  // Sequential blocks that start before the removed index cannot contain larger indices
+  for (std::vector<uint32_t>::iterator i = indexOffsets_.begin(); i != indexOffsets_.end(); ++i)
+  {
+    assert(baseIndex_ + *i != removedIndex);
+    if (baseIndex_ + *i > removedIndex)
+      --(*i);
+  }
+}
+
+bool BlockTimeContainer::Block::appendDelta_(double timeValue)
+{
+  if (count_ == 0)
+  {
+    baseTime_ = timeValue;
+    // Use the coarsest scale that represents the time, to give the block the largest time span
+    for (size_t k = 0; k < NUM_DECIMAL_SCALES; ++k)
+    {
+      if (toUnits_(timeValue, DECIMAL_SCALES[k], baseUnits_))
+      {
+        scale_ = DECIMAL_SCALES[k];
+        deltas_.push_back(0);
+        return true;
+      }
+    }
+    // Every finite value is a whole number of its least significant bit
+    if (timeValue != 0.0 && std::abs(timeValue) <= std::numeric_limits<double>::max())
+    {
+      const double binaryScale = 1.0 / lowestBit(std::abs(timeValue));
+      if (toUnits_(timeValue, binaryScale, baseUnits_))
+      {
+        scale_ = binaryScale;
+        deltas_.push_back(0);
+        return true;
+      }
+    }
+    raw_ = true;
+  }
+  if (raw_)
+  {
+    rawTimes_.push_back(timeValue);
+    return true;
+  }
+
+  int64_t units = 0;
+  if (toUnits_(timeValue, scale_, units) && units >= baseUnits_ && units - baseUnits_ <= std::numeric_limits<uint32_t>::max())
+  {
+    deltas_.push_back(static_cast<uint32_t>(units - baseUnits_));
+    return true;
+  }
+
+  // Try progressively finer scales
+  for (size_t k = 0; k < NUM_DECIMAL_SCALES; ++k)
+  {
+    if (DECIMAL_SCALES[k] > scale_ && rescale_(DECIMAL_SCALES[k], timeValue))
+      return true;
+  }
+  // Binary fractions that are not decimal, e.g. 1/1024 second steps
+  if (timeValue != 0.0 && std::abs(timeValue) <= std::numeric_limits<double>::max())
+  {
+    const double binaryScale = 1.0 / lowestBit(std::abs(timeValue));
+    if (binaryScale > scale_ && rescale_(binaryScale, timeValue))
+      return true;
+  }
+  return false;
+}
+
+bool BlockTimeContainer::Block::rescale_(double scale, double timeValue)
+{
+  int64_t baseUnits = 0;
+  if (!toUnits_(baseTime_, scale, baseUnits))
+    return false;
+
+  uint32_t newDeltas[BLOCK_SIZE];
+  assert(count_ < BLOCK_SIZE);
+  for (size_t k = 0; k <= count_; ++k)
+  {
+    int64_t units = 0;
+    if (!toUnits_((k < count_) ? time(k) : timeValue, scale, units) || units < baseUnits ||
+      units - baseUnits > std::numeric_limits<uint32_t>::max())
+      return false;
+    newDeltas[k] = static_cast<uint32_t>(units - baseUnits);
+  }
+  scale_ = scale;
+  baseUnits_ = baseUnits;
+  deltas_.assign(newDeltas, newDeltas + count_ + 1);
+  return true;
+}
+
+bool BlockTimeContainer::Block::toUnits_(double timeValue, double scale, int64_t& units) const
+{
+  const double scaled = std::floor(timeValue * scale + 0.5);
+  // Negated comparison also rejects NaN
+  if (!(std::abs(scaled) <= MAX_EXACT_UNITS))
+    return false;
+  // Only accept exact round trips, so that the encoding is lossless
+  if (scaled / scale != timeValue)
+    return false;
+  units = static_cast<int64_t>(scaled);
+  return true;
+}
+
+void BlockTimeContainer::Block::clear_()
+{
+  baseTime_ = 0.0;
+  maxTime_ = 0.0;
+  scale_ = 1.0;
+  baseUnits_ = 0;
+  deltas_.clear();
+  std::vector<double>().swap(rawTimes_);
+  baseIndex_ = 0;
+  std::vector<uint32_t>().swap(indexOffsets_);
+  count_ = 0;
+  raw_ = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/// Implements delayed flush by doing a container swap
+class BlockTimeContainer::FlushContainer : public DelayedFlushContainer
+{
+public:
+  /** Takes ownership of the blocks, leaving the input empty */
+  explicit FlushContainer(std::vector<Block>& blocks)
+  {
+    blocks_.swap(blocks);
+  }
+  virtual ~FlushContainer()
+  {
+  }
+private:
+  std::vector<Block> blocks_;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Implementation of the TimeContainer's iterator impl interface.  Steps through the
+ * blocks in time order.  Like deque iterators, invalidated by changes to the container.
+ */
+class BlockTimeContainer::BlockIterator : public TimeContainer::IteratorImpl
+{
+public:
+  /** Sentinel value for invalid values */
+  static const IteratorData INVALID_VALUE;
+
+  /** Construct a new iterator at the given position */
+  BlockIterator(const BlockTimeContainer& owner, const Position& pos)
+    : owner_(owner),
+      pos_(pos)
+  {
+  }
+
+  virtual ~BlockIterator()
+  {
+  }
+
+  /** Retrieves next element and increments iterator to position after that element */
+  virtual const IteratorData next()
+  {
+    if (!hasNext())
+      return INVALID_VALUE;
+    const IteratorData rv = entry_(pos_);
+    if (++pos_.offset == owner_.blocks_[pos_.blockIndex].size())
+    {
+      ++pos_.blockIndex;
+      pos_.offset = 0;
+    }
+    return rv;
+  }
+  /** Retrieves next element and does not change iterator position */
+  virtual const IteratorData peekNext() const
+  {
+    if (!hasNext())
+      return INVALID_VALUE;
+    return entry_(pos_);
+  }
+
+  /** Retrieves previous element and decrements iterator to position before that element */
+  virtual const IteratorData previous()
+  {
+    if (!hasPrevious())
+      return INVALID_VALUE;
+    retreat_(pos_);
+    return entry_(pos_);
+  }
+  /** Retrieves previous element and does not change iterator position */
+  virtual const IteratorData peekPrevious() const
+  {
+    if (!hasPrevious())
+      return INVALID_VALUE;
+    Position pos = pos_;
+    retreat_(pos);
+    return entry_(pos);
+  }
+
+  /** Resets the iterator to the front of the data structure, before the first element */
+  virtual void toFront()
+  {
+    pos_.blockIndex = 0;
+    pos_.offset = 0;
+  }
+  /** Sets the iterator to the end of the data structure, after the last element */
+  virtual void toBack()
+  {
+    pos_.blockIndex = owner_.blocks_.size();
+    pos_.offset = 0;
+  }
+
+  /** Returns true if next() / peekNext() will be a valid entry */
+  virtual bool hasNext() const
+  {
+    return pos_.blockIndex < owner_.blocks_.size();
+  }
+  /** Returns true if previous() / peekPrevious() will be a valid entry */
+  virtual bool hasPrevious() const
+  {
+    return pos_.offset > 0 || (pos_.blockIndex > 0 && !owner_.blocks_.empty());
+  }
+
+  /** Create a copy of the actual implementation */
+  virtual GenericIteratorImpl<IteratorData>* clone() const
+  {
+    return new BlockIterator(*this);
+  }
+
+  /** Position of the entry returned by next() */
+  const Position& position() const
+  {
+    return pos_;
+  }
+
+private:
+  IteratorData entry_(const Position& pos) const
+  {
+    const Block& block = owner_.blocks_[pos.blockIndex];
+    return IteratorData(block.time(pos.offset), block.index(pos.offset), true);
+  }
+
+  void retreat_(Position& pos) const
+  {
+    if (pos.offset > 0)
+    {
+      --pos.offset;
+      return;
+    }
+    --pos.blockIndex;
+    pos.offset = owner_.blocks_[pos.blockIndex].size() - 1;
+  }
+
+  const BlockTimeContainer& owner_;
+  Position pos_;
+};
+const TimeContainer::IteratorData BlockTimeContainer::BlockIterator::INVALID_VALUE(std::numeric_limits<double>::max(), 0, true);
+
+/////////////////////////////////////////////////////////////////////////////
+
+BlockTimeContainer::BlockTimeContainer()
+  : size_(0)
+{
+}
+
+BlockTimeContainer::BlockTimeContainer(const BlockTimeContainer& copyFrom)
+  : blocks_(copyFrom.blocks_),
+    size_(copyFrom.size_)
+{
+}
+
+BlockTimeContainer::~BlockTimeContainer()
+{
+}
+
+TimeContainer* BlockTimeContainer::clone() const
+{
+  return new BlockTimeContainer(*this);
+}
+
+size_t BlockTimeContainer::size() const
+{
+  return size_;
+}
+
+bool BlockTimeContainer::empty() const
+{
+  return size_ == 0;
+}
+
+TimeContainer::Iterator BlockTimeContainer::begin()
+{
+  Position pos = { 0, 0 };
+  return newIterator_(pos);
+}
+
+TimeContainer::Iterator BlockTimeContainer::end()
+{
+  Position pos = { blocks_.size(), 0 };
+  return newIterator_(pos);
+}
+
+TimeContainer::Iterator BlockTimeContainer::lower_bound(double timeValue)
+{
+  return newIterator_(bound_(timeValue, false));
+}
+
+TimeContainer::Iterator BlockTimeContainer::upper_bound(double timeValue)
+{
+  return newIterator_(bound_(timeValue, true));
+}
+
+TimeContainer::Iterator BlockTimeContainer::findTimeAtOrBeforeGivenTime(double timeValue)
+{
+  Position pos = bound_(timeValue, true);
+  // Step back from the first time after timeValue
+  if (pos.offset > 0)
+    --pos.offset;
+  else if (pos.blockIndex > 0)
+  {
+    --pos.blockIndex;
+    pos.offset = blocks_[pos.blockIndex].size() - 1;
+  }
+  else
+    return end();
+  return newIterator_(pos);
+}
+
+TimeContainer::Iterator BlockTimeContainer::find(double timeValue)
+{
+  const Position pos = bound_(timeValue, false);
+  if (pos.blockIndex < blocks_.size() && blocks_[pos.blockIndex].time(pos.offset) == timeValue)
+    return newIterator_(pos);
+  return end();
+}
+
+TimeContainer::Iterator BlockTimeContainer::findOrAddTime(double timeValue, bool* exactMatch)
+{
+  const Position pos = bound_(timeValue, false);
+  const bool found = (pos.blockIndex < blocks_.size() && blocks_[pos.blockIndex].time(pos.offset) == timeValue);
+  if (exactMatch)
+    *exactMatch = found;
+  if (found)
+    return newIterator_(pos);
+
+  // New rows are appended to the data containers, same as the fresh bin of the double buffer
+  return newIterator_(insert_(pos, timeValue, size_));
+}
+
+void BlockTimeContainer::erase(TimeContainer::Iterator iter, TimeContainer::EraseBehavior eraseBehavior)
+{
+  BlockIterator* blockIter = dynamic_cast<BlockIterator*>(iter.impl());
+  if (blockIter == nullptr || !blockIter->hasNext())
+    return;
+  const Position pos = blockIter->position();
+
+  std::vector<double> times;
+  std::vector<size_t> indices;
+  blocks_[pos.blockIndex].decode(times, indices);
+  const size_t removedIndex = indices[pos.offset];
+  times.erase(times.begin() + pos.offset);
+  indices.erase(indices.begin() + pos.offset);
+  --size_;
+
+  if (eraseBehavior == TimeContainer::ERASE_FIXOFFSETS)
+  {
+    for (std::vector<size_t>::iterator i = indices.begin(); i != indices.end(); ++i)
+    {
+      if (*i > removedIndex)
+        --(*i);
+    }
+    for (size_t k = 0; k < blocks_.size(); ++k)
+    {
+      if (k != pos.blockIndex)
+        blocks_[k].closeIndexGap(removedIndex);
+    }
+  }
+  rebuildBlock_(pos.blockIndex, times, indices);
+  // Iterator is no longer valid; leave it in a consistent state
+  blockIter->toBack();
+}
+
+simData::DelayedFlushContainerPtr BlockTimeContainer::flush()
+{
+  size_ = 0;
+  // Optimize for case where container is empty (no memory allocation)
+  if (blocks_.empty())
+    return DelayedFlushContainerPtr();
+  return DelayedFlushContainerPtr(new FlushContainer(blocks_));
+}
+
+void BlockTimeContainer::flush(const std::vector<DataColumn*>& columns, double startTime, double endTime)
+{
+  // Convert the times to entry numbers in time order
+  size_t firstEntry = 0;
+  size_t lastEntry = 0;
+  const Position start = bound_(startTime, false);
+  const Position end = bound_(endTime, false);
+  for (size_t k = 0; k < blocks_.size(); ++k)
+  {
+    if (k < start.blockIndex)
+      firstEntry += blocks_[k].size();
+    if (k < end.blockIndex)
+      lastEntry += blocks_[k].size();
+  }
+  firstEntry += start.offset;
+  lastEntry += end.offset;
+  if (firstEntry < lastEntry)
+    removeEntries_(firstEntry, lastEntry, columns);
+}
+
+size_t BlockTimeContainer::copyEntries(double beginTime, double endTime, IteratorData* entries, size_t maxCount) const
+{
+  size_t count = 0;
+  Position pos = bound_(beginTime, false);
+  for (; pos.blockIndex < blocks_.size() && count < maxCount; ++pos.blockIndex)
+  {
+    const Block& block = blocks_[pos.blockIndex];
+    for (; pos.offset < block.size() && count < maxCount; ++pos.offset)
+    {
+      const double timeValue = block.time(pos.offset);
+      if (timeValue >= endTime)
+        return count;
+      entries[count++] = IteratorData(timeValue, block.index(pos.offset), true);
+    }
+    pos.offset = 0;
+  }
+  return count;
+}
+
+void BlockTimeContainer::limitData(size_t maxPoints, double latestInvalidTime,
+  const std::vector<DataColumn*>& columns,
+  DataTable* table, const std::vector<DataTable::TableObserverPtr>& observers)
+{
+  // Find the whole blocks at the front that are over the point limit or entirely too old
+  size_t numBlocks = 0;
+  size_t numEntries = 0;
+  for (; numBlocks < blocks_.size(); ++numBlocks)
+  {
+    const Block& block = blocks_[numBlocks];
+    const bool overPoints = (maxPoints > 0) && (size_ - numEntries - block.size() >= maxPoints);
+    const bool tooOld = (latestInvalidTime > 0.0) && (block.maxTime() < latestInvalidTime);
+    if (!overPoints && !tooOld)
+      break;
+    numEntries += block.size();
+  }
+  if (numBlocks == 0)
+    return;
+
+  // Before removing the blocks, announce that all those times are being removed
+  if (table != nullptr)
+  {
+    for (std::vector<DataTable::TableObserverPtr>::const_iterator oiter = observers.begin(); oiter != observers.end(); ++oiter)
+    {
+      for (size_t k = 0; k < numBlocks; ++k)
+      {
+        const Block& block = blocks_[k];
+        for (size_t offset = 0; offset < block.size(); ++offset)
+          (*oiter)->onPreRemoveRow(*table, block.time(offset));
+      }
+    }
+  }
+
+  // Rows normally arrive in time order, so the oldest blocks hold the oldest data container entries
+  size_t maxIndex = 0;
+  for (size_t k = 0; k < numBlocks; ++k)
+    maxIndex = std::max(maxIndex, blocks_[k].maxIndex());
+  if (maxIndex + 1 != numEntries)
+  {
+    removeEntries_(0, numEntries, columns);
+    return;
+  }
+
+  // Indices are unique, so the removed blocks hold exactly [0, numEntries)
+  for (std::vector<DataColumn*>::const_iterator i = columns.begin(); i != columns.end(); ++i)
+    (*i)->erase(true, 0, numEntries);
+  blocks_.erase(blocks_.begin(), blocks_.begin() + numBlocks);
+  for (std::vector<Block>::iterator i = blocks_.begin(); i != blocks_.end(); ++i)
+    i->shiftIndices(numEntries);
+  size_ -= numEntries;
+}
+
+int BlockTimeContainer::getTimeRange(double& begin, double& end) const
+{
+  if (blocks_.empty())
+  {
+    begin = 0.0;
+    end = 0.0;
+    return 1;
+  }
+  begin = blocks_.front().minTime();
+  end = blocks_.back().maxTime();
+  return 0;
+}
+
+size_t BlockTimeContainer::memoryUsage() const
+{
+  size_t rv = sizeof(*this) + blocks_.capacity() * sizeof(Block);
+  for (std::vector<Block>::const_iterator i = blocks_.begin(); i != blocks_.end(); ++i)
+    rv += i->memoryUsage();
+  return rv;
+}
+
+size_t BlockTimeContainer::numBlocks() const
+{
+  return blocks_.size();
+}
+
+size_t BlockTimeContainer::numRawBlocks() const
+{
+  size_t rv = 0;
+  for (std::vector<Block>::const_iterator i = blocks_.begin(); i != blocks_.end(); ++i)
+  {
+    if (i->isRaw())
+      ++rv;
+  }
+  return rv;
+}
+
+BlockTimeContainer::Position BlockTimeContainer::bound_(double timeValue, bool upper) const
+{
+  // Binary search for the first block that could hold the time, then search inside the block
+  size_t first = 0;
+  size_t count = blocks_.size();
+  while (count > 0)
+  {
+    const size_t step = count / 2;
+    const double maxTime = blocks_[first + step].maxTime();
+    if (upper ? (maxTime <= timeValue) : (maxTime < timeValue))
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+  Position rv = { first, 0 };
+  if (first < blocks_.size())
+    rv.offset = blocks_[first].bound(timeValue, upper);
+  return rv;
+}
+
+BlockTimeContainer::Position BlockTimeContainer::insert_(const Position& pos, double timeValue, size_t index)
+{
+  ++size_;
+  // Times between blocks, or after the last block, are appended to the earlier block when possible
+  if (pos.offset == 0 && pos.blockIndex > 0)
+  {
+    Block& previous = blocks_[pos.blockIndex - 1];
+    if (previous.append(timeValue, index))
+    {
+      Position rv = { pos.blockIndex - 1, previous.size() - 1 };
+      return rv;
+    }
+  }
+  if (pos.blockIndex == blocks_.size())
+  {
+    blocks_.push_back(Block());
+    blocks_.back().append(timeValue, index);
+    Position rv = { blocks_.size() - 1, 0 };
+    return rv;
+  }
+
+  // Insert into the middle of a block, splitting it if needed
+  std::vector<double> times;
+  std::vector<size_t> indices;
+  times.reserve(BLOCK_SIZE + 1);
+  indices.reserve(BLOCK_SIZE + 1);
+  blocks_[pos.blockIndex].decode(times, indices);
+  times.insert(times.begin() + pos.offset, timeValue);
+  indices.insert(indices.begin() + pos.offset, index);
+  rebuildBlock_(pos.blockIndex, times, indices);
+  if (pos.offset < blocks_[pos.blockIndex].size())
+    return pos;
+  Position rv = { pos.blockIndex + 1, pos.offset - blocks_[pos.blockIndex].size() };
+  return rv;
+}
+
+void BlockTimeContainer::rebuildBlock_(size_t blockIndex, const std::vector<double>& times, const std::vector<size_t>& indices)
+{
+  assert(times.size() == indices.size() && times.size() <= 2 * BLOCK_SIZE);
+  if (times.empty())
+  {
+    blocks_.erase(blocks_.begin() + blockIndex);
+    return;
+  }
+  if (times.size() <= BLOCK_SIZE)
+  {
+    blocks_[blockIndex].assign(&times[0], &indices[0], times.size());
+    return;
+  }
+  const size_t half = times.size() / 2;
+  blocks_[blockIndex].assign(&times[0], &indices[0], half);
+  blocks_.insert(blocks_.begin() + blockIndex + 1, Block());
+  blocks_[blockIndex + 1].assign(&times[half], &indices[half], times.size() - half);
+}
+
+void BlockTimeContainer::removeEntries_(size_t firstEntry, size_t lastEntry, const std::vector<DataColumn*>& columns)
+{
+  std::vector<double> times;
+  std::vector<size_t> indices;
+  times.reserve(size_);
+  indices.reserve(size_);
+  for (std::vector<Block>::const_iterator i = blocks_.begin(); i != blocks_.end(); ++i)
+    i->decode(times, indices);
+
+  std::vector<size_t> removed(indices.begin() + firstEntry, indices.begin() + lastEntry);
+  std::sort(removed.begin(), removed.end());
+  times.erase(times.begin() + firstEntry, times.begin() + lastEntry);
+  indices.erase(indices.begin() + firstEntry, indices.begin() + lastEntry);
+
+  // Each remaining index moves down by the number of removed indices below it
+  for (std::vector<size_t>::iterator i = indices.begin(); i != indices.end(); ++i)
+    *i -= std::lower_bound(removed.begin(), removed.end(), *i) - removed.begin();
+
+  // Erase contiguous ranges from the columns, last range first so earlier positions stay valid
+  size_t rangeEnd = removed.size();
+  while (rangeEnd > 0)
+  {
+    size_t rangeStart = rangeEnd - 1;
+    while (rangeStart > 0 && removed[rangeStart - 1] + 1 == removed[rangeStart])
+      --rangeStart;
+    for (std::vector<DataColumn*>::const_iterator i = columns.begin(); i != columns.end(); ++i)
+      (*i)->erase(true, removed[rangeStart], rangeEnd - rangeStart);
+    rangeEnd = rangeStart;
+  }
+
+  // Rebuild the blocks from the remaining entries
+  blocks_.clear();
+  size_ = times.size();
+  for (size_t k = 0; k < times.size(); ++k)
+  {
+    if (blocks_.empty() || !blocks_.back().append(times[k], indices[k]))
+    {
+      blocks_.push_back(Block());
+      blocks_.back().append(times[k], indices[k]);
+    }
+  }
+}
+
+TimeContainer::Iterator BlockTimeContainer::newIterator_(const Position& pos)
+{
+  return Iterator(new BlockIterator(*this, pos));
+}
+
+} }
@@ -0,0 +1,200 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_MEMORYTABLE_BLOCKTIMECONTAINER_H
+#define SIMDATA_MEMORYTABLE_BLOCKTIMECONTAINER_H
+
+#include <cstdint>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/DataTable.h"
+#include "simData/MemoryTable/TimeContainer.h"
+
+namespace simData { namespace MemoryTable {
+
+/**
+ * Compact time container that stores times in a contiguous array of blocks.  Each block
+ * holds up to BLOCK_SIZE time-sorted entries, and remembers its minimum and maximum time
+ * so that searches are a binary search over blocks followed by a binary search inside a
+ * single block, for O(lg n) lookups.
+ *
+ * Inside a block, times are stored as a count of time units for the first entry plus a
+ * 32-bit delta for each entry, where a unit is 1/scale seconds.  Scales are powers of ten,
+ * which reproduce decimal times such as 12.3 exactly, or powers of two.  The encoding is
+ * lossless: a block whose times cannot be represented exactly falls back to storing full
+ * doubles.  Data container positions are stored as a base position for the block, plus
+ * 32-bit offsets only when rows arrived out of time order.  For in-order data this reduces
+ * the cost of the time index from a std::pair<double, size_t> per row to roughly 4 bytes
+ * per row.
+ *
+ * All entries live in the "fresh" bin of the data columns.  Data limiting removes whole
+ * blocks from the front of the container, so up to one block of points beyond the limit
+ * may be retained.
+ */
+class SDKDATA_EXPORT BlockTimeContainer : public TimeContainer
+{
+public:
+  /** Maximum number of entries in a block */
+  static const size_t BLOCK_SIZE = 128;
+
+  /** Default constructor */
+  BlockTimeContainer();
+  /** Copy constructor */
+  BlockTimeContainer(const BlockTimeContainer& copyFrom);
+  virtual ~BlockTimeContainer();
+
+  virtual TimeContainer* clone() const;
+  virtual size_t size() const;
+  virtual bool empty() const;
+  virtual TimeContainer::Iterator begin();
+  virtual TimeContainer::Iterator end();
+  virtual TimeContainer::Iterator lower_bound(double timeValue);
+  virtual TimeContainer::Iterator upper_bound(double timeValue);
+  virtual TimeContainer::Iterator findTimeAtOrBeforeGivenTime(double timeValue);
+  virtual TimeContainer::Iterator find(double timeValue);
+  virtual TimeContainer::Iterator findOrAddTime(double timeValue, bool* exactMatch=nullptr);
+  virtual void erase(Iterator iter, EraseBehavior eraseBehavior);
+  virtual DelayedFlushContainerPtr flush();
+  virtual void flush(const std::vector<DataColumn*>& columns, double startTime, double endTime);
+  virtual size_t copyEntries(double beginTime, double endTime, IteratorData* entries, size_t maxCount) const;
+
+  /// @copydoc TimeContainer::limitData()
+  virtual void limitData(size_t maxPoints, double latestInvalidTime, const std::vector<DataColumn*>& columns,
+    DataTable* table, const std::vector<DataTable::TableObserverPtr>& observers);
+
+  /**
+   * Returns the begin and end time of the container
+   * @param begin Returns the begin time
+   * @param end Returns the end time
+   * @returns 0 if begin and end are set
+   */
+  virtual int getTimeRange(double& begin, double& end) const;
+
+  /** Approximate number of bytes of memory used by the container, including its blocks */
+  virtual size_t memoryUsage() const;
+
+  /** Number of blocks in the container */
+  size_t numBlocks() const;
+  /** Number of blocks that could not be delta encoded and store full double precision times */
+  size_t numRawBlocks() const;
+
+private:
+  class Block;
+  class BlockIterator;
+  class FlushContainer;
+
+  /** Location of an entry; blockIndex of blocks_.size() represents end() */
+  struct Position
+  {
+    size_t blockIndex;
+    size_t offset;
+  };
+
+  /** Returns the position of the first entry with time >= timeValue (or > timeValue if upper) */
+  Position bound_(double timeValue, bool upper) const;
+  /** Inserts a new time at the position, which must be the sorted location for the time */
+  Position insert_(const Position& pos, double timeValue, size_t index);
+  /** Replaces the contents of a block, splitting it if it is over capacity */
+  void rebuildBlock_(size_t blockIndex, const std::vector<double>& times, const std::vector<size_t>& indices);
+  /** Removes entries [firstEntry, lastEntry) in time order, erasing their data from the columns and fixing indices */
+  void removeEntries_(size_t firstEntry, size_t lastEntry, const std::vector<DataColumn*>& columns);
+  /** Creates a new iterator at the given position */
+  TimeContainer::Iterator newIterator_(const Position& pos);
+
+  std::vector<Block> blocks_;
+  size_t size_;
+};
+
+/**
+ * Single block of a BlockTimeContainer.  Holds up to BLOCK_SIZE time-sorted entries.
+ * Exposed in the header only so that the container can store blocks contiguously.
+ */
+class BlockTimeContainer::Block
+{
+public:
+  Block();
+
+  /** Number of entries in the block */
+  size_t size() const;
+  /** Smallest time in the block */
+  double minTime() const;
+  /** Largest time in the block */
+  double maxTime() const;
+  /** Time of the entry at the given offset */
+  double time(size_t offset) const;
+  /** Data container index of the entry at the given offset */
+  size_t index(size_t offset) const;
+  /** Offset of the first entry with time >= timeValue (or > timeValue if upper) */
+  size_t bound(double timeValue, bool upper) const;
+  /** True if times are stored as full doubles instead of deltas */
+  bool isRaw() const;
+  /** Approximate number of bytes of dynamic memory used by the block */
+  size_t memoryUsage() const;
+
+  /** Adds an entry after the last entry; returns false if it cannot be encoded in this block */
+  bool append(double timeValue, size_t index);
+  /** Replaces the contents of the block with the time-sorted entries provided */
+  void assign(const double* times, const size_t* indices, size_t count);
+  /** Decodes the contents of the block */
+  void decode(std::vector<double>& times, std::vector<size_t>& indices) const;
+  /** Largest data container index in the block */
+  size_t maxIndex() const;
+  /** Subtracts a value from every index in the block; all indices must be at least the amount */
+  void shiftIndices(size_t amount);
+  /** Decrements every index greater than the removed index; the removed index must not be in the block */
+  void closeIndexGap(size_t removedIndex);
+
+private:
+  /** Attempts to add the time as a delta, changing scale if needed; returns false if it cannot be represented exactly */
+  bool appendDelta_(double timeValue);
+  /** Attempts to re-encode all entries and the new time with a finer scale */
+  bool rescale_(double scale, double timeValue);
+  /** Converts a time to units of 1/scale seconds; returns false if the time cannot be represented exactly */
+  bool toUnits_(double timeValue, double scale, int64_t& units) const;
+  /** Clears the contents of the block */
+  void clear_();
+
+  /// Time of the first entry
+  double baseTime_;
+  /// Time of the last entry
+  double maxTime_;
+  /// Number of time units per second; a power of ten or a power of two
+  double scale_;
+  /// Time of the first entry in units of 1/scale_ seconds
+  int64_t baseUnits_;
+  /// Units after baseUnits_ for each entry, when not raw
+  std::vector<uint32_t> deltas_;
+  /// Full times, only when the times cannot be delta encoded
+  std::vector<double> rawTimes_;
+  /// Index of the first entry, or smallest index when out of order
+  size_t baseIndex_;
+  /// Offsets from baseIndex_; empty when indices are sequential starting at baseIndex_
+  std::vector<uint32_t> indexOffsets_;
+  /// Number of entries in the block
+  size_t count_;
+  /// True when times are stored in rawTimes_
+  bool raw_;
+};
+
+} }
+
+#endif /* SIMDATA_MEMORYTABLE_BLOCKTIMECONTAINER_H */
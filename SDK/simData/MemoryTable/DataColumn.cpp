@@ -20,8 +20,11 @@
  * disclose, or release this software.
  *
  */
-#include <deque>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <deque>
+#include <limits>
 #include "simCore/Calc/Interpolation.h"
 #include "simData/DataTable.h"
 #include "simData/TableCellTranslator.h"
@@ -211,6 +214,18 @@ public:
   virtual TableStatus getValue(size_t position, double& value) const { return getValue_(position, value); }
   virtual TableStatus getValue(size_t position, std::string& value) const { return getValue_(position, value); }
 
+  // Retrieve the items at each of the given positions
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint8_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, int8_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint16_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, int16_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint32_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, int32_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint64_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, int64_t* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, float* values) const { return getValues_(positions, count, values); }
+  virtual TableStatus getValues(const size_t* positions, size_t count, double* values) const { return getValues_(positions, count, values); }
+
   ///Sets the row's cell to our value
   virtual TableStatus copyToRowCell(TableRow& row, simData::TableColumnId whichCell, size_t position) const
   {
@@ -282,6 +297,21 @@ private:
     TableCellTranslator::cast(*(data_.begin() + position), value);
     return TableStatus::Success();
   }
+
+  /// Template implementation of get-values at positions
+  template <typename DataType>
+  TableStatus getValues_(const size_t* positions, size_t count, DataType* values) const
+  {
+    const size_t dataSize = size();
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (positions[k] >= dataSize)
+        return TableStatus::Error("Column getValues: invalid index.");
+    }
+    for (size_t k = 0; k < count; ++k)
+      TableCellTranslator::cast(data_[positions[k]], values[k]);
+    return TableStatus::Success();
+  }
 };
 
 /////////////////////////////////////////////////////////////////
@@ -489,6 +519,100 @@ TableColumn::Iterator DataColumn::findAtOrBeforeTime(double timeValue) const
   return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->findTimeAtOrBeforeGivenTime(timeValue)));
 }
 
+template <typename DataType>
+size_t DataColumn::copyRange_(double beginTime, double endTime, DataType* values, double* times, size_t maxCount) const
+{
+  // Read the time container in chunks, so that positions can be kept on the stack
+  static const size_t CHUNK_SIZE = 256;
+  TimeContainer::IteratorData entries[CHUNK_SIZE];
+  size_t positions[CHUNK_SIZE];
+
+  size_t count = 0;
+  while (count < maxCount)
+  {
+    const size_t chunkSize = std::min(CHUNK_SIZE, maxCount - count);
+    const size_t numEntries = timeContainer_->copyEntries(beginTime, endTime, entries, chunkSize);
+
+    // Copy values one run of same-bin entries at a time
+    size_t runStart = 0;
+    while (runStart < numEntries)
+    {
+      const bool fresh = entries[runStart].isFreshBin();
+      size_t runEnd = runStart;
+      for (; runEnd < numEntries && entries[runEnd].isFreshBin() == fresh; ++runEnd)
+        positions[runEnd - runStart] = entries[runEnd].index();
+      const TableStatus status = dataContainer_(fresh)->getValues(positions, runEnd - runStart, values + count + runStart);
+      // Assertion failure means the time container and data container are out of sync
+      assert(status.isSuccess());
+      if (status.isError())
+        return count;
+      runStart = runEnd;
+    }
+    if (times != nullptr)
+    {
+      for (size_t k = 0; k < numEntries; ++k)
+        times[count + k] = entries[k].time();
+    }
+
+    count += numEntries;
+    if (numEntries < chunkSize)
+      break;
+    // Times are unique, so the next chunk starts just after the last time read
+    beginTime = std::nextafter(entries[numEntries - 1].time(), std::numeric_limits<double>::infinity());
+  }
+  return count;
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, uint8_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, int8_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, uint16_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, int16_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, uint32_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, int32_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, uint64_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, int64_t* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, float* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
+size_t DataColumn::copyRange(double beginTime, double endTime, double* values, double* times, size_t maxCount) const
+{
+  return copyRange_(beginTime, endTime, values, times, maxCount);
+}
+
 DataContainer* DataColumn::newDataContainer_(simData::VariableType variableType) const
 {
   switch (variableType)
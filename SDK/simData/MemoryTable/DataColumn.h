@@ -134,7 +134,25 @@ public:
    */
   virtual int getTimeRange(double& begin, double& end) const;
 
+  ///@{
+  /** Bulk copies cells in [beginTime, endTime), reading directly from the data containers */
+  virtual size_t copyRange(double beginTime, double endTime, uint8_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, int8_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, uint16_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, int16_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, uint32_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, int32_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, uint64_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, int64_t* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, float* values, double* times, size_t maxCount) const;
+  virtual size_t copyRange(double beginTime, double endTime, double* values, double* times, size_t maxCount) const;
+  ///@}
+
 private:
+  /// Template implementation of copyRange()
+  template <typename DataType>
+  size_t copyRange_(double beginTime, double endTime, DataType* values, double* times, size_t maxCount) const;
+
   /// Allocates a new data container based on the data storage type
   DataContainer* newDataContainer_(simData::VariableType variableType) const;
   /// Retrieves the data container, fresh or stale, as requested
@@ -84,6 +84,22 @@ public:
   virtual TableStatus getValue(size_t position, std::string& value) const = 0;
   ///@}
 
+  /**@name Data Container getValues() methods
+   * @{
+   */
+  /// Retrieve the items at each of the given positions; fails without copying if any position is invalid
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint8_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, int8_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint16_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, int16_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint32_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, int32_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, uint64_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, int64_t* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, float* values) const = 0;
+  virtual TableStatus getValues(const size_t* positions, size_t count, double* values) const = 0;
+  ///@}
+
   /** Copies the contents of a given position into a row at cell position whichCell */
   virtual TableStatus copyToRowCell(TableRow& row, simData::TableColumnId whichCell, size_t position) const = 0;
 
@@ -679,6 +679,30 @@ void DoubleBufferTimeContainer::flush_(TimeIndexDeque& deq, bool fresh, const st
 //  return ((*i).first == timeValue) ? i : deq.end();
 //}
 
+size_t DoubleBufferTimeContainer::copyEntries(double beginTime, double endTime, IteratorData* entries, size_t maxCount) const
+{
+  LessThan lessThan;
+  const TimeIndexDeque& staleDeq = staleTimes_();
+  const TimeIndexDeque& freshDeq = freshTimes_();
+  TimeIndexDeque::const_iterator staleIter = std::lower_bound(staleDeq.begin(), staleDeq.end(), beginTime, lessThan);
+  TimeIndexDeque::const_iterator freshIter = std::lower_bound(freshDeq.begin(), freshDeq.end(), beginTime, lessThan);
+
+  // Merge the two sorted bins, same as DoubleBufferIterator::next()
+  size_t count = 0;
+  while (count < maxCount)
+  {
+    const bool staleValid = (staleIter != staleDeq.end()) && (staleIter->first < endTime);
+    const bool freshValid = (freshIter != freshDeq.end()) && (freshIter->first < endTime);
+    if (staleValid && (!freshValid || staleIter->first < freshIter->first))
+      entries[count++] = IteratorData(*staleIter++, false);
+    else if (freshValid)
+      entries[count++] = IteratorData(*freshIter++, true);
+    else
+      break;
+  }
+  return count;
+}
+
 DoubleBufferTimeContainer::TimeIndexDeque::iterator DoubleBufferTimeContainer::lowerBound_(
   DoubleBufferTimeContainer::TimeIndexDeque& deq, double timeValue, bool* exactMatch) const
 {
@@ -807,4 +831,10 @@ int DoubleBufferTimeContainer::getTimeRange(double& begin, double& end) const
   return 0;
 }
 
+size_t DoubleBufferTimeContainer::memoryUsage() const
+{
+  // Deque storage is allocated in chunks; count the entries, which dominate for large containers
+  return sizeof(*this) + size() * sizeof(RowTimeToIndex);
+}
+
 } }
@@ -66,6 +66,7 @@ public:
   virtual void erase(Iterator iter, EraseBehavior eraseBehavior);
   virtual DelayedFlushContainerPtr flush();
   virtual void flush(const std::vector<DataColumn*>& columns, double startTime, double endTime);
+  virtual size_t copyEntries(double beginTime, double endTime, IteratorData* entries, size_t maxCount) const;
 
   /// @copydoc TimeContainer::limitData()
   virtual void limitData(size_t maxPoints, double latestInvalidTime, const std::vector<DataColumn*>& columns,
@@ -79,6 +80,9 @@ public:
    */
   virtual int getTimeRange(double& begin, double& end) const;
 
+  /** Approximate number of bytes of memory used by the container */
+  virtual size_t memoryUsage() const;
+
   /** Swaps the fresh to stale, stale to fresh, and clears out the fresh vector; announces all items removed */
   void swapFreshStaleData(DataTable* table, const std::vector<DataTable::TableObserverPtr>& observers);
 
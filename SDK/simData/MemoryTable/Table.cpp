@@ -25,7 +25,6 @@
 #include <algorithm>
 #include "simCore/Calc/Math.h"
 #include "simData/TableCellTranslator.h"
-#include "simData/MemoryTable/DoubleBufferTimeContainer.h"
 #include "simData/MemoryTable/SubTable.h"
 #include "simData/MemoryTable/TableManager.h"
 #include "simData/MemoryTable/DataLimitsProvider.h"
@@ -251,7 +250,7 @@ TableStatus Table::addColumn(const std::string& columnName, VariableType storage
   if (emptyTable == nullptr)
   {
     // Create an empty table with a new time container
-    emptyTable = new SubTable(new DoubleBufferTimeContainer(), tableId_);
+    emptyTable = new SubTable(tableManager_.newTimeContainer(), tableId_);
     // Add the column; possible to roll back this operation
     TableStatus rv = emptyTable->addColumn(columnName, nextId_, storageType, unitType, &returnColumn);
     if (rv.isError())
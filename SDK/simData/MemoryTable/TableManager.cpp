@@ -22,6 +22,7 @@
  */
 #include <cassert>
 #include <algorithm>
+#include "simData/MemoryTable/DoubleBufferTimeContainer.h"
 #include "simData/MemoryTable/Table.h"
 #include "simData/MemoryTable/TableManager.h"
 
@@ -110,7 +111,8 @@ private:
 TableManager::TableManager(const DataLimitsProvider* dataLimitsProvider)
   : nextId_(1),
     dataLimitsProvider_(dataLimitsProvider),
-    newRowDataListener_(new DefaultNewRowDataListener)
+    newRowDataListener_(new DefaultNewRowDataListener),
+    timeContainerPrototype_(nullptr)
 {
 }
 
@@ -129,6 +131,7 @@ TableManager::~TableManager()
   {
     delete i->second;
   }
+  delete timeContainerPrototype_;
 }
 
 TableStatus TableManager::addDataTable(ObjectId ownerId, const std::string& tableName, DataTable** newTable)
@@ -240,6 +243,23 @@ void TableManager::fireOnNewRowData(Table& table, double dataTime)
   newRowDataListener_->onNewRowData(table, table.ownerId(), dataTime);
 }
 
+void TableManager::setTimeContainerPrototype(TimeContainer* prototype)
+{
+  // Assertion failure means the prototype has data, which would be copied into every new subtable
+  assert(prototype == nullptr || prototype->empty());
+  if (prototype == timeContainerPrototype_)
+    return;
+  delete timeContainerPrototype_;
+  timeContainerPrototype_ = prototype;
+}
+
+TimeContainer* TableManager::newTimeContainer() const
+{
+  if (timeContainerPrototype_ == nullptr)
+    return new DoubleBufferTimeContainer();
+  return timeContainerPrototype_->clone();
+}
+
 void TableManager::addObserver(ManagerObserverPtr callback)
 {
   observers_.push_back(callback);
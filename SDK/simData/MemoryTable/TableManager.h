@@ -31,6 +31,7 @@ namespace simData { namespace MemoryTable {
 
 class Table;
 class DataLimitsProvider;
+class TimeContainer;
 
 /**
  * In-memory solution for the table manager.  Owns data tables in a map from ID to
@@ -95,6 +96,17 @@ public:
   /** Internal method for Table to use to alert on new row data */
   void fireOnNewRowData(Table& table, double dataTime);
 
+  /**
+   * Sets the time container that is cloned for subtables created from now on, such as a
+   * BlockTimeContainer to reduce memory use.  Existing subtables are not changed.
+   * @param prototype Empty time container to clone; ownership is taken.  Use nullptr to
+   *   restore the default DoubleBufferTimeContainer.
+   */
+  void setTimeContainerPrototype(TimeContainer* prototype);
+
+  /** Internal method for Table to create the time container for a new subtable */
+  TimeContainer* newTimeContainer() const;
+
 private:
   typedef std::vector<ManagerObserverPtr> ManagerObserverList;
   class MemTableList;
@@ -117,6 +129,8 @@ private:
 
   /// Pointer to tell when new rows are added
   NewRowDataListenerPtr newRowDataListener_;
+  /// Cloned for new subtables; nullptr for the default time container
+  TimeContainer* timeContainerPrototype_;
 };
 
 } }
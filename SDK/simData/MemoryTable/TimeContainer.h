@@ -54,6 +54,13 @@ public:
   class IteratorData
   {
   public:
+    /// Instantiates an entry for time 0 at index 0 of the fresh bin
+    IteratorData()
+      : time_(0.0),
+        index_(0),
+        isFreshBin_(true)
+    {
+    }
     /// Instantiates with a specific time and index.
     IteratorData(double t, size_t idx, bool isFreshBin)
       : time_(t),
@@ -185,6 +192,17 @@ public:
   /** Remove entries in the given time range; up to but not including endTime */
   virtual void flush(const std::vector<DataColumn*>& columns, double startTime, double endTime) = 0;
 
+  /**
+   * Copies up to maxCount entries with times in [beginTime, endTime) into entries, in time order.
+   * Bulk alternative to iteration for readers that do not need an iterator object.
+   * @param beginTime Time of the first entry, inclusive
+   * @param endTime Time after the last entry, exclusive
+   * @param entries Receives the entries; must have room for maxCount entries
+   * @param maxCount Maximum number of entries to copy
+   * @return Number of entries copied
+   */
+  virtual size_t copyEntries(double beginTime, double endTime, IteratorData* entries, size_t maxCount) const = 0;
+
   /**
    * Returns the begin and end time
    * @param begin Returns the begin time
@@ -192,6 +210,9 @@ public:
    * @returns 0 if begin and end are set
    */
   virtual int getTimeRange(double& begin, double& end) const = 0;
+
+  /** Approximate number of bytes of memory used by the container, for comparing time storage strategies */
+  virtual size_t memoryUsage() const = 0;
 };
 
 } }
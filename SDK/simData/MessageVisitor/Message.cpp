@@ -20,12 +20,250 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <deque>
 #include "simCore/String/Tokenizer.h"
 #include "simData/MessageVisitor/protobuf.h"
 #include "simData/MessageVisitor/Message.h"
 
+// Protobuf uses GetMessage(), which windows.h renames with #define to GetMessageA
+#ifdef WIN32
+#undef GetMessage
+#endif
+
 namespace simData { namespace protobuf {
 
+namespace {
+
+typedef google::protobuf::FieldDescriptor FieldDescriptor;
+typedef google::protobuf::Message Message;
+typedef google::protobuf::Reflection Reflection;
+typedef std::vector<const FieldDescriptor*> FieldVector;
+
+/** Stack of field descriptors from the top level message; turned into a path string only when a change is reported */
+typedef FieldVector FieldStack;
+
+/**
+ * Reusable lists of set fields, two per level of message nesting.  Only the fields that are set are visited, which
+ * is far cheaper than visiting every field in the descriptor since prefs messages are sparsely populated.
+ */
+class SetFields
+{
+public:
+  /** Fills and returns the list of set fields for the message, at the given nesting depth and side (0 or 1) */
+  const FieldVector& list(const Message& message, size_t depth, size_t side)
+  {
+    // deque does not invalidate references to existing lists when growing
+    while (lists_.size() <= 2 * depth + side)
+      lists_.push_back(FieldVector());
+    FieldVector& fields = lists_[2 * depth + side];
+    fields.clear();
+    message.GetReflection()->ListFields(message, &fields);
+    return fields;
+  }
+
+private:
+  std::deque<FieldVector> lists_;
+};
+
+bool messagesEqual(const Message& lhs, const Message& rhs, SetFields& setFields, size_t depth);
+
+/** Compares element 'index' of a repeated field, or the singular field if index is negative */
+bool fieldValuesEqual(const Message& lhs, const Message& rhs, const FieldDescriptor* field, int index, SetFields& setFields, size_t depth)
+{
+  const Reflection* lhsRefl = lhs.GetReflection();
+  const Reflection* rhsRefl = rhs.GetReflection();
+  const bool repeated = (index >= 0);
+  switch (field->cpp_type())
+  {
+  case FieldDescriptor::CPPTYPE_INT32:
+    return (repeated ? lhsRefl->GetRepeatedInt32(lhs, field, index) : lhsRefl->GetInt32(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedInt32(rhs, field, index) : rhsRefl->GetInt32(rhs, field));
+  case FieldDescriptor::CPPTYPE_INT64:
+    return (repeated ? lhsRefl->GetRepeatedInt64(lhs, field, index) : lhsRefl->GetInt64(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedInt64(rhs, field, index) : rhsRefl->GetInt64(rhs, field));
+  case FieldDescriptor::CPPTYPE_UINT32:
+    return (repeated ? lhsRefl->GetRepeatedUInt32(lhs, field, index) : lhsRefl->GetUInt32(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedUInt32(rhs, field, index) : rhsRefl->GetUInt32(rhs, field));
+  case FieldDescriptor::CPPTYPE_UINT64:
+    return (repeated ? lhsRefl->GetRepeatedUInt64(lhs, field, index) : lhsRefl->GetUInt64(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedUInt64(rhs, field, index) : rhsRefl->GetUInt64(rhs, field));
+  case FieldDescriptor::CPPTYPE_DOUBLE:
+  {
+    // Compare bits, like a serialized comparison would; NaN equals itself and 0.0 differs from -0.0
+    const double lhsValue = repeated ? lhsRefl->GetRepeatedDouble(lhs, field, index) : lhsRefl->GetDouble(lhs, field);
+    const double rhsValue = repeated ? rhsRefl->GetRepeatedDouble(rhs, field, index) : rhsRefl->GetDouble(rhs, field);
+    return memcmp(&lhsValue, &rhsValue, sizeof(double)) == 0;
+  }
+  case FieldDescriptor::CPPTYPE_FLOAT:
+  {
+    const float lhsValue = repeated ? lhsRefl->GetRepeatedFloat(lhs, field, index) : lhsRefl->GetFloat(lhs, field);
+    const float rhsValue = repeated ? rhsRefl->GetRepeatedFloat(rhs, field, index) : rhsRefl->GetFloat(rhs, field);
+    return memcmp(&lhsValue, &rhsValue, sizeof(float)) == 0;
+  }
+  case FieldDescriptor::CPPTYPE_BOOL:
+    return (repeated ? lhsRefl->GetRepeatedBool(lhs, field, index) : lhsRefl->GetBool(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedBool(rhs, field, index) : rhsRefl->GetBool(rhs, field));
+  case FieldDescriptor::CPPTYPE_ENUM:
+    return (repeated ? lhsRefl->GetRepeatedEnumValue(lhs, field, index) : lhsRefl->GetEnumValue(lhs, field)) ==
+      (repeated ? rhsRefl->GetRepeatedEnumValue(rhs, field, index) : rhsRefl->GetEnumValue(rhs, field));
+  case FieldDescriptor::CPPTYPE_STRING:
+  {
+    // Scratch strings are only used for non-standard string representations
+    std::string lhsScratch;
+    std::string rhsScratch;
+    if (repeated)
+      return lhsRefl->GetRepeatedStringReference(lhs, field, index, &lhsScratch) == rhsRefl->GetRepeatedStringReference(rhs, field, index, &rhsScratch);
+    return lhsRefl->GetStringReference(lhs, field, &lhsScratch) == rhsRefl->GetStringReference(rhs, field, &rhsScratch);
+  }
+  case FieldDescriptor::CPPTYPE_MESSAGE:
+    if (repeated)
+      return messagesEqual(lhsRefl->GetRepeatedMessage(lhs, field, index), rhsRefl->GetRepeatedMessage(rhs, field, index), setFields, depth + 1);
+    return messagesEqual(lhsRefl->GetMessage(lhs, field), rhsRefl->GetMessage(rhs, field), setFields, depth + 1);
+  }
+  return false;
+}
+
+/** Returns true if the field, which is set in both messages, has the same value(s) in both */
+bool setFieldEqual(const Message& lhs, const Message& rhs, const FieldDescriptor* field, SetFields& setFields, size_t depth)
+{
+  if (!field->is_repeated())
+    return fieldValuesEqual(lhs, rhs, field, -1, setFields, depth);
+
+  const int size = lhs.GetReflection()->FieldSize(lhs, field);
+  if (size != rhs.GetReflection()->FieldSize(rhs, field))
+    return false;
+  for (int k = 0; k < size; ++k)
+  {
+    if (!fieldValuesEqual(lhs, rhs, field, k, setFields, depth))
+      return false;
+  }
+  return true;
+}
+
+bool messagesEqual(const Message& lhs, const Message& rhs, SetFields& setFields, size_t depth)
+{
+  const FieldVector& lhsFields = setFields.list(lhs, depth, 0);
+  const FieldVector& rhsFields = setFields.list(rhs, depth, 1);
+  if (lhsFields != rhsFields)
+    return false;
+  for (FieldVector::const_iterator i = lhsFields.begin(); i != lhsFields.end(); ++i)
+  {
+    if (!setFieldEqual(lhs, rhs, *i, setFields, depth))
+      return false;
+  }
+  return true;
+}
+
+/** Replaces the field in 'to' with the field from 'from' */
+void copyField(const Message& from, Message& to, const FieldDescriptor* field)
+{
+  const Reflection* fromRefl = from.GetReflection();
+  const Reflection* toRefl = to.GetReflection();
+  toRefl->ClearField(&to, field);
+  if (field->is_repeated())
+  {
+    const int size = fromRefl->FieldSize(from, field);
+    for (int k = 0; k < size; ++k)
+    {
+      switch (field->cpp_type())
+      {
+      case FieldDescriptor::CPPTYPE_INT32: toRefl->AddInt32(&to, field, fromRefl->GetRepeatedInt32(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_INT64: toRefl->AddInt64(&to, field, fromRefl->GetRepeatedInt64(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_UINT32: toRefl->AddUInt32(&to, field, fromRefl->GetRepeatedUInt32(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_UINT64: toRefl->AddUInt64(&to, field, fromRefl->GetRepeatedUInt64(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_DOUBLE: toRefl->AddDouble(&to, field, fromRefl->GetRepeatedDouble(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_FLOAT: toRefl->AddFloat(&to, field, fromRefl->GetRepeatedFloat(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_BOOL: toRefl->AddBool(&to, field, fromRefl->GetRepeatedBool(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_ENUM: toRefl->AddEnumValue(&to, field, fromRefl->GetRepeatedEnumValue(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_STRING: toRefl->AddString(&to, field, fromRefl->GetRepeatedString(from, field, k)); break;
+      case FieldDescriptor::CPPTYPE_MESSAGE: toRefl->AddMessage(&to, field)->CopyFrom(fromRefl->GetRepeatedMessage(from, field, k)); break;
+      }
+    }
+    return;
+  }
+
+  if (!fromRefl->HasField(from, field))
+    return;
+  switch (field->cpp_type())
+  {
+  case FieldDescriptor::CPPTYPE_INT32: toRefl->SetInt32(&to, field, fromRefl->GetInt32(from, field)); break;
+  case FieldDescriptor::CPPTYPE_INT64: toRefl->SetInt64(&to, field, fromRefl->GetInt64(from, field)); break;
+  case FieldDescriptor::CPPTYPE_UINT32: toRefl->SetUInt32(&to, field, fromRefl->GetUInt32(from, field)); break;
+  case FieldDescriptor::CPPTYPE_UINT64: toRefl->SetUInt64(&to, field, fromRefl->GetUInt64(from, field)); break;
+  case FieldDescriptor::CPPTYPE_DOUBLE: toRefl->SetDouble(&to, field, fromRefl->GetDouble(from, field)); break;
+  case FieldDescriptor::CPPTYPE_FLOAT: toRefl->SetFloat(&to, field, fromRefl->GetFloat(from, field)); break;
+  case FieldDescriptor::CPPTYPE_BOOL: toRefl->SetBool(&to, field, fromRefl->GetBool(from, field)); break;
+  case FieldDescriptor::CPPTYPE_ENUM: toRefl->SetEnumValue(&to, field, fromRefl->GetEnumValue(from, field)); break;
+  case FieldDescriptor::CPPTYPE_STRING: toRefl->SetString(&to, field, fromRefl->GetString(from, field)); break;
+  case FieldDescriptor::CPPTYPE_MESSAGE: toRefl->MutableMessage(&to, field)->CopyFrom(fromRefl->GetMessage(from, field)); break;
+  }
+}
+
+/** Adds the path of the field on top of the stack to the list */
+void reportField(const FieldStack& stack, std::vector<std::string>* changedFields)
+{
+  if (changedFields == nullptr)
+    return;
+  std::string path;
+  for (FieldStack::const_iterator i = stack.begin(); i != stack.end(); ++i)
+  {
+    if (!path.empty())
+      path.append(".");
+    path.append((*i)->name());
+  }
+  changedFields->push_back(path);
+}
+
+bool copyChangedFields(const Message& from, Message& to, FieldStack& stack, std::vector<std::string>* changedFields, SetFields& setFields)
+{
+  const size_t depth = stack.size();
+  // Lists are sorted by field number; walk them together
+  const FieldVector& fromFields = setFields.list(from, depth, 0);
+  const FieldVector& toFields = setFields.list(to, depth, 1);
+  FieldVector::const_iterator fromIter = fromFields.begin();
+  FieldVector::const_iterator toIter = toFields.begin();
+  bool changed = false;
+  while (fromIter != fromFields.end() || toIter != toFields.end())
+  {
+    const FieldDescriptor* field;
+    bool differs = true;
+    if (toIter == toFields.end() || (fromIter != fromFields.end() && (*fromIter)->number() < (*toIter)->number()))
+      field = *fromIter++; // set only in from
+    else if (fromIter == fromFields.end() || (*toIter)->number() < (*fromIter)->number())
+      field = *toIter++; // set only in to
+    else
+    {
+      field = *fromIter++;
+      ++toIter;
+      if (!field->is_repeated() && field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE)
+      {
+        // Recurse into sub-messages set on both sides so that only the changed leaves are copied and reported
+        stack.push_back(field);
+        if (copyChangedFields(from.GetReflection()->GetMessage(from, field), *to.GetReflection()->MutableMessage(&to, field), stack, changedFields, setFields))
+          changed = true;
+        stack.pop_back();
+        continue;
+      }
+      differs = !setFieldEqual(from, to, field, setFields, depth + 1);
+    }
+
+    if (differs)
+    {
+      copyField(from, to, field);
+      stack.push_back(field);
+      reportField(stack, changedFields);
+      stack.pop_back();
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+}
+
 int getField(google::protobuf::Message& message, std::pair<google::protobuf::Message*, const google::protobuf::FieldDescriptor*>& out, const std::string& path)
 {
   std::vector<std::string> tokens;
@@ -105,5 +343,33 @@ int clearField(google::protobuf::Message& message, const std::string& path)
   return 0;
 }
 
+bool copyChangedFields(const google::protobuf::Message& from, google::protobuf::Message& to, std::vector<std::string>* changedFields)
+{
+  // if assert fails, the messages are not the same type
+  assert(from.GetDescriptor() == to.GetDescriptor());
+  // performance: a single pass over the set fields; most commits change nothing, and nothing is written for equal fields
+  FieldStack stack;
+  SetFields setFields;
+  return copyChangedFields(from, to, stack, changedFields, setFields);
+}
+
+bool containsField(const std::vector<std::string>& changedFields, const std::string& path)
+{
+  for (std::vector<std::string>::const_iterator i = changedFields.begin(); i != changedFields.end(); ++i)
+  {
+    // Match the path itself, or a parent or child on a "." boundary
+    const std::string& changed = *i;
+    const size_t common = std::min(changed.size(), path.size());
+    if (changed.compare(0, common, path, 0, common) != 0)
+      continue;
+    if (changed.size() == path.size())
+      return true;
+    const std::string& longer = (changed.size() > path.size()) ? changed : path;
+    if (longer[common] == '.')
+      return true;
+  }
+  return false;
+}
+
 }
 }
@@ -24,6 +24,7 @@
 #define SIMDATA_PROTOBUF_MESSAGE_H
 
 #include <string>
+#include <vector>
 #include "simCore/Common/Export.h"
 
 namespace google {
@@ -51,6 +52,27 @@ namespace simData { namespace protobuf {
   * @return 0 if field was found and cleared, non-0 if field was not found
   */
   SDKDATA_EXPORT int clearField(google::protobuf::Message& message, const std::string& path);
+
+  /**
+  * Copies the fields of one message that differ from another message of the same type, leaving equal fields untouched.
+  * Only the fields set in either message are compared, with reflection, so neither message is serialized.  Presence
+  * of optional fields is significant.
+  * Sub-messages are compared field by field; repeated fields are compared and copied as a whole.
+  * @param[in] from Message to copy from
+  * @param[in,out] to Message to copy into; must be the same type as from
+  * @param[out] changedFields If not nullptr, receives the "." separated path (e.g., "commonPrefs.offset.x") of each changed
+  *  field, using the same naming as MessageVisitor.  A sub-message that was added or removed is reported by its own path.
+  * @return true if any field differed
+  */
+  SDKDATA_EXPORT bool copyChangedFields(const google::protobuf::Message& from, google::protobuf::Message& to, std::vector<std::string>* changedFields);
+
+  /**
+  * Returns true if the field at path, one of its parent messages, or one of its child fields is in the list
+  * @param[in] changedFields List of "." separated paths, such as those returned by copyChangedFields()
+  * @param[in] path a "." separated path (e.g., "commonPrefs.draw")
+  * @return true if the field is impacted by the changes
+  */
+  SDKDATA_EXPORT bool containsField(const std::vector<std::string>& changedFields, const std::string& path);
 }}
 
 #endif
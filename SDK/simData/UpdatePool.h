@@ -0,0 +1,206 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_UPDATEPOOL_H
+#define SIMDATA_UPDATEPOOL_H
+
+#include <cstddef>
+#include <map>
+#include <new>
+#include <type_traits>
+
+namespace simData
+{
+
+/**
+ * Chunked allocator for data slice updates.  Updates are constructed in place inside
+ * contiguous chunks that grow geometrically in size, starting small so that entities
+ * with few points do not pay for a large chunk.  Released updates are destroyed
+ * immediately, but the memory for a chunk is only returned to the system once every
+ * update allocated from that chunk has been released.  Since data limiting and flushing
+ * remove updates in time order, and updates typically arrive in time order, memory is
+ * reclaimed a chunk at a time instead of one update at a time.
+ *
+ * Updates that were not allocated by the pool may be passed to release(); they are deleted.
+ */
+template <typename T>
+class UpdatePool
+{
+public:
+  /// Size of the first chunk, in updates
+  static const size_t MIN_CHUNK_SIZE = 16;
+  /// Largest chunk size, in updates
+  static const size_t MAX_CHUNK_SIZE = 1024;
+
+  UpdatePool()
+    : current_(nullptr),
+      lastReleased_(nullptr),
+      nextChunkSize_(MIN_CHUNK_SIZE),
+      numUpdates_(0)
+  {
+  }
+
+  /** Frees all chunks; updates should be released before the pool is destroyed, since remaining updates are not destructed */
+  ~UpdatePool()
+  {
+    for (typename ChunkMap::const_iterator i = chunks_.begin(); i != chunks_.end(); ++i)
+      deleteChunk_(i->second);
+  }
+
+  /** Returns a default constructed update.  Caller must return the update via release() */
+  T* allocate()
+  {
+    if (current_ == nullptr || current_->used == current_->capacity)
+      current_ = newChunk_();
+    T* rv = new (&current_->slots[current_->used]) T();
+    ++current_->used;
+    ++numUpdates_;
+    return rv;
+  }
+
+  /** Destroys the update; its chunk is freed once all of the chunk's updates have been released */
+  void release(T* update)
+  {
+    if (update == nullptr)
+      return;
+
+    Chunk* chunk = findChunk_(update);
+    if (chunk == nullptr)
+    {
+      // Not from this pool
+      delete update;
+      return;
+    }
+
+    update->~T();
+    --numUpdates_;
+    ++chunk->released;
+    if (chunk->released != chunk->used)
+    {
+      lastReleased_ = chunk;
+      return;
+    }
+
+    if (chunk == current_)
+    {
+      // Rewind the current chunk so that its memory is reused
+      chunk->used = 0;
+      chunk->released = 0;
+      lastReleased_ = chunk;
+      return;
+    }
+
+    // Chunk is full and fully released; return its memory
+    if (lastReleased_ == chunk)
+      lastReleased_ = nullptr;
+    chunks_.erase(reinterpret_cast<const char*>(chunk->slots));
+    deleteChunk_(chunk);
+  }
+
+  /** Returns true if the update was allocated by this pool */
+  bool owns(const T* update) const
+  {
+    return findChunk_(update) != nullptr;
+  }
+
+  /** Returns the number of updates allocated and not yet released */
+  size_t numUpdates() const
+  {
+    return numUpdates_;
+  }
+
+  /** Returns the number of chunks currently allocated */
+  size_t numChunks() const
+  {
+    return chunks_.size();
+  }
+
+private:
+  /// Raw storage for a single update
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+  /// Contiguous block of update storage
+  struct Chunk
+  {
+    Slot* slots;
+    size_t capacity;
+    size_t used;
+    size_t released;
+  };
+  /// Chunks keyed by the address of their first slot
+  typedef std::map<const char*, Chunk*> ChunkMap;
+
+  Chunk* newChunk_()
+  {
+    Chunk* chunk = new Chunk;
+    chunk->slots = new Slot[nextChunkSize_];
+    chunk->capacity = nextChunkSize_;
+    chunk->used = 0;
+    chunk->released = 0;
+    chunks_[reinterpret_cast<const char*>(chunk->slots)] = chunk;
+    if (nextChunkSize_ < MAX_CHUNK_SIZE)
+      nextChunkSize_ *= 2;
+    return chunk;
+  }
+
+  void deleteChunk_(Chunk* chunk) const
+  {
+    delete[] chunk->slots;
+    delete chunk;
+  }
+
+  static bool contains_(const Chunk* chunk, const T* update)
+  {
+    const char* address = reinterpret_cast<const char*>(update);
+    const char* begin = reinterpret_cast<const char*>(chunk->slots);
+    return address >= begin && address < reinterpret_cast<const char*>(chunk->slots + chunk->capacity);
+  }
+
+  Chunk* findChunk_(const T* update) const
+  {
+    // Releases tend to be sequential, so check the last chunk touched first
+    if (lastReleased_ != nullptr && contains_(lastReleased_, update))
+      return lastReleased_;
+    if (chunks_.empty())
+      return nullptr;
+
+    typename ChunkMap::const_iterator i = chunks_.upper_bound(reinterpret_cast<const char*>(update));
+    if (i == chunks_.begin())
+      return nullptr;
+    --i;
+    return contains_(i->second, update) ? i->second : nullptr;
+  }
+
+  ChunkMap chunks_;
+  Chunk* current_;
+  Chunk* lastReleased_;
+  size_t nextChunkSize_;
+  size_t numUpdates_;
+
+  // Not implemented
+  UpdatePool(const UpdatePool&);
+  UpdatePool& operator=(const UpdatePool&);
+};
+
+}
+
+#endif
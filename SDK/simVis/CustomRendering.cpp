@@ -240,6 +240,11 @@ const std::string CustomRenderingNode::getEntityName(EntityNode::NameType nameTy
   return getEntityName_(lastPrefs_.commonprefs(), nameType, allowBlankAlias);
 }
 
+bool CustomRenderingNode::hasTimeDependentUpdates() const
+{
+  return updateCallback_.valid() || EntityNode::hasTimeDependentUpdates();
+}
+
 bool CustomRenderingNode::updateFromDataStore(const simData::DataSliceBase* updateSliceBase, bool force)
 {
   if (updateCallback_ == nullptr)
@@ -171,6 +171,13 @@ public:
   */
   virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force=false);
 
+  /**
+  * Custom renderings with an update callback are updated every frame, since the callback decides
+  * what changed; a callback set after the entity's first update takes effect on its next update.
+  * @see EntityNode::hasTimeDependentUpdates()
+  */
+  virtual bool hasTimeDependentUpdates() const;
+
   /**
   * Flushes all the entity's data point visualization.
   */
@@ -179,7 +179,8 @@ void CoordSurfaceClamping::setUseMaxElevPrec(bool useMaxElevPrec)
 
 EntityNode::EntityNode(simData::ObjectType type, Locator* locator)
   : type_(type),
-    contentCallback_(new NullEntityCallback())
+    contentCallback_(new NullEntityCallback()),
+    customLabelContent_(false)
 {
   setNodeMask(0);  // Draw is off until a valid update is received
   setLocator(locator);
@@ -301,6 +302,8 @@ void EntityNode::setLabelContentCallback(LabelContentCallback* cb)
     contentCallback_ = new NullEntityCallback();
   else
     contentCallback_ = cb;
+  // checked here rather than on every frame
+  customLabelContent_ = (dynamic_cast<const NullEntityCallback*>(contentCallback_.get()) == nullptr);
 }
 
 LabelContentCallback& EntityNode::labelContentCallback() const
@@ -149,6 +149,8 @@ namespace simVis
     void setLabelContentCallback(LabelContentCallback* callback);
     /// Returns current content callback; guaranteed non-nullptr
     LabelContentCallback& labelContentCallback() const;
+    /// Returns true if the content callback is not the default, which adds no content
+    bool hasCustomLabelContent() const { return customLabelContent_; }
 
     /// Returns the pop up text based on the label content callback, update and preference
     virtual std::string popupText() const = 0;
@@ -277,6 +279,23 @@ namespace simVis
     */
     virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force=false) = 0;
 
+    /**
+    * Whether the entity may need updateFromDataStore() calls without new data or preferences, for
+    * example to refresh time-dependent graphics or custom label content. The ScenarioManager asks after
+    * each update of the entity, and checks needsFrameUpdate() on every update() only for entities that
+    * returned true. Hosted entities are also updated whenever their host applies an update.
+    * @return true if the entity has time-dependent work; default is true for active entities with custom label content
+    */
+    virtual bool hasTimeDependentUpdates() const { return isActive() && hasCustomLabelContent(); }
+
+    /**
+    * Whether updateFromDataStore() must be called at the data store's current time, even though the
+    * entity's update slice has not changed. Only called while hasTimeDependentUpdates() is true, on
+    * every update(), so this must be cheap.
+    * @return true if the entity needs an update at the current time; default is hasTimeDependentUpdates()
+    */
+    virtual bool needsFrameUpdate() const { return hasTimeDependentUpdates(); }
+
     /**
     * Notify the entity of a clock mode update. The implementation may
     * optionally override this method to respond to a mode change.
@@ -340,6 +359,7 @@ namespace simVis
     simData::ObjectType type_;
     osg::ref_ptr<Locator> locator_;
     osg::ref_ptr<LabelContentCallback> contentCallback_;
+    bool customLabelContent_;
     std::vector<osg::observer_ptr<ProjectorNode> > acceptedProjectors_;
   };
 
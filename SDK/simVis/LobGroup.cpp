@@ -622,6 +622,13 @@ bool LobGroupNode::updateFromDataStore(const simData::DataSliceBase *updateSlice
   return applyUpdate;
 }
 
+bool LobGroupNode::hasTimeDependentUpdates() const
+{
+  if (EntityNode::hasTimeDependentUpdates())
+    return true;
+  return ds_.dataTableManager().findTable(getId(), simData::INTERNAL_LOB_DRAWSTYLE_TABLE) != nullptr;
+}
+
 void LobGroupNode::flush()
 {
   lineCache_->clearCache(this);
@@ -135,6 +135,13 @@ public: // EntityNode interface
   */
   virtual bool updateFromDataStore(const simData::DataSliceBase *updateSlice, bool force=false) override;
 
+  /**
+  * LOB groups with a draw style table flash over time; a table created without new LOB data is
+  * noticed on the next LOB group update.
+  * @see EntityNode::hasTimeDependentUpdates()
+  */
+  virtual bool hasTimeDependentUpdates() const override;
+
   /**
   * Flushes all the entity's data point visualization
   */
@@ -65,6 +65,8 @@ static const simVis::Color SUN_VECTOR_COLOR = simVis::Color::Yellow;
 static const double HORIZON_RANGE_STEP = 100;
 // Distance in meters that a platform drawing optical or radio horizon must move vertically before the horizon is recalculated
 static const double HORIZON_ALT_STEP = 10;
+// Seconds per frame spent computing an optical or radio horizon, so that recalculation does not stall the frame
+static const double HORIZON_COMPUTE_BUDGET = 0.004;
 
 // this is used as a sentinel value for an platform that does not (currently) have a valid position
 static const simData::PlatformUpdate NULL_PLATFORM_UPDATE = simData::PlatformUpdate();
@@ -653,6 +655,32 @@ bool PlatformNode::updateFromDataStore(const simData::DataSliceBase* updateSlice
   return true;
 }
 
+bool PlatformNode::hasTimeDependentUpdates() const
+{
+  // Pending work that updateFromDataStore() has not applied yet
+  if (!lastPrefsValid_ || forceUpdateFromDataStore_ || queuedInvalidate_)
+    return true;
+  // Track history only changes with new data, but time ticks come due as time moves
+  return timeTicks_.valid() || drawsCustomLabel_();
+}
+
+bool PlatformNode::needsFrameUpdate() const
+{
+  // Pending work that updateFromDataStore() has not applied yet
+  if (!lastPrefsValid_ || forceUpdateFromDataStore_ || queuedInvalidate_)
+    return true;
+  // Time ticks are added and expire as time moves, even if the platform does not
+  if (timeTicks_.valid() && timeTicks_->needsUpdate())
+    return true;
+  return drawsCustomLabel_();
+}
+
+bool PlatformNode::drawsCustomLabel_() const
+{
+  // Custom label content can depend on time or on data outside the update slice; the default content is empty
+  return valid_ && lastPrefs_.commonprefs().labelprefs().draw() && hasCustomLabelContent();
+}
+
 bool PlatformNode::isActive_(const simData::PlatformPrefs& prefs) const
 {
   // the valid_ flag indicates that the platform node has data at current scenario time, but this can be manually overridden by the datadraw flag
@@ -1015,6 +1043,9 @@ void PlatformNode::updateOrRemoveHorizon_(simCore::HorizonCalculations horizonTy
     {
       opticalLosNode_ = losCreator_->newLosNode();
       opticalLosNode_->setNodeMask(simVis::DISPLAY_MASK_LABEL);
+      opticalLosNode_->setComputeTimeBudget(HORIZON_COMPUTE_BUDGET);
+      // terrain is resampled on lateral moves; altitude changes reuse it
+      opticalLosNode_->setOriginTolerance(osgEarth::Distance(HORIZON_RANGE_STEP, osgEarth::Units::METERS));
       addChild(opticalLosNode_);
     }
     los = opticalLosNode_;
@@ -1032,6 +1063,9 @@ void PlatformNode::updateOrRemoveHorizon_(simCore::HorizonCalculations horizonTy
     {
       radioLosNode_ = losCreator_->newLosNode();
       radioLosNode_->setNodeMask(simVis::DISPLAY_MASK_LABEL);
+      radioLosNode_->setComputeTimeBudget(HORIZON_COMPUTE_BUDGET);
+      // terrain is resampled on lateral moves; altitude changes reuse it
+      radioLosNode_->setOriginTolerance(osgEarth::Distance(HORIZON_RANGE_STEP, osgEarth::Units::METERS));
       addChild(radioLosNode_);
     }
     los = radioLosNode_;
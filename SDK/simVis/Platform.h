@@ -178,6 +178,20 @@ public: // EntityNode interface
   */
   virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false);
 
+  /**
+  * Platforms have time-dependent work while they draw time ticks or a label with custom content,
+  * or while a preference change or flush is waiting.
+  * @see EntityNode::hasTimeDependentUpdates()
+  */
+  virtual bool hasTimeDependentUpdates() const;
+
+  /**
+  * Platforms need an update without new data only when time ticks are due to be added or to expire,
+  * when a custom label content callback is shown, or while a preference change or flush is waiting.
+  * @see EntityNode::needsFrameUpdate()
+  */
+  virtual bool needsFrameUpdate() const;
+
   /**
   * Notifies the platform of a clock mode update.
   * override from EntityNode.
@@ -264,6 +278,9 @@ private:
   */
   bool isActive_(const simData::PlatformPrefs& prefs) const;
 
+  /** Returns true if the platform shows a label with content from a custom label content callback */
+  bool drawsCustomLabel_() const;
+
   /**
   * Indicates if the track history should exist in the scene, based on the expireMode, if the platform is active, non-static, and track history draw state is valid
   * @param prefs pref values to interrogate
@@ -198,6 +198,16 @@ PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simD
   return modified;
 }
 
+bool PlatformTspiFilterManager::isApplicable(const simData::PlatformPrefs& prefs) const
+{
+  for (std::vector<PlatformTspiFilter*>::const_iterator it = platformFilters_.begin(); it != platformFilters_.end(); ++it)
+  {
+    if ((*it)->isApplicable(prefs))
+      return true;
+  }
+  return false;
+}
+
 simCore::Coordinate PlatformTspiFilterManager::toCoordinate_(const simData::PlatformUpdate& update) const
 {
   simCore::Coordinate rv(simCore::COORD_SYS_ECEF, simCore::Vec3(update.x(), update.y(), update.z()));
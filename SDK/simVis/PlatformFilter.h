@@ -64,6 +64,9 @@ public:
   /// Filters the given platform state
   virtual FilterResponse filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props);
 
+  /// Returns true if any filter might modify the TSPI data for the given prefs; when false, filter() always returns POINT_UNCHANGED
+  bool isApplicable(const simData::PlatformPrefs& prefs) const;
+
 private:
   /// Returns simCore::Coordinate based off of update
   simCore::Coordinate toCoordinate_(const simData::PlatformUpdate& update) const;
@@ -20,11 +20,28 @@
  * disclose, or release this software.
  *
  */
+#ifdef WIN32
+#include "simCore/Common/Common.h"
+#else
+#include <unistd.h>
+#endif
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "osgDB/FileNameUtils"
 #include "osgDB/FileUtils"
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Math.h"
+#include "simCore/Common/MappedFile.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simCore/Common/Version.h"
 #include "simCore/LUT/LUT2.h"
 #include "simCore/String/Constants.h"
@@ -45,6 +62,195 @@
 
 namespace simRF {
 
+namespace
+{
+  /// Identifies an AREPS cache file
+  const char CACHE_MAGIC[8] = { 'A', 'R', 'E', 'P', 'S', 'L', 'U', 'T' };
+  /// Written in native byte order, so that files from a machine with another byte order are detected
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+  /// Incremented whenever the layout of the cache file changes
+  const uint32_t CACHE_VERSION = 1;
+  /// Extension added to AREPS filenames to name their cache files
+  const std::string CACHE_EXTENSION = ".arepsc";
+
+  /// Lookup tables present in a cache file
+  enum CacheFlags
+  {
+    CACHE_HAS_CNR = 0x1,
+    CACHE_HAS_LOSS = 0x2,
+    CACHE_HAS_FACTOR = 0x4
+  };
+
+  /// Header values that must be present for a file to be read without values from the first file of a set
+  enum RequiredHeaders
+  {
+    HEADER_ANT_HT = 0x01,
+    HEADER_HMAX = 0x02,
+    HEADER_HMIN = 0x04,
+    HEADER_NROUT = 0x08,
+    HEADER_NZOUT = 0x10,
+    HEADER_RMAX = 0x20,
+    HEADER_ALL = 0x3f
+  };
+
+  /// Fixed size start of a cache file; followed by the POD thresholds as floats, then the CNR, loss and PPF tables as shorts
+  struct CacheHeader
+  {
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t version;
+    /// Size in bytes of the AREPS file the cache was written from
+    uint64_t sourceSize;
+    /// Modification time of the AREPS file the cache was written from
+    int64_t sourceTime;
+    double antennaGaindBi;
+    double freqMHz;
+    double noiseFiguredB;
+    double pulseWidth_uSec;
+    double systemLossdB;
+    double xmtPowerKW;
+    double hbwD;
+    double antennaHeight;
+    double minHeight;
+    double maxHeight;
+    double maxRange;
+    uint64_t numRanges;
+    uint64_t numHeights;
+    /// Bearing in radians
+    double bearing;
+    uint32_t podCount;
+    /// Combination of CacheFlags
+    uint32_t flags;
+  };
+
+  /** Retrieves the size and modification time of a file; returns 0 on success */
+  int sourceStamp(const std::string& filename, uint64_t& size, int64_t& modified)
+  {
+#ifdef WIN32
+    struct _stat64 fileStat;
+    if (_wstat64(simCore::streamFixUtf8(filename).c_str(), &fileStat) != 0)
+      return 1;
+#else
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0)
+      return 1;
+#endif
+    size = static_cast<uint64_t>(fileStat.st_size);
+    modified = static_cast<int64_t>(fileStat.st_mtime);
+    return 0;
+  }
+
+  /** 64-bit FNV-1a hash, used to name cache files */
+  uint64_t fnv1aHash(const std::string& value)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (std::string::const_iterator i = value.begin(); i != value.end(); ++i)
+    {
+      hash ^= static_cast<unsigned char>(*i);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  /** Returns a temporary name next to a cache file, unique across processes and calls, for writing the cache */
+  std::string tempCacheName(const std::string& cacheFile)
+  {
+    static std::atomic<unsigned int> counter(0);
+#ifdef WIN32
+    const unsigned int pid = static_cast<unsigned int>(GetCurrentProcessId());
+#else
+    const unsigned int pid = static_cast<unsigned int>(getpid());
+#endif
+    std::ostringstream name;
+    name << cacheFile << "." << pid << "." << counter++ << ".tmp";
+    return name.str();
+  }
+
+  /** Validates the header of a mapped cache file against its source; returns 0 if the cache is usable */
+  int validateCache(const simCore::MappedFile& file, uint64_t sourceSize, int64_t sourceTime, CacheHeader& header)
+  {
+    if (file.size() < sizeof(header))
+      return 1;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 || header.byteOrder != BYTE_ORDER_MARK ||
+      header.version != CACHE_VERSION || header.sourceSize != sourceSize || header.sourceTime != sourceTime)
+      return 1;
+
+    // Bound the table dimensions by the file size before computing the expected size, to avoid overflow
+    const uint64_t fileSize = file.size();
+    if (header.numRanges == 0 || header.numHeights == 0 || header.numRanges > fileSize || header.numHeights > fileSize ||
+      (header.podCount != PODProfileDataProvider::POD_VECTOR_SIZE && header.podCount != 0))
+      return 1;
+    uint64_t expectedSize = sizeof(header) + header.podCount * sizeof(float);
+    if (header.flags & CACHE_HAS_CNR)
+      expectedSize += header.numRanges * sizeof(short);
+    if (header.flags & CACHE_HAS_LOSS)
+      expectedSize += header.numRanges * header.numHeights * sizeof(short);
+    if (header.flags & CACHE_HAS_FACTOR)
+      expectedSize += header.numRanges * header.numHeights * sizeof(short);
+    return (expectedSize == fileSize) ? 0 : 1;
+  }
+
+  /** Copies a table from a cache file into a newly allocated LUT, advancing the read position */
+  simCore::LUT::LUT2<short>* readTable(const char*& pos, double minHeight, double maxHeight, size_t numHeights, double minRange, double maxRange, size_t numRanges)
+  {
+    simCore::LUT::LUT2<short>* lut = new simCore::LUT::LUT2<short>();
+    lut->initialize(minHeight, maxHeight, numHeights, minRange, maxRange, numRanges);
+    const size_t rowSize = numRanges * sizeof(short);
+    for (size_t i = 0; i < numHeights; ++i)
+    {
+      memcpy(&(*lut)(i, 0), pos, rowSize);
+      pos += rowSize;
+    }
+    return lut;
+  }
+
+  /** Writes a table to a cache file */
+  void writeTable(std::ostream& out, const simCore::LUT::LUT2<short>& lut)
+  {
+    for (size_t i = 0; i < lut.numX(); ++i)
+      out.write(reinterpret_cast<const char*>(&lut(i, 0)), lut.numY() * sizeof(short));
+  }
+}
+
+/// Values read from a single AREPS file or cache file
+struct ArepsLoader::FileData
+{
+  FileData()
+    : antennaHeight(0.0),
+      maxHeight(0.0),
+      minHeight(0.0),
+      numRanges(0),
+      numHeights(0),
+      maxRange(0.0),
+      headers(0),
+      bearing(-1.0),
+      cacheable(true)
+  {
+  }
+
+  simCore::RadarParameters radarParameters;
+  double antennaHeight;
+  double maxHeight;
+  double minHeight;
+  size_t numRanges;
+  size_t numHeights;
+  double maxRange;
+  /// Combination of RequiredHeaders found in the file
+  unsigned int headers;
+  /// POD thresholds, if present in the file
+  std::vector<float> pod;
+  /// Bearing in radians
+  double bearing;
+  std::unique_ptr<simCore::LUT::LUT1<short> > cnr;
+  std::unique_ptr<simCore::LUT::LUT2<short> > loss;
+  std::unique_ptr<simCore::LUT::LUT2<short> > factor;
+  /// False if the file contained errors that were ignored, so that its values cannot be reused
+  bool cacheable;
+  /// Description of the error, if reading failed
+  std::string error;
+};
+
 ArepsLoader::ArepsLoader(RFPropagationFacade* beamHandler)
   : maxHeight_(0.0),
   minHeight_(0.0),
@@ -53,7 +259,8 @@ ArepsLoader::ArepsLoader(RFPropagationFacade* beamHandler)
   maxRange_(0.0),
   minRange_(0.0),
   antennaHgt_(0.0),
-  beamHandler_(beamHandler)
+  beamHandler_(beamHandler),
+  cacheEnabled_(false)
 {
 }
 
@@ -66,8 +273,52 @@ double ArepsLoader::getAntennaHeight() const
   return antennaHgt_;
 }
 
+void ArepsLoader::setCache(bool enabled, const std::string& cacheDirectory)
+{
+  cacheEnabled_ = enabled;
+  cacheDirectory_ = cacheDirectory;
+}
+
+bool ArepsLoader::cacheEnabled() const
+{
+  return cacheEnabled_;
+}
+
+const std::string& ArepsLoader::cacheDirectory() const
+{
+  return cacheDirectory_;
+}
+
+std::string ArepsLoader::cacheFilename(const std::string& arepsFile) const
+{
+  if (cacheDirectory_.empty())
+    return arepsFile + CACHE_EXTENSION;
+  // Hash the full path, so that files with the same name in different directories do not collide
+  std::ostringstream name;
+  name << std::hex << std::setfill('0') << std::setw(16) << fnv1aHash(osgDB::getRealPath(arepsFile)) << CACHE_EXTENSION;
+  return osgDB::concatPaths(cacheDirectory_, name.str());
+}
+
 int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile, bool firstFile)
 {
+  FileData data;
+  initFileData_(data);
+
+  uint64_t sourceSize = 0;
+  int64_t sourceTime = 0;
+  const bool useCache = cacheEnabled_ && (sourceStamp(arepsFile, sourceSize, sourceTime) == 0);
+  const std::string cacheFile = useCache ? cacheFilename(arepsFile) : "";
+  if (useCache)
+  {
+    FileData cached;
+    // Tables in the cache use the file's own grid, which must match the grid of the first file
+    if (readCache_(cacheFile, sourceSize, sourceTime, cached) == 0 && (firstFile || matchesGrid_(cached)))
+    {
+      SIM_INFO << "Loading AREPS file: " << simCore::toNativeSeparators(arepsFile) << " from cache" << std::endl;
+      return apply_(arepsFile, cached, profile, firstFile);
+    }
+  }
+
   // create stream to input file
   std::ifstream inFile(simCore::streamFixUtf8(arepsFile));
   if (!inFile)
@@ -80,9 +331,67 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
     SIM_INFO << "Loading AREPS file: " << simCore::toNativeSeparators(arepsFile) << std::endl;
   }
 
+  if (parseText_(arepsFile, inFile, data, firstFile, firstFile && beamHandler_ != nullptr) != 0)
+  {
+    SIM_ERROR << data.error << std::endl;
+    return 1;
+  }
+
+  if (useCache && isCacheable_(data, firstFile) && writeCache_(cacheFile, sourceSize, sourceTime, data) != 0)
+  {
+    SIM_WARN << "Could not write AREPS cache file: " << simCore::toNativeSeparators(cacheFile) << std::endl;
+  }
+  return apply_(arepsFile, data, profile, firstFile);
+}
+
+void ArepsLoader::initFileData_(FileData& data) const
+{
+  data.antennaHeight = antennaHgt_;
+  data.maxHeight = maxHeight_;
+  data.minHeight = minHeight_;
+  data.numRanges = numRanges_;
+  data.numHeights = numHeights_;
+  data.maxRange = maxRange_;
+}
+
+bool ArepsLoader::matchesGrid_(const FileData& data) const
+{
+  return data.maxHeight == maxHeight_ && data.minHeight == minHeight_ && data.numRanges == numRanges_ &&
+    data.numHeights == numHeights_ && data.maxRange == maxRange_;
+}
+
+bool ArepsLoader::isCacheable_(const FileData& data, bool firstFile) const
+{
+  // Tables of later files use the grid of the first file; only cache them if that is also the file's own grid
+  return data.cacheable && data.headers == HEADER_ALL && (firstFile || matchesGrid_(data));
+}
+
+bool ArepsLoader::headerError_(FileData& data, bool firstFile, const std::string& value, const std::string& arepsFile) const
+{
+  if (firstFile)
+  {
+    data.error = "Could not determine " + value + " for AREPS file: " + arepsFile;
+    return true;
+  }
+  // Header values of later files are not used, but the file cannot be read on its own
+  data.cacheable = false;
+  return false;
+}
+
+int ArepsLoader::parseText_(const std::string& arepsFile, std::istream& inFile, FileData& data, bool firstFile, bool requirePod) const
+{
   // Older versions of AREPS file had bearing embedding in filename
-  double bearingAngleRad = getBearingAngle_(arepsFile);
-  simCore::RadarParameters radarParameters;
+  data.bearing = getBearingAngle_(arepsFile);
+  simCore::RadarParameters& radarParameters = data.radarParameters;
+  // lookup tables of later files use the grid of the first file
+  const FileData* grid = &data;
+  FileData firstGrid;
+  if (!firstFile)
+  {
+    initFileData_(firstGrid);
+    grid = &firstGrid;
+  }
+
   std::string st;
   while (simCore::getStrippedLine(inFile, st))
   {
@@ -95,165 +404,144 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
     size_t vecLen = tmpvec.size();
     if (vecLen > 0 && tmpvec[0] != "#")
     {
-      // some values are only read/processed for the first file (of a multi-file set)
-      if (firstFile)
+      // header values are only used from the first file (of a multi-file set), but are read from every
+      // file so that each file's values can be cached
+      if ((tmpvec[0] == "AntGain") && vecLen >= 3)
       {
-        if ((tmpvec[0] == "AntGain") && vecLen >= 3)
-        {
-          //# Antenna gain in dBi
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.antennaGaindBi))
-          {
-            SIM_ERROR << "Could not determine antenna gain for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "AntHt") && vecLen >= 3)
-        {
-          //# Antenna ht(m) above ground
-          if (!simCore::isValidNumber(tmpvec[2], antennaHgt_))
-          {
-            SIM_ERROR << "Could not determine antenna height for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Freq") && vecLen >= 3)
-        {
-          //# Frequency(MHz)
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.freqMHz))
-          {
-            SIM_ERROR << "Could not determine freq for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Noise") && vecLen >= 3)
-        {
-          //# Noise figure
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.noiseFiguredB))
-          {
-            SIM_ERROR << "Could not determine noiseFigure for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "PulseWidth") && vecLen >= 3)
-        {
-          //#  Pulse width or length in usec
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.pulseWidth_uSec))
-          {
-            SIM_ERROR << "Could not determine pulseWidth for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "SysLoss") && vecLen >= 3)
-        {
-          //# System losses in dB
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.systemLossdB))
-          {
-            SIM_ERROR << "Could not determine system loss for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "TransPower") && vecLen >= 3)
-        {
-          //# Transmitter power in KW
-          if (!simCore::isValidNumber(tmpvec[2], radarParameters.xmtPowerKW))
-          {
-            SIM_ERROR << "Could not determine xmtPower for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Hmax") && vecLen >= 3)
-        {
-          //# Maximum height Meters
-          if (!simCore::isValidNumber(tmpvec[2], maxHeight_))
-          {
-            SIM_ERROR << "Could not determine max height for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Hmin") && vecLen >= 3)
-        {
-          //# Minimum height Meters
-          if (!simCore::isValidNumber(tmpvec[2], minHeight_))
-          {
-            SIM_ERROR << "Could not determine min height for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Nrout") && vecLen >= 3)
-        {
-          //# Number of range steps to output
-          if (!simCore::isValidNumber(tmpvec[2], numRanges_))
-          {
-            SIM_ERROR << "Could not determine number of ranges for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if ((tmpvec[0] == "Nzout") && vecLen >= 3)
+        //# Antenna gain in dBi
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.antennaGaindBi) && headerError_(data, firstFile, "antenna gain", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "AntHt") && vecLen >= 3)
+      {
+        //# Antenna ht(m) above ground
+        if (simCore::isValidNumber(tmpvec[2], data.antennaHeight))
+          data.headers |= HEADER_ANT_HT;
+        else if (headerError_(data, firstFile, "antenna height", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Freq") && vecLen >= 3)
+      {
+        //# Frequency(MHz)
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.freqMHz) && headerError_(data, firstFile, "freq", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Noise") && vecLen >= 3)
+      {
+        //# Noise figure
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.noiseFiguredB) && headerError_(data, firstFile, "noiseFigure", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "PulseWidth") && vecLen >= 3)
+      {
+        //#  Pulse width or length in usec
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.pulseWidth_uSec) && headerError_(data, firstFile, "pulseWidth", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "SysLoss") && vecLen >= 3)
+      {
+        //# System losses in dB
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.systemLossdB) && headerError_(data, firstFile, "system loss", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "TransPower") && vecLen >= 3)
+      {
+        //# Transmitter power in KW
+        if (!simCore::isValidNumber(tmpvec[2], radarParameters.xmtPowerKW) && headerError_(data, firstFile, "xmtPower", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Hmax") && vecLen >= 3)
+      {
+        //# Maximum height Meters
+        if (simCore::isValidNumber(tmpvec[2], data.maxHeight))
+          data.headers |= HEADER_HMAX;
+        else if (headerError_(data, firstFile, "max height", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Hmin") && vecLen >= 3)
+      {
+        //# Minimum height Meters
+        if (simCore::isValidNumber(tmpvec[2], data.minHeight))
+          data.headers |= HEADER_HMIN;
+        else if (headerError_(data, firstFile, "min height", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Nrout") && vecLen >= 3)
+      {
+        //# Number of range steps to output
+        if (simCore::isValidNumber(tmpvec[2], data.numRanges))
+          data.headers |= HEADER_NROUT;
+        else if (headerError_(data, firstFile, "number of ranges", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Nzout") && vecLen >= 3)
+      {
+        //# Number of height points to output
+        if (simCore::isValidNumber(tmpvec[2], data.numHeights))
         {
-          //# Number of height points to output
-          if (!simCore::isValidNumber(tmpvec[2], numHeights_))
-          {
-            SIM_ERROR << "Could not determine number of heights for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
           // add 1 due to incorrect value specified by AREPS
-          ++numHeights_;
+          ++data.numHeights;
+          data.headers |= HEADER_NZOUT;
         }
-        else if ((tmpvec[0] == "Rmax") && vecLen >= 3)
-        {
-          //# Maximum range in meters
-          if (!simCore::isValidNumber(tmpvec[2], maxRange_))
-          {
-            SIM_ERROR << "Could not determine max range for AREPS file: " << arepsFile << std::endl;
-            return 1;
-          }
-        }
-        else if (beamHandler_ && (st == "[Probability of detection]"))
+        else if (headerError_(data, firstFile, "number of heights", arepsFile))
+          return 1;
+      }
+      else if ((tmpvec[0] == "Rmax") && vecLen >= 3)
+      {
+        //# Maximum range in meters
+        if (simCore::isValidNumber(tmpvec[2], data.maxRange))
+          data.headers |= HEADER_RMAX;
+        else if (headerError_(data, firstFile, "max range", arepsFile))
+          return 1;
+      }
+      else if (st == "[Probability of detection]")
+      {
+        // skip comment
+        simCore::getStrippedLine(inFile, st);
+        // Thresholds in DB for a probability of detection from 1% to 100%, 10 lines of 10 values
+        // expected to be positive, in decreasing order;
+        // they are sign-inverted by setPODLossThreshold, producing a vector of negative thresholds, in increasing order.
+        std::vector<float> podVector;
+        podVector.reserve(PODProfileDataProvider::POD_VECTOR_SIZE);
+        std::string podError;
+        for (size_t i = 0; i < 10 && podError.empty(); i++)
         {
-          // skip comment
           simCore::getStrippedLine(inFile, st);
-          // Thresholds in DB for a probability of detection from 1% to 100%, 10 lines of 10 values
-          // expected to be positive, in decreasing order;
-          // they are sign-inverted by setPODLossThreshold, producing a vector of negative thresholds, in increasing order.
-          std::vector<float> podVector;
-          podVector.reserve(PODProfileDataProvider::POD_VECTOR_SIZE);
-          for (size_t i = 0; i < 10; i++)
-          {
-            simCore::getStrippedLine(inFile, st);
-
-            std::vector<std::string> pdVec;
-            //remove quotes
-            simCore::stringTokenizer(pdVec, simCore::StringUtils::substitute(st, "\"", ""));
-            if (pdVec.size() != 10)
-            {
-              SIM_ERROR << "Bad formatting of POD data for AREPS file: " << arepsFile << std::endl;
-              return 1;
-            }
 
-            for (size_t j = 0; j < 10; j++)
-            {
-              float pdVal = 0.0;
-              if (!simCore::isValidNumber(pdVec[j], pdVal) || pdVal < 0)
-              {
-                // if assert fails, the AREPS file contains negative POD thresholds.
-                assert(pdVal >= 0);
-                SIM_ERROR << "Invalid data in POD data for AREPS file: " << arepsFile << std::endl;
-                return 1;
-              }
-              podVector.push_back(pdVal);
-            }
-          }
-          if (podVector.size() != PODProfileDataProvider::POD_VECTOR_SIZE)
+          std::vector<std::string> pdVec;
+          //remove quotes
+          simCore::stringTokenizer(pdVec, simCore::StringUtils::substitute(st, "\"", ""));
+          if (pdVec.size() != 10)
           {
-            SIM_ERROR << "Invalid POD data for AREPS file: " << arepsFile << std::endl;
-            return 1;
+            podError = "Bad formatting of POD data for AREPS file: " + arepsFile;
+            break;
           }
-          if (0 != beamHandler_->setPODLossThreshold(podVector))
+
+          for (size_t j = 0; j < 10; j++)
           {
-            SIM_ERROR << "Error saving POD data for AREPS file: " << arepsFile << std::endl;
-            return 1;
+            float pdVal = 0.0;
+            if (!simCore::isValidNumber(pdVec[j], pdVal) || pdVal < 0)
+            {
+              // if assert fails, the AREPS file contains negative POD thresholds.
+              assert(pdVal >= 0);
+              podError = "Invalid data in POD data for AREPS file: " + arepsFile;
+              break;
+            }
+            podVector.push_back(pdVal);
           }
         }
+        if (podError.empty() && podVector.size() != PODProfileDataProvider::POD_VECTOR_SIZE)
+          podError = "Invalid POD data for AREPS file: " + arepsFile;
+
+        if (podError.empty())
+          data.pod.swap(podVector);
+        else if (requirePod)
+        {
+          data.error = podError;
+          return 1;
+        }
+        else
+          data.cacheable = false;
       }
 
       // the following entries are processed for every file in a fileset
@@ -268,11 +556,11 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
         if (simCore::isValidNumber(bearVec[0], bearingAngleDeg))
         {
           // convert degrees to radians
-          bearingAngleRad = simCore::angFix2PI(bearingAngleDeg * simCore::DEG2RAD);
+          data.bearing = simCore::angFix2PI(bearingAngleDeg * simCore::DEG2RAD);
         }
         else
         {
-          SIM_ERROR << "Could not determine bearing for AREPS file: " << arepsFile << std::endl;
+          data.error = "Could not determine bearing for AREPS file: " + arepsFile;
           return 1;
         }
       }
@@ -281,7 +569,7 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
         //# Horizontal beam width in deg
         if (!simCore::isValidNumber(tmpvec[2], radarParameters.hbwD))
         {
-          SIM_ERROR << "Could not determine beam width for AREPS file: " << arepsFile << std::endl;
+          data.error = "Could not determine beam width for AREPS file: " + arepsFile;
           return 1;
         }
       }
@@ -290,11 +578,12 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
         // skip comment
         simCore::getStrippedLine(inFile, st);
 
-        simCore::LUT::LUT1<short>* cnr = new simCore::LUT::LUT1<short>();
-
+        const size_t numRanges = grid->numRanges;
         // minRange and rangeStep are the same
-        minRange_ = (numRanges_ == 0) ? 0 : (maxRange_ / numRanges_);
-        cnr->initialize(minRange_, maxRange_, numRanges_);
+        const double minRange = (numRanges == 0) ? 0 : (grid->maxRange / numRanges);
+        data.cnr.reset(new simCore::LUT::LUT1<short>());
+        simCore::LUT::LUT1<short>& cnr = *data.cnr;
+        cnr.initialize(minRange, grid->maxRange, numRanges);
 
         size_t rngCnt = 0;
         std::vector<std::string> noiseVec;
@@ -314,21 +603,16 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
           {
             // AREPS CNR data stored as decibels, convert to centibels
             float cnr_dB;
-            if (rngCnt == numRanges_ || !simCore::isValidNumber(noiseVec[i], cnr_dB))
+            if (rngCnt == numRanges || !simCore::isValidNumber(noiseVec[i], cnr_dB))
             {
-              SIM_ERROR << "Invalid CNR data for AREPS file: " << arepsFile << std::endl;
-              delete cnr;
+              data.error = "Invalid CNR data for AREPS file: " + arepsFile;
               return 1;
             }
             short cnr_cB = static_cast<short>(simCore::rint(cnr_dB * SCALE_FACTOR));
-            (*cnr)(rngCnt) = cnr_cB;
+            cnr(rngCnt) = cnr_cB;
             rngCnt++;
           }
-        } while (rngCnt < numRanges_);
-
-        // data must be populated in the provider prior to assigning to profile, provider takes ownership of the cnr LUT
-        profile.addProvider(
-          new simRF::LUT1ProfileDataProvider(cnr, ProfileDataProvider::THRESHOLDTYPE_CNR, 1.0/SCALE_FACTOR));
+        } while (rngCnt < numRanges);
       }
       else if (st == "[Apm Loss Data]" || st == "[Apm Factor Data]")
       {
@@ -342,9 +626,13 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
           type = ProfileDataProvider::THRESHOLDTYPE_FACTOR;
         }
 
-        minRange_ = (numRanges_ == 0) ? 0 : (maxRange_ / numRanges_);
-        simCore::LUT::LUT2<short>* loss = new simCore::LUT::LUT2<short>();
-        loss->initialize(minHeight_, maxHeight_, numHeights_, minRange_, maxRange_, numRanges_);
+        const size_t numRanges = grid->numRanges;
+        const size_t numHeights = grid->numHeights;
+        const double minRange = (numRanges == 0) ? 0 : (grid->maxRange / numRanges);
+        std::unique_ptr<simCore::LUT::LUT2<short> >& lut = (type == ProfileDataProvider::THRESHOLDTYPE_LOSS) ? data.loss : data.factor;
+        lut.reset(new simCore::LUT::LUT2<short>());
+        simCore::LUT::LUT2<short>& loss = *lut;
+        loss.initialize(grid->minHeight, grid->maxHeight, numHeights, minRange, grid->maxRange, numRanges);
 
         // parse APM data in AREPS file
         std::vector<std::string> vec;
@@ -356,7 +644,7 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
           simCore::getStrippedLine(inFile, st);
         } while (st.find("Height(") == std::string::npos);
 
-        for (size_t i = 0; i < static_cast<size_t>(numHeights_); i++)
+        for (size_t i = 0; i < numHeights; i++)
         {
           // read first data line
           simCore::getStrippedLine(inFile, st);
@@ -368,37 +656,260 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
             {
               // read in centibel data, then store in LUT
               short lossVal = 0;
-              if (k == numRanges_ || !simCore::isValidNumber(vec[j], lossVal))
+              if (k == numRanges || !simCore::isValidNumber(vec[j], lossVal))
               {
                 if (type == ProfileDataProvider::THRESHOLDTYPE_LOSS)
-                {
-                  SIM_ERROR << "Invalid Loss data for AREPS file: " << arepsFile << std::endl;
-                }
+                  data.error = "Invalid Loss data for AREPS file: " + arepsFile;
                 else
-                {
-                  SIM_ERROR << "Invalid PPF data for AREPS file: " << arepsFile << std::endl;
-                }
-                delete loss;
+                  data.error = "Invalid PPF data for AREPS file: " + arepsFile;
                 return 1;
               }
 
               // fix incorrect initialization value
               if (lossVal == ERRONEOUS_INIT_VALUE)
                 lossVal = INIT_VALUE;
-              (*loss)(i, k) = lossVal;
+              loss(i, k) = lossVal;
               k++;
             }
             simCore::getStrippedLine(inFile, st);
-          } while (k < static_cast<size_t>(numRanges_));
+          } while (k < numRanges);
         } // end of for numHeights
-
-        // loss/ppf data provided must be populated prior to assigning to profile, provider takes ownership of the LUT
-        profile.addProvider(
-          new simRF::LUTProfileDataProvider(loss, type, 1.0/SCALE_FACTOR));
       }
     }
   } // end of while (simCore::getStrippedLine ...
 
+  return 0;
+}
+
+int ArepsLoader::readCache_(const std::string& cacheFile, uint64_t sourceSize, int64_t sourceTime, FileData& data) const
+{
+  simCore::MappedFile file;
+  CacheHeader header;
+  if (file.open(cacheFile) != 0 || validateCache(file, sourceSize, sourceTime, header) != 0)
+    return 1;
+
+  data.radarParameters.antennaGaindBi = header.antennaGaindBi;
+  data.radarParameters.freqMHz = header.freqMHz;
+  data.radarParameters.noiseFiguredB = header.noiseFiguredB;
+  data.radarParameters.pulseWidth_uSec = header.pulseWidth_uSec;
+  data.radarParameters.systemLossdB = header.systemLossdB;
+  data.radarParameters.xmtPowerKW = header.xmtPowerKW;
+  data.radarParameters.hbwD = header.hbwD;
+  data.antennaHeight = header.antennaHeight;
+  data.minHeight = header.minHeight;
+  data.maxHeight = header.maxHeight;
+  data.maxRange = header.maxRange;
+  data.numRanges = static_cast<size_t>(header.numRanges);
+  data.numHeights = static_cast<size_t>(header.numHeights);
+  data.headers = HEADER_ALL;
+  data.bearing = header.bearing;
+
+  const char* pos = file.data() + sizeof(header);
+  data.pod.resize(header.podCount);
+  if (header.podCount > 0)
+  {
+    memcpy(&data.pod[0], pos, header.podCount * sizeof(float));
+    pos += header.podCount * sizeof(float);
+  }
+
+  const double minRange = data.maxRange / data.numRanges;
+  if (header.flags & CACHE_HAS_CNR)
+  {
+    data.cnr.reset(new simCore::LUT::LUT1<short>());
+    data.cnr->initialize(minRange, data.maxRange, data.numRanges);
+    memcpy(&(*data.cnr)(0), pos, data.numRanges * sizeof(short));
+    pos += data.numRanges * sizeof(short);
+  }
+  if (header.flags & CACHE_HAS_LOSS)
+    data.loss.reset(readTable(pos, data.minHeight, data.maxHeight, data.numHeights, minRange, data.maxRange, data.numRanges));
+  if (header.flags & CACHE_HAS_FACTOR)
+    data.factor.reset(readTable(pos, data.minHeight, data.maxHeight, data.numHeights, minRange, data.maxRange, data.numRanges));
+  return 0;
+}
+
+int ArepsLoader::writeCache_(const std::string& cacheFile, uint64_t sourceSize, int64_t sourceTime, const FileData& data) const
+{
+  const std::string directory = osgDB::getFilePath(cacheFile);
+  if (!directory.empty() && !osgDB::fileExists(directory) && !osgDB::makeDirectory(directory))
+    return 1;
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.version = CACHE_VERSION;
+  header.sourceSize = sourceSize;
+  header.sourceTime = sourceTime;
+  header.antennaGaindBi = data.radarParameters.antennaGaindBi;
+  header.freqMHz = data.radarParameters.freqMHz;
+  header.noiseFiguredB = data.radarParameters.noiseFiguredB;
+  header.pulseWidth_uSec = data.radarParameters.pulseWidth_uSec;
+  header.systemLossdB = data.radarParameters.systemLossdB;
+  header.xmtPowerKW = data.radarParameters.xmtPowerKW;
+  header.hbwD = data.radarParameters.hbwD;
+  header.antennaHeight = data.antennaHeight;
+  header.minHeight = data.minHeight;
+  header.maxHeight = data.maxHeight;
+  header.maxRange = data.maxRange;
+  header.numRanges = data.numRanges;
+  header.numHeights = data.numHeights;
+  header.bearing = data.bearing;
+  header.podCount = static_cast<uint32_t>(data.pod.size());
+  header.flags = (data.cnr ? CACHE_HAS_CNR : 0) | (data.loss ? CACHE_HAS_LOSS : 0) | (data.factor ? CACHE_HAS_FACTOR : 0);
+
+  // Write to a temporary file and rename, so that readers never map a partially written cache
+  const std::string tempFile = tempCacheName(cacheFile);
+  std::ofstream out(simCore::streamFixUtf8(tempFile), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+    return 1;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!data.pod.empty())
+    out.write(reinterpret_cast<const char*>(&data.pod[0]), data.pod.size() * sizeof(float));
+  if (data.cnr)
+    out.write(reinterpret_cast<const char*>(&(*data.cnr)(0)), data.cnr->numX() * sizeof(short));
+  if (data.loss)
+    writeTable(out, *data.loss);
+  if (data.factor)
+    writeTable(out, *data.factor);
+  out.close();
+  if (out.fail())
+  {
+    std::remove(tempFile.c_str());
+    return 1;
+  }
+
+  // rename() does not replace existing files on all platforms
+  std::remove(cacheFile.c_str());
+  if (std::rename(tempFile.c_str(), cacheFile.c_str()) != 0)
+  {
+    std::remove(tempFile.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+int ArepsLoader::convertFile(const std::string& arepsFile) const
+{
+  std::string error;
+  if (convertFile_(arepsFile, error) == 0)
+    return 0;
+  SIM_ERROR << error << std::endl;
+  return 1;
+}
+
+int ArepsLoader::convertFile_(const std::string& arepsFile, std::string& error) const
+{
+  uint64_t sourceSize = 0;
+  int64_t sourceTime = 0;
+  std::ifstream inFile(simCore::streamFixUtf8(arepsFile));
+  if (!inFile || sourceStamp(arepsFile, sourceSize, sourceTime) != 0)
+  {
+    error = "Could not open AREPS file: " + simCore::toNativeSeparators(arepsFile) + " for reading";
+    return 1;
+  }
+
+  const std::string cacheFile = cacheFilename(arepsFile);
+  {
+    simCore::MappedFile existing;
+    CacheHeader header;
+    if (existing.open(cacheFile) == 0 && validateCache(existing, sourceSize, sourceTime, header) == 0)
+      return 0;
+  }
+
+  // Read the file on its own, as the first file of a set
+  FileData data;
+  if (parseText_(arepsFile, inFile, data, true, true) != 0)
+  {
+    error = data.error;
+    return 1;
+  }
+  if (!data.cacheable || data.headers != HEADER_ALL)
+  {
+    error = "AREPS file: " + simCore::toNativeSeparators(arepsFile) + " is missing header values needed for caching";
+    return 1;
+  }
+  if (!data.cnr && !data.loss && !data.factor)
+  {
+    error = "File: " + arepsFile + " did not contain valid AREPS data";
+    return 1;
+  }
+  if (writeCache_(cacheFile, sourceSize, sourceTime, data) != 0)
+  {
+    error = "Could not write AREPS cache file: " + simCore::toNativeSeparators(cacheFile);
+    return 1;
+  }
+  return 0;
+}
+
+int ArepsLoader::convertFiles(const std::vector<std::string>& arepsFiles, unsigned int numThreads) const
+{
+  // Messages are collected per file and reported from this thread
+  std::vector<std::string> errors(arepsFiles.size());
+  simCore::ThreadPool pool(numThreads == 0 ? simCore::ThreadPool::hardwareThreads() : numThreads);
+  pool.parallelFor(arepsFiles.size(), [&](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k)
+      convertFile_(arepsFiles[k], errors[k]);
+  });
+
+  int numFailed = 0;
+  for (std::vector<std::string>::const_iterator i = errors.begin(); i != errors.end(); ++i)
+  {
+    if (i->empty())
+      continue;
+    SIM_ERROR << *i << std::endl;
+    ++numFailed;
+  }
+  return numFailed;
+}
+
+int ArepsLoader::convertDirectory(const std::string& directory, unsigned int numThreads) const
+{
+  if (osgDB::fileType(directory) != osgDB::DIRECTORY)
+  {
+    SIM_ERROR << "Could not read AREPS directory: " << simCore::toNativeSeparators(directory) << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> arepsFiles;
+  const osgDB::DirectoryContents contents = osgDB::getDirectoryContents(directory);
+  for (osgDB::DirectoryContents::const_iterator i = contents.begin(); i != contents.end(); ++i)
+  {
+    const std::string filename = osgDB::concatPaths(directory, *i);
+    if (osgDB::getLowerCaseFileExtension(*i) == "txt" && osgDB::fileType(filename) == osgDB::REGULAR_FILE)
+      arepsFiles.push_back(filename);
+  }
+  return convertFiles(arepsFiles, numThreads);
+}
+
+int ArepsLoader::apply_(const std::string& arepsFile, FileData& data, simRF::Profile& profile, bool firstFile)
+{
+  // some values are only used from the first file (of a multi-file set)
+  if (firstFile)
+  {
+    antennaHgt_ = data.antennaHeight;
+    maxHeight_ = data.maxHeight;
+    minHeight_ = data.minHeight;
+    numRanges_ = data.numRanges;
+    numHeights_ = data.numHeights;
+    maxRange_ = data.maxRange;
+    // minRange and rangeStep are the same
+    minRange_ = (numRanges_ == 0) ? 0 : (maxRange_ / numRanges_);
+
+    if (beamHandler_ && !data.pod.empty() && 0 != beamHandler_->setPODLossThreshold(data.pod))
+    {
+      SIM_ERROR << "Error saving POD data for AREPS file: " << arepsFile << std::endl;
+      return 1;
+    }
+  }
+
+  // data must be populated in the provider prior to assigning to profile, providers take ownership of the LUTs
+  if (data.cnr)
+    profile.addProvider(new simRF::LUT1ProfileDataProvider(data.cnr.release(), ProfileDataProvider::THRESHOLDTYPE_CNR, 1.0/SCALE_FACTOR));
+  if (data.loss)
+    profile.addProvider(new simRF::LUTProfileDataProvider(data.loss.release(), ProfileDataProvider::THRESHOLDTYPE_LOSS, 1.0/SCALE_FACTOR));
+  if (data.factor)
+    profile.addProvider(new simRF::LUTProfileDataProvider(data.factor.release(), ProfileDataProvider::THRESHOLDTYPE_FACTOR, 1.0/SCALE_FACTOR));
+
   if (profile.getDataProvider()->getNumProviders() == 0)
   {
     SIM_ERROR << "File: " << arepsFile << " did not contain valid AREPS data" << std::endl;
@@ -408,7 +919,7 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
   // set our radar parameters for all subsequent files
   if (firstFile && beamHandler_)
   {
-    if (0 != beamHandler_->setRadarParams(radarParameters))
+    if (0 != beamHandler_->setRadarParams(data.radarParameters))
     {
       SIM_ERROR << "File: " << arepsFile << " could not set radar parameters" << std::endl;
       return 1;
@@ -465,8 +976,8 @@ int ArepsLoader::loadFile(const std::string& arepsFile, simRF::Profile& profile,
     SIM_WARN << "The following RF calcs will be unavailable: " << missingCalcs << std::endl;
   }
 
-  profile.setBearing(bearingAngleRad);
-  profile.setHalfBeamWidth(radarParameters.hbwD * simCore::DEG2RAD / 2.0);
+  profile.setBearing(data.bearing);
+  profile.setHalfBeamWidth(data.radarParameters.hbwD * simCore::DEG2RAD / 2.0);
   return 0;
 }
 
@@ -23,6 +23,8 @@
 #ifndef SIMVIS_RFPROP_AREPS_LOADER_H
 #define SIMVIS_RFPROP_AREPS_LOADER_H
 
+#include <string>
+#include <vector>
 #include "simVis/RFProp/RFPropagationFacade.h"
 #include "simCore/Common/Common.h"
 
@@ -32,6 +34,12 @@ namespace simRF
 {
 /**
  * ArepsLoader is a file loader AREPS .txt files
+ *
+ * Parsing the AREPS text is slow for large file sets.  When the cache is enabled, the parsed
+ * header values and the quantized CNR, loss and PPF lookup tables for each file are stored in
+ * a binary cache file, which is memory mapped on later loads of the same file.  A cache file
+ * records the size and modification time of its source and is ignored once the source changes.
+ * Cache files may be created ahead of time with convertFiles() or convertDirectory().
  */
 class SDKVIS_EXPORT ArepsLoader
 {
@@ -60,7 +68,86 @@ public:
    */
   double getAntennaHeight() const;
 
+  /**
+   * Enables or disables the binary cache used by loadFile(); disabled by default
+   * @param enabled true to read and write cache files
+   * @param cacheDirectory directory in which to store cache files; if empty, cache files are
+   *   written next to the AREPS files, using the AREPS filename with an added .arepsc extension
+   */
+  void setCache(bool enabled, const std::string& cacheDirectory = "");
+  /** Returns true if loadFile() reads and writes cache files */
+  bool cacheEnabled() const;
+  /** Returns the directory for cache files, or empty string if cache files are written next to the AREPS files */
+  const std::string& cacheDirectory() const;
+
+  /**
+   * Returns the name of the cache file for an AREPS file.  Cache files in a cache directory are
+   * named from a hash of the AREPS file's full path.
+   * @param arepsFile AREPS filename
+   * @return name of the cache file, whether or not it exists
+   */
+  std::string cacheFilename(const std::string& arepsFile) const;
+
+  /**
+   * Writes the cache file for an AREPS file, unless an up to date cache file already exists.
+   * The file is read on its own, so it must contain all of the header values that loadFile()
+   * would otherwise take from the first file of a set.  Does not require setCache().
+   * @param arepsFile AREPS filename
+   * @return 0 on success, !0 on error
+   */
+  int convertFile(const std::string& arepsFile) const;
+
+  /**
+   * Writes cache files for a list of AREPS files, using multiple threads; see convertFile()
+   * @param arepsFiles AREPS filenames
+   * @param numThreads number of threads to use; 0 uses one per hardware thread
+   * @return 0 on success, otherwise the number of files that could not be converted
+   */
+  int convertFiles(const std::vector<std::string>& arepsFiles, unsigned int numThreads = 0) const;
+
+  /**
+   * Writes cache files for all AREPS .txt files in a directory, using multiple threads; see convertFile()
+   * @param directory directory to search; subdirectories are not searched
+   * @param numThreads number of threads to use; 0 uses one per hardware thread
+   * @return 0 on success, otherwise the number of files that could not be converted, or 1 if the directory could not be read
+   */
+  int convertDirectory(const std::string& directory, unsigned int numThreads = 0) const;
+
 private:
+  /// Values read from a single AREPS file or cache file
+  struct FileData;
+
+  /** Initializes the grid and antenna height of the data from the values of the first file */
+  void initFileData_(FileData& data) const;
+  /** Returns true if the data's height and range grid matches that of the first file */
+  bool matchesGrid_(const FileData& data) const;
+  /** Returns true if the data can be written to a cache file */
+  bool isCacheable_(const FileData& data, bool firstFile) const;
+
+  /**
+   * Parses AREPS text into data.  Errors in header values and POD data are only reported for the first file;
+   * in other files they prevent the data from being cached.  Sets data.error on failure.
+   * @param arepsFile filename, used for messages and the bearing of older files
+   * @param inFile stream to read
+   * @param data receives the values; grid and antenna height should be initialized by the caller
+   * @param firstFile if true, lookup tables use the grid from this file; otherwise they use the grid of the first file
+   * @param requirePod if true, errors in POD data are fatal
+   * @return 0 on success, !0 on error
+   */
+  int parseText_(const std::string& arepsFile, std::istream& inFile, FileData& data, bool firstFile, bool requirePod) const;
+  /** Handles an invalid header value; returns true if the error is fatal, in which case data.error is set */
+  bool headerError_(FileData& data, bool firstFile, const std::string& value, const std::string& arepsFile) const;
+
+  /** Reads a cache file written for the given source size and time into data; returns 0 on success */
+  int readCache_(const std::string& cacheFile, uint64_t sourceSize, int64_t sourceTime, FileData& data) const;
+  /** Writes data to a cache file; returns 0 on success */
+  int writeCache_(const std::string& cacheFile, uint64_t sourceSize, int64_t sourceTime, const FileData& data) const;
+  /** Converts one file, returning 0 on success; error is set on failure */
+  int convertFile_(const std::string& arepsFile, std::string& error) const;
+
+  /** Adds the data to the profile, and for the first file, to the loader and beam handler */
+  int apply_(const std::string& arepsFile, FileData& data, simRF::Profile& profile, bool firstFile);
+
   /**
    * getBearingAngle_() obtains the bearing angle for the file, from the filename;
    * this is to support older versions of AREPS files which specified the bearing for a file only in the filename
@@ -78,6 +165,8 @@ private:
   double minRange_;
   double antennaHgt_;
   RFPropagationFacade* beamHandler_;
+  bool cacheEnabled_;
+  std::string cacheDirectory_;
 };
 }
 
@@ -36,6 +36,14 @@ CompositeProfileProvider::CompositeProfileProvider()
 {
 }
 
+CompositeProfileProvider::CompositeProfileProvider(const CompositeProfileProvider& rhs)
+  : ProfileDataProvider(rhs),
+  activeIndex_(rhs.activeIndex_),
+  heightProviderIndex_(rhs.heightProviderIndex_),
+  providers_(rhs.providers_)
+{
+}
+
 int CompositeProfileProvider::getActiveProviderIndex() const
 {
   return activeIndex_;
@@ -39,6 +39,8 @@ class SDKVIS_EXPORT CompositeProfileProvider : public ProfileDataProvider
 public:
   /** Creates a new CompositeProfileProvider */
   CompositeProfileProvider();
+  /** Copies the list of providers and the active selection; the providers themselves are shared */
+  CompositeProfileProvider(const CompositeProfileProvider& rhs);
 
   /**
    * Gets the index of the provider
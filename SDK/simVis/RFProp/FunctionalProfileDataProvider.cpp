@@ -86,6 +86,11 @@ double FunctionalProfileDataProvider::templateInterpolateValue_(double height, d
   return templateProvider_->interpolateValue(height, range);
 }
 
+void FunctionalProfileDataProvider::templateInterpolateValues_(size_t count, const double* heights, const double* ranges, double* values) const
+{
+  templateProvider_->interpolateValues(count, heights, ranges, values);
+}
+
 double FunctionalProfileDataProvider::getRange_(unsigned int rangeIndex) const
 {
   if (rangeIndex >= getNumRanges())
@@ -91,6 +91,15 @@ protected:
   */
   double templateInterpolateValue_(double height, double range) const;
 
+  /**
+  * Gets values on this profile from the templateProvider_ for arrays of heights and ranges
+  * @param count Number of values to interpolate
+  * @param heights The heights of the desired samples, in meters, count values
+  * @param ranges The ranges of the desired samples, in meters, count values
+  * @param values Receives the values at the specified heights and ranges, count values
+  */
+  void templateInterpolateValues_(size_t count, const double* heights, const double* ranges, double* values) const;
+
   /**
   * Gets the range value corresponding to a range index
   * @param rangeIndex The index of the desired range
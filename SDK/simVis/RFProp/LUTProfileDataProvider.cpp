@@ -21,6 +21,7 @@
  *
  */
 #include <cassert>
+#include <vector>
 #include "simCore/LUT/InterpTable.h"
 #include "simNotify/Notify.h"
 #include "simVis/RFProp/LUTProfileDataProvider.h"
@@ -111,5 +112,22 @@ double LUTProfileDataProvider::interpolateValue(double height, double range) con
   return scalar_ * simCore::LUT::interpolate(*lut_, height, range, bil);
 }
 
+void LUTProfileDataProvider::interpolateValues(size_t count, const double* hgtMeters, const double* gndRngMeters, double* values) const
+{
+  // Tables with a single height or range have no cells; fall back to the single value path
+  if (lut_->numX() < 2 || lut_->numY() < 2)
+  {
+    ProfileDataProvider::interpolateValues(count, hgtMeters, gndRngMeters, values);
+    return;
+  }
+
+  std::vector<short> centibels(count);
+  if (count > 0)
+    simCore::LUT::interpolateBilinear(*lut_, count, hgtMeters, gndRngMeters, &centibels[0]);
+  // Apply scalar to convert internal storage back to dB
+  for (size_t k = 0; k < count; ++k)
+    values[k] = scalar_ * centibels[k];
+}
+
 }
 
@@ -71,6 +71,16 @@ public:
   */
   virtual double interpolateValue(double hgtMeters, double gndRngMeters) const;
 
+  /**
+  * Interpolates values on this Profile for arrays of heights and ranges, using a single pass over the table.
+  * Heights and ranges are expected to be within the table limits; values outside are clamped.
+  * @param count Number of values to interpolate
+  * @param hgtMeters Heights of the desired samples, in meters, count values
+  * @param gndRngMeters Ranges of the desired samples, in meters, count values
+  * @param values Receives the values at the specified heights and ranges, count values
+  */
+  virtual void interpolateValues(size_t count, const double* hgtMeters, const double* gndRngMeters, double* values) const;
+
 protected:
   /// osg::Referenced-derived
   virtual ~LUTProfileDataProvider();
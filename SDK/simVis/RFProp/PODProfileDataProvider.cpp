@@ -43,6 +43,13 @@ double PODProfileDataProvider::getValueByIndex(unsigned int heightIndex, unsigne
   return getPOD(-lossdB, podVector_);
 }
 
+void PODProfileDataProvider::interpolateValues(size_t count, const double* heights, const double* ranges, double* values) const
+{
+  FunctionalProfileDataProvider::templateInterpolateValues_(count, heights, ranges, values);
+  for (size_t k = 0; k < count; ++k)
+    values[k] = getPOD(-values[k], podVector_);
+}
+
 double PODProfileDataProvider::interpolateValue(double height, double range) const
 {
   const double lossdB = FunctionalProfileDataProvider::templateInterpolateValue_(height, range);
@@ -65,6 +65,15 @@ public:
    */
   virtual double interpolateValue(double height, double range) const;
 
+  /**
+   * Gets values on this Profile for arrays of heights and ranges, interpolating the loss provider in one pass
+   * @param count Number of values to interpolate
+   * @param heights The heights of the desired samples, in meters, count values
+   * @param ranges The ranges of the desired samples, in meters, count values
+   * @param values Receives the POD values at the specified heights and ranges, count values
+   */
+  virtual void interpolateValues(size_t count, const double* heights, const double* ranges, double* values) const;
+
   /**
   * Gets the POD value corresponding to a loss in dB
   * @param lossdB the loss specified in dB, must be a negative number
@@ -20,6 +20,9 @@
  * disclose, or release this software.
  *
  */
+#include <atomic>
+#include <chrono>
+#include <future>
 #include "osg/MatrixTransform"
 #include "osg/Texture2D"
 #include "osgEarth/GLUtils"
@@ -28,6 +31,7 @@
 #include "osgEarth/NodeUtils"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Interpolation.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simVis/Constants.h"
 #include "simVis/Utils.h"
 #include "simVis/RFProp/CompositeProfileProvider.h"
@@ -36,11 +40,47 @@
 
 namespace simRF {
 
+namespace
+{
+  /// Number of builds started but not yet swapped in or discarded, across all profiles
+  std::atomic<unsigned int> s_numPendingBuilds(0);
+
+  /// Worker threads shared by all profiles for building geometry; leaves one core for the render loop
+  simCore::ThreadPool& buildPool()
+  {
+    // the pool counts the calling thread, which does not take part in submitted tasks; builds still
+    // queued when the pool is destroyed at exit are discarded rather than run during static destruction
+    static simCore::ThreadPool pool(simCore::ThreadPool::hardwareThreads());
+    return pool;
+  }
+}
+
+/** Background build: a private profile, configured from a snapshot of the owner's settings, that builds the geometry */
+struct Profile::PendingBuild
+{
+  PendingBuild()
+  {
+    ++s_numPendingBuilds;
+  }
+  ~PendingBuild()
+  {
+    --s_numPendingBuilds;
+  }
+
+  /// Profile that builds the geometry; only touched by the worker until ready is satisfied
+  osg::ref_ptr<Profile> builder;
+  /// Satisfied by the worker once the builder's geometry is complete
+  std::promise<void> promise;
+  /// Future for promise
+  std::future<void> ready;
+};
+
 Profile::Profile(CompositeProfileProvider* data)
  : bearing_(0),
    halfBeamWidth_(0.0),
    data_(data),
-   dirty_(false)
+   dirty_(false),
+   updateRequested_(false)
 {
   setHalfBeamWidth(5.0 * simCore::DEG2RAD);
   updateOrientation_();
@@ -49,6 +89,7 @@ Profile::Profile(CompositeProfileProvider* data)
 
 Profile::~Profile()
 {
+  // an unfinished build owns its own snapshot of the settings and is discarded when the worker finishes it
 }
 
 double Profile::getBearing() const
@@ -138,24 +179,88 @@ void Profile::setThresholdType(ProfileDataProvider::ThresholdType type)
 
 void Profile::dirty()
 {
-  if (!dirty_)
-  {
-    ADJUST_UPDATE_TRAV_COUNT(this, 1);
-    dirty_ = true;
-  }
+  dirty_ = true;
+  setUpdateRequested_(true);
+}
+
+bool Profile::isBuilding() const
+{
+  return pendingBuild_ != nullptr;
+}
+
+unsigned int Profile::numPendingBuilds()
+{
+  return s_numPendingBuilds;
 }
 
 void Profile::traverse(osg::NodeVisitor& nv)
 {
   if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
   {
-    if (dirty_)
-      init_();
-    ADJUST_UPDATE_TRAV_COUNT(this, -1);
+    if (pendingBuild_ && pendingBuild_->ready.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+      finishBuild_();
+    // changes made during a build are picked up by a new build once the previous one is swapped in
+    if (dirty_ && !pendingBuild_)
+      startBuild_();
+    setUpdateRequested_(dirty_ || pendingBuild_ != nullptr);
   }
   osg::Group::traverse(nv);
 }
 
+void Profile::setUpdateRequested_(bool requested)
+{
+  if (updateRequested_ == requested)
+    return;
+  ADJUST_UPDATE_TRAV_COUNT(this, requested ? 1 : -1);
+  updateRequested_ = requested;
+}
+
+void Profile::startBuild_()
+{
+  dirty_ = false;
+  // nothing to build; clearing the existing geometry is cheap
+  if (!profileContext_ || !data_.valid() || data_->getActiveProvider() == nullptr)
+  {
+    init_();
+    return;
+  }
+
+  // the builder gets its own copy of everything that can change while it works, including the
+  // provider list and active threshold type; the providers themselves do not change once added
+  std::shared_ptr<PendingBuild> build = std::make_shared<PendingBuild>();
+  build->ready = build->promise.get_future();
+  build->builder = new Profile(new CompositeProfileProvider(*data_));
+  build->builder->setHalfBeamWidth(halfBeamWidth_);
+  build->builder->terrainHeights_ = terrainHeights_;
+  build->builder->profileContext_ = std::make_shared<ProfileContext>(*profileContext_);
+  build->builder->texture_ = texture_;
+  pendingBuild_ = build;
+
+  buildPool().submit([build]() {
+    build->builder->init_();
+    build->promise.set_value();
+  });
+}
+
+void Profile::finishBuild_()
+{
+  std::shared_ptr<PendingBuild> build = pendingBuild_;
+  pendingBuild_.reset();
+  Profile* builder = build->builder.get();
+
+  // swap in the new geometry in one step; the old geometry was drawn until now
+  removeChildren(0, getNumChildren());
+  verts_ = builder->verts_;
+  values_ = builder->values_;
+  group_ = builder->group_;
+  // a texture invalidated during the build is not restored; otherwise reuse what the builder made
+  if (!dirty_)
+    texture_ = builder->texture_;
+  builder->removeChildren(0, builder->getNumChildren());
+  if (group_.valid())
+    addChild(group_);
+}
+
 void Profile::init_()
 {
   // Remove all existing nodes
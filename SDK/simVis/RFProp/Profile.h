@@ -36,7 +36,13 @@ namespace simRF
 class CompositeProfileProvider;
 struct ProfileContext;
 
-/** Responsible for rendering a single profile of data. */
+/**
+ * Responsible for rendering a single profile of data.
+ *
+ * Geometry is built on a background thread.  After dirty(), the profile keeps drawing its
+ * previous geometry until the new geometry is ready, and swaps it in during the next update
+ * traversal.  Changes made while a build is running start another build once it finishes.
+ */
 class SDKVIS_EXPORT Profile : public osg::MatrixTransform
 {
 public:
@@ -101,6 +107,12 @@ public:
   /** Dirty this Profile causing it to be redrawn. */
   void dirty();
 
+  /** Returns true if new geometry is being built in the background and has not yet been swapped in */
+  bool isBuilding() const;
+
+  /** Number of profile geometry builds, across all profiles, that have been started but not yet swapped in or discarded */
+  static unsigned int numPendingBuilds();
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simRF"; }
 
@@ -118,6 +130,16 @@ private:
   /** Performs initialization at construction time */
   void init_();
 
+  /** Results of a background geometry build */
+  struct PendingBuild;
+
+  /** Starts building geometry on a background thread from a snapshot of the current settings */
+  void startBuild_();
+  /** Swaps in the geometry from a finished background build */
+  void finishBuild_();
+  /** Requests or cancels update traversals, keeping the parent's count in sync */
+  void setUpdateRequested_(bool requested);
+
   /** Initializes as a 2D horizontal */
   void init2DHoriz_();
   /** Initializes as a 2D Vertical */
@@ -182,6 +204,10 @@ private:
 
   /** Indicates profile needs updating */
   bool dirty_;
+  /** Indicates this profile has requested update traversals */
+  bool updateRequested_;
+  /** Background build in progress, or nullptr if none */
+  std::shared_ptr<PendingBuild> pendingBuild_;
 
   /** context owned by manager but shared with each profile */
   std::shared_ptr<ProfileContext> profileContext_;
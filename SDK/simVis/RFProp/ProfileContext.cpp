@@ -36,7 +36,8 @@ ProfileContext::ProfileContext(std::shared_ptr<simCore::DatumConvert> datumConve
   type(simRF::ProfileDataProvider::THRESHOLDTYPE_NONE),
   agl(false),
   sphericalEarth(true),
-  datumConvert_(datumConvert)
+  datumConvert_(datumConvert),
+  datumConvertMutex_(std::make_shared<std::mutex>())
 {
 }
 
@@ -68,6 +69,7 @@ double ProfileContext::adjustHeight(const simCore::Vec3& xEast) const
     coordConvert_.convert(in, out, simCore::COORD_SYS_LLA);
 
     // determine conversion from MSL to HAE, force use of EGM96
+    std::lock_guard<std::mutex> lock(*datumConvertMutex_);
     const double mslToHaeM = datumConvert_->convertVerticalDatum(simCore::Vec3(out.lat(), out.lon(), 0.), simCore::TimeStamp(1996, 0.),
       simCore::COORD_SYS_LLA, simCore::VERTDATUM_MSL, simCore::VERTDATUM_WGS84, 0.);
     return xEast.z() + mslToHaeM;
@@ -24,6 +24,7 @@
 #define SIMVIS_RFPROP_PROFILE_CONTEXT_H
 
 #include <memory>
+#include <mutex>
 #include "osg/Vec3f"
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simVis/RFProp/Profile.h"
@@ -31,7 +32,7 @@
 namespace simCore { class DatumConvert; }
 namespace simRF
 {
-/** Display context that all profiles share */
+/** Display context that all profiles share; profiles building in the background work from copies */
 struct ProfileContext
 {
 public:
@@ -53,6 +54,7 @@ public:
 
 private:
   std::shared_ptr<simCore::DatumConvert> datumConvert_;    ///< provides MSL data for height correction
+  std::shared_ptr<std::mutex> datumConvertMutex_;  ///< serializes datumConvert_ across copies used by background profile builds
   simCore::CoordinateConverter coordConvert_;   ///< converts datapoint enu values to LLA for datum
   simCore::Vec3 tpSphereXYZ_; ///< refLLA converted to spherical earth
 };
@@ -23,6 +23,7 @@
 #ifndef SIMVIS_RFPROP_PROFILE_DATA_PROVIDER_H
 #define SIMVIS_RFPROP_PROFILE_DATA_PROVIDER_H
 
+#include <cstddef>
 #include "osg/Referenced"
 #include "simCore/Common/Common.h"
 
@@ -102,6 +103,20 @@ public:
    */
   virtual double interpolateValue(double hgtMeters, double gndRngMeters) const = 0;
 
+  /**
+   * Interpolates values on this Profile for arrays of heights and ranges.  Gives the same values as
+   * interpolateValue(); derived classes may override to avoid a virtual call per value.
+   * @param count Number of values to interpolate
+   * @param hgtMeters Heights of the desired samples, in meters, count values
+   * @param gndRngMeters Ranges of the desired samples, in meters, count values
+   * @param values Receives the values at the specified heights and ranges, count values
+   */
+  virtual void interpolateValues(size_t count, const double* hgtMeters, const double* gndRngMeters, double* values) const
+  {
+    for (size_t k = 0; k < count; ++k)
+      values[k] = interpolateValue(hgtMeters[k], gndRngMeters[k]);
+  }
+
   /** Retrieves the threshold type value */
   virtual ThresholdType getType() const { return type_; }
 
@@ -20,9 +20,11 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include "osg/Depth"
 #include "osgEarth/Map"
 #include "simCore/Calc/Angle.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simCore/EM/AntennaPattern.h"
 #include "simCore/Time/TimeClass.h"
 #include "simNotify/Notify.h"
@@ -83,6 +85,18 @@ std::string dataTypeToString(simRF::ProfileDataProvider::ThresholdType dataType)
   }
   return "?";
 }
+
+/// Groups of batch requests for a single data provider with at least this many requests are split across threads
+const size_t PARALLEL_BATCH_SIZE = 16384;
+
+/** Reports batch requests that could not be answered with a single warning */
+void warnMissing(const std::string& function, size_t missing, size_t count)
+{
+  if (missing > 0)
+  {
+    SIM_WARN << "RFPropagationFacade::" << function << ": No data found for " << missing << " of " << count << " requests\n";
+  }
+}
 }
 
 namespace simRF
@@ -93,7 +107,8 @@ const int DEFAULT_HISTORY = 30; // degrees
 RFPropagationFacade::RFPropagationFacade(osg::Group* parent, std::shared_ptr<simCore::DatumConvert> datumConvert)
   : antennaHeightMeters_(0.0),
   profileManager_(new simRF::ProfileManager(datumConvert)),
-  parent_(parent)
+  parent_(parent),
+  arepsCacheEnabled_(false)
 {
   // add profileManager_ to the parent node
   if (profileManager_.valid() && parent_.valid())
@@ -237,6 +252,12 @@ const simRF::Profile* RFPropagationFacade::getSlotData(double azRad) const
   return profileManager_->getProfileByBearing(azRad);
 }
 
+void RFPropagationFacade::setArepsCache(bool enabled, const std::string& cacheDirectory)
+{
+  arepsCacheEnabled_ = enabled;
+  arepsCacheDirectory_ = cacheDirectory;
+}
+
 int RFPropagationFacade::getInputFiles(const simCore::TimeStamp& time, std::vector<std::string>& filenames) const
 {
   std::map<simCore::TimeStamp, std::vector<std::string> >::const_iterator it =
@@ -537,6 +558,222 @@ double RFPropagationFacade::getReceivedPower(double azimRad, double slantRngMete
   return simRF::TwoWayPowerDataProvider::getTwoWayPower(*radarParameters_, ppf_dB, slantRngMeters, xmtGaindB, rcvGaindB, rcsSqm);
 }
 
+void RFPropagationFacade::getPOD(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* pod) const
+{
+  std::vector<char> found;
+  interpolateBatch_(simRF::ProfileDataProvider::THRESHOLDTYPE_POD, count, azimRad, gndRngMeters, hgtMeters, pod, found);
+  size_t missing = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (found[k])
+      continue;
+    if (lossDataHelper_)
+    {
+      const double lossdB = lossDataHelper_->value(azimRad[k], gndRngMeters[k], hgtMeters[k]);
+      pod[k] = (lossdB != simCore::SMALL_DB_VAL) ?
+        simRF::PODProfileDataProvider::getPOD(-lossdB, podLossThresholds_) : 0.0;
+      continue;
+    }
+    pod[k] = 0.0;
+    ++missing;
+  }
+  warnMissing("getPOD", missing, count);
+}
+
+void RFPropagationFacade::getLoss(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* loss) const
+{
+  std::vector<char> found;
+  interpolateBatch_(simRF::ProfileDataProvider::THRESHOLDTYPE_LOSS, count, azimRad, gndRngMeters, hgtMeters, loss, found);
+  size_t missing = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (found[k])
+      loss[k] = (loss[k] > simCore::SMALL_DB_VAL ? loss[k] : simCore::SMALL_DB_VAL);
+    else if (lossDataHelper_)
+      loss[k] = lossDataHelper_->value(azimRad[k], gndRngMeters[k], hgtMeters[k]);
+    else
+    {
+      loss[k] = simCore::SMALL_DB_VAL;
+      ++missing;
+    }
+  }
+  warnMissing("getLoss", missing, count);
+}
+
+void RFPropagationFacade::getPPF(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* ppf) const
+{
+  std::vector<char> found;
+  interpolateBatch_(simRF::ProfileDataProvider::THRESHOLDTYPE_FACTOR, count, azimRad, gndRngMeters, hgtMeters, ppf, found);
+  size_t missing = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (found[k])
+      ppf[k] = (ppf[k] > simCore::SMALL_DB_VAL ? ppf[k] : simCore::SMALL_DB_VAL);
+    else if (lossDataHelper_)
+    {
+      const double lossdB = lossDataHelper_->value(azimRad[k], gndRngMeters[k], hgtMeters[k]);
+      const double slantRangeM = sqrt(simCore::square(gndRngMeters[k]) + simCore::square(hgtMeters[k]));
+      ppf[k] = simCore::lossToPpf(slantRangeM, radarParameters_->freqMHz, lossdB);
+    }
+    else
+    {
+      ppf[k] = simCore::SMALL_DB_VAL;
+      ++missing;
+    }
+  }
+  warnMissing("getPPF", missing, count);
+}
+
+void RFPropagationFacade::getSNR(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+  const double* rcvGaindB, const double* rcsSqm, const double* gndRngMeters, double* snr) const
+{
+  getReceivedPower(count, azimRad, slantRngMeters, hgtMeters, xmtGaindB, rcvGaindB, rcsSqm, gndRngMeters, snr);
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (snr[k] != simCore::SMALL_DB_VAL)
+      snr[k] -= radarParameters_->noisePowerdB;
+  }
+}
+
+void RFPropagationFacade::getCNR(size_t count, const double* azimRad, const double* gndRngMeters, double* cnr) const
+{
+  std::vector<char> found;
+  interpolateBatch_(simRF::ProfileDataProvider::THRESHOLDTYPE_CNR, count, azimRad, gndRngMeters, nullptr, cnr, found);
+  size_t missing = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (found[k])
+      continue;
+    cnr[k] = simCore::SMALL_DB_VAL;
+    ++missing;
+  }
+  warnMissing("getCNR", missing, count);
+}
+
+void RFPropagationFacade::getOneWayPower(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+  const double* gndRngMeters, const double* rcvGaindB, double* power) const
+{
+  // PPF values are computed in place, then converted to power
+  getPPF(count, azimRad, gndRngMeters, hgtMeters, power);
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (power[k] != simCore::SMALL_DB_VAL)
+      power[k] = simRF::OneWayPowerDataProvider::getOneWayPower(*radarParameters_, power[k], slantRngMeters[k], xmtGaindB[k], rcvGaindB[k]);
+  }
+}
+
+void RFPropagationFacade::getReceivedPower(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+  const double* rcvGaindB, const double* rcsSqm, const double* gndRngMeters, double* power) const
+{
+  // PPF values are computed in place, then converted to power
+  getPPF(count, azimRad, gndRngMeters, hgtMeters, power);
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (power[k] != simCore::SMALL_DB_VAL)
+      power[k] = simRF::TwoWayPowerDataProvider::getTwoWayPower(*radarParameters_, power[k], slantRngMeters[k], xmtGaindB[k], rcvGaindB[k], rcsSqm[k]);
+  }
+}
+
+void RFPropagationFacade::interpolateBatch_(simRF::ProfileDataProvider::ThresholdType type, size_t count, const double* azimRad,
+  const double* gndRngMeters, const double* hgtMeters, double* values, std::vector<char>& found) const
+{
+  found.assign(count, 0);
+
+  // Assign each request with data to the group of its provider.  Requests usually arrive ordered by
+  // bearing, so the provider and its limits are only looked up when the azimuth changes.
+  std::vector<const simRF::ProfileDataProvider*> groupProviders;
+  std::vector<size_t> groupSizes;
+  std::vector<int> requestGroups(count, -1);
+  bool haveLast = false;
+  double lastAzimRad = 0.0;
+  int lastGroup = -1;
+  double minRange = 0.0;
+  double maxRange = 0.0;
+  double minHeight = 0.0;
+  double maxHeight = 0.0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (!haveLast || azimRad[k] != lastAzimRad)
+    {
+      haveLast = true;
+      lastAzimRad = azimRad[k];
+      lastGroup = -1;
+      const simRF::Profile* profile = getSlotData(lastAzimRad);
+      const simRF::CompositeProfileProvider* cProvider = (profile != nullptr) ?
+        dynamic_cast<const simRF::CompositeProfileProvider*>(profile->getDataProvider()) : nullptr;
+      const simRF::ProfileDataProvider* provider = (cProvider != nullptr) ? cProvider->getProvider(type) : nullptr;
+      if (provider != nullptr)
+      {
+        const std::vector<const simRF::ProfileDataProvider*>::const_iterator it = std::find(groupProviders.begin(), groupProviders.end(), provider);
+        lastGroup = static_cast<int>(it - groupProviders.begin());
+        if (it == groupProviders.end())
+        {
+          groupProviders.push_back(provider);
+          groupSizes.push_back(0);
+        }
+        minRange = provider->getMinRange();
+        maxRange = provider->getMaxRange();
+        minHeight = provider->getMinHeight();
+        maxHeight = provider->getMaxHeight();
+      }
+    }
+    if (lastGroup < 0 || gndRngMeters[k] < minRange || gndRngMeters[k] > maxRange)
+      continue;
+    if (hgtMeters != nullptr && (hgtMeters[k] < minHeight || hgtMeters[k] > maxHeight))
+      continue;
+    requestGroups[k] = lastGroup;
+    ++groupSizes[lastGroup];
+    found[k] = 1;
+  }
+
+  // Gather the requests of each group into contiguous arrays
+  std::vector<size_t> groupStarts(groupSizes.size() + 1, 0);
+  for (size_t g = 0; g < groupSizes.size(); ++g)
+    groupStarts[g + 1] = groupStarts[g] + groupSizes[g];
+  const size_t numFound = groupStarts.back();
+  if (numFound == 0)
+    return;
+  std::vector<size_t> order(numFound);
+  std::vector<double> heights(numFound, 0.0);
+  std::vector<double> ranges(numFound);
+  std::vector<double> results(numFound);
+  std::vector<size_t> next(groupStarts.begin(), groupStarts.end() - 1);
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (requestGroups[k] < 0)
+      continue;
+    const size_t pos = next[requestGroups[k]]++;
+    order[pos] = k;
+    ranges[pos] = gndRngMeters[k];
+    if (hgtMeters != nullptr)
+      heights[pos] = hgtMeters[k];
+  }
+
+  // Interpolate each group in one call, splitting large groups across threads.  The pool is kept for
+  // later batches; a batch that finds the pool in use by another thread stays on its own thread instead.
+  std::unique_lock<std::mutex> poolLock(batchPoolMutex_, std::defer_lock);
+  for (size_t g = 0; g < groupProviders.size(); ++g)
+  {
+    const simRF::ProfileDataProvider* provider = groupProviders[g];
+    const size_t start = groupStarts[g];
+    const size_t size = groupSizes[g];
+    if (size >= PARALLEL_BATCH_SIZE && simCore::ThreadPool::hardwareThreads() > 1 &&
+      (poolLock.owns_lock() || poolLock.try_lock()))
+    {
+      if (!batchPool_)
+        batchPool_.reset(new simCore::ThreadPool(simCore::ThreadPool::hardwareThreads()));
+      batchPool_->parallelFor(size, [&](size_t begin, size_t end) {
+        provider->interpolateValues(end - begin, &heights[start + begin], &ranges[start + begin], &results[start + begin]);
+      });
+    }
+    else if (size > 0)
+      provider->interpolateValues(size, &heights[start], &ranges[start], &results[start]);
+  }
+
+  for (size_t pos = 0; pos < numFound; ++pos)
+    values[order[pos]] = results[pos];
+}
+
 bool RFPropagationFacade::valid() const
 {
   // in SIMDIS 9, valid == (rfParametersSet && podVectorSet && colorMapSet);
@@ -562,6 +799,7 @@ int RFPropagationFacade::loadArepsFiles(const simCore::TimeStamp& time, const st
   // loading 180 files is very slow, and there are no dependencies between files, so loading could be parallelized.
 
   simRF::ArepsLoader arepsLoader(this);
+  arepsLoader.setCache(arepsCacheEnabled_, arepsCacheDirectory_);
   std::vector<std::string> filenamesAdded;
   bool loadingFirstFile = true;
   for (const auto& filename : filenames)
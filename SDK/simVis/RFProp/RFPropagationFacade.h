@@ -25,6 +25,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "osg/ref_ptr"
@@ -38,6 +39,7 @@ namespace simCore
 {
   class TimeStamp;
   class DatumConvert;
+  class ThreadPool;
 }
 
 namespace simRF
@@ -120,6 +122,14 @@ public:
    */
   int loadArepsFiles(const simCore::TimeStamp& time, const std::vector<std::string>& filenames);
 
+  /**
+   * Enables or disables the binary cache for AREPS files loaded by loadArepsFiles(); disabled by default.
+   * See ArepsLoader::setCache().
+   * @param enabled true to read and write cache files
+   * @param cacheDirectory directory in which to store cache files; if empty, cache files are written next to the AREPS files
+   */
+  void setArepsCache(bool enabled, const std::string& cacheDirectory = "");
+
   /**
    * Get AREPS RF Propagation files for a given beam
    * @param time Time reference for the files which are requested
@@ -398,6 +408,97 @@ public:
    */
   double getReceivedPower(double azimRad, double slantRngMeters, double hgtMeters, double xmtGaindB, double rcvGaindB, double rcsSqm, double gndRngMeters) const;
 
+  /**
+   * Batch versions of the queries above compute values for arrays of requests.  They give the same
+   * values as the single request versions, but look up each bearing's data provider once, interpolate
+   * all requests for a provider in one pass over its table, and split large batches across threads.
+   * Requests without data use the loss data helper, if set; a single warning reports requests that
+   * could not be answered.
+   */
+
+  /**
+   * Return the probability of detection for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param pod Receives probabilities of detection [0, 100], count values
+   */
+  void getPOD(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* pod) const;
+
+  /**
+   * Return the propagation loss for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param loss Receives propagation losses [-300: error or invalid data], count values
+   */
+  void getLoss(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* loss) const;
+
+  /**
+   * Return the pattern propagation factor for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param ppf Receives pattern propagation factors [-300: error or invalid data], count values
+   */
+  void getPPF(size_t count, const double* azimRad, const double* gndRngMeters, const double* hgtMeters, double* ppf) const;
+
+  /**
+   * Return the signal to noise ratio for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param slantRngMeters Slant ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param xmtGaindB Transmitter antenna gains, dB, count values
+   * @param rcvGaindB Receiver antenna gains, dB, count values
+   * @param rcsSqm Target RADAR cross sections, sqm, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, used to look up PPF, count values
+   * @param snr Receives signal to noise ratios [-300: error or invalid data], count values
+   */
+  void getSNR(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+    const double* rcvGaindB, const double* rcsSqm, const double* gndRngMeters, double* snr) const;
+
+  /**
+   * Return the clutter to noise ratio for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, count values
+   * @param cnr Receives clutter to noise ratios [-300: error or invalid data], count values
+   */
+  void getCNR(size_t count, const double* azimRad, const double* gndRngMeters, double* cnr) const;
+
+  /**
+   * Return the one way power for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param slantRngMeters Slant ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param xmtGaindB Transmitter antenna gains, dB, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, used to look up PPF, count values
+   * @param rcvGaindB Receiver antenna gains, dB, count values
+   * @param power Receives one way received powers [-300: error or invalid data], count values
+   */
+  void getOneWayPower(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+    const double* gndRngMeters, const double* rcvGaindB, double* power) const;
+
+  /**
+   * Return the two way received power for arrays of requests; see the single request version
+   * @param count Number of requests
+   * @param azimRad Azimuth angles referenced to True North in radians, count values
+   * @param slantRngMeters Slant ranges from emitter source, meters, count values
+   * @param hgtMeters Heights, above surface referenced to HAE, meters, count values
+   * @param xmtGaindB Transmitter antenna gains, dB, count values
+   * @param rcvGaindB Receiver antenna gains, dB, count values
+   * @param rcsSqm Target RADAR cross sections, sqm, count values
+   * @param gndRngMeters Ground ranges from emitter source, meters, used to look up PPF, count values
+   * @param power Receives two way received powers [-300: error or invalid data], count values
+   */
+  void getReceivedPower(size_t count, const double* azimRad, const double* slantRngMeters, const double* hgtMeters, const double* xmtGaindB,
+    const double* rcvGaindB, const double* rcsSqm, const double* gndRngMeters, double* power) const;
+
   /**
    * Returns valid propagation state for given beam
    * @return true for valid, false otherwise
@@ -522,6 +623,19 @@ private:
   /// update the color provider based on threshold type
   void setColorProviderByThresholdType_(simRF::ProfileDataProvider::ThresholdType type);
 
+  /**
+   * Interpolates a data type for arrays of requests, grouping requests by data provider
+   * @param type Data type to interpolate
+   * @param count Number of requests
+   * @param azimRad Azimuth angles in radians, count values
+   * @param gndRngMeters Ground ranges in meters, count values
+   * @param hgtMeters Heights in meters, count values; nullptr for data types without height, like CNR
+   * @param values Receives interpolated values for requests with data, count values
+   * @param found Receives 1 for requests with data, 0 for requests outside of the data, count values
+   */
+  void interpolateBatch_(simRF::ProfileDataProvider::ThresholdType type, size_t count, const double* azimRad,
+    const double* gndRngMeters, const double* hgtMeters, double* values, std::vector<char>& found) const;
+
   /// antenna height used to create rf propagation data
   float antennaHeightMeters_;
 
@@ -540,6 +654,11 @@ private:
   /// map of filesets loaded, keyed by the timestamp for which they were specified
   std::map<simCore::TimeStamp, std::vector<std::string> > arepsFilesetTimeMap_;
 
+  /// true if AREPS files are loaded through the binary cache
+  bool arepsCacheEnabled_;
+  /// directory for AREPS cache files; empty to write them next to the AREPS files
+  std::string arepsCacheDirectory_;
+
   /// shared ptr to the POD Loss thresholds
   PODVectorPtr podLossThresholds_;
 
@@ -551,6 +670,11 @@ private:
 
   /// default color provider
   osg::ref_ptr<simRF::CompositeColorProvider> defaultColorProvider_;
+
+  /// threads for splitting large batch requests; created by the first batch that needs them
+  mutable std::unique_ptr<simCore::ThreadPool> batchPool_;
+  /// held while a batch uses batchPool_, since the pool runs one parallelFor() at a time
+  mutable std::mutex batchPoolMutex_;
 };
 
 }
@@ -22,12 +22,17 @@
  */
 #include <cassert>
 #include <limits>
+#include "osgEarth/ElevationLayer"
 #include "osgEarth/GeoData"
+#include "osgEarth/Map"
+#include "osg/observer_ptr"
 #include "osgEarth/Terrain"
 #include "simNotify/Notify.h"
+#include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Calculations.h"
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simCore/Calc/Math.h"
+#include "simCore/Time/Utils.h"
 #include "simVis/RadialLOS.h"
 #include "simVis/Utils.h"
 
@@ -35,6 +40,95 @@
 #define LC "[LOS] "
 
 namespace simVis {
+
+namespace
+{
+
+/** Terrain height sampled at one radial and range step */
+struct CachedHeight
+{
+  CachedHeight() : valid(false), hamsl_m(0.0), hae_m(0.0) {}
+
+  /** True once a valid height has been sampled; failed samples are retried */
+  bool valid;
+  double hamsl_m;
+  double hae_m;
+};
+
+/** Returns a value that changes whenever the terrain heights available for sampling change */
+int elevationRevision(osgEarth::MapNode* mapNode, const RadialLOS::ElevationSource* source)
+{
+  if (source)
+    return source->getRevision();
+  if (mapNode == nullptr || mapNode->getMap() == nullptr)
+    return 0;
+
+  // layers added, removed, moved, opened or closed change the map revision; a layer's own
+  // revision changes when its data changes
+  const osgEarth::Map* map = mapNode->getMap();
+  int revision = map->getDataModelRevision();
+  osgEarth::ElevationLayerVector layers;
+  map->getLayers(layers);
+  for (osgEarth::ElevationLayerVector::const_iterator iter = layers.begin(); iter != layers.end(); ++iter)
+    revision = revision * 31 + (*iter)->getRevision();
+  return revision;
+}
+
+/** Converts an absolute GeoPoint to an LLA coordinate; unlike convertGeoPointToCoord(), no map is needed */
+bool convertAbsoluteGeoPointToLla(const osgEarth::GeoPoint& input, simCore::Coordinate& out_coord)
+{
+  osgEarth::GeoPoint absInput = input;
+  if (!absInput.getSRS()->isGeographic())
+  {
+    if (!absInput.transform(absInput.getSRS()->getGeographicSRS(), absInput))
+      return false;
+  }
+
+  out_coord = simCore::Coordinate(
+    simCore::COORD_SYS_LLA,
+    simCore::Vec3(absInput.y() * simCore::DEG2RAD, absInput.x() * simCore::DEG2RAD, absInput.alt()));
+  return true;
+}
+
+}
+
+/// Settings fixed at the start of an incremental computation, and the radials computed so far
+struct RadialLOS::Computation
+{
+  Computation() : useMap(false), elevationRevision(0), validLos(false), lastSampleValid(false) {}
+
+  /// True when sampling the map rather than only the elevation source
+  bool useMap;
+  osg::observer_ptr<osgEarth::MapNode> mapNode;
+  osg::ref_ptr<const osgEarth::SpatialReference> srs;
+  /// Revision of the terrain data when the computation started
+  int elevationRevision;
+  osgEarth::GeoPoint originMap;
+  osg::Matrix local2world;
+  simCore::Coordinate originLla;
+  /// Converter with its reference origin at the LOS origin
+  simCore::CoordinateConverter cc;
+  std::vector<double> azimuths;
+  std::vector<double> ranges;
+  RadialVector radials;
+  bool validLos;
+  bool lastSampleValid;
+};
+
+/// Terrain heights indexed by radial and range step, sampled around a fixed origin
+struct RadialLOS::HeightCache
+{
+  osg::ref_ptr<const osgEarth::SpatialReference> srs;
+  /// Revision of the terrain data that was sampled
+  int elevationRevision;
+  /// Origin at which the heights were sampled, LLA radians
+  simCore::Vec3 originLla;
+  std::vector<double> azimuths;
+  std::vector<double> ranges;
+  /// Heights in radial-major order
+  std::vector<CachedHeight> heights;
+};
+
 //----------------------------------------------------------------------------
 
 RadialLOS::Sample::Sample(double range_m, const osgEarth::GeoPoint& point)
@@ -77,13 +171,15 @@ RadialLOS::Sample::Sample(const Sample& rhs)
 
 RadialLOS::RadialLOS()
   : dirty_(true),
+    valid_(false),
     range_max_(osgEarth::Distance(10.0, osgEarth::Units::KILOMETERS)),
     range_resolution_(osgEarth::Distance(1.0, osgEarth::Units::KILOMETERS)),
     azim_center_(osgEarth::Angle(0.0, osgEarth::Units::DEGREES)),
     fov_(osgEarth::Angle(360.0, osgEarth::Units::DEGREES)),
     azim_resolution_(osgEarth::Angle(15.0, osgEarth::Units::DEGREES)),
     elevationWorkingSet_(new osgEarth::ElevationPool::WorkingSet(WORKINGSET_SIZE)),
-    use_scene_graph_(false)
+    use_scene_graph_(false),
+    originTolerance_(osgEarth::Distance(0.0, osgEarth::Units::METERS))
 {
 }
 
@@ -98,7 +194,10 @@ RadialLOS::~RadialLOS()
 
 RadialLOS& RadialLOS::operator=(const RadialLOS& rhs)
 {
+  if (this == &rhs)
+    return *this;
   dirty_ = rhs.dirty_;
+  valid_ = rhs.valid_;
   radials_ = rhs.radials_;
   originMap_ = rhs.originMap_;
   range_max_ = rhs.range_max_;
@@ -107,8 +206,12 @@ RadialLOS& RadialLOS::operator=(const RadialLOS& rhs)
   fov_ = rhs.fov_;
   azim_resolution_ = rhs.azim_resolution_;
   use_scene_graph_ = rhs.use_scene_graph_;
+  elevationSource_ = rhs.elevationSource_;
+  originTolerance_ = rhs.originTolerance_;
   elevationWorkingSet_.reset(new osgEarth::ElevationPool::WorkingSet(WORKINGSET_SIZE));
-  // nocopy: srs_
+  heightCache_.reset(rhs.heightCache_ ? new HeightCache(*rhs.heightCache_) : nullptr);
+  // nocopy: srs_, computation in progress
+  computation_.reset();
 
   return *this;
 }
@@ -158,34 +261,163 @@ void RadialLOS::setAzimuthalResolution(const osgEarth::Angle& value)
   }
 }
 
+void RadialLOS::setElevationSource(std::shared_ptr<ElevationSource> source)
+{
+  if (elevationSource_ != source)
+  {
+    elevationSource_ = source;
+    heightCache_.reset();
+    dirty_ = true;
+  }
+}
+
+void RadialLOS::setOriginTolerance(const osgEarth::Distance& value)
+{
+  originTolerance_ = value;
+  if (originTolerance_.as(osgEarth::Units::METERS) <= 0.0)
+    heightCache_.reset();
+}
+
 bool RadialLOS::compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& originCoord)
 {
   assert(mapNode != nullptr);
 
+  if (!startCompute(mapNode, originCoord))
+    return false;
+  return finishCompute_();
+}
+
+bool RadialLOS::compute(const osgEarth::SpatialReference* srs, const simCore::Coordinate& originCoord)
+{
+  if (!startCompute(srs, originCoord))
+    return false;
+  return finishCompute_();
+}
+
+bool RadialLOS::startCompute(osgEarth::MapNode* mapNode, const simCore::Coordinate& originCoord)
+{
+  if (mapNode == nullptr)
+  {
+    cancelCompute();
+    // clear out existing data
+    radials_.clear();
+    return false;
+  }
+  return startCompute_(mapNode, mapNode->getMapSRS(), originCoord);
+}
+
+bool RadialLOS::startCompute(const osgEarth::SpatialReference* srs, const simCore::Coordinate& originCoord)
+{
+  // without a map, heights can only come from the elevation source
+  if (!elevationSource_ || srs == nullptr)
+  {
+    cancelCompute();
+    radials_.clear();
+    return false;
+  }
+  return startCompute_(nullptr, srs, originCoord);
+}
+
+bool RadialLOS::startCompute_(osgEarth::MapNode* mapNode, const osgEarth::SpatialReference* srs, const simCore::Coordinate& originCoord)
+{
+  cancelCompute();
+
+  std::unique_ptr<Computation> computation(new Computation);
+  computation->useMap = (mapNode != nullptr);
+  computation->mapNode = mapNode;
+  computation->srs = srs;
+  computation->elevationRevision = elevationRevision(mapNode, elevationSource_.get());
+
+  // set up the localizer transforms:
+  if (!convertCoordToGeoPoint(originCoord, computation->originMap, srs))
+  {
+    radials_.clear();
+    return false;
+  }
+  computation->originMap.createLocalToWorld(computation->local2world);
+
+  computation->cc.convert(originCoord, computation->originLla, simCore::COORD_SYS_LLA);
+  computation->cc.setReferenceOrigin(computation->originLla.position());
+
+  getAzimuths_(computation->azimuths);
+  getRanges_(computation->ranges);
+  computation->radials.reserve(computation->azimuths.size());
+
+  prepareHeightCache_(*computation);
+  computation_ = std::move(computation);
+  return true;
+}
+
+bool RadialLOS::computeStep(double budgetSeconds)
+{
+  if (!computation_)
+    return true;
+
+  osg::ref_ptr<osgEarth::MapNode> mapNode;
+  if (computation_->useMap && !computation_->mapNode.lock(mapNode))
+  {
+    // map went away mid-computation; nothing to sample
+    cancelCompute();
+    return true;
+  }
+
+  const double startTime = simCore::getSystemTime();
+  do
+  {
+    computeRadial_(mapNode.get());
+  } while (computation_->radials.size() < computation_->azimuths.size() && simCore::getSystemTime() - startTime < budgetSeconds);
+
+  if (computation_->radials.size() < computation_->azimuths.size())
+    return false;
+
+  // swap in the completed result
+  radials_.swap(computation_->radials);
+  originMap_ = computation_->originMap;
+  srs_ = computation_->srs;
+  valid_ = computation_->validLos;
+  dirty_ = false;
+  computation_.reset();
+  return true;
+}
+
+bool RadialLOS::finishCompute_()
+{
 #ifdef LOS_TIME_PROFILING
   osg::Timer_t startTime = osg::Timer::instance()->tick();
 #endif
 
+  computeStep(std::numeric_limits<double>::max());
+
+#ifdef LOS_TIME_PROFILING
+  osg::Timer_t endTime = osg::Timer::instance()->tick();
+  SIM_NOTICE << "RLOS::compute time=" << osg::Timer::instance()->delta_m(startTime, endTime) << " ms" << std::endl;
+#endif
+
+  return valid_;
+}
 
-  // clear out existing data
-  radials_.clear();
+void RadialLOS::cancelCompute()
+{
+  computation_.reset();
+}
 
-  // set up the localizer transforms:
-  if (!convertCoordToGeoPoint(originCoord, originMap_, mapNode->getMapSRS()))
-    return false;
+double RadialLOS::getComputeProgress() const
+{
+  if (!computation_ || computation_->azimuths.empty())
+    return 1.0;
+  return static_cast<double>(computation_->radials.size()) / computation_->azimuths.size();
+}
 
-  osg::Matrix local2world;
-  originMap_.createLocalToWorld(local2world);
+void RadialLOS::getAzimuths_(std::vector<double>& azimuths) const
+{
+  azimuths.clear();
 
   // convert everything to the proper units:
   double azim_center  = azim_center_.as(osgEarth::Units::RADIANS);
   double fov          = fov_.as(osgEarth::Units::RADIANS);
   double azim_res_rad = azim_resolution_.as(osgEarth::Units::RADIANS);
-  double range_max_m  = range_max_.as(osgEarth::Units::METERS);
-  double range_res_m  = range_resolution_.as(osgEarth::Units::METERS);
 
   // collect the azimuth list:
-  std::vector<double> azimuths;
   double   azim_min_rad = azim_center - 0.5*fov;
   double   azim_max_rad = azim_center + 0.5*fov;
   double   halfSpan       = 0.5 * (azim_max_rad - azim_min_rad);
@@ -213,111 +445,166 @@ bool RadialLOS::compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& o
   {
     azimuths.push_back(azim_max_rad);
   }
+}
 
-  simCore::CoordinateConverter cc;
-  simCore::Coordinate originLlaCoord;
-  cc.convert(originCoord, originLlaCoord, simCore::COORD_SYS_LLA);
-  cc.setReferenceOrigin(originLlaCoord.position());
-
-  bool validLos = false;
-  // step through the azimuthal range:
-  for (std::vector<double>::iterator i = azimuths.begin(); i != azimuths.end(); ++i)
-  {
-    double azim_rad = *i;
-    double x = sin(azim_rad);
-    double y = cos(azim_rad);
-
-    radials_.push_back(Radial(azim_rad));
-    Radial& radial = radials_.back();
-
-    // Track the highest elevation along this azimuth to check for visibility
-    double maxElev = -2 * M_PI;
-    // step through the distance range:
-    bool rangeDone = false;
-    bool lastSampleValid = false;
-    for (double range_m = range_res_m; !rangeDone; range_m += range_res_m)
+void RadialLOS::getRanges_(std::vector<double>& ranges) const
+{
+  ranges.clear();
+  double range_max_m  = range_max_.as(osgEarth::Units::METERS);
+  double range_res_m  = range_resolution_.as(osgEarth::Units::METERS);
+
+  // step through the distance range:
+  bool rangeDone = false;
+  for (double range_m = range_res_m; !rangeDone; range_m += range_res_m)
+  {
+    if (range_m >= range_max_m)
     {
-      if (range_m >= range_max_m)
-      {
-        range_m = range_max_m;
-        rangeDone = true;
-      }
+      range_m = range_max_m;
+      rangeDone = true;
+    }
+    ranges.push_back(range_m);
+  }
+}
 
-      // calculate the world point:
-      osg::Vec3d sampleWorld = osg::Vec3d(x*range_m, y*range_m, 0.0) * local2world;
+void RadialLOS::prepareHeightCache_(const Computation& computation)
+{
+  const double tolerance_m = originTolerance_.as(osgEarth::Units::METERS);
+  if (tolerance_m <= 0.0)
+  {
+    heightCache_.reset();
+    return;
+  }
 
-      // convert to a map point
-      osgEarth::GeoPoint mapPoint;
-      mapPoint.fromWorld(mapNode->getMapSRS(), sampleWorld);
+  // Reuse the cache if the origin is still close to where the terrain was sampled, measuring from
+  // the sampling origin rather than the last origin so that small moves do not accumulate
+  if (heightCache_ &&
+    heightCache_->elevationRevision == computation.elevationRevision &&
+    heightCache_->srs.valid() && heightCache_->srs->isEquivalentTo(computation.srs.get()) &&
+    heightCache_->azimuths == computation.azimuths &&
+    simCore::calculateGroundDist(heightCache_->originLla, computation.originLla.position(), simCore::WGS_84, nullptr) <= tolerance_m)
+    return;
+
+  heightCache_.reset(new HeightCache);
+  heightCache_->srs = computation.srs;
+  heightCache_->elevationRevision = computation.elevationRevision;
+  heightCache_->originLla = computation.originLla.position();
+  heightCache_->azimuths = computation.azimuths;
+  heightCache_->ranges = computation.ranges;
+  heightCache_->heights.resize(computation.azimuths.size() * computation.ranges.size());
+}
 
-      // sample the terrain at that point
-      double hamsl = 0.0, hae = 0.0;
+bool RadialLOS::sampleHeight_(osgEarth::MapNode* mapNode, size_t radialIndex, size_t rangeIndex, const osgEarth::GeoPoint& mapPoint, double& hamsl, double& hae)
+{
+  // Cached heights are only valid for the range steps that match the cached ranges
+  CachedHeight* cached = nullptr;
+  if (heightCache_ && rangeIndex < heightCache_->ranges.size() &&
+    heightCache_->ranges[rangeIndex] == computation_->ranges[rangeIndex])
+  {
+    cached = &heightCache_->heights[radialIndex * heightCache_->ranges.size() + rangeIndex];
+    if (cached->valid)
+    {
+      hamsl = cached->hamsl_m;
+      hae = cached->hae_m;
+      return true;
+    }
+  }
 
-      bool ok;
-      if (use_scene_graph_)
-      {
-        ok = mapNode->getTerrain()->getHeight(mapPoint.getSRS(), mapPoint.x(), mapPoint.y(), &hamsl, &hae);
-      }
-      else
-      {
-        osgEarth::ElevationSample sample = mapNode->getMap()->getElevationPool()->getSample(mapPoint, osgEarth::Distance(1.0, osgEarth::Units::METERS), elevationWorkingSet_.get());
-        hae = sample.elevation().as(osgEarth::Units::METERS);
-        hamsl = hae;
-        ok = true;
-        if (hae == NO_DATA_VALUE)
-        {
-          // If there is invalid data at a point treat it as 0 HAE.
-          hae = 0.0;
-          hamsl = 0.0;
-        }
-      }
+  bool ok;
+  // heights without data are not cached, so that data loaded later is picked up
+  bool hasData = true;
+  if (elevationSource_)
+  {
+    ok = elevationSource_->getHeight(mapPoint, hamsl, hae);
+  }
+  else if (use_scene_graph_)
+  {
+    ok = mapNode->getTerrain()->getHeight(mapPoint.getSRS(), mapPoint.x(), mapPoint.y(), &hamsl, &hae);
+  }
+  else
+  {
+    osgEarth::ElevationSample sample = mapNode->getMap()->getElevationPool()->getSample(mapPoint, osgEarth::Distance(1.0, osgEarth::Units::METERS), elevationWorkingSet_.get());
+    hae = sample.elevation().as(osgEarth::Units::METERS);
+    hamsl = hae;
+    ok = true;
+    if (hae == NO_DATA_VALUE)
+    {
+      // If there is invalid data at a point treat it as 0 HAE.
+      hae = 0.0;
+      hamsl = 0.0;
+      hasData = false;
+    }
+  }
 
-      if (ok)
-      {
-        // see if the point is unobstructed.
-        mapPoint.z() = hae;
+  if (cached && ok && hasData)
+  {
+    cached->valid = true;
+    cached->hamsl_m = hamsl;
+    cached->hae_m = hae;
+  }
+  return ok;
+}
 
-        simCore::Coordinate destCoord;
-        convertGeoPointToCoord(mapPoint, destCoord, mapNode);
+void RadialLOS::computeRadial_(osgEarth::MapNode* mapNode)
+{
+  Computation& c = *computation_;
+  const size_t radialIndex = c.radials.size();
+  double azim_rad = c.azimuths[radialIndex];
+  double x = sin(azim_rad);
+  double y = cos(azim_rad);
+
+  c.radials.push_back(Radial(azim_rad));
+  Radial& radial = c.radials.back();
+  radial.samples_.reserve(c.ranges.size());
+
+  // Track the highest elevation along this azimuth to check for visibility
+  double maxElev = -2 * M_PI;
+  for (size_t rangeIndex = 0; rangeIndex < c.ranges.size(); ++rangeIndex)
+  {
+    const double range_m = c.ranges[rangeIndex];
 
-        double elev;
-        simCore::calculateAbsAzEl(originLlaCoord.position(), destCoord.position(), nullptr, &elev, nullptr, simCore::FLAT_EARTH, &cc);
+    // calculate the world point:
+    osg::Vec3d sampleWorld = osg::Vec3d(x*range_m, y*range_m, 0.0) * c.local2world;
 
-        bool visible = false;
-        if (elev >= maxElev)
-        {
-          maxElev = elev;
-          visible = true;
-        }
+    // convert to a map point
+    osgEarth::GeoPoint mapPoint;
+    mapPoint.fromWorld(c.srs.get(), sampleWorld);
 
-        radial.samples_.push_back(Sample(range_m, mapPoint, hamsl, hae, elev, visible));
-        if (!validLos)
-        {
-          // To be valid there needs to be at least two consecutive points on the same azimuth
-          if (lastSampleValid)
-            validLos = true;
-          lastSampleValid = true;
-        }
+    // sample the terrain at that point
+    double hamsl = 0.0, hae = 0.0;
+    if (sampleHeight_(mapNode, radialIndex, rangeIndex, mapPoint, hamsl, hae))
+    {
+      // see if the point is unobstructed.
+      mapPoint.z() = hae;
+
+      simCore::Coordinate destCoord;
+      convertAbsoluteGeoPointToLla(mapPoint, destCoord);
+
+      double elev;
+      simCore::calculateAbsAzEl(c.originLla.position(), destCoord.position(), nullptr, &elev, nullptr, simCore::FLAT_EARTH, &c.cc);
+
+      bool visible = false;
+      if (elev >= maxElev)
+      {
+        maxElev = elev;
+        visible = true;
       }
-      else
+
+      radial.samples_.push_back(Sample(range_m, mapPoint, hamsl, hae, elev, visible));
+      if (!c.validLos)
       {
-        // record an "invalid" sample
-        radial.samples_.push_back(Sample(range_m, mapPoint));
-        lastSampleValid = false;
+        // To be valid there needs to be at least two consecutive points on the same azimuth
+        if (c.lastSampleValid)
+          c.validLos = true;
+        c.lastSampleValid = true;
       }
     }
+    else
+    {
+      // record an "invalid" sample
+      radial.samples_.push_back(Sample(range_m, mapPoint));
+      c.lastSampleValid = false;
+    }
   }
-
-  srs_ = mapNode->getMapSRS();
-
-  dirty_ = false;
-
-#ifdef LOS_TIME_PROFILING
-  osg::Timer_t endTime = osg::Timer::instance()->tick();
-  SIM_NOTICE << "RLOS::compute time=" << osg::Timer::instance()->delta_m(startTime, endTime) << " ms" << std::endl;
-#endif
-
-  return validLos;
 }
 
 // Note: this method only used when use_scene_graph_ == true
@@ -353,6 +640,9 @@ bool RadialLOS::update(osgEarth::MapNode* mapNode, const osgEarth::GeoExtent& ex
     // visibility from there on out.
     if (firstNewSampleIndex != ~(0u))
     {
+      // cached heights are stale now that the terrain has changed
+      heightCache_.reset();
+
       osg::Matrix local2world;
       originMap_.createLocalToWorld(local2world);
 
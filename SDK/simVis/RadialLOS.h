@@ -77,6 +77,33 @@ public:
   /** Vector of Samples */
   typedef std::vector<Sample> SampleVector;
 
+  /**
+   * Source of terrain heights for the computation.  By default the map's elevation pool (or
+   * the live scene graph) is sampled; an alternate source may be supplied, for example to
+   * compute against synthetic terrain.
+   */
+  class SDKVIS_EXPORT ElevationSource
+  {
+  public:
+    virtual ~ElevationSource() {}
+
+    /**
+     * Samples the terrain height at the given point.
+     * @param[in ] point Map point to sample; altitude is ignored
+     * @param[out] hamsl Height above mean sea level, in meters
+     * @param[out] hae   Height above ellipsoid, in meters
+     * @return True if the heights are valid
+     */
+    virtual bool getHeight(const osgEarth::GeoPoint& point, double& hamsl, double& hae) = 0;
+
+    /**
+     * Returns a value that changes whenever the heights from getHeight() change.  Cached
+     * heights (see setOriginTolerance()) are discarded when the revision changes.
+     * @return Revision of the terrain data
+     */
+    virtual int getRevision() const { return 0; }
+  };
+
 public:
   /**
    * Constructs a new RLOS computer
@@ -165,6 +192,33 @@ public:
    */
   bool getUseSceneGraph() const { return use_scene_graph_; }
 
+  /**
+   * Sets an alternate source of terrain heights, replacing the map's elevation data.
+   * @param[in ] source Elevation source, or nullptr to sample the map
+   */
+  void setElevationSource(std::shared_ptr<ElevationSource> source);
+
+  /**
+   * Gets the alternate source of terrain heights, if any
+   * @return Elevation source, possibly nullptr
+   */
+  std::shared_ptr<ElevationSource> getElevationSource() const { return elevationSource_; }
+
+  /**
+   * Sets the distance the origin may move from where the terrain was last sampled while
+   * still reusing those terrain heights.  Heights are reused only when the radials and
+   * range steps are unchanged and the elevation data has not changed; visibility is always
+   * recomputed from the new origin.  A tolerance of zero (the default) disables the cache.
+   * @param[in ] value Horizontal distance tolerance
+   */
+  void setOriginTolerance(const osgEarth::Distance& value);
+
+  /**
+   * Gets the distance the origin may move while reusing terrain heights
+   * @return Horizontal distance tolerance
+   */
+  const osgEarth::Distance& getOriginTolerance() const { return originTolerance_; }
+
 public:
 
   /**
@@ -175,6 +229,60 @@ public:
    */
   bool compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& origin);
 
+  /**
+   * Compute the entire set of terrain samples against the elevation source, without a map.
+   * @param[in ] srs    Map spatial reference system for the sample points
+   * @param[in ] origin Origin point for the LOS computation
+   * @return True upon success; false if no elevation source was set
+   */
+  bool compute(const osgEarth::SpatialReference* srs, const simCore::Coordinate& origin);
+
+  /**
+   * Starts an incremental computation, replacing any computation in progress.  No terrain is
+   * sampled until computeStep() is called.  The radials from the previous computation remain
+   * available until the new computation completes; if the computation cannot be started, the
+   * previous radials are cleared, as with compute().
+   * @param[in ] mapNode Map interface to use for sampling
+   * @param[in ] origin  Origin point for the LOS computation
+   * @return True if the computation was started
+   */
+  bool startCompute(osgEarth::MapNode* mapNode, const simCore::Coordinate& origin);
+
+  /**
+   * Starts an incremental computation against the elevation source, without a map.
+   * @param[in ] srs    Map spatial reference system for the sample points
+   * @param[in ] origin Origin point for the LOS computation
+   * @return True if the computation was started; false if no elevation source was set
+   */
+  bool startCompute(const osgEarth::SpatialReference* srs, const simCore::Coordinate& origin);
+
+  /**
+   * Computes radials of the computation in progress until the time budget is spent.  At least
+   * one radial is computed per call, so a budget of zero computes one radial at a time.  When
+   * the last radial completes, the new radials replace the previous result.
+   * @param[in ] budgetSeconds Wall clock time allowed for this call, in seconds
+   * @return True if no computation remains in progress
+   */
+  bool computeStep(double budgetSeconds);
+
+  /** Abandons the computation in progress, if any, keeping the previous result */
+  void cancelCompute();
+
+  /** Returns true if an incremental computation is in progress */
+  bool isComputing() const { return computation_ != nullptr; }
+
+  /**
+   * Gets the fraction of radials completed by the computation in progress
+   * @return Value from 0 to 1; 1 if no computation is in progress
+   */
+  double getComputeProgress() const;
+
+  /**
+   * Returns true if the most recently completed computation found a valid line of sight,
+   * i.e. the same value returned by compute()
+   */
+  bool isValid() const { return valid_; }
+
   /**
    * Re-samples the terrain for all sample points that fall within the specified extent.
    * @param[in ] mapNode Map interface to use for sampling
@@ -234,7 +342,13 @@ public:
   const RadialVector& getRadials() const { return radials_; }
 
 private:
+  /// State of an incremental computation in progress
+  struct Computation;
+  /// Terrain heights from a previous computation
+  struct HeightCache;
+
   bool                dirty_;
+  bool                valid_;
   RadialVector        radials_;
   osgEarth::GeoPoint  originMap_;
   osgEarth::Distance  range_max_;
@@ -245,6 +359,25 @@ private:
   osg::ref_ptr<const osgEarth::SpatialReference> srs_;
   std::unique_ptr<osgEarth::ElevationPool::WorkingSet> elevationWorkingSet_;
   bool use_scene_graph_;
+  std::shared_ptr<ElevationSource> elevationSource_;
+  osgEarth::Distance  originTolerance_;
+  std::unique_ptr<Computation> computation_;
+  std::unique_ptr<HeightCache> heightCache_;
+
+  /** Sets up a computation; mapNode may be nullptr when an elevation source is set */
+  bool startCompute_(osgEarth::MapNode* mapNode, const osgEarth::SpatialReference* srs, const simCore::Coordinate& origin);
+  /** Runs the computation in progress to completion, returning the validity of the result */
+  bool finishCompute_();
+  /** Collects the azimuths of the radials for the current settings */
+  void getAzimuths_(std::vector<double>& azimuths) const;
+  /** Collects the sample ranges along each radial for the current settings */
+  void getRanges_(std::vector<double>& ranges) const;
+  /** Keeps the height cache if the new computation can reuse it, else starts a new one */
+  void prepareHeightCache_(const Computation& computation);
+  /** Samples the next radial of the computation in progress */
+  void computeRadial_(osgEarth::MapNode* mapNode);
+  /** Samples terrain height at the given sample index of the computation, consulting the cache */
+  bool sampleHeight_(osgEarth::MapNode* mapNode, size_t radialIndex, size_t rangeIndex, const osgEarth::GeoPoint& point, double& hamsl, double& hae);
 
   bool getBoundingRadials_(double azim_rad, const Radial*& out_r0, const Radial*& out_r1, double& out_mix) const;
 
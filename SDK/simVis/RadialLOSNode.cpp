@@ -23,6 +23,7 @@
 #include <cassert>
 #include "osg/Depth"
 #include "osgEarth/DrapeableNode"
+#include "osgEarth/NodeUtils"
 #include "osgEarth/Terrain"
 #include "simNotify/Notify.h"
 #include "simVis/Constants.h"
@@ -41,7 +42,10 @@ RadialLOSNode::RadialLOSNode(osgEarth::MapNode* mapNode)
     obstructedColor_(1.0f, 0.0f, 0.0f, 0.5f),
     active_(false),
     isValid_(true),
-    requireUpdateLOS_(true)
+    requireUpdateLOS_(true),
+    computeTimeBudget_(0.0),
+    computePending_(false),
+    updateRequested_(false)
 {
   geode_ = new osg::Geode();
 
@@ -166,6 +170,17 @@ void RadialLOSNode::setAzimuthalResolution(const osgEarth::Angle& value)
   updateLOS_(getMapNode(), coord_);
 }
 
+void RadialLOSNode::setOriginTolerance(const osgEarth::Distance& value)
+{
+  // only affects the next computation
+  los_.setOriginTolerance(value);
+}
+
+void RadialLOSNode::setComputeTimeBudget(double seconds)
+{
+  computeTimeBudget_ = seconds;
+}
+
 bool RadialLOSNode::updateLOS_(osgEarth::MapNode* mapNode, const simCore::Coordinate& coord)
 {
   if (!active_)
@@ -176,18 +191,57 @@ bool RadialLOSNode::updateLOS_(osgEarth::MapNode* mapNode, const simCore::Coordi
 
   requireUpdateLOS_ = false;
 
-  if (!los_.compute(mapNode, coord))
+  if (computeTimeBudget_ > 0.0)
+  {
+    // finish the computation in progress first so that a moving origin still gets results
+    if (los_.isComputing())
+      computePending_ = true;
+    else if (!los_.startCompute(mapNode, coord))
+      setLosValid_(false);
+    setUpdateRequested_(los_.isComputing() || computePending_);
+    // geometry is refreshed when the computation completes
+    return false;
+  }
+
+  return setLosValid_(los_.compute(mapNode, coord));
+}
+
+bool RadialLOSNode::setLosValid_(bool valid)
+{
+  if (!valid && isValid_)
   {
-    if (isValid_)
+    SIM_WARN << "Failed to compute LOS.  Consider adjusting range, azimuth angle and/or altitude.\n";
+  }
+  isValid_ = valid;
+  return valid;
+}
+
+void RadialLOSNode::traverse(osg::NodeVisitor& nv)
+{
+  if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR && active_)
+  {
+    if (los_.isComputing() && los_.computeStep(computeTimeBudget_))
     {
-      SIM_WARN << "Failed to compute LOS.  Consider adjusting range, azimuth angle and/or altitude.\n";
+      if (setLosValid_(los_.isValid()))
+        refreshGeometry_();
+    }
+    if (computePending_ && !los_.isComputing())
+    {
+      computePending_ = false;
+      updateLOS_(getMapNode(), coord_);
     }
-    isValid_ = false;
-    return false;
   }
+  if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
+    setUpdateRequested_(active_ && (los_.isComputing() || computePending_));
+  GeoPositionNode::traverse(nv);
+}
 
-  isValid_ = true;
-  return true;
+void RadialLOSNode::setUpdateRequested_(bool requested)
+{
+  if (updateRequested_ == requested)
+    return;
+  ADJUST_UPDATE_TRAV_COUNT(this, requested ? 1 : -1);
+  updateRequested_ = requested;
 }
 
 void RadialLOSNode::updateDataModel(const osgEarth::GeoExtent& extent,
@@ -231,6 +285,8 @@ void RadialLOSNode::setActive(bool active)
     active_ = active;
     if (requireUpdateLOS_)
       updateLOS_(getMapNode(), coord_);
+    // computation pauses while inactive
+    setUpdateRequested_(active_ && (los_.isComputing() || computePending_));
     refreshGeometry_();
   }
 }
@@ -91,8 +91,24 @@ public:
 
   void setAzimuthalResolution(const osgEarth::Angle& value);
   const osgEarth::Angle& getAzimuthalResolution() const { return los_.getAzimuthalResolution(); }
+
+  void setOriginTolerance(const osgEarth::Distance& value);
+  const osgEarth::Distance& getOriginTolerance() const { return los_.getOriginTolerance(); }
   ///@}
 
+  /**
+   * Sets the time allowed for LOS computation in each update traversal.  When positive, changes
+   * to the origin or data model settings are computed a few radials per frame, and the previous
+   * result stays on display until the new one completes.  Changes made while a computation is in
+   * progress are picked up by a new computation once it completes.  Zero (the default) computes
+   * synchronously when settings change.
+   * @param[in ] seconds Time budget per frame, in seconds
+   */
+  void setComputeTimeBudget(double seconds);
+
+  /** Gets the time allowed for LOS computation in each update traversal, in seconds */
+  double getComputeTimeBudget() const { return computeTimeBudget_; }
+
   /**
    * Sets the "visible" color
    * param[in ] color for visible areas (rgba, [0..1])
@@ -129,6 +145,9 @@ public: // GeoPositionNode
   /** Return the class name */
   virtual const char* className() const { return "RadialLOSNode"; }
 
+  /** Steps the incremental LOS computation during the update traversal */
+  virtual void traverse(osg::NodeVisitor& nv);
+
 public: // TerrainCallback
 
   /** Adjusts height of node based on new tiles */
@@ -159,6 +178,12 @@ private:
    */
   bool updateLOS_(osgEarth::MapNode* mapNode, const simCore::Coordinate& coord);
 
+  /** Records the validity of a completed computation, warning when it first fails */
+  bool setLosValid_(bool valid);
+
+  /** Requests or releases update traversals for stepping the LOS computation */
+  void setUpdateRequested_(bool requested);
+
   // callback hook.
   struct TerrainCallbackHook : public osgEarth::TerrainCallback
   {
@@ -182,6 +207,10 @@ private:
   bool active_;
   bool isValid_;
   bool requireUpdateLOS_;
+  double computeTimeBudget_;
+  /** True if settings changed while a computation was in progress */
+  bool computePending_;
+  bool updateRequested_;
 
   /** Rebuilds the geometry if needed when parameters change. */
   void refreshGeometry_();
@@ -31,6 +31,8 @@
 #include "simNotify/Notify.h"
 #include "simCore/Common/Exception.h"
 #include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Geometry.h"
+#include "simCore/Calc/SpatialIndex.h"
 #include "simCore/Time/String.h"
 #include "simData/DataStore.h"
 
@@ -67,6 +69,8 @@
 
 /// The highest available Level of Detail from ElevationPool
 static const unsigned int MAX_LOD = 23;
+/// Distance (m) an entity can move before its spatial index entry is reinserted
+static const double SPATIAL_INDEX_MARGIN = 500.0;
 
 namespace
 {
@@ -464,8 +468,15 @@ ScenarioManager::ScenarioManager(ProjectorManager* projMan)
   projectorManager_(projMan),
   labelContentManager_(new NullLabelContentManager()),
   rfManager_(new simRF::NullRFPropagationManager()),
-  losCreator_(new ScenarioLosCreator())
+  losCreator_(new ScenarioLosCreator()),
+  updateAllEntities_(true),
+  spatialIndex_(new simCore::SpatialIndex(SPATIAL_INDEX_MARGIN))
 {
+  updateStats_.numEntities = 0;
+  updateStats_.numVisited = 0;
+  updateStats_.numUpdated = 0;
+  updateStats_.fullSweep = false;
+
   root_->setName("root");
   root_->addChild(entityGraph_->node());
   addChild(root_.get());
@@ -587,12 +598,16 @@ void ScenarioManager::flush(simData::ObjectId flushedId)
       const EntityRecord* record = i->second.get();
       static_cast<EntityNode*>(record->getNode())->flush();
     }
+    updateAllEntities_ = true;
   }
   else // flush individual entity
   {
     EntityNode* entity = find(flushedId);
     if (entity)
+    {
       entity->flush();
+      requestUpdate_(flushedId);
+    }
   }
   SAFETRYEND("flushing scenario entities");
 }
@@ -623,6 +638,9 @@ void ScenarioManager::clearEntities(simData::DataStore* dataStore)
           // remove it from the scene graph:
           entityGraph_->removeEntity(record);
 
+          pendingUpdateIds_.erase(i->first);
+          frameUpdateIds_.erase(i->first);
+          spatialIndex_->remove(i->first);
           // remove it from the entities list (works because EntityRepo is a map, will not work for vector)
           entities_.erase(i++);
         }
@@ -640,6 +658,9 @@ void ScenarioManager::clearEntities(simData::DataStore* dataStore)
     // just remove everything.
     entityGraph_->clear();
     entities_.clear();
+    pendingUpdateIds_.clear();
+    frameUpdateIds_.clear();
+    spatialIndex_->clear();
     projectorManager_->clear();
     hosterTable_.clear();
   }
@@ -679,6 +700,9 @@ void ScenarioManager::removeEntity(simData::ObjectId id)
     }
 
     // remove it from the entities list
+    pendingUpdateIds_.erase(id);
+    frameUpdateIds_.erase(id);
+    spatialIndex_->remove(id);
     entities_.erase(i);
   }
   SAFETRYEND("removing entity from scenario");
@@ -713,6 +737,7 @@ PlatformNode* ScenarioManager::addPlatform(const simData::PlatformProperties& pr
     node,
     dataStore.platformUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   node->setLosCreator(losCreator_);
 
@@ -745,6 +770,7 @@ BeamNode* ScenarioManager::addBeam(const simData::BeamProperties& props, simData
     node,
     dataStore.beamUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   if (host)
   {
@@ -785,6 +811,7 @@ GateNode* ScenarioManager::addGate(const simData::GateProperties& props, simData
     node,
     dataStore.gateUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
@@ -816,6 +843,7 @@ LaserNode* ScenarioManager::addLaser(const simData::LaserProperties& props, simD
     node,
     dataStore.laserUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
@@ -849,6 +877,7 @@ LobGroupNode* ScenarioManager::addLobGroup(const simData::LobGroupProperties& pr
     node,
     dataStore.lobGroupUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
@@ -879,6 +908,7 @@ CustomRenderingNode* ScenarioManager::addCustomRendering(const simData::CustomRe
     host->addChild(node);
   }
   entities_[node->getId()] = new EntityRecord(node, nullptr, &dataStore);
+  requestUpdate_(node->getId());
   hosterTable_.insert(std::make_pair((host ? host->getId() : 0), node->getId()));
 
   notifyToolsOfAdd_(node);
@@ -907,6 +937,7 @@ ProjectorNode* ScenarioManager::addProjector(const simData::ProjectorProperties&
     node,
     dataStore.projectorUpdateSlice(node->getId()),
     &dataStore);
+  requestUpdate_(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
@@ -932,6 +963,7 @@ bool ScenarioManager::setPlatformPrefs(simData::ObjectId id, const simData::Plat
   {
     // Note that this may trigger the Beam Nose Fixer indirectly
     platform->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting platform prefs of ID " << id));
@@ -945,6 +977,7 @@ bool ScenarioManager::setBeamPrefs(simData::ObjectId id, const simData::BeamPref
   if (beam)
   {
     beam->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting beam prefs of ID " << id));
@@ -958,6 +991,7 @@ bool ScenarioManager::setGatePrefs(simData::ObjectId id, const simData::GatePref
   if (gate)
   {
     gate->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting gate prefs of ID " << id));
@@ -971,6 +1005,7 @@ bool ScenarioManager::setProjectorPrefs(simData::ObjectId id, const simData::Pro
   if (proj)
   {
     proj->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting projector prefs of ID " << id));
@@ -984,6 +1019,7 @@ bool ScenarioManager::setLaserPrefs(simData::ObjectId id, const simData::LaserPr
   if (obj)
   {
     obj->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting laser prefs of ID " << id));
@@ -997,6 +1033,7 @@ bool ScenarioManager::setLobGroupPrefs(simData::ObjectId id, const simData::LobG
   if (obj)
   {
     obj->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting LOB group prefs of ID " << id));
@@ -1010,6 +1047,7 @@ bool ScenarioManager::setCustomRenderingPrefs(simData::ObjectId id, const simDat
   if (obj)
   {
     obj->setPrefs(prefs);
+    requestUpdate_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting custom prefs of ID " << id));
@@ -1267,21 +1305,48 @@ void ScenarioManager::update(simData::DataStore* ds, bool force)
   EntityVector updates;
 
   SAFETRYBEGIN;
-  for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
+  updateStats_.numEntities = entities_.size();
+  updateStats_.numVisited = 0;
+  updateStats_.numUpdated = 0;
+  updateStats_.fullSweep = (force || updateAllEntities_);
+  if (updateStats_.fullSweep)
+  {
+    updateAllEntities_ = false;
+    pendingUpdateIds_.clear();
+    for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
+      updateRecord_(i->first, i->second.get(), force, updates);
+  }
+  else
   {
-    EntityRecord* record = i->second.get();
-
-    bool appliedUpdate = false;
-
-    // Note that entity classes decide how to process 'force' and record->updateSlice_->hasChanged()
-    if (record->updateFromDataStore(force))
+    // Visit only the entities whose slices changed, plus those that asked for an update; in ID order, as with a full sweep
+    std::set<simData::ObjectId> ids;
+    ids.swap(pendingUpdateIds_);
+    simData::DataStore::IdList changedIds;
+    ds->changedIdList(&changedIds);
+    ids.insert(changedIds.begin(), changedIds.end());
+    // Time-dependent work is checked at the new time, since it can come due without any data change
+    for (std::set<simData::ObjectId>::const_iterator i = frameUpdateIds_.begin(); i != frameUpdateIds_.end(); ++i)
     {
-      updates.push_back(record->getEntityNode());
-      appliedUpdate = true;
+      const EntityRepo::const_iterator entry = entities_.find(*i);
+      if (entry != entities_.end() && entry->second->getEntityNode()->needsFrameUpdate())
+        ids.insert(*i);
     }
 
-    if (appliedUpdate)
-      entityGraph_->addOrUpdate(record);
+    while (!ids.empty())
+    {
+      const simData::ObjectId id = *ids.begin();
+      ids.erase(ids.begin());
+      // The data store may report entities that were removed from the scenario
+      const EntityRepo::const_iterator entry = entities_.find(id);
+      if (entry == entities_.end())
+        continue;
+      if (!updateRecord_(id, entry->second.get(), force, updates))
+        continue;
+      // Hosted entities follow their host's transitions, so visit them whenever the host applies an update
+      const std::pair<HosterTable::const_iterator, HosterTable::const_iterator> range = hosterTable_.equal_range(id);
+      for (HosterTable::const_iterator i = range.first; i != range.second; ++i)
+        ids.insert(i->second);
+    }
   }
   SAFETRYEND("checking scenario for updates");
 
@@ -1327,6 +1392,72 @@ void ScenarioManager::update(simData::DataStore* ds, bool force)
   }
 }
 
+bool ScenarioManager::updateRecord_(simData::ObjectId id, EntityRecord* record, bool force, EntityVector& updates)
+{
+  ++updateStats_.numVisited;
+
+  // Note that entity classes decide how to process 'force' and record->updateSlice_->hasChanged()
+  const bool appliedUpdate = record->updateFromDataStore(force);
+  if (appliedUpdate)
+  {
+    ++updateStats_.numUpdated;
+    updates.push_back(record->getEntityNode());
+    entityGraph_->addOrUpdate(record);
+  }
+  updateSpatialIndex_(id, record->getEntityNode());
+
+  // Keep only entities with time-dependent work in the set checked on every update()
+  if (record->getEntityNode()->hasTimeDependentUpdates())
+    frameUpdateIds_.insert(id);
+  else
+    frameUpdateIds_.erase(id);
+  return appliedUpdate;
+}
+
+const ScenarioManager::UpdateStatistics& ScenarioManager::lastUpdateStatistics() const
+{
+  return updateStats_;
+}
+
+void ScenarioManager::updateSpatialIndex_(simData::ObjectId id, const EntityNode* node)
+{
+  simCore::Vec3 ecef;
+  if (node->isActive() && node->getPosition(&ecef) == 0)
+    spatialIndex_->setPosition(id, ecef);
+  else
+    spatialIndex_->remove(id);
+}
+
+void ScenarioManager::entitiesInRadius(const simCore::Vec3& ecef, double radius, std::vector<simData::ObjectId>& ids) const
+{
+  spatialIndex_->queryRadius(ecef, radius, ids);
+}
+
+void ScenarioManager::entitiesInBox(const simCore::Vec3& minEcef, const simCore::Vec3& maxEcef, std::vector<simData::ObjectId>& ids) const
+{
+  spatialIndex_->queryBox(minEcef, maxEcef, ids);
+}
+
+void ScenarioManager::entitiesInVolume(const simCore::Polytope& volume, std::vector<simData::ObjectId>& ids) const
+{
+  spatialIndex_->queryPolytope(volume, ids);
+}
+
+void ScenarioManager::entitiesInFence(const simCore::GeoFence& fence, std::vector<simData::ObjectId>& ids) const
+{
+  spatialIndex_->queryPolytope(fence.polytope(), ids);
+}
+
+void ScenarioManager::nearestEntities(const simCore::Vec3& ecef, size_t k, std::vector<simData::ObjectId>& ids) const
+{
+  spatialIndex_->queryNearest(ecef, k, ids);
+}
+
+void ScenarioManager::requestUpdate_(simData::ObjectId id)
+{
+  pendingUpdateIds_.insert(id);
+}
+
 void ScenarioManager::removeAllTools_()
 {
   std::vector< osg::ref_ptr<ScenarioTool> > scenarioTools;
@@ -1344,6 +1475,8 @@ void ScenarioManager::notifyOfClockChange(const simCore::Clock* clock)
     EntityRecord* record = i->second.get();
     record->getEntityNode()->updateClockMode(clock);
   }
+  // Entities may react to the new mode on their next update
+  updateAllEntities_ = true;
 }
 
 void ScenarioManager::getObjectsHostedBy(const simData::ObjectId& hostId, std::set<simData::ObjectId>& output) const
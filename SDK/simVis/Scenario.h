@@ -24,9 +24,11 @@
 #define SIMVIS_SCENARIO_H
 
 #include <limits>
+#include <memory>
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 #include "osg/Group"
 #include "osg/ref_ptr"
 #include "osg/View"
@@ -37,7 +39,13 @@
 #include "simVis/RFProp/RFPropagationManager.h"
 
 namespace osgEarth { class MapNode; }
-namespace simCore { class Clock; }
+namespace simCore {
+  class Clock;
+  class GeoFence;
+  class Polytope;
+  class SpatialIndex;
+  class Vec3;
+}
 namespace simData { class DataStore; }
 
 namespace simVis
@@ -363,6 +371,37 @@ public: // package protected
   */
   void update(simData::DataStore* ds, bool force = false);
 
+  /** Counts of the entity records processed by the most recent update() */
+  struct UpdateStatistics
+  {
+    size_t numEntities; ///< Entity records in the scenario
+    size_t numVisited;  ///< Records whose entity was asked to update from the data store
+    size_t numUpdated;  ///< Records whose entity applied an update
+    bool fullSweep;     ///< True if every record was visited, false if only changed records were visited
+  };
+
+  /** Retrieves the counts from the most recent update(), for performance monitoring */
+  const UpdateStatistics& lastUpdateStatistics() const;
+
+  /**@name Spatial queries
+   * Active entities of every type are kept in a spatial index of their ECEF positions, refreshed as
+   * they update, so these queries do not need to visit every entity.  Hosted entities are refreshed
+   * when their own data changes and whenever their host applies an update.  Each query appends the
+   * matching entity IDs to the output vector.
+   * @{
+   */
+  /** Retrieves active entities within a distance (m) of an ECEF position */
+  void entitiesInRadius(const simCore::Vec3& ecef, double radius, std::vector<simData::ObjectId>& ids) const;
+  /** Retrieves active entities inside an ECEF axis-aligned box */
+  void entitiesInBox(const simCore::Vec3& minEcef, const simCore::Vec3& maxEcef, std::vector<simData::ObjectId>& ids) const;
+  /** Retrieves active entities inside a convex ECEF volume, such as a view frustum */
+  void entitiesInVolume(const simCore::Polytope& volume, std::vector<simData::ObjectId>& ids) const;
+  /** Retrieves active entities contained by a GeoFence */
+  void entitiesInFence(const simCore::GeoFence& fence, std::vector<simData::ObjectId>& ids) const;
+  /** Retrieves up to k active entities closest to an ECEF position, closest first */
+  void nearestEntities(const simCore::Vec3& ecef, size_t k, std::vector<simData::ObjectId>& ids) const;
+  ///@}
+
   /**
   * Notify all entities of a change in a Clock Mode.
   * @param[in ] clock Clock to propagate to scenario objects.
@@ -456,6 +495,17 @@ protected:
   /** List of all scene graph entities to their ID */
   EntityRepo entities_;
 
+  /** Entities to visit on the next update() even if the data store does not report them as changed */
+  std::set<simData::ObjectId> pendingUpdateIds_;
+  /** Entities with time-dependent work, checked with EntityNode::needsFrameUpdate() on every update() */
+  std::set<simData::ObjectId> frameUpdateIds_;
+  /** When true, the next update() visits every entity */
+  bool updateAllEntities_;
+  /** Counts from the most recent update() */
+  UpdateStatistics updateStats_;
+  /** ECEF positions of active entities */
+  std::unique_ptr<simCore::SpatialIndex> spatialIndex_;
+
   /** table that maps hoster ID's to hostee ID's */
   typedef std::multimap< simData::ObjectId, simData::ObjectId > HosterTable;
   /** Maps the hoster to the hostee, for hosted entity types */
@@ -472,6 +522,12 @@ protected:
   void notifyToolsOfRemove_(EntityNode* node);
   /// informs the scenario tools of a flush
   void notifyToolsOfFlush_(simData::ObjectId flushedId);
+  /// makes sure the next update() visits the entity, whether or not its data changed
+  void requestUpdate_(simData::ObjectId id);
+  /// updates a single entity from the data store, returning true if an update was applied
+  bool updateRecord_(simData::ObjectId id, EntityRecord* record, bool force, EntityVector& updates);
+  /// refreshes the entity's entry in the spatial index after an update
+  void updateSpatialIndex_(simData::ObjectId id, const EntityNode* node);
 
   /// locator that tracks earth rotation linked to sim time
   osg::ref_ptr<Locator> scenarioEciLocator_;
@@ -543,6 +543,39 @@ void TimeTicks::update()
   updateTrackData_(ds_.updateTime(), *updateSlice);
 }
 
+bool TimeTicks::needsUpdate() const
+{
+  // tracklength 0 means no time ticks are shown
+  const int trackLength = lastPlatformPrefs_.trackprefs().tracklength();
+  if (trackLength == 0)
+    return false;
+
+  const double currentTime = ds_.updateTime();
+  if (currentTime == lastCurrentTime_)
+    return false;
+  // nothing drawn yet, or reverse mode; rebuild as update() would
+  if (!hasLastDrawTime_ || timeDirection_ != simCore::FORWARD || chunkGroup_->getNumChildren() == 0)
+    return true;
+  // backward jump resets the ticks
+  if (currentTime < lastCurrentTime_)
+    return true;
+
+  // a new tick is due
+  const TimeTicksChunk* lastChunk = static_cast<const TimeTicksChunk*>(chunkGroup_->getChild(chunkGroup_->getNumChildren() - 1));
+  if (currentTime >= lastChunk->getEndTime() + lastPlatformPrefs_.trackprefs().timeticks().interval())
+    return true;
+
+  // the oldest tick or label falls outside the track length
+  if (trackLength > 0)
+  {
+    const double beginTime = currentTime - trackLength;
+    const TimeTicksChunk* firstChunk = static_cast<const TimeTicksChunk*>(chunkGroup_->getChild(0));
+    if (firstChunk->getBeginTime() < beginTime || (!labels_.empty() && labels_.begin()->first < beginTime))
+      return true;
+  }
+  return false;
+}
+
 void TimeTicks::updateTrackData_(double currentTime, const simData::PlatformUpdateSlice& updateSlice)
 {
   // determine the time window that time ticks should display
@@ -72,6 +72,13 @@ public:
   */
   void update();
 
+  /**
+  * Returns true if update() at the data store's current time would add or remove ticks, assuming the platform's
+  * data has not changed.  Ticks are added at each interval up to the current time and expire at the track length.
+  * @return true if update() needs to be called for the current time
+  */
+  bool needsUpdate() const;
+
   /**
   * Update the time ticks based on the change in the Clock mode, e.g. to
   * change the time direction.
@@ -20,9 +20,14 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include "osgUtil/CullVisitor"
 #include "osgEarth/LineDrawable"
+#include "osgEarth/NodeUtils"
 #include "osgEarth/PointDrawable"
+#include "simCore/Calc/Geometry.h"
 #include "simVis/Locator.h"
 #include "simVis/Types.h"
 #include "simVis/Utils.h"
@@ -47,6 +52,12 @@ unsigned int TrackPointsChunk::size() const
   return count_;
 }
 
+/// how many more points fit in this chunk?
+unsigned int TrackPointsChunk::remainingCapacity() const
+{
+  return isFull() ? 0 : maxSize_ - (offset_ + count_);
+}
+
 
 /// remove the oldest point in this chunk.
 bool TrackPointsChunk::removeOldestPoint()
@@ -112,10 +123,36 @@ bool TrackPointsChunk::isEmpty_() const
 
 //----------------------------------------------------------------------------
 
+namespace
+{
+  /// Douglas-Peucker tolerance of the first decimated level of detail, in meters
+  const double LOD_BASE_TOLERANCE = 1.0;
+  /// Each level of detail allows this many times the error of the previous level
+  const double LOD_TOLERANCE_FACTOR = 4.0;
+  /// Chunks with fewer points than this are always drawn at full resolution
+  const unsigned int LOD_MIN_POINTS = 8;
+  /// Default screen-space error for decimated levels, in pixels
+  const float DEFAULT_LOD_PIXEL_ERROR = 1.f;
+  /// Levels of a changing chunk are rebuilt once this fraction (1/n) of its points have been added or removed
+  const unsigned int LOD_REBUILD_DIVISOR = 8;
+
+  /// Douglas-Peucker tolerance for the level of detail, in meters
+  double lodTolerance(unsigned int level)
+  {
+    return LOD_BASE_TOLERANCE * pow(LOD_TOLERANCE_FACTOR, static_cast<double>(level) - 1.0);
+  }
+}
+
 /** Creates a new chunk with a maximum size. */
 TrackChunkNode::TrackChunkNode(unsigned int maxSize, simData::TrackPrefs_Mode mode)
   : TrackPointsChunk(maxSize),
-  mode_(mode)
+  mode_(mode),
+  lodOffset_(0),
+  lodCount_(0),
+  lodDirty_(false),
+  lodChanged_(false),
+  lodPixelError_(DEFAULT_LOD_PIXEL_ERROR),
+  updateRequested_(false)
 {
   allocate_();
 }
@@ -161,6 +198,35 @@ bool TrackChunkNode::addPoint(const Locator& locator, double t, const osg::Vec4&
   return true;
 }
 
+unsigned int TrackChunkNode::addPoints(const osg::Vec3d* world, const double* t, const osg::Vec4* colors, unsigned int count)
+{
+  // ribbons need orientation for each point; use addPoint()
+  assert(mode_ != simData::TrackPrefs_Mode_RIBBON);
+  // first point positions the chunk and sets world2local_; use addPoint()
+  assert(offset_ + count_ > 0);
+  if (mode_ == simData::TrackPrefs_Mode_RIBBON || (offset_ + count_) == 0)
+    return 0;
+
+  const unsigned int first = offset_ + count_;
+  const unsigned int numAdded = std::min(count, remainingCapacity());
+  for (unsigned int k = 0; k < numAdded; ++k)
+  {
+    const unsigned int i = first + k;
+    times_[i] = t[k];
+    const osg::Vec3f local = world[k] * world2local_;
+    appendPointLine_(i, local, colors[k]);
+    if (mode_ == simData::TrackPrefs_Mode_BRIDGE)
+      appendBridge_(i, local, world[k], colors[k]);
+  }
+
+  if (numAdded > 0)
+  {
+    count_ += numAdded;
+    updatePrimitiveSets_();
+  }
+  return numAdded;
+}
+
 bool TrackChunkNode::getNewestData(osg::Matrix& out_matrix, double& out_time) const
 {
   if (count_ == 0)
@@ -171,6 +237,207 @@ bool TrackChunkNode::getNewestData(osg::Matrix& out_matrix, double& out_time) co
   return true;
 }
 
+void TrackChunkNode::setLodPixelError(float pixels)
+{
+  lodPixelError_ = (pixels > 0.f) ? pixels : 0.f;
+  setUpdateRequested_(lodDirty_ && lodPixelError_ > 0.f);
+}
+
+float TrackChunkNode::lodPixelError() const
+{
+  return lodPixelError_;
+}
+
+unsigned int TrackChunkNode::lodPointCount(unsigned int level) const
+{
+  if (level == 0 || !supportsLod_())
+    return count_;
+  if (level > MAX_LOD_LEVEL)
+    level = MAX_LOD_LEVEL;
+  // levels are only built during update; out of date rankings are recomputed here and discarded
+  std::vector<double> currentImportance;
+  const bool upToDate = !lodDirty_ && !lodLevels_.empty();
+  if (!upToDate)
+    rankLodPoints_(currentImportance);
+  std::vector<size_t> indices;
+  simCore::douglasPeuckerSelect(upToDate ? lodImportance_ : currentImportance, lodTolerance(level), indices);
+  if (keepFullResolution_(indices.size()))
+    return count_;
+  return static_cast<unsigned int>(indices.size());
+}
+
+void TrackChunkNode::traverse(osg::NodeVisitor& nv)
+{
+  if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
+    updateLod_();
+  // levels are only drawn while they match the current points; cull never builds or changes them
+  else if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR && lodPixelError_ > 0.f && !lodDirty_ && !lodLevels_.empty())
+  {
+    osgUtil::CullVisitor* cv = dynamic_cast<osgUtil::CullVisitor*>(&nv);
+    if (cv)
+    {
+      // the chunk's matrix has already been pushed, so the bound is in the same local frame as the pixel size vector
+      const osg::BoundingSphere& bound = fullResolution_()->getBound();
+      const float pixelsPerMeter = cv->clampedPixelSize(bound.center(), 1.f);
+      if (pixelsPerMeter > 0.f)
+      {
+        // choose the coarsest level whose error stays within the allowed pixel error
+        const double tolerance = lodPixelError_ / pixelsPerMeter;
+        unsigned int level = 0;
+        while (level < MAX_LOD_LEVEL && lodTolerance(level + 1) <= tolerance)
+          ++level;
+        if (level > 0)
+        {
+          lodLevels_[level]->accept(nv);
+          return;
+        }
+      }
+    }
+  }
+  LocatorNode::traverse(nv);
+}
+
+void TrackChunkNode::setUpdateRequested_(bool requested)
+{
+  if (updateRequested_ == requested)
+    return;
+  ADJUST_UPDATE_TRAV_COUNT(this, requested ? 1 : -1);
+  updateRequested_ = requested;
+}
+
+bool TrackChunkNode::supportsLod_() const
+{
+  // bridges and ribbons draw additional geometry per point, and are always drawn at full resolution
+  return (mode_ == simData::TrackPrefs_Mode_POINT || mode_ == simData::TrackPrefs_Mode_LINE) &&
+    !localPoints_.empty() && count_ >= LOD_MIN_POINTS;
+}
+
+osg::Node* TrackChunkNode::fullResolution_() const
+{
+  if (mode_ == simData::TrackPrefs_Mode_POINT)
+    return centerPoints_.get();
+  return lineGroup_.get();
+}
+
+void TrackChunkNode::updateLod_()
+{
+  const bool changing = lodChanged_;
+  lodChanged_ = false;
+  if (!lodDirty_ || lodPixelError_ <= 0.f)
+  {
+    setUpdateRequested_(false);
+    return;
+  }
+
+  if (!supportsLod_())
+  {
+    // too few points to decimate; drawn at full resolution
+    lodImportance_.clear();
+    lodLevels_.clear();
+    lodDirty_ = false;
+    setUpdateRequested_(false);
+    return;
+  }
+
+  // stays dirty, drawing at full resolution, until the rebuild is due
+  if (!lodRebuildDue_(changing))
+    return;
+  buildLod_();
+  setUpdateRequested_(false);
+}
+
+bool TrackChunkNode::lodRebuildDue_(bool changing) const
+{
+  // The live chunk gains points as data arrives and data limiting trims the oldest chunk, possibly every
+  // frame.  Rather than running Douglas-Peucker each time, levels are rebuilt once a fraction of the points
+  // have changed, when the chunk fills, or once the points stop changing.
+  if (!lodLevels_.empty())
+  {
+    const unsigned int end = offset_ + count_;
+    const unsigned int lodEnd = lodOffset_ + lodCount_;
+    const unsigned int changed = (offset_ > lodOffset_ ? offset_ - lodOffset_ : lodOffset_ - offset_) +
+      (end > lodEnd ? end - lodEnd : lodEnd - end);
+    if (changed < std::max(LOD_MIN_POINTS, lodCount_ / LOD_REBUILD_DIVISOR))
+      return isFull() && !changing;
+  }
+  return isFull() || !changing;
+}
+
+void TrackChunkNode::rankLodPoints_(std::vector<double>& importance) const
+{
+  simCore::Vec3String points;
+  points.reserve(count_);
+  for (unsigned int i = offset_; i < offset_ + count_; ++i)
+    points.push_back(simCore::Vec3(localPoints_[i].x(), localPoints_[i].y(), localPoints_[i].z()));
+  simCore::douglasPeuckerImportance(points, importance);
+}
+
+bool TrackChunkNode::keepFullResolution_(size_t numSelected) const
+{
+  // keep drawing the full resolution graphic unless decimation saves a meaningful number of points
+  return numSelected * 4 >= static_cast<size_t>(count_) * 3;
+}
+
+void TrackChunkNode::buildLod_()
+{
+  lodLevels_.assign(MAX_LOD_LEVEL + 1, osg::ref_ptr<osg::Node>());
+  lodLevels_[0] = fullResolution_();
+
+  // rank the current points once for all levels
+  rankLodPoints_(lodImportance_);
+
+  std::vector<size_t> indices;
+  size_t previousSize = count_;
+  for (unsigned int level = 1; level <= MAX_LOD_LEVEL; ++level)
+  {
+    simCore::douglasPeuckerSelect(lodImportance_, lodTolerance(level), indices);
+    if (keepFullResolution_(indices.size()))
+      lodLevels_[level] = fullResolution_();
+    else if (indices.size() == previousSize)
+      lodLevels_[level] = lodLevels_[level - 1];
+    else
+      lodLevels_[level] = buildLodLevel_(indices);
+    previousSize = indices.size();
+  }
+
+  lodOffset_ = offset_;
+  lodCount_ = count_;
+  lodDirty_ = false;
+}
+
+osg::Node* TrackChunkNode::buildLodLevel_(const std::vector<size_t>& indices) const
+{
+  const unsigned int numPoints = static_cast<unsigned int>(indices.size());
+  if (mode_ == simData::TrackPrefs_Mode_POINT)
+  {
+    osgEarth::PointDrawable* points = new osgEarth::PointDrawable();
+    points->allocate(numPoints);
+    points->setColor(simVis::Color::White);
+    points->finish();
+    for (unsigned int k = 0; k < numPoints; ++k)
+    {
+      points->setVertex(k, localPoints_[offset_ + indices[k]]);
+      points->setColor(k, colors_[offset_ + indices[k]]);
+    }
+    points->setFirst(0);
+    points->setCount(numPoints);
+    return points;
+  }
+
+  osgEarth::LineGroup* group = new osgEarth::LineGroup();
+  osgEarth::LineDrawable* line = new osgEarth::LineDrawable(GL_LINE_STRIP);
+  line->allocate(numPoints);
+  for (unsigned int k = 0; k < numPoints; ++k)
+  {
+    line->setVertex(k, localPoints_[offset_ + indices[k]]);
+    line->setColor(k, colors_[offset_ + indices[k]]);
+  }
+  line->setFirst(0);
+  line->setCount(numPoints);
+  group->addChild(line);
+  return group;
+}
+
 /// allocate the graphical elements for this chunk.
 void TrackChunkNode::allocate_()
 {
@@ -228,6 +495,23 @@ void TrackChunkNode::allocate_()
 
   // reset to identity matrices
   world2local_ = osg::Matrixd::identity();
+
+  // copies of the points for building levels of detail
+  lodImportance_.clear();
+  lodLevels_.clear();
+  lodOffset_ = 0;
+  lodCount_ = 0;
+  lodDirty_ = false;
+  if (mode_ == simData::TrackPrefs_Mode_POINT || mode_ == simData::TrackPrefs_Mode_LINE)
+  {
+    localPoints_.resize(maxSize_);
+    colors_.resize(maxSize_);
+  }
+  else
+  {
+    localPoints_.clear();
+    colors_.clear();
+  }
 }
 
 void TrackChunkNode::appendEci_(const Locator& locator, const osg::Vec4& color, const osg::Vec2& hostBounds)
@@ -277,6 +561,12 @@ void TrackChunkNode::append_(const Locator& locator, const osg::Vec4& color, con
 
 void TrackChunkNode::appendPointLine_(unsigned int i, const osg::Vec3f& local, const osg::Vec4& color)
 {
+  if (!localPoints_.empty())
+  {
+    localPoints_[i] = local;
+    colors_[i] = color;
+  }
+
   if (mode_ == simData::TrackPrefs_Mode_POINT)
   {
     centerPoints_->setVertex(i, local);
@@ -327,6 +617,14 @@ void TrackChunkNode::appendRibbon_(unsigned int i, const osg::Matrixd& localMatr
 /// update the offset and count on each primitive set to draw the proper data.
 void TrackChunkNode::updatePrimitiveSets_()
 {
+  // points changed; levels of detail are rebuilt during a later update traversal
+  if (!localPoints_.empty())
+  {
+    lodDirty_ = true;
+    lodChanged_ = true;
+    setUpdateRequested_(lodPixelError_ > 0.f);
+  }
+
   if (mode_ == simData::TrackPrefs_Mode_POINT)
   {
     centerPoints_->setFirst(offset_);
@@ -23,6 +23,7 @@
 #ifndef SIMVIS_TRACK_CHUNK_NODE_H
 #define SIMVIS_TRACK_CHUNK_NODE_H
 
+#include <vector>
 #include "osg/ref_ptr"
 #include "osgEarth/LineDrawable"
 #include "osgEarth/PointDrawable"
@@ -49,6 +50,14 @@ namespace simVis
  * Each chunk lives under its own MT to prevent single-precision jitter
  * effects in a geocentric map.
  *
+ * Point and line mode chunks support level of detail.  When a chunk covers few
+ * pixels on screen, it draws a Douglas-Peucker decimation of its points whose
+ * screen-space error is within setLodPixelError().  Decimated levels are built
+ * on the CPU during the update traversal, never during cull.  A chunk that is
+ * still gaining points, or is being trimmed by data limiting, is drawn at full
+ * resolution until enough of its points change, it fills, or its points stop
+ * changing, so that its levels are not rebuilt every frame.
+ *
  * Note: Choose the Chunk Size carefully. Each chunk pre-allocates all the memory
  * it will possibly need, so if you have a large number of entities with track
  * histories, you can quickly run out of memory.
@@ -74,6 +83,12 @@ public:
   */
   unsigned int size() const;
 
+  /**
+  * How many more points can be added to this chunk?
+  * @return number of points that can be added before the chunk is full
+  */
+  unsigned int remainingCapacity() const;
+
   /**
   * Return time of the first point in this chunk in seconds since ref year, accounting for data limiting
   * @return begin time in seconds
@@ -146,6 +161,19 @@ public:
   */
   bool addPoint(const Locator& locator, double t, const osg::Vec4& color, const osg::Vec2& hostBounds);
 
+  /**
+  * Add a run of points to the chunk, updating the primitive sets once.  The chunk must already
+  * hold at least one point added with addPoint(), which positions the chunk.  Only supported for
+  * the point, line and bridge draw modes, and not for ECI locators, since ribbons need each
+  * point's orientation and ECI needs each point's rotation.
+  * @param world ECEF position of each point
+  * @param t time of each point
+  * @param colors color of each point
+  * @param count number of points
+  * @return number of points added, which is less than count if the chunk fills up
+  */
+  unsigned int addPoints(const osg::Vec3d* world, const double* t, const osg::Vec4* colors, unsigned int count);
+
   /**
   * Get the matrix and time associated with the newest point in this chunk
   * @param out_matrix position matrix for the newest point in the chunk
@@ -154,6 +182,30 @@ public:
   */
   bool getNewestData(osg::Matrix& out_matrix, double& out_time) const;
 
+  /**
+  * Sets the largest screen-space error allowed when drawing a decimated level of detail.
+  * Only applies to point and line draw modes.
+  * @param pixels maximum distance in pixels between a dropped point and the decimated track; 0 disables level of detail
+  */
+  void setLodPixelError(float pixels);
+  /** @return largest screen-space error allowed when drawing a decimated level of detail, in pixels */
+  float lodPixelError() const;
+
+  /**
+  * Number of points drawn at the given level of detail for the current points.  Level 0 is full resolution,
+  * and each subsequent level allows four times the error of the previous level, starting at 1 meter for level 1.
+  * Computed on demand when the built levels are out of date, without building or changing them.
+  * @param level level of detail, up to MAX_LOD_LEVEL
+  * @return number of points drawn at that level
+  */
+  unsigned int lodPointCount(unsigned int level) const;
+
+  /** Coarsest level of detail */
+  static const unsigned int MAX_LOD_LEVEL = 8;
+
+  /// Builds levels of detail during update traversal and selects one during cull traversal
+  virtual void traverse(osg::NodeVisitor& nv);
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
 
@@ -183,6 +235,25 @@ private:
   /// Appends a new ribbon element to each geometry set.
   void appendRibbon_(unsigned int i, const osg::Matrixd& localMatrix, const osg::Vec4& color, const osg::Vec2& hostBounds);
 
+  /// Returns true if the draw mode and current points support decimated levels of detail
+  bool supportsLod_() const;
+  /// Returns the full resolution graphic for point or line mode
+  osg::Node* fullResolution_() const;
+  /// Rebuilds out of date levels of detail when due; called during update traversal
+  void updateLod_();
+  /// Returns true if out of date levels should be rebuilt now; changing is true if points changed since the last update traversal
+  bool lodRebuildDue_(bool changing) const;
+  /// Ranks the current points for decimation, in the form used by simCore::douglasPeuckerSelect()
+  void rankLodPoints_(std::vector<double>& importance) const;
+  /// Returns true if a level that keeps only the given number of points saves too little to replace full resolution
+  bool keepFullResolution_(size_t numSelected) const;
+  /// Ranks the current points and builds every level of detail
+  void buildLod_();
+  /// Requests or cancels update traversals for rebuilding levels of detail
+  void setUpdateRequested_(bool requested);
+  /// Builds a point or line graphic from the given subset of points
+  osg::Node* buildLodLevel_(const std::vector<size_t>& indices) const;
+
 private:
   osg::ref_ptr<Locator> localLocator_;
   osg::ref_ptr<osg::Group> lineGroup_;
@@ -192,6 +263,27 @@ private:
   osg::ref_ptr<osgEarth::LineDrawable> drop_;
   osg::Matrixd world2local_;
   simData::TrackPrefs_Mode mode_;  ///<  track draw mode that this chunk will display
+
+  /// Local position of each point, kept for building levels of detail in point and line modes
+  std::vector<osg::Vec3f> localPoints_;
+  /// Color of each point, kept for building levels of detail in point and line modes
+  std::vector<osg::Vec4> colors_;
+  /// Douglas-Peucker importance of each point covered by the levels, in meters
+  std::vector<double> lodImportance_;
+  /// Graphic for each level of detail; level 0 is the full resolution graphic
+  std::vector<osg::ref_ptr<osg::Node> > lodLevels_;
+  /// Offset of the first point covered by the levels
+  unsigned int lodOffset_;
+  /// Number of points covered by the levels
+  unsigned int lodCount_;
+  /// Points were added or removed since the levels were built; out of date levels are not drawn
+  bool lodDirty_;
+  /// Points were added or removed since the last update traversal
+  bool lodChanged_;
+  /// Largest screen-space error in pixels for decimated levels; 0 disables level of detail
+  float lodPixelError_;
+  /// Whether an update traversal has been requested for rebuilding levels of detail
+  bool updateRequested_;
 };
 
 } // namespace simVis
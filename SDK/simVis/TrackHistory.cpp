@@ -764,35 +764,107 @@ void TrackHistoryNode::backfillTrackHistory_(double endTime, double beginTime)
     return;
   }
 
-  if (timeDirection_ == simCore::FORWARD)
+  // ribbons need each point's orientation and ECI needs each point's rotation, so those go through addUpdate_() one at a time;
+  // otherwise, points are converted directly to ECEF vertices and handed to each chunk in a single batch
+  const bool bulk = (lastPlatformPrefs_.trackprefs().trackdrawmode() != simData::TrackPrefs_Mode_RIBBON) && !localLocator_->isEci();
+  const bool forward = (timeDirection_ == simCore::FORWARD);
+
+  // forward: get an iterator that will take us from beginTime up to and including endTime: [beginTime, endTime]
+  // reverse: get an iterator that will take us from [endTime, beginTime]
+  simData::PlatformUpdateSlice::Iterator iter = forward ? updateSlice->lower_bound(beginTime) : updateSlice->upper_bound(endTime);
+
+  // A single iterator walks the range; the update preceding each point (in draw order) is copied rather than
+  // obtained by cloning the iterator, since slice iterators may reuse their storage for returned updates.
+  // When going backwards in time, the preceding update is actually the next update in the slice.
+  // The copy is only needed when addUpdate_() starts a new chunk, so the bulk path only copies the update that fills a chunk.
+  simData::PlatformUpdate prevUpdate;
+  bool hasPrevUpdate = false;
+  const simData::PlatformUpdate* before = forward ? iter.peekPrevious() : iter.peekNext();
+  if (before != nullptr)
   {
-    // get an iterator that will take us from beginTime up to and including endTime: [beginTime, endTime]
-    simData::PlatformUpdateSlice::Iterator iter = updateSlice->lower_bound(beginTime);
-    while (iter.hasNext() && iter.peekNext()->time() <= endTime)
+    prevUpdate = *before;
+    hasPrevUpdate = true;
+  }
+
+  // filters depend only on prefs, so decide once whether bulk points need to go through them
+  const bool filtered = bulk && platformTspiFilterManager_.isApplicable(lastPlatformPrefs_);
+  TrackChunkNode* bulkChunk = nullptr;
+  while (forward ? (iter.hasNext() && iter.peekNext()->time() <= endTime) : (iter.hasPrevious() && iter.peekPrevious()->time() >= beginTime))
+  {
+    const simData::PlatformUpdate* u = forward ? iter.next() : iter.previous();
+    // if assert fails, hasNext()/hasPrevious() and next()/previous() are not in agreement, check iterator implementation
+    assert(u);
+
+    if (bulk && bulkChunk == nullptr)
+      bulkChunk = getCurrentChunk_();
+
+    if (bulkChunk != nullptr)
     {
-      simData::PlatformUpdateSlice::Iterator prevIter = iter;
-      const simData::PlatformUpdate* prevUpdate = prevIter.previous();
-      const simData::PlatformUpdate* u = iter.next();
-      // if assert fails, hasNext() and next() are not in agreement, check iterator implementation
-      assert(u);
-      addUpdate_(*u, prevUpdate);
+      // chunk is flushed once it fills, after which a new chunk (with its continuity point) is needed
+      if (queueBulkPoint_(bulkChunk, *u, filtered))
+      {
+        bulkChunk = nullptr;
+        prevUpdate = *u;
+        hasPrevUpdate = true;
+      }
+    }
+    else
+    {
+      // creates the chunk if needed, which is positioned by its first point
+      addUpdate_(*u, hasPrevUpdate ? &prevUpdate : nullptr);
+      prevUpdate = *u;
+      hasPrevUpdate = true;
     }
   }
+
+  if (bulkChunk != nullptr)
+    flushBulkPoints_(bulkChunk);
+}
+
+bool TrackHistoryNode::queueBulkPoint_(TrackChunkNode* chunk, const simData::PlatformUpdate& u, bool filtered)
+{
+  if (filtered)
+  {
+    // filters work on a copy of the update
+    simCore::Coordinate ecefCoord;
+    if (!getCoord_(u, ecefCoord))
+      return false;
+    bulkWorld_.push_back(osg::Vec3d(ecefCoord.x(), ecefCoord.y(), ecefCoord.z()));
+  }
   else
+    bulkWorld_.push_back(osg::Vec3d(u.x(), u.y(), u.z()));
+
+  bulkTimes_.push_back(toDrawTime_(u.time()));
+  if (bulkWorld_.size() < chunk->remainingCapacity())
+    return false;
+
+  flushBulkPoints_(chunk);
+  return true;
+}
+
+void TrackHistoryNode::flushBulkPoints_(TrackChunkNode* chunk)
+{
+  if (bulkWorld_.empty())
+    return;
+
+  const unsigned int numQueued = static_cast<unsigned int>(bulkWorld_.size());
+  bulkColors_.resize(numQueued);
+  for (unsigned int k = 0; k < numQueued; ++k)
+    bulkColors_[k] = historyColorAtTime_(bulkTimes_[k]);
+  const unsigned int numAdded = chunk->addPoints(&bulkWorld_[0], &bulkTimes_[0], &bulkColors_[0], numQueued);
+  // if assert fails, queueBulkPoint_ allowed more points than the chunk could hold
+  assert(numAdded == numQueued);
+  if (numAdded > 0)
   {
-    // get an iterator that will take us from [endTime, beginTime]
-    simData::PlatformUpdateSlice::Iterator iter = updateSlice->upper_bound(endTime);
-    while (iter.hasPrevious() && iter.peekPrevious()->time() >= beginTime)
-    {
-      // since this is going backwards in time, prevIter is actually next, grab it before iterator moves backwards
-      simData::PlatformUpdateSlice::Iterator prevIter = iter;
-      const simData::PlatformUpdate* prevUpdate = prevIter.next();
-      const simData::PlatformUpdate* u = iter.previous();
-      // if assert fails, hasPrevious() and previous() are not in agreement, check iterator implementation
-      assert(u);
-      addUpdate_(*u, prevUpdate);
-    }
+    totalPoints_ += numAdded;
+    // same semantics as addUpdate_: newest point in forward mode, earliest point in reverse mode
+    lastDrawTime_ = bulkTimes_[numAdded - 1];
+    hasLastDrawTime_ = true;
   }
+
+  bulkWorld_.clear();
+  bulkTimes_.clear();
+  bulkColors_.clear();
 }
 
 // update the track's representation of the current point, if that point is interpolated
@@ -875,6 +947,16 @@ void TrackHistoryNode::updateCurrentPoint_(const simData::PlatformUpdateSlice& u
 
 bool TrackHistoryNode::getCoord_(const simData::PlatformUpdate& u, simCore::Coordinate& ecefCoord)
 {
+  // avoid copying the update when no filter can change it
+  if (!platformTspiFilterManager_.isApplicable(lastPlatformPrefs_))
+  {
+    ecefCoord = simCore::Coordinate(
+      simCore::COORD_SYS_ECEF,
+      simCore::Vec3(u.x(), u.y(), u.z()),
+      simCore::Vec3(u.psi(), u.theta(), u.phi()));
+    return true;
+  }
+
   simData::PlatformUpdate update = u;
   if (platformTspiFilterManager_.filter(update, lastPlatformPrefs_, lastPlatformProps_) == PlatformTspiFilterManager::POINT_DROPPED)
     return false;
@@ -23,6 +23,7 @@
 #ifndef SIMVIS_TRACK_HISTORY_H
 #define SIMVIS_TRACK_HISTORY_H
 
+#include <vector>
 #include "osg/Group"
 #include "simCore/Time/Clock.h"
 #include "simData/DataSlice.h"
@@ -194,6 +195,24 @@ private: // methods
   */
   void addUpdate_(const simData::PlatformUpdate& update, const simData::PlatformUpdate* prevUpdate);
 
+  /**
+  * Queue a point for bulk addition to the given chunk during backfill.  Queued points are
+  * sent to the chunk when it cannot hold any more, or when flushBulkPoints_() is called.
+  * Bulk addition is only possible for line, point and bridge modes with a non-ECI locator.
+  * @param chunk chunk that will receive the point; must already contain at least one point
+  * @param update platform update from which to obtain track position information
+  * @param filtered true if TSPI filters apply, in which case the update is filtered before being queued;
+  *   otherwise its ECEF position is queued as is
+  * @return true if the chunk is now full and was flushed, false otherwise
+  */
+  bool queueBulkPoint_(TrackChunkNode* chunk, const simData::PlatformUpdate& update, bool filtered);
+
+  /**
+  * Send all queued bulk points to the chunk in a single primitive set update
+  * @param chunk chunk that receives the queued points
+  */
+  void flushBulkPoints_(TrackChunkNode* chunk);
+
   /**
   * Convert update time to draw time
   * To support REVERSE playback mode, we play a little trick and simply negate
@@ -255,6 +274,12 @@ private: // data
   osg::ref_ptr<simVis::Locator> parentLocator_;
   /// locator to calculate track point positions
   osg::ref_ptr<simVis::Locator> localLocator_;
+  /// ECEF positions of points queued for bulk addition during backfill
+  std::vector<osg::Vec3d> bulkWorld_;
+  /// draw times of points queued for bulk addition during backfill
+  std::vector<double> bulkTimes_;
+  /// colors of queued bulk points, filled in by flushBulkPoints_()
+  std::vector<osg::Vec4> bulkColors_;
   /// observer for changes to the internal track color data table
   simData::DataTable::TableObserverPtr colorChangeObserver_;
   /// observer for when the internal track color data table is added/removed
@@ -20,14 +20,22 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Math.h"
 #include "simCore/Calc/Calculations.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Geometry.h"
+#include "simCore/Calc/LocalFrame.h"
+#include "simCore/Calc/RelativeGeometry.h"
 #include "simCore/Calc/CoordinateSystem.h"
 #include "simCore/Calc/Random.h"
 #include "simCore/Calc/NumericalAnalysis.h"
+#include "simCore/Time/Utils.h"
 
 namespace {
 
@@ -1822,6 +1830,386 @@ int testTangentPlane2Sphere()
   return rv;
 }
 
+
+int testLocalFrame()
+{
+  int rv = 0;
+  // Hosts include the equator, the antimeridian and a high latitude
+  const simCore::Vec3 hosts[] = {
+    simCore::Vec3(0.0, 0.0, 0.0),
+    simCore::Vec3(22.3 * simCore::DEG2RAD, 179.9 * simCore::DEG2RAD, 1500.0),
+    simCore::Vec3(-37.5 * simCore::DEG2RAD, -76.1 * simCore::DEG2RAD, 12000.0),
+    simCore::Vec3(84.0 * simCore::DEG2RAD, 10.0 * simCore::DEG2RAD, -20.0)
+  };
+  const simCore::Vec3 targets[] = {
+    simCore::Vec3(0.1 * simCore::DEG2RAD, 0.2 * simCore::DEG2RAD, 100.0),
+    simCore::Vec3(22.0 * simCore::DEG2RAD, -179.8 * simCore::DEG2RAD, 3000.0),
+    simCore::Vec3(-37.0 * simCore::DEG2RAD, -75.0 * simCore::DEG2RAD, 0.0),
+    simCore::Vec3(85.0 * simCore::DEG2RAD, 40.0 * simCore::DEG2RAD, 9000.0)
+  };
+  const simCore::Vec3 hostOri(0.3, -0.1, 0.05);
+
+  simCore::CoordinateConverter flatEarthConv;
+  flatEarthConv.setReferenceOrigin(hosts[2]);
+
+  simCore::LocalFrame frame;
+  rv += SDK_ASSERT(!frame.isValid());
+  for (size_t h = 0; h < sizeof(hosts) / sizeof(hosts[0]); ++h)
+  {
+    const simCore::Vec3& host = hosts[h];
+    frame.setOrigin(host);
+    rv += SDK_ASSERT(frame.isValid());
+    rv += SDK_ASSERT(frame.originLla() == host);
+    rv += SDK_ASSERT(frame.converter().hasReferenceOrigin());
+
+    // Cached matrices match the CoordinateConverter
+    const simCore::LocalLevelFrame frames[] = { simCore::LOCAL_LEVEL_FRAME_NED, simCore::LOCAL_LEVEL_FRAME_NWU, simCore::LOCAL_LEVEL_FRAME_ENU };
+    for (size_t f = 0; f < 3; ++f)
+    {
+      double expected[3][3];
+      double cached[3][3];
+      simCore::CoordinateConverter::setLocalToEarthMatrix(host.lat(), host.lon(), frames[f], expected);
+      frame.localToEarthMatrix(frames[f], cached);
+      for (size_t row = 0; row < 3; ++row)
+        rv += SDK_ASSERT(simCore::v3AreEqual(simCore::Vec3(cached[row]), simCore::Vec3(expected[row]), 1e-15));
+    }
+
+    // Origin orientation conversions match the CoordinateConverter
+    simCore::Vec3 ecefOri;
+    simCore::Vec3 expectedOri;
+    frame.geodeticOriToEcef(hostOri, ecefOri);
+    simCore::CoordinateConverter::convertGeodeticOriToEcef(host, hostOri, expectedOri);
+    rv += SDK_ASSERT(simCore::v3AreEqual(ecefOri, expectedOri, 1e-12));
+    simCore::Vec3 llaOri;
+    frame.ecefOriToGeodetic(ecefOri, llaOri);
+    rv += SDK_ASSERT(simCore::v3AreEqual(llaOri, hostOri, 1e-9));
+
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t)
+    {
+      const simCore::Vec3& target = targets[t];
+
+      // Local positions match X-East, and convert back to ECEF
+      simCore::Coordinate xEast;
+      frame.converter().convert(simCore::Coordinate(simCore::COORD_SYS_LLA, target), xEast, simCore::COORD_SYS_XEAST);
+      simCore::Vec3 local;
+      frame.geodeticToLocal(target, local);
+      rv += SDK_ASSERT(simCore::v3AreEqual(local, xEast.position(), 1e-6));
+      simCore::Vec3 ecef;
+      simCore::Vec3 targetEcef;
+      frame.localToEcef(local, ecef);
+      simCore::CoordinateConverter::convertGeodeticPosToEcef(target, targetEcef);
+      rv += SDK_ASSERT(simCore::v3AreEqual(ecef, targetEcef, 1e-6));
+      simCore::Vec3 vec;
+      simCore::Vec3 back;
+      frame.rotateEcefToLocal(simCore::Vec3(10., -20., 30.), vec);
+      frame.rotateLocalToEcef(vec, back);
+      rv += SDK_ASSERT(simCore::v3AreEqual(back, simCore::Vec3(10., -20., 30.), 1e-9));
+
+      // Calculations through the frame match the Vec3 versions for every earth model
+      const simCore::EarthModelCalculations models[] = { simCore::WGS_84, simCore::TANGENT_PLANE_WGS_84, simCore::FLAT_EARTH, simCore::PERFECT_SPHERE };
+      for (size_t m = 0; m < 4; ++m)
+      {
+        const simCore::EarthModelCalculations model = models[m];
+        double az1 = 0.;
+        double el1 = 0.;
+        double cmp1 = 0.;
+        double az2 = 0.;
+        double el2 = 0.;
+        double cmp2 = 0.;
+        if (model != simCore::PERFECT_SPHERE)
+        {
+          simCore::calculateRelAzEl(host, hostOri, target, &az1, &el1, &cmp1, model, &flatEarthConv);
+          simCore::calculateRelAzEl(frame, hostOri, target, &az2, &el2, &cmp2, model, &flatEarthConv);
+          rv += SDK_ASSERT(simCore::areAnglesEqual(az1, az2, 1e-9));
+          rv += SDK_ASSERT(simCore::areAnglesEqual(el1, el2, 1e-9));
+          rv += SDK_ASSERT(simCore::areAnglesEqual(cmp1, cmp2, 1e-9));
+        }
+
+        simCore::calculateAbsAzEl(host, target, &az1, &el1, &cmp1, model, &flatEarthConv);
+        simCore::calculateAbsAzEl(frame, target, &az2, &el2, &cmp2, model, &flatEarthConv);
+        rv += SDK_ASSERT(simCore::areAnglesEqual(az1, az2, 1e-9));
+        rv += SDK_ASSERT(simCore::areAnglesEqual(el1, el2, 1e-9));
+        rv += SDK_ASSERT(simCore::areAnglesEqual(cmp1, cmp2, 1e-9));
+
+        rv += SDK_ASSERT(simCore::areEqual(simCore::calculateSlant(host, target, model, &flatEarthConv), simCore::calculateSlant(frame, target, model, &flatEarthConv), 1e-6));
+        if (model != simCore::PERFECT_SPHERE)
+        {
+          rv += SDK_ASSERT(simCore::areEqual(simCore::calculateGroundDist(host, target, model, &flatEarthConv), simCore::calculateGroundDist(frame, target, model, &flatEarthConv), 1e-6));
+          rv += SDK_ASSERT(simCore::areEqual(simCore::calculateAltitude(host, target, model, &flatEarthConv), simCore::calculateAltitude(frame, target, model, &flatEarthConv), 1e-6));
+        }
+
+        double dr1 = 0.;
+        double cr1 = 0.;
+        double dv1 = 0.;
+        double dr2 = 0.;
+        double cr2 = 0.;
+        double dv2 = 0.;
+        simCore::calculateDRCRDownValue(host, hostOri.yaw(), target, model, nullptr, &dr1, &cr1, &dv1);
+        simCore::calculateDRCRDownValue(frame, hostOri.yaw(), target, model, &dr2, &cr2, &dv2);
+        rv += SDK_ASSERT(simCore::areEqual(dr1, dr2, 1e-6));
+        rv += SDK_ASSERT(simCore::areEqual(cr1, cr2, 1e-6));
+        rv += SDK_ASSERT(simCore::areEqual(dv1, dv2, 1e-6));
+      }
+    }
+  }
+  return rv;
+}
+
+
+/** Creates entities spread over a few degrees, moving in different directions */
+std::vector<simCore::RelativeGeometryState> createRelativeGeometryStates(size_t count, double seed)
+{
+  std::vector<simCore::RelativeGeometryState> states;
+  for (size_t k = 0; k < count; ++k)
+  {
+    const double phase = seed + 0.7 * k;
+    const simCore::Vec3 lla((35.0 + 2.0 * sin(phase)) * simCore::DEG2RAD, (-120.0 + 3.0 * cos(1.3 * phase)) * simCore::DEG2RAD, 5000.0 + 4000.0 * sin(2.1 * phase));
+    const simCore::Vec3 ori(simCore::angFix2PI(phase), 0.2 * sin(phase), 0.1 * cos(phase));
+    const simCore::Vec3 vel(200.0 * sin(ori.yaw()), 200.0 * cos(ori.yaw()), 5.0 * sin(3.0 * phase));
+    states.push_back(simCore::RelativeGeometryState(lla, ori, vel));
+  }
+  return states;
+}
+
+int testRelativeGeometryBatch()
+{
+  int rv = 0;
+  const std::vector<simCore::RelativeGeometryState> from = createRelativeGeometryStates(23, 0.1);
+  const std::vector<simCore::RelativeGeometryState> to = createRelativeGeometryStates(31, 2.9);
+  simCore::CoordinateConverter flatEarthConv;
+  flatEarthConv.setReferenceOrigin(simCore::Vec3(35.0 * simCore::DEG2RAD, -120.0 * simCore::DEG2RAD, 0.0));
+
+  simCore::RelativeGeometryBatch singleThread(1);
+  simCore::RelativeGeometryBatch multiThread(4);
+  rv += SDK_ASSERT(singleThread.numThreads() == 1);
+  rv += SDK_ASSERT(multiThread.numThreads() == 4);
+
+  const simCore::EarthModelCalculations models[] = { simCore::WGS_84, simCore::TANGENT_PLANE_WGS_84, simCore::FLAT_EARTH };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    const simCore::EarthModelCalculations model = models[m];
+    simCore::RelativeGeometryBatch::Results results;
+    rv += SDK_ASSERT(multiThread.calculate(from, to, simCore::RelativeGeometryBatch::ALL_OUTPUTS, model, &flatEarthConv, results) == 0);
+    rv += SDK_ASSERT(results.numFrom == from.size() && results.numTo == to.size());
+    rv += SDK_ASSERT(results.slantRange.size() == from.size() * to.size());
+
+    // Thread count does not change the answers
+    simCore::RelativeGeometryBatch::Results singleResults;
+    rv += SDK_ASSERT(singleThread.calculate(from, to, simCore::RelativeGeometryBatch::ALL_OUTPUTS, model, &flatEarthConv, singleResults) == 0);
+    rv += SDK_ASSERT(singleResults.relAzimuth == results.relAzimuth && singleResults.slantRange == results.slantRange && singleResults.closingVelocity == results.closingVelocity);
+
+    int failures = 0;
+    for (size_t i = 0; i < from.size(); ++i)
+    {
+      for (size_t j = 0; j < to.size(); ++j)
+      {
+        const simCore::RelativeGeometryState& f = from[i];
+        const simCore::RelativeGeometryState& t = to[j];
+        const size_t index = results.index(i, j);
+        double az = 0.;
+        double el = 0.;
+        double cmp = 0.;
+        simCore::calculateRelAzEl(f.lla, f.ori, t.lla, &az, &el, &cmp, model, &flatEarthConv);
+        if (!simCore::areAnglesEqual(az, results.relAzimuth[index], 1e-9) ||
+          !simCore::areAnglesEqual(el, results.relElevation[index], 1e-9) ||
+          !simCore::areAnglesEqual(cmp, results.relComposite[index], 1e-9))
+          ++failures;
+        if (!simCore::areEqual(simCore::calculateSlant(f.lla, t.lla, model, &flatEarthConv), results.slantRange[index], 1e-6) ||
+          !simCore::areEqual(simCore::calculateGroundDist(f.lla, t.lla, model, &flatEarthConv), results.groundDistance[index], 1e-6) ||
+          !simCore::areEqual(simCore::calculateRangeRate(f.lla, f.ori, t.lla, t.ori, model, &flatEarthConv, f.vel, t.vel), results.rangeRate[index], 1e-6) ||
+          !simCore::areEqual(simCore::calculateClosingVelocity(f.lla, t.lla, model, &flatEarthConv, f.vel, t.vel), results.closingVelocity[index], 1e-6))
+          ++failures;
+      }
+    }
+    rv += SDK_ASSERT(failures == 0);
+  }
+
+  // Only requested values are calculated
+  simCore::RelativeGeometryBatch::Results results;
+  rv += SDK_ASSERT(multiThread.calculate(from, to, simCore::RelativeGeometryBatch::SLANT_RANGE, simCore::PERFECT_SPHERE, nullptr, results) == 0);
+  rv += SDK_ASSERT(results.relAzimuth.empty() && results.closingVelocity.empty());
+  rv += SDK_ASSERT(simCore::areEqual(results.slantRange[results.index(3, 4)], simCore::calculateSlant(from[3].lla, to[4].lla, simCore::PERFECT_SPHERE, nullptr), 1e-6));
+  // Unsupported values are zero, with an error return
+  rv += SDK_ASSERT(multiThread.calculate(from, to, simCore::RelativeGeometryBatch::SLANT_RANGE | simCore::RelativeGeometryBatch::REL_AZIMUTH, simCore::PERFECT_SPHERE, nullptr, results) != 0);
+  rv += SDK_ASSERT(results.relAzimuth.size() == from.size() * to.size() && results.relAzimuth[5] == 0.);
+  rv += SDK_ASSERT(results.slantRange[5] > 0.);
+  // Flat earth without a converter supports only the rates
+  rv += SDK_ASSERT(multiThread.calculate(from, to, simCore::RelativeGeometryBatch::CLOSING_VELOCITY, simCore::FLAT_EARTH, nullptr, results) == 0);
+  rv += SDK_ASSERT(multiThread.calculate(from, to, simCore::RelativeGeometryBatch::SLANT_RANGE, simCore::FLAT_EARTH, nullptr, results) != 0);
+  // Empty inputs
+  rv += SDK_ASSERT(multiThread.calculate(std::vector<simCore::RelativeGeometryState>(), to, simCore::RelativeGeometryBatch::ALL_OUTPUTS, simCore::WGS_84, nullptr, results) == 0);
+  rv += SDK_ASSERT(results.numFrom == 0 && results.slantRange.empty());
+
+  // Report throughput against the pairwise functions
+  const std::vector<simCore::RelativeGeometryState> many = createRelativeGeometryStates(300, 1.7);
+  const unsigned int outputs = simCore::RelativeGeometryBatch::REL_AZIMUTH | simCore::RelativeGeometryBatch::SLANT_RANGE | simCore::RelativeGeometryBatch::CLOSING_VELOCITY;
+  double startTime = simCore::getSystemTime();
+  double sum = 0.;
+  for (size_t i = 0; i < many.size(); ++i)
+  {
+    for (size_t j = 0; j < many.size(); ++j)
+    {
+      double az = 0.;
+      simCore::calculateRelAzEl(many[i].lla, many[i].ori, many[j].lla, &az, nullptr, nullptr, simCore::TANGENT_PLANE_WGS_84, nullptr);
+      sum += az + simCore::calculateSlant(many[i].lla, many[j].lla, simCore::TANGENT_PLANE_WGS_84, nullptr);
+      if (i != j)
+        sum += simCore::calculateClosingVelocity(many[i].lla, many[j].lla, simCore::TANGENT_PLANE_WGS_84, nullptr, many[i].vel, many[j].vel);
+    }
+  }
+  const double pairwiseTime = simCore::getSystemTime() - startTime;
+  startTime = simCore::getSystemTime();
+  simCore::RelativeGeometryBatch defaultThreads;
+  rv += SDK_ASSERT(defaultThreads.calculate(many, many, outputs, simCore::TANGENT_PLANE_WGS_84, nullptr, results) == 0);
+  const double batchTime = simCore::getSystemTime() - startTime;
+  rv += SDK_ASSERT(sum != 0.);
+  std::cout << "RelativeGeometryBatch " << many.size() << "x" << many.size() << ": pairwise " << pairwiseTime << " s, batch "
+    << batchTime << " s with " << defaultThreads.numThreads() << " threads" << std::endl;
+  return rv;
+}
+
+/** Straightforward recursive Douglas-Peucker, as a reference for the importance-based implementation */
+void referenceDouglasPeucker(const simCore::Vec3String& points, size_t first, size_t last, double tolerance, std::vector<bool>& keep)
+{
+  if (last <= first + 1)
+    return;
+  size_t farthest = first;
+  double maxDistance = -1.0;
+  for (size_t k = first + 1; k < last; ++k)
+  {
+    simCore::Vec3String threePoints;
+    threePoints.push_back(points[first]);
+    threePoints.push_back(points[k]);
+    threePoints.push_back(points[last]);
+    // the middle vertex importance is its distance to the segment (first, last)
+    std::vector<double> importance;
+    simCore::douglasPeuckerImportance(threePoints, importance);
+    if (importance[1] > maxDistance)
+    {
+      maxDistance = importance[1];
+      farthest = k;
+    }
+  }
+  if (maxDistance <= tolerance)
+    return;
+  keep[farthest] = true;
+  referenceDouglasPeucker(points, first, farthest, tolerance, keep);
+  referenceDouglasPeucker(points, farthest, last, tolerance, keep);
+}
+
+/** Returns the largest distance from a dropped vertex to the simplified polyline */
+double maxDecimationError(const simCore::Vec3String& points, const std::vector<size_t>& indices)
+{
+  double maxError = 0.0;
+  for (size_t k = 0; k + 1 < indices.size(); ++k)
+  {
+    const simCore::Vec3& a = points[indices[k]];
+    const simCore::Vec3& b = points[indices[k + 1]];
+    for (size_t i = indices[k] + 1; i < indices[k + 1]; ++i)
+    {
+      simCore::Vec3String threePoints;
+      threePoints.push_back(a);
+      threePoints.push_back(points[i]);
+      threePoints.push_back(b);
+      std::vector<double> importance;
+      simCore::douglasPeuckerImportance(threePoints, importance);
+      maxError = simCore::sdkMax(maxError, importance[1]);
+    }
+  }
+  return maxError;
+}
+
+int testDouglasPeucker()
+{
+  int rv = 0;
+
+  // Degenerate polylines keep all of their vertices
+  std::vector<size_t> indices;
+  simCore::Vec3String points;
+  simCore::douglasPeucker(points, 1.0, indices);
+  rv += SDK_ASSERT(indices.empty());
+  points.push_back(simCore::Vec3(1.0, 2.0, 3.0));
+  simCore::douglasPeucker(points, 1.0, indices);
+  rv += SDK_ASSERT(indices.size() == 1 && indices[0] == 0);
+  points.push_back(simCore::Vec3(1.0, 2.0, 3.0));
+  simCore::douglasPeucker(points, 1.0, indices);
+  rv += SDK_ASSERT(indices.size() == 2 && indices[1] == 1);
+
+  // Distance is to the segment, not the infinite line; a track that doubles back keeps its turn
+  points.clear();
+  points.push_back(simCore::Vec3(0.0, 0.0, 0.0));
+  points.push_back(simCore::Vec3(100.0, 0.0, 0.0));
+  points.push_back(simCore::Vec3(50.0, 0.0, 0.0));
+  simCore::douglasPeucker(points, 1.0, indices);
+  rv += SDK_ASSERT(indices.size() == 3);
+
+  // Square track, 25000 points per leg, with a 0.5 m wobble; simplifying at 1 m should keep only the corners
+  const size_t POINTS_PER_LEG = 25000;
+  const double LEG_LENGTH = 50000.0;
+  const double WOBBLE = 0.5;
+  points.clear();
+  for (size_t leg = 0; leg < 4; ++leg)
+  {
+    for (size_t k = 0; k < POINTS_PER_LEG; ++k)
+    {
+      const double along = LEG_LENGTH * k / POINTS_PER_LEG;
+      const double across = WOBBLE * sin(k * 0.1);
+      switch (leg)
+      {
+      case 0: points.push_back(simCore::Vec3(along, across, 100.0)); break;
+      case 1: points.push_back(simCore::Vec3(LEG_LENGTH + across, along, 100.0)); break;
+      case 2: points.push_back(simCore::Vec3(LEG_LENGTH - along, LEG_LENGTH + across, 100.0)); break;
+      default: points.push_back(simCore::Vec3(across, LEG_LENGTH - along, 100.0)); break;
+      }
+    }
+  }
+  points.push_back(points.front());
+
+  std::vector<double> importance;
+  simCore::douglasPeuckerImportance(points, importance);
+  rv += SDK_ASSERT(importance.size() == points.size());
+
+  const double tolerances[] = { 0.01, 0.25, 1.0, 100.0 };
+  for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); ++t)
+  {
+    const double tolerance = tolerances[t];
+    simCore::douglasPeuckerSelect(importance, tolerance, indices);
+    rv += SDK_ASSERT(indices.front() == 0 && indices.back() == points.size() - 1);
+    rv += SDK_ASSERT(maxDecimationError(points, indices) <= tolerance);
+    if (tolerance >= WOBBLE * 2)
+    {
+      // endpoints plus the three corners in between, and maybe a vertex near each corner
+      rv += SDK_ASSERT(indices.size() >= 5 && indices.size() <= 13);
+      for (size_t leg = 1; leg < 4; ++leg)
+        rv += SDK_ASSERT(std::find(indices.begin(), indices.end(), leg * POINTS_PER_LEG) != indices.end());
+    }
+    else if (tolerance > 0.1)
+      rv += SDK_ASSERT(indices.size() < points.size() / 4);
+    std::cout << "Douglas-Peucker at " << tolerance << " m: " << points.size() << " points reduced to " << indices.size() << std::endl;
+  }
+
+  // Thresholding importance matches running Douglas-Peucker at each tolerance
+  simCore::Vec3String zigzag;
+  for (size_t k = 0; k < 400; ++k)
+    zigzag.push_back(simCore::Vec3(k * 10.0, 20.0 * sin(k * 0.37) + 3.0 * sin(k * 2.9), 5.0 * cos(k * 0.11)));
+  for (double tolerance = 0.5; tolerance < 40.0; tolerance *= 2.0)
+  {
+    std::vector<bool> keep(zigzag.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    referenceDouglasPeucker(zigzag, 0, zigzag.size() - 1, tolerance, keep);
+    std::vector<size_t> expected;
+    for (size_t k = 0; k < keep.size(); ++k)
+    {
+      if (keep[k])
+        expected.push_back(k);
+    }
+    simCore::douglasPeucker(zigzag, tolerance, indices);
+    rv += SDK_ASSERT(indices == expected);
+  }
+
+  return rv;
+}
+
 }
 
 int CalculationTest(int argc, char* argv[])
@@ -1852,5 +2240,8 @@ int CalculationTest(int argc, char* argv[])
   rv += testAoaSideslipTotalAoa();
   rv += testBoresightAlphaBeta();
   rv += testTangentPlane2Sphere();
+  rv += testLocalFrame();
+  rv += testRelativeGeometryBatch();
+  rv += testDouglasPeucker();
   return rv;
 }
@@ -20,6 +20,8 @@
  * disclose, or release this software.
  *
  */
+#include <cstdio>
+#include <fstream>
 #include <vector>
 #include <string>
 #include <iomanip>
@@ -32,6 +34,8 @@
 #include "simCore/Calc/Vec3.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Math.h"
+#include "simCore/String/UtfUtils.h"
+#include "simCore/Time/Utils.h"
 
 namespace
 {
@@ -1116,6 +1120,284 @@ int testStringFunctions()
   return rv;
 }
 
+
+//===========================================================================
+/** Structure of arrays used to feed the batch conversions */
+struct Vec3Columns
+{
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+
+  explicit Vec3Columns(size_t count = 0)
+    : x(count), y(count), z(count)
+  {
+  }
+
+  void set(size_t index, const simCore::Vec3& vec)
+  {
+    x[index] = vec.x();
+    y[index] = vec.y();
+    z[index] = vec.z();
+  }
+
+  simCore::Vec3 get(size_t index) const
+  {
+    return simCore::Vec3(x[index], y[index], z[index]);
+  }
+
+  simCore::Vec3Arrays arrays()
+  {
+    return simCore::Vec3Arrays(&x[0], &y[0], &z[0]);
+  }
+
+  simCore::ConstVec3Arrays constArrays() const
+  {
+    return simCore::ConstVec3Arrays(&x[0], &y[0], &z[0]);
+  }
+};
+
+/** Returns true if the two vectors are equal within the relative epsilon */
+bool batchEqual(const simCore::Vec3& batch, const simCore::Vec3& single, double epsilon)
+{
+  for (size_t k = 0; k < 3; ++k)
+  {
+    const double scale = simCore::sdkMax(1.0, fabs(single[k]));
+    if (fabs(batch[k] - single[k]) > epsilon * scale)
+      return false;
+  }
+  return true;
+}
+
+/** Returns true if the two sets of Euler angles are equal within the epsilon */
+bool batchAnglesEqual(const simCore::Vec3& batch, const simCore::Vec3& single, double epsilon)
+{
+  return simCore::areAnglesEqual(batch.x(), single.x(), epsilon) &&
+    simCore::areAnglesEqual(batch.y(), single.y(), epsilon) &&
+    simCore::areAnglesEqual(batch.z(), single.z(), epsilon);
+}
+
+/** Fills the columns with a grid of geodetic states, including the poles, the antimeridian and points below the surface */
+void createBatchGeodeticData(size_t count, Vec3Columns& llaPos, Vec3Columns& llaVel, Vec3Columns& llaOri, std::vector<double>& eciTimes)
+{
+  static const double ALTITUDES[] = { -simCore::WGS_B, -6.3e6, -40000., -1., 0., 100., 12000., 4.2e7 };
+  static const size_t NUM_ALTITUDES = sizeof(ALTITUDES) / sizeof(ALTITUDES[0]);
+  llaPos = Vec3Columns(count);
+  llaVel = Vec3Columns(count);
+  llaOri = Vec3Columns(count);
+  eciTimes.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    // Latitude sweeps pole to pole, longitude wraps past +/-180
+    const double lat = -M_PI_2 + M_PI * static_cast<double>(i % 181) / 180.;
+    const double lon = -M_PI + 2. * M_PI * static_cast<double>((i * 7) % 361) / 360.;
+    llaPos.set(i, simCore::Vec3(lat, lon, ALTITUDES[i % NUM_ALTITUDES]));
+    llaVel.set(i, simCore::Vec3(120. * sin(0.1 * i), -75. + (i % 150), 3. * cos(0.3 * i)));
+    llaOri.set(i, simCore::Vec3(simCore::angFixPI(0.37 * i), simCore::angFixPI(0.11 * i) * 0.5, simCore::angFixPI(0.53 * i)));
+    eciTimes[i] = 17.5 * static_cast<double>(i % 5000);
+  }
+}
+
+/** Compares the batch conversions against the single point Coordinate conversions */
+int testBatchParity()
+{
+  int rv = 0;
+  const size_t count = 5000;
+  Vec3Columns llaPos;
+  Vec3Columns llaVel;
+  Vec3Columns llaOri;
+  std::vector<double> eciTimes;
+  createBatchGeodeticData(count, llaPos, llaVel, llaOri, eciTimes);
+
+  static const simCore::LocalLevelFrame FRAMES[] = { simCore::LOCAL_LEVEL_FRAME_NED, simCore::LOCAL_LEVEL_FRAME_ENU };
+  for (size_t f = 0; f < 2; ++f)
+  {
+    const simCore::LocalLevelFrame frame = FRAMES[f];
+    Vec3Columns ecefPos(count);
+    Vec3Columns ecefVel(count);
+    Vec3Columns ecefOri(count);
+    simCore::CoordinateConverter::convertGeodeticPosToEcef(count, llaPos.constArrays(), ecefPos.arrays());
+    simCore::CoordinateConverter::convertGeodeticVelToEcef(count, llaPos.constArrays(), llaVel.constArrays(), ecefVel.arrays());
+    simCore::CoordinateConverter::convertGeodeticOriToEcef(count, llaPos.constArrays(), llaOri.constArrays(), ecefOri.arrays(), frame);
+
+    Vec3Columns backPos(count);
+    Vec3Columns backVel(count);
+    Vec3Columns backOri(count);
+    rv += SDK_ASSERT(simCore::CoordinateConverter::convertEcefToGeodeticPos(count, ecefPos.constArrays(), backPos.arrays()) == 0);
+    simCore::CoordinateConverter::convertEcefToGeodeticVel(count, backPos.constArrays(), ecefVel.constArrays(), backVel.arrays());
+    simCore::CoordinateConverter::convertEcefToGeodeticOri(count, backPos.constArrays(), ecefOri.constArrays(), backOri.arrays(), frame);
+
+    int failures = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Single point path through Coordinate
+      const simCore::Coordinate lla(simCore::COORD_SYS_LLA, llaPos.get(i), llaOri.get(i), llaVel.get(i));
+      simCore::Coordinate ecef;
+      simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef, frame);
+      if (!batchEqual(ecefPos.get(i), ecef.position(), 1e-12) ||
+        !batchEqual(ecefVel.get(i), ecef.velocity(), 1e-12) ||
+        !batchAnglesEqual(ecefOri.get(i), ecef.orientation(), 1e-9))
+        ++failures;
+
+      simCore::Coordinate llaBack;
+      simCore::CoordinateConverter::convertEcefToGeodetic(simCore::Coordinate(simCore::COORD_SYS_ECEF, ecefPos.get(i), ecefOri.get(i), ecefVel.get(i)), llaBack, frame);
+      if (!batchEqual(backPos.get(i), llaBack.position(), 1e-12) ||
+        !batchEqual(backVel.get(i), llaBack.velocity(), 1e-12) ||
+        !batchAnglesEqual(backOri.get(i), llaBack.orientation(), 1e-9))
+        ++failures;
+      // Velocity survives the round trip; positions deep inside the earth lose precision, so skip those
+      if (llaPos.z[i] > -40000. && !batchEqual(backVel.get(i), llaVel.get(i), 1e-6))
+        ++failures;
+    }
+    rv += SDK_ASSERT(failures == 0);
+  }
+
+  // ECI to ECEF, using the ECEF states above as ECI states
+  Vec3Columns eciPos(count);
+  Vec3Columns eciVel(count);
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(count, llaPos.constArrays(), eciPos.arrays());
+  simCore::CoordinateConverter::convertGeodeticVelToEcef(count, llaPos.constArrays(), llaVel.constArrays(), eciVel.arrays());
+  Vec3Columns ecefPos(count);
+  Vec3Columns ecefVel(count);
+  Vec3Columns ecefOri(count);
+  simCore::CoordinateConverter::convertEciToEcefPos(count, &eciTimes[0], eciPos.constArrays(), ecefPos.arrays());
+  simCore::CoordinateConverter::convertEciToEcefVel(count, &eciTimes[0], eciPos.constArrays(), eciVel.constArrays(), ecefVel.arrays());
+  simCore::CoordinateConverter::convertEciToEcefOri(count, &eciTimes[0], llaOri.constArrays(), ecefOri.arrays());
+  int failures = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const simCore::Coordinate eci(simCore::COORD_SYS_ECI, eciPos.get(i), llaOri.get(i), eciVel.get(i), eciTimes[i]);
+    simCore::Coordinate ecef;
+    simCore::CoordinateConverter::convertEciToEcef(eci, ecef);
+    if (!batchEqual(ecefPos.get(i), ecef.position(), 1e-12) ||
+      !batchEqual(ecefVel.get(i), ecef.velocity(), 1e-12) ||
+      !batchAnglesEqual(ecefOri.get(i), ecef.orientation(), 1e-9))
+      ++failures;
+  }
+  rv += SDK_ASSERT(failures == 0);
+
+  // In place conversion gives the same answer
+  Vec3Columns inPlace = eciPos;
+  simCore::CoordinateConverter::convertEciToEcefPos(count, &eciTimes[0], inPlace.constArrays(), inPlace.arrays());
+  rv += SDK_ASSERT(inPlace.x == ecefPos.x && inPlace.y == ecefPos.y && inPlace.z == ecefPos.z);
+
+  // Zero count touches nothing
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(0, simCore::ConstVec3Arrays(nullptr, nullptr, nullptr), simCore::Vec3Arrays(nullptr, nullptr, nullptr));
+  rv += SDK_ASSERT(simCore::CoordinateConverter::convertEcefToGeodeticPos(0, simCore::ConstVec3Arrays(nullptr, nullptr, nullptr), simCore::Vec3Arrays(nullptr, nullptr, nullptr)) == 0);
+
+  std::cout << std::endl << "Batch parity test case: ";
+  std::cout << (rv == 0 ? "PASSED" : "FAILED") << std::endl;
+  return rv;
+}
+
+/** Loads a comma separated gold data file of 3 values per line */
+int loadBatchGoldData(const std::string& fileName, Vec3Columns& data)
+{
+  std::ifstream inFile(simCore::streamFixUtf8(fileName));
+  if (!inFile)
+    return 1;
+  data = Vec3Columns();
+  std::string line;
+  while (std::getline(inFile, line))
+  {
+    double a = 0.;
+    double b = 0.;
+    double c = 0.;
+    if (sscanf(line.c_str(), "%lf, %lf, %lf", &a, &b, &c) != 3)
+      continue;
+    data.x.push_back(a);
+    data.y.push_back(b);
+    data.z.push_back(c);
+  }
+  return data.x.empty() ? 1 : 0;
+}
+
+/** Runs the batch position conversions against the NGA gold data used by GoldDataCoordConvertTest */
+int testBatchGoldData(const std::string& dataDir)
+{
+  Vec3Columns lla;
+  Vec3Columns ecef;
+  if (loadBatchGoldData(dataDir + "/geodetic.dat", lla) != 0 || loadBatchGoldData(dataDir + "/geocentric.dat", ecef) != 0)
+  {
+    std::cout << "Unable to load gold data from " << dataDir << std::endl;
+    return 1;
+  }
+
+  int rv = 0;
+  rv += SDK_ASSERT(lla.x.size() == ecef.x.size());
+  const size_t count = simCore::sdkMin(lla.x.size(), ecef.x.size());
+  for (size_t i = 0; i < count; ++i)
+  {
+    lla.x[i] *= simCore::DEG2RAD;
+    lla.y[i] *= simCore::DEG2RAD;
+  }
+
+  // Same tolerances as GoldDataCoordConvertTest
+  const double angleEpsilon = 1.57e-7;
+  const double distanceEpsilon = 0.9;
+  Vec3Columns ecefOut(count);
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(count, lla.constArrays(), ecefOut.arrays());
+  Vec3Columns llaOut(count);
+  rv += SDK_ASSERT(simCore::CoordinateConverter::convertEcefToGeodeticPos(count, ecef.constArrays(), llaOut.arrays()) == 0);
+  int failures = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!simCore::v3AreEqual(ecefOut.get(i), ecef.get(i), distanceEpsilon))
+      ++failures;
+    // Longitude is meaningless at the poles
+    const bool atPole = simCore::areEqual(fabs(lla.x[i]), M_PI_2, angleEpsilon);
+    if (!simCore::areEqual(llaOut.x[i], lla.x[i], angleEpsilon) ||
+      (!atPole && !simCore::areAnglesEqual(llaOut.y[i], lla.y[i], angleEpsilon)) ||
+      !simCore::areEqual(llaOut.z[i], lla.z[i], distanceEpsilon))
+      ++failures;
+  }
+  rv += SDK_ASSERT(failures == 0);
+
+  std::cout << std::endl << "Batch gold data test case (" << count << " points): ";
+  std::cout << (rv == 0 ? "PASSED" : "FAILED") << std::endl;
+  return rv;
+}
+
+/** Reports the throughput of the batch conversions against the single point conversions */
+int testBatchThroughput()
+{
+  int rv = 0;
+  const size_t count = 200000;
+  Vec3Columns llaPos;
+  Vec3Columns llaVel;
+  Vec3Columns llaOri;
+  std::vector<double> eciTimes;
+  createBatchGeodeticData(count, llaPos, llaVel, llaOri, eciTimes);
+
+  // Single point conversions through Coordinate
+  double checksum = 0.;
+  double startTime = simCore::getSystemTime();
+  for (size_t i = 0; i < count; ++i)
+  {
+    simCore::Coordinate ecef;
+    simCore::CoordinateConverter::convertGeodeticToEcef(simCore::Coordinate(simCore::COORD_SYS_LLA, llaPos.get(i)), ecef);
+    simCore::Coordinate lla;
+    simCore::CoordinateConverter::convertEcefToGeodetic(ecef, lla);
+    checksum += lla.lat();
+  }
+  const double singleTime = simCore::getSystemTime() - startTime;
+
+  Vec3Columns ecefPos(count);
+  Vec3Columns backPos(count);
+  startTime = simCore::getSystemTime();
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(count, llaPos.constArrays(), ecefPos.arrays());
+  rv += SDK_ASSERT(simCore::CoordinateConverter::convertEcefToGeodeticPos(count, ecefPos.constArrays(), backPos.arrays()) == 0);
+  const double batchTime = simCore::getSystemTime() - startTime;
+  double batchChecksum = 0.;
+  for (size_t i = 0; i < count; ++i)
+    batchChecksum += backPos.x[i];
+  rv += SDK_ASSERT(simCore::areEqual(checksum, batchChecksum, 1e-9 * count));
+
+  std::cout << std::endl << "Batch throughput, " << count << " LLA->ECEF->LLA positions: single " << singleTime
+    << " s, batch " << batchTime << " s" << std::endl;
+  return rv;
+}
+
 }
 
 //===========================================================================
@@ -1186,5 +1468,10 @@ int CoordConvertLibTest(int _argc_, char *_argv_[])
   rv += testScaledFlatEarthPole();
   rv += testScaledFlatEarth();
   rv += testStringFunctions();
+  rv += testBatchParity();
+  rv += testBatchThroughput();
+  // Gold data directory is optional
+  if (_argc_ > 1)
+    rv += testBatchGoldData(_argv_[1]);
   return rv;
 }
@@ -20,11 +20,25 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include "simCore/Common/Version.h"
 #include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/MappedFile.h"
+#include "simCore/Common/MpscQueue.h"
+#include "simCore/Common/ThreadPool.h"
 
 namespace
 {
@@ -98,6 +112,238 @@ int testException()
   return rv;
 }
 
+int testThreadPool()
+{
+  int rv = 0;
+
+  // Zero threads is treated as the calling thread only
+  simCore::ThreadPool single(0);
+  rv += SDK_ASSERT(single.numThreads() == 1);
+  size_t calls = 0;
+  single.parallelFor(100, [&](size_t begin, size_t end) { ++calls; rv += SDK_ASSERT(begin == 0 && end == 100); });
+  rv += SDK_ASSERT(calls == 1);
+
+  simCore::ThreadPool pool(4);
+  rv += SDK_ASSERT(pool.numThreads() == 4);
+  rv += SDK_ASSERT(simCore::ThreadPool::hardwareThreads() >= 1);
+
+  // Every index is visited exactly once, over repeated jobs of varying size
+  for (size_t count = 0; count < 1000; count += 37)
+  {
+    std::vector<int> visits(count, 0);
+    std::atomic<size_t> total(0);
+    pool.parallelFor(count, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k)
+        ++visits[k];
+      total += end - begin;
+    });
+    rv += SDK_ASSERT(total == count);
+    for (size_t k = 0; k < count; ++k)
+      rv += SDK_ASSERT(visits[k] == 1);
+  }
+
+  // Pool can be destroyed without ever running a job
+  {
+    simCore::ThreadPool unused(3);
+  }
+  return rv;
+}
+
+int testThreadPoolSubmit()
+{
+  int rv = 0;
+
+  // Every task runs exactly once, off the calling thread
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int> total(0);
+  std::atomic<int> finished(0);
+  std::atomic<int> onCaller(0);
+  {
+    simCore::ThreadPool pool(4);
+    for (int k = 1; k <= 100; ++k)
+    {
+      pool.submit([&total, &finished, &onCaller, caller, k]() {
+        total += k;
+        if (std::this_thread::get_id() == caller)
+          ++onCaller;
+        ++finished;
+      });
+    }
+
+    // Tasks publish results through a promise while the caller continues
+    std::promise<int> promise;
+    std::future<int> result = promise.get_future();
+    pool.submit([&promise]() { promise.set_value(42); });
+    rv += SDK_ASSERT(result.get() == 42);
+
+    // parallelFor still covers every index while tasks are queued
+    std::vector<int> visits(1000, 0);
+    pool.parallelFor(visits.size(), [&visits](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k)
+        ++visits[k];
+    });
+    rv += SDK_ASSERT(std::count(visits.begin(), visits.end(), 1) == 1000);
+
+    while (finished < 100)
+      std::this_thread::yield();
+  }
+  rv += SDK_ASSERT(total == 5050);
+  rv += SDK_ASSERT(onCaller == 0);
+
+  // A single worker runs tasks in order
+  std::vector<int> order;
+  {
+    simCore::ThreadPool serial(2);
+    std::promise<void> lastDone;
+    for (int k = 0; k < 5; ++k)
+      serial.submit([&order, k]() { order.push_back(k); });
+    serial.submit([&lastDone]() { lastDone.set_value(); });
+    lastDone.get_future().wait();
+  }
+  rv += SDK_ASSERT(order.size() == 5 && order[0] == 0 && order[4] == 4);
+
+  // Destroying the pool discards tasks that have not started, and waits for the running one
+  std::mutex gate;
+  std::vector<int> started;
+  std::unique_ptr<simCore::ThreadPool> blocked(new simCore::ThreadPool(2));
+  std::unique_lock<std::mutex> gateLock(gate);
+  for (int k = 0; k < 5; ++k)
+  {
+    blocked->submit([&gate, &started, k]() {
+      std::lock_guard<std::mutex> lock(gate);
+      started.push_back(k);
+    });
+  }
+  std::thread destroyer([&blocked]() { blocked.reset(); });
+  // give the destructor time to discard the queue while the first task, if started, waits on the gate
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  gateLock.unlock();
+  destroyer.join();
+  rv += SDK_ASSERT(started.size() <= 1);
+  rv += SDK_ASSERT(started.empty() || started[0] == 0);
+
+  // Without workers, tasks run on the caller before submit() returns
+  simCore::ThreadPool single(1);
+  bool ran = false;
+  single.submit([&ran, caller]() { ran = (std::this_thread::get_id() == caller); });
+  rv += SDK_ASSERT(ran);
+  return rv;
+}
+
+int testMpscQueue()
+{
+  int rv = 0;
+
+  // Capacity rounds up to a power of two
+  simCore::MpscQueue<int> small(5);
+  rv += SDK_ASSERT(small.capacity() == 8);
+  rv += SDK_ASSERT(small.size() == 0);
+  int value = -1;
+  rv += SDK_ASSERT(!small.tryPop(value));
+
+  // First in, first out; pushes fail once full, and succeed again after a pop
+  for (int k = 0; k < 8; ++k)
+    rv += SDK_ASSERT(small.tryPush(k));
+  rv += SDK_ASSERT(!small.tryPush(8));
+  rv += SDK_ASSERT(small.size() == 8);
+  rv += SDK_ASSERT(small.tryPop(value) && value == 0);
+  rv += SDK_ASSERT(small.tryPush(8));
+  for (int k = 1; k <= 8; ++k)
+    rv += SDK_ASSERT(small.tryPop(value) && value == k);
+  rv += SDK_ASSERT(!small.tryPop(value));
+  rv += SDK_ASSERT(small.size() == 0);
+
+  // Several producers racing a consumer; every accepted item arrives once, in order per producer
+  const int numProducers = 4;
+  const int perProducer = 20000;
+  simCore::MpscQueue<int> queue(64);
+  std::atomic<int> dropped(0);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < numProducers; ++p)
+  {
+    producers.push_back(std::thread([&queue, &dropped, p, perProducer]() {
+      for (int k = 0; k < perProducer; ++k)
+      {
+        // Retry a few times, then drop, as a producer under back-pressure would
+        int tries = 0;
+        while (!queue.tryPush(p * perProducer + k))
+        {
+          if (++tries == 100)
+          {
+            ++dropped;
+            break;
+          }
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  std::vector<int> lastSeen(numProducers, -1);
+  int received = 0;
+  std::atomic<bool> producing(true);
+  std::thread joiner([&producers, &producing]() {
+    for (size_t k = 0; k < producers.size(); ++k)
+      producers[k].join();
+    producing = false;
+  });
+  while (true)
+  {
+    const bool stillProducing = producing;
+    while (queue.tryPop(value))
+    {
+      const int producer = value / perProducer;
+      const int index = value % perProducer;
+      rv += SDK_ASSERT(producer >= 0 && producer < numProducers);
+      if (producer < 0 || producer >= numProducers)
+        continue;
+      rv += SDK_ASSERT(index > lastSeen[producer]);
+      lastSeen[producer] = index;
+      ++received;
+    }
+    if (!stillProducing)
+      break;
+    std::this_thread::yield();
+  }
+  joiner.join();
+  rv += SDK_ASSERT(received + dropped == numProducers * perProducer);
+  rv += SDK_ASSERT(queue.size() == 0);
+  return rv;
+}
+
+int testMappedFile()
+{
+  int rv = 0;
+  const std::string filename = "CoreCommonTest.mapped";
+  const char contents[] = "mapped file contents";
+  {
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(contents, sizeof(contents));
+  }
+
+  simCore::MappedFile file;
+  rv += SDK_ASSERT(!file.isOpen());
+  rv += SDK_ASSERT(file.data() == nullptr);
+  rv += SDK_ASSERT(file.open(filename) == 0);
+  rv += SDK_ASSERT(file.isOpen());
+  rv += SDK_ASSERT(file.size() == sizeof(contents));
+  if (file.isOpen())
+    rv += SDK_ASSERT(memcmp(file.data(), contents, sizeof(contents)) == 0);
+  file.close();
+  rv += SDK_ASSERT(!file.isOpen());
+  rv += SDK_ASSERT(file.size() == 0);
+
+  // Missing and empty files cannot be mapped
+  rv += SDK_ASSERT(file.open("CoreCommonTest.missing") != 0);
+  {
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  }
+  rv += SDK_ASSERT(file.open(filename) != 0);
+  rv += SDK_ASSERT(!file.isOpen());
+  std::remove(filename.c_str());
+  return rv;
+}
+
 }
 
 int CoreCommonTest(int argc, char* arv[])
@@ -106,5 +352,9 @@ int CoreCommonTest(int argc, char* arv[])
   rv += SDK_ASSERT(testFailure() == 0);
   rv += SDK_ASSERT(testVersion() == 0);
   rv += SDK_ASSERT(testException() == 0);
+  rv += SDK_ASSERT(testThreadPool() == 0);
+  rv += SDK_ASSERT(testThreadPoolSubmit() == 0);
+  rv += SDK_ASSERT(testMpscQueue() == 0);
+  rv += SDK_ASSERT(testMappedFile() == 0);
   return rv;
 }
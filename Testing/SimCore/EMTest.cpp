@@ -21,11 +21,16 @@
  *
  */
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Math.h"
 #include "simCore/Common/SDKAssert.h"
+#include "simCore/EM/AntennaGainCache.h"
 #include "simCore/EM/AntennaPattern.h"
 #include "simCore/EM/Propagation.h"
 #include "simCore/EM/RadarCrossSection.h"
+#include "simCore/Time/Utils.h"
 
 #define EXAMPLE_RCS_FILE                  "fake_rcs_3.rcs"
 
@@ -677,6 +682,227 @@ int antennaPatternTest(int argc, char* argv[])
   return rv;
 }
 
+/** Fills a table pattern with smooth azimuth and elevation gains, sampled every 0.1 degrees */
+void fillTablePattern(simCore::AntennaPatternTable& table)
+{
+  for (int k = -1800; k <= 1800; ++k)
+  {
+    const double azim = k * 0.1 * simCore::DEG2RAD;
+    table.setAzimData(static_cast<float>(azim), static_cast<float>(-20.0 * (1.0 - cos(azim))));
+  }
+  for (int k = -900; k <= 900; ++k)
+  {
+    const double elev = k * 0.1 * simCore::DEG2RAD;
+    table.setElevData(static_cast<float>(elev), static_cast<float>(-15.0 * (1.0 - cos(2.0 * elev))));
+  }
+  table.setValid(true);
+}
+
+int testAntennaGainCache()
+{
+  int rv = 0;
+
+  simCore::AntennaGainParameters params;
+  params.hbw_ = static_cast<float>(10.0 * simCore::DEG2RAD);
+  params.vbw_ = static_cast<float>(20.0 * simCore::DEG2RAD);
+  params.refGain_ = 30.f;
+  params.freq_ = 3e+9;
+
+  rv += SDK_ASSERT(simCore::AntennaGainCache::isBaked(simCore::ANTENNA_PATTERN_TABLE));
+  rv += SDK_ASSERT(simCore::AntennaGainCache::isBaked(simCore::ANTENNA_PATTERN_BILINEAR));
+  rv += SDK_ASSERT(!simCore::AntennaGainCache::isBaked(simCore::ANTENNA_PATTERN_GAUSS));
+  rv += SDK_ASSERT(!simCore::AntennaGainCache::isBaked(simCore::ANTENNA_PATTERN_OMNI));
+
+  simCore::AntennaPatternTable table;
+  fillTablePattern(table);
+  simCore::AntennaGainCache cache(&table, 0.25 * simCore::DEG2RAD, 0.25 * simCore::DEG2RAD, 2);
+  rv += SDK_ASSERT(cache.pattern() == &table);
+  rv += SDK_ASSERT(cache.azStep() <= 0.25 * simCore::DEG2RAD);
+  rv += SDK_ASSERT(cache.elStep() <= 0.25 * simCore::DEG2RAD);
+  rv += SDK_ASSERT(cache.numTables() == 0);
+
+  // Grid points reproduce the pattern
+  params.azim_ = 0.f;
+  params.elev_ = 0.f;
+  rv += SDK_ASSERT(simCore::areEqual(cache.gain(params), table.gain(params), 1e-4));
+  rv += SDK_ASSERT(cache.numTables() == 1);
+
+  // Values between grid points stay within the error bound, in and out of the main beam
+  const float bound = cache.errorBound(params);
+  rv += SDK_ASSERT(bound >= 0.f && bound < 1.f);
+  float maxError = 0.f;
+  for (int az = -180; az <= 180; az += 7)
+  {
+    for (int el = -90; el <= 90; el += 3)
+    {
+      params.azim_ = static_cast<float>((az + 0.37) * simCore::DEG2RAD);
+      params.elev_ = static_cast<float>((el + 0.11) * simCore::DEG2RAD);
+      maxError = simCore::sdkMax(maxError, static_cast<float>(fabs(cache.gain(params) - table.gain(params))));
+    }
+  }
+  rv += SDK_ASSERT(maxError <= bound + 1e-3f);
+
+  // Azimuth wraps and elevation clamps
+  params.azim_ = static_cast<float>(0.1 + M_TWOPI);
+  params.elev_ = 0.f;
+  const float wrapped = cache.gain(params);
+  params.azim_ = 0.1f;
+  rv += SDK_ASSERT(simCore::areEqual(wrapped, cache.gain(params), 1e-4));
+  params.elev_ = 2.f;
+  const float clamped = cache.gain(params);
+  params.elev_ = static_cast<float>(M_PI_2);
+  rv += SDK_ASSERT(simCore::areEqual(clamped, cache.gain(params), 1e-4));
+
+  // Batch matches individual queries
+  const size_t count = 100000;
+  std::vector<float> azim(count);
+  std::vector<float> elev(count);
+  std::vector<float> gains(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    azim[k] = static_cast<float>(-M_PI + M_TWOPI * k / count);
+    elev[k] = static_cast<float>(-M_PI_2 + M_PI * ((k * 37) % count) / count);
+  }
+  cache.gain(params, count, &azim[0], &elev[0], &gains[0]);
+  for (size_t k = 0; k < count; k += 997)
+  {
+    params.azim_ = azim[k];
+    params.elev_ = elev[k];
+    rv += SDK_ASSERT(cache.gain(params) == gains[k]);
+  }
+
+  // Each reference gain gets its own grid, and the least recently used grid is discarded
+  params.azim_ = 0.f;
+  params.elev_ = static_cast<float>(3.0 * simCore::DEG2RAD);
+  const float highGain = cache.gain(params);
+  params.refGain_ = 20.f;
+  rv += SDK_ASSERT(simCore::areEqual(cache.gain(params), highGain - 10.f, 1e-3));
+  rv += SDK_ASSERT(cache.numTables() == 2);
+  params.refGain_ = 10.f;
+  cache.gain(params);
+  rv += SDK_ASSERT(cache.numTables() == 2);
+  cache.clear();
+  rv += SDK_ASSERT(cache.numTables() == 0);
+
+  // Analytic patterns are evaluated directly
+  simCore::AntennaPatternGauss gauss;
+  simCore::AntennaGainCache gaussCache(&gauss, 0.25 * simCore::DEG2RAD, 0.25 * simCore::DEG2RAD);
+  params.azim_ = 0.123f;
+  params.elev_ = 0.045f;
+  rv += SDK_ASSERT(gaussCache.gain(params) == gauss.gain(params));
+  gaussCache.gain(params, count, &azim[0], &elev[0], &gains[0]);
+  params.azim_ = azim[count / 3];
+  params.elev_ = elev[count / 3];
+  rv += SDK_ASSERT(gains[count / 3] == gauss.gain(params));
+  rv += SDK_ASSERT(gaussCache.numTables() == 0);
+  rv += SDK_ASSERT(gaussCache.errorBound(params) == 0.f);
+
+  // Compare throughput against the table pattern itself, once the grid is baked
+  cache.gain(params);
+  const double startDirect = simCore::getSystemTime();
+  float directSum = 0.f;
+  for (size_t k = 0; k < count; ++k)
+  {
+    params.azim_ = azim[k];
+    params.elev_ = elev[k];
+    directSum += table.gain(params);
+  }
+  const double startCached = simCore::getSystemTime();
+  cache.gain(params, count, &azim[0], &elev[0], &gains[0]);
+  const double endCached = simCore::getSystemTime();
+  std::cout << "AntennaGainCache: " << count << " table pattern gains, direct " << (startCached - startDirect)
+    << " s, cached batch " << (endCached - startCached) << " s" << std::endl;
+  rv += SDK_ASSERT(directSum != 0.f);
+
+  return rv;
+}
+
+/** Writes a synthetic RCS LUT with horizontal and vertical tables at several frequencies and elevations */
+std::string createRcsLut(int tableType)
+{
+  const float freqs[] = { 1000.f, 3000.f, 9000.f };
+  std::ostringstream os;
+  os << "0\nSynthetic RCS\n" << tableType << "\n0\n1\n" << 2 * 3 * 7 << "\n";
+  for (int pol = simCore::POLARITY_HORIZONTAL; pol <= simCore::POLARITY_VERTICAL; ++pol)
+  {
+    for (size_t freq = 0; freq < 3; ++freq)
+    {
+      for (int elev = -30; elev <= 30; elev += 10)
+      {
+        os << freqs[freq] << "\n" << elev << "\n" << pol << "\n360\n0 1\n";
+        for (int azim = 0; azim < 360; ++azim)
+          os << azim << " " << (10. * sin(azim * simCore::DEG2RAD * (freq + 1)) + 0.1 * elev + pol) << "\n";
+      }
+    }
+  }
+  return os.str();
+}
+
+int testRcsBatch()
+{
+  int rv = 0;
+
+  const size_t count = 100000;
+  const float freqs[] = { 900.f, 1000.f, 2000.f, 2500.f, 4000.f, 10000.f };
+  const simCore::PolarityType pols[] = { simCore::POLARITY_UNKNOWN, simCore::POLARITY_HORIZONTAL, simCore::POLARITY_VERTICAL, simCore::POLARITY_CIRCULAR };
+  std::vector<float> freq(count);
+  std::vector<double> azim(count);
+  std::vector<double> elev(count);
+  std::vector<simCore::PolarityType> pol(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    freq[k] = freqs[(k / 1000) % 6];
+    azim[k] = (k * 0.37) * simCore::DEG2RAD - M_PI;
+    elev[k] = (((k * 13) % 900) * 0.1 - 45.) * simCore::DEG2RAD;
+    pol[k] = pols[(k / 6000) % 4];
+  }
+  // Include exact table angles
+  azim[1] = 0.;
+  elev[1] = 10. * simCore::DEG2RAD;
+
+  for (int tableType = simCore::RCS_LUT_TYPE; tableType <= simCore::RCS_SYM_LUT_TYPE; ++tableType)
+  {
+    simCore::RCSLUT rcs;
+    std::istringstream is(createRcsLut(tableType));
+    rv += SDK_ASSERT(rcs.loadRCSFile(is) == 0);
+
+    // Batch must match single look ups exactly
+    std::vector<float> batchSm(count);
+    std::vector<float> batchDb(count);
+    rcs.RCSsm(count, &freq[0], &azim[0], &elev[0], &pol[0], &batchSm[0]);
+    rcs.RCSdB(count, &freq[0], &azim[0], &elev[0], &pol[0], &batchDb[0]);
+    int mismatches = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (rcs.RCSsm(freq[k], azim[k], elev[k], pol[k]) != batchSm[k] || rcs.RCSdB(freq[k], azim[k], elev[k], pol[k]) != batchDb[k])
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+    // Missing polarity
+    rv += SDK_ASSERT(batchDb[18000] == simCore::SMALL_DB_VAL);
+
+    // Micro-benchmark of single versus batch look ups
+    float sum = 0.f;
+    const double startSingle = simCore::getSystemTime();
+    for (size_t k = 0; k < count; ++k)
+      sum += rcs.RCSdB(freq[k], azim[k], elev[k], pol[k]);
+    const double startBatch = simCore::getSystemTime();
+    rcs.RCSdB(count, &freq[0], &azim[0], &elev[0], &pol[0], &batchDb[0]);
+    const double endBatch = simCore::getSystemTime();
+    std::cout << "RCS table type " << tableType << ": " << count << " look ups, single " << (startBatch - startSingle)
+      << " s, batch " << (endBatch - startBatch) << " s" << std::endl;
+    rv += SDK_ASSERT(sum != 0.f);
+  }
+
+  // Empty table
+  simCore::RCSLUT empty;
+  float emptyRcs = 0.f;
+  empty.RCSsm(1, &freq[0], &azim[0], &elev[0], &pol[0], &emptyRcs);
+  rv += SDK_ASSERT(emptyRcs == empty.RCSsm(freq[0], azim[0], elev[0], pol[0]));
+
+  return rv;
+}
+
 }
 
 int EMTest(int argc, char* argv[])
@@ -689,6 +915,8 @@ int EMTest(int argc, char* argv[])
   rv += testOneWayFreeSpaceRangeLoss();
   rv += testLossToPpf();
   rv += antennaPatternTest(argc, argv);
+  rv += testAntennaGainCache();
+  rv += testRcsBatch();
 
   std::cout << "EMTests " << ((rv == 0) ? "Passed" : "Failed") << std::endl;
 
@@ -28,9 +28,12 @@
 #include "simCore/Calc/Units.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Common/Version.h"
+#include "simCore/String/Format.h"
 #include "simCore/String/Tokenizer.h"
 #include "simCore/GOG/GogShape.h"
 #include "simCore/GOG/Parser.h"
+#include "simNotify/Notify.h"
+#include "simNotify/NotifyHandler.h"
 
 namespace {
 
@@ -2259,6 +2262,171 @@ int testReferencePositionField()
   return rv;
 }
 
+/** Notify handler that records all messages, with their severity prefixes */
+class CaptureNotifyHandler : public simNotify::NotifyHandler
+{
+public:
+  virtual void notify(const std::string& message) { text += message; }
+  std::string text;
+};
+
+/** Parses the GOG text with the given number of threads, from a stream or a buffer, returning the serialized shapes and the notifications */
+void parseWithThreads(const std::string& gog, unsigned int numThreads, std::string& shapesText, std::string& messages, size_t& numShapes, bool fromBuffer = false)
+{
+  simNotify::NotifyHandlerPtr errorHandler = simNotify::notifyHandler(simNotify::NOTIFY_ERROR);
+  simNotify::NotifyHandlerPtr warnHandler = simNotify::notifyHandler(simNotify::NOTIFY_WARN);
+  std::shared_ptr<CaptureNotifyHandler> capture(new CaptureNotifyHandler);
+  simNotify::setNotifyHandler(simNotify::NOTIFY_ERROR, capture);
+  simNotify::setNotifyHandler(simNotify::NOTIFY_WARN, capture);
+
+  simCore::GOG::Parser parser;
+  parser.setNumThreads(numThreads);
+  std::vector<simCore::GOG::GogShapePtr> shapes;
+  if (fromBuffer)
+    parser.parse(gog.data(), gog.size(), "parallel.gog", shapes);
+  else
+  {
+    std::istringstream is(gog);
+    parser.parse(is, "parallel.gog", shapes);
+  }
+
+  simNotify::setNotifyHandler(simNotify::NOTIFY_ERROR, errorHandler);
+  simNotify::setNotifyHandler(simNotify::NOTIFY_WARN, warnHandler);
+
+  std::ostringstream os;
+  for (const auto& shape : shapes)
+    shape->serializeToStream(os);
+  shapesText = os.str();
+  messages = capture->text;
+  numShapes = shapes.size();
+}
+
+// test that a parallel parse gives the same shapes and messages as a serial parse
+int testParallelParse()
+{
+  int rv = 0;
+
+  std::ostringstream gog;
+  gog << "version 2\nline outside of block\n";
+  for (int block = 0; block < 600; ++block)
+  {
+    gog << (block % 3 == 0 ? "Start\n" : "start\n");
+    switch (block % 6)
+    {
+    case 0:
+      gog << "line\n linecolor red\n 3d name line " << block << "\n";
+      for (int point = 0; point < 20; ++point)
+        gog << " ll " << (block * 0.01) << " " << (point * 0.1) << " 100\n";
+      break;
+    case 1:
+      gog << "annotation first " << block << "\n centerll 10 20\nannotation second_" << block << "\n centerll 11 21\n";
+      break;
+    case 2:
+      gog << "circle\n centerxy 1 2\n radius 100\n linecolor notacolor\n";
+      break;
+    case 3:
+      // multiple shape keywords and an invalid shape
+      gog << "poly\n circle\n ll 1 2\n";
+      break;
+    case 4:
+      // unterminated block followed by a nested start
+      gog << "points\n";
+      for (int point = 0; point < 400; ++point)
+        gog << " xyz " << point << " 1 2\n";
+      gog << "start\n ll 3 4\n";
+      break;
+    default:
+      gog << "ellipse\n centerll 22 33\n majoraxis 10\n minoraxis 5\n unknownkeyword 5\n starttime \"bad time\"\n";
+      break;
+    }
+    gog << "end\n";
+    if (block % 50 == 0)
+      gog << "end\nfillcolor blue\n";
+  }
+
+  std::string serialShapes;
+  std::string serialMessages;
+  size_t serialCount = 0;
+  parseWithThreads(gog.str(), 1, serialShapes, serialMessages, serialCount);
+  rv += SDK_ASSERT(serialCount > 500);
+  rv += SDK_ASSERT(serialMessages.find("Multiple shape keywords") != std::string::npos);
+  rv += SDK_ASSERT(serialMessages.find("nested start") != std::string::npos);
+
+  const unsigned int threadCounts[] = { 0, 2, 4 };
+  for (unsigned int numThreads : threadCounts)
+  {
+    std::string shapes;
+    std::string messages;
+    size_t count = 0;
+    parseWithThreads(gog.str(), numThreads, shapes, messages, count);
+    rv += SDK_ASSERT(count == serialCount);
+    rv += SDK_ASSERT(shapes == serialShapes);
+    rv += SDK_ASSERT(messages == serialMessages);
+  }
+
+  // Parsing from a buffer matches parsing from a stream, serial or parallel
+  const unsigned int bufferThreadCounts[] = { 1, 4 };
+  for (unsigned int numThreads : bufferThreadCounts)
+  {
+    std::string shapes;
+    std::string messages;
+    size_t count = 0;
+    parseWithThreads(gog.str(), numThreads, shapes, messages, count, true);
+    rv += SDK_ASSERT(count == serialCount);
+    rv += SDK_ASSERT(shapes == serialShapes);
+    rv += SDK_ASSERT(messages == serialMessages);
+  }
+
+  // Empty input and input without a trailing newline
+  std::string shapes;
+  std::string messages;
+  size_t count = 0;
+  parseWithThreads("", 4, shapes, messages, count);
+  rv += SDK_ASSERT(count == 0);
+  parseWithThreads("start\nline\nll 1 2\nll 3 4\nend", 4, shapes, messages, count);
+  rv += SDK_ASSERT(count == 1);
+  parseWithThreads("start\r\nline\r\nll 1 2 \r\nll 3 4\t\r\nend\r\n", 1, shapes, messages, count, true);
+  rv += SDK_ASSERT(count == 1);
+
+  return rv;
+}
+
+// test that lines in a buffer are tokenized the same as simCore::quoteTokenizer()
+int testBufferTokenizing()
+{
+  int rv = 0;
+
+  const std::string comments[] = {
+    "# plain  comment\twith tabs",
+    "# \"double quoted\" 'single quoted' \"\"\"triple quoted\"\"\" end",
+    "# \"escaped \\\" quote\" \"even \\\\\" backslashes",
+    "# \"\"\"\" four quotes \"unterminated quote",
+    "# 'unterminated single",
+    "# trailing\"\"\"",
+  };
+  std::string gog = "start\n";
+  for (const std::string& comment : comments)
+    gog += comment + "\n";
+  gog += "line\nll 1 2\nll 3 4\nend\n";
+
+  simCore::GOG::Parser parser;
+  std::vector<simCore::GOG::GogShapePtr> shapes;
+  parser.parse(gog.data(), gog.size(), "", shapes);
+  rv += SDK_ASSERT(shapes.size() == 1);
+  if (shapes.size() != 1)
+    return rv;
+
+  const std::vector<std::string>& parsedComments = shapes.front()->comments();
+  rv += SDK_ASSERT(parsedComments.size() == 6);
+  for (size_t k = 0; k < 6 && k < parsedComments.size(); ++k)
+  {
+    std::vector<std::string> tokens;
+    simCore::quoteTokenizer(tokens, comments[k]);
+    rv += SDK_ASSERT(parsedComments[k] == simCore::join(tokens, " "));
+  }
+  return rv;
+}
+
 }
 
 int GogTest(int argc, char* argv[])
@@ -2283,6 +2451,8 @@ int GogTest(int argc, char* argv[])
   rv += testLineWidthStrings();
   rv += testTimeStrings();
   rv += testReferencePositionField();
+  rv += testParallelParse();
+  rv += testBufferTokenizing();
 
   return rv;
 }
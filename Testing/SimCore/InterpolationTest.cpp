@@ -21,9 +21,15 @@
  *
  */
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Interpolation.h"
+#include "simCore/Calc/Random.h"
+#include "simCore/LUT/InterpTable.h"
+#include "simCore/LUT/LUT2.h"
+#include "simCore/Time/Utils.h"
 
 namespace
 {
@@ -205,6 +211,84 @@ namespace
 
     return rv;
   }
+  int lut2InterpolateBilinearTest()
+  {
+    int rv = 0;
+    // Propagation loss style table: heights by ranges of centibel values
+    simCore::LUT::LUT2<short> lut;
+    lut.initialize(0., 1000., 101, 100., 50000., 500);
+    for (size_t i = 0; i < lut.numX(); ++i)
+    {
+      for (size_t j = 0; j < lut.numY(); ++j)
+        lut(i, j) = static_cast<short>(1200 + 3 * i - 7 * j + ((i * j) % 13) * 11);
+    }
+
+    // Queries span the table, including both edges
+    const size_t count = 200000;
+    std::vector<double> heights(count);
+    std::vector<double> ranges(count);
+    simCore::UniformVariable heightVar(0., 1000.);
+    simCore::UniformVariable rangeVar(100., 50000.);
+    for (size_t k = 0; k < count; ++k)
+    {
+      heights[k] = heightVar();
+      ranges[k] = rangeVar();
+    }
+    heights[0] = 0.;
+    ranges[0] = 100.;
+    heights[1] = 1000.;
+    ranges[1] = 50000.;
+    heights[2] = 500.;
+    ranges[2] = 50000.;
+
+    std::vector<short> batch(count);
+    simCore::LUT::interpolateBilinear(lut, count, &heights[0], &ranges[0], &batch[0]);
+    BilinearInterpolate<short> bil;
+    size_t mismatches = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (simCore::LUT::interpolate(lut, heights[k], ranges[k], bil) != batch[k])
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+    rv += SDK_ASSERT(batch[0] == lut(0, 0));
+    rv += SDK_ASSERT(batch[1] == lut(100, 499));
+
+    // Values outside of the table are clamped to the edge cells
+    const double outsideHeights[] = { -10., 2000. };
+    const double outsideRanges[] = { 0., 60000. };
+    short outside[2];
+    simCore::LUT::interpolateBilinear(lut, 2, outsideHeights, outsideRanges, outside);
+    rv += SDK_ASSERT(outside[0] == lut(0, 0));
+    rv += SDK_ASSERT(outside[1] == lut(100, 499));
+
+    // Tables without cells cannot be interpolated
+    simCore::LUT::LUT2<short> singleRow;
+    singleRow.initialize(0., 0., 1, 0., 10., 11);
+    bool thrown = false;
+    try
+    {
+      simCore::LUT::interpolateBilinear(singleRow, 1, outsideHeights, outsideRanges, outside);
+    }
+    catch (const std::out_of_range&)
+    {
+      thrown = true;
+    }
+    rv += SDK_ASSERT(thrown);
+
+    // Micro-benchmark of single versus batch interpolation
+    long sum = 0;
+    const double startSingle = simCore::getSystemTime();
+    for (size_t k = 0; k < count; ++k)
+      sum += simCore::LUT::interpolate(lut, heights[k], ranges[k], bil);
+    const double startBatch = simCore::getSystemTime();
+    simCore::LUT::interpolateBilinear(lut, count, &heights[0], &ranges[0], &batch[0]);
+    const double endBatch = simCore::getSystemTime();
+    std::cout << "LUT2 bilinear: " << count << " interpolations, single " << (startBatch - startSingle)
+      << " s, batch " << (endBatch - startBatch) << " s" << std::endl;
+    rv += SDK_ASSERT(sum != 0);
+    return rv;
+  }
 }
 
 int InterpolationTest(int argc, char* argv[])
@@ -217,6 +301,7 @@ int InterpolationTest(int argc, char* argv[])
   rv += linearInterpolateMapTest();
   rv += bilinearInterpolateTest();
   rv += nearestNeighborInterpolateTest();
+  rv += lut2InterpolateBilinearTest();
 
   std::cout << "InterpolationTest " << ((rv == 0) ? "Passed" : "Failed") << std::endl;
 
@@ -0,0 +1,252 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Geometry.h"
+#include "simCore/Calc/SpatialIndex.h"
+
+namespace {
+
+/** Positions by ID, searched by brute force to check the index */
+typedef std::vector<std::pair<uint64_t, simCore::Vec3> > Items;
+
+double distanceSq(const simCore::Vec3& a, const simCore::Vec3& b)
+{
+  const simCore::Vec3 delta(a.x() - b.x(), a.y() - b.y(), a.z() - b.z());
+  return delta.x() * delta.x() + delta.y() * delta.y() + delta.z() * delta.z();
+}
+
+std::vector<uint64_t> sorted(std::vector<uint64_t> ids)
+{
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+int checkQueries(const simCore::SpatialIndex& index, const Items& items, const simCore::Vec3& center)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(index.size() == items.size());
+
+  // Radius
+  const double radius = 2500.0;
+  std::vector<uint64_t> expected;
+  for (Items::const_iterator i = items.begin(); i != items.end(); ++i)
+  {
+    if (distanceSq(i->second, center) <= radius * radius)
+      expected.push_back(i->first);
+  }
+  std::vector<uint64_t> found;
+  index.queryRadius(center, radius, found);
+  rv += SDK_ASSERT(sorted(found) == sorted(expected));
+
+  // Box
+  const simCore::Vec3 minCorner(center.x() - 3000.0, center.y() - 1000.0, center.z() - 2000.0);
+  const simCore::Vec3 maxCorner(center.x() + 1000.0, center.y() + 3000.0, center.z() + 2000.0);
+  expected.clear();
+  for (Items::const_iterator i = items.begin(); i != items.end(); ++i)
+  {
+    const simCore::Vec3& p = i->second;
+    if (p.x() >= minCorner.x() && p.x() <= maxCorner.x() && p.y() >= minCorner.y() && p.y() <= maxCorner.y() && p.z() >= minCorner.z() && p.z() <= maxCorner.z())
+      expected.push_back(i->first);
+  }
+  found.clear();
+  index.queryBox(minCorner, maxCorner, found);
+  rv += SDK_ASSERT(sorted(found) == sorted(expected));
+
+  // Polytope: a wedge opening along +x from the center
+  simCore::Polytope wedge;
+  wedge.addPlane(simCore::Plane(center, simCore::Vec3(center.x(), center.y(), center.z() + 1.0), simCore::Vec3(center.x() + 1.0, center.y() + 1.0, center.z())));
+  wedge.addPlane(simCore::Plane(center, simCore::Vec3(center.x() + 1.0, center.y() - 1.0, center.z()), simCore::Vec3(center.x(), center.y(), center.z() + 1.0)));
+  expected.clear();
+  for (Items::const_iterator i = items.begin(); i != items.end(); ++i)
+  {
+    if (wedge.contains(i->second))
+      expected.push_back(i->first);
+  }
+  rv += SDK_ASSERT(items.empty() || (!expected.empty() && expected.size() < items.size()));
+  found.clear();
+  index.queryPolytope(wedge, found);
+  rv += SDK_ASSERT(sorted(found) == sorted(expected));
+
+  // Empty polytope contains everything
+  found.clear();
+  index.queryPolytope(simCore::Polytope(), found);
+  rv += SDK_ASSERT(found.size() == items.size());
+
+  // Nearest, closest first with ties in ID order
+  Items byDistance = items;
+  std::sort(byDistance.begin(), byDistance.end(), [&center](const Items::value_type& a, const Items::value_type& b) {
+    const double aDist = distanceSq(a.second, center);
+    const double bDist = distanceSq(b.second, center);
+    return (aDist != bDist) ? (aDist < bDist) : (a.first < b.first);
+  });
+  const size_t k = std::min(static_cast<size_t>(25), items.size());
+  expected.clear();
+  for (size_t n = 0; n < k; ++n)
+    expected.push_back(byDistance[n].first);
+  found.clear();
+  index.queryNearest(center, k, found);
+  rv += SDK_ASSERT(found == expected);
+  return rv;
+}
+
+int testEmpty()
+{
+  int rv = 0;
+  simCore::SpatialIndex index(10.0);
+  rv += SDK_ASSERT(index.size() == 0);
+  rv += SDK_ASSERT(index.height() == 0);
+  std::vector<uint64_t> ids;
+  index.queryRadius(simCore::Vec3(), 1e9, ids);
+  index.queryBox(simCore::Vec3(-1e9, -1e9, -1e9), simCore::Vec3(1e9, 1e9, 1e9), ids);
+  index.queryPolytope(simCore::Polytope(), ids);
+  index.queryNearest(simCore::Vec3(), 5, ids);
+  rv += SDK_ASSERT(ids.empty());
+  rv += SDK_ASSERT(index.remove(1) != 0);
+  simCore::Vec3 pos;
+  rv += SDK_ASSERT(index.position(1, pos) != 0);
+
+  // Single item
+  index.setPosition(7, simCore::Vec3(1.0, 2.0, 3.0));
+  rv += SDK_ASSERT(index.size() == 1);
+  rv += SDK_ASSERT(index.height() == 1);
+  rv += SDK_ASSERT(index.position(7, pos) == 0 && pos == simCore::Vec3(1.0, 2.0, 3.0));
+  index.queryNearest(simCore::Vec3(), 5, ids);
+  rv += SDK_ASSERT(ids.size() == 1 && ids[0] == 7);
+  rv += SDK_ASSERT(index.remove(7) == 0);
+  rv += SDK_ASSERT(index.size() == 0 && index.height() == 0);
+  return rv;
+}
+
+int testRandomItems()
+{
+  int rv = 0;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> coord(-20000.0, 20000.0);
+  std::uniform_real_distribution<double> step(-50.0, 50.0);
+
+  simCore::SpatialIndex index(100.0);
+  Items items;
+  for (uint64_t id = 1; id <= 5000; ++id)
+  {
+    const simCore::Vec3 p(coord(gen), coord(gen), coord(gen) * 0.1);
+    items.push_back(std::make_pair(id, p));
+    index.setPosition(id, p);
+  }
+  // Balanced; a degenerate tree would be thousands of levels high
+  rv += SDK_ASSERT(index.height() <= 30);
+  rv += checkQueries(index, items, simCore::Vec3(0.0, 0.0, 0.0));
+  rv += checkQueries(index, items, simCore::Vec3(15000.0, -12000.0, 1000.0));
+
+  // Duplicate positions are kept as separate items
+  index.setPosition(9001, items[10].second);
+  items.push_back(std::make_pair(static_cast<uint64_t>(9001), items[10].second));
+  rv += checkQueries(index, items, items[10].second);
+
+  // Small moves stay within the margin, large moves reinsert
+  for (size_t k = 0; k < items.size(); ++k)
+  {
+    simCore::Vec3& p = items[k].second;
+    if (k % 10 == 0)
+      p.set(coord(gen), coord(gen), coord(gen) * 0.1);
+    else
+      p.set(p.x() + step(gen), p.y() + step(gen), p.z() + step(gen));
+    index.setPosition(items[k].first, p);
+  }
+  rv += SDK_ASSERT(index.height() <= 30);
+  rv += checkQueries(index, items, simCore::Vec3(-5000.0, 5000.0, 0.0));
+  simCore::Vec3 pos;
+  rv += SDK_ASSERT(index.position(items[3].first, pos) == 0 && pos == items[3].second);
+
+  // Remove every third item; freed nodes are reused by new items
+  Items remaining;
+  for (size_t k = 0; k < items.size(); ++k)
+  {
+    if (k % 3 == 0)
+      rv += SDK_ASSERT(index.remove(items[k].first) == 0);
+    else
+      remaining.push_back(items[k]);
+  }
+  rv += SDK_ASSERT(index.remove(items[0].first) != 0);
+  rv += checkQueries(index, remaining, simCore::Vec3(1000.0, 1000.0, 0.0));
+  for (uint64_t id = 20000; id < 20500; ++id)
+  {
+    const simCore::Vec3 p(coord(gen), coord(gen), coord(gen) * 0.1);
+    remaining.push_back(std::make_pair(id, p));
+    index.setPosition(id, p);
+  }
+  rv += checkQueries(index, remaining, simCore::Vec3(-15000.0, 0.0, 0.0));
+
+  index.clear();
+  rv += SDK_ASSERT(index.size() == 0 && index.height() == 0);
+  rv += checkQueries(index, Items(), simCore::Vec3());
+  return rv;
+}
+
+int testGeoFence()
+{
+  int rv = 0;
+  // Square fence around 0 lat/0 lon, 10 degrees on a side
+  simCore::Vec3String vertices;
+  vertices.push_back(simCore::Vec3(5.0 * simCore::DEG2RAD, -5.0 * simCore::DEG2RAD, 0.0));
+  vertices.push_back(simCore::Vec3(-5.0 * simCore::DEG2RAD, -5.0 * simCore::DEG2RAD, 0.0));
+  vertices.push_back(simCore::Vec3(-5.0 * simCore::DEG2RAD, 5.0 * simCore::DEG2RAD, 0.0));
+  vertices.push_back(simCore::Vec3(5.0 * simCore::DEG2RAD, 5.0 * simCore::DEG2RAD, 0.0));
+  vertices.push_back(vertices.front());
+  const simCore::GeoFence fence(vertices, simCore::COORD_SYS_LLA);
+  rv += SDK_ASSERT(fence.valid());
+
+  // Points on the equator, every 2 degrees of longitude
+  simCore::SpatialIndex index(1000.0);
+  std::vector<uint64_t> expected;
+  for (int lon = -178; lon <= 180; lon += 2)
+  {
+    const double lonRad = lon * simCore::DEG2RAD;
+    const simCore::Vec3 ecef(simCore::WGS_A * cos(lonRad), simCore::WGS_A * sin(lonRad), 0.0);
+    const uint64_t id = static_cast<uint64_t>(lon + 1000);
+    index.setPosition(id, ecef);
+    if (fence.contains(ecef))
+      expected.push_back(id);
+  }
+  rv += SDK_ASSERT(expected.size() == 5);
+
+  std::vector<uint64_t> found;
+  index.queryPolytope(fence.polytope(), found);
+  rv += SDK_ASSERT(sorted(found) == expected);
+  return rv;
+}
+
+}
+
+int SpatialIndexTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testEmpty();
+  rv += testRandomItems();
+  rv += testGeoFence();
+  return rv;
+}
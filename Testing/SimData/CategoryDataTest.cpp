@@ -20,7 +20,11 @@
  * disclose, or release this software.
  *
  */
+#include <iostream>
+#include <map>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
 #include "simData/CategoryData/CategoryNameManager.h"
 #include "simData/CategoryData/CategoryFilter.h"
 #include "simData/MemoryDataStore.h"
@@ -1463,6 +1467,152 @@ int testCaseInsensitivity()
   return rv;
 }
 
+/** Returns 0 if the flat current values of the slice agree with allInts() */
+int compareCurrentValues(const simData::DataStore& ds, uint64_t id)
+{
+  int rv = 0;
+  const simData::CategoryNameManager& catMan = ds.categoryNameManager();
+  const simData::CategoryDataSlice* slice = ds.categoryDataSlice(id);
+  const std::vector<int>* values = slice->currentValues();
+  rv += SDK_ASSERT(values != nullptr);
+  if (values == nullptr)
+    return rv;
+  rv += SDK_ASSERT(values->size() <= catMan.numCategoryNames());
+
+  std::map<int, int> expected;
+  slice->allInts(expected);
+  std::vector<int> nameInts;
+  catMan.allCategoryNameInts(nameInts);
+  for (std::vector<int>::const_iterator i = nameInts.begin(); i != nameInts.end(); ++i)
+  {
+    const int index = catMan.nameIndex(*i);
+    rv += SDK_ASSERT(index >= 0 && static_cast<size_t>(index) < catMan.numCategoryNames());
+    const int actual = (static_cast<size_t>(index) < values->size()) ? (*values)[index] : simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME;
+    std::map<int, int>::const_iterator exp = expected.find(*i);
+    rv += SDK_ASSERT(actual == (exp == expected.end() ? simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME : exp->second));
+  }
+  return rv;
+}
+
+int testFlatCurrentValues()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  loadCategoryData(ds);
+  simData::CategoryNameManager& catMan = ds.categoryNameManager();
+  simQt::RegExpFilterFactoryImpl reFactory;
+
+  // Names get dense indices in the order added; values are not names
+  rv += SDK_ASSERT(catMan.numCategoryNames() == 3);
+  rv += SDK_ASSERT(catMan.nameIndex(catMan.nameToInt("key1")) == 0);
+  rv += SDK_ASSERT(catMan.nameIndex(catMan.nameToInt("key2")) == 1);
+  rv += SDK_ASSERT(catMan.nameIndex(catMan.nameToInt("key3")) == 2);
+  rv += SDK_ASSERT(catMan.nameIndex(catMan.valueToInt("value2")) == simData::CategoryNameManager::NO_CATEGORY_NAME);
+  rv += SDK_ASSERT(catMan.nameIndex(simData::CategoryNameManager::NO_CATEGORY_NAME) == simData::CategoryNameManager::NO_CATEGORY_NAME);
+  rv += SDK_ASSERT(catMan.nameIndex(1000000) == simData::CategoryNameManager::NO_CATEGORY_NAME);
+
+  // Forward and backward in time, including before any data
+  const double times[] = { 0.5, 1.0, 2.0, 3.0, 2.5, 1.5, 0.0, 10.0 };
+  for (size_t k = 0; k < sizeof(times) / sizeof(times[0]); ++k)
+  {
+    ds.update(times[k]);
+    rv += compareCurrentValues(ds, PLATFORM_ID);
+  }
+
+  // Filters see the same result from the flat values as from the map
+  const char* filters[] = {
+    "key1(1)~value3(1)",
+    "key1(1)~value4(1)",
+    "key1(1)~Unlisted Value(0)~value3(1)`key3(1)~Unlisted Value(0)~value1(1)",
+    "key2(1)~No Value(1)",
+    "key3(1)~No Value(0)~Unlisted Value(1)",
+    "key1(1)^value[34]",
+    "key3(1)^^$",
+  };
+  for (size_t k = 0; k < sizeof(times) / sizeof(times[0]); ++k)
+  {
+    ds.update(times[k]);
+    simData::CategoryFilter::CurrentCategoryValues curVals;
+    simData::CategoryFilter::getCurrentCategoryValues(ds, PLATFORM_ID, curVals);
+    const std::vector<int>* values = ds.categoryDataSlice(PLATFORM_ID)->currentValues();
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+    {
+      simData::CategoryFilter filter(&ds);
+      rv += SDK_ASSERT(filter.deserialize(filters[f], reFactory));
+      const bool fromMap = filter.matchData(curVals);
+      rv += SDK_ASSERT(filter.matchValues(*values, catMan) == fromMap);
+      rv += SDK_ASSERT(filter.match(ds, PLATFORM_ID) == fromMap);
+    }
+  }
+
+  // Edits between updates are visible without another update, like allInts()
+  ds.update(2.0);
+  simData::DataStore::Transaction t;
+  simData::CategoryData* cd = ds.addCategoryData(PLATFORM_ID, &t);
+  cd->set_time(1.5);
+  simData::CategoryData_Entry* e = cd->add_entry();
+  e->set_key("key4");
+  e->set_value("value5");
+  e = cd->add_entry();
+  e->set_key("key1");
+  e->set_value("value5");
+  t.commit();
+  rv += SDK_ASSERT(catMan.numCategoryNames() == 4);
+  rv += compareCurrentValues(ds, PLATFORM_ID);
+  const std::vector<int>* values = ds.categoryDataSlice(PLATFORM_ID)->currentValues();
+  rv += SDK_ASSERT(values->size() == 4);
+  rv += SDK_ASSERT((*values)[catMan.nameIndex(catMan.nameToInt("key4"))] == catMan.valueToInt("value5"));
+  ds.update(3.0);
+  rv += compareCurrentValues(ds, PLATFORM_ID);
+  // Later updates only rewrite the categories that change, and still agree with allInts()
+  for (size_t k = 0; k < sizeof(times) / sizeof(times[0]); ++k)
+  {
+    ds.update(times[k]);
+    rv += compareCurrentValues(ds, PLATFORM_ID);
+  }
+
+  // Removing and re-adding a category keeps its index
+  const int key2 = catMan.nameToInt("key2");
+  catMan.removeCategory(key2);
+  rv += SDK_ASSERT(catMan.addCategoryName("key2") == key2);
+  rv += SDK_ASSERT(catMan.nameIndex(key2) == 1);
+  rv += SDK_ASSERT(catMan.numCategoryNames() == 4);
+
+  // Flushing leaves only the current values
+  ds.flush(PLATFORM_ID);
+  rv += compareCurrentValues(ds, PLATFORM_ID);
+  ds.update(3.0);
+  rv += compareCurrentValues(ds, PLATFORM_ID);
+
+  // Compare cost of matching through the map versus the flat values
+  simData::CategoryFilter filter(&ds);
+  rv += SDK_ASSERT(filter.deserialize("key1(1)~Unlisted Value(1)`key3(1)~Unlisted Value(1)~No Value(1)", reFactory));
+  const int iterations = 100000;
+  int mapMatches = 0;
+  const double mapStart = simCore::getSystemTime();
+  for (int k = 0; k < iterations; ++k)
+  {
+    simData::CategoryFilter::CurrentCategoryValues curVals;
+    simData::CategoryFilter::getCurrentCategoryValues(ds, PLATFORM_ID, curVals);
+    mapMatches += filter.matchData(curVals) ? 1 : 0;
+  }
+  const double mapSeconds = simCore::getSystemTime() - mapStart;
+  int flatMatches = 0;
+  const double flatStart = simCore::getSystemTime();
+  for (int k = 0; k < iterations; ++k)
+    flatMatches += filter.match(ds, PLATFORM_ID) ? 1 : 0;
+  const double flatSeconds = simCore::getSystemTime() - flatStart;
+  rv += SDK_ASSERT(mapMatches == flatMatches);
+  std::cout << "Category filter match, " << iterations << " evaluations: map " << mapSeconds << " s, flat " << flatSeconds << " s\n";
+
+  // Clearing the manager resets the indices
+  catMan.clear();
+  rv += SDK_ASSERT(catMan.numCategoryNames() == 0);
+  rv += SDK_ASSERT(catMan.nameIndex(key2) == simData::CategoryNameManager::NO_CATEGORY_NAME);
+
+  return rv;
+}
+
 }
 
 int CategoryDataTest(int argc, char *argv[])
@@ -1485,6 +1635,7 @@ int CategoryDataTest(int argc, char *argv[])
   rv += testSimplify();
   rv += testRegExpSimplify();
   rv += testCaseInsensitivity();
+  rv += testFlatCurrentValues();
 
   return rv;
 }
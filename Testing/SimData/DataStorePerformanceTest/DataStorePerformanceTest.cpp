@@ -31,6 +31,7 @@
 #include "simCore/Time/Utils.h"
 #include "simCore/Calc/Math.h"
 #include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/ThreadPool.h"
 #include "simCore/String/Format.h"
 #include "simCore/String/Tokenizer.h"
 #include "simUtil/DataStoreTestHelper.h"
@@ -566,7 +567,10 @@ struct TopLevelOptions
     dataLimiting(false),
     playforward(true),
     addListener(true),
-    testCD(false)
+    testCD(false),
+    pooledUpdates(false),
+    updateThreads(1),
+    threadScaling(false)
   {
   }
 
@@ -578,6 +582,9 @@ struct TopLevelOptions
   bool playforward;  // True = move time forwards, False = move time backwards
   bool addListener;  // True = count the number of callbacks
   bool testCD;       // True = testing will include testing of CategoryData
+  bool pooledUpdates;  // True = allocate entity updates from per-slice pools
+  unsigned int updateThreads;  // Number of threads for DataStore::update; 1 = serial
+  bool threadScaling;  // True = in file mode, time the playback with 1, 2, 4 and 8 update threads
 };
 
 /// Initializes the DataStore and creates all the entities
@@ -635,34 +642,9 @@ int cleanUpDataStore(simData::DataStore& ds, const TopLevelOptions& options, Ent
   return rv;
 }
 
-/// Simulates file mode by loading the data than doing one playback
-double fileMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities)
+/// Plays back the entire time range of file mode data once, returning the elapsed time in seconds
+double filePlayback(simData::DataStore& ds, const TopLevelOptions& options, Entities& entities)
 {
-  std::cout << "In File Mode" << std::endl;
-  std::cout << "Creating Data" << std::endl;
-
-  for (size_t ii = 0; ii < static_cast<size_t>(options.numberOfSeconds); ii++)
-  {
-    for (size_t jj = 0; jj < entities.platforms->dataPerSecond(); jj++)
-      entities.platforms->addUpdates(ii, jj, entities.platforms->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.beams->dataPerSecond(); jj++)
-      entities.beams->addUpdates(ii, jj, entities.beams->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.gates->dataPerSecond(); jj++)
-      entities.gates->addUpdates(ii, jj, entities.gates->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.lasers->dataPerSecond(); jj++)
-      entities.lasers->addUpdates(ii, jj, entities.lasers->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.lobGroups->dataPerSecond(); jj++)
-      entities.lobGroups->addUpdates(ii, jj, entities.lobGroups->dataPerSecond());
-  }
-
-  std::cout << "Starting updates" << std::endl;
-  // The sleep helps with looking at the data in the Intel tools
-  Sleep(1000);
-
   double direction = 1.0;
   int offset = 0;
   if (!options.playforward)
@@ -691,6 +673,66 @@ double fileMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, To
   return endTime-startTime;
 }
 
+/// Times one file mode playback for each of 1, 2, 4 and 8 update threads
+void threadScaling(simData::MemoryDataStore& ds, const TopLevelOptions& options, Entities& entities)
+{
+  std::cout << "Timing playback with multiple update threads; hardware threads = " << simCore::ThreadPool::hardwareThreads() << std::endl;
+  double serialTime = 0.0;
+  for (unsigned int numThreads = 1; numThreads <= 8; numThreads *= 2)
+  {
+    ds.setUpdateThreadCount(numThreads);
+    // Rewind, so that each pass starts from the same state
+    ds.update(-1.0);
+    const double playbackTime = filePlayback(ds, options, entities);
+    if (numThreads == 1)
+      serialTime = playbackTime;
+    std::cout << "  " << numThreads << " thread(s): Average Update Rate (milliseconds) = " << playbackTime * 1000.0 / (options.numberOfSeconds*options.frameRate)
+      << ", speedup = " << (playbackTime > 0.0 ? serialTime / playbackTime : 0.0) << std::endl;
+  }
+  ds.setUpdateThreadCount(options.updateThreads);
+  ds.update(-1.0);
+}
+
+/// Simulates file mode by loading the data than doing one playback
+double fileMode(simData::MemoryDataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities, CallbackCounters& counters)
+{
+  std::cout << "In File Mode" << std::endl;
+  std::cout << "Creating Data" << std::endl;
+
+  const double createStartTime = simCore::systemTimeToSecsBgnYr();
+  for (size_t ii = 0; ii < static_cast<size_t>(options.numberOfSeconds); ii++)
+  {
+    for (size_t jj = 0; jj < entities.platforms->dataPerSecond(); jj++)
+      entities.platforms->addUpdates(ii, jj, entities.platforms->dataPerSecond());
+
+    for (size_t jj = 0; jj < entities.beams->dataPerSecond(); jj++)
+      entities.beams->addUpdates(ii, jj, entities.beams->dataPerSecond());
+
+    for (size_t jj = 0; jj < entities.gates->dataPerSecond(); jj++)
+      entities.gates->addUpdates(ii, jj, entities.gates->dataPerSecond());
+
+    for (size_t jj = 0; jj < entities.lasers->dataPerSecond(); jj++)
+      entities.lasers->addUpdates(ii, jj, entities.lasers->dataPerSecond());
+
+    for (size_t jj = 0; jj < entities.lobGroups->dataPerSecond(); jj++)
+      entities.lobGroups->addUpdates(ii, jj, entities.lobGroups->dataPerSecond());
+  }
+  std::cout << "Time to create data (seconds) = " << simCore::systemTimeToSecsBgnYr() - createStartTime << std::endl;
+
+  if (options.threadScaling)
+  {
+    threadScaling(ds, options, entities);
+    // Only count the callbacks from the final playback
+    counters.time = 0;
+  }
+
+  std::cout << "Starting updates" << std::endl;
+  // The sleep helps with looking at the data in the Intel tools
+  Sleep(1000);
+
+  return filePlayback(ds, options, entities);
+}
+
 /// Simulates live mode by repeatedly adding data and doing an update
 double liveMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities)
 {
@@ -804,6 +846,9 @@ void writeExampleConfigurationFile()
   output << "Interpolate true          # State of the DataStore interpolation" << std::endl;
   output << "NumberOfSeconds 150       # Seconds of data" << std::endl;
   output << "DataLimiting false        # Used in Live mode to limit the amount of data, limits are set below" << std::endl;
+  output << "PooledUpdates false       # Allocate entity updates from per-slice pools instead of the heap" << std::endl;
+  output << "UpdateThreads 1           # Number of threads used by DataStore::update; 1 updates serially" << std::endl;
+  output << "ThreadScaling false       # File mode only; time the playback with 1, 2, 4 and 8 update threads" << std::endl;
   output << std::endl;
 
   writeEntityConfigurationPart(output, "Platform", 1000);
@@ -1038,6 +1083,12 @@ int loadConfigurationFile(const std::string& fileName, TopLevelOptions& options,
         options.numberOfSeconds = atoi(tokens[1].c_str());
       else if (simCore::caseCompare(tokens[0], "DataLimiting") == 0)
         options.dataLimiting = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "PooledUpdates") == 0)
+        options.pooledUpdates = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "UpdateThreads") == 0)
+        options.updateThreads = static_cast<unsigned int>(atoi(tokens[1].c_str()));
+      else if (simCore::caseCompare(tokens[0], "ThreadScaling") == 0)
+        options.threadScaling = (simCore::caseCompare(tokens[1], "True") == 0);
       else
       {
         std::cerr << "Unknown command on line " << currentLineNumber << std::endl;
@@ -1114,11 +1165,15 @@ int main(int argc, char *argv[])
     return -1;
   }
 
+  ds.setPooledUpdateAllocation(options.pooledUpdates);
+  std::cout << "Pooled update allocation " << (options.pooledUpdates ? "enabled" : "disabled") << std::endl;
+  ds.setUpdateThreadCount(options.updateThreads);
+  std::cout << "Update threads = " << ds.updateThreadCount() << std::endl;
   simData::LinearInterpolator* interpolator = initializeDataStore(ds, helper, options, entities, &counters);
 
   double updateTime;
   if (options.fileMode)
-    updateTime = fileMode(ds, helper, options, entities);
+    updateTime = fileMode(ds, helper, options, entities, counters);
   else
     updateTime = liveMode(ds, helper, options, entities);
 
@@ -1126,6 +1181,10 @@ int main(int argc, char *argv[])
   // The sleep helps with looking at the data in the Intel tools
   Sleep(1000);
 
+  const double flushStartTime = simCore::systemTimeToSecsBgnYr();
+  ds.flush(0, simData::DataStore::RECURSIVE);
+  std::cout << "Time to flush (seconds) = " << simCore::systemTimeToSecsBgnYr() - flushStartTime << std::endl;
+
   cleanUpDataStore(ds, options, entities, counters);
   delete interpolator;
 
@@ -20,11 +20,18 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
 #include <string>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Math.h"
+#include "simCore/Time/Utils.h"
 #include "simData/DataTable.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/MemoryTable/BlockTimeContainer.h"
 #include "simData/MemoryTable/DoubleBufferTimeContainer.h"
 #include "simData/MemoryTable/SubTable.h"
 #include "simData/MemoryTable/TableManager.h"
@@ -1966,6 +1973,8 @@ int timeContainerTest()
   MemoryTable::DoubleBufferTimeContainer dbContainer;
   int rv = 0;
   rv += SDK_ASSERT(timeContainerTest(dbContainer) == 0);
+  MemoryTable::BlockTimeContainer blockContainer;
+  rv += SDK_ASSERT(timeContainerTest(blockContainer) == 0);
   return rv;
 }
 
@@ -2248,6 +2257,363 @@ int testPartialFlush()
   return rv;
 }
 
+/** Reads all values of a column in [beginTime, endTime) using the heap-allocating iterator */
+void readWithIterator(const simData::TableColumn& column, double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values)
+{
+  times.clear();
+  values.clear();
+  simData::TableColumn::Iterator iter = column.lower_bound(beginTime);
+  while (iter.hasNext())
+  {
+    simData::TableColumn::IteratorDataPtr data = iter.next();
+    if (data->time() >= endTime)
+      break;
+    double value = 0.0;
+    data->getValue(value);
+    times.push_back(data->time());
+    values.push_back(value);
+  }
+}
+
+/** Reads all values of a column in [beginTime, endTime) using a cursor */
+template <typename T>
+void readWithCursor(const simData::TableColumn& column, double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values)
+{
+  times.clear();
+  values.clear();
+  simData::TableColumnCursor<T> cursor(column, beginTime, endTime);
+  while (cursor.next())
+  {
+    times.push_back(cursor.time());
+    values.push_back(static_cast<double>(cursor.value()));
+  }
+}
+
+int testColumnCursor()
+{
+  int rv = 0;
+
+  // Data limiting splits the rows between the stale and fresh bins of the time container
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore* ds = testHelper.dataStore();
+  const uint64_t platId = testHelper.addPlatform();
+  ds->setDataLimiting(true);
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds->mutable_platformPrefs(platId, &t);
+  prefs->mutable_commonprefs()->set_datalimitpoints(1500);
+  t.commit();
+
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(ds->dataTableManager().addDataTable(platId, "Cursor Test Table", &table).isSuccess());
+  simData::TableColumn* doubles = nullptr;
+  simData::TableColumn* shorts = nullptr;
+  simData::TableColumn* sparse = nullptr;
+  rv += SDK_ASSERT(table->addColumn("Doubles", VT_DOUBLE, 0, &doubles).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("Shorts", VT_INT16, 0, &shorts).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("Sparse", VT_UINT32, 0, &sparse).isSuccess());
+
+  simData::TableRow row;
+  for (int k = 0; k < 2000; ++k)
+  {
+    row.clear();
+    row.setTime(k * 0.5);
+    row.setValue(doubles->columnId(), k * 1.25);
+    row.setValue(shorts->columnId(), static_cast<int16_t>(k % 1000 - 500));
+    if (k % 3 == 0)
+      row.setValue(sparse->columnId(), static_cast<uint32_t>(k));
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  }
+  // Late rows land in the fresh bin between times in the stale bin
+  for (int k = 1700; k < 1900; k += 7)
+  {
+    row.clear();
+    row.setTime(k * 0.5 + 0.25);
+    row.setValue(doubles->columnId(), -k * 1.25);
+    row.setValue(shorts->columnId(), static_cast<int16_t>(-k % 1000));
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  }
+  rv += SDK_ASSERT(doubles->size() > simData::TableColumnCursor<double>::BLOCK_SIZE * 2);
+
+  const double ranges[][2] = {
+    { -std::numeric_limits<double>::max(), std::numeric_limits<double>::max() },
+    { 900.1, 940.0 },
+    { 950.0, 950.0 },
+    { 2000.0, 3000.0 }
+  };
+  const simData::TableColumn* columns[] = { doubles, shorts, sparse };
+  std::vector<double> expectedTimes;
+  std::vector<double> expectedValues;
+  std::vector<double> times;
+  std::vector<double> values;
+  for (size_t c = 0; c < 3; ++c)
+  {
+    for (size_t r = 0; r < 4; ++r)
+    {
+      readWithIterator(*columns[c], ranges[r][0], ranges[r][1], expectedTimes, expectedValues);
+      readWithCursor<double>(*columns[c], ranges[r][0], ranges[r][1], times, values);
+      rv += SDK_ASSERT(times == expectedTimes);
+      rv += SDK_ASSERT(values == expectedValues);
+      // Conversion to another type
+      readWithCursor<int64_t>(*columns[c], ranges[r][0], ranges[r][1], times, values);
+      rv += SDK_ASSERT(times == expectedTimes);
+      for (size_t k = 0; k < values.size(); ++k)
+        rv += SDK_ASSERT(values[k] == static_cast<double>(static_cast<int64_t>(expectedValues[k])));
+    }
+  }
+
+  // Bulk copy honors maxCount, and times are optional
+  readWithIterator(*doubles, 900.1, 1000.0, expectedTimes, expectedValues);
+  rv += SDK_ASSERT(expectedValues.size() > 10);
+  std::vector<double> copied(expectedValues.size(), 0.0);
+  std::vector<double> copiedTimes(expectedValues.size(), 0.0);
+  rv += SDK_ASSERT(doubles->copyRange(900.1, 1000.0, &copied[0], &copiedTimes[0], 10) == 10);
+  rv += SDK_ASSERT(std::equal(copied.begin(), copied.begin() + 10, expectedValues.begin()));
+  rv += SDK_ASSERT(std::equal(copiedTimes.begin(), copiedTimes.begin() + 10, expectedTimes.begin()));
+  rv += SDK_ASSERT(doubles->copyRange(900.1, 1000.0, &copied[0], nullptr, copied.size()) == copied.size());
+  rv += SDK_ASSERT(copied == expectedValues);
+  rv += SDK_ASSERT(doubles->copyRange(900.1, 1000.0, &copied[0], nullptr, 0) == 0);
+
+  // Compare speed of the iterator and the cursor on a larger table
+  simData::MemoryTable::TableManager mgr(nullptr);
+  simData::DataTable* bigTable = nullptr;
+  rv += SDK_ASSERT(mgr.addDataTable(0, "Big Table", &bigTable).isSuccess());
+  simData::TableColumn* bigColumn = nullptr;
+  rv += SDK_ASSERT(bigTable->addColumn("Values", VT_DOUBLE, 0, &bigColumn).isSuccess());
+  const int NUM_ROWS = 200000;
+  for (int k = 0; k < NUM_ROWS; ++k)
+  {
+    row.clear();
+    row.setTime(k);
+    row.setValue(bigColumn->columnId(), k * 0.5);
+    bigTable->addRow(row);
+  }
+  double iterSum = 0.0;
+  double startTime = simCore::systemTimeToSecsBgnYr();
+  simData::TableColumn::Iterator iter = bigColumn->begin();
+  while (iter.hasNext())
+  {
+    double value = 0.0;
+    iter.next()->getValue(value);
+    iterSum += value;
+  }
+  const double iterElapsed = simCore::systemTimeToSecsBgnYr() - startTime;
+  double cursorSum = 0.0;
+  startTime = simCore::systemTimeToSecsBgnYr();
+  simData::TableColumnCursor<double> cursor(*bigColumn);
+  while (cursor.next())
+    cursorSum += cursor.value();
+  const double cursorElapsed = simCore::systemTimeToSecsBgnYr() - startTime;
+  rv += SDK_ASSERT(iterSum == cursorSum);
+  std::cout << "Time to read " << NUM_ROWS << " rows: iterator " << iterElapsed << ", cursor " << cursorElapsed << std::endl;
+
+  return rv;
+}
+
+/** Returns 0 if both time containers hold the same times and indices in the same order */
+int compareTimeContainers(MemoryTable::TimeContainer& expected, MemoryTable::TimeContainer& actual)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(expected.size() == actual.size());
+  MemoryTable::TimeContainer::Iterator expectedIter = expected.begin();
+  MemoryTable::TimeContainer::Iterator actualIter = actual.begin();
+  while (expectedIter.hasNext() && actualIter.hasNext())
+  {
+    const MemoryTable::TimeContainer::IteratorData expectedData = expectedIter.next();
+    const MemoryTable::TimeContainer::IteratorData actualData = actualIter.next();
+    if (expectedData.time() != actualData.time() || expectedData.index() != actualData.index())
+    {
+      rv += SDK_ASSERT(0);
+      break;
+    }
+  }
+  rv += SDK_ASSERT(!expectedIter.hasNext() && !actualIter.hasNext());
+  return rv;
+}
+
+int blockTimeContainerTest()
+{
+  int rv = 0;
+
+  // Random insertion order matches the double buffer, including the data container indices
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> tenths(0, 20000);
+  std::uniform_real_distribution<double> anyTime(-1e6, 1e6);
+  MemoryTable::DoubleBufferTimeContainer expected;
+  MemoryTable::BlockTimeContainer blocks;
+  for (int k = 0; k < 5000; ++k)
+  {
+    // Mix decimal times that encode as deltas with arbitrary times that do not
+    const double timeValue = (k % 4 == 0) ? anyTime(gen) : (1000.0 + tenths(gen) * 0.1);
+    bool expectedMatch = false;
+    bool actualMatch = true;
+    const MemoryTable::TimeContainer::IteratorData expectedData = expected.findOrAddTime(timeValue, &expectedMatch).next();
+    const MemoryTable::TimeContainer::IteratorData actualData = blocks.findOrAddTime(timeValue, &actualMatch).next();
+    rv += SDK_ASSERT(expectedMatch == actualMatch);
+    rv += SDK_ASSERT(actualData.time() == timeValue);
+    rv += SDK_ASSERT(expectedData.index() == actualData.index());
+  }
+  rv += compareTimeContainers(expected, blocks);
+  rv += SDK_ASSERT(blocks.numBlocks() > 1);
+
+  // Searches agree with the double buffer
+  for (int k = 0; k < 500; ++k)
+  {
+    const double timeValue = (k % 2 == 0) ? anyTime(gen) : (1000.0 + tenths(gen) * 0.1);
+    rv += SDK_ASSERT(expected.lower_bound(timeValue).peekNext().time() == blocks.lower_bound(timeValue).peekNext().time());
+    rv += SDK_ASSERT(expected.upper_bound(timeValue).peekNext().time() == blocks.upper_bound(timeValue).peekNext().time());
+    rv += SDK_ASSERT(expected.find(timeValue).hasNext() == blocks.find(timeValue).hasNext());
+    MemoryTable::TimeContainer::Iterator expectedBefore = expected.findTimeAtOrBeforeGivenTime(timeValue);
+    MemoryTable::TimeContainer::Iterator actualBefore = blocks.findTimeAtOrBeforeGivenTime(timeValue);
+    rv += SDK_ASSERT(expectedBefore.hasNext() == actualBefore.hasNext());
+    if (expectedBefore.hasNext() && actualBefore.hasNext())
+      rv += SDK_ASSERT(expectedBefore.next().time() == actualBefore.next().time());
+  }
+  MemoryTable::TimeContainer::IteratorData expectedEntries[100];
+  MemoryTable::TimeContainer::IteratorData actualEntries[100];
+  const size_t numEntries = expected.copyEntries(1500.0, 1600.0, expectedEntries, 100);
+  rv += SDK_ASSERT(numEntries > 0);
+  rv += SDK_ASSERT(blocks.copyEntries(1500.0, 1600.0, actualEntries, 100) == numEntries);
+  for (size_t k = 0; k < numEntries; ++k)
+    rv += SDK_ASSERT(expectedEntries[k].time() == actualEntries[k].time() && expectedEntries[k].index() == actualEntries[k].index());
+
+  // Erasing with offset fixes matches the double buffer
+  for (int k = 0; k < 100; ++k)
+  {
+    const double timeValue = expected.lower_bound(anyTime(gen)).peekNext().time();
+    expected.erase(expected.find(timeValue), MemoryTable::TimeContainer::ERASE_FIXOFFSETS);
+    blocks.erase(blocks.find(timeValue), MemoryTable::TimeContainer::ERASE_FIXOFFSETS);
+  }
+  rv += compareTimeContainers(expected, blocks);
+
+  // Clones are independent
+  MemoryTable::TimeContainer* clone = blocks.clone();
+  rv += compareTimeContainers(expected, *clone);
+  clone->flush();
+  rv += SDK_ASSERT(clone->empty() && !clone->begin().hasNext());
+  rv += SDK_ASSERT(blocks.size() == expected.size());
+  delete clone;
+
+  // In-order data at a decimal rate encodes as deltas, using much less memory than the double buffer
+  MemoryTable::DoubleBufferTimeContainer inOrderExpected;
+  MemoryTable::BlockTimeContainer inOrder;
+  const size_t NUM_IN_ORDER = 100000;
+  for (size_t k = 0; k < NUM_IN_ORDER; ++k)
+  {
+    const double timeValue = 31536000.0 + k * 0.1;
+    inOrderExpected.findOrAddTime(timeValue);
+    inOrder.findOrAddTime(timeValue);
+  }
+  rv += compareTimeContainers(inOrderExpected, inOrder);
+  rv += SDK_ASSERT(inOrder.numRawBlocks() == 0);
+  rv += SDK_ASSERT(inOrder.memoryUsage() * 2 < inOrderExpected.memoryUsage());
+  std::cout << "Time index memory for " << NUM_IN_ORDER << " rows: double buffer " << inOrderExpected.memoryUsage()
+    << " bytes, blocks " << inOrder.memoryUsage() << " bytes in " << inOrder.numBlocks() << " blocks" << std::endl;
+
+  // Data limiting removes whole blocks from the front, and keeps at least the requested points
+  const std::vector<MemoryTable::DataColumn*> noColumns;
+  const std::vector<DataTable::TableObserverPtr> noObservers;
+  inOrder.limitData(1000, -1.0, noColumns, nullptr, noObservers);
+  rv += SDK_ASSERT(inOrder.size() >= 1000);
+  rv += SDK_ASSERT(inOrder.size() < 1000 + MemoryTable::BlockTimeContainer::BLOCK_SIZE);
+  MemoryTable::TimeContainer::Iterator front = inOrder.begin();
+  rv += SDK_ASSERT(front.peekNext().index() == 0);
+  rv += SDK_ASSERT(front.peekNext().time() == 31536000.0 + (NUM_IN_ORDER - inOrder.size()) * 0.1);
+  MemoryTable::TimeContainer::Iterator back = inOrder.end();
+  rv += SDK_ASSERT(back.peekPrevious().index() == inOrder.size() - 1);
+  rv += SDK_ASSERT(back.peekPrevious().time() == 31536000.0 + (NUM_IN_ORDER - 1) * 0.1);
+  // Limiting by time removes the blocks entirely before the invalid time
+  double begin = 0.0;
+  double end = 0.0;
+  rv += SDK_ASSERT(inOrder.getTimeRange(begin, end) == 0);
+  inOrder.limitData(0, end - 10.0, noColumns, nullptr, noObservers);
+  rv += SDK_ASSERT(inOrder.getTimeRange(begin, end) == 0);
+  rv += SDK_ASSERT(begin <= end - 10.0);
+  rv += SDK_ASSERT(inOrder.size() >= 100 && inOrder.size() < 100 + MemoryTable::BlockTimeContainer::BLOCK_SIZE);
+
+  return rv;
+}
+
+int blockTimeContainerTableTest()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore* ds = testHelper.dataStore();
+  const uint64_t platId = testHelper.addPlatform();
+  ds->setDataLimiting(true);
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds->mutable_platformPrefs(platId, &t);
+  prefs->mutable_commonprefs()->set_datalimitpoints(500);
+  t.commit();
+
+  MemoryTable::TableManager* mgr = dynamic_cast<MemoryTable::TableManager*>(&ds->dataTableManager());
+  rv += SDK_ASSERT(mgr != nullptr);
+  if (mgr == nullptr)
+    return rv;
+  mgr->setTimeContainerPrototype(new MemoryTable::BlockTimeContainer());
+
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(ds->dataTableManager().addDataTable(platId, "Block Table", &table).isSuccess());
+  simData::TableColumn* column1 = nullptr;
+  simData::TableColumn* column2 = nullptr;
+  rv += SDK_ASSERT(table->addColumn("1", VT_INT32, 0, &column1).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("2", VT_DOUBLE, 0, &column2).isSuccess());
+
+  // Every 10th row skips the second column, splitting the subtable
+  simData::TableRow row;
+  for (int k = 0; k < 2000; ++k)
+  {
+    row.clear();
+    row.setTime(k * 0.5);
+    row.setValue(column1->columnId(), k);
+    if (k % 10 != 0)
+      row.setValue(column2->columnId(), k * 2.0);
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  }
+  rv += SDK_ASSERT(column1->size() >= 500 && column1->size() < 500 + MemoryTable::BlockTimeContainer::BLOCK_SIZE);
+  rv += SDK_ASSERT(column2->size() >= 500 && column2->size() < 500 + MemoryTable::BlockTimeContainer::BLOCK_SIZE);
+
+  // Values still line up with their times after limiting
+  int errors = 0;
+  simData::TableColumn::Iterator iter = column1->begin();
+  while (iter.hasNext())
+  {
+    simData::TableColumn::IteratorDataPtr data = iter.next();
+    int32_t value = 0;
+    data->getValue(value);
+    if (value * 0.5 != data->time())
+      ++errors;
+  }
+  iter = column2->begin();
+  while (iter.hasNext())
+  {
+    simData::TableColumn::IteratorDataPtr data = iter.next();
+    double value = 0.0;
+    data->getValue(value);
+    if (value != data->time() * 4.0)
+      ++errors;
+  }
+  rv += SDK_ASSERT(errors == 0);
+
+  // Range flush keeps the remaining data aligned
+  double begin = 0.0;
+  double end = 0.0;
+  rv += SDK_ASSERT(column1->getTimeRange(begin, end) == 0);
+  const size_t origSize = column1->size();
+  table->flush(begin + 10.0, begin + 20.0);
+  rv += SDK_ASSERT(column1->size() == origSize - 20);
+  double value = 0.0;
+  rv += SDK_ASSERT(column1->interpolate(value, begin + 25.0, nullptr).isSuccess());
+  rv += SDK_ASSERT(value * 0.5 == begin + 25.0);
+  simData::TableColumn::IteratorDataPtr before = column1->findAtOrBeforeTime(begin + 15.0).next();
+  rv += SDK_ASSERT(before->time() == begin + 9.5);
+  before = column2->findAtOrBeforeTime(begin + 25.0).next();
+  rv += SDK_ASSERT(before->getValue(value).isSuccess());
+  rv += SDK_ASSERT(value == before->time() * 4.0);
+
+  mgr->setTimeContainerPrototype(nullptr);
+  return rv;
+}
+
 }
 
 int MemoryDataTableTest(int argc, char* argv[])
@@ -2261,9 +2627,13 @@ int MemoryDataTableTest(int argc, char* argv[])
   rv += dataLimitingTest();
   rv += dataLimitSecondsTest();
   rv += subTableIterationTest(new simData::MemoryTable::DoubleBufferTimeContainer());
+  rv += subTableIterationTest(new simData::MemoryTable::BlockTimeContainer());
   rv += testColumnIteration();
   rv += doubleBufferTimeContainerTest();
   rv += testPartialFlush();
   rv += getTimeRangeTest();
+  rv += testColumnCursor();
+  rv += blockTimeContainerTest();
+  rv += blockTimeContainerTableTest();
   return rv;
 }
@@ -22,6 +22,7 @@
  */
 #include "simCore/Common/SDKAssert.h"
 #include "simData/DataStoreHelpers.h"
+#include "simData/MemoryDataStore.h"
 #include "simUtil/DataStoreTestHelper.h"
 
 namespace {
@@ -703,6 +704,112 @@ int testCommandTiming()
   return rv;
 }
 
+/// Adds a command at the given time; every seventh command clears the icon instead of setting it
+void addSnapshotTestCommand(simUtil::DataStoreTestHelper& helper, uint64_t platId, int index, double time)
+{
+  simData::PlatformCommand cmd;
+  cmd.set_time(time);
+  // Late commands set a field that no other command sets
+  if (index >= 1000)
+    cmd.mutable_updateprefs()->set_drawbox(true);
+  if (index % 7 == 6)
+  {
+    cmd.mutable_updateprefs()->set_icon("");
+    cmd.set_isclearcommand(true);
+  }
+  else
+  {
+    cmd.mutable_updateprefs()->set_icon("icon" + std::to_string(index));
+    if (index % 3 == 0)
+      cmd.mutable_updateprefs()->mutable_commonprefs()->set_draw(index % 2 == 0);
+    if (index % 5 == 0)
+      cmd.mutable_updateprefs()->mutable_commonprefs()->mutable_labelprefs()->set_draw(index % 4 == 0);
+    if (index % 11 == 0)
+      cmd.mutable_updateprefs()->mutable_commonprefs()->mutable_labelprefs()->set_offsetx(index);
+    if (index % 13 == 0)
+      cmd.mutable_updateprefs()->mutable_commonprefs()->mutable_labelprefs()->set_offsety(index);
+  }
+  helper.addPlatformCommand(cmd, platId);
+}
+
+/// Updates both data stores to the given time and verifies that the platform prefs match
+int compareSnapshotPrefs(simData::DataStore* ds, uint64_t id, simData::DataStore* reference, uint64_t refId, double time)
+{
+  ds->update(time);
+  reference->update(time);
+  simData::DataStore::Transaction t;
+  const simData::PlatformPrefs* prefs = ds->platformPrefs(id, &t);
+  simData::DataStore::Transaction refT;
+  const simData::PlatformPrefs* refPrefs = reference->platformPrefs(refId, &refT);
+  if (SDK_ASSERT(prefs != nullptr && refPrefs != nullptr) != 0)
+    return 1;
+  return SDK_ASSERT(prefs->SerializeAsString() == refPrefs->SerializeAsString());
+}
+
+/// Tests that backward seeks from command state snapshots match replaying every command
+int testCommandSnapshots()
+{
+  int rv = 0;
+
+  // Reference data store has snapshots disabled
+  simUtil::DataStoreTestHelper refHelper;
+  simData::MemoryDataStore* reference = dynamic_cast<simData::MemoryDataStore*>(refHelper.dataStore());
+  simUtil::DataStoreTestHelper testHelper;
+  simData::MemoryDataStore* ds = dynamic_cast<simData::MemoryDataStore*>(testHelper.dataStore());
+  if (SDK_ASSERT(reference != nullptr && ds != nullptr) != 0)
+    return 1;
+  reference->setCommandSnapshotLimits(10, 0.0, 0);
+  // Small limits so that the snapshots are thinned
+  ds->setCommandSnapshotLimits(10, 25.0, 8);
+  size_t commandInterval = 0;
+  double timeInterval = 0.0;
+  size_t maxSnapshots = 0;
+  ds->commandSnapshotLimits(&commandInterval, &timeInterval, &maxSnapshots);
+  rv += SDK_ASSERT(commandInterval == 10);
+  rv += SDK_ASSERT(timeInterval == 25.0);
+  rv += SDK_ASSERT(maxSnapshots == 8);
+
+  const uint64_t refId = refHelper.addPlatform();
+  const uint64_t platId = testHelper.addPlatform();
+  for (int k = 0; k < 500; ++k)
+  {
+    addSnapshotTestCommand(refHelper, refId, k, k * 0.5);
+    addSnapshotTestCommand(testHelper, platId, k, k * 0.5);
+  }
+
+  // Play forward to create the snapshots
+  for (double time = 0.0; time < 260.0; time += 3.7)
+    rv += compareSnapshotPrefs(ds, platId, reference, refId, time);
+  const simData::MemoryCommandSlice<simData::PlatformCommand, simData::PlatformPrefs>* slice =
+    dynamic_cast<const simData::MemoryCommandSlice<simData::PlatformCommand, simData::PlatformPrefs>*>(ds->platformCommandSlice(platId));
+  if (SDK_ASSERT(slice != nullptr) != 0)
+    return rv + 1;
+  rv += SDK_ASSERT(slice->numSnapshots() > 0);
+  rv += SDK_ASSERT(slice->numSnapshots() <= 8);
+
+  // Seek backwards, including to the times of the commands themselves
+  const double seekTimes[] = { 200.0, 199.5, 12.25, 0.0, 249.5, 137.0, 137.5, 64.0, 255.0, 5.5, 100.0 };
+  for (size_t k = 0; k < sizeof(seekTimes) / sizeof(seekTimes[0]); ++k)
+    rv += compareSnapshotPrefs(ds, platId, reference, refId, seekTimes[k]);
+
+  // Insert a command into the middle of the existing commands; later snapshots must not be used
+  addSnapshotTestCommand(refHelper, refId, 1001, 80.25);
+  addSnapshotTestCommand(testHelper, platId, 1001, 80.25);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 240.0);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 80.25);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 150.0);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 80.0);
+
+  // Disabling snapshots discards them
+  ds->setCommandSnapshotLimits(10, 0.0, 0);
+  rv += SDK_ASSERT(slice->numSnapshots() == 0);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 230.0);
+  rv += compareSnapshotPrefs(ds, platId, reference, refId, 30.0);
+  rv += SDK_ASSERT(slice->numSnapshots() == 0);
+
+  return rv;
+}
+
 }
 
 int TestCommands(int argc, char* argv[])
@@ -715,6 +822,7 @@ int TestCommands(int argc, char* argv[])
   rv += testPlatformCommand();
   rv += testAcceptProjectorsPrefs();
   rv += testAcceptProjectorsCommands();
+  rv += testCommandSnapshots();
 
   return rv;
 }
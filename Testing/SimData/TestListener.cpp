@@ -23,6 +23,7 @@
 
 #include "simCore/Common/SDKAssert.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/MessageVisitor/Message.h"
 #include "simUtil/DataStoreTestHelper.h"
 
 namespace
@@ -499,6 +500,107 @@ int testPrefsChange()
   return rv;
 }
 
+/// Records the fields reported with prefs and properties changes
+class ChangedFieldsListener : public simData::DataStore::DefaultListener
+{
+public:
+  ChangedFieldsListener()
+    : prefsCount(0),
+      propertiesCount(0)
+  {
+  }
+
+  virtual void onPrefsFieldsChange(simData::DataStore *source, simData::ObjectId id, const simData::DataStore::FieldList& changedFields)
+  {
+    ++prefsCount;
+    prefsFields = changedFields;
+  }
+
+  virtual void onPropertiesFieldsChange(simData::DataStore *source, simData::ObjectId id, const simData::DataStore::FieldList& changedFields)
+  {
+    ++propertiesCount;
+    propertiesFields = changedFields;
+  }
+
+  int prefsCount;
+  int propertiesCount;
+  simData::DataStore::FieldList prefsFields;
+  simData::DataStore::FieldList propertiesFields;
+};
+
+int testPrefsFieldsChange()
+{
+  int rv = 0;
+
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore* ds = testHelper.dataStore();
+  uint64_t platId1 = testHelper.addPlatform();
+
+  ChangedFieldsListener* fields = new ChangedFieldsListener;
+  ds->addListener(simData::DataStore::ListenerPtr(fields));
+  // listeners that only implement onPrefsChange() are still notified
+  CounterListener* counter = new CounterListener;
+  ds->addListener(simData::DataStore::ListenerPtr(counter));
+
+  // one field
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_color(1);
+  testHelper.updatePlatformPrefs(prefs, platId1);
+  rv += SDK_ASSERT(fields->prefsCount == 1);
+  rv += SDK_ASSERT(fields->prefsFields.size() == 1 && fields->prefsFields[0] == "commonPrefs.color");
+  rv += SDK_ASSERT(counter->compareAndClear(0, 0, 1, 0, 0, 0, 0, 0));
+
+  // no change, no notification
+  testHelper.updatePlatformPrefs(prefs, platId1);
+  rv += SDK_ASSERT(fields->prefsCount == 1);
+  rv += SDK_ASSERT(counter->compareAndClear(0, 0, 0, 0, 0, 0, 0, 0));
+
+  // fields from multiple commits in one transaction are combined, without duplicates
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformPrefs* p = ds->mutable_platformPrefs(platId1, &t);
+    p->set_icon("newIcon");
+    p->mutable_commonprefs()->set_color(2);
+    t.commit();
+    p->mutable_commonprefs()->set_color(3);
+    p->mutable_commonprefs()->set_alias("alias");
+    t.commit();
+    t.release(&p);
+  }
+  rv += SDK_ASSERT(fields->prefsCount == 2);
+  rv += SDK_ASSERT(fields->prefsFields.size() == 3);
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields->prefsFields, "icon"));
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields->prefsFields, "commonPrefs.color"));
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields->prefsFields, "commonPrefs.alias"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(fields->prefsFields, "commonPrefs.name"));
+  {
+    simData::DataStore::Transaction t;
+    rv += SDK_ASSERT(ds->platformPrefs(platId1, &t)->commonprefs().color() == 3);
+  }
+
+  // properties
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformProperties* p = ds->mutable_platformProperties(platId1, &t);
+    p->set_originalid(1234);
+    t.complete(&p);
+  }
+  rv += SDK_ASSERT(fields->propertiesCount == 1);
+  rv += SDK_ASSERT(fields->propertiesFields.size() == 1 && fields->propertiesFields[0] == "originalId");
+
+  // a cleared field is reported
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformPrefs* p = ds->mutable_platformPrefs(platId1, &t);
+    p->clear_icon();
+    t.complete(&p);
+  }
+  rv += SDK_ASSERT(fields->prefsCount == 3);
+  rv += SDK_ASSERT(fields->prefsFields.size() == 1 && fields->prefsFields[0] == "icon");
+
+  return rv;
+}
+
 int testTimeChange()
 {
   int rv = 0;
@@ -833,6 +935,7 @@ int TestListener(int argc, char* argv[])
   rv += testAddEntity();
   rv += testRemoveEntity();
   rv += testPrefsChange();
+  rv += testPrefsFieldsChange();
   rv += testTimeChange();
   rv += testCategoryDataChange();
   rv += testNameChange();
@@ -20,16 +20,26 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "simCore/Common/Version.h"
 #include "simCore/Time/ClockImpl.h"
 #include "simCore/Common/Common.h"
+#include "simData/IngestQueue.h"
 #include "simData/LinearInterpolator.h"
+#include "simData/DataStoreHelpers.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/MemoryDataStoreSnapshot.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simUtil/DataStoreTestHelper.h"
 
@@ -1536,6 +1546,704 @@ int testUpdateToNonCurrentTime()
   return rv;
 }
 
+/** Records the order of category data and change notifications */
+class UpdateOrderListener : public simData::DataStore::DefaultListener
+{
+public:
+  virtual void onCategoryDataChange(simData::DataStore *source, simData::ObjectId changedId, simData::ObjectType ot)
+  {
+    events.push_back(changedId);
+  }
+
+  virtual void onChange(simData::DataStore *source)
+  {
+    // 0 is not a valid entity ID, so it marks the end of an update
+    events.push_back(0);
+  }
+
+  std::vector<simData::ObjectId> events;
+};
+
+/** Adds the same entities and data to a data store; returns the ID of the first platform */
+uint64_t fillUpdateThreadsDataStore(simUtil::DataStoreTestHelper& helper)
+{
+  uint64_t firstPlatform = 0;
+  for (int k = 0; k < 40; ++k)
+  {
+    const uint64_t platId = helper.addPlatform();
+    if (firstPlatform == 0)
+      firstPlatform = platId;
+    const uint64_t beamId = helper.addBeam(platId);
+    const uint64_t gateId = helper.addGate(beamId);
+    const uint64_t laserId = helper.addLaser(platId);
+    const uint64_t lobId = helper.addLOB(platId);
+    // Stagger the data so entities start and stop at different times
+    for (int time = k % 5; time < 20 - (k % 3); ++time)
+    {
+      helper.addPlatformUpdate(time, platId);
+      helper.addBeamUpdate(time, beamId);
+      helper.addGateUpdate(time, gateId);
+      helper.addLaserUpdate(time, laserId);
+      helper.addLOBUpdate(time, lobId);
+    }
+    helper.addCategoryData(platId, "Key", "A", 2.0 + k % 7);
+    helper.addCategoryData(platId, "Key", "B", 10.0 + k % 4);
+
+    // Commands turn some of the platforms off partway through
+    simData::PlatformCommand cmd;
+    cmd.set_time(5.0 + k % 6);
+    cmd.mutable_updateprefs()->mutable_commonprefs()->set_datadraw(k % 2 == 0);
+    helper.addPlatformCommand(cmd, platId);
+  }
+  return firstPlatform;
+}
+
+/** Verifies that parallel slice updates give the same results and callbacks as serial updates */
+int testUpdateThreads()
+{
+  int rv = 0;
+
+  simData::LinearInterpolator interpolator;
+  simData::MemoryDataStore serialDs;
+  simData::MemoryDataStore parallelDs;
+  simUtil::DataStoreTestHelper serialHelper(&serialDs);
+  simUtil::DataStoreTestHelper parallelHelper(&parallelDs);
+  std::shared_ptr<UpdateOrderListener> serialListener(new UpdateOrderListener);
+  std::shared_ptr<UpdateOrderListener> parallelListener(new UpdateOrderListener);
+
+  rv += SDK_ASSERT(parallelDs.updateThreadCount() == 1);
+  parallelDs.setUpdateThreadCount(4);
+  rv += SDK_ASSERT(parallelDs.updateThreadCount() == 4);
+
+  const uint64_t serialFirst = fillUpdateThreadsDataStore(serialHelper);
+  const uint64_t parallelFirst = fillUpdateThreadsDataStore(parallelHelper);
+  rv += SDK_ASSERT(serialFirst == parallelFirst);
+  serialDs.addListener(serialListener);
+  parallelDs.addListener(parallelListener);
+
+  simData::DataStore::IdList ids;
+  serialDs.idList(&ids);
+
+  // Play forward with interpolation, then backward without
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    serialDs.setInterpolator(&interpolator);
+    parallelDs.setInterpolator(&interpolator);
+    serialDs.enableInterpolation(pass == 0);
+    parallelDs.enableInterpolation(pass == 0);
+    for (int step = 0; step <= 70; ++step)
+    {
+      const double time = (pass == 0) ? (step * 0.3) : (21.0 - step * 0.3);
+      serialDs.update(time);
+      parallelDs.update(time);
+      for (simData::DataStore::IdList::const_iterator i = ids.begin(); i != ids.end(); ++i)
+      {
+        const simData::ObjectId id = *i;
+        switch (serialDs.objectType(id))
+        {
+        case simData::PLATFORM:
+        {
+          const simData::PlatformUpdate* u1 = serialDs.platformUpdateSlice(id)->current();
+          const simData::PlatformUpdate* u2 = parallelDs.platformUpdateSlice(id)->current();
+          rv += SDK_ASSERT((u1 == nullptr) == (u2 == nullptr));
+          if (u1 != nullptr && u2 != nullptr)
+            rv += SDK_ASSERT(u1->time() == u2->time() && u1->x() == u2->x());
+          rv += SDK_ASSERT(serialDs.platformUpdateSlice(id)->hasChanged() == parallelDs.platformUpdateSlice(id)->hasChanged());
+          break;
+        }
+        case simData::BEAM:
+        {
+          const simData::BeamUpdate* u1 = serialDs.beamUpdateSlice(id)->current();
+          const simData::BeamUpdate* u2 = parallelDs.beamUpdateSlice(id)->current();
+          rv += SDK_ASSERT((u1 == nullptr) == (u2 == nullptr));
+          if (u1 != nullptr && u2 != nullptr)
+            rv += SDK_ASSERT(u1->time() == u2->time() && u1->range() == u2->range());
+          break;
+        }
+        case simData::GATE:
+        {
+          const simData::GateUpdate* u1 = serialDs.gateUpdateSlice(id)->current();
+          const simData::GateUpdate* u2 = parallelDs.gateUpdateSlice(id)->current();
+          rv += SDK_ASSERT((u1 == nullptr) == (u2 == nullptr));
+          if (u1 != nullptr && u2 != nullptr)
+            rv += SDK_ASSERT(u1->time() == u2->time());
+          break;
+        }
+        case simData::LASER:
+        {
+          const simData::LaserUpdate* u1 = serialDs.laserUpdateSlice(id)->current();
+          const simData::LaserUpdate* u2 = parallelDs.laserUpdateSlice(id)->current();
+          rv += SDK_ASSERT((u1 == nullptr) == (u2 == nullptr));
+          if (u1 != nullptr && u2 != nullptr)
+            rv += SDK_ASSERT(u1->time() == u2->time());
+          break;
+        }
+        case simData::LOB_GROUP:
+        {
+          const simData::LobGroupUpdate* u1 = serialDs.lobGroupUpdateSlice(id)->current();
+          const simData::LobGroupUpdate* u2 = parallelDs.lobGroupUpdateSlice(id)->current();
+          rv += SDK_ASSERT((u1 == nullptr) == (u2 == nullptr));
+          if (u1 != nullptr && u2 != nullptr)
+            rv += SDK_ASSERT(u1->datapoints_size() == u2->datapoints_size());
+          break;
+        }
+        default:
+          break;
+        }
+      }
+    }
+  }
+
+  // Callbacks are delivered in the same order
+  rv += SDK_ASSERT(!serialListener->events.empty());
+  rv += SDK_ASSERT(serialListener->events == parallelListener->events);
+
+  // Returning to serial updates releases the threads
+  parallelDs.setUpdateThreadCount(0);
+  rv += SDK_ASSERT(parallelDs.updateThreadCount() == 1);
+  return rv;
+}
+
+/** Counts entity update notifications */
+class CountingNewUpdatesListener : public simData::DataStore::DefaultNewUpdatesListener
+{
+public:
+  CountingNewUpdatesListener() : numEntityUpdates(0) {}
+  virtual void onEntityUpdate(simData::DataStore* source, simData::ObjectId id, double dataTime) { ++numEntityUpdates; }
+  int numEntityUpdates;
+};
+
+int testIngestQueue()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  std::shared_ptr<CountingNewUpdatesListener> listener(new CountingNewUpdatesListener);
+  ds.setNewUpdatesListener(listener);
+
+  // Full queue drops updates, including their memory
+  simData::IngestQueue small(4);
+  rv += SDK_ASSERT(small.capacity() == 4);
+  simData::PlatformUpdate update;
+  for (int k = 0; k < 4; ++k)
+  {
+    update.set_time(k);
+    rv += SDK_ASSERT(small.push(platId, update) == 0);
+  }
+  update.set_time(4.0);
+  rv += SDK_ASSERT(small.push(platId, update) != 0);
+  rv += SDK_ASSERT(small.push(beamId, new simData::BeamUpdate) != 0);
+  rv += SDK_ASSERT(small.size() == 4);
+  simData::IngestQueue::Statistics stats = small.statistics();
+  rv += SDK_ASSERT(stats.accepted == 4);
+  rv += SDK_ASSERT(stats.dropped == 2);
+  rv += SDK_ASSERT(stats.applied == 0);
+  // High-water mark is sampled on push, before any drain
+  rv += SDK_ASSERT(stats.highWaterMark == 4);
+
+  // Draining applies the updates; unknown entities are rejected
+  rv += SDK_ASSERT(small.drain(ds) == 4);
+  rv += SDK_ASSERT(small.size() == 0);
+  // Platform updates go in as one batch, notifying for the earliest and latest times only
+  rv += SDK_ASSERT(listener->numEntityUpdates == 2);
+  ds.setNewUpdatesListener(simData::DataStore::NewUpdatesListenerPtr());
+  simData::BeamUpdate* beamUpdate = new simData::BeamUpdate;
+  beamUpdate->set_time(1.0);
+  beamUpdate->set_range(100.0);
+  rv += SDK_ASSERT(small.push(beamId, beamUpdate) == 0);
+  rv += SDK_ASSERT(small.push(platId + beamId + 100, update) == 0);
+  rv += SDK_ASSERT(small.drain(ds) == 1);
+  stats = small.statistics();
+  rv += SDK_ASSERT(stats.applied == 5);
+  rv += SDK_ASSERT(stats.rejected == 1);
+  rv += SDK_ASSERT(stats.highWaterMark == 4);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(platId)->numItems() == 4);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->numItems() == 1);
+  small.resetStatistics();
+  stats = small.statistics();
+  rv += SDK_ASSERT(stats.accepted == 0 && stats.dropped == 0 && stats.applied == 0 && stats.rejected == 0 && stats.highWaterMark == 0);
+
+  // Several producers feeding the data store while it updates; nothing is lost or duplicated
+  simData::IngestQueue queue(256);
+  ds.setIngestQueue(&queue);
+  rv += SDK_ASSERT(ds.ingestQueue() == &queue);
+  const int numProducers = 4;
+  const int perProducer = 2000;
+  std::vector<uint64_t> ids;
+  for (int p = 0; p < numProducers; ++p)
+    ids.push_back(helper.addPlatform());
+  std::atomic<int> producing(numProducers);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < numProducers; ++p)
+  {
+    const uint64_t id = ids[p];
+    producers.push_back(std::thread([&queue, &producing, id, perProducer]() {
+      simData::PlatformUpdate u;
+      for (int k = 0; k < perProducer; ++k)
+      {
+        u.set_time(k);
+        u.set_x(k);
+        // Back off while the queue is full instead of dropping
+        while (queue.push(id, u) != 0)
+          std::this_thread::yield();
+      }
+      --producing;
+    }));
+  }
+  double time = 0.0;
+  while (producing > 0)
+  {
+    ds.update(time);
+    time += 0.1;
+    std::this_thread::yield();
+  }
+  for (size_t k = 0; k < producers.size(); ++k)
+    producers[k].join();
+  ds.update(time + 1.0);
+
+  stats = queue.statistics();
+  rv += SDK_ASSERT(stats.accepted == static_cast<uint64_t>(numProducers * perProducer));
+  rv += SDK_ASSERT(stats.applied == stats.accepted);
+  rv += SDK_ASSERT(stats.highWaterMark <= queue.capacity());
+  for (int p = 0; p < numProducers; ++p)
+  {
+    const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(ids[p]);
+    rv += SDK_ASSERT(slice->numItems() == static_cast<size_t>(perProducer));
+    simData::PlatformUpdateSlice::Iterator iter = slice->lower_bound(0.0);
+    int expected = 0;
+    while (iter.hasNext())
+    {
+      const simData::PlatformUpdate* next = iter.next();
+      rv += SDK_ASSERT(next->time() == expected && next->x() == expected);
+      ++expected;
+    }
+  }
+
+  ds.setIngestQueue(nullptr);
+  return rv;
+}
+
+/// Concatenates the serialized form of each visited message
+template <typename VisitorType, typename T>
+class SerializingVisitor : public VisitorType
+{
+public:
+  explicit SerializingVisitor(std::string& out)
+    : out_(out)
+  {
+  }
+
+  virtual void operator()(const T* message)
+  {
+    out_ += message->SerializeAsString();
+  }
+
+private:
+  std::string& out_;
+};
+
+/// Returns the serialized contents of a slice
+template <typename T, typename SliceType>
+std::string serializeSlice(const SliceType* slice)
+{
+  std::string out;
+  if (slice == nullptr)
+    return out;
+  SerializingVisitor<typename SliceType::Visitor, T> visitor(out);
+  slice->visit(&visitor);
+  return out;
+}
+
+/// Formats every field of each visited platform update
+class PlatformUpdateFormatter : public simData::DataSlice<simData::PlatformUpdate>::Visitor
+{
+public:
+  explicit PlatformUpdateFormatter(std::ostringstream& os)
+    : os_(os)
+  {
+  }
+
+  virtual void operator()(const simData::PlatformUpdate* u)
+  {
+    os_ << u->time() << " " << u->x() << " " << u->y() << " " << u->z() << " " << u->psi() << " " << u->theta()
+      << " " << u->phi() << " " << u->vx() << " " << u->vy() << " " << u->vz() << "\n";
+  }
+
+private:
+  std::ostringstream& os_;
+};
+
+/// Formats the rows of a table, identifying cells by column name since column IDs may differ between stores
+class TableFormatter : public simData::DataTable::RowVisitor, public simData::TableRow::CellVisitor
+{
+public:
+  TableFormatter(const simData::DataTable& table, std::ostringstream& os)
+    : table_(table),
+      os_(os)
+  {
+  }
+
+  virtual VisitReturn visit(const simData::TableRow& row)
+  {
+    os_ << "row " << row.time() << ":";
+    row.accept(*this);
+    os_ << "\n";
+    return VISIT_CONTINUE;
+  }
+
+  virtual void visit(simData::TableColumnId id, uint8_t value) { cell_(id, static_cast<int>(value)); }
+  virtual void visit(simData::TableColumnId id, int8_t value) { cell_(id, static_cast<int>(value)); }
+  virtual void visit(simData::TableColumnId id, uint16_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, int16_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, uint32_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, int32_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, uint64_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, int64_t value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, float value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, double value) { cell_(id, value); }
+  virtual void visit(simData::TableColumnId id, const std::string& value) { cell_(id, value); }
+
+private:
+  template <typename T>
+  void cell_(simData::TableColumnId id, const T& value)
+  {
+    const simData::TableColumn* column = table_.column(id);
+    os_ << " " << column->name() << "/" << column->variableType() << "/" << column->unitType() << "=" << value;
+  }
+
+  const simData::DataTable& table_;
+  std::ostringstream& os_;
+};
+
+/// Formats the contents of a data store that a snapshot is expected to preserve
+std::string formatDataStore(simData::MemoryDataStore& ds)
+{
+  std::ostringstream os;
+  os.precision(17);
+  simData::DataStore::Transaction t;
+  os << ds.scenarioProperties(&t)->SerializeAsString() << "\n";
+
+  simData::DataStore::IdList ids;
+  ds.idList(&ids);
+  std::sort(ids.begin(), ids.end());
+  ids.insert(ids.begin(), 0);
+  for (simData::DataStore::IdList::const_iterator i = ids.begin(); i != ids.end(); ++i)
+  {
+    const uint64_t id = *i;
+    os << "entity " << id << " type " << ds.objectType(id) << "\n";
+    switch (ds.objectType(id))
+    {
+    case simData::PLATFORM:
+    {
+      os << ds.platformProperties(id, &t)->SerializeAsString() << ds.platformPrefs(id, &t)->SerializeAsString();
+      PlatformUpdateFormatter formatter(os);
+      ds.platformUpdateSlice(id)->visit(&formatter);
+      os << serializeSlice<simData::PlatformCommand>(ds.platformCommandSlice(id));
+      break;
+    }
+    case simData::BEAM:
+      os << ds.beamProperties(id, &t)->SerializeAsString() << ds.beamPrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::BeamUpdate>(ds.beamUpdateSlice(id)) << serializeSlice<simData::BeamCommand>(ds.beamCommandSlice(id));
+      break;
+    case simData::GATE:
+      os << ds.gateProperties(id, &t)->SerializeAsString() << ds.gatePrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::GateUpdate>(ds.gateUpdateSlice(id)) << serializeSlice<simData::GateCommand>(ds.gateCommandSlice(id));
+      break;
+    case simData::LASER:
+      os << ds.laserProperties(id, &t)->SerializeAsString() << ds.laserPrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::LaserUpdate>(ds.laserUpdateSlice(id)) << serializeSlice<simData::LaserCommand>(ds.laserCommandSlice(id));
+      break;
+    case simData::PROJECTOR:
+      os << ds.projectorProperties(id, &t)->SerializeAsString() << ds.projectorPrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::ProjectorUpdate>(ds.projectorUpdateSlice(id)) << serializeSlice<simData::ProjectorCommand>(ds.projectorCommandSlice(id));
+      break;
+    case simData::LOB_GROUP:
+      os << ds.lobGroupProperties(id, &t)->SerializeAsString() << ds.lobGroupPrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::LobGroupUpdate>(ds.lobGroupUpdateSlice(id)) << serializeSlice<simData::LobGroupCommand>(ds.lobGroupCommandSlice(id));
+      break;
+    case simData::CUSTOM_RENDERING:
+      os << ds.customRenderingProperties(id, &t)->SerializeAsString() << ds.customRenderingPrefs(id, &t)->SerializeAsString()
+        << serializeSlice<simData::CustomRenderingCommand>(ds.customRenderingCommandSlice(id));
+      break;
+    default:
+      break;
+    }
+    os << "\n" << serializeSlice<simData::GenericData>(ds.genericDataSlice(id));
+    if (id != 0)
+      os << serializeSlice<simData::CategoryData>(ds.categoryDataSlice(id));
+
+    const simData::TableList* tables = ds.dataTableManager().tablesForOwner(id);
+    if (tables == nullptr)
+      continue;
+    // Visit tables in name order
+    std::vector<std::string> names;
+    class NameCollector : public simData::TableList::Visitor
+    {
+    public:
+      explicit NameCollector(std::vector<std::string>& names) : names_(names) {}
+      virtual void visit(simData::DataTable* table) { names_.push_back(table->tableName()); }
+    private:
+      std::vector<std::string>& names_;
+    } nameCollector(names);
+    tables->accept(nameCollector);
+    std::sort(names.begin(), names.end());
+    for (std::vector<std::string>::const_iterator name = names.begin(); name != names.end(); ++name)
+    {
+      const simData::DataTable* table = tables->findTable(*name);
+      os << "table " << *name << " columns " << table->columnCount() << "\n";
+      TableFormatter formatter(*table, os);
+      table->accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), formatter);
+    }
+  }
+  return os.str();
+}
+
+int testSnapshot()
+{
+  int rv = 0;
+  const std::string filename = "TestMemoryDataStore.snapshot";
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  {
+    simData::DataStore::Transaction t;
+    simData::ScenarioProperties* props = ds.mutable_scenarioProperties(&t);
+    props->set_description("Snapshot test");
+    props->set_referenceyear(2010);
+    t.commit();
+  }
+
+  const uint64_t platId = helper.addPlatform(11);
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+  const uint64_t laserId = helper.addLaser(platId);
+  const uint64_t projectorId = helper.addProjector(platId);
+  const uint64_t lobId = helper.addLOB(platId);
+  const uint64_t customId = helper.addCustomRendering(platId);
+  // Removed entity leaves a gap in the IDs
+  const uint64_t removedId = helper.addPlatform();
+  ds.removeEntity(removedId);
+  const uint64_t plat2Id = helper.addPlatform(22);
+
+  simData::PlatformPrefs platPrefs;
+  platPrefs.mutable_commonprefs()->set_name("Snapshot Platform");
+  platPrefs.set_icon("icon.png");
+  helper.updatePlatformPrefs(platPrefs, platId);
+
+  for (int k = 0; k < 50; ++k)
+  {
+    const double time = 0.5 * k;
+    helper.addPlatformUpdate(time, platId);
+    helper.addBeamUpdate(time, beamId);
+    helper.addGateUpdate(time, gateId);
+    helper.addLaserUpdate(time, laserId);
+    helper.addProjectorUpdate(time, projectorId);
+    helper.addLOBUpdate(time, lobId);
+  }
+  {
+    // Orientation, velocity and an unset field are preserved exactly
+    simData::DataStore::Transaction t;
+    simData::PlatformUpdate* u = ds.addPlatformUpdate(plat2Id, &t);
+    u->set_time(3.25);
+    u->set_x(1.0 / 3.0);
+    u->set_y(-7.5);
+    u->set_psi(0.1);
+    u->set_theta(-0.2);
+    u->set_phi(0.3);
+    u->set_vx(10.1);
+    u->set_vy(-20.2);
+    u->set_vz(30.3);
+    t.commit();
+  }
+
+  simData::PlatformCommand platCommand;
+  platCommand.set_time(2.0);
+  platCommand.mutable_updateprefs()->set_icon("command.png");
+  helper.addPlatformCommand(platCommand, platId);
+  simData::BeamCommand beamCommand;
+  beamCommand.set_time(1.0);
+  beamCommand.mutable_updateprefs()->set_horizontalwidth(0.25);
+  helper.addBeamCommand(beamCommand, beamId);
+  simData::CustomRenderingCommand customCommand;
+  customCommand.set_time(1.5);
+  customCommand.mutable_updateprefs()->set_persistence(12.5);
+  helper.addCustomRenderingCommand(customCommand, customId);
+
+  helper.addGenericData(platId, "key1", "value1", 1.0);
+  helper.addGenericData(platId, "key1", "value2", 2.0);
+  helper.addGenericData(platId, "key2", "value3", 2.0);
+  helper.addGenericData(0, "scenarioKey", "scenarioValue", 4.0);
+  helper.addCategoryData(platId, "category1", "valueA", 1.0);
+  helper.addCategoryData(platId, "category1", "valueB", 3.0);
+  helper.addCategoryData(beamId, "category2", "valueC", 0.0);
+
+  helper.addDataTable(platId, 5);
+  helper.addDataTable(beamId, 3);
+  {
+    // Scenario table with string and unsigned columns
+    simData::DataTable* table = nullptr;
+    rv += SDK_ASSERT(!ds.dataTableManager().addDataTable(0, "Scenario Table", &table).isError());
+    simData::TableColumn* strings = nullptr;
+    simData::TableColumn* counts = nullptr;
+    rv += SDK_ASSERT(!table->addColumn("Strings", simData::VT_STRING, 3, &strings).isError());
+    rv += SDK_ASSERT(!table->addColumn("Counts", simData::VT_UINT64, 0, &counts).isError());
+    simData::TableRow row;
+    row.setTime(1.0);
+    row.setValue(strings->columnId(), std::string("first"));
+    row.setValue(counts->columnId(), static_cast<uint64_t>(1) << 40);
+    rv += SDK_ASSERT(!table->addRow(row).isError());
+    row.clear();
+    row.setTime(2.0);
+    row.setValue(strings->columnId(), std::string());
+    rv += SDK_ASSERT(!table->addRow(row).isError());
+  }
+  ds.update(10.0);
+
+  const std::string expected = formatDataStore(ds);
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::save(ds, filename) == 0);
+
+  // Restoring replaces existing contents
+  simData::MemoryDataStore restored;
+  simUtil::DataStoreTestHelper restoredHelper(&restored);
+  const uint64_t oldId = restoredHelper.addPlatform();
+  restoredHelper.addPlatformUpdate(100.0, oldId);
+  restoredHelper.addGenericData(0, "oldKey", "oldValue", 1.0);
+  restoredHelper.addDataTable(0, 2, "Old Table");
+
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(restored, filename) == 0);
+  rv += SDK_ASSERT(formatDataStore(restored) == expected);
+  rv += SDK_ASSERT(restored.platformUpdateSlice(platId)->numItems() == 50);
+  rv += SDK_ASSERT(restored.dataTableManager().findTable(0, "Old Table") == nullptr);
+
+  // Loaded data updates like the original
+  restored.update(10.0);
+  rv += SDK_ASSERT(restored.platformUpdateSlice(platId)->current() != nullptr);
+  rv += SDK_ASSERT(restored.platformUpdateSlice(platId)->current()->time() == 10.0);
+  simData::DataStore::Transaction t;
+  rv += SDK_ASSERT(restored.platformPrefs(platId, &t)->icon() == "command.png");
+  rv += SDK_ASSERT(simData::DataStoreHelpers::nameFromId(platId, &restored) == "Snapshot Platform");
+  // New entities do not reuse loaded IDs
+  rv += SDK_ASSERT(restoredHelper.addPlatform() > plat2Id);
+
+  // Snapshot of the restored store restores the same contents
+  const std::string filename2 = "TestMemoryDataStore2.snapshot";
+  simData::MemoryDataStore twice;
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::save(restored, filename2) == 0);
+  // Settings carry over to a replacement store through the internals memento, not the snapshot
+  simData::PlatformPrefs defaultPrefs;
+  defaultPrefs.set_scale(3.0);
+  static_cast<simData::DataStore&>(restored).setDefaultPrefs(defaultPrefs);
+  std::unique_ptr<simData::DataStore::InternalsMemento> memento(restored.createInternalsMemento());
+  memento->apply(twice);
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(twice, filename2) == 0);
+  twice.update(10.0);
+  rv += SDK_ASSERT(twice.platformUpdateSlice(platId)->numItems() == 50);
+  rv += SDK_ASSERT(twice.dataTableManager().tableCount() == 3);
+  simUtil::DataStoreTestHelper twiceHelper(&twice);
+  const uint64_t newId = twiceHelper.addPlatform();
+  rv += SDK_ASSERT(twice.platformPrefs(newId, &t)->scale() == 3.0);
+
+  std::ifstream file1(filename.c_str(), std::ios::binary);
+  const std::string contents((std::istreambuf_iterator<char>(file1)), std::istreambuf_iterator<char>());
+  file1.close();
+  rv += SDK_ASSERT(contents.size() > 24);
+
+  // Bad magic, unsupported version, truncation and missing files are rejected
+  simData::MemoryDataStore bad;
+  std::string corrupt = contents;
+  corrupt[0] = 'X';
+  std::ofstream(filename2.c_str(), std::ios::binary | std::ios::trunc).write(corrupt.data(), corrupt.size());
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(bad, filename2) != 0);
+  corrupt = contents;
+  corrupt[8] = static_cast<char>(simData::MemoryDataStoreSnapshot::VERSION + 1);
+  std::ofstream(filename2.c_str(), std::ios::binary | std::ios::trunc).write(corrupt.data(), corrupt.size());
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(bad, filename2) != 0);
+  for (size_t size = 4; size < contents.size(); size += contents.size() / 7)
+  {
+    std::ofstream(filename2.c_str(), std::ios::binary | std::ios::trunc).write(contents.data(), size);
+    simData::MemoryDataStore truncated;
+    rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(truncated, filename2) != 0);
+  }
+  rv += SDK_ASSERT(simData::MemoryDataStoreSnapshot::load(bad, "TestMemoryDataStoreMissing.snapshot") != 0);
+
+  std::remove(filename.c_str());
+  std::remove(filename2.c_str());
+  return rv;
+}
+
+int testChangedIdList()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t plat1Id = helper.addPlatform();
+  const uint64_t plat2Id = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(plat1Id);
+  const uint64_t plat3Id = helper.addPlatform();
+  helper.addPlatformUpdate(1.0, plat1Id);
+  helper.addPlatformUpdate(2.0, plat1Id);
+  helper.addPlatformUpdate(-1.0, plat2Id);
+  helper.addPlatformUpdate(1.0, plat3Id);
+  helper.addPlatformUpdate(10.0, plat3Id);
+  helper.addBeamUpdate(1.0, beamId);
+
+  // Nothing has been updated yet
+  simData::DataStore::IdList ids;
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+
+  // Everything becomes current on the first update, reported in ID order
+  ds.update(1.0);
+  ds.changedIdList(&ids);
+  simData::DataStore::IdList expected;
+  expected.push_back(plat1Id);
+  expected.push_back(plat2Id);
+  expected.push_back(beamId);
+  expected.push_back(plat3Id);
+  rv += SDK_ASSERT(ids == expected);
+
+  // Existing contents are kept
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 2 * expected.size());
+
+  // Repeating the same time with no new data changes nothing
+  ds.update(1.0);
+  ids.clear();
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+
+  // Only the platform with a new point changes; the static platform and the platform between points do not
+  ds.update(2.0);
+  ids.clear();
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 1 && ids[0] == plat1Id);
+
+  // New data at the current time dirties the slice
+  helper.addPlatformUpdate(2.0, plat3Id);
+  ds.update(2.0);
+  ids.clear();
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 1 && ids[0] == plat3Id);
+
+  // Removed entities are not reported by later updates
+  ds.removeEntity(plat3Id);
+  ds.update(0.5);
+  ids.clear();
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(std::find(ids.begin(), ids.end(), plat3Id) == ids.end());
+  rv += SDK_ASSERT(std::find(ids.begin(), ids.end(), plat1Id) != ids.end());
+
+  ds.clear();
+  ids.clear();
+  ds.changedIdList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+  return rv;
+}
+
 int TestMemoryDataStore(int argc, char* argv[])
 {
   simCore::checkVersionThrow();
@@ -1555,6 +2263,10 @@ int TestMemoryDataStore(int argc, char* argv[])
     rv += testCategoryData_change();
     rv += testScenarioDeleteCallback();
     rv += testUpdateToNonCurrentTime();
+    rv += testUpdateThreads();
+    rv += testIngestQueue();
+    rv += testSnapshot();
+    rv += testChangedIdList();
     return rv;
   }
   catch (MemDataStoreAssertException& e)
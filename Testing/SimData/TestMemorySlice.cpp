@@ -22,6 +22,10 @@
  */
 
 #include "simCore/Common/SDKAssert.h"
+#include "simData/ColumnarPlatformSlice.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/UpdatePool.h"
 #include "simUtil/DataStoreTestHelper.h"
 
 namespace
@@ -192,6 +196,374 @@ int testStaticPlatformUpdates()
   return rv;
 }
 
+int testUpdatePool()
+{
+  int rv = 0;
+
+  simData::UpdatePool<simData::BeamUpdate> pool;
+  rv += SDK_ASSERT(pool.numUpdates() == 0);
+  rv += SDK_ASSERT(pool.numChunks() == 0);
+
+  // Allocate enough to span several chunks
+  std::vector<simData::BeamUpdate*> updates;
+  for (size_t k = 0; k < 200; ++k)
+  {
+    simData::BeamUpdate* update = pool.allocate();
+    update->set_time(static_cast<double>(k));
+    updates.push_back(update);
+  }
+  rv += SDK_ASSERT(pool.numUpdates() == 200);
+  // 16 + 32 + 64 + 128 slots
+  rv += SDK_ASSERT(pool.numChunks() == 4);
+  rv += SDK_ASSERT(pool.owns(updates.front()));
+  rv += SDK_ASSERT(pool.owns(updates.back()));
+  rv += SDK_ASSERT(updates[150]->time() == 150.0);
+
+  // Heap allocations are not owned, and are deleted on release
+  simData::BeamUpdate* heapUpdate = new simData::BeamUpdate;
+  rv += SDK_ASSERT(!pool.owns(heapUpdate));
+  pool.release(heapUpdate);
+  rv += SDK_ASSERT(pool.numUpdates() == 200);
+
+  // Releasing part of the first chunk keeps it
+  for (size_t k = 0; k < 15; ++k)
+    pool.release(updates[k]);
+  rv += SDK_ASSERT(pool.numChunks() == 4);
+  // Releasing the last update in the first chunk frees it
+  pool.release(updates[15]);
+  rv += SDK_ASSERT(pool.numChunks() == 3);
+  rv += SDK_ASSERT(pool.numUpdates() == 184);
+
+  // Release the rest; the partially filled current chunk is kept for reuse
+  for (size_t k = 16; k < updates.size(); ++k)
+    pool.release(updates[k]);
+  rv += SDK_ASSERT(pool.numUpdates() == 0);
+  rv += SDK_ASSERT(pool.numChunks() == 1);
+
+  return rv;
+}
+
+int testPooledPlatformUpdates()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t id1 = helper.addPlatform();
+  rv += SDK_ASSERT(!ds.pooledUpdateAllocation());
+  helper.addPlatformUpdate(0.0, id1);
+
+  // Switching modes applies to existing and new entities, mixing heap and pooled updates
+  ds.setPooledUpdateAllocation(true);
+  rv += SDK_ASSERT(ds.pooledUpdateAllocation());
+  const uint64_t id2 = helper.addPlatform();
+  for (int k = 1; k <= 100; ++k)
+  {
+    helper.addPlatformUpdate(static_cast<double>(k), id1);
+    helper.addPlatformUpdate(static_cast<double>(k), id2);
+  }
+
+  const simData::PlatformUpdateSlice* slice1 = ds.platformUpdateSlice(id1);
+  const simData::PlatformUpdateSlice* slice2 = ds.platformUpdateSlice(id2);
+  rv += SDK_ASSERT(slice1->numItems() == 101);
+  rv += SDK_ASSERT(slice2->numItems() == 100);
+
+  // Duplicate time replaces the pooled update
+  addPlatformUpdate(&ds, id2, 50.0, 500.0, 0.0, 0.0);
+  rv += SDK_ASSERT(slice2->numItems() == 100);
+  ds.update(50.0);
+  rv += SDK_ASSERT(slice2->current() != nullptr && slice2->current()->x() == 500.0);
+  rv += SDK_ASSERT(slice1->current() != nullptr && slice1->current()->x() == 50.0);
+
+  // Uncommitted transactions return their update to the pool
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformUpdate* u = ds.addPlatformUpdate(id2, &t);
+    rv += SDK_ASSERT(u != nullptr);
+    u->set_time(1000.0);
+  }
+  rv += SDK_ASSERT(slice2->numItems() == 100);
+
+  // Data limiting releases from the front of the pool
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_datalimitpoints(10);
+  helper.updatePlatformPrefs(prefs, id1);
+  helper.updatePlatformPrefs(prefs, id2);
+  ds.setDataLimiting(true);
+  helper.addPlatformUpdate(101.0, id1);
+  helper.addPlatformUpdate(101.0, id2);
+  rv += SDK_ASSERT(slice1->numItems() == 10);
+  rv += SDK_ASSERT(slice2->numItems() == 10);
+  rv += SDK_ASSERT(slice1->firstTime() == 92.0);
+  rv += SDK_ASSERT(slice2->firstTime() == 92.0);
+  ds.update(95.0);
+  rv += SDK_ASSERT(slice2->current() != nullptr && slice2->current()->x() == 95.0);
+
+  // Flush releases everything, with and without the pool enabled
+  ds.setPooledUpdateAllocation(false);
+  ds.flush(id1);
+  ds.flush(id2);
+  rv += SDK_ASSERT(slice1->numItems() == 0);
+  rv += SDK_ASSERT(slice2->numItems() == 0);
+
+  // Beams and LOB groups use protobuf updates; LOB groups merge updates at the same time
+  ds.setPooledUpdateAllocation(true);
+  const uint64_t beamId = helper.addBeam(id1);
+  const uint64_t lobId = helper.addLOB(id1);
+  for (int k = 0; k < 50; ++k)
+  {
+    helper.addBeamUpdate(static_cast<double>(k), beamId);
+    helper.addLOBUpdate(static_cast<double>(k), lobId);
+  }
+  helper.addLOBUpdate(10.0, lobId);
+  ds.update(10.0);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->numItems() == 50);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->current()->range() == 12.0);
+  rv += SDK_ASSERT(ds.lobGroupUpdateSlice(lobId)->numItems() == 50);
+  ds.flush(0, simData::DataStore::RECURSIVE);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->numItems() == 0);
+  rv += SDK_ASSERT(ds.lobGroupUpdateSlice(lobId)->numItems() == 0);
+
+  return rv;
+}
+
+simData::PlatformUpdate makePlatformUpdate(double time)
+{
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  update.set_x(time * 10.0);
+  update.set_y(time * 20.0);
+  update.set_z(time * 30.0);
+  update.set_psi(0.01 * time);
+  update.set_theta(0.02 * time);
+  update.set_phi(0.03 * time);
+  update.set_vx(time);
+  update.set_vy(-time);
+  update.set_vz(2.0 * time);
+  return update;
+}
+
+bool sameUpdate(const simData::PlatformUpdate* u1, const simData::PlatformUpdate* u2)
+{
+  if (u1 == nullptr || u2 == nullptr)
+    return u1 == u2;
+  return u1->time() == u2->time() && u1->x() == u2->x() && u1->y() == u2->y() && u1->z() == u2->z() &&
+    u1->psi() == u2->psi() && u1->theta() == u2->theta() && u1->phi() == u2->phi() &&
+    u1->vx() == u2->vx() && u1->vy() == u2->vy() && u1->vz() == u2->vz();
+}
+
+/** Returns 0 if the two slices return the same values for bounds and time updates */
+int compareSlices(simData::MemoryDataSlice<simData::PlatformUpdate>& memory, simData::ColumnarPlatformSlice& columnar, simData::Interpolator* interpolator)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(memory.numItems() == columnar.numItems());
+  rv += SDK_ASSERT(memory.firstTime() == columnar.firstTime());
+  rv += SDK_ASSERT(memory.lastTime() == columnar.lastTime());
+
+  for (double time = -2.0; time <= 62.0; time += 0.25)
+  {
+    simData::PlatformUpdateSlice::Iterator memIter = memory.lower_bound(time);
+    simData::PlatformUpdateSlice::Iterator colIter = columnar.lower_bound(time);
+    rv += SDK_ASSERT(sameUpdate(memIter.peekPrevious(), colIter.peekPrevious()));
+    rv += SDK_ASSERT(sameUpdate(memIter.peekNext(), colIter.peekNext()));
+
+    memIter = memory.upper_bound(time);
+    colIter = columnar.upper_bound(time);
+    // Both pointers from the iterator remain valid
+    const simData::PlatformUpdate* colPrev = colIter.peekPrevious();
+    const simData::PlatformUpdate* colNext = colIter.peekNext();
+    rv += SDK_ASSERT(sameUpdate(memIter.peekPrevious(), colPrev));
+    rv += SDK_ASSERT(sameUpdate(memIter.peekNext(), colNext));
+    rv += SDK_ASSERT(memory.deltaTime(time) == columnar.deltaTime(time));
+
+    memory.update(time, interpolator);
+    columnar.update(time, interpolator);
+    rv += SDK_ASSERT(sameUpdate(memory.current(), columnar.current()));
+    rv += SDK_ASSERT(memory.isInterpolated() == columnar.isInterpolated());
+    rv += SDK_ASSERT(memory.hasChanged() == columnar.hasChanged());
+    if (columnar.isInterpolated())
+    {
+      rv += SDK_ASSERT(sameUpdate(memory.interpolationBounds().first, columnar.interpolationBounds().first));
+      rv += SDK_ASSERT(sameUpdate(memory.interpolationBounds().second, columnar.interpolationBounds().second));
+    }
+  }
+
+  // Scrub backwards without interpolation
+  for (double time = 62.0; time >= -2.0; time -= 0.5)
+  {
+    memory.update(time);
+    columnar.update(time);
+    rv += SDK_ASSERT(sameUpdate(memory.current(), columnar.current()));
+    rv += SDK_ASSERT(memory.hasChanged() == columnar.hasChanged());
+  }
+  return rv;
+}
+
+int testColumnarPlatformSlice()
+{
+  int rv = 0;
+
+  simData::MemoryDataSlice<simData::PlatformUpdate> memory;
+  simData::ColumnarPlatformSlice columnar;
+  simData::LinearInterpolator interpolator;
+
+  // Empty slices
+  rv += compareSlices(memory, columnar, &interpolator);
+  rv += SDK_ASSERT(columnar.times() == nullptr);
+
+  // Even times in order, then odd times out of order, then a replacement
+  for (int k = 0; k <= 60; k += 2)
+  {
+    memory.insert(new simData::PlatformUpdate(makePlatformUpdate(k)));
+    columnar.insert(makePlatformUpdate(k));
+  }
+  for (int k = 59; k > 0; k -= 6)
+  {
+    memory.insert(new simData::PlatformUpdate(makePlatformUpdate(k)));
+    columnar.insert(makePlatformUpdate(k));
+  }
+  simData::PlatformUpdate replacement = makePlatformUpdate(20.0);
+  replacement.set_x(-1.0);
+  memory.insert(new simData::PlatformUpdate(replacement));
+  columnar.insert(replacement);
+  rv += compareSlices(memory, columnar, &interpolator);
+
+  // Columns are contiguous and time sorted
+  rv += SDK_ASSERT(columnar.numItems() == 41);
+  const double* times = columnar.times();
+  for (size_t k = 1; k < columnar.numItems(); ++k)
+    rv += SDK_ASSERT(times[k - 1] < times[k]);
+  simData::PlatformUpdate update;
+  rv += SDK_ASSERT(columnar.get(5, &update) == 0);
+  rv += SDK_ASSERT(update.time() == times[5] && update.x() == columnar.x()[5] && update.vz() == columnar.vz()[5]);
+  rv += SDK_ASSERT(columnar.get(41, &update) != 0);
+
+  // Unset fields survive the round trip
+  simData::PlatformUpdate positionOnly;
+  positionOnly.set_time(100.0);
+  positionOnly.set_x(1.0);
+  positionOnly.set_y(2.0);
+  positionOnly.set_z(3.0);
+  columnar.insert(positionOnly);
+  memory.insert(new simData::PlatformUpdate(positionOnly));
+  rv += SDK_ASSERT(columnar.get(41, &update) == 0);
+  rv += SDK_ASSERT(update.has_position() && !update.has_orientation() && !update.has_velocity());
+
+  // Data limiting and flushing
+  memory.limitByPoints(30);
+  columnar.limitByPoints(30);
+  rv += compareSlices(memory, columnar, &interpolator);
+  memory.limitByTime(70.0);
+  columnar.limitByTime(70.0);
+  rv += compareSlices(memory, columnar, &interpolator);
+  memory.flush(40.0, 50.0);
+  columnar.flush(40.0, 50.0);
+  rv += compareSlices(memory, columnar, &interpolator);
+  memory.flush();
+  columnar.flush();
+  rv += compareSlices(memory, columnar, &interpolator);
+
+  // Static platforms are kept by flush
+  simData::PlatformUpdate staticUpdate = makePlatformUpdate(-1.0);
+  memory.insert(new simData::PlatformUpdate(staticUpdate));
+  columnar.insert(staticUpdate);
+  memory.flush();
+  columnar.flush();
+  rv += SDK_ASSERT(columnar.numItems() == 1);
+  rv += compareSlices(memory, columnar, &interpolator);
+
+  // Deferred front removal compacts the columns once enough points are removed
+  columnar.flush(false);
+  for (int k = 0; k < 5000; ++k)
+  {
+    columnar.insert(makePlatformUpdate(k));
+    columnar.limitByPoints(100);
+  }
+  rv += SDK_ASSERT(columnar.numItems() == 100);
+  rv += SDK_ASSERT(columnar.firstTime() == 4900.0);
+  rv += SDK_ASSERT(columnar.times()[99] == 4999.0);
+  columnar.update(4950.5, &interpolator);
+  rv += SDK_ASSERT(columnar.isInterpolated() && columnar.current()->time() == 4950.5);
+  rv += SDK_ASSERT(columnar.interpolationBounds().first->time() == 4950.0);
+  rv += SDK_ASSERT(columnar.interpolationBounds().second->time() == 4951.0);
+
+  return rv;
+}
+
+/** Returns an update for the given time whose x value identifies the batch it came from */
+simData::PlatformUpdate* newMarkedUpdate(simData::MemoryDataSlice<simData::PlatformUpdate>& slice, double time, double marker)
+{
+  simData::PlatformUpdate* update = slice.newUpdate();
+  *update = makePlatformUpdate(time);
+  update->set_x(marker);
+  return update;
+}
+
+int testInsertBatch()
+{
+  int rv = 0;
+
+  simData::MemoryDataSlice<simData::PlatformUpdate> batched;
+  simData::MemoryDataSlice<simData::PlatformUpdate> reference;
+  std::vector<simData::PlatformUpdate*> batch;
+  batched.insertBatch(batch);
+  rv += SDK_ASSERT(batched.numItems() == 0);
+
+  // Out of order batch into an empty slice, with two updates at time 3
+  const double firstTimes[] = { 5.0, 1.0, 3.0, 9.0, 3.0, 7.0 };
+  for (size_t k = 0; k < sizeof(firstTimes) / sizeof(firstTimes[0]); ++k)
+  {
+    batch.push_back(newMarkedUpdate(batched, firstTimes[k], k));
+    reference.insert(newMarkedUpdate(reference, firstTimes[k], k));
+  }
+  batched.insertBatch(batch);
+  rv += SDK_ASSERT(batch.empty());
+  rv += SDK_ASSERT(batched.numItems() == 5);
+
+  // Current value is replaced by the next batch
+  batched.update(5.0);
+  reference.update(5.0);
+  rv += SDK_ASSERT(batched.current() != nullptr && batched.current()->x() == 0.0);
+
+  // Batch that overlaps and interleaves with the existing updates, and extends past them
+  const double secondTimes[] = { 12.0, 4.0, 5.0, 0.5, 9.0, 10.0, 4.0 };
+  for (size_t k = 0; k < sizeof(secondTimes) / sizeof(secondTimes[0]); ++k)
+  {
+    batch.push_back(newMarkedUpdate(batched, secondTimes[k], 100 + k));
+    reference.insert(newMarkedUpdate(reference, secondTimes[k], 100 + k));
+  }
+  batched.insertBatch(batch);
+  rv += SDK_ASSERT(batched.current() == nullptr);
+
+  // Batch that follows all existing updates
+  for (int k = 20; k > 13; --k)
+  {
+    batch.push_back(newMarkedUpdate(batched, k, 200 + k));
+    reference.insert(newMarkedUpdate(reference, k, 200 + k));
+  }
+  batched.insertBatch(batch);
+
+  // Same contents as inserting one at a time
+  rv += SDK_ASSERT(batched.numItems() == reference.numItems());
+  simData::PlatformUpdateSlice::Iterator batchedIter = batched.lower_bound(-1.0);
+  simData::PlatformUpdateSlice::Iterator referenceIter = reference.lower_bound(-1.0);
+  while (referenceIter.hasNext())
+  {
+    rv += SDK_ASSERT(batchedIter.hasNext());
+    rv += SDK_ASSERT(sameUpdate(batchedIter.next(), referenceIter.next()));
+  }
+  rv += SDK_ASSERT(!batchedIter.hasNext());
+
+  // Time updates find the merged values
+  for (double time = 0.0; time < 21.0; time += 0.5)
+  {
+    batched.update(time);
+    reference.update(time);
+    rv += SDK_ASSERT(sameUpdate(batched.current(), reference.current()));
+  }
+  return rv;
+}
+
 }
 
 int TestMemorySlice(int argc, char* argv[])
@@ -201,6 +573,10 @@ int TestMemorySlice(int argc, char* argv[])
   rv += testDeltaTime();
   rv += duplicatePoints();
   rv += testStaticPlatformUpdates();
+  rv += testUpdatePool();
+  rv += testPooledPlatformUpdates();
+  rv += testColumnarPlatformSlice();
+  rv += testInsertBatch();
 
   return rv;
 }
@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simData/DataTypes.h"
@@ -215,6 +216,93 @@ int testMessageVisitor()
 
   return rv;
 }
+
+int testCopyChangedFields()
+{
+  int rv = 0;
+  simData::PlatformPrefs current;
+  current.mutable_commonprefs()->set_name("plat");
+  current.mutable_commonprefs()->set_color(0xff0000ff);
+  current.set_icon("icon");
+  current.add_gogfile("abcd");
+
+  // identical messages have no changes, and nothing is reported
+  simData::PlatformPrefs modified(current);
+  std::vector<std::string> changed;
+  rv += SDK_ASSERT(!simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.empty());
+
+  // setting a field to the value it already has is not a change
+  modified.set_icon("icon");
+  rv += SDK_ASSERT(!simData::protobuf::copyChangedFields(modified, current, &changed));
+
+  // leaf fields in sub-messages are reported by full path
+  modified.mutable_commonprefs()->set_color(0x00ff00ff);
+  modified.set_brightness(28);
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 2);
+  rv += SDK_ASSERT(std::find(changed.begin(), changed.end(), "commonPrefs.color") != changed.end());
+  rv += SDK_ASSERT(std::find(changed.begin(), changed.end(), "brightness") != changed.end());
+  rv += SDK_ASSERT(current.SerializeAsString() == modified.SerializeAsString());
+
+  // presence matters: explicitly setting a default value is a change, as is clearing it
+  changed.clear();
+  modified.mutable_commonprefs()->set_draw(modified.commonprefs().draw());
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 1 && changed[0] == "commonPrefs.draw");
+  rv += SDK_ASSERT(current.commonprefs().has_draw());
+  changed.clear();
+  modified.mutable_commonprefs()->clear_draw();
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 1 && changed[0] == "commonPrefs.draw");
+  rv += SDK_ASSERT(!current.commonprefs().has_draw());
+
+  // added and removed sub-messages are reported by their own path
+  changed.clear();
+  modified.mutable_trackprefs()->set_linewidth(1.76);
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 1 && changed[0] == "trackPrefs");
+  rv += SDK_ASSERT(current.trackprefs().linewidth() == 1.76);
+  changed.clear();
+  modified.clear_trackprefs();
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 1 && changed[0] == "trackPrefs");
+  rv += SDK_ASSERT(!current.has_trackprefs());
+
+  // repeated fields are compared and copied as a whole
+  changed.clear();
+  modified.add_gogfile("efgh");
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(changed.size() == 1 && changed[0] == "gogFile");
+  rv += SDK_ASSERT(current.gogfile_size() == 2 && current.gogfile(1) == "efgh");
+  changed.clear();
+  modified.set_gogfile(0, "wxyz");
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, &changed));
+  rv += SDK_ASSERT(current.gogfile(0) == "wxyz");
+
+  // result always matches a full copy
+  rv += SDK_ASSERT(current.SerializeAsString() == modified.SerializeAsString());
+
+  // list is optional
+  modified.set_brightness(30);
+  rv += SDK_ASSERT(simData::protobuf::copyChangedFields(modified, current, nullptr));
+  rv += SDK_ASSERT(current.brightness() == 30);
+
+  // containsField() matches the path, its parents and its children, on "." boundaries
+  std::vector<std::string> fields;
+  fields.push_back("commonPrefs.color");
+  fields.push_back("trackPrefs");
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields, "commonPrefs.color"));
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields, "commonPrefs"));
+  rv += SDK_ASSERT(simData::protobuf::containsField(fields, "trackPrefs.lineWidth"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(fields, "commonPrefs.draw"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(fields, "commonPrefs.colorx"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(fields, "trackPrefsx"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(fields, "brightness"));
+  rv += SDK_ASSERT(!simData::protobuf::containsField(std::vector<std::string>(), "brightness"));
+
+  return rv;
+}
 }
 
 int TestMessageVisitor(int argc, char* argv[])
@@ -223,5 +311,6 @@ int TestMessageVisitor(int argc, char* argv[])
   rv += testGetField();
   rv += testClearField();
   rv += testMessageVisitor();
+  rv += testCopyChangedFields();
   return rv;
 }
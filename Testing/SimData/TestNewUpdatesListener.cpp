@@ -488,6 +488,62 @@ int testIgnoresCategoryData()
   return rv;
 }
 
+int testBatchPlatformUpdates()
+{
+  simUtil::DataStoreTestHelper helper;
+  simData::DataStore* ds = helper.dataStore();
+  std::shared_ptr<TimeCollector> timeCollector(new TimeCollector);
+  ds->setNewUpdatesListener(timeCollector);
+  simData::ObjectId plat1 = helper.addPlatform(1);
+
+  std::vector<simData::PlatformUpdate> updates;
+  int rv = 0;
+  // Unknown entity is an error; empty batch is not
+  rv += SDK_ASSERT(ds->addPlatformUpdates(plat1 + 10, updates) != 0);
+  rv += SDK_ASSERT(ds->addPlatformUpdates(plat1, updates) == 0);
+  rv += SDK_ASSERT(timeCollector->getTimes(plat1).empty());
+
+  const double times[] = { 4.0, 2.0, 3.0, 1.0, 5.0 };
+  for (size_t k = 0; k < sizeof(times) / sizeof(times[0]); ++k)
+  {
+    simData::PlatformUpdate update;
+    update.set_time(times[k]);
+    update.set_x(times[k]);
+    updates.push_back(update);
+  }
+  rv += SDK_ASSERT(ds->addPlatformUpdates(plat1, updates) == 0);
+
+  // One notification each for the earliest and latest times
+  TimeCollector::Timestamps p1Times = timeCollector->getTimes(plat1);
+  rv += SDK_ASSERT(p1Times.size() == 2);
+  rv += SDK_ASSERT(p1Times.count(1.0) != 0);
+  rv += SDK_ASSERT(p1Times.count(5.0) != 0);
+
+  const simData::PlatformUpdateSlice* slice = ds->platformUpdateSlice(plat1);
+  rv += SDK_ASSERT(slice->numItems() == 5);
+  rv += SDK_ASSERT(slice->firstTime() == 1.0);
+  rv += SDK_ASSERT(slice->lastTime() == 5.0);
+  ds->update(3.0);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->x() == 3.0);
+
+  // Data limiting is applied to the batch
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_datalimitpoints(3);
+  helper.updatePlatformPrefs(prefs, plat1);
+  ds->setDataLimiting(true);
+  updates.clear();
+  for (int k = 6; k <= 10; ++k)
+  {
+    simData::PlatformUpdate update;
+    update.set_time(k);
+    updates.push_back(update);
+  }
+  rv += SDK_ASSERT(ds->addPlatformUpdates(plat1, updates) == 0);
+  rv += SDK_ASSERT(slice->numItems() == 3);
+  rv += SDK_ASSERT(slice->firstTime() == 8.0);
+  return rv;
+}
+
 }
 
 int TestNewUpdatesListener(int argc, char* argv[])
@@ -497,5 +553,6 @@ int TestNewUpdatesListener(int argc, char* argv[])
   rv += SDK_ASSERT(testDataTableCollection() == 0);
   rv += SDK_ASSERT(testDataStoreProxy() == 0);
   rv += SDK_ASSERT(testIgnoresCategoryData() == 0);
+  rv += SDK_ASSERT(testBatchPlatformUpdates() == 0);
   return rv;
 }
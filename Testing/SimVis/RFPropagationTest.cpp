@@ -0,0 +1,422 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include "osg/Group"
+#include "osg/ref_ptr"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/DatumConvert.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Calc/MathConstants.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/EM/Decibel.h"
+#include "simCore/EM/Propagation.h"
+#include "simCore/LUT/LUT2.h"
+#include "simCore/Time/Utils.h"
+#include "simVis/RFProp/ArepsLoader.h"
+#include "simVis/RFProp/CompositeProfileProvider.h"
+#include "simVis/RFProp/LUTProfileDataProvider.h"
+#include "simVis/RFProp/Profile.h"
+#include "simVis/RFProp/RFPropagationFacade.h"
+
+namespace
+{
+
+const double MAX_HEIGHT = 3000.0;
+const double MAX_RANGE = 100000.0;
+const double BEAM_WIDTH_DEG = 2.0;
+
+/** Creates a table of smoothly varying values, in tenths of a dB, that differs by bearing */
+simCore::LUT::LUT2<short>* makeTable(double bearingDeg, double offset)
+{
+  const size_t numHeights = 101;
+  const size_t numRanges = 1001;
+  simCore::LUT::LUT2<short>* lut = new simCore::LUT::LUT2<short>();
+  lut->initialize(0.0, MAX_HEIGHT, numHeights, 0.0, MAX_RANGE, numRanges);
+  for (size_t h = 0; h < numHeights; ++h)
+  {
+    for (size_t r = 0; r < numRanges; ++r)
+    {
+      const double value = offset - 0.5 * r - 20.0 * sin(0.05 * h + bearingDeg * simCore::DEG2RAD);
+      (*lut)(h, r) = static_cast<short>(value);
+    }
+  }
+  return lut;
+}
+
+/** Fills the facade with loss and PPF data for a full circle of bearings */
+int addProfiles(simRF::RFPropagationFacade& facade)
+{
+  int rv = 0;
+  for (double bearingDeg = 0.0; bearingDeg < 360.0; bearingDeg += BEAM_WIDTH_DEG)
+  {
+    osg::ref_ptr<simRF::Profile> profile = new simRF::Profile(new simRF::CompositeProfileProvider());
+    profile->addProvider(new simRF::LUTProfileDataProvider(makeTable(bearingDeg, -1000.0), simRF::ProfileDataProvider::THRESHOLDTYPE_LOSS, 0.1));
+    profile->addProvider(new simRF::LUTProfileDataProvider(makeTable(bearingDeg, -100.0), simRF::ProfileDataProvider::THRESHOLDTYPE_FACTOR, 0.1));
+    profile->setBearing(bearingDeg * simCore::DEG2RAD);
+    profile->setHalfBeamWidth(BEAM_WIDTH_DEG / 2.0 * simCore::DEG2RAD);
+    rv += SDK_ASSERT(facade.setSlotData(profile.get()) == 0);
+  }
+  return rv;
+}
+
+/** Compares the batch and single request queries of the facade, and reports the time for each */
+int testBatchQueries()
+{
+  int rv = 0;
+
+  osg::ref_ptr<osg::Group> root = new osg::Group();
+  simRF::RFPropagationFacade facade(root.get(), std::make_shared<simCore::MagneticDatumConvert>());
+  simCore::RadarParameters params;
+  params.hbwD = BEAM_WIDTH_DEG;
+  rv += SDK_ASSERT(facade.setRadarParams(params) == 0);
+  rv += addProfiles(facade);
+
+  // requests sweep the azimuth slowly, as when sampling along a path, with random ranges and heights
+  const size_t NUM_REQUESTS = 200000;
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<double> rangeDist(0.0, MAX_RANGE);
+  std::uniform_real_distribution<double> heightDist(0.0, MAX_HEIGHT);
+  std::vector<double> azimRad(NUM_REQUESTS);
+  std::vector<double> gndRng(NUM_REQUESTS);
+  std::vector<double> hgt(NUM_REQUESTS);
+  for (size_t k = 0; k < NUM_REQUESTS; ++k)
+  {
+    azimRad[k] = M_TWOPI * k / NUM_REQUESTS;
+    gndRng[k] = rangeDist(generator);
+    hgt[k] = heightDist(generator);
+  }
+
+  std::vector<double> single(NUM_REQUESTS);
+  double startTime = simCore::getSystemTime();
+  for (size_t k = 0; k < NUM_REQUESTS; ++k)
+    single[k] = facade.getLoss(azimRad[k], gndRng[k], hgt[k]);
+  const double singleTime = simCore::getSystemTime() - startTime;
+
+  std::vector<double> batch(NUM_REQUESTS);
+  startTime = simCore::getSystemTime();
+  facade.getLoss(NUM_REQUESTS, &azimRad[0], &gndRng[0], &hgt[0], &batch[0]);
+  const double batchTime = simCore::getSystemTime() - startTime;
+
+  size_t mismatches = 0;
+  for (size_t k = 0; k < NUM_REQUESTS; ++k)
+  {
+    if (single[k] != batch[k])
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+  // data covers every request, so no request falls back to the error value
+  rv += SDK_ASSERT(single[0] > simCore::SMALL_DB_VAL && single[NUM_REQUESTS - 1] > simCore::SMALL_DB_VAL);
+
+  std::cout << "RFPropagationFacade::getLoss, " << NUM_REQUESTS << " requests: single " << singleTime << " s, batch " << batchTime << " s";
+  if (batchTime > 0.0)
+    std::cout << " (" << singleTime / batchTime << "x)";
+  std::cout << "\n";
+
+  // PPF goes through the same batch path with a different provider type
+  facade.getPPF(NUM_REQUESTS, &azimRad[0], &gndRng[0], &hgt[0], &batch[0]);
+  mismatches = 0;
+  for (size_t k = 0; k < NUM_REQUESTS; k += 97)
+  {
+    if (facade.getPPF(azimRad[k], gndRng[k], hgt[k]) != batch[k])
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+  return rv;
+}
+
+/** Sends a large batch down a single bearing, so that one profile's requests are split across threads */
+int testSingleBearingBatch()
+{
+  int rv = 0;
+
+  osg::ref_ptr<osg::Group> root = new osg::Group();
+  simRF::RFPropagationFacade facade(root.get(), std::make_shared<simCore::MagneticDatumConvert>());
+  simCore::RadarParameters params;
+  params.hbwD = BEAM_WIDTH_DEG;
+  rv += SDK_ASSERT(facade.setRadarParams(params) == 0);
+  rv += addProfiles(facade);
+
+  // well above the facade's threshold for splitting one profile's requests
+  const size_t NUM_REQUESTS = 50000;
+  std::mt19937 generator(5678);
+  std::uniform_real_distribution<double> rangeDist(0.0, MAX_RANGE);
+  std::uniform_real_distribution<double> heightDist(0.0, MAX_HEIGHT);
+  std::vector<double> azimRad(NUM_REQUESTS, 30.0 * simCore::DEG2RAD);
+  std::vector<double> gndRng(NUM_REQUESTS);
+  std::vector<double> hgt(NUM_REQUESTS);
+  for (size_t k = 0; k < NUM_REQUESTS; ++k)
+  {
+    gndRng[k] = rangeDist(generator);
+    hgt[k] = heightDist(generator);
+  }
+
+  // run twice to cover both creating and reusing the facade's thread pool
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    std::vector<double> batch(NUM_REQUESTS);
+    facade.getLoss(NUM_REQUESTS, &azimRad[0], &gndRng[0], &hgt[0], &batch[0]);
+    size_t mismatches = 0;
+    for (size_t k = 0; k < NUM_REQUESTS; ++k)
+    {
+      if (facade.getLoss(azimRad[k], gndRng[k], hgt[k]) != batch[k])
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+  }
+  return rv;
+}
+
+/**
+ * Writes a small AREPS file; loss values depend on lossOffset, which should have 4 digits so that
+ * files written with different offsets have the same size
+ */
+void writeArepsFile(const std::string& filename, int lossOffset)
+{
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::trunc);
+  out << "AntGain = 30.5\n"
+    << "AntHt = 25\n"
+    << "Freq = 3000\n"
+    << "Noise = 4.5\n"
+    << "PulseWidth = 1.5\n"
+    << "SysLoss = 3\n"
+    << "TransPower = 250\n"
+    << "Hmax = 1000\n"
+    << "Hmin = 0\n"
+    << "Nrout = 4\n"
+    << "Nzout = 3\n"
+    << "Rmax = 40000\n"
+    << "HorzBwidth = 2.5\n";
+  out << "[Probability of detection]\n"
+    << "# thresholds for 1% to 100%\n";
+  for (int i = 0; i < 10; ++i)
+  {
+    for (int j = 0; j < 10; ++j)
+      out << (200 - 10 * i - j) * 0.1 << " ";
+    out << "\n";
+  }
+  out << "[Clutter to noise ratio]\n"
+    << "# dB by range\n"
+    << "12.5 10.1 -3.2 -20\n";
+  out << "[Apm Loss Data]\n"
+    << "InitValue = -32768\n"
+    << "Height(1) cB by range\n";
+  for (int h = 0; h < 3; ++h)
+  {
+    for (int r = 0; r < 4; ++r)
+      out << -(lossOffset + 10 * h + r) << " ";
+    out << "\nHeight(" << h + 2 << ")\n";
+  }
+}
+
+/** Sets the modification time of a file; returns 0 on success */
+int setModifiedTime(const std::string& filename, time_t modified)
+{
+#ifdef WIN32
+  struct _utimbuf times;
+  times.actime = modified;
+  times.modtime = modified;
+  return _utime(filename.c_str(), &times);
+#else
+  struct utimbuf times;
+  times.actime = modified;
+  times.modtime = modified;
+  return utime(filename.c_str(), &times);
+#endif
+}
+
+/** Returns the modification time of a file, or 0 on error */
+time_t modifiedTime(const std::string& filename)
+{
+  struct stat fileStat;
+  if (stat(filename.c_str(), &fileStat) != 0)
+    return 0;
+  return fileStat.st_mtime;
+}
+
+/** Loaded AREPS data, with the facade that receives the radar parameters */
+struct LoadedAreps
+{
+  LoadedAreps()
+    : facade(nullptr, std::make_shared<simCore::MagneticDatumConvert>()),
+      loader(&facade),
+      profile(new simRF::Profile(new simRF::CompositeProfileProvider())),
+      antennaHeight(0.0)
+  {
+  }
+
+  simRF::RFPropagationFacade facade;
+  simRF::ArepsLoader loader;
+  osg::ref_ptr<simRF::Profile> profile;
+  double antennaHeight;
+};
+
+/** Loads an AREPS file, with or without the cache; returns 0 on success */
+int loadAreps(const std::string& filename, bool useCache, LoadedAreps& loaded)
+{
+  loaded.loader.setCache(useCache);
+  const int rv = loaded.loader.loadFile(filename, *loaded.profile);
+  loaded.antennaHeight = loaded.loader.getAntennaHeight();
+  return rv;
+}
+
+/** Compares the contents of two providers of the same type; returns 0 if they match */
+int compareProviders(const simRF::ProfileDataProvider* a, const simRF::ProfileDataProvider* b)
+{
+  if (a == nullptr || b == nullptr)
+    return 1;
+  if (a->getNumHeights() != b->getNumHeights() || a->getNumRanges() != b->getNumRanges() ||
+    a->getMinHeight() != b->getMinHeight() || a->getMaxHeight() != b->getMaxHeight() ||
+    a->getMinRange() != b->getMinRange() || a->getMaxRange() != b->getMaxRange())
+    return 1;
+  for (unsigned int h = 0; h < a->getNumHeights(); ++h)
+  {
+    for (unsigned int r = 0; r < a->getNumRanges(); ++r)
+    {
+      if (a->getValueByIndex(h, r) != b->getValueByIndex(h, r))
+        return 1;
+    }
+  }
+  return 0;
+}
+
+/** Compares the header values and lookup tables of two loads; returns 0 if they match */
+int compareLoads(const LoadedAreps& a, const LoadedAreps& b)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(a.antennaHeight == b.antennaHeight);
+  const simCore::RadarParameters& paramsA = *a.facade.radarParams();
+  const simCore::RadarParameters& paramsB = *b.facade.radarParams();
+  rv += SDK_ASSERT(paramsA.antennaGaindBi == paramsB.antennaGaindBi);
+  rv += SDK_ASSERT(paramsA.freqMHz == paramsB.freqMHz);
+  rv += SDK_ASSERT(paramsA.noiseFiguredB == paramsB.noiseFiguredB);
+  rv += SDK_ASSERT(paramsA.pulseWidth_uSec == paramsB.pulseWidth_uSec);
+  rv += SDK_ASSERT(paramsA.systemLossdB == paramsB.systemLossdB);
+  rv += SDK_ASSERT(paramsA.xmtPowerKW == paramsB.xmtPowerKW);
+  rv += SDK_ASSERT(paramsA.hbwD == paramsB.hbwD);
+  rv += SDK_ASSERT(a.profile->getBearing() == b.profile->getBearing());
+  rv += SDK_ASSERT(a.profile->getHalfBeamWidth() == b.profile->getHalfBeamWidth());
+  rv += SDK_ASSERT(*a.facade.getPODLossThreshold() == *b.facade.getPODLossThreshold());
+
+  const simRF::CompositeProfileProvider* providersA = a.profile->getDataProvider();
+  const simRF::CompositeProfileProvider* providersB = b.profile->getDataProvider();
+  rv += SDK_ASSERT(compareProviders(providersA->getProvider(simRF::ProfileDataProvider::THRESHOLDTYPE_LOSS),
+    providersB->getProvider(simRF::ProfileDataProvider::THRESHOLDTYPE_LOSS)) == 0);
+  rv += SDK_ASSERT(compareProviders(providersA->getProvider(simRF::ProfileDataProvider::THRESHOLDTYPE_CNR),
+    providersB->getProvider(simRF::ProfileDataProvider::THRESHOLDTYPE_CNR)) == 0);
+  return rv;
+}
+
+/** Returns the loss at the first height and range of a load, in dB */
+double firstLoss(const LoadedAreps& loaded)
+{
+  const simRF::ProfileDataProvider* loss = loaded.profile->getDataProvider()->getProvider(simRF::ProfileDataProvider::THRESHOLDTYPE_LOSS);
+  return (loss == nullptr) ? 0.0 : loss->getValueByIndex(0, 0);
+}
+
+/** Loads an AREPS file from text and from its cache, and checks that a changed file is not read from a stale cache */
+int testArepsCache()
+{
+  int rv = 0;
+  // bearing comes from the filename
+  const std::string filename = "RFPropagationTest_APM_45.txt";
+  simRF::ArepsLoader namer;
+  const std::string cacheFile = namer.cacheFilename(filename);
+  std::remove(cacheFile.c_str());
+  writeArepsFile(filename, 1000);
+
+  // Text only, for reference
+  LoadedAreps text;
+  rv += SDK_ASSERT(loadAreps(filename, false, text) == 0);
+  rv += SDK_ASSERT(text.antennaHeight == 25.0);
+  rv += SDK_ASSERT(text.facade.radarParams()->freqMHz == 3000.0);
+  rv += SDK_ASSERT(simCore::areEqual(text.profile->getBearing(), 45.0 * simCore::DEG2RAD));
+  rv += SDK_ASSERT(simCore::areEqual(firstLoss(text), -100.0));
+  rv += SDK_ASSERT(!std::ifstream(cacheFile.c_str()).good());
+
+  // First load with the cache enabled parses the text and writes the cache; the second reads the cache
+  LoadedAreps writer;
+  rv += SDK_ASSERT(loadAreps(filename, true, writer) == 0);
+  rv += SDK_ASSERT(std::ifstream(cacheFile.c_str()).good());
+  rv += compareLoads(text, writer);
+  LoadedAreps cached;
+  rv += SDK_ASSERT(loadAreps(filename, true, cached) == 0);
+  rv += compareLoads(text, cached);
+
+  // Same size and time: the cache is still used, which shows that the loads above came from the cache
+  const time_t originalTime = modifiedTime(filename);
+  writeArepsFile(filename, 2000);
+  rv += SDK_ASSERT(setModifiedTime(filename, originalTime) == 0);
+  LoadedAreps sameStamp;
+  rv += SDK_ASSERT(loadAreps(filename, true, sameStamp) == 0);
+  rv += SDK_ASSERT(simCore::areEqual(firstLoss(sameStamp), -100.0));
+
+  // Same size with a new time: the stale cache is ignored and rewritten
+  rv += SDK_ASSERT(setModifiedTime(filename, originalTime + 10) == 0);
+  LoadedAreps newTime;
+  rv += SDK_ASSERT(loadAreps(filename, true, newTime) == 0);
+  rv += SDK_ASSERT(simCore::areEqual(firstLoss(newTime), -200.0));
+  LoadedAreps newTimeCached;
+  rv += SDK_ASSERT(loadAreps(filename, true, newTimeCached) == 0);
+  rv += compareLoads(newTime, newTimeCached);
+
+  // New size with the time recorded in the cache: the stale cache is ignored
+  writeArepsFile(filename, 10000);
+  rv += SDK_ASSERT(setModifiedTime(filename, originalTime + 10) == 0);
+  LoadedAreps newSize;
+  rv += SDK_ASSERT(loadAreps(filename, true, newSize) == 0);
+  rv += SDK_ASSERT(simCore::areEqual(firstLoss(newSize), -1000.0));
+
+  std::remove(cacheFile.c_str());
+  std::remove(filename.c_str());
+  return rv;
+}
+
+}
+
+int RFPropagationTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  // Check the SIMDIS SDK version
+  simCore::checkVersionThrow();
+
+  rv += testBatchQueries();
+  rv += testSingleBearingBatch();
+  rv += testArepsCache();
+
+  return rv;
+}
@@ -0,0 +1,294 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include "osgEarth/SpatialReference"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Coordinate.h"
+#include "simVis/RadialLOS.h"
+
+namespace
+{
+
+/** Flat terrain at sea level, with a 500 m wall east of the origin from 1.5 to 2.5 km out; counts samples */
+class SyntheticTerrain : public simVis::RadialLOS::ElevationSource
+{
+public:
+  SyntheticTerrain() : numSamples(0), revision(0), available(true) {}
+
+  virtual bool getHeight(const osgEarth::GeoPoint& point, double& hamsl, double& hae)
+  {
+    ++numSamples;
+    if (!available)
+      return false;
+    // roughly 111 km per degree of longitude at the equator
+    const double eastMeters = point.x() * 111320.0;
+    hae = (eastMeters > 1500.0 && eastMeters < 2500.0 && fabs(point.y()) < 0.1) ? 500.0 : 0.0;
+    hamsl = hae;
+    return true;
+  }
+
+  virtual int getRevision() const
+  {
+    return revision;
+  }
+
+  unsigned int numSamples;
+  int revision;
+  /// When false, every sample fails, as when terrain data is not loaded yet
+  bool available;
+};
+
+/** Returns an LOS origin at the given latitude (deg) and altitude (m) on the prime meridian */
+simCore::Coordinate makeOrigin(double latDeg, double alt)
+{
+  return simCore::Coordinate(simCore::COORD_SYS_LLA, simCore::Vec3(latDeg * simCore::DEG2RAD, 0.0, alt));
+}
+
+/** Returns the radial closest to the given azimuth, in degrees */
+const simVis::RadialLOS::Radial* findRadial(const simVis::RadialLOS& los, double azimDeg)
+{
+  const simVis::RadialLOS::RadialVector& radials = los.getRadials();
+  for (auto i = radials.begin(); i != radials.end(); ++i)
+  {
+    if (simCore::areAnglesEqual(i->azim_rad_, azimDeg * simCore::DEG2RAD, 1e-6))
+      return &(*i);
+  }
+  return nullptr;
+}
+
+/** Returns true if the radials of both models have the same samples */
+bool sameRadials(const simVis::RadialLOS& a, const simVis::RadialLOS& b)
+{
+  if (a.getRadials().size() != b.getRadials().size())
+    return false;
+  for (size_t k = 0; k < a.getRadials().size(); ++k)
+  {
+    const simVis::RadialLOS::SampleVector& sa = a.getRadials()[k].samples_;
+    const simVis::RadialLOS::SampleVector& sb = b.getRadials()[k].samples_;
+    if (sa.size() != sb.size())
+      return false;
+    for (size_t s = 0; s < sa.size(); ++s)
+    {
+      if (sa[s].visible_ != sb[s].visible_ || sa[s].hae_m_ != sb[s].hae_m_ || sa[s].elev_rad_ != sb[s].elev_rad_)
+        return false;
+    }
+  }
+  return true;
+}
+
+/** Makes an LOS model with a full circle of 15 degree radials out to 10 km in 1 km steps */
+void configure(simVis::RadialLOS& los, std::shared_ptr<SyntheticTerrain> terrain)
+{
+  los.setMaxRange(osgEarth::Distance(10.0, osgEarth::Units::KILOMETERS));
+  los.setRangeResolution(osgEarth::Distance(1.0, osgEarth::Units::KILOMETERS));
+  los.setFieldOfView(osgEarth::Angle(360.0, osgEarth::Units::DEGREES));
+  los.setAzimuthalResolution(osgEarth::Angle(15.0, osgEarth::Units::DEGREES));
+  los.setElevationSource(terrain);
+}
+
+int testCompute(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  std::shared_ptr<SyntheticTerrain> terrain(new SyntheticTerrain);
+  simVis::RadialLOS los;
+
+  // without a map, an elevation source is required
+  rv += SDK_ASSERT(!los.compute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(!los.startCompute(srs, makeOrigin(0.0, 10.0)));
+
+  configure(los, terrain);
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(los.isValid());
+  rv += SDK_ASSERT(!los.isComputing());
+  rv += SDK_ASSERT(los.getRadials().size() == 25);
+  rv += SDK_ASSERT(los.getNumSamplesPerRadial() == 10);
+  rv += SDK_ASSERT(terrain->numSamples == 250);
+
+  // flat terrain to the west is visible everywhere
+  const simVis::RadialLOS::Radial* west = findRadial(los, 270.0);
+  rv += SDK_ASSERT(west != nullptr);
+  if (west != nullptr)
+  {
+    for (auto i = west->samples_.begin(); i != west->samples_.end(); ++i)
+      rv += SDK_ASSERT(i->valid_ && i->visible_);
+  }
+
+  // the wall to the east is visible, hiding everything behind it
+  const simVis::RadialLOS::Radial* east = findRadial(los, 90.0);
+  rv += SDK_ASSERT(east != nullptr);
+  if (east != nullptr && east->samples_.size() == 10)
+  {
+    rv += SDK_ASSERT(east->samples_[0].visible_);
+    rv += SDK_ASSERT(east->samples_[1].visible_ && simCore::areEqual(east->samples_[1].hae_m_, 500.0));
+    for (size_t k = 2; k < east->samples_.size(); ++k)
+      rv += SDK_ASSERT(!east->samples_[k].visible_);
+  }
+  return rv;
+}
+
+int testIncremental(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  std::shared_ptr<SyntheticTerrain> terrain(new SyntheticTerrain);
+  simVis::RadialLOS reference;
+  configure(reference, terrain);
+  rv += SDK_ASSERT(reference.compute(srs, makeOrigin(0.0, 10.0)));
+
+  // a budget of zero computes one radial per step
+  simVis::RadialLOS los;
+  configure(los, terrain);
+  rv += SDK_ASSERT(los.computeStep(0.0));
+  rv += SDK_ASSERT(los.startCompute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(los.isComputing());
+  rv += SDK_ASSERT(los.getComputeProgress() == 0.0);
+  unsigned int numSteps = 1;
+  while (!los.computeStep(0.0))
+  {
+    ++numSteps;
+    // partial results are not visible until the computation completes
+    rv += SDK_ASSERT(los.getRadials().empty());
+  }
+  rv += SDK_ASSERT(numSteps == 25);
+  rv += SDK_ASSERT(!los.isComputing());
+  rv += SDK_ASSERT(los.getComputeProgress() == 1.0);
+  rv += SDK_ASSERT(los.isValid());
+  rv += SDK_ASSERT(sameRadials(los, reference));
+
+  // previous result remains while a new computation is in progress, and after it is cancelled
+  rv += SDK_ASSERT(los.startCompute(srs, makeOrigin(0.5, 10.0)));
+  rv += SDK_ASSERT(!los.computeStep(0.0));
+  rv += SDK_ASSERT(simCore::areEqual(los.getComputeProgress(), 1.0 / 25));
+  rv += SDK_ASSERT(sameRadials(los, reference));
+  los.cancelCompute();
+  rv += SDK_ASSERT(!los.isComputing());
+  rv += SDK_ASSERT(sameRadials(los, reference));
+
+  // generous budget finishes in one step
+  rv += SDK_ASSERT(los.startCompute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(los.computeStep(10.0));
+  rv += SDK_ASSERT(sameRadials(los, reference));
+
+  // failing to start clears the previous result, like compute()
+  rv += SDK_ASSERT(!los.startCompute(static_cast<const osgEarth::SpatialReference*>(nullptr), makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(!los.isComputing());
+  rv += SDK_ASSERT(los.getRadials().empty());
+  return rv;
+}
+
+int testHeightCache(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  std::shared_ptr<SyntheticTerrain> terrain(new SyntheticTerrain);
+  simVis::RadialLOS los;
+  configure(los, terrain);
+
+  // cache is off by default
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 500);
+
+  terrain->numSamples = 0;
+  los.setOriginTolerance(osgEarth::Distance(100.0, osgEarth::Units::METERS));
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 250);
+
+  // moving about 55 m north reuses all the terrain heights
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0005, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 250);
+
+  // visibility is recomputed from the new origin: high above the wall, everything is visible
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0005, 1000.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 250);
+  const simVis::RadialLOS::Radial* east = findRadial(los, 90.0);
+  rv += SDK_ASSERT(east != nullptr && !east->samples_.empty() && east->samples_.back().visible_);
+
+  // tolerance is measured from where the terrain was sampled, not from the last origin
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0010, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 500);
+
+  // moving about 550 m resamples everything
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 750);
+  simVis::RadialLOS reference;
+  configure(reference, terrain);
+  rv += SDK_ASSERT(reference.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(sameRadials(los, reference));
+
+  // shorter range keeps the matching range steps, and only the new last step is sampled
+  terrain->numSamples = 0;
+  los.setMaxRange(osgEarth::Distance(5.5, osgEarth::Units::KILOMETERS));
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(los.getNumSamplesPerRadial() == 6);
+  rv += SDK_ASSERT(terrain->numSamples == 25);
+
+  // different radials cannot use the cache
+  terrain->numSamples = 0;
+  los.setAzimuthalResolution(osgEarth::Angle(30.0, osgEarth::Units::DEGREES));
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 13 * 6);
+
+  // a change to the terrain data discards the cache
+  terrain->numSamples = 0;
+  ++terrain->revision;
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 13 * 6);
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 13 * 6);
+
+  // failed samples are not cached, so terrain that becomes available later is picked up
+  terrain->numSamples = 0;
+  terrain->available = false;
+  ++terrain->revision;
+  rv += SDK_ASSERT(!los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 13 * 6);
+  terrain->available = true;
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 2 * 13 * 6);
+  rv += SDK_ASSERT(los.compute(srs, makeOrigin(0.0060, 10.0)));
+  rv += SDK_ASSERT(terrain->numSamples == 2 * 13 * 6);
+  return rv;
+}
+
+}
+
+int RadialLOSTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  // Check the SIMDIS SDK version
+  simCore::checkVersionThrow();
+
+  // Terrain comes from a synthetic elevation source, so no map or view is needed
+  osg::ref_ptr<const osgEarth::SpatialReference> srs = osgEarth::SpatialReference::get("wgs84");
+  rv += SDK_ASSERT(srs.valid());
+  if (!srs.valid())
+    return rv;
+
+  rv += testCompute(srs.get());
+  rv += testIncremental(srs.get());
+  rv += testHeightCache(srs.get());
+
+  return rv;
+}
@@ -0,0 +1,158 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Time/Utils.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Locator.h"
+#include "simVis/PlatformFilter.h"
+#include "simVis/TrackChunkNode.h"
+#include "simVis/TrackHistory.h"
+
+namespace
+{
+
+/** Adds a platform that circles the equator with the given number of updates, returning its id */
+uint64_t addCirclingPlatform(simData::DataStore& ds, unsigned int numPoints)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformProperties* props = ds.addPlatform(&t);
+  const uint64_t id = props->id();
+  t.commit();
+
+  const double radius = 6378137.0 + 1000.0;
+  for (unsigned int k = 0; k < numPoints; ++k)
+  {
+    const double lon = M_TWOPI * k / numPoints;
+    simData::PlatformUpdate* u = ds.addPlatformUpdate(id, &t);
+    u->set_time(static_cast<double>(k));
+    u->set_x(radius * cos(lon));
+    u->set_y(radius * sin(lon));
+    u->set_z(0.0);
+    u->set_psi(lon);
+    u->set_theta(0.0);
+    u->set_phi(0.0);
+    t.commit();
+  }
+  ds.update(numPoints - 1.0);
+  return id;
+}
+
+/** Returns the number of points across all chunks of the track history */
+unsigned int countTrackPoints(const simVis::TrackHistoryNode& track, unsigned int& numChunks)
+{
+  // first child of the track history is the group holding all the chunks
+  numChunks = 0;
+  if (track.getNumChildren() == 0 || track.getChild(0)->asGroup() == nullptr)
+    return 0;
+  const osg::Group* chunkGroup = track.getChild(0)->asGroup();
+  unsigned int numPoints = 0;
+  for (unsigned int k = 0; k < chunkGroup->getNumChildren(); ++k)
+  {
+    const simVis::TrackChunkNode* chunk = dynamic_cast<const simVis::TrackChunkNode*>(chunkGroup->getChild(k));
+    if (chunk == nullptr)
+      continue;
+    ++numChunks;
+    numPoints += chunk->size();
+  }
+  return numPoints;
+}
+
+/** Backfills the full history in the given draw mode, verifying the number of points and reporting throughput */
+int testBackfill(simData::TrackPrefs_Mode mode, const char* modeName)
+{
+  int rv = 0;
+  const unsigned int NUM_POINTS = 100000;
+
+  simData::MemoryDataStore ds;
+  ds.setDataLimiting(false);
+  const uint64_t id = addCirclingPlatform(ds, NUM_POINTS);
+
+  simVis::PlatformTspiFilterManager filterManager;
+  osg::ref_ptr<simVis::Locator> locator = new simVis::Locator();
+  osg::ref_ptr<simVis::TrackHistoryNode> track = new simVis::TrackHistoryNode(ds, locator.get(), filterManager, id);
+
+  simData::PlatformPrefs prefs;
+  prefs.mutable_trackprefs()->set_trackdrawmode(mode);
+  prefs.mutable_trackprefs()->set_tracklength(-1);
+  simData::PlatformProperties props;
+  props.set_id(id);
+  track->setPrefs(prefs, props, true);
+
+  const double startTime = simCore::getSystemTime();
+  track->update();
+  const double elapsed = simCore::getSystemTime() - startTime;
+
+  // each chunk after the first duplicates the last point of its predecessor for continuity
+  unsigned int numChunks = 0;
+  const unsigned int numTrackPoints = countTrackPoints(*track, numChunks);
+  rv += SDK_ASSERT(numChunks > 0);
+  rv += SDK_ASSERT(numTrackPoints == NUM_POINTS + numChunks - 1);
+
+  // newest point in the last chunk matches the last update
+  if (numChunks > 0)
+  {
+    osg::Group* chunkGroup = track->getChild(0)->asGroup();
+    const simVis::TrackChunkNode* lastChunk = dynamic_cast<const simVis::TrackChunkNode*>(chunkGroup->getChild(chunkGroup->getNumChildren() - 1));
+    rv += SDK_ASSERT(lastChunk != nullptr && simCore::areEqual(lastChunk->getEndTime(), NUM_POINTS - 1.0));
+
+    // point and line chunks decimate to the chunk's end points at the coarsest level of detail
+    simVis::TrackChunkNode* firstChunk = dynamic_cast<simVis::TrackChunkNode*>(chunkGroup->getChild(0));
+    rv += SDK_ASSERT(firstChunk != nullptr);
+    if (firstChunk != nullptr)
+    {
+      const bool supportsLod = (mode == simData::TrackPrefs_Mode_POINT || mode == simData::TrackPrefs_Mode_LINE);
+      const unsigned int coarsest = firstChunk->lodPointCount(simVis::TrackChunkNode::MAX_LOD_LEVEL);
+      rv += SDK_ASSERT(firstChunk->lodPointCount(0) == firstChunk->size());
+      rv += SDK_ASSERT(supportsLod ? (coarsest == 2) : (coarsest == firstChunk->size()));
+    }
+  }
+
+  std::cout << "Backfill " << modeName << ": " << NUM_POINTS << " points in " << elapsed << " s";
+  if (elapsed > 0.0)
+    std::cout << " (" << static_cast<unsigned int>(NUM_POINTS / elapsed) << " points/s)";
+  std::cout << "\n";
+  return rv;
+}
+
+}
+
+int TrackHistoryTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  // Check the SIMDIS SDK version
+  simCore::checkVersionThrow();
+
+  // Run tests; ribbon mode uses the point-by-point path for comparison
+  rv += testBackfill(simData::TrackPrefs_Mode_POINT, "POINT");
+  rv += testBackfill(simData::TrackPrefs_Mode_LINE, "LINE");
+  rv += testBackfill(simData::TrackPrefs_Mode_BRIDGE, "BRIDGE");
+  rv += testBackfill(simData::TrackPrefs_Mode_RIBBON, "RIBBON");
+
+  return rv;
+}